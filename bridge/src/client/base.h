@@ -31,10 +31,8 @@
 #include <atomic>
 #include <functional>
 
-using ShadowMap = std::unordered_map<uintptr_t, IUnknown*>;
-extern ShadowMap gShadowMap;
+#include "shadow_map.h"
 
-extern std::mutex gShadowMapMutex;
 
 enum class D3D9ObjectType: char {
   Module,
@@ -301,11 +299,13 @@ static inline D3DAutoPtr MakeD3DAutoPtr(T* obj) {
   return D3DAutoPtr(static_cast<D3DRefCounted*>(obj));
 }
 
+// Object ids double as the handles the server looks objects up by, see ObjectHandle.
+// An id is recycled once its object is destroyed, which is after the object's destroy
+// command has been sent.
 class D3dBaseIdFactory {
-private:
-  static std::atomic<uintptr_t> id_counter;
 public:
   static uintptr_t getNextId();
+  static void releaseId(const uintptr_t id);
 };
 
 // The base object for every D3D object. Implements IUnknown::AddRef() and
@@ -374,13 +374,12 @@ protected:
   }
 
   ~D3DBase() override {
-    gShadowMapMutex.lock();
-    gShadowMap.erase(m_id);
-    gShadowMapMutex.unlock();
+    gShadowMap.untrack(m_id);
 #ifdef _DEBUG
     Logger::debug(format_string("%s object [%p/%p] destroyed",
                                 toD3D9ObjectTypeName<T>(), this, m_id));
 #endif
+    D3dBaseIdFactory::releaseId(m_id);
   }
 
 public:
@@ -78,4 +78,53 @@ namespace ClientOptions {
   inline bool getOptimizedDynamicLock() {
     return bridge_util::Config::getOption<bool>("client.optimizedDynamicLock", false);
   }
+
+  // If set, Unlock() on static vertex and index buffers only marks the touched pages as dirty.
+  // Dirty pages of a buffer are coalesced across all locks and sent to the server in a single
+  // update right before the next draw call or Present.
+  inline bool getTrackStaticBufferDirtyPages() {
+    return bridge_util::Config::getOption<bool>("client.trackStaticBufferDirtyPages", false);
+  }
+
+  // If set and a thread-safe device is created, device state setters and draw calls are
+  // recorded into per-thread buffers instead of contending on the device channel lock for
+  // every call. Recorded commands are merged in order into the channel at sync points such
+  // as Present, resource creation and any call that waits on a server response.
+  inline bool getPerThreadCommandRecording() {
+    return bridge_util::Config::getOption<bool>("client.perThreadCommandRecording", false);
+  }
+
+  // If set, Remix API calls that never wait on the server, such as instance draws and instance
+  // and light updates, are recorded in the calling thread's command buffer like above and merged
+  // into the channel at the next sync point, usually Present, instead of going out one by one.
+  inline bool getBatchRemixApiCalls() {
+    return bridge_util::Config::getOption<bool>("client.batchRemixApiCalls", true);
+  }
+
+  // If set, render states, sampler states, textures, stream sources and float shader
+  // constants are only recorded in the client state shadow when set. The net delta
+  // against the state last sent to the server is flushed right before the server
+  // consumes device state, e.g. on draw calls, Clear or state block operations.
+  inline bool getFlushStateDeltaAtDraw() {
+    return bridge_util::Config::getOption<bool>("client.flushStateDeltaAtDraw", false);
+  }
+
+  // If set, SetVertexShaderConstantF() and SetPixelShaderConstantF() keep the registers
+  // last sent to the server and only send a change mask plus the registers that differ.
+  // The server expands the delta from its own copy of the registers.
+  inline bool getShaderConstantDelta() {
+    return bridge_util::Config::getOption<bool>("client.shaderConstantDelta", false);
+  }
+
+  // If set, the surface data of UnlockRect() calls is collected and sent to the server
+  // in a single command, e.g. all mip levels and faces of a texture loaded in a row, and
+  // flushed before the server may access the surfaces, e.g. on draw calls or Present.
+  inline bool getBatchSurfaceUploads() {
+    return bridge_util::Config::getOption<bool>("client.batchSurfaceUploads", false);
+  }
+
+  // Granularity of the static buffer dirty page tracking in bytes.
+  inline uint32_t getStaticBufferDirtyPageSize() {
+    return bridge_util::Config::getOption<uint32_t>("client.staticBufferDirtyPageSize", 4 << 10);
+  }
 }
\ No newline at end of file
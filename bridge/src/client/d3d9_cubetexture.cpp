@@ -23,6 +23,7 @@
 
 #include "d3d9_cubetexture.h"
 #include "shadow_map.h"
+#include "surface_upload_batch.h"
 
 #include "util_devicecommand.h"
 
@@ -65,7 +66,8 @@ ULONG Direct3DCubeTexture9_LSS::Release() {
 }
 
 void Direct3DCubeTexture9_LSS::onDestroy() {
-   ClientMessage { Commands::IDirect3DCubeTexture9_Destroy, getId() };
+   SurfaceUploadBatch::flush();
+  ClientMessage { Commands::IDirect3DCubeTexture9_Destroy, getId() };
 }
 
 HRESULT Direct3DCubeTexture9_LSS::GetLevelDesc(UINT Level, D3DSURFACE_DESC* pDesc) {
@@ -36,6 +36,7 @@
 #include "d3d9_vertexshader.h"
 #include "d3d9_volumetexture.h"
 #include "shadow_map.h"
+#include "surface_upload_batch.h"
 #include "client_options.h"
 #include "swapchain_map.h"
 #include "config/global_options.h"
@@ -44,6 +45,7 @@
 
 #include "util_bridge_assert.h"
 #include "util_semaphore.h"
+#include "util_vertexring.h"
 
 #include <wingdi.h>
 #include <assert.h>
@@ -476,6 +478,7 @@ HRESULT syncOnPresent() {
 #endif
     }
   }
+  ++gSyncedPresentCount;
   return S_OK;
 }
 
@@ -764,6 +767,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::UpdateSurface(IDirect3DSurface9* pSourceSurface, CONST RECT* pSourceRect, IDirect3DSurface9* pDestinationSurface, CONST POINT* pDestPoint) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   if (pSourceSurface == nullptr || pDestinationSurface == nullptr || pSourceSurface == pDestinationSurface) {
     return D3DERR_INVALIDCALL;
@@ -809,6 +813,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::UpdateTexture(IDirect3DBaseTexture9* pSourceTexture, IDirect3DBaseTexture9* pDestinationTexture) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   assert(pSourceTexture->GetType() == pDestinationTexture->GetType() && "UpdateTexture: texture type mismatch!");
 
@@ -830,6 +835,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::GetRenderTargetData(IDirect3DSurface9* pRenderTarget, IDirect3DSurface9* pDestSurface) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   const auto pLssSourceSurface = bridge_cast<Direct3DSurface9_LSS*>(pRenderTarget);
   const auto pLssDestinationSurface = bridge_cast<Direct3DSurface9_LSS*>(pDestSurface);
@@ -872,6 +878,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::StretchRect(IDirect3DSurface9* pSourceSurface, CONST RECT* pSourceRect, IDirect3DSurface9* pDestSurface, CONST RECT* pDestRect, D3DTEXTUREFILTERTYPE Filter) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   if (pSourceSurface == nullptr || pDestSurface == nullptr) {
     return D3DERR_INVALIDCALL;
@@ -901,6 +908,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::ColorFill(IDirect3DSurface9* pSurface, CONST RECT* pRect, D3DCOLOR color) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   if (pSurface == nullptr) {
     return D3DERR_INVALIDCALL;
@@ -1113,6 +1121,7 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::Clear(DWORD Count, CONST D3DRECT* pRects, DWORD Flags, D3DCOLOR Color, float Z, DWORD Stencil) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
 
   if (Count == 0 && pRects != NULL) {
     return D3DERR_INVALIDCALL;
@@ -1121,6 +1130,11 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::Clear(DWORD Count, CONST D3DRECT* pRe
     return D3DERR_INVALIDCALL;
   }
 
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
+
   UID currentUID = 0;
   {
     ClientMessage c(Commands::IDirect3DDevice9Ex_Clear, getId());
@@ -1527,6 +1541,11 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetRenderState(D3DRENDERSTATETYPE Sta
           return S_OK;
         }
         m_state.renderStates[State] = Value;
+        if (m_bDeferState) {
+          m_deferredDirty.renderStates[State] = true;
+          m_bDeferredStateDirty = true;
+          return S_OK;
+        }
       }
     }
     {
@@ -1759,6 +1778,7 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::CreateStateBlock(D3DSTATEBLOCKTYPE Ty
     {
       BRIDGE_DEVICE_LOCKGUARD();
       // Insert our own IDirect3DStateBlock9 interface implementation
+      flushDeferredState();
       pLssSB = trackWrapper(new Direct3DStateBlock9_LSS(this));
       (*ppSB) = pLssSB;
       StateBlockSetCaptureFlags(Type, pLssSB->m_dirtyFlags);
@@ -1783,6 +1803,7 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::BeginStateBlock() {
     if (m_stateRecording) {
       return D3DERR_INVALIDCALL;
     }
+    flushDeferredState();
     m_stateRecording = trackWrapper(new Direct3DStateBlock9_LSS(this));
   }
   UID currentUID = 0;
@@ -1968,6 +1989,12 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetTexture(DWORD Stage, IDirect3DBase
     } else {
       m_state.textures[idx] = std::move(objectRef);
       m_state.textureTypes[idx] = type;
+      if (m_bDeferState) {
+        m_deferredTextures[idx] = (uint32_t) pD3DObject;
+        m_deferredDirty.textures[idx] = true;
+        m_bDeferredStateDirty = true;
+        return S_OK;
+      }
     }
   }
   UID currentUID = 0;
@@ -2135,6 +2162,11 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetSamplerState(DWORD Sampler, D3DSAM
           return S_OK;
         }
         m_state.samplerStates[samplerIdx][typeIdx] = Value;
+        if (m_bDeferState) {
+          m_deferredDirty.samplerStates[samplerIdx][typeIdx] = true;
+          m_bDeferredStateDirty = true;
+          return S_OK;
+        }
       }
     }
     {
@@ -2336,6 +2368,12 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::DrawPrimitive(D3DPRIMITIVETYPE PrimitiveType, UINT StartVertex, UINT PrimitiveCount) {
   ZoneScoped;
   LogFunctionCall();
+  DeferredBufferUpdate::flushAll();
+  SurfaceUploadBatch::flush();
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
   UID currentUID = 0;
   {
     ClientMessage c(Commands::IDirect3DDevice9Ex_DrawPrimitive, getId());
@@ -2349,6 +2387,12 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::DrawIndexedPrimitive(D3DPRIMITIVETYPE Type, INT BaseVertexIndex, UINT MinVertexIndex, UINT NumVertices, UINT startIndex, UINT primCount) {
   ZoneScoped;
   LogFunctionCall();
+  DeferredBufferUpdate::flushAll();
+  SurfaceUploadBatch::flush();
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
   UID currentUID = 0;
   {
     ClientMessage c(Commands::IDirect3DDevice9Ex_DrawIndexedPrimitive, getId());
@@ -2362,16 +2406,30 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::DrawPrimitiveUP(D3DPRIMITIVETYPE PrimitiveType, UINT PrimitiveCount, CONST void* pVertexStreamZeroData, UINT VertexStreamZeroStride) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
   UID currentUID = 0;
   {
-    ClientMessage c(Commands::IDirect3DDevice9Ex_DrawPrimitiveUP, getId());
-    currentUID = c.get_uid();
-    c.send_many(PrimitiveType, PrimitiveCount);
-
     uint32_t numIndices = GetIndexCount(PrimitiveType, PrimitiveCount);
     uint32_t vertexDataSize = numIndices * VertexStreamZeroStride;
 
-    c.send_data(vertexDataSize, (void*) pVertexStreamZeroData);
+    // The ring writer must outlive the command, see VertexRing::Writer
+    VertexRing::Writer ringWriter(vertexDataSize);
+    const Commands::Flags dataFlag = ringWriter.isValid() ? Commands::FlagBits::DataInVertexRing : 0;
+
+    ClientMessage c(Commands::IDirect3DDevice9Ex_DrawPrimitiveUP, getId(), dataFlag);
+    currentUID = c.get_uid();
+    c.send_many(PrimitiveType, PrimitiveCount);
+
+    if (ringWriter.isValid()) {
+      memcpy(ringWriter.data(), pVertexStreamZeroData, vertexDataSize);
+      c.send_many(ringWriter.getPos(), ringWriter.getSize());
+    } else {
+      c.send_data(vertexDataSize, (void*) pVertexStreamZeroData);
+    }
     c.send_data(VertexStreamZeroStride);
   }
   WAIT_FOR_OPTIONAL_SERVER_RESPONSE("DrawPrimitiveUP()", D3DERR_INVALIDCALL, currentUID);
@@ -2381,19 +2439,35 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE PrimitiveType, UINT MinIndex, UINT NumVertices, UINT PrimitiveCount, CONST void* pIndexData, D3DFORMAT IndexDataFormat, CONST void* pVertexStreamZeroData, UINT VertexStreamZeroStride) {
   ZoneScoped;
   LogFunctionCall();
+  SurfaceUploadBatch::flush();
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
   UID currentUID = 0;
   {
-    ClientMessage c(Commands::IDirect3DDevice9Ex_DrawIndexedPrimitiveUP, getId());
-    currentUID = c.get_uid();
-    c.send_many(PrimitiveType, MinIndex, NumVertices, PrimitiveCount, IndexDataFormat, VertexStreamZeroStride);
-
     uint32_t numIndices = GetIndexCount(PrimitiveType, PrimitiveCount);
     uint32_t indexStride = IndexDataFormat == D3DFMT_INDEX16 ? 2 : 4;
     uint32_t indexDataSize = numIndices * indexStride;
     uint32_t vertexDataSize = NumVertices * VertexStreamZeroStride;
 
-    c.send_data(indexDataSize, (void*) pIndexData);
-    c.send_data(vertexDataSize, (void*) pVertexStreamZeroData);
+    // Indices and vertices share a single ring reservation, vertices go first
+    const uint32_t indexDataOffset = VertexRing::align(vertexDataSize);
+    VertexRing::Writer ringWriter(indexDataOffset + indexDataSize);
+    const Commands::Flags dataFlag = ringWriter.isValid() ? Commands::FlagBits::DataInVertexRing : 0;
+
+    ClientMessage c(Commands::IDirect3DDevice9Ex_DrawIndexedPrimitiveUP, getId(), dataFlag);
+    currentUID = c.get_uid();
+    c.send_many(PrimitiveType, MinIndex, NumVertices, PrimitiveCount, IndexDataFormat, VertexStreamZeroStride);
+
+    if (ringWriter.isValid()) {
+      memcpy(ringWriter.data(), pVertexStreamZeroData, vertexDataSize);
+      memcpy(ringWriter.data() + indexDataOffset, pIndexData, indexDataSize);
+      c.send_many(ringWriter.getPos(), ringWriter.getSize(), indexDataOffset);
+    } else {
+      c.send_data(indexDataSize, (void*) pIndexData);
+      c.send_data(vertexDataSize, (void*) pVertexStreamZeroData);
+    }
   }
   WAIT_FOR_OPTIONAL_SERVER_RESPONSE("DrawIndexedPrimitiveUP()", D3DERR_INVALIDCALL, currentUID);
 }
@@ -2402,6 +2476,11 @@ template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::ProcessVertices(UINT SrcStartIndex, UINT DestIndex, UINT VertexCount, IDirect3DVertexBuffer9* pDestBuffer, IDirect3DVertexDeclaration9* pVertexDecl, DWORD Flags) {
   ZoneScoped;
   LogMissingFunctionCall();
+  DeferredBufferUpdate::flushAll();
+  if (m_bDeferState) {
+    BRIDGE_DEVICE_LOCKGUARD();
+    flushDeferredState();
+  }
 
   if (pDestBuffer == nullptr || pVertexDecl == nullptr) {
     return D3DERR_INVALIDCALL;
@@ -2638,14 +2717,25 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetVertexShaderConstantF(UINT StartRe
         StartRegister,
         pConstantData,
         Vector4fCount);
+    if (SUCCEEDED(hresult) && m_bDeferState && !m_stateRecording) {
+      markDeferredRegisters(m_deferredDirty.vertexConstantsF, StartRegister, Vector4fCount);
+      return hresult;
+    }
   }
   if (SUCCEEDED(hresult)) {
     UID currentUID = 0;
-    SetShaderConst(SetVertexShaderConstantF,
-                   StartRegister,
-                   pConstantData,
-                   Vector4fCount,
-                   Vector4fCount * 4 * sizeof(float), currentUID);
+    if (m_bShaderConstantDelta) {
+      BRIDGE_DEVICE_LOCKGUARD();
+      currentUID = sendShaderConstantDeltaF(Commands::IDirect3DDevice9Ex_SetVertexShaderConstantF,
+                                            m_vertexConstantDeltaShadow, caps::MaxFloatConstantsSoftware,
+                                            StartRegister, pConstantData, Vector4fCount);
+    } else {
+      SetShaderConst(SetVertexShaderConstantF,
+                     StartRegister,
+                     pConstantData,
+                     Vector4fCount,
+                     Vector4fCount * 4 * sizeof(float), currentUID);
+    }
     WAIT_FOR_OPTIONAL_SERVER_RESPONSE("SetVertexShaderConstantF()", D3DERR_INVALIDCALL, currentUID);
   }
   return hresult;
@@ -2805,6 +2895,12 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetStreamSource(UINT StreamNumber, ID
           m_state.streamOffsets[StreamNumber] = OffsetInBytes;
           m_state.streamStrides[StreamNumber] = Stride;
         }
+        if (m_bDeferState) {
+          m_deferredStreams[StreamNumber] = { (uint32_t) id, OffsetInBytes, Stride };
+          m_deferredDirty.streams[StreamNumber] = true;
+          m_bDeferredStateDirty = true;
+          return S_OK;
+        }
       }
     }
     {
@@ -3017,15 +3113,26 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::SetPixelShaderConstantF(UINT StartReg
   {
     BRIDGE_DEVICE_LOCKGUARD();
     hresult = setShaderConstants<ShaderType::Pixel, ConstantType::Float>(StartRegister, pConstantData, Vector4fCount);
+    if (SUCCEEDED(hresult) && m_bDeferState && !m_stateRecording) {
+      markDeferredRegisters(m_deferredDirty.pixelConstantsF, StartRegister, Vector4fCount);
+      return hresult;
+    }
   }
 
   if (SUCCEEDED(hresult)) {
     UID currentUID = 0;
-    SetShaderConst(SetPixelShaderConstantF,
-                   StartRegister,
-                   pConstantData,
-                   Vector4fCount,
-                   Vector4fCount * 4 * sizeof(float), currentUID);
+    if (m_bShaderConstantDelta) {
+      BRIDGE_DEVICE_LOCKGUARD();
+      currentUID = sendShaderConstantDeltaF(Commands::IDirect3DDevice9Ex_SetPixelShaderConstantF,
+                                            m_pixelConstantDeltaShadow, caps::MaxFloatConstantsPS,
+                                            StartRegister, pConstantData, Vector4fCount);
+    } else {
+      SetShaderConst(SetPixelShaderConstantF,
+                     StartRegister,
+                     pConstantData,
+                     Vector4fCount,
+                     Vector4fCount * 4 * sizeof(float), currentUID);
+    }
     WAIT_FOR_OPTIONAL_SERVER_RESPONSE("SetPixelShaderConstantF()", D3DERR_INVALIDCALL, currentUID);
   }
   return hresult;
@@ -3163,6 +3270,9 @@ HRESULT Direct3DDevice9Ex_LSS<EnableSync>::CreateQuery(D3DQUERYTYPE Type, IDirec
     ClientMessage c(Commands::IDirect3DDevice9Ex_CreateQuery, getId());
     currentUID = c.get_uid();
     c.send_many(Type, (uint32_t) pLssQuery->getId());
+    if (OcclusionQueryResults::isEnabled()) {
+      c.send_data(pLssQuery->getResultSlot());
+    }
   }
   return S_OK;
 }
@@ -3642,6 +3752,11 @@ std::tuple<HRESULT, size_t> BaseDirect3DDevice9Ex_LSS::commonGetSetConstants(con
 
 template<bool EnableSync>
 HRESULT Direct3DDevice9Ex_LSS<EnableSync>::ResetState() {
+  // The server state is reset as well, so anything still deferred is stale
+  m_deferredDirty = DeferredStateFlags {};
+  m_bDeferredStateDirty = false;
+  invalidateDeferredState();
+
   for (uint32_t stageIdx = 0; stageIdx < kNumStageSamplers; ++stageIdx) {
     // Reset Texture States
     m_state.textureStageStates[stageIdx][TextureStageStateType::ColorOp] = stageIdx == 0 ? D3DTOP_MODULATE : D3DTOP_DISABLE;
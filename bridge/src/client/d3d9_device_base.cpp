@@ -23,6 +23,8 @@
 
 #include "d3d9_lss.h"
 #include "window.h"
+#include "client_options.h"
+#include "config/global_options.h"
 
 #include "util_modulecommand.h"
 
@@ -74,6 +76,12 @@ BaseDirect3DDevice9Ex_LSS::BaseDirect3DDevice9Ex_LSS(const bool bExtended,
 
   assert(m_createParams.hFocusWindow || m_presParams.hDeviceWindow);
 
+  // Deferred setters never wait on the server, so they can't be used together
+  // with per command responses.
+  m_bDeferState = ClientOptions::getFlushStateDeltaAtDraw() &&
+                  !GlobalOptions::getSendAllServerResponses();
+  m_bShaderConstantDelta = ClientOptions::getShaderConstantDelta();
+
   m_previousPresentParams = presParams;
   m_bSoftwareVtxProcessing = (createParams.BehaviorFlags & D3DCREATE_SOFTWARE_VERTEXPROCESSING) ? true : false;
   DWORD customBehaviorFlags = createParams.BehaviorFlags | D3DCREATE_NOWINDOWCHANGES;
@@ -129,4 +137,144 @@ void BaseDirect3DDevice9Ex_LSS::InitRamp() {
     m_gammaRamp.green[i] = identity;
     m_gammaRamp.blue[i] = identity;
   }
-}
\ No newline at end of file
+}
+void BaseDirect3DDevice9Ex_LSS::invalidateDeferredState() {
+  m_deferredKnown = DeferredStateFlags {};
+}
+
+void BaseDirect3DDevice9Ex_LSS::flushDeferredState() {
+  if (!m_bDeferredStateDirty) {
+    return;
+  }
+  m_bDeferredStateDirty = false;
+  ZoneScoped;
+
+  auto& dirty = m_deferredDirty;
+  auto& known = m_deferredKnown;
+
+  // Maps state array index back to the D3D sampler stage
+  auto idxToSamplerStage = [](const size_t idx) {
+    return idx < caps::MaxTexturesPS ? DWORD(idx) : DWORD(D3DDMAPSAMPLER + (idx - caps::MaxTexturesPS));
+  };
+
+  for (size_t idx = 0; idx < kNumStageSamplers; idx++) {
+    if (!dirty.textures[idx] || (known.textures[idx] && m_sentState.textures[idx] == m_deferredTextures[idx])) {
+      continue;
+    }
+    m_sentState.textures[idx] = m_deferredTextures[idx];
+    known.textures.set(idx);
+    ClientMessage c(Commands::IDirect3DDevice9Ex_SetTexture, getId());
+    c.send_many(idxToSamplerStage(idx), m_deferredTextures[idx]);
+  }
+
+  for (size_t i = 0; i < caps::MaxStreams; i++) {
+    const StreamBinding& binding = m_deferredStreams[i];
+    if (!dirty.streams[i] || (known.streams[i] && m_sentState.streams[i] == binding)) {
+      continue;
+    }
+    m_sentState.streams[i] = binding;
+    known.streams.set(i);
+    ClientMessage c(Commands::IDirect3DDevice9Ex_SetStreamSource, getId());
+    c.send_many(i, binding.id, binding.offset, binding.stride);
+  }
+
+  for (size_t idx = 0; idx < kNumStageSamplers; idx++) {
+    if (dirty.samplerStates[idx].none()) {
+      continue;
+    }
+    for (size_t typeIdx = 0; typeIdx < kMaxStageSamplerStateTypes; typeIdx++) {
+      const DWORD value = m_state.samplerStates[idx][typeIdx];
+      if (!dirty.samplerStates[idx][typeIdx] ||
+          (known.samplerStates[idx][typeIdx] && m_sentState.samplerStates[idx][typeIdx] == value)) {
+        continue;
+      }
+      m_sentState.samplerStates[idx][typeIdx] = value;
+      known.samplerStates[idx].set(typeIdx);
+      ClientMessage c(Commands::IDirect3DDevice9Ex_SetSamplerState, getId());
+      c.send_many(idxToSamplerStage(idx), typeIdx + 1, value);
+    }
+  }
+
+  for (size_t state = 0; state < kNumRenderStates; state++) {
+    const DWORD value = m_state.renderStates[state];
+    if (!dirty.renderStates[state] || (known.renderStates[state] && m_sentState.renderStates[state] == value)) {
+      continue;
+    }
+    m_sentState.renderStates[state] = value;
+    known.renderStates.set(state);
+    ClientMessage c(Commands::IDirect3DDevice9Ex_SetRenderState, getId());
+    c.send_many(state, value);
+  }
+
+  // Changed registers are coalesced into contiguous ranges
+  auto flushConstants = [this](const Commands::D3D9Command command, auto& dirtyRegs, auto& knownRegs,
+                               auto& sentRegs, const auto& regs) {
+    const uint32_t numRegs = (uint32_t) dirtyRegs.size();
+    uint32_t reg = 0;
+    while (reg < numRegs) {
+      auto isChanged = [&](const uint32_t r) {
+        return dirtyRegs[r] &&
+               (!knownRegs[r] || memcmp(&sentRegs[r], &regs[r], sizeof(regs[r])) != 0);
+      };
+      if (!isChanged(reg)) {
+        reg++;
+        continue;
+      }
+      const uint32_t start = reg;
+      while (reg < numRegs && isChanged(reg)) {
+        sentRegs[reg] = regs[reg];
+        knownRegs.set(reg);
+        reg++;
+      }
+      const uint32_t count = reg - start;
+      ClientMessage c(command, getId());
+      c.send_many(start, count);
+      c.send_data(count * sizeof(regs[start]), (void*) &regs[start]);
+    }
+  };
+  if (dirty.vertexConstantsF.any()) {
+    flushConstants(Commands::IDirect3DDevice9Ex_SetVertexShaderConstantF, dirty.vertexConstantsF,
+                   known.vertexConstantsF, m_sentState.vertexConstantsF, m_state.vertexConstants.fConsts);
+  }
+  if (dirty.pixelConstantsF.any()) {
+    flushConstants(Commands::IDirect3DDevice9Ex_SetPixelShaderConstantF, dirty.pixelConstantsF,
+                   known.pixelConstantsF, m_sentState.pixelConstantsF, m_state.pixelConstants.fConsts);
+  }
+
+  dirty = DeferredStateFlags {};
+}
+
+UID BaseDirect3DDevice9Ex_LSS::sendShaderConstantDeltaF(const Commands::D3D9Command command,
+                                                       ConstantDeltaShadow& shadow,
+                                                       const uint32_t numRegs,
+                                                       const uint32_t startRegister,
+                                                       const float* const pConstantData,
+                                                       const uint32_t count) {
+  using Vec4f = ShaderConstants::Vec4<float>;
+  if (shadow.regs.empty()) {
+    shadow.regs.resize(numRegs);
+    shadow.known.resize(numRegs, false);
+  }
+  assert(startRegister + count <= numRegs);
+
+  const uint32_t numMaskWords = (count + 31) / 32;
+  m_constantDeltaMask.assign(numMaskWords, 0);
+  m_constantDeltaRegs.clear();
+  const Vec4f* const pRegs = reinterpret_cast<const Vec4f*>(pConstantData);
+  for (uint32_t i = 0; i < count; i++) {
+    const uint32_t reg = startRegister + i;
+    if (shadow.known[reg] && memcmp(&shadow.regs[reg], &pRegs[i], sizeof(Vec4f)) == 0) {
+      continue;
+    }
+    shadow.regs[reg] = pRegs[i];
+    shadow.known[reg] = true;
+    m_constantDeltaMask[i / 32] |= 1u << (i % 32);
+    m_constantDeltaRegs.push_back(pRegs[i]);
+  }
+
+  ClientMessage c(command, getId(), Commands::FlagBits::DataIsDelta);
+  c.send_many(startRegister, count);
+  c.send_data(numMaskWords * sizeof(uint32_t), m_constantDeltaMask.data());
+  c.send_data(m_constantDeltaRegs.size() * sizeof(Vec4f), m_constantDeltaRegs.data());
+  return c.get_uid();
+}
@@ -29,6 +29,8 @@
 #include "shadow_map.h"
 
 #include <array>
+#include <bitset>
+#include <vector>
 
 class Direct3D9Ex_LSS;
 class Direct3DSwapChain9_LSS;
@@ -292,4 +294,78 @@ protected:
 
   State m_state;
   Direct3DStateBlock9_LSS* m_stateRecording = nullptr;
+
+  // Sends the net delta of the deferred state to the server, see
+  // ClientOptions::getFlushStateDeltaAtDraw(). Must be called before
+  // any command that consumes device state on the server.
+  void flushDeferredState();
+  // Forgets what state was last sent, e.g. after the server state was
+  // changed behind our back by a state block Apply() or device Reset().
+  void invalidateDeferredState();
+
+  template<size_t N>
+  void markDeferredRegisters(std::bitset<N>& dirtyRegs, const uint32_t startRegister, const uint32_t count) {
+    for (uint32_t reg = startRegister; reg < startRegister + count && reg < N; reg++) {
+      dirtyRegs[reg] = true;
+    }
+    m_bDeferredStateDirty = true;
+  }
+
+  struct StreamBinding {
+    uint32_t id;
+    UINT offset;
+    UINT stride;
+    bool operator==(const StreamBinding& other) const {
+      return id == other.id && offset == other.offset && stride == other.stride;
+    }
+  };
+
+  struct DeferredStateFlags {
+    std::bitset<kNumRenderStates> renderStates;
+    std::array<std::bitset<kMaxStageSamplerStateTypes>, kNumStageSamplers> samplerStates;
+    std::bitset<kNumStageSamplers> textures;
+    std::bitset<caps::MaxStreams> streams;
+    std::bitset<caps::MaxFloatConstantsVS> vertexConstantsF;
+    std::bitset<caps::MaxFloatConstantsPS> pixelConstantsF;
+  };
+
+  // Shadow of the deferred state as it was last sent to the server
+  struct SentState {
+    std::array<DWORD, kNumRenderStates> renderStates;
+    std::array<State::SamplerStateArray, kNumStageSamplers> samplerStates;
+    std::array<uint32_t, kNumStageSamplers> textures;
+    std::array<StreamBinding, caps::MaxStreams> streams;
+    std::array<ShaderConstants::Vec4<float>, caps::MaxFloatConstantsVS> vertexConstantsF;
+    std::array<ShaderConstants::Vec4<float>, caps::MaxFloatConstantsPS> pixelConstantsF;
+  };
+
+  bool m_bDeferState = false;
+  bool m_bDeferredStateDirty = false;
+  // Set since the last flush
+  DeferredStateFlags m_deferredDirty;
+  // The value in m_sentState matches the server
+  DeferredStateFlags m_deferredKnown;
+  SentState m_sentState;
+  // Texture and stream bindings are tracked by server id, values set since the last flush
+  std::array<uint32_t, kNumStageSamplers> m_deferredTextures;
+  std::array<StreamBinding, caps::MaxStreams> m_deferredStreams;
+
+  // Float constants as last sent with a delta, see ClientOptions::getShaderConstantDelta()
+  struct ConstantDeltaShadow {
+    std::vector<ShaderConstants::Vec4<float>> regs;
+    std::vector<bool> known;
+  };
+  // Sends the constants as a delta against the shadow and returns the command UID
+  UID sendShaderConstantDeltaF(const Commands::D3D9Command command,
+                               ConstantDeltaShadow& shadow,
+                               const uint32_t numRegs,
+                               const uint32_t startRegister,
+                               const float* const pConstantData,
+                               const uint32_t count);
+
+  bool m_bShaderConstantDelta = false;
+  ConstantDeltaShadow m_vertexConstantDeltaShadow;
+  ConstantDeltaShadow m_pixelConstantDeltaShadow;
+  std::vector<uint32_t> m_constantDeltaMask;
+  std::vector<ShaderConstants::Vec4<float>> m_constantDeltaRegs;
 };
\ No newline at end of file
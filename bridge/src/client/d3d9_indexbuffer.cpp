@@ -63,6 +63,10 @@ ULONG Direct3DIndexBuffer9_LSS::Release() {
 }
 
 void Direct3DIndexBuffer9_LSS::onDestroy() {
+  if (m_trackDirtyPages) {
+    // The server object is going away, pending page updates have nothing to land in
+    cancelPending();
+  }
   ClientMessage { Commands::IDirect3DIndexBuffer9_Destroy, getId() };
 }
 
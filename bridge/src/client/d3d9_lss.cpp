@@ -45,9 +45,12 @@
 #include "util_modulecommand.h"
 #include "util_filesys.h"
 #include "util_hack_d3d_debug.h"
+#include "util_handletable.h"
 #include "util_messagechannel.h"
+#include "util_occlusionqueryresults.h"
 #include "util_seh.h"
 #include "util_semaphore.h"
+#include "util_vertexring.h"
 
 #include <assert.h>
 #include <sstream>
@@ -57,9 +60,23 @@
 
 using namespace bridge_util;
 
-std::atomic<uintptr_t> D3dBaseIdFactory::id_counter = 1;
+namespace {
+  ObjectHandleAllocator& getObjectHandleAllocator() {
+    static ObjectHandleAllocator allocator;
+    return allocator;
+  }
+}
+
 uintptr_t D3dBaseIdFactory::getNextId() {
-  return id_counter++;
+  const uint32_t id = getObjectHandleAllocator().allocate();
+  if (id == 0) {
+    Logger::errLogMessageBoxAndExit(format_string("Out of D3D object handles, more than %d objects are alive at once.", ObjectHandle::kMaxIndex));
+  }
+  return id;
+}
+
+void D3dBaseIdFactory::releaseId(const uintptr_t id) {
+  getObjectHandleAllocator().release((uint32_t) id);
 }
 
 #if defined(_DEBUG) || defined(DEBUGOPT)
@@ -113,8 +130,8 @@ static bool gIsAttached = false;
 Guid gUniqueIdentifier;
 Process* gpServer = nullptr;
 NamedSemaphore* gpPresent = nullptr;
+std::atomic<uint64_t> gSyncedPresentCount = 0;
 ShadowMap gShadowMap;
-std::mutex gShadowMapMutex;
 std::mutex serverStartMutex;
 SceneState gSceneState = WaitBeginScene;
 std::chrono::steady_clock::time_point gTimeStart;
@@ -254,6 +271,12 @@ void InitServer() {
   if (GlobalOptions::getUseSharedHeap()) {
     SharedHeap::init();
   }
+  if (GlobalOptions::getUseVertexRing()) {
+    VertexRing::init();
+  }
+  if (GlobalOptions::getUseAsyncOcclusionQueries()) {
+    OcclusionQueryResults::init();
+  }
 }
 
 bool InitRemixFolder(HMODULE hinst) {
@@ -423,6 +446,22 @@ bool RemixAttach(HMODULE hModule) {
 #endif
 
     gIsAttached = true;
+
+    if (GlobalOptions::getWarmStartServer()) {
+      // We may be inside DllMain here, so the server has to be launched from a thread of its own
+      // that only starts running once the loader lock is released. Direct3DCreate9 blocks in
+      // InitServer() until this thread is done with the handshake.
+      Logger::info("Warm start enabled, launching server ahead of D3D9 object creation.");
+      const HANDLE hThread = CreateThread(nullptr, 0, [](LPVOID) -> DWORD {
+        InitServer();
+        return 0;
+      }, nullptr, 0, nullptr);
+      if (hThread != nullptr) {
+        CloseHandle(hThread);
+      } else {
+        Logger::warn("Unable to create the warm start thread, the server will be launched on D3D9 object creation.");
+      }
+    }
   }
 
   return true;
@@ -639,6 +639,10 @@ std::tuple<HRESULT, BaseDirect3DDevice9Ex_LSS*> Direct3D9Ex_LSS::createDevice(
   if ((0 != (createParams.BehaviorFlags & D3DCREATE_MULTITHREADED) && policy == 0) || policy == 1) {
 #ifdef WITH_MULTITHREADED_DEVICE
     Logger::info("Creating a thread-safe D3D9 device.");
+    if (ClientOptions::getPerThreadCommandRecording()) {
+      Logger::info("Per-thread command recording enabled.");
+      DeviceBridge::setCommandRecordingEnabled(true);
+    }
     pNewDevice = new Direct3DDevice9Ex_LSS<true>(
       bExtended, pDirect3D, createParams, localPresParam, pFullscreenDisplayMode, createDeviceHresult);
 #else
@@ -54,6 +54,10 @@ ULONG Direct3DQuery9_LSS::Release() {
 void Direct3DQuery9_LSS::onDestroy() {
   LogFunctionCall();
   ClientMessage { Commands::IDirect3DQuery9_Destroy, getId() };
+  // Results the server still publishes to the slot carry issue numbers the next owner never matches
+  if (m_resultSlot != OcclusionQueryResults::kInvalidSlot) {
+    OcclusionQueryResults::releaseSlot(m_resultSlot);
+  }
 }
 
 HRESULT Direct3DQuery9_LSS::GetDevice(IDirect3DDevice9** ppDevice) {
@@ -98,6 +102,11 @@ HRESULT Direct3DQuery9_LSS::Issue(DWORD dwIssueFlags) {
     ClientMessage c(Commands::IDirect3DQuery9_Issue, getId());
     currentUID = c.get_uid();
     c.send_data(dwIssueFlags);
+    if (m_resultSlot != OcclusionQueryResults::kInvalidSlot) {
+      // Beginning the query again also invalidates the result of the previous issue
+      m_lastIssue = OcclusionQueryResults::nextIssue();
+      c.send_data(m_lastIssue);
+    }
   }
   WAIT_FOR_OPTIONAL_SERVER_RESPONSE("Direct3DQuery9_LSS::Issue()", D3DERR_INVALIDCALL, currentUID);
 
@@ -107,6 +116,28 @@ HRESULT Direct3DQuery9_LSS::Issue(DWORD dwIssueFlags) {
 HRESULT Direct3DQuery9_LSS::GetData(void* pData, DWORD dwSize, DWORD dwGetDataFlags) {
   LogFunctionCall();
 
+  // The server answers GetData of occlusion queries that have been ended through the result slot
+  if (m_resultSlot != OcclusionQueryResults::kInvalidSlot && m_lastIssue != 0) {
+    DWORD result = 0;
+    if (OcclusionQueryResults::tryGetResult(m_resultSlot, m_lastIssue, result)) {
+      if (dwSize > 0 && pData != NULL) {
+        memcpy(pData, &result, std::min<DWORD>(dwSize, sizeof(result)));
+      }
+      return S_OK;
+    }
+
+    // Have the server check on the query, without waiting for it
+    {
+      ClientMessage c(Commands::IDirect3DQuery9_GetData, getId());
+      c.send_data(dwSize);
+      c.send_data(dwGetDataFlags);
+    }
+    if (dwGetDataFlags & D3DGETDATA_FLUSH) {
+      DeviceBridge::flushRecordedCommands();
+    }
+    return S_FALSE;
+  }
+
   UID currentUID = 0;
   {
     ClientMessage c(Commands::IDirect3DQuery9_GetData, getId());
@@ -24,10 +24,15 @@
 #include "d3d9_util.h"
 #include "base.h"
 #include "d3d9_device_base.h"
+#include "util_occlusionqueryresults.h"
 
 class Direct3DQuery9_LSS: public D3DBase<IDirect3DQuery9> {
   void onDestroy() override;
   D3DQUERYTYPE m_type;
+  // Slot the server publishes the results of this occlusion query to, see OcclusionQueryResults
+  uint32_t m_resultSlot = OcclusionQueryResults::kInvalidSlot;
+  // Issue number of the most recent Issue(), 0 until the query has been issued once
+  uint32_t m_lastIssue = 0;
 
 protected:
   BaseDirect3DDevice9Ex_LSS* const m_pDevice = nullptr;
@@ -36,6 +41,13 @@ public:
     : D3DBase<IDirect3DQuery9>((IDirect3DQuery9*) nullptr, pDevice)
     , m_pDevice(pDevice)
     , m_type(Type) {
+    if (m_type == D3DQUERYTYPE_OCCLUSION && OcclusionQueryResults::isEnabled()) {
+      m_resultSlot = OcclusionQueryResults::allocateSlot();
+    }
+  }
+
+  uint32_t getResultSlot() const {
+    return m_resultSlot;
   }
 
   /*** IUnknown methods ***/
@@ -200,6 +200,7 @@ HRESULT Direct3DStateBlock9_LSS::Capture() {
     return D3DERR_INVALIDCALL;
   }
   LocalCapture();
+  m_pDevice->flushDeferredState();
   {
     ClientMessage { Commands::IDirect3DStateBlock9_Capture, getId() };
   }
@@ -208,9 +209,11 @@ HRESULT Direct3DStateBlock9_LSS::Capture() {
 
 HRESULT Direct3DStateBlock9_LSS::Apply() {
   LogFunctionCall();
+  m_pDevice->flushDeferredState();
   StateTransfer(m_dirtyFlags, m_captureState, m_pDevice->m_state);
   {
     ClientMessage { Commands::IDirect3DStateBlock9_Apply, getId() };
   }
+  m_pDevice->invalidateDeferredState();
   return S_OK;
 }
@@ -28,6 +28,7 @@
 #include "d3d9_cubetexture.h"
 
 #include "d3d9_surfacebuffer_helper.h"
+#include "surface_upload_batch.h"
 #include "util_bridge_assert.h"
 #include "util_gdi.h"
 
@@ -93,6 +94,7 @@ void Direct3DSurface9_LSS::onDestroy() {
   const auto command = isStandalone() ? Commands::IDirect3DSurface9_Destroy :
     Commands::Bridge_UnlinkResource;
 
+  SurfaceUploadBatch::flush();
   ClientMessage { command, getId() };
 }
 
@@ -262,6 +264,14 @@ void* Direct3DSurface9_LSS::getBufPtr(const int pitch, const RECT& rect) {
 }
 
 void Direct3DSurface9_LSS::sendDataToServer(const LockInfo& lockInfo) const {
+  if (SurfaceUploadBatch::isEnabled()) {
+    const auto bufId = m_bUseSharedHeap ? lockInfo.bufId : SharedHeap::kInvalidId;
+    if (SurfaceUploadBatch::add(getId(), lockInfo.rect, lockInfo.flags, m_desc.Format,
+                                lockInfo.lockedRect, bufId, lockInfo.discardBufId)) {
+      return;
+    }
+  }
+
   const auto dataFlag = m_bUseSharedHeap ? Commands::FlagBits::DataInSharedHeap : 0;
   {
     ClientMessage c(Commands::IDirect3DSurface9_UnlockRect, getId(), dataFlag);
@@ -276,7 +286,17 @@ void Direct3DSurface9_LSS::sendDataToServer(const LockInfo& lockInfo) const {
       const size_t totalSize = bridge_util::calcTotalSizeOfRect(width, height, m_desc.Format);
       const size_t rowSize = bridge_util::calcRowSize(width, m_desc.Format);
       c.send_data(rowSize);
-      if (auto* blobPacketPtr = c.begin_data_blob(totalSize)) {
+      if (GlobalOptions::getCompressDataBlobs() && totalSize >= GlobalOptions::getCompressDataBlobsThreshold()) {
+        // Pack the rows first so the whole rect can be compressed as one blob
+        thread_local std::vector<uint8_t> packedRows;
+        packedRows.resize(totalSize);
+        uint8_t* pPackedRow = packedRows.data();
+        FOR_EACH_RECT_ROW(lockInfo.lockedRect, height, m_desc.Format, {
+          memcpy(pPackedRow, ptr, rowSize);
+          pPackedRow += rowSize;
+        });
+        c.send_data(totalSize, packedRows.data());
+      } else if (auto* blobPacketPtr = c.begin_data_blob(totalSize)) {
         FOR_EACH_RECT_ROW(lockInfo.lockedRect, height, m_desc.Format, {
           memcpy(blobPacketPtr, ptr, rowSize);
           blobPacketPtr += rowSize;
@@ -24,7 +24,10 @@
 #include "d3d9_swapchain.h"
 #include "d3d9_surface.h"
 #include "d3d9_surfacebuffer_helper.h"
+#include "lockable_buffer.h"
+#include "surface_upload_batch.h"
 #include "swapchain_map.h"
+#include "util_deferrederrors.h"
 
 extern std::mutex gSwapChainMapMutex;
 extern SwapChainMap gSwapChainMap;
@@ -168,6 +171,18 @@ HRESULT Direct3DSwapChain9_LSS::Present(CONST RECT* pSourceRect, CONST RECT* pDe
     return D3D_OK;
   }
 
+  // Buffer updates still pending at the end of the frame go out before Present
+  DeferredBufferUpdate::flushAll();
+  SurfaceUploadBatch::flush();
+
+  // The application simulated its frame from the return of the previous Present until now,
+  // the server hands these on to the renderer to measure the bridge transit of the frame
+  static uint64_t simulationStart = 0;
+  LARGE_INTEGER simulationEnd;
+  QueryPerformanceCounter(&simulationEnd);
+  const uint64_t frameTimes[2] = { simulationStart != 0 ? simulationStart : (uint64_t) simulationEnd.QuadPart,
+                                   (uint64_t) simulationEnd.QuadPart };
+
   // Send present first
   {
     ClientMessage c(Commands::IDirect3DSwapChain9_Present, getId());
@@ -176,14 +191,29 @@ HRESULT Direct3DSwapChain9_LSS::Present(CONST RECT* pSourceRect, CONST RECT* pDe
     c.send_data((uint32_t) hDestWindowOverride);
     c.send_data(sizeof(RGNDATA), (void*) pDirtyRegion);
     c.send_data(dwFlags);
+    c.send_data(sizeof(frameTimes), (void*) frameTimes);
   }
 
   extern HRESULT syncOnPresent();
   const auto syncResult = syncOnPresent();
+
+  LARGE_INTEGER presentEnd;
+  QueryPerformanceCounter(&presentEnd);
+  simulationStart = presentEnd.QuadPart;
+
   if (syncResult == ERROR_SEM_TIMEOUT) {
     return ERROR_SEM_TIMEOUT;
   }
 
+  // Report resource creation failures the server ran into since the last Present
+  if (GlobalOptions::getAsyncResourceCreation()) {
+    const auto createErrors = DeferredCreateErrors::consume();
+    if (createErrors.numErrors > 0) {
+      Logger::err(format_string("%d asynchronous resource creation call(s) failed on the server, last failure: %s (0x%x).",
+                                createErrors.numErrors, Commands::toString(createErrors.lastCommand).c_str(), createErrors.lastHResult));
+    }
+  }
+
   FrameMark;
 
   return D3D_OK;
@@ -26,6 +26,7 @@
 #include "d3d9_util.h"
 #include "d3d9_surface.h"
 #include "shadow_map.h"
+#include "surface_upload_batch.h"
 #include "util_bridge_assert.h"
 
 #include <d3d9.h>
@@ -66,6 +67,7 @@ ULONG Direct3DTexture9_LSS::Release() {
 }
 
 void Direct3DTexture9_LSS::onDestroy() {
+  SurfaceUploadBatch::flush();
   ClientMessage { Commands::IDirect3DTexture9_Destroy, getId() };
 }
 
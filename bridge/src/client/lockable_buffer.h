@@ -27,10 +27,83 @@
 #include "d3d9_util.h"
 
 #include <d3d9.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <queue>
+#include <vector>
+
+// Number of Present() calls for which the client has already passed the Present semaphore.
+// Used to tell when the server is guaranteed to be done reading shared heap allocations.
+extern std::atomic<uint64_t> gSyncedPresentCount;
+
+// Registry of buffers holding dirty pages that were not sent to the server yet. Pending
+// updates must be flushed before anything on the server may read the buffers, i.e. before
+// every draw call and at Present.
+class DeferredBufferUpdate {
+public:
+  static void flushAll() {
+    if (s_numPending.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+    std::lock_guard lock(s_mutex);
+    for (auto* pUpdate : s_pending) {
+      pUpdate->flushDirtyPages();
+      pUpdate->m_bPending = false;
+    }
+    s_pending.clear();
+    s_numPending.store(0, std::memory_order_release);
+  }
+
+protected:
+  virtual ~DeferredBufferUpdate() = default;
+
+  // Called with the registry lock held
+  virtual void flushDirtyPages() = 0;
+
+  // Must be called with the registry lock held
+  void markPending() {
+    if (!m_bPending) {
+      m_bPending = true;
+      s_pending.push_back(this);
+      s_numPending.store(s_pending.size(), std::memory_order_release);
+    }
+  }
+
+  // Flushes the pending update of this buffer alone, used when the backing store is about to change
+  void flushPending() {
+    std::lock_guard lock(s_mutex);
+    if (m_bPending) {
+      flushDirtyPages();
+      removePending();
+    }
+  }
+
+  // Drops the pending update, used when the buffer is destroyed
+  void cancelPending() {
+    std::lock_guard lock(s_mutex);
+    if (m_bPending) {
+      removePending();
+    }
+  }
+
+  inline static std::mutex s_mutex;
+
+private:
+  void removePending() {
+    s_pending.erase(std::find(s_pending.begin(), s_pending.end(), this));
+    s_numPending.store(s_pending.size(), std::memory_order_release);
+    m_bPending = false;
+  }
+
+  bool m_bPending = false;
+  inline static std::vector<DeferredBufferUpdate*> s_pending;
+  inline static std::atomic<size_t> s_numPending = 0;
+};
 
 template <typename T>
-class LockableBuffer: public Direct3DResource9_LSS<T> {
+class LockableBuffer: public Direct3DResource9_LSS<T>, protected DeferredBufferUpdate {
   static constexpr bool bIsVertexBuffer = std::is_same_v<IDirect3DVertexBuffer9, T>;
   static constexpr Commands::D3D9Command LockCmd = bIsVertexBuffer ?
     Commands::IDirect3DVertexBuffer9_Lock : Commands::IDirect3DIndexBuffer9_Lock;
@@ -51,6 +124,21 @@ class LockableBuffer: public Direct3DResource9_LSS<T> {
   };
   std::queue<LockInfo> m_lockInfos;
 
+  // Shared heap allocations retired by D3DLOCK_DISCARD together with the present count at
+  // the time of retirement. These are recycled once the server can no longer be reading them,
+  // which avoids a SharedHeap allocate/deallocate round trip on every discard.
+  struct RetiredBuffer {
+    SharedHeap::AllocId bufferId;
+    uint64_t presentCount;
+  };
+  std::deque<RetiredBuffer> m_retiredBufferIds;
+  // Set when m_bufferId was referenced by an Unlock command the server may not have processed yet
+  bool m_bBufferIdInFlight = false;
+
+  // One bit per page of the buffer, only used when m_trackDirtyPages is set
+  std::vector<uint64_t> m_dirtyPages;
+  const uint32_t m_dirtyPageSize;
+
   const bool m_bUseSharedHeap = false;
   std::unique_ptr<uint8_t[]> m_shadow;
   inline static size_t g_totalBufferShadow = 0;
@@ -62,7 +150,9 @@ public:
 
 private:
   static bool getSharedHeapPolicy(const DescType& desc) {
-    if (GlobalOptions::getUseSharedHeap()) {
+    if (GlobalOptions::getUseSharedHeapForAllBuffers()) {
+      return true;
+    } else if (GlobalOptions::getUseSharedHeap()) {
       return (desc.Usage & D3DUSAGE_DYNAMIC) ?
         GlobalOptions::getUseSharedHeapForDynamicBuffers() :
         GlobalOptions::getUseSharedHeapForStaticBuffers();
@@ -71,6 +161,105 @@ private:
     }
   }
 
+  static bool canRecycleRetiredBuffers() {
+    return GlobalOptions::getUseSharedHeapForAllBuffers() && GlobalOptions::getPresentSemaphoreEnabled();
+  }
+
+  // The client may run at most presentSemaphoreMaxFrames ahead of the server, so an allocation
+  // retired before the N-th Present is guaranteed to be consumed once N + maxFrames Presents
+  // have passed the semaphore.
+  static bool isRetiredBufferIdle(const RetiredBuffer& retired) {
+    return gSyncedPresentCount.load(std::memory_order_relaxed) >
+      retired.presentCount + GlobalOptions::getPresentSemaphoreMaxFrames();
+  }
+
+  SharedHeap::AllocId allocateDiscardBuffer() {
+    if (!m_retiredBufferIds.empty() && isRetiredBufferIdle(m_retiredBufferIds.front())) {
+      const auto bufferId = m_retiredBufferIds.front().bufferId;
+      m_retiredBufferIds.pop_front();
+      return bufferId;
+    }
+    return SharedHeap::allocate(m_desc.Size);
+  }
+
+  void retireBuffer(const SharedHeap::AllocId bufferId) {
+    m_retiredBufferIds.push_back({ bufferId, gSyncedPresentCount.load(std::memory_order_relaxed) });
+    // Bound the number of allocations kept per buffer, anything beyond what the frame
+    // latency can cover is handed back to the heap.
+    const size_t maxRetired = GlobalOptions::getPresentSemaphoreMaxFrames() + 2;
+    while (m_retiredBufferIds.size() > maxRetired) {
+      SharedHeap::deallocate(m_retiredBufferIds.front().bufferId);
+      m_retiredBufferIds.pop_front();
+    }
+  }
+
+  void markDirtyPages(const size_t offset, const size_t size) {
+    if (size == 0) {
+      return;
+    }
+    const size_t firstPage = offset / m_dirtyPageSize;
+    const size_t lastPage = (offset + size - 1) / m_dirtyPageSize;
+    std::lock_guard lock(s_mutex);
+    if (m_dirtyPages.empty()) {
+      const size_t numPages = (m_desc.Size + m_dirtyPageSize - 1) / m_dirtyPageSize;
+      m_dirtyPages.resize((numPages + 63) / 64, 0);
+    }
+    for (size_t page = firstPage; page <= lastPage; ++page) {
+      m_dirtyPages[page / 64] |= 1ull << (page % 64);
+    }
+    markPending();
+  }
+
+  // Sends all dirty pages of the buffer as one coalesced Unlock. The server locks the span
+  // covering all dirty ranges once and copies every range into it.
+  void flushDirtyPages() override {
+    struct Range {
+      uint32_t offset;
+      uint32_t size;
+    };
+    std::vector<Range> ranges;
+    const size_t numPages = (m_desc.Size + m_dirtyPageSize - 1) / m_dirtyPageSize;
+    size_t page = 0;
+    while (page < numPages) {
+      if ((m_dirtyPages[page / 64] & (1ull << (page % 64))) == 0) {
+        ++page;
+        continue;
+      }
+      const size_t firstPage = page;
+      while (page < numPages && (m_dirtyPages[page / 64] & (1ull << (page % 64))) != 0) {
+        ++page;
+      }
+      const uint32_t offset = firstPage * m_dirtyPageSize;
+      const uint32_t end = std::min<size_t>(page * m_dirtyPageSize, m_desc.Size);
+      ranges.push_back({ offset, end - offset });
+    }
+    std::fill(m_dirtyPages.begin(), m_dirtyPages.end(), 0);
+
+    if (ranges.empty()) {
+      return;
+    }
+
+    const uint32_t spanOffset = ranges.front().offset;
+    const uint32_t spanSize = ranges.back().offset + ranges.back().size - spanOffset;
+    Commands::Flags cmdFlags = Commands::FlagBits::DataHasRanges;
+    if (m_bUseSharedHeap) {
+      cmdFlags |= Commands::FlagBits::DataInSharedHeap;
+    }
+    ClientMessage c(UnlockCmd, getId(), cmdFlags);
+    c.send_many(spanOffset, spanSize, (DWORD) 0);
+    c.send_data((uint32_t) ranges.size());
+    if (m_bUseSharedHeap) {
+      c.send_data(m_bufferId);
+      m_bBufferIdInFlight = true;
+    }
+    for (const auto& range : ranges) {
+      c.send_many(range.offset, range.size);
+      if (!m_bUseSharedHeap) {
+        c.send_data(range.size, m_shadow.get() + range.offset);
+      }
+    }
+  }
+
   void initShadowMem() {
     m_shadow = std::make_unique<uint8_t[]>(m_desc.Size);
     g_totalBufferShadow += m_desc.Size;
@@ -85,13 +274,16 @@ protected:
   SharedHeap::AllocId m_bufferId = SharedHeap::kInvalidId;
   const bool m_sendWhole = false;
   const bool m_optimizedLock = false;
+  const bool m_trackDirtyPages = false;
 
   LockableBuffer(T* const pD3dBuf, BaseDirect3DDevice9Ex_LSS* const pDevice, const DescType& desc)
     : Direct3DResource9_LSS<T>(pD3dBuf, pDevice)
     , m_desc(desc)
     , m_bUseSharedHeap(getSharedHeapPolicy(m_desc))
     , m_sendWhole((desc.Usage& D3DUSAGE_DYNAMIC) == 0 && GlobalOptions::getAlwaysCopyEntireStaticBuffer())
-    , m_optimizedLock((desc.Usage& D3DUSAGE_DYNAMIC) != 0 && ClientOptions::getOptimizedDynamicLock()) {
+    , m_optimizedLock((desc.Usage& D3DUSAGE_DYNAMIC) != 0 && ClientOptions::getOptimizedDynamicLock())
+    , m_trackDirtyPages((desc.Usage& D3DUSAGE_DYNAMIC) == 0 && !m_sendWhole && ClientOptions::getTrackStaticBufferDirtyPages())
+    , m_dirtyPageSize(std::max(ClientOptions::getStaticBufferDirtyPageSize(), 1u)) {
     if (!m_bUseSharedHeap) {
       initShadowMem();
     }
@@ -102,6 +294,9 @@ protected:
       if (m_bufferId != SharedHeap::kInvalidId) {
         SharedHeap::deallocate(m_bufferId);
       }
+      for (const auto& retired : m_retiredBufferIds) {
+        SharedHeap::deallocate(retired.bufferId);
+      }
     } else if (m_shadow) {
       g_totalBufferShadow -= m_desc.Size;
       Logger::trace(format_string("Released shadow of dynamic %s buffer [%p] "
@@ -120,14 +315,29 @@ protected:
 
     if (m_bUseSharedHeap) {
       SharedHeap::AllocId discardedBufferId = SharedHeap::kInvalidId;
-      const bool bDiscard = (flags & D3DLOCK_DISCARD) != 0;
+      // Discarding an allocation the server has never seen is a no-op, keep using it
+      const bool bDiscard = (flags & D3DLOCK_DISCARD) != 0 && m_bBufferIdInFlight;
+      SharedHeap::AllocId nextBufId = m_bufferId;
       if (bDiscard && (m_bufferId != SharedHeap::kInvalidId)) {
-        // If D3DLOCK_DISCARD is an active flag, we must begin the process of dealloc'ing
-        // and freeing that buffer from the shared heap
-        discardedBufferId = m_bufferId;
+        if (m_trackDirtyPages) {
+          // Pending pages refer to the allocation that is about to be discarded
+          flushPending();
+        }
+        if (canRecycleRetiredBuffers()) {
+          // Keep the discarded allocation around for reuse after the server is done with it
+          retireBuffer(m_bufferId);
+          nextBufId = allocateDiscardBuffer();
+        } else {
+          // If D3DLOCK_DISCARD is an active flag, we must begin the process of dealloc'ing
+          // and freeing that buffer from the shared heap
+          discardedBufferId = m_bufferId;
+          nextBufId = SharedHeap::allocate(m_desc.Size);
+        }
+        m_bBufferIdInFlight = false;
+      } else if (m_bufferId == SharedHeap::kInvalidId) {
+        nextBufId = SharedHeap::allocate(m_desc.Size);
       }
-      const auto nextBufId = (bDiscard || (m_bufferId == SharedHeap::kInvalidId)) ?
-        m_bufferId = SharedHeap::allocate(m_desc.Size) : m_bufferId;
+      m_bufferId = nextBufId;
       if (nextBufId == SharedHeap::kInvalidId) {
         std::stringstream ss;
         ss << "[LockableBuffer][Lock] Failed to allocate on SharedHeap: {";
@@ -139,7 +349,6 @@ protected:
         Logger::err(ss.str());
         return E_FAIL;
       }
-      m_bufferId = nextBufId;
       *ppbData = SharedHeap::getBuf(m_bufferId) + offset;
       m_lockInfos.push({ offset, size, nullptr, flags, checkPtr, m_bufferId, discardedBufferId });
     } else {
@@ -190,7 +399,11 @@ protected:
 
     // If this is a read only access then don't bother sending
     if ((lockInfo.flags & D3DLOCK_READONLY) == 0) {
-      {
+      if (m_trackDirtyPages) {
+        // The locked data already lives in the shadow or the shared heap, only record the
+        // touched pages and send them coalesced before the next draw
+        markDirtyPages(offset, size);
+      } else {
         Commands::Flags cmdFlags = 0;
 
         if (m_bUseSharedHeap) {
@@ -211,6 +424,7 @@ protected:
 
         if (m_bUseSharedHeap) {
           c.send_data(lockInfo.bufferId);
+          m_bBufferIdInFlight = true;
         } else if (m_optimizedLock) {
           // Now send data offset in the channel
           const uint32_t dataOffset = static_cast<uint32_t*>(ptr) -
@@ -20,10 +20,12 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include "client_options.h"
 #include "log/log.h"
 #include "util_bridgecommand.h"
 #include "util_devicecommand.h"
 #include "util_remixapi.h"
+#include "util_vertexring.h"
 
 using namespace remixapi::util;
 
@@ -161,16 +163,10 @@ remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyMaterial(remixapi_MaterialHandl
   return REMIXAPI_ERROR_CODE_SUCCESS;
 }
 
-remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMesh(
-  const remixapi_MeshInfo* info,
-  remixapi_MeshHandle*     out_handle) {
-
-  ASSERT_REMIXAPI_PFN_TYPE(remixapi_CreateMesh);
-  assert(info->sType == REMIXAPI_STRUCT_TYPE_MESH_INFO);
-
+static remixapi_MeshHandle sendMeshInfo(const Commands::D3D9Command command, const remixapi_MeshInfo* info) {
   MeshHandle newHandle;
   {
-    ClientMessage c(Commands::RemixApi_CreateMesh);
+    ClientMessage c(command);
     
     serializeAndSend<serialize::MeshInfo>(c, *info);
 
@@ -186,12 +182,55 @@ remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMesh(
     }
     sendHandle(c, newHandle);
   }
-  
-  *out_handle = newHandle;
+  return newHandle;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMesh(
+  const remixapi_MeshInfo* info,
+  remixapi_MeshHandle*     out_handle) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_CreateMesh);
+  assert(info->sType == REMIXAPI_STRUCT_TYPE_MESH_INFO);
+
+  *out_handle = sendMeshInfo(Commands::RemixApi_CreateMesh, info);
 
   return REMIXAPI_ERROR_CODE_SUCCESS;
 }
 
+remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMeshAsync(
+  const remixapi_MeshInfo* info,
+  remixapi_MeshHandle*     out_handle) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_CreateMeshAsync);
+  assert(info->sType == REMIXAPI_STRUCT_TYPE_MESH_INFO);
+
+  *out_handle = sendMeshInfo(Commands::RemixApi_CreateMeshAsync, info);
+
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateMeshVertices(
+  remixapi_MeshHandle             handle,
+  uint32_t                        surfaceIndex,
+  uint64_t                        firstVertex,
+  const remixapi_HardcodedVertex* vertices_values,
+  uint64_t                        vertices_count) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_UpdateMeshVertices);
+  MeshHandle meshHandle(handle);
+  if(!meshHandle.isValid() || !vertices_values || vertices_count == 0) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  {
+    ClientMessage c(Commands::RemixApi_UpdateMeshVertices);
+    sendHandle(c, meshHandle);
+    c.send_data(surfaceIndex);
+    c.send_data(sizeof(firstVertex), &firstVertex);
+    c.send_data((uint32_t) (vertices_count * sizeof(remixapi_HardcodedVertex)), vertices_values);
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
 remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyMesh(remixapi_MeshHandle handle) {
   ASSERT_REMIXAPI_PFN_TYPE(remixapi_DestroyMesh);
   MeshHandle meshHandle(handle);
@@ -205,55 +244,277 @@ remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyMesh(remixapi_MeshHandle handle
   return REMIXAPI_ERROR_CODE_SUCCESS;
 }
 
-remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawInstance(const remixapi_InstanceInfo* info) {
-  ASSERT_REMIXAPI_PFN_TYPE(remixapi_DrawInstance);
-  {
-    ClientMessage c(Commands::RemixApi_DrawInstance);
+// Bone palettes of all instances of a command are written straight into the vertex ring in
+// a single reservation, instances then only carry the offset of their palette within it.
+// Without the ring, or if the palettes don't fit, they are serialized with the instance.
+class BonePaletteWriter {
+public:
+  BonePaletteWriter(const remixapi_InstanceInfo* infos, const uint32_t count)
+    : m_ringWriter(getPalettesSize(infos, count)) { }
 
-    serializeAndSend<serialize::InstanceInfo>(c, *info);
+  Commands::Flags getFlags() const {
+    return m_ringWriter.isValid() ? Commands::FlagBits::DataInVertexRing : 0;
+  }
 
-    // For each valid pNext, we will send a true-valued bool to indicate that
-    // server must read another extension. If it reads false, it knows that it
-    // is done reading.
-    // send(c, Bool::True); -> CONTINUE
-    // send(c, Bool::False); -> STOP
-    const void* infoItr = info;
-    while (auto* const pNext = getPNext(infoItr)) {
-      infoItr = pNext;
-      switch (getSType(pNext)) {
-        case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_OBJECT_PICKING_EXT:
-        {
-          auto* pObjectPicking = static_cast<const remixapi_InstanceInfoObjectPickingEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::InstanceInfoObjectPicking>(c, *pObjectPicking);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BLEND_EXT:
-        {
-          auto* pBlend = static_cast<const remixapi_InstanceInfoBlendEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::InstanceInfoBlend>(c, *pBlend);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT:
-        {
+  // Must be sent ahead of the instances
+  void sendRingPos(ClientMessage& c) const {
+    if (m_ringWriter.isValid()) {
+      c.send_many(m_ringWriter.getPos(), m_ringWriter.getSize());
+    }
+  }
+
+  void send(ClientMessage& c, const remixapi_InstanceInfoBoneTransformsEXT& xforms) {
+    if (!m_ringWriter.isValid()) {
+      serializeAndSend<serialize::InstanceInfoTransforms>(c, xforms);
+      return;
+    }
+    const uint32_t size = xforms.boneTransforms_count * sizeof(remixapi_Transform);
+    memcpy(m_ringWriter.data() + m_offset, xforms.boneTransforms_values, size);
+    c.send_data(ToRemixApiStructEnum<remixapi_InstanceInfoBoneTransformsEXT>);
+    c.send_many(xforms.boneTransforms_count, m_offset);
+    m_offset += size;
+  }
+
+private:
+  static uint32_t getPalettesSize(const remixapi_InstanceInfo* infos, const uint32_t count) {
+    if (!VertexRing::isEnabled()) {
+      return 0;
+    }
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      const void* infoItr = &infos[i];
+      while (auto* const pNext = getPNext(infoItr)) {
+        infoItr = pNext;
+        if (getSType(pNext) == REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT) {
           auto* pXforms = static_cast<const remixapi_InstanceInfoBoneTransformsEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::InstanceInfoTransforms>(c, *pXforms);
-          break;
-        }
-        default:
-        {
-          Logger::warn("[remixapi_DrawInstance] Unknown sType. Skipping.");
-          break;
+          size += pXforms->boneTransforms_count * sizeof(remixapi_Transform);
         }
       }
     }
-    send(c, Bool::False);
+    return size;
+  }
+
+  VertexRing::Writer m_ringWriter;
+  uint32_t m_offset = 0;
+};
+
+static void sendInstanceInfo(ClientMessage& c, const remixapi_InstanceInfo& info, BonePaletteWriter& bonePalettes) {
+  serializeAndSend<serialize::InstanceInfo>(c, info);
+
+  // For each valid pNext, we will send a true-valued bool to indicate that
+  // server must read another extension. If it reads false, it knows that it
+  // is done reading.
+  // send(c, Bool::True); -> CONTINUE
+  // send(c, Bool::False); -> STOP
+  const void* infoItr = &info;
+  while (auto* const pNext = getPNext(infoItr)) {
+    infoItr = pNext;
+    switch (getSType(pNext)) {
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_OBJECT_PICKING_EXT:
+      {
+        auto* pObjectPicking = static_cast<const remixapi_InstanceInfoObjectPickingEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::InstanceInfoObjectPicking>(c, *pObjectPicking);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BLEND_EXT:
+      {
+        auto* pBlend = static_cast<const remixapi_InstanceInfoBlendEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::InstanceInfoBlend>(c, *pBlend);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT:
+      {
+        auto* pXforms = static_cast<const remixapi_InstanceInfoBoneTransformsEXT* const>(infoItr);
+        send(c, Bool::True);
+        bonePalettes.send(c, *pXforms);
+        break;
+      }
+      default:
+      {
+        Logger::warn("[remixapi_DrawInstance] Unknown sType. Skipping.");
+        break;
+      }
+    }
+  }
+  send(c, Bool::False);
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawInstance(const remixapi_InstanceInfo* info) {
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_DrawInstance);
+  {
+    // The palette writer must outlive the command, see VertexRing::Writer
+    BonePaletteWriter bonePalettes(info, 1);
+    ClientMessage c(Commands::RemixApi_DrawInstance, 0, bonePalettes.getFlags());
+    bonePalettes.sendRingPos(c);
+    sendInstanceInfo(c, *info, bonePalettes);
   }
   return REMIXAPI_ERROR_CODE_SUCCESS;
 }
 
+remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawInstances(const remixapi_InstanceInfo* infos, uint32_t infos_count) {
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_DrawInstances);
+  if (infos_count == 0) {
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+  if (!infos) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  {
+    // The whole batch goes out as one command so the server can hand it to Remix in one call
+    BonePaletteWriter bonePalettes(infos, infos_count);
+    ClientMessage c(Commands::RemixApi_DrawInstances, 0, bonePalettes.getFlags());
+    bonePalettes.sendRingPos(c);
+    c.send_data(infos_count);
+    for (uint32_t i = 0; i < infos_count; i++) {
+      sendInstanceInfo(c, infos[i], bonePalettes);
+    }
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateInstance(
+  const remixapi_InstanceInfo* info,
+  remixapi_InstanceHandle*     out_handle) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_CreateInstance);
+  assert(info->sType == REMIXAPI_STRUCT_TYPE_INSTANCE_INFO);
+
+  InstanceHandle newHandle;
+  {
+    BonePaletteWriter bonePalettes(info, 1);
+    ClientMessage c(Commands::RemixApi_CreateInstance, 0, bonePalettes.getFlags());
+    bonePalettes.sendRingPos(c);
+    sendInstanceInfo(c, *info, bonePalettes);
+    sendHandle(c, newHandle);
+  }
+
+  *out_handle = newHandle;
+
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateInstanceTransform(
+  remixapi_InstanceHandle   handle,
+  const remixapi_Transform* transform) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_UpdateInstanceTransform);
+  InstanceHandle instanceHandle(handle);
+  if(!instanceHandle.isValid() || !transform) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  {
+    ClientMessage c(Commands::RemixApi_UpdateInstanceTransform);
+    sendHandle(c, instanceHandle);
+    c.send_data(sizeof(remixapi_Transform), transform);
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateInstanceMaterial(
+  remixapi_InstanceHandle handle,
+  remixapi_MaterialHandle material) {
+
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_UpdateInstanceMaterial);
+  InstanceHandle instanceHandle(handle);
+  if(!instanceHandle.isValid()) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  {
+    ClientMessage c(Commands::RemixApi_UpdateInstanceMaterial);
+    sendHandle(c, instanceHandle);
+    // Null material is sent as uid 0, which restores the mesh's own materials
+    c.send_data((uint32_t) (uintptr_t) material);
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyInstance(remixapi_InstanceHandle handle) {
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_DestroyInstance);
+  InstanceHandle instanceHandle(handle);
+  if(!instanceHandle.isValid()) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  {
+    ClientMessage c(Commands::RemixApi_DestroyInstance);
+    sendHandle(c, instanceHandle);
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
+// Sends a light and its pNext chain, read back by the server's PullRemixApiLight
+static void sendLightInfo(ClientMessage& c, const remixapi_LightInfo& info) {
+  serializeAndSend<serialize::LightInfo>(c, info);
+  
+  // For each valid pNext, we will send a true-valued bool to indicate that
+  // server must read another extension. If it reads false, it knows that it
+  // is done reading.
+  // send(c, Bool::True); -> CONTINUE
+  // send(c, Bool::False); -> STOP
+  const void* infoItr = &info;
+  while (auto* const pNext = getPNext(infoItr)) {
+    infoItr = pNext;
+    switch (getSType(infoItr)) {
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_SPHERE_EXT:
+      {
+        auto* pSphere = static_cast<const remixapi_LightInfoSphereEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoSphere>(c, *pSphere);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_RECT_EXT:
+      {
+        auto* pRect = static_cast<const remixapi_LightInfoRectEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoRect>(c, *pRect);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISK_EXT:
+      {
+        auto* pDisk = static_cast<const remixapi_LightInfoDiskEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoDisk>(c, *pDisk);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_CYLINDER_EXT:
+      {
+        auto* pCylinder = static_cast<const remixapi_LightInfoCylinderEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoCylinder>(c, *pCylinder);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISTANT_EXT:
+      {
+        auto* pDistant = static_cast<const remixapi_LightInfoDistantEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoDistant>(c, *pDistant);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DOME_EXT:
+      {
+        auto* pDome = static_cast<const remixapi_LightInfoDomeEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoDome>(c, *pDome);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_USD_EXT:
+      {
+        auto* pUSD = static_cast<const remixapi_LightInfoUSDEXT* const>(infoItr);
+        send(c, Bool::True);
+        serializeAndSend<serialize::LightInfoUSD>(c, *pUSD);
+        break;
+      }
+      default:
+      {
+        Logger::warn("[remixapi_CreateLight] Unknown sType. Skipping.");
+        break;
+      }
+    }
+  }
+  send(c, Bool::False);
+}
+
 remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateLight(
   const remixapi_LightInfo* info,
   remixapi_LightHandle*     out_handle) {
@@ -265,74 +526,7 @@ remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateLight(
   {
     ClientMessage c(Commands::RemixApi_CreateLight);
 
-    serializeAndSend<serialize::LightInfo>(c, *info);
-    
-    // For each valid pNext, we will send a true-valued bool to indicate that
-    // server must read another extension. If it reads false, it knows that it
-    // is done reading.
-    // send(c, Bool::True); -> CONTINUE
-    // send(c, Bool::False); -> STOP
-    const void* infoItr = info;
-    while (auto* const pNext = getPNext(infoItr)) {
-      infoItr = pNext;
-      switch (getSType(infoItr)) {
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_SPHERE_EXT:
-        {
-          auto* pSphere = static_cast<const remixapi_LightInfoSphereEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoSphere>(c, *pSphere);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_RECT_EXT:
-        {
-          auto* pRect = static_cast<const remixapi_LightInfoRectEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoRect>(c, *pRect);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISK_EXT:
-        {
-          auto* pDisk = static_cast<const remixapi_LightInfoDiskEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoDisk>(c, *pDisk);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_CYLINDER_EXT:
-        {
-          auto* pCylinder = static_cast<const remixapi_LightInfoCylinderEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoCylinder>(c, *pCylinder);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISTANT_EXT:
-        {
-          auto* pDistant = static_cast<const remixapi_LightInfoDistantEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoDistant>(c, *pDistant);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DOME_EXT:
-        {
-          auto* pDome = static_cast<const remixapi_LightInfoDomeEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoDome>(c, *pDome);
-          break;
-        }
-        case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_USD_EXT:
-        {
-          auto* pUSD = static_cast<const remixapi_LightInfoUSDEXT* const>(infoItr);
-          send(c, Bool::True);
-          serializeAndSend<serialize::LightInfoUSD>(c, *pUSD);
-          break;
-        }
-        default:
-        {
-          Logger::warn("[remixapi_CreateLight] Unknown sType. Skipping.");
-          break;
-        }
-      }
-    }
-    send(c, Bool::False);
+    sendLightInfo(c, *info);
     sendHandle(c, newHandle);
   }
 
@@ -354,6 +548,34 @@ remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyLight(remixapi_LightHandle hand
   return REMIXAPI_ERROR_CODE_SUCCESS;
 }
 
+remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateLights(
+  const remixapi_LightHandle* handles,
+  const remixapi_LightInfo*   infos,
+  uint32_t                    count) {
+  ASSERT_REMIXAPI_PFN_TYPE(remixapi_UpdateLights);
+  if (count == 0) {
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+  if (!handles || !infos) {
+    return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    // Lights have to be created through CreateLight first, so that the server knows their handle
+    if (!LightHandle(handles[i]).isValid() || infos[i].sType != REMIXAPI_STRUCT_TYPE_LIGHT_INFO) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+  }
+  {
+    ClientMessage c(Commands::RemixApi_UpdateLights);
+    c.send_data(count);
+    for (uint32_t i = 0; i < count; i++) {
+      sendHandle(c, LightHandle(handles[i]));
+      sendLightInfo(c, infos[i]);
+    }
+  }
+  return REMIXAPI_ERROR_CODE_SUCCESS;
+}
+
 remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawLightInstance(remixapi_LightHandle handle) {
   ASSERT_REMIXAPI_PFN_TYPE(remixapi_DrawLightInstance);
   LightHandle lightHandle(handle);
@@ -437,8 +659,17 @@ extern "C" {
       interf.DestroyMesh = remixapi_DestroyMesh;
       // interf.SetupCamera = remixapi_SetupCamera;
       interf.DrawInstance = remixapi_DrawInstance;
+      interf.DrawInstances = remixapi_DrawInstances;
+      interf.CreateInstance = remixapi_CreateInstance;
+      interf.UpdateInstanceTransform = remixapi_UpdateInstanceTransform;
+      interf.UpdateInstanceMaterial = remixapi_UpdateInstanceMaterial;
+      interf.DestroyInstance = remixapi_DestroyInstance;
+      interf.CreateMeshAsync = remixapi_CreateMeshAsync;
+      // interf.IsMeshReady = remixapi_IsMeshReady;
+      interf.UpdateMeshVertices = remixapi_UpdateMeshVertices;
       interf.CreateLight = remixapi_CreateLight;
       interf.DestroyLight = remixapi_DestroyLight;
+      interf.UpdateLights = remixapi_UpdateLights;
       interf.DrawLightInstance = remixapi_DrawLightInstance;
       interf.SetConfigVariable = remixapi_SetConfigVariable;
       interf.dxvk_CreateD3D9 = remixapi_dxvk_CreateD3D9;
@@ -449,8 +680,14 @@ extern "C" {
       // interf.dxvk_SetDefaultOutput = remixapi_dxvk_SetDefaultOutput;
       // interf.pick_RequestObjectPicking = remixapi_pick_RequestObjectPicking;
       // interf.pick_HighlightObjects = remixapi_pick_HighlightObjects;
+      // interf.dxvk_RequestReadback = remixapi_dxvk_RequestReadback;
+      // interf.dxvk_GetReadback = remixapi_dxvk_GetReadback;
+      // interf.dxvk_DestroyReadback = remixapi_dxvk_DestroyReadback;
+      // interf.pick_HighlightObjectAtPixel = remixapi_pick_HighlightObjectAtPixel;
     }
 
+    DeviceBridge::setRemixApiRecordingEnabled(ClientOptions::getBatchRemixApiCalls());
+
     *out_result = interf;
     remixapi::g_bInterfaceInitialized = true;
 
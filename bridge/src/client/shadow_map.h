@@ -22,23 +22,78 @@
 #pragma once
 
 #include <unknwn.h>
-#include <unordered_map>
+#include <array>
+#include <atomic>
 
-using ShadowMap = std::unordered_map<uintptr_t, IUnknown*>;
-extern ShadowMap gShadowMap;
-extern std::mutex gShadowMapMutex;
+#include "util_handletable.h"
+
+// Maps object ids to their wrappers. Ids are dense indices (see bridge_util::ObjectHandle),
+// so the map is a fixed array of lazily allocated pages of atomic pointers, and tracking,
+// untracking and lookups never take a lock.
+class ShadowMap {
+public:
+  ShadowMap() = default;
+  ShadowMap(const ShadowMap&) = delete;
+  ShadowMap& operator=(const ShadowMap&) = delete;
+
+  ~ShadowMap() {
+    for (auto& page : m_pages) {
+      delete page.load(std::memory_order_relaxed);
+    }
+  }
+
+  void track(const uintptr_t id, IUnknown* const pWrapper) {
+    getSlot(id, true)->store(pWrapper, std::memory_order_release);
+  }
+
+  void untrack(const uintptr_t id) {
+    if (auto* pSlot = getSlot(id, false)) {
+      pSlot->store(nullptr, std::memory_order_release);
+    }
+  }
+
+  // Returns the wrapper for the id or nullptr if it is not tracked
+  IUnknown* find(const uintptr_t id) const {
+    const auto* pSlot = const_cast<ShadowMap*>(this)->getSlot(id, false);
+    return pSlot ? pSlot->load(std::memory_order_acquire) : nullptr;
+  }
 
-#define SHADOW_MAP_LOCKGUARD \
-   std::scoped_lock lockObj(gShadowMapMutex); \
+private:
+  static constexpr uint32_t kPageBits = 12;
+  static constexpr uint32_t kPageSize = 1u << kPageBits;
+  static constexpr uint32_t kNumPages = (bridge_util::ObjectHandle::kMaxIndex + 1) / kPageSize;
+
+  using Page = std::array<std::atomic<IUnknown*>, kPageSize>;
+
+  std::atomic<IUnknown*>* getSlot(const uintptr_t id, const bool allocate) {
+    const uint32_t index = bridge_util::ObjectHandle::getIndex((uint32_t) id);
+    std::atomic<Page*>& page = m_pages[index >> kPageBits];
+
+    Page* pPage = page.load(std::memory_order_acquire);
+    if (pPage == nullptr) {
+      if (!allocate) {
+        return nullptr;
+      }
+      // Threads racing to allocate the same page keep whichever page was published first
+      Page* pNewPage = new Page();
+      if (page.compare_exchange_strong(pPage, pNewPage, std::memory_order_acq_rel)) {
+        pPage = pNewPage;
+      } else {
+        delete pNewPage;
+      }
+    }
+    return &(*pPage)[index & (kPageSize - 1)];
+  }
+
+  std::array<std::atomic<Page*>, kNumPages> m_pages {};
+};
+
+extern ShadowMap gShadowMap;
 
 class BaseDirect3DDevice9Ex_LSS;
 
 template<class WrapperType>
 static WrapperType* trackWrapper(WrapperType* const pLss) {
-  {
-    SHADOW_MAP_LOCKGUARD;
-    gShadowMap[pLss->getId()] = pLss;
-  }
-
+  gShadowMap.track(pLss->getId(), pLss);
   return pLss;
 }
\ No newline at end of file
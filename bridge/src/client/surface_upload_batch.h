@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022-2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "client_options.h"
+#include "util_devicecommand.h"
+#include "util_sharedheap.h"
+#include "util_texture_and_volume.h"
+
+#include <d3d9.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Collects the surface data of UnlockRect() calls and sends it to the server in a single
+// Bridge_UnlockSurfaceBatch command, so that uploading all mip levels and faces of a
+// texture costs one command instead of one per surface. Pending uploads must be flushed
+// before anything on the server may read or write the surfaces, i.e. before draw calls,
+// Clear, surface copies, Present and before a surface or texture is destroyed.
+class SurfaceUploadBatch {
+public:
+  static bool isEnabled() {
+    static const bool bEnabled = ClientOptions::getBatchSurfaceUploads();
+    return bEnabled;
+  }
+
+  // Returns false if the upload is too large to be batched and must be sent directly
+  static bool add(const uint32_t surfaceHandle, const RECT& rect, const DWORD flags,
+                  const D3DFORMAT format, const D3DLOCKED_RECT& lockedRect,
+                  const bridge_util::SharedHeap::AllocId bufId,
+                  const bridge_util::SharedHeap::AllocId discardBufId) {
+    const bool bUseSharedHeap = bufId != bridge_util::SharedHeap::kInvalidId;
+    const uint32_t width = rect.right - rect.left;
+    const uint32_t height = rect.bottom - rect.top;
+    const size_t rowSize = bridge_util::calcRowSize(width, format);
+    const size_t dataSize = bUseSharedHeap ? 0 : bridge_util::calcTotalSizeOfRect(width, height, format);
+    if (dataSize > kMaxDataSize) {
+      flush();
+      return false;
+    }
+
+    std::lock_guard lock(s_mutex);
+    if (!s_entries.empty() && (bUseSharedHeap != s_bUseSharedHeap ||
+                               s_data.size() + dataSize > kMaxDataSize ||
+                               s_entries.size() >= kMaxEntries)) {
+      flushLocked();
+    }
+    s_bUseSharedHeap = bUseSharedHeap;
+
+    bridge_util::SurfaceUploadEntry entry;
+    entry.surfaceHandle = surfaceHandle;
+    entry.rect = rect;
+    entry.flags = flags;
+    entry.format = format;
+    if (bUseSharedHeap) {
+      entry.pitch = lockedRect.Pitch;
+      entry.bufIdOrDataOffset = bufId;
+    } else {
+      // Rows are packed, the locked rect may be part of a larger surface
+      entry.pitch = static_cast<uint32_t>(rowSize);
+      entry.bufIdOrDataOffset = static_cast<uint32_t>(s_data.size());
+      s_data.resize(s_data.size() + dataSize);
+      uint8_t* pDst = s_data.data() + entry.bufIdOrDataOffset;
+      FOR_EACH_RECT_ROW(lockedRect, height, format, {
+        memcpy(pDst, ptr, rowSize);
+        pDst += rowSize;
+      });
+    }
+    s_entries.push_back(entry);
+    if (discardBufId != bridge_util::SharedHeap::kInvalidId) {
+      s_discardBufIds.push_back(discardBufId);
+    }
+    s_numPending.store(s_entries.size(), std::memory_order_release);
+    return true;
+  }
+
+  static void flush() {
+    if (s_numPending.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+    std::lock_guard lock(s_mutex);
+    flushLocked();
+  }
+
+private:
+  static void flushLocked() {
+    if (s_entries.empty()) {
+      return;
+    }
+    {
+      const auto dataFlag = s_bUseSharedHeap ? Commands::FlagBits::DataInSharedHeap : 0;
+      ClientMessage c(Commands::Bridge_UnlockSurfaceBatch, 0, dataFlag);
+      c.send_data(static_cast<uint32_t>(s_entries.size()));
+      c.send_data(static_cast<uint32_t>(s_entries.size() * sizeof(bridge_util::SurfaceUploadEntry)), s_entries.data());
+      if (!s_bUseSharedHeap) {
+        c.send_data(static_cast<uint32_t>(s_data.size()), s_data.data());
+      }
+    }
+    // Replaced shared heap buffers may only be released after the server has read them
+    for (const auto bufId : s_discardBufIds) {
+      bridge_util::SharedHeap::deallocate(bufId);
+    }
+    s_entries.clear();
+    s_data.clear();
+    s_discardBufIds.clear();
+    s_numPending.store(0, std::memory_order_release);
+  }
+
+  static constexpr size_t kMaxEntries = 1024;
+  static constexpr size_t kMaxDataSize = 8 << 20; // 8MB
+
+  inline static std::mutex s_mutex;
+  inline static bool s_bUseSharedHeap = false;
+  inline static std::vector<bridge_util::SurfaceUploadEntry> s_entries;
+  inline static std::vector<uint8_t> s_data;
+  inline static std::vector<bridge_util::SharedHeap::AllocId> s_discardBufIds;
+  inline static std::atomic<size_t> s_numPending = 0;
+};
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "command_pipeline.h"
+
+#include "log/log.h"
+
+#include "../tracy/tracy.hpp"
+
+#include <assert.h>
+
+using namespace Commands;
+using namespace bridge_util;
+
+CommandPipeline::CommandPipeline(const uint32_t queueSize) {
+  const size_t memSize = Queue::getExtraMemoryRequirements() + queueSize * sizeof(DecodedCommand);
+  m_memory = std::make_unique<uint8_t[]>(memSize);
+  m_queue = std::make_unique<Queue>("CommandPipeline", m_memory.get(), memSize, queueSize);
+  m_thread = std::thread([this]() {
+    executeLoop();
+  });
+  Logger::info(format_string("Server command pipeline enabled with %d entries.", queueSize));
+}
+
+CommandPipeline::~CommandPipeline() {
+  drain();
+  m_bDone.store(true);
+  m_thread.join();
+}
+
+bool CommandPipeline::isPipelined(const D3D9Command command) {
+  switch (command) {
+  case IDirect3DDevice9Ex_BeginScene:
+  case IDirect3DDevice9Ex_EndScene:
+  case IDirect3DDevice9Ex_SetTransform:
+  case IDirect3DDevice9Ex_SetViewport:
+  case IDirect3DDevice9Ex_SetRenderState:
+  case IDirect3DDevice9Ex_SetTexture:
+  case IDirect3DDevice9Ex_SetTextureStageState:
+  case IDirect3DDevice9Ex_SetSamplerState:
+  case IDirect3DDevice9Ex_SetScissorRect:
+  case IDirect3DDevice9Ex_DrawPrimitive:
+  case IDirect3DDevice9Ex_DrawIndexedPrimitive:
+  case IDirect3DDevice9Ex_SetVertexDeclaration:
+  case IDirect3DDevice9Ex_SetFVF:
+  case IDirect3DDevice9Ex_SetVertexShader:
+  case IDirect3DDevice9Ex_SetVertexShaderConstantF:
+  case IDirect3DDevice9Ex_SetVertexShaderConstantI:
+  case IDirect3DDevice9Ex_SetVertexShaderConstantB:
+  case IDirect3DDevice9Ex_SetStreamSource:
+  case IDirect3DDevice9Ex_SetStreamSourceFreq:
+  case IDirect3DDevice9Ex_SetIndices:
+  case IDirect3DDevice9Ex_SetPixelShader:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantF:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantI:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantB:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void CommandPipeline::push(const DecodedCommand& cmd) {
+  assert(cmd.pData == nullptr);
+  const auto result = m_queue->push(cmd);
+  if (RESULT_FAILURE(result)) {
+    // Execute stage is stuck, fall back to executing in order on this thread
+    Logger::warn("Command pipeline push timed out, executing command on the decode thread.");
+    drain();
+    execute(cmd);
+  }
+}
+
+void CommandPipeline::drain() {
+  ZoneScoped;
+  while (!m_queue->isEmpty()) {
+    std::this_thread::yield();
+  }
+}
+
+void CommandPipeline::executeLoop() {
+  while (!m_bDone.load()) {
+    Result result;
+    // Peek, execute and only then pull so that the slot is not reused by the
+    // decode stage while it is still being read, and so that an empty queue
+    // means all commands have been executed.
+    const DecodedCommand& cmd = m_queue->peek(result, 0, &m_bDone);
+    if (RESULT_FAILURE(result)) {
+      continue;
+    }
+    execute(cmd);
+    m_queue->pull(result);
+  }
+}
+
+void CommandPipeline::execute(const DecodedCommand& cmd) {
+  ZoneScoped;
+  IDirect3DDevice9* const pD3DDevice = cmd.pDevice;
+  const uint32_t* const args = cmd.args;
+  HRESULT hresult = D3D_OK;
+  switch (cmd.command) {
+  case IDirect3DDevice9Ex_BeginScene:
+    hresult = pD3DDevice->BeginScene();
+    break;
+  case IDirect3DDevice9Ex_EndScene:
+    hresult = pD3DDevice->EndScene();
+    break;
+  case IDirect3DDevice9Ex_SetTransform:
+    hresult = pD3DDevice->SetTransform((D3DTRANSFORMSTATETYPE) args[0], (const D3DMATRIX*) cmd.data());
+    break;
+  case IDirect3DDevice9Ex_SetViewport:
+    hresult = pD3DDevice->SetViewport((const D3DVIEWPORT9*) cmd.data());
+    break;
+  case IDirect3DDevice9Ex_SetRenderState:
+    hresult = pD3DDevice->SetRenderState((D3DRENDERSTATETYPE) args[0], args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetTexture:
+    hresult = pD3DDevice->SetTexture(args[0], (IDirect3DBaseTexture9*) cmd.pObject);
+    break;
+  case IDirect3DDevice9Ex_SetTextureStageState:
+    hresult = pD3DDevice->SetTextureStageState(args[0], (D3DTEXTURESTAGESTATETYPE) args[1], args[2]);
+    break;
+  case IDirect3DDevice9Ex_SetSamplerState:
+    hresult = pD3DDevice->SetSamplerState(args[0], (D3DSAMPLERSTATETYPE) args[1], args[2]);
+    break;
+  case IDirect3DDevice9Ex_SetScissorRect:
+    hresult = pD3DDevice->SetScissorRect((const RECT*) cmd.data());
+    break;
+  case IDirect3DDevice9Ex_DrawPrimitive:
+    hresult = pD3DDevice->DrawPrimitive((D3DPRIMITIVETYPE) args[0], args[1], args[2]);
+    break;
+  case IDirect3DDevice9Ex_DrawIndexedPrimitive:
+    hresult = pD3DDevice->DrawIndexedPrimitive((D3DPRIMITIVETYPE) args[0], (INT) args[1], args[2], args[3], args[4], args[5]);
+    break;
+  case IDirect3DDevice9Ex_SetVertexDeclaration:
+    hresult = pD3DDevice->SetVertexDeclaration((IDirect3DVertexDeclaration9*) cmd.pObject);
+    break;
+  case IDirect3DDevice9Ex_SetFVF:
+    hresult = pD3DDevice->SetFVF(args[0]);
+    break;
+  case IDirect3DDevice9Ex_SetVertexShader:
+    hresult = pD3DDevice->SetVertexShader((IDirect3DVertexShader9*) cmd.pObject);
+    break;
+  case IDirect3DDevice9Ex_SetVertexShaderConstantF:
+    hresult = pD3DDevice->SetVertexShaderConstantF(args[0], (const float*) cmd.data(), args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetVertexShaderConstantI:
+    hresult = pD3DDevice->SetVertexShaderConstantI(args[0], (const int*) cmd.data(), args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetVertexShaderConstantB:
+    hresult = pD3DDevice->SetVertexShaderConstantB(args[0], (const BOOL*) cmd.data(), args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetStreamSource:
+    hresult = pD3DDevice->SetStreamSource(args[0], (IDirect3DVertexBuffer9*) cmd.pObject, args[1], args[2]);
+    break;
+  case IDirect3DDevice9Ex_SetStreamSourceFreq:
+    hresult = pD3DDevice->SetStreamSourceFreq(args[0], args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetIndices:
+    hresult = pD3DDevice->SetIndices((IDirect3DIndexBuffer9*) cmd.pObject);
+    break;
+  case IDirect3DDevice9Ex_SetPixelShader:
+    hresult = pD3DDevice->SetPixelShader((IDirect3DPixelShader9*) cmd.pObject);
+    break;
+  case IDirect3DDevice9Ex_SetPixelShaderConstantF:
+    hresult = pD3DDevice->SetPixelShaderConstantF(args[0], (const float*) cmd.data(), args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetPixelShaderConstantI:
+    hresult = pD3DDevice->SetPixelShaderConstantI(args[0], (const int*) cmd.data(), args[1]);
+    break;
+  case IDirect3DDevice9Ex_SetPixelShaderConstantB:
+    hresult = pD3DDevice->SetPixelShaderConstantB(args[0], (const BOOL*) cmd.data(), args[1]);
+    break;
+  default:
+    assert(!"Command is not pipelined");
+    break;
+  }
+  assert(SUCCEEDED(hresult));
+}
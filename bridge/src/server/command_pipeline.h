@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_atomiccircularqueue.h"
+#include "util_commands.h"
+
+#include <d3d9.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// A fully decoded device command. All handles are already resolved to D3D
+// objects and any payload is copied out of the data queue, so executing it
+// does not touch the IPC channel or the server object maps.
+struct DecodedCommand {
+  // Largest payload that is carried inline, fits 32 float4 shader constants
+  static constexpr size_t kMaxPayloadSize = 32 * 4 * sizeof(float);
+
+  Commands::D3D9Command command = Commands::Bridge_Invalid;
+  IDirect3DDevice9* pDevice = nullptr;
+  void* pObject = nullptr;
+  uint32_t args[6] = {};
+  // Set when the payload did not fit inline, points directly into the data
+  // queue so the command must be executed before the data is released.
+  const void* pData = nullptr;
+  bool bInlinePayload = false;
+  alignas(16) uint8_t payload[kMaxPayloadSize];
+
+  const void* data() const {
+    return bInlinePayload ? payload : pData;
+  }
+};
+
+// Splits device command processing into a decode stage, running on the thread
+// that reads the device command queue, and an execute stage running on its own
+// thread. The stages are connected by a single producer single consumer ring.
+//
+// Only hot state setters and draws are pipelined. Every other command is
+// executed by the decode thread after the execute stage has drained, which keeps
+// the original command order and means the server object maps are only ever
+// accessed by the decode thread.
+class CommandPipeline {
+public:
+  explicit CommandPipeline(const uint32_t queueSize);
+  ~CommandPipeline();
+
+  static bool isPipelined(const Commands::D3D9Command command);
+
+  // Hands a decoded command to the execute stage
+  void push(const DecodedCommand& cmd);
+
+  // Waits until the execute stage has executed all pushed commands
+  void drain();
+
+  // Executes a decoded command on the calling thread
+  static void execute(const DecodedCommand& cmd);
+
+private:
+  void executeLoop();
+
+  using Queue = bridge_util::AtomicCircularQueue<DecodedCommand, bridge_util::Accessor::Writer>;
+
+  std::unique_ptr<uint8_t[]> m_memory;
+  std::unique_ptr<Queue> m_queue;
+  std::atomic<bool> m_bDone = false;
+  std::thread m_thread;
+};
@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "command_trace.h"
+
+#include "config/global_options.h"
+#include "log/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace bridge_util;
+
+namespace {
+  using CommandTrace::Channel;
+  using CommandTrace::Clock;
+
+  constexpr uint32_t kTraceMagic = 0x52544342; // "BCTR"
+  constexpr uint32_t kTraceVersion = 1;
+  constexpr size_t kNumChannels = (size_t) Channel::Count;
+  constexpr size_t kCaptureBufferSize = 16 << 20;
+
+  enum RecordType: uint8_t {
+    Begin = 0,   // BeginRecord
+    Command = 1, // CommandRecord, followed by numWords data queue words
+  };
+
+  struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+  };
+
+  struct RecordHeader {
+    RecordType type;
+    Channel channel;
+    uint16_t reserved;
+  };
+
+  struct BeginRecord {
+    uint32_t dataQueueSize;
+    uint32_t dataPos;
+  };
+
+  struct CommandRecord {
+    Header header;
+    uint32_t dataPos;
+    uint32_t numWords;
+  };
+
+  const char* toString(const Channel channel) {
+    return channel == Channel::Module ? "Module" : "Device";
+  }
+
+  // Number of data queue words between two positions, accounting for wrap around
+  size_t getNumWords(const size_t begin, const size_t end, const size_t queueSize) {
+    return end >= begin ? end - begin : queueSize - begin + end;
+  }
+
+  //===============//
+  // Command costs //
+  //===============//
+
+  // Buckets are powers of two in nanoseconds
+  constexpr size_t kNumCostBuckets = 40;
+
+  struct CommandCost {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t buckets[kNumCostBuckets] = {};
+
+    void add(const uint64_t ns) {
+      size_t bucket = 0;
+      for (uint64_t v = ns; v > 0 && bucket + 1 < kNumCostBuckets; v >>= 1) {
+        ++bucket;
+      }
+      ++buckets[bucket];
+      ++count;
+      totalNs += ns;
+      maxNs = ns > maxNs ? ns : maxNs;
+    }
+
+    void merge(const CommandCost& other) {
+      for (size_t i = 0; i < kNumCostBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+      }
+      count += other.count;
+      totalNs += other.totalNs;
+      maxNs = other.maxNs > maxNs ? other.maxNs : maxNs;
+    }
+
+    // Upper bound of the bucket the given percentile falls into
+    double percentileUs(const double percentile) const {
+      const uint64_t target = (uint64_t) (percentile * count);
+      uint64_t sum = 0;
+      for (size_t i = 0; i < kNumCostBuckets; ++i) {
+        sum += buckets[i];
+        if (sum > target) {
+          return (double) (1ull << i) / 1000.0;
+        }
+      }
+      return (double) maxNs / 1000.0;
+    }
+  };
+
+  // Each map is only accessed by the processing loop of its channel
+  std::unordered_map<Commands::D3D9Command, CommandCost> gCommandCosts[kNumChannels];
+
+  //=========//
+  // Capture //
+  //=========//
+
+  std::mutex gCaptureMutex;
+  FILE* gpCaptureFile = nullptr;
+  size_t gCaptureDataPos[kNumChannels] = {};
+  uint64_t gNumCapturedCommands = 0;
+
+  void writeRecord(const RecordType type, const Channel channel,
+                   const void* pRecord, const size_t recordSize) {
+    const RecordHeader recordHeader { type, channel, 0 };
+    fwrite(&recordHeader, sizeof(recordHeader), 1, gpCaptureFile);
+    fwrite(pRecord, recordSize, 1, gpCaptureFile);
+  }
+
+  //========//
+  // Replay //
+  //========//
+
+  struct ReplayCommand {
+    Channel channel;
+    CommandRecord record;
+    size_t firstWord;
+  };
+
+  struct ReplayChannel {
+    bool bHasBegin = false;
+    BeginRecord begin = {};
+    size_t cmdQueueSize = 0;
+    // Client to server channel written by the replay, server to client channel drained by it
+    std::unique_ptr<WriterChannel> pClientChannel;
+    std::unique_ptr<ReaderChannel> pServerChannel;
+    std::thread drainThread;
+    uint64_t numPushed = 0;
+    size_t numPendingWords = 0;
+    size_t dataPos = 0;
+    std::atomic<uint64_t> numProcessed = 0;
+  };
+
+  bool gbReplaying = false;
+  std::vector<ReplayCommand> gReplayCommands;
+  std::vector<uint32_t> gReplayWords;
+  ReplayChannel gReplayChannels[kNumChannels];
+  std::atomic<bool> gbStopReplay = false;
+  std::thread gFeedThread;
+  std::thread gWindowThread;
+  std::atomic<bool> gbReplayWindowReady = false;
+  HWND ghReplayWindow = nullptr;
+  Clock::time_point gReplayStart;
+
+  ReplayChannel& getReplayChannel(const Channel channel) {
+    return gReplayChannels[(size_t) channel];
+  }
+
+  // Opens the views the client would normally have on the module and device channels
+  void openReplayChannels(const Channel channel, ReplayChannel& replayChannel) {
+    if (channel == Channel::Module) {
+      replayChannel.cmdQueueSize = GlobalOptions::getModuleClientCmdQueueSize();
+      replayChannel.pClientChannel = std::make_unique<WriterChannel>("ModuleClient2Server",
+        GlobalOptions::getModuleClientChannelMemSize(),
+        GlobalOptions::getModuleClientCmdQueueSize(),
+        GlobalOptions::getModuleClientDataQueueSize());
+      replayChannel.pServerChannel = std::make_unique<ReaderChannel>("ModuleServer2Client",
+        GlobalOptions::getModuleServerChannelMemSize(),
+        GlobalOptions::getModuleServerCmdQueueSize(),
+        GlobalOptions::getModuleServerDataQueueSize());
+    } else {
+      replayChannel.cmdQueueSize = GlobalOptions::getClientCmdQueueSize();
+      replayChannel.pClientChannel = std::make_unique<WriterChannel>("DeviceClient2Server",
+        GlobalOptions::getClientChannelMemSize(),
+        GlobalOptions::getClientCmdQueueSize(),
+        GlobalOptions::getClientDataQueueSize());
+      replayChannel.pServerChannel = std::make_unique<ReaderChannel>("DeviceServer2Client",
+        GlobalOptions::getServerChannelMemSize(),
+        GlobalOptions::getServerCmdQueueSize(),
+        GlobalOptions::getServerDataQueueSize());
+    }
+  }
+
+  // Waits until the server has processed every command pushed to the channel
+  void waitForChannelIdle(ReplayChannel& replayChannel) {
+    while (replayChannel.numProcessed.load(std::memory_order_acquire) < replayChannel.numPushed &&
+           !gbStopReplay.load()) {
+      std::this_thread::yield();
+    }
+    replayChannel.numPendingWords = 0;
+  }
+
+  void pushCommand(ReplayChannel& replayChannel, const Header& header,
+                   const uint32_t dataPos, const uint32_t* pWords, const size_t numWords) {
+    const size_t queueSize = replayChannel.begin.dataQueueSize;
+    // Never write over data the server has not consumed yet
+    if (replayChannel.numPendingWords + numWords > queueSize / 2 ||
+        replayChannel.numPushed - replayChannel.numProcessed.load() + 1 >= replayChannel.cmdQueueSize / 2) {
+      waitForChannelIdle(replayChannel);
+    }
+    uint32_t* const pData = replayChannel.pClientChannel->get_data_ptr();
+    for (size_t i = 0; i < numWords; ++i) {
+      pData[(dataPos + i) % queueSize] = pWords[i];
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (RESULT_FAILURE(replayChannel.pClientChannel->commands->push(header)) && !gbStopReplay.load()) {
+    }
+    replayChannel.numPendingWords += numWords;
+    replayChannel.dataPos = (dataPos + numWords) % queueSize;
+    ++replayChannel.numPushed;
+  }
+
+  void feedLoop() {
+    Channel lastChannel = Channel::Count;
+    bool bTerminated = false;
+    for (const ReplayCommand& cmd : gReplayCommands) {
+      if (gbStopReplay.load()) {
+        return;
+      }
+      // Commands were issued in this order on the client, which waits for the
+      // responses to cross channel dependencies, so finish the other channel first
+      if (lastChannel != cmd.channel && lastChannel != Channel::Count) {
+        waitForChannelIdle(getReplayChannel(lastChannel));
+      }
+      lastChannel = cmd.channel;
+      pushCommand(getReplayChannel(cmd.channel), cmd.record.header, cmd.record.dataPos,
+                  gReplayWords.data() + cmd.firstWord, cmd.record.numWords);
+      bTerminated = cmd.record.header.command == Commands::Bridge_Terminate;
+    }
+    // A trace that was cut short needs to terminate the device loop itself
+    ReplayChannel& deviceChannel = getReplayChannel(Channel::Device);
+    if (!bTerminated && deviceChannel.bHasBegin) {
+      waitForChannelIdle(getReplayChannel(Channel::Module));
+      const uint32_t uid = 0;
+      const uint32_t dataPos = (uint32_t) deviceChannel.dataPos;
+      Header header;
+      header.command = Commands::Bridge_Terminate;
+      header.dataOffset = (uint32_t) ((dataPos + 1) % deviceChannel.begin.dataQueueSize);
+      pushCommand(deviceChannel, header, dataPos, &uid, 1);
+    }
+  }
+
+  // Responses are not checked, but must be consumed so the server never blocks on a full queue
+  void drainLoop(ReplayChannel* pReplayChannel) {
+    while (!gbStopReplay.load()) {
+      Result result;
+      pReplayChannel->pServerChannel->commands->pull(result, 0, &gbStopReplay);
+    }
+  }
+
+  LRESULT CALLBACK replayWindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    if (msg == WM_CLOSE) {
+      // The replay owns the window lifetime
+      return 0;
+    }
+    return DefWindowProc(hWnd, msg, wParam, lParam);
+  }
+
+  void windowLoop() {
+    WNDCLASSEX wc = {};
+    wc.cbSize = sizeof(wc);
+    wc.lpfnWndProc = replayWindowProc;
+    wc.hInstance = GetModuleHandle(nullptr);
+    wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+    wc.lpszClassName = "RemixBridgeReplay";
+    RegisterClassEx(&wc);
+    const HWND hWnd = CreateWindowEx(0, wc.lpszClassName, "RTX Remix Bridge Replay",
+                                     WS_OVERLAPPEDWINDOW | WS_VISIBLE, CW_USEDEFAULT, CW_USEDEFAULT,
+                                     1280, 720, nullptr, nullptr, wc.hInstance, nullptr);
+    if (hWnd == nullptr) {
+      Logger::err(format_string("Unable to create the replay window (error code %d)!", GetLastError()));
+    }
+    ghReplayWindow = hWnd;
+    gbReplayWindowReady.store(true);
+    MSG msg;
+    while (!gbStopReplay.load()) {
+      while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+      }
+      Sleep(1);
+    }
+    if (hWnd) {
+      DestroyWindow(hWnd);
+    }
+  }
+
+  void logCommandCosts() {
+    std::unordered_map<Commands::D3D9Command, CommandCost> costs;
+    for (const auto& channelCosts : gCommandCosts) {
+      for (const auto& [command, cost] : channelCosts) {
+        costs[command].merge(cost);
+      }
+    }
+    if (costs.empty()) {
+      return;
+    }
+    std::vector<std::pair<Commands::D3D9Command, CommandCost>> sorted(costs.begin(), costs.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+      return a.second.totalNs > b.second.totalNs;
+    });
+    std::stringstream ss;
+    ss << "Command costs (count, total ms, avg us, p50 us, p90 us, p99 us, max us):";
+    for (const auto& [command, cost] : sorted) {
+      ss << std::endl << format_string("  %-56s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f",
+                                       Commands::toString(command).c_str(), cost.count,
+                                       (double) cost.totalNs / 1'000'000.0,
+                                       (double) cost.totalNs / cost.count / 1000.0,
+                                       cost.percentileUs(0.5), cost.percentileUs(0.9),
+                                       cost.percentileUs(0.99), (double) cost.maxNs / 1000.0);
+    }
+    Logger::info(ss.str());
+  }
+}
+
+namespace CommandTrace {
+  bool beginCapture(const std::string& path) {
+    if (GlobalOptions::getUseSharedHeap()) {
+      Logger::err("Command trace capture requires useSharedHeap to be disabled, since shared heap contents are not captured.");
+      return false;
+    }
+    if (GlobalOptions::getUseVertexRing()) {
+      Logger::err("Command trace capture requires useVertexRing to be disabled, since vertex ring contents are not captured.");
+      return false;
+    }
+    if (fopen_s(&gpCaptureFile, path.c_str(), "wb") != 0 || gpCaptureFile == nullptr) {
+      Logger::err("Unable to open command trace capture file " + path);
+      gpCaptureFile = nullptr;
+      return false;
+    }
+    setvbuf(gpCaptureFile, nullptr, _IOFBF, kCaptureBufferSize);
+    const FileHeader fileHeader { kTraceMagic, kTraceVersion };
+    fwrite(&fileHeader, sizeof(fileHeader), 1, gpCaptureFile);
+    Logger::info("Capturing command trace to " + path);
+    return true;
+  }
+
+  bool loadReplay(const std::string& path) {
+    FILE* pFile = nullptr;
+    if (fopen_s(&pFile, path.c_str(), "rb") != 0 || pFile == nullptr) {
+      Logger::err("Unable to open command trace " + path);
+      return false;
+    }
+    FileHeader fileHeader = {};
+    if (fread(&fileHeader, sizeof(fileHeader), 1, pFile) != 1 ||
+        fileHeader.magic != kTraceMagic || fileHeader.version != kTraceVersion) {
+      Logger::err("Unsupported command trace file " + path);
+      fclose(pFile);
+      return false;
+    }
+    bool bValid = true;
+    RecordHeader recordHeader;
+    while (bValid && fread(&recordHeader, sizeof(recordHeader), 1, pFile) == 1) {
+      if (recordHeader.channel >= Channel::Count) {
+        bValid = false;
+        break;
+      }
+      ReplayChannel& replayChannel = getReplayChannel(recordHeader.channel);
+      if (recordHeader.type == RecordType::Begin) {
+        bValid = fread(&replayChannel.begin, sizeof(BeginRecord), 1, pFile) == 1;
+        replayChannel.bHasBegin = true;
+      } else if (recordHeader.type == RecordType::Command && replayChannel.bHasBegin) {
+        ReplayCommand cmd;
+        cmd.channel = recordHeader.channel;
+        cmd.firstWord = gReplayWords.size();
+        bValid = fread(&cmd.record, sizeof(CommandRecord), 1, pFile) == 1;
+        if (bValid) {
+          gReplayWords.resize(cmd.firstWord + cmd.record.numWords);
+          bValid = fread(gReplayWords.data() + cmd.firstWord, sizeof(uint32_t), cmd.record.numWords, pFile) == cmd.record.numWords;
+        }
+        if (bValid) {
+          gReplayCommands.push_back(cmd);
+        }
+      } else {
+        bValid = false;
+      }
+    }
+    fclose(pFile);
+    if (!bValid) {
+      // Keep whatever was read completely, the trace is likely just cut short
+      Logger::warn("Command trace " + path + " is truncated or corrupt, replaying the commands read so far.");
+    }
+    Logger::info(format_string("Loaded command trace %s with %d commands.", path.c_str(), gReplayCommands.size()));
+    gbReplaying = true;
+    return true;
+  }
+
+  bool isCapturing() {
+    return gpCaptureFile != nullptr;
+  }
+
+  bool isReplaying() {
+    return gbReplaying;
+  }
+
+  size_t getReplayStartDataPos(const Channel channel) {
+    return getReplayChannel(channel).begin.dataPos;
+  }
+
+  bool startReplay() {
+    for (size_t i = 0; i < kNumChannels; ++i) {
+      ReplayChannel& replayChannel = gReplayChannels[i];
+      openReplayChannels((Channel) i, replayChannel);
+      // Data is replayed to its original queue positions, so the queues must be configured the same way
+      const size_t dataQueueSize = replayChannel.pClientChannel->data->get_total_size();
+      if (!replayChannel.bHasBegin) {
+        replayChannel.begin.dataQueueSize = (uint32_t) dataQueueSize;
+      } else if (replayChannel.begin.dataQueueSize != dataQueueSize) {
+        Logger::err(format_string("The %s channel was captured with a data queue of %d entries but is configured with %d. "
+                                  "Replay with the channel memory and queue sizes used during capture.",
+                                  toString((Channel) i), replayChannel.begin.dataQueueSize, dataQueueSize));
+        return false;
+      }
+    }
+    for (ReplayChannel& replayChannel : gReplayChannels) {
+      replayChannel.drainThread = std::thread(drainLoop, &replayChannel);
+    }
+    gWindowThread = std::thread(windowLoop);
+    while (!gbReplayWindowReady.load()) {
+      Sleep(1);
+    }
+    gReplayStart = Clock::now();
+    gFeedThread = std::thread(feedLoop);
+    return true;
+  }
+
+  void finishReplay() {
+    const auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - gReplayStart).count();
+    gbStopReplay.store(true);
+    if (gFeedThread.joinable()) {
+      gFeedThread.join();
+    }
+    for (ReplayChannel& replayChannel : gReplayChannels) {
+      if (replayChannel.drainThread.joinable()) {
+        replayChannel.drainThread.join();
+      }
+    }
+    if (gWindowThread.joinable()) {
+      gWindowThread.join();
+    }
+
+    uint64_t numPresents = 0;
+    for (const ReplayCommand& cmd : gReplayCommands) {
+      if (cmd.record.header.command == Commands::IDirect3DDevice9Ex_Present ||
+          cmd.record.header.command == Commands::IDirect3DSwapChain9_Present) {
+        ++numPresents;
+      }
+    }
+    const uint64_t numProcessed = getReplayChannel(Channel::Module).numProcessed.load() +
+                                  getReplayChannel(Channel::Device).numProcessed.load();
+    if (numProcessed < gReplayCommands.size()) {
+      Logger::warn(format_string("Replay stopped after %llu of %llu commands.", numProcessed, (uint64_t) gReplayCommands.size()));
+    }
+    if (durationUs > 0) {
+      const double seconds = (double) durationUs / 1'000'000.0;
+      Logger::info(format_string("Replayed %llu commands and %llu frames in %.3f s: %.0f commands/s, %.2f frames/s.",
+                                 numProcessed, numPresents, seconds,
+                                 (double) numProcessed / seconds, (double) numPresents / seconds));
+    }
+  }
+
+  HWND getReplayWindow() {
+    return ghReplayWindow;
+  }
+
+  void beginChannel(const Channel channel, const ReaderChannel& readerChannel) {
+    if (!isCapturing()) {
+      return;
+    }
+    std::lock_guard lock(gCaptureMutex);
+    gCaptureDataPos[(size_t) channel] = readerChannel.get_data_pos();
+    const BeginRecord record {
+      (uint32_t) readerChannel.data->get_total_size(),
+      (uint32_t) readerChannel.get_data_pos()
+    };
+    writeRecord(RecordType::Begin, channel, &record, sizeof(record));
+  }
+
+  void commandProcessed(const Channel channel, const ReaderChannel& readerChannel,
+                        const Header& header, const Clock::time_point start) {
+    const auto costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    gCommandCosts[(size_t) channel][header.command].add((uint64_t) costNs);
+
+    if (isReplaying()) {
+      getReplayChannel(channel).numProcessed.fetch_add(1, std::memory_order_release);
+      return;
+    }
+
+    std::lock_guard lock(gCaptureMutex);
+    if (gpCaptureFile == nullptr) {
+      return;
+    }
+    size_t& dataPos = gCaptureDataPos[(size_t) channel];
+    const size_t endPos = readerChannel.get_data_pos();
+    const size_t queueSize = readerChannel.data->get_total_size();
+    const size_t numWords = getNumWords(dataPos, endPos, queueSize);
+    const CommandRecord record { header, (uint32_t) dataPos, (uint32_t) numWords };
+    writeRecord(RecordType::Command, channel, &record, sizeof(record));
+    const uint32_t* const pData = readerChannel.get_data_ptr();
+    if (endPos >= dataPos) {
+      fwrite(pData + dataPos, sizeof(uint32_t), numWords, gpCaptureFile);
+    } else {
+      fwrite(pData + dataPos, sizeof(uint32_t), queueSize - dataPos, gpCaptureFile);
+      fwrite(pData, sizeof(uint32_t), endPos, gpCaptureFile);
+    }
+    dataPos = endPos;
+    ++gNumCapturedCommands;
+  }
+
+  void shutdown() {
+    logCommandCosts();
+    std::lock_guard lock(gCaptureMutex);
+    if (gpCaptureFile) {
+      fclose(gpCaptureFile);
+      gpCaptureFile = nullptr;
+      Logger::info(format_string("Command trace capture finished with %llu commands.", gNumCapturedCommands));
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_commands.h"
+#include "util_ipcchannel.h"
+
+#include <chrono>
+#include <string>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+// Records the command and data queue traffic the server receives from the client
+// into a trace file, and replays such a trace into the server without a client.
+//
+// Every processed command is stored together with the raw data queue words it
+// consumed and the queue position they were read from. On replay the words are
+// written back to the very same positions of the client to server channels, so
+// the command processing loops run unmodified on exactly the data they saw during
+// capture. Shared heap contents are not part of the trace, so capturing requires
+// the shared heap to be disabled.
+//
+// While capturing or replaying the cost of every processed command is also
+// collected and logged per command type on shutdown.
+namespace CommandTrace {
+  enum class Channel: uint8_t {
+    Module = 0,
+    Device = 1,
+    Count
+  };
+
+  using Clock = std::chrono::high_resolution_clock;
+
+  // Opens the capture file, returns false if capturing was not possible
+  bool beginCapture(const std::string& path);
+  // Reads a trace file for replay, returns false if the trace could not be loaded
+  bool loadReplay(const std::string& path);
+
+  bool isCapturing();
+  bool isReplaying();
+  inline bool isActive() {
+    return isCapturing() || isReplaying();
+  }
+
+  // Position of the first data queue word the processing loop of the channel reads
+  // in the trace. The server must skip ahead to it before replay is started.
+  size_t getReplayStartDataPos(const Channel channel);
+
+  // Starts feeding the loaded trace into the client to server channels and draining
+  // the server responses. The server channels must have been initialized already.
+  bool startReplay();
+  // Called once the command processing loops exited, stops the replay and logs
+  // the replay statistics.
+  void finishReplay();
+
+  // Window all client window handles are mapped to while replaying
+  HWND getReplayWindow();
+
+  // Called by the command processing loops before the first command is read
+  void beginChannel(const Channel channel, const ReaderChannel& readerChannel);
+  // Called by the command processing loops after a command was processed
+  void commandProcessed(const Channel channel, const ReaderChannel& readerChannel,
+                        const Header& header, const Clock::time_point start);
+
+  // Logs the per command cost histograms and closes the capture file
+  void shutdown();
+}
@@ -23,18 +23,23 @@
 
 #include "version.h"
 #include "module_processing.h"
+#include "command_pipeline.h"
+#include "command_trace.h"
 #include "remix_api.h"
 
 #include "util_bridge_assert.h"
 #include "util_circularbuffer.h"
 #include "util_commands.h"
 #include "util_common.h"
+#include "util_deferrederrors.h"
 #include "util_devicecommand.h"
 #include "util_filesys.h"
 #include "util_guid.h"
 #include "util_hack_d3d_debug.h"
+#include "util_handletable.h"
 #include "util_messagechannel.h"
 #include "util_modulecommand.h"
+#include "util_occlusionqueryresults.h"
 #include "util_process.h"
 #include "util_remixapi.h"
 #include "util_seh.h"
@@ -43,6 +48,7 @@
 #include "util_sharedmemory.h"
 #include "util_texture_and_volume.h"
 #include "util_version.h"
+#include "util_vertexring.h"
 
 #include "log/log.h"
 #include "config/config.h"
@@ -57,6 +63,7 @@
 #include <map>
 #include <atomic>
 #include <array>
+#include <vector>
 
 using namespace Commands;
 using namespace bridge_util;
@@ -76,6 +83,8 @@ using namespace remixapi::util;
     if (GlobalOptions::getSendCreateFunctionServerResponses() || GlobalOptions::getSendAllServerResponses()) { \
       ServerMessage c(Commands::Bridge_Response, uid); \
       c.send_data(hresult); \
+    } else if (FAILED(hresult) && GlobalOptions::getAsyncResourceCreation()) { \
+      DeferredCreateErrors::record(rpcHeader.command, hresult); \
     } \
   } 
 
@@ -108,7 +117,18 @@ using namespace remixapi::util;
 // https://docs.microsoft.com/en-us/windows/win32/winprog64/interprocess-communication?redirectedfrom=MSDN
 #define TRUNCATE_HANDLE(type, input) (type)(size_t)(input)
 
+// The client windows do not exist when replaying a command trace, so every window
+// is mapped to the replay window instead.
+static inline HWND toServerWindow(const uint32_t hWnd) {
+  if (hWnd != 0 && CommandTrace::isReplaying()) {
+    return CommandTrace::getReplayWindow();
+  }
+  return TRUNCATE_HANDLE(HWND, hWnd);
+}
+
 bool bDxvkModuleLoaded = false;
+// Resolved from Remix DXVK when it supports receiving the frame times of the client
+version::SetBridgeFrameTimesFunc gpSetBridgeFrameTimes = nullptr;
 std::chrono::steady_clock::time_point gTimeStart;
 
 // Shared memory and IPC channels
@@ -123,18 +143,34 @@ LPDIRECT3D9 gpD3D;
 
 bool gOverwriteConditionAlreadyActive = false;
 
-// Mapping between client and server pointer addresses
-std::unordered_map<uint32_t, IDirect3DDevice9*> gpD3DDevices;
-std::unordered_map<uint32_t, IDirect3DResource9*> gpD3DResources; // For Textures, Buffers, and Surfaces
-std::unordered_map<uint32_t, IDirect3DVolume9*> gpD3DVolumes;
-std::unordered_map<uint32_t, IDirect3DVertexDeclaration9*> gpD3DVertexDeclarations;
-std::unordered_map<uint32_t, IDirect3DStateBlock9*> gpD3DStateBlocks;
-std::unordered_map<uint32_t, IDirect3DVertexShader9*> gpD3DVertexShaders;
-std::unordered_map<uint32_t, IDirect3DPixelShader9*> gpD3DPixelShaders;
-std::unordered_map<uint32_t, IDirect3DSwapChain9*> gpD3DSwapChains;
-std::unordered_map<uint32_t, IDirect3DQuery9*> gpD3DQuery;
+// Mapping between client handles and server objects, client handles are dense indices (see ObjectHandle)
+HandleTable<IDirect3DDevice9> gpD3DDevices;
+HandleTable<IDirect3DResource9> gpD3DResources; // For Textures, Buffers, and Surfaces
+HandleTable<IDirect3DVolume9> gpD3DVolumes;
+HandleTable<IDirect3DVertexDeclaration9> gpD3DVertexDeclarations;
+HandleTable<IDirect3DStateBlock9> gpD3DStateBlocks;
+HandleTable<IDirect3DVertexShader9> gpD3DVertexShaders;
+HandleTable<IDirect3DPixelShader9> gpD3DPixelShaders;
+HandleTable<IDirect3DSwapChain9> gpD3DSwapChains;
+HandleTable<IDirect3DQuery9> gpD3DQuery;
 std::unordered_map<uint32_t, void*> gMapRemixApi;
 
+// Float shader constants of each device as of the last delta update, see DataIsDelta
+struct ShaderConstantShadow {
+  using Vec4 = std::array<float, 4>;
+  std::vector<Vec4> vertexConstantsF = std::vector<Vec4>(caps::MaxFloatConstantsSoftware);
+  std::vector<Vec4> pixelConstantsF = std::vector<Vec4>(caps::MaxFloatConstantsPS);
+};
+std::unordered_map<uint32_t, ShaderConstantShadow> gShaderConstantShadows;
+
+// Occlusion queries whose results are published through OcclusionQueryResults, see useAsyncOcclusionQueries
+struct AsyncOcclusionQuery {
+  uint32_t slot;
+  uint32_t issue = 0;
+  bool isPending = false;
+};
+std::unordered_map<uint32_t, AsyncOcclusionQuery> gAsyncOcclusionQueries;
+
 // Global state
 bool gbBridgeRunning = true;
 HANDLE hWait;
@@ -152,6 +188,30 @@ static void deserializeFromQueue(SerializableT& serializableT) {
 }
 }
 
+// Publishes the result of an ended occlusion query once the device has it, never waits on the GPU
+static void pollAsyncOcclusionQuery(IDirect3DQuery9* pQuery, AsyncOcclusionQuery& query, const DWORD dwGetDataFlags) {
+  if (!query.isPending) {
+    return;
+  }
+  DWORD result = 0;
+  const HRESULT hresult = pQuery->GetData(&result, sizeof(result), dwGetDataFlags & D3DGETDATA_FLUSH);
+  if (hresult == S_FALSE) {
+    return;
+  }
+  // The client can't be handed an error through the slot, so failed queries report the query geometry as visible
+  if (FAILED(hresult)) {
+    result = 1;
+  }
+  OcclusionQueryResults::publish(query.slot, query.issue, result);
+  query.isPending = false;
+}
+
+static void pollAsyncOcclusionQueries() {
+  for (auto& [handle, query] : gAsyncOcclusionQueries) {
+    pollAsyncOcclusionQuery(gpD3DQuery[handle], query, 0);
+  }
+}
+
 static inline void safeDestroy(IUnknown* obj, uint32_t x86handle) {
   // Note: in DXVK the refcounts of non-standalone objects may go negative!
   // We need to handle such objects appropriately, even though this is not
@@ -170,6 +230,28 @@ static inline void safeDestroy(IUnknown* obj, uint32_t x86handle) {
   while (obj && static_cast<LONG>(obj->Release()) > 0);
 }
 
+// Copies the {offset, size} ranges of a coalesced buffer Unlock into the locked span
+static void copyBufferRanges(void* pbLockedSpan, const UINT spanOffset, const Commands::Flags flags) {
+  PULL_U(numRanges);
+  BYTE* pSharedHeapBuf = nullptr;
+  if (Commands::IsDataInSharedHeap(flags)) {
+    PULL_U(allocId);
+    pSharedHeapBuf = SharedHeap::getBuf(allocId);
+  }
+  for (uint32_t i = 0; i < numRanges; ++i) {
+    PULL_U(RangeOffset);
+    PULL_U(RangeSize);
+    void* data = nullptr;
+    if (pSharedHeapBuf) {
+      data = pSharedHeapBuf + RangeOffset;
+    } else {
+      const auto size = DeviceBridge::get_data(&data);
+      assert(RangeSize == size);
+    }
+    memcpy(static_cast<BYTE*>(pbLockedSpan) + (RangeOffset - spanOffset), data, RangeSize);
+  }
+}
+
 D3DPRESENT_PARAMETERS getPresParamFromRaw(const uint32_t* rawPresentationParameters) {
   D3DPRESENT_PARAMETERS presParam;
   // Set up presentation parameters. We can't just directly cast the structure because the hDeviceWindow
@@ -184,6 +266,9 @@ D3DPRESENT_PARAMETERS getPresParamFromRaw(const uint32_t* rawPresentationParamet
 
   presParam.SwapEffect = *reinterpret_cast<const D3DSWAPEFFECT*>(rawPresentationParameters + 6);
   presParam.hDeviceWindow = *reinterpret_cast<const HWND*>(rawPresentationParameters + 7);
+  if (CommandTrace::isReplaying()) {
+    presParam.hDeviceWindow = toServerWindow(rawPresentationParameters[7]);
+  }
   presParam.Windowed = *reinterpret_cast<const BOOL*>(rawPresentationParameters + 8);
   presParam.EnableAutoDepthStencil = *reinterpret_cast<const BOOL*>(rawPresentationParameters + 9);
   presParam.AutoDepthStencilFormat = *reinterpret_cast<const D3DFORMAT*>(rawPresentationParameters + 10);
@@ -247,9 +332,9 @@ static bool dumpLeakedObjects(const char* name, const T& map) {
   if (!map.empty()) {
     bridge_util::Logger::err(format_string("%zd objects discovered in %s map at "
                               "Direct3D module eviction:", map.size(), name));
-    for (auto& [handle, obj] : map) {
-      bridge_util::Logger::err(format_string("\t%x -> %p", handle, obj));
-    }
+    map.forEach([](const uint32_t index, const auto* obj) {
+      bridge_util::Logger::err(format_string("\t%x -> %p", index, obj));
+    });
     return true;
   }
   return false;
@@ -271,11 +356,390 @@ static bool dumpLeakedObjects() {
   return anyLeaked;
 }
 
+// Pulls a float shader constant delta, applies it to the device's constant shadow
+// and returns the expanded register range.
+static const float* PullShaderConstantDelta(std::vector<ShaderConstantShadow::Vec4>& shadow,
+                                            const uint32_t startRegister,
+                                            const uint32_t count) {
+  uint32_t* pMask = nullptr;
+  const uint32_t maskSize = DeviceBridge::get_data((void**) &pMask);
+  assert(maskSize == ((count + 31) / 32) * sizeof(uint32_t));
+  float* pChangedRegs = nullptr;
+  DeviceBridge::get_data((void**) &pChangedRegs);
+  assert(startRegister + count <= shadow.size());
+  uint32_t changedIdx = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (pMask[i / 32] & (1u << (i % 32))) {
+      memcpy(shadow[startRegister + i].data(), &pChangedRegs[4 * changedIdx++], sizeof(ShaderConstantShadow::Vec4));
+    }
+  }
+  return shadow[startRegister].data();
+}
+
+// Deserialized instance of a Remix API draw along with the extensions chained to it
+struct RemixApiInstance {
+  serialize::InstanceInfo info;
+  struct InstanceExtensions {
+    serialize::InstanceInfoObjectPicking objectPicking;
+    serialize::InstanceInfoBlend blend;
+    serialize::InstanceInfoTransforms boneXforms;
+    // Bone palette in the vertex ring, points straight into the ring's mapping
+    remixapi_InstanceInfoBoneTransformsEXT ringBoneXforms;
+  } exts;
+};
+
+// Pulls the position of the bone palettes of a command's instances, if they were written to the
+// vertex ring. Returns nullptr if they were serialized with the instances instead.
+static const BYTE* PullRemixApiBonePalettes(const Header& rpcHeader, uint32_t& ringPos, uint32_t& ringSize) {
+  if (!Commands::IsDataInVertexRing(rpcHeader.flags)) {
+    return nullptr;
+  }
+  ringPos = DeviceBridge::get_data();
+  ringSize = DeviceBridge::get_data();
+  return VertexRing::getBuf(ringPos);
+}
+
+// Pulls an instance sent by the client's sendInstanceInfo, its pNext chain points into inst.exts
+static void PullRemixApiInstance(RemixApiInstance& inst, const BYTE* pBonePalettes) {
+  auto& exts = inst.exts;
+  memset(&exts, 0, sizeof(RemixApiInstance::InstanceExtensions));
+
+  const auto instSType = remixapi::pullSType();
+  assert(instSType == REMIXAPI_STRUCT_TYPE_INSTANCE_INFO);
+  serialize::InstanceInfo& instInfo = inst.info;
+  deserializeFromQueue(instInfo);
+
+  MeshHandle meshHandle(instInfo.mesh);
+  if(meshHandle.isValid()) {
+    instInfo.mesh = meshHandle;
+  } else {
+    Logger::err("[RemixApi_DrawInstance] Invalid mesh handle!" );
+  }
+
+  instInfo.pNext = nullptr;
+
+  bool bInstExtExists = remixapi::pullBool();
+  auto* pInfoProto = &getInfoProto(instInfo);
+  while(bInstExtExists) {
+    const auto extSType = remixapi::pullSType();
+    switch (extSType) {
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_OBJECT_PICKING_EXT:
+      {
+        assert(!exts.objectPicking.pNext);
+        deserializeFromQueue(exts.objectPicking);
+        pInfoProto->pNext = &(exts.objectPicking);
+        pInfoProto = &getInfoProto(exts.objectPicking);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BLEND_EXT:
+      {
+        assert(!exts.blend.pNext);
+        deserializeFromQueue(exts.blend);
+        pInfoProto->pNext = &(exts.blend);
+        pInfoProto = &getInfoProto(exts.blend);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT:
+      {
+        if (pBonePalettes) {
+          auto& ringXforms = exts.ringBoneXforms;
+          ringXforms.sType = REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT;
+          ringXforms.boneTransforms_count = DeviceBridge::get_data();
+          const uint32_t paletteOffset = DeviceBridge::get_data();
+          ringXforms.boneTransforms_values = reinterpret_cast<const remixapi_Transform*>(pBonePalettes + paletteOffset);
+          pInfoProto->pNext = &ringXforms;
+          pInfoProto = &getInfoProto(ringXforms);
+          break;
+        }
+        assert(!exts.boneXforms.pNext);
+        deserializeFromQueue(exts.boneXforms);
+        pInfoProto->pNext = &(exts.boneXforms);
+        pInfoProto = &getInfoProto(exts.boneXforms);
+        break;
+      }
+      default:
+      {
+        Logger::warn("[RemixApi_DrawInstance] Unknown sType. Skipping.");
+        break;
+      }
+    }
+    bInstExtExists = remixapi::pullBool();
+  }
+}
+
+// Deserialized Remix API light along with the extensions chained to it
+struct RemixApiLight {
+  serialize::LightInfo info;
+  struct LightExtensions {
+    serialize::LightInfoSphere sphere;
+    serialize::LightInfoRect rect;
+    serialize::LightInfoDisk disk;
+    serialize::LightInfoCylinder cylinder;
+    serialize::LightInfoDistant distant;
+    serialize::LightInfoDome dome;
+    serialize::LightInfoUSD usd;
+  } exts;
+};
+
+// Pulls a light sent by the client's sendLightInfo, its pNext chain points into light.exts
+static void PullRemixApiLight(RemixApiLight& light) {
+  auto& exts = light.exts;
+  memset(&exts, 0, sizeof(RemixApiLight::LightExtensions));
+
+  const auto lightSType = remixapi::pullSType();
+  assert(lightSType == REMIXAPI_STRUCT_TYPE_LIGHT_INFO);
+  serialize::LightInfo& lightInfo = light.info;
+  deserializeFromQueue(lightInfo);
+  lightInfo.pNext = nullptr;
+
+  bool bLightExtExists = remixapi::pullBool();
+  auto* pInfoProto = &getInfoProto(lightInfo);
+  while(bLightExtExists) {
+    const auto extSType = remixapi::pullSType();
+    switch (extSType) {
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_SPHERE_EXT:
+      {
+        assert(!exts.sphere.pNext);
+        deserializeFromQueue(exts.sphere);
+        pInfoProto->pNext = &(exts.sphere);
+        pInfoProto = &getInfoProto(exts.sphere);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_RECT_EXT:
+      {
+        assert(!exts.rect.pNext);
+        deserializeFromQueue(exts.rect);
+        pInfoProto->pNext = &(exts.rect);
+        pInfoProto = &getInfoProto(exts.rect);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISK_EXT:
+      {
+        assert(!exts.disk.pNext);
+        deserializeFromQueue(exts.disk);
+        pInfoProto->pNext = &(exts.disk);
+        pInfoProto = &getInfoProto(exts.disk);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_CYLINDER_EXT:
+      {
+        assert(!exts.cylinder.pNext);
+        deserializeFromQueue(exts.cylinder);
+        pInfoProto->pNext = &(exts.cylinder);
+        pInfoProto = &getInfoProto(exts.cylinder);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISTANT_EXT:
+      {
+        assert(!exts.distant.pNext);
+        deserializeFromQueue(exts.distant);
+        pInfoProto->pNext = &(exts.distant);
+        pInfoProto = &getInfoProto(exts.distant);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DOME_EXT:
+      {
+        assert(!exts.dome.pNext);
+        deserializeFromQueue(exts.dome);
+        pInfoProto->pNext = &(exts.dome);
+        pInfoProto = &getInfoProto(exts.dome);
+        break;
+      }
+      case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_USD_EXT:
+      {
+        assert(!exts.usd.pNext);
+        deserializeFromQueue(exts.usd);
+        pInfoProto->pNext = &(exts.usd);
+        pInfoProto = &getInfoProto(exts.usd);
+        break;
+      }
+      default:
+      {
+        Logger::warn("[RemixApi_CreateLight] Unknown sType. Skipping.");
+        break;
+      }
+    }
+    bLightExtExists = remixapi::pullBool();
+  }
+}
+
+// Decode stage of the server command pipeline. Pulls the arguments of a pipelined
+// command and resolves its handles, then hands it to the execute stage. Returns
+// false if the command is not pipelined and has to be processed as usual.
+static bool DecodePipelinedCommand(const Header& rpcHeader, CommandPipeline& pipeline) {
+  if (!CommandPipeline::isPipelined(rpcHeader.command)) {
+    return false;
+  }
+
+  DecodedCommand cmd;
+  cmd.command = rpcHeader.command;
+  {
+    GET_RES(pD3DDevice, gpD3DDevices);
+    cmd.pDevice = pD3DDevice;
+  }
+  uint32_t* const args = cmd.args;
+  auto pullPayload = [&cmd](const size_t size) {
+    void* pData = nullptr;
+    const uint32_t len = DeviceBridge::get_data(&pData);
+    assert(len == 0 || size == len);
+    if (pData != nullptr && len <= DecodedCommand::kMaxPayloadSize) {
+      memcpy(cmd.payload, pData, len);
+      cmd.bInlinePayload = true;
+    } else {
+      cmd.pData = pData;
+    }
+  };
+
+  switch (rpcHeader.command) {
+  case IDirect3DDevice9Ex_BeginScene:
+  case IDirect3DDevice9Ex_EndScene:
+    break;
+  case IDirect3DDevice9Ex_SetTransform:
+    args[0] = DeviceBridge::get_data();
+    pullPayload(sizeof(D3DMATRIX));
+    break;
+  case IDirect3DDevice9Ex_SetViewport:
+    pullPayload(sizeof(D3DVIEWPORT9));
+    break;
+  case IDirect3DDevice9Ex_SetScissorRect:
+    pullPayload(sizeof(RECT));
+    break;
+  case IDirect3DDevice9Ex_SetRenderState:
+  case IDirect3DDevice9Ex_SetStreamSourceFreq:
+    args[0] = DeviceBridge::get_data();
+    args[1] = DeviceBridge::get_data();
+    break;
+  case IDirect3DDevice9Ex_SetTextureStageState:
+  case IDirect3DDevice9Ex_SetSamplerState:
+  case IDirect3DDevice9Ex_DrawPrimitive:
+    args[0] = DeviceBridge::get_data();
+    args[1] = DeviceBridge::get_data();
+    args[2] = DeviceBridge::get_data();
+    break;
+  case IDirect3DDevice9Ex_DrawIndexedPrimitive:
+    for (uint32_t i = 0; i < 6; ++i) {
+      args[i] = DeviceBridge::get_data();
+    }
+    break;
+  case IDirect3DDevice9Ex_SetFVF:
+    args[0] = DeviceBridge::get_data();
+    break;
+  case IDirect3DDevice9Ex_SetTexture:
+  {
+    args[0] = DeviceBridge::get_data();
+    PULL_U(pHandle);
+    if (pHandle != NULL) {
+      cmd.pObject = (IDirect3DBaseTexture9*) gpD3DResources[pHandle];
+      assert(cmd.pObject != nullptr);
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetStreamSource:
+  {
+    args[0] = DeviceBridge::get_data();
+    PULL_U(pHandle);
+    args[1] = DeviceBridge::get_data();
+    args[2] = DeviceBridge::get_data();
+    if (pHandle != NULL) {
+      cmd.pObject = (IDirect3DVertexBuffer9*) gpD3DResources[pHandle];
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetIndices:
+  {
+    PULL_U(pHandle);
+    if (pHandle != NULL) {
+      cmd.pObject = (IDirect3DIndexBuffer9*) gpD3DResources[pHandle];
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetVertexDeclaration:
+  {
+    PULL_U(pHandle);
+    if (pHandle != NULL) {
+      cmd.pObject = gpD3DVertexDeclarations[pHandle];
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetVertexShader:
+  {
+    PULL_U(pHandle);
+    if (pHandle != NULL) {
+      cmd.pObject = gpD3DVertexShaders[pHandle];
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetPixelShader:
+  {
+    PULL_U(pHandle);
+    if (pHandle != NULL) {
+      cmd.pObject = gpD3DPixelShaders[pHandle];
+    }
+    break;
+  }
+  case IDirect3DDevice9Ex_SetVertexShaderConstantF:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantF:
+    args[0] = DeviceBridge::get_data();
+    args[1] = DeviceBridge::get_data();
+    if (Commands::IsDataDelta(rpcHeader.flags)) {
+      auto& shadow = gShaderConstantShadows[rpcHeader.pHandle];
+      const float* const pConstantData = PullShaderConstantDelta(
+        rpcHeader.command == IDirect3DDevice9Ex_SetVertexShaderConstantF ? shadow.vertexConstantsF : shadow.pixelConstantsF,
+        args[0], args[1]);
+      const size_t size = args[1] * sizeof(float) * 4;
+      if (size <= DecodedCommand::kMaxPayloadSize) {
+        memcpy(cmd.payload, pConstantData, size);
+        cmd.bInlinePayload = true;
+      } else {
+        cmd.pData = pConstantData;
+      }
+    } else {
+      pullPayload(args[1] * sizeof(float) * 4);
+    }
+    break;
+  case IDirect3DDevice9Ex_SetVertexShaderConstantI:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantI:
+    args[0] = DeviceBridge::get_data();
+    args[1] = DeviceBridge::get_data();
+    pullPayload(args[1] * sizeof(int) * 4);
+    break;
+  case IDirect3DDevice9Ex_SetVertexShaderConstantB:
+  case IDirect3DDevice9Ex_SetPixelShaderConstantB:
+    args[0] = DeviceBridge::get_data();
+    args[1] = DeviceBridge::get_data();
+    pullPayload(args[1] * sizeof(BOOL));
+    break;
+  default:
+    break;
+  }
+
+  if (cmd.pData != nullptr) {
+    // Payload still lives in the data queue, execute in order right away
+    pipeline.drain();
+    CommandPipeline::execute(cmd);
+  } else {
+    pipeline.push(cmd);
+  }
+  return true;
+}
+
 void ProcessDeviceCommandQueue() {
+  // Pipelined execution is only possible when no per command responses are sent
+  std::unique_ptr<CommandPipeline> pPipeline;
+  if (ServerOptions::getUseCommandPipeline() && !GlobalOptions::getSendAllServerResponses()) {
+    pPipeline = std::make_unique<CommandPipeline>(ServerOptions::getCommandPipelineSize());
+  }
+
+  CommandTrace::beginChannel(CommandTrace::Channel::Device, DeviceBridge::getReaderChannel());
+
   // Loop until the client sends terminate instruction
   bool done = false;
   while (!done && DeviceBridge::waitForCommand() == Result::Success) {
     ZoneScopedN("Process Command");
+    CommandTrace::Clock::time_point commandStart;
+    if (CommandTrace::isActive()) {
+      commandStart = CommandTrace::Clock::now();
+    }
 #ifdef LOG_SERVER_COMMAND_TIME
     // Take a snapshot of the current tick count for profiling purposes
     const auto start = GetTickCount64();
@@ -305,8 +769,17 @@ void ProcessDeviceCommandQueue() {
         Logger::info("Device Processing: " + toString(rpcHeader.command) + " UID: " + std::to_string(currentUID));
       }
 #endif
+      // Hot setters and draws are decoded here and executed by the pipeline,
+      // everything else is executed in order once the pipeline has drained.
+      bool bPipelined = false;
+      if (pPipeline) {
+        bPipelined = DecodePipelinedCommand(rpcHeader, *pPipeline);
+        if (!bPipelined) {
+          pPipeline->drain();
+        }
+      }
       // The mother of all switch statements - every call in the D3D9 interface is mapped here...
-      switch (rpcHeader.command) {
+      switch (bPipelined ? Bridge_Invalid : rpcHeader.command) {
       case IDirect3D9Ex_CreateDeviceEx:
       {
         GET_HND(pHandle);
@@ -322,7 +795,7 @@ void ProcessDeviceCommandQueue() {
         D3DPRESENT_PARAMETERS PresentationParameters = getPresParamFromRaw(rawPresentationParameters);
 
         IDirect3DDevice9Ex* pD3DDevice = nullptr;
-        const auto hresult = ((IDirect3D9Ex*) gpD3D)->CreateDeviceEx(IN Adapter, IN DeviceType, IN TRUNCATE_HANDLE(HWND, hFocusWindow), IN BehaviorFlags, IN OUT & PresentationParameters, IN pFullscreenDisplayMode, OUT & pD3DDevice);
+        const auto hresult = ((IDirect3D9Ex*) gpD3D)->CreateDeviceEx(IN Adapter, IN DeviceType, IN toServerWindow(hFocusWindow), IN BehaviorFlags, IN OUT & PresentationParameters, IN pFullscreenDisplayMode, OUT & pD3DDevice);
         if (!SUCCEEDED(hresult)) {
           std::stringstream ss;
           ss << format_string("CreateDeviceEx() call failed with error code 0x%x", hresult) << std::endl;
@@ -357,7 +830,7 @@ void ProcessDeviceCommandQueue() {
         D3DPRESENT_PARAMETERS PresentationParameters = getPresParamFromRaw(rawPresentationParameters);
 
         IDirect3DDevice9* pD3DDevice = nullptr;
-        const auto hresult = gpD3D->CreateDevice(IN Adapter, IN DeviceType, IN TRUNCATE_HANDLE(HWND, hFocusWindow), IN BehaviorFlags, IN OUT & PresentationParameters, OUT & pD3DDevice);
+        const auto hresult = gpD3D->CreateDevice(IN Adapter, IN DeviceType, IN toServerWindow(hFocusWindow), IN BehaviorFlags, IN OUT & PresentationParameters, OUT & pD3DDevice);
         if (!SUCCEEDED(hresult)) {
           std::stringstream ss;
           ss << format_string("CreateDevice() call failed with error code 0x%x", hresult) << std::endl;
@@ -503,6 +976,7 @@ void ProcessDeviceCommandQueue() {
         GET_RES(pD3DDevice, gpD3DDevices);
         safeDestroy(pD3DDevice, pD3DDeviceHandle);
         gpD3DDevices.erase(pD3DDeviceHandle);
+        gShaderConstantShadows.erase(pD3DDeviceHandle);
         break;
       }
       case IDirect3DDevice9Ex_TestCooperativeLevel:
@@ -699,7 +1173,7 @@ void ProcessDeviceCommandQueue() {
         PULL(uint32_t, hDestWindowOverride);
         PULL_OBJ(RGNDATA, pDirtyRegion);
 
-        HWND hwnd = TRUNCATE_HANDLE(HWND, hDestWindowOverride);
+        HWND hwnd = toServerWindow(hDestWindowOverride);
 
         const auto hresult = pD3DDevice->Present(pSourceRect, pDestRect, hwnd, pDirtyRegion);
         if (!SUCCEEDED(hresult)) {
@@ -708,6 +1182,8 @@ void ProcessDeviceCommandQueue() {
           Logger::err(ss.str());
         }
 
+        pollAsyncOcclusionQueries();
+
         // If we're syncing with the client on Present() then trigger the semaphore now
         if (GlobalOptions::getPresentSemaphoreEnabled()) {
           gpPresent->release();
@@ -1332,11 +1808,23 @@ void ProcessDeviceCommandQueue() {
         GET_RES(pD3DDevice, gpD3DDevices);
         PULL(D3DPRIMITIVETYPE, PrimitiveType);
         PULL_U(PrimitiveCount);
-        void* pVertexStreamZeroData = nullptr;
-        DeviceBridge::get_data(&pVertexStreamZeroData);
+        const void* pVertexStreamZeroData = nullptr;
+        const bool useVertexRing = Commands::IsDataInVertexRing(rpcHeader.flags);
+        uint32_t ringPos = 0, ringSize = 0;
+        if (useVertexRing) {
+          ringPos = DeviceBridge::get_data();
+          ringSize = DeviceBridge::get_data();
+          pVertexStreamZeroData = VertexRing::getBuf(ringPos);
+        } else {
+          DeviceBridge::get_data((void**) &pVertexStreamZeroData);
+        }
         PULL_U(VertexStreamZeroStride);
         const auto hresult = pD3DDevice->DrawPrimitiveUP(IN PrimitiveType, IN PrimitiveCount, IN pVertexStreamZeroData, IN VertexStreamZeroStride);
         assert(SUCCEEDED(hresult));
+        // The device copies UP data right away, so the ring space can be handed back
+        if (useVertexRing) {
+          VertexRing::release(ringPos, ringSize);
+        }
         SEND_OPTIONAL_SERVER_RESPONSE(hresult, currentUID);
         break;
       }
@@ -1350,13 +1838,26 @@ void ProcessDeviceCommandQueue() {
         PULL(D3DFORMAT, IndexDataFormat);
         PULL_U(VertexStreamZeroStride);
 
-        void* pIndexData = nullptr;
-        DeviceBridge::get_data(&pIndexData);
-        void* pVertexStreamZeroData = nullptr;
-        DeviceBridge::get_data(&pVertexStreamZeroData);
+        const void* pIndexData = nullptr;
+        const void* pVertexStreamZeroData = nullptr;
+        const bool useVertexRing = Commands::IsDataInVertexRing(rpcHeader.flags);
+        uint32_t ringPos = 0, ringSize = 0;
+        if (useVertexRing) {
+          ringPos = DeviceBridge::get_data();
+          ringSize = DeviceBridge::get_data();
+          PULL_U(indexDataOffset);
+          pVertexStreamZeroData = VertexRing::getBuf(ringPos);
+          pIndexData = VertexRing::getBuf(ringPos + indexDataOffset);
+        } else {
+          DeviceBridge::get_data((void**) &pIndexData);
+          DeviceBridge::get_data((void**) &pVertexStreamZeroData);
+        }
 
         const auto hresult = pD3DDevice->DrawIndexedPrimitiveUP(IN PrimitiveType, IN MinVertexIndex, IN NumVertices, IN PrimitiveCount, IN pIndexData, IN IndexDataFormat, IN pVertexStreamZeroData, IN VertexStreamZeroStride);
         assert(SUCCEEDED(hresult));
+        if (useVertexRing) {
+          VertexRing::release(ringPos, ringSize);
+        }
         SEND_OPTIONAL_SERVER_RESPONSE(hresult, currentUID);
         break;
       }
@@ -1456,8 +1957,13 @@ void ProcessDeviceCommandQueue() {
         GET_RES(pD3DDevice, gpD3DDevices);
         PULL_U(StartRegister);
         PULL_U(Count);
-        float* pConstantData = nullptr;
-        PULL_DATA(Count * sizeof(float) * 4, pConstantData);
+        const float* pConstantData = nullptr;
+        if (Commands::IsDataDelta(rpcHeader.flags)) {
+          auto& shadow = gShaderConstantShadows[pD3DDeviceHandle].vertexConstantsF;
+          pConstantData = PullShaderConstantDelta(shadow, StartRegister, Count);
+        } else {
+          PULL_DATA(Count * sizeof(float) * 4, pConstantData);
+        }
         const auto hresult = pD3DDevice->SetVertexShaderConstantF(IN StartRegister, IN pConstantData, IN Count);
         assert(SUCCEEDED(hresult));
         SEND_OPTIONAL_SERVER_RESPONSE(hresult, currentUID);
@@ -1574,8 +2080,13 @@ void ProcessDeviceCommandQueue() {
         GET_RES(pD3DDevice, gpD3DDevices);
         PULL_U(StartRegister);
         PULL_U(Count);
-        float* pConstantData = nullptr;
-        PULL_DATA(Count * sizeof(float) * 4, pConstantData);
+        const float* pConstantData = nullptr;
+        if (Commands::IsDataDelta(rpcHeader.flags)) {
+          auto& shadow = gShaderConstantShadows[pD3DDeviceHandle].pixelConstantsF;
+          pConstantData = PullShaderConstantDelta(shadow, StartRegister, Count);
+        } else {
+          PULL_DATA(Count * sizeof(float) * 4, pConstantData);
+        }
         const auto hresult = pD3DDevice->SetPixelShaderConstantF(IN StartRegister, IN pConstantData, IN Count);
         assert(SUCCEEDED(hresult));
         SEND_OPTIONAL_SERVER_RESPONSE(hresult, currentUID);
@@ -1664,7 +2175,7 @@ void ProcessDeviceCommandQueue() {
       {
         GET_RES(pD3DDevice, gpD3DDevices);
         PULL(uint32_t, hDestinationWindow);
-        HWND hwnd = TRUNCATE_HANDLE(HWND, hDestinationWindow);
+        HWND hwnd = toServerWindow(hDestinationWindow);
         const auto hresult = ((IDirect3DDevice9Ex*) pD3DDevice)->CheckDeviceState(IN hwnd);
         assert(SUCCEEDED(hresult));
         {
@@ -1678,10 +2189,17 @@ void ProcessDeviceCommandQueue() {
         GET_RES(pD3DDevice, gpD3DDevices);
         PULL(D3DQUERYTYPE, Type);
         PULL_HND(pHandle);
+        uint32_t resultSlot = OcclusionQueryResults::kInvalidSlot;
+        if (OcclusionQueryResults::isEnabled()) {
+          resultSlot = DeviceBridge::get_data();
+        }
         IDirect3DQuery9* ppQuery;
         const auto hresult = pD3DDevice->CreateQuery(IN Type, OUT & ppQuery);
         if (SUCCEEDED(hresult)) {
           gpD3DQuery[pHandle] = ppQuery;
+          if (resultSlot != OcclusionQueryResults::kInvalidSlot) {
+            gAsyncOcclusionQueries[pHandle] = AsyncOcclusionQuery { resultSlot };
+          }
         }
         break;
       }
@@ -1748,8 +2266,16 @@ void ProcessDeviceCommandQueue() {
         PULL(uint32_t, hDestWindowOverride);
         PULL_OBJ(RGNDATA, pDirtyRegion);
         PULL(uint32_t, dwFlags);
+        uint64_t* pFrameTimes = nullptr;
+        PULL_DATA(sizeof(uint64_t) * 2, pFrameTimes);
+
+        if (gpSetBridgeFrameTimes && pFrameTimes) {
+          LARGE_INTEGER presentReceived;
+          QueryPerformanceCounter(&presentReceived);
+          gpSetBridgeFrameTimes(pFrameTimes[0], pFrameTimes[1], presentReceived.QuadPart);
+        }
 
-        HWND hwnd = TRUNCATE_HANDLE(HWND, hDestWindowOverride);
+        HWND hwnd = toServerWindow(hDestWindowOverride);
 
         const auto hresult = pSwapChain->Present(pSourceRect, pDestRect, hwnd, pDirtyRegion, dwFlags);
 
@@ -2385,17 +2911,21 @@ void ProcessDeviceCommandQueue() {
 
         // Copy the data over
         void* data = nullptr;
-        if (Commands::IsDataReserved(rpcHeader.flags)) {
-          PULL_D(DataOffset);
-          data = DeviceBridge::Bridge::getReaderChannel().get_data_ptr() + DataOffset;
-        } else if (Commands::IsDataInSharedHeap(rpcHeader.flags)) {
-          PULL_U(allocId);
-          data = SharedHeap::getBuf(allocId) + OffsetToLock;
+        if (Commands::IsDataInRanges(rpcHeader.flags)) {
+          copyBufferRanges(pbData, OffsetToLock, rpcHeader.flags);
         } else {
-          const auto size = DeviceBridge::get_data(&data);
-          assert(SizeToLock == size);
+          if (Commands::IsDataReserved(rpcHeader.flags)) {
+            PULL_D(DataOffset);
+            data = DeviceBridge::Bridge::getReaderChannel().get_data_ptr() + DataOffset;
+          } else if (Commands::IsDataInSharedHeap(rpcHeader.flags)) {
+            PULL_U(allocId);
+            data = SharedHeap::getBuf(allocId) + OffsetToLock;
+          } else {
+            const auto size = DeviceBridge::get_data(&data);
+            assert(SizeToLock == size);
+          }
+          memcpy(pbData, data, SizeToLock);
         }
-        memcpy(pbData, data, SizeToLock);
         hresult = pVertexBuffer->Unlock();
         assert(SUCCEEDED(hresult));
 
@@ -2471,17 +3001,21 @@ void ProcessDeviceCommandQueue() {
 
         // Copy the data over
         void* data = nullptr;
-        if (Commands::IsDataReserved(rpcHeader.flags)) {
-          PULL_D(DataOffset);
-          data = DeviceBridge::Bridge::getReaderChannel().get_data_ptr() + DataOffset;
-        } else if (Commands::IsDataInSharedHeap(rpcHeader.flags)) {
-          PULL_U(allocId);
-          data = SharedHeap::getBuf(allocId) + OffsetToLock;
+        if (Commands::IsDataInRanges(rpcHeader.flags)) {
+          copyBufferRanges(pbData, OffsetToLock, rpcHeader.flags);
         } else {
-          const auto size = DeviceBridge::get_data(&data);
-          assert(SizeToLock == size);
+          if (Commands::IsDataReserved(rpcHeader.flags)) {
+            PULL_D(DataOffset);
+            data = DeviceBridge::Bridge::getReaderChannel().get_data_ptr() + DataOffset;
+          } else if (Commands::IsDataInSharedHeap(rpcHeader.flags)) {
+            PULL_U(allocId);
+            data = SharedHeap::getBuf(allocId) + OffsetToLock;
+          } else {
+            const auto size = DeviceBridge::get_data(&data);
+            assert(SizeToLock == size);
+          }
+          memcpy(pbData, data, SizeToLock);
         }
-        memcpy(pbData, data, SizeToLock);
         hresult = pIndexBuffer->Unlock();
         assert(SUCCEEDED(hresult));
         break;
@@ -2699,6 +3233,7 @@ void ProcessDeviceCommandQueue() {
         const auto& pQuery = (IDirect3DQuery9*) gpD3DQuery[pHandle];
         safeDestroy(pQuery, pHandle);
         gpD3DQuery.erase(pHandle);
+        gAsyncOcclusionQueries.erase(pHandle);
         break;
       }
       case IDirect3DQuery9_GetDevice:
@@ -2713,6 +3248,12 @@ void ProcessDeviceCommandQueue() {
         PULL(DWORD, dwIssueFlags);
         const auto &pQuery = gpD3DQuery[pHandle];
         const auto hresult = pQuery->Issue(dwIssueFlags);
+        if (auto it = gAsyncOcclusionQueries.find(pHandle); it != gAsyncOcclusionQueries.end()) {
+          PULL_U(issue);
+          // Only ended queries get a result, a begun one stays unanswered until its end
+          it->second.issue = issue;
+          it->second.isPending = (dwIssueFlags & D3DISSUE_END) != 0;
+        }
         SEND_OPTIONAL_SERVER_RESPONSE(hresult, currentUID);
         break;
       }
@@ -2722,6 +3263,11 @@ void ProcessDeviceCommandQueue() {
         PULL(DWORD, dwSize);
         PULL(DWORD, dwGetDataFlags);
         const auto& pQuery = gpD3DQuery[pHandle];
+        // Ended async occlusion queries are only checked on, the client doesn't wait for a response
+        if (auto it = gAsyncOcclusionQueries.find(pHandle); it != gAsyncOcclusionQueries.end() && it->second.issue != 0) {
+          pollAsyncOcclusionQuery(pQuery, it->second, dwGetDataFlags);
+          break;
+        }
         void* pData = NULL;
         if (dwSize > 0) {
           pData = new char[dwSize];
@@ -2751,7 +3297,7 @@ void ProcessDeviceCommandQueue() {
         PULL_U(i);
         const int length = DeviceBridge::getReaderChannel().data->peek();
         void* text = nullptr;
-        const int size = DeviceBridge::getReaderChannel().data->pull(&text);
+        const int size = DeviceBridge::get_data(&text);
         std::stringstream ss;
         ss << "DebugMessage. i = " << i << ", length = " << length << " = " << size << ", text = '" << (char*) text << "'";
         Logger::info(ss.str().c_str());
@@ -2796,6 +3342,39 @@ void ProcessDeviceCommandQueue() {
         gpD3DVolumes.erase(pHandle);
         break;
       }
+      case Bridge_UnlockSurfaceBatch:
+      {
+        PULL_U(numEntries);
+        SurfaceUploadEntry* pEntries = nullptr;
+        PULL_DATA(numEntries * sizeof(SurfaceUploadEntry), pEntries);
+        const bool useSharedHeap = Commands::IsDataInSharedHeap(rpcHeader.flags);
+        uint8_t* pBlob = nullptr;
+        if (!useSharedHeap) {
+          DeviceBridge::get_data((void**) &pBlob);
+        }
+        for (uint32_t i = 0; i < numEntries; ++i) {
+          const SurfaceUploadEntry& entry = pEntries[i];
+          const auto pSurface = (IDirect3DSurface9*) gpD3DResources[entry.surfaceHandle];
+          D3DLOCKED_RECT lockedRect;
+          auto hresult = pSurface->LockRect(OUT & lockedRect, IN & entry.rect, IN entry.flags);
+          assert(S_OK == hresult);
+          if (FAILED(hresult)) {
+            continue;
+          }
+          const uint32_t width = entry.rect.right - entry.rect.left;
+          const uint32_t height = entry.rect.bottom - entry.rect.top;
+          const size_t rowSize = bridge_util::calcRowSize(width, entry.format);
+          const PBYTE pData = useSharedHeap ?
+            SharedHeap::getBuf(entry.bufIdOrDataOffset) + bridge_util::calcImageByteOffset(entry.pitch, entry.rect, entry.format) :
+            pBlob + entry.bufIdOrDataOffset;
+          FOR_EACH_RECT_ROW(lockedRect, height, entry.format,
+            memcpy(ptr, pData + y * entry.pitch, rowSize);
+          )
+          hresult = pSurface->UnlockRect();
+          assert(SUCCEEDED(hresult));
+        }
+        break;
+      }
       /*
        * BridgeApi commands
        */
@@ -2889,6 +3468,7 @@ void ProcessDeviceCommandQueue() {
       }
 
       case RemixApi_CreateMesh:
+      case RemixApi_CreateMeshAsync:
       {
         const auto meshInfoSType = remixapi::pullSType();
         assert(meshInfoSType == REMIXAPI_STRUCT_TYPE_MESH_INFO);
@@ -2908,7 +3488,10 @@ void ProcessDeviceCommandQueue() {
 
         auto bridgeHandle = DeviceBridge::get_data();
         remixapi_MeshHandle remixApiHandle = nullptr;
-        if(remixapi::g_remix.CreateMesh(&meshInfo, &remixApiHandle) == REMIXAPI_ERROR_CODE_SUCCESS) {
+        // Async creation only copies the mesh data, so the server can move on to the next command right away
+        const auto pfnCreateMesh = (rpcHeader.command == RemixApi_CreateMeshAsync && remixapi::g_remix.CreateMeshAsync) ?
+          remixapi::g_remix.CreateMeshAsync : remixapi::g_remix.CreateMesh;
+        if(pfnCreateMesh(&meshInfo, &remixApiHandle) == REMIXAPI_ERROR_CODE_SUCCESS) {
           MeshHandle handle(bridgeHandle, remixApiHandle);
         } else {
           Logger::err("[RemixApi_CreateMesh] Remix API call failed!");
@@ -2917,6 +3500,25 @@ void ProcessDeviceCommandQueue() {
         break;
       }
 
+      case RemixApi_UpdateMeshVertices:
+      {
+        MeshHandle handle(DeviceBridge::get_data());
+        const uint32_t surfaceIndex = DeviceBridge::get_data();
+        uint64_t* pFirstVertex = nullptr;
+        DeviceBridge::get_data((void**) &pFirstVertex);
+        remixapi_HardcodedVertex* pVertices = nullptr;
+        const auto verticesSize = DeviceBridge::get_data((void**) &pVertices);
+        if(!remixapi::g_remix.UpdateMeshVertices) {
+          Logger::err("[RemixApi_UpdateMeshVertices] Not supported by the Remix runtime!");
+        } else if(handle.isValid()) {
+          remixapi::g_remix.UpdateMeshVertices(handle, surfaceIndex, *pFirstVertex, pVertices,
+                                               verticesSize / sizeof(remixapi_HardcodedVertex));
+        } else {
+          Logger::err("[RemixApi_UpdateMeshVertices] Invalid mesh handle!" );
+        }
+        break;
+      }
+
       case RemixApi_DestroyMesh:
       {
         MeshHandle handle(DeviceBridge::get_data());
@@ -2934,163 +3536,129 @@ void ProcessDeviceCommandQueue() {
         // Rather than allocate deserialized struct extensions on the heap,
         // allocate them locally, since we know only one instance will be
         // supported at a time
-        struct InstanceExtensions {
-          serialize::InstanceInfoObjectPicking objectPicking;
-          serialize::InstanceInfoBlend blend;
-          serialize::InstanceInfoTransforms boneXforms;
-        } exts;
-        memset(&exts, 0, sizeof(InstanceExtensions));
+        uint32_t ringPos = 0, ringSize = 0;
+        const BYTE* pBonePalettes = PullRemixApiBonePalettes(rpcHeader, ringPos, ringSize);
+        RemixApiInstance inst;
+        PullRemixApiInstance(inst, pBonePalettes);
 
-        const auto instSType = remixapi::pullSType();
-        assert(instSType == REMIXAPI_STRUCT_TYPE_INSTANCE_INFO);
-        serialize::InstanceInfo instInfo;
-        deserializeFromQueue(instInfo);
-        
-        MeshHandle meshHandle(instInfo.mesh);
-        if(meshHandle.isValid()) {
-          instInfo.mesh = meshHandle;
-        } else {
-          Logger::err("[RemixApi_DrawInstance] Invalid mesh handle!" );
+        if(remixapi::g_remix.DrawInstance(&inst.info) != REMIXAPI_ERROR_CODE_SUCCESS) {
+          Logger::err("[RemixApi_DrawInstance] Remix API call failed!");
+        }
+        // Remix copies the bone transforms during the call
+        if (pBonePalettes) {
+          VertexRing::release(ringPos, ringSize);
         }
 
-        instInfo.pNext = nullptr;
-        
-        bool bInstExtExists = remixapi::pullBool();
-        auto* pInfoProto = &getInfoProto(instInfo);
-        while(bInstExtExists) {
-          const auto extSType = remixapi::pullSType();
-          switch (extSType) {
-            case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_OBJECT_PICKING_EXT:
-            {
-              assert(!exts.objectPicking.pNext);
-              deserializeFromQueue(exts.objectPicking);
-              pInfoProto->pNext = &(exts.objectPicking);
-              pInfoProto = &getInfoProto(exts.objectPicking);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BLEND_EXT:
-            {
-              assert(!exts.blend.pNext);
-              deserializeFromQueue(exts.blend);
-              pInfoProto->pNext = &(exts.blend);
-              pInfoProto = &getInfoProto(exts.blend);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_INSTANCE_INFO_BONE_TRANSFORMS_EXT:
-            {
-              assert(!exts.boneXforms.pNext);
-              deserializeFromQueue(exts.boneXforms);
-              pInfoProto->pNext = &(exts.boneXforms);
-              pInfoProto = &getInfoProto(exts.boneXforms);
-              break;
-            }
-            default:
-            {
-              Logger::warn("[RemixApi_DrawInstance] Unknown sType. Skipping.");
-              break;
+        break;
+      }
+
+      case RemixApi_DrawInstances:
+      {
+        uint32_t ringPos = 0, ringSize = 0;
+        const BYTE* pBonePalettes = PullRemixApiBonePalettes(rpcHeader, ringPos, ringSize);
+        const uint32_t count = DeviceBridge::get_data();
+        // The pulled instances own their extensions, so they have to stay put until Remix is done with them
+        auto insts = std::make_unique<RemixApiInstance[]>(count);
+        std::vector<remixapi_InstanceInfo> instInfos;
+        instInfos.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+          PullRemixApiInstance(insts[i], pBonePalettes);
+          instInfos.push_back(insts[i].info);
+        }
+
+        if (remixapi::g_remix.DrawInstances) {
+          if (remixapi::g_remix.DrawInstances(instInfos.data(), count) != REMIXAPI_ERROR_CODE_SUCCESS) {
+            Logger::err("[RemixApi_DrawInstances] Remix API call failed!");
+          }
+        } else {
+          // Runtime predates the batched entry point
+          for (const remixapi_InstanceInfo& instInfo : instInfos) {
+            if (remixapi::g_remix.DrawInstance(&instInfo) != REMIXAPI_ERROR_CODE_SUCCESS) {
+              Logger::err("[RemixApi_DrawInstances] Remix API call failed!");
             }
           }
-          bInstExtExists = remixapi::pullBool();
         }
-
-        if(remixapi::g_remix.DrawInstance(&instInfo) != REMIXAPI_ERROR_CODE_SUCCESS) {
-          Logger::err("[RemixApi_DrawInstance] Remix API call failed!");
+        if (pBonePalettes) {
+          VertexRing::release(ringPos, ringSize);
         }
 
         break;
       }
 
-      case RemixApi_CreateLight:
+      case RemixApi_CreateInstance:
       {
-        // Rather than allocate deserialized struct extensions on the heap,
-        // allocate them locally, since we know only one instance will be
-        // supported at a time
-        struct LightExtensions {
-          serialize::LightInfoSphere sphere;
-          serialize::LightInfoRect rect;
-          serialize::LightInfoDisk disk;
-          serialize::LightInfoCylinder cylinder;
-          serialize::LightInfoDistant distant;
-          serialize::LightInfoDome dome;
-          serialize::LightInfoUSD usd;
-        } exts;
-        memset(&exts, 0, sizeof(LightExtensions));
+        uint32_t ringPos = 0, ringSize = 0;
+        const BYTE* pBonePalettes = PullRemixApiBonePalettes(rpcHeader, ringPos, ringSize);
+        RemixApiInstance inst;
+        PullRemixApiInstance(inst, pBonePalettes);
 
-        const auto lightSType = remixapi::pullSType();
-        assert(lightSType == REMIXAPI_STRUCT_TYPE_LIGHT_INFO);
-        serialize::LightInfo lightInfo;
-        deserializeFromQueue(lightInfo);
-        lightInfo.pNext = nullptr;
+        auto bridgeHandle = DeviceBridge::get_data();
+        remixapi_InstanceHandle remixApiHandle = nullptr;
+        if(remixapi::g_remix.CreateInstance &&
+           remixapi::g_remix.CreateInstance(&inst.info, &remixApiHandle) == REMIXAPI_ERROR_CODE_SUCCESS) {
+          InstanceHandle handle(bridgeHandle, remixApiHandle);
+        } else {
+          Logger::err("[RemixApi_CreateInstance] Remix API call failed!");
+        }
+        if (pBonePalettes) {
+          VertexRing::release(ringPos, ringSize);
+        }
 
-        bool bLightExtExists = remixapi::pullBool();
-        auto* pInfoProto = &getInfoProto(lightInfo);
-        while(bLightExtExists) {
-          const auto extSType = remixapi::pullSType();
-          switch (extSType) {
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_SPHERE_EXT:
-            {
-              assert(!exts.sphere.pNext);
-              deserializeFromQueue(exts.sphere);
-              pInfoProto->pNext = &(exts.sphere);
-              pInfoProto = &getInfoProto(exts.sphere);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_RECT_EXT:
-            {
-              assert(!exts.rect.pNext);
-              deserializeFromQueue(exts.rect);
-              pInfoProto->pNext = &(exts.rect);
-              pInfoProto = &getInfoProto(exts.rect);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISK_EXT:
-            {
-              assert(!exts.disk.pNext);
-              deserializeFromQueue(exts.disk);
-              pInfoProto->pNext = &(exts.disk);
-              pInfoProto = &getInfoProto(exts.disk);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_CYLINDER_EXT:
-            {
-              assert(!exts.cylinder.pNext);
-              deserializeFromQueue(exts.cylinder);
-              pInfoProto->pNext = &(exts.cylinder);
-              pInfoProto = &getInfoProto(exts.cylinder);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DISTANT_EXT:
-            {
-              assert(!exts.distant.pNext);
-              deserializeFromQueue(exts.distant);
-              pInfoProto->pNext = &(exts.distant);
-              pInfoProto = &getInfoProto(exts.distant);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_DOME_EXT:
-            {
-              assert(!exts.dome.pNext);
-              deserializeFromQueue(exts.dome);
-              pInfoProto->pNext = &(exts.dome);
-              pInfoProto = &getInfoProto(exts.dome);
-              break;
-            }
-            case REMIXAPI_STRUCT_TYPE_LIGHT_INFO_USD_EXT:
-            {
-              assert(!exts.usd.pNext);
-              deserializeFromQueue(exts.usd);
-              pInfoProto->pNext = &(exts.usd);
-              pInfoProto = &getInfoProto(exts.usd);
-              break;
-            }
-            default:
-            {
-              Logger::warn("[RemixApi_CreateLight] Unknown sType. Skipping.");
-              break;
-            }
+        break;
+      }
+
+      case RemixApi_UpdateInstanceTransform:
+      {
+        InstanceHandle handle(DeviceBridge::get_data());
+        remixapi_Transform* pTransform = nullptr;
+        const auto size = DeviceBridge::get_data((void**) &pTransform);
+        assert(size == sizeof(remixapi_Transform));
+        if(handle.isValid()) {
+          remixapi::g_remix.UpdateInstanceTransform(handle, pTransform);
+        } else {
+          Logger::err("[RemixApi_UpdateInstanceTransform] Invalid instance handle!" );
+        }
+        break;
+      }
+
+      case RemixApi_UpdateInstanceMaterial:
+      {
+        InstanceHandle handle(DeviceBridge::get_data());
+        const uint32_t materialUid = DeviceBridge::get_data();
+        remixapi_MaterialHandle material = nullptr;
+        if(materialUid != 0) {
+          MaterialHandle matHandle(materialUid);
+          if(matHandle.isValid()) {
+            material = matHandle;
+          } else {
+            Logger::err("[RemixApi_UpdateInstanceMaterial] Invalid material handle!" );
           }
-          bLightExtExists = remixapi::pullBool();
         }
+        if(handle.isValid()) {
+          remixapi::g_remix.UpdateInstanceMaterial(handle, material);
+        } else {
+          Logger::err("[RemixApi_UpdateInstanceMaterial] Invalid instance handle!" );
+        }
+        break;
+      }
+
+      case RemixApi_DestroyInstance:
+      {
+        InstanceHandle handle(DeviceBridge::get_data());
+        if(handle.isValid()) {
+          remixapi::g_remix.DestroyInstance(handle);
+          handle.invalidate();
+        } else {
+          Logger::err("[RemixApi_DestroyInstance] Invalid instance handle!" );
+        }
+        break;
+      }
+
+      case RemixApi_CreateLight:
+      {
+        RemixApiLight light;
+        PullRemixApiLight(light);
+        const serialize::LightInfo& lightInfo = light.info;
 
         auto bridgeHandle = DeviceBridge::get_data();
         remixapi_LightHandle lightHandle = nullptr;
@@ -3115,6 +3683,42 @@ void ProcessDeviceCommandQueue() {
         break;
       }
 
+      case RemixApi_UpdateLights:
+      {
+        const uint32_t count = DeviceBridge::get_data();
+        // The pulled lights own their extensions, so they have to stay put until Remix is done with them
+        auto lights = std::make_unique<RemixApiLight[]>(count);
+        std::vector<remixapi_LightHandle> lightHandles;
+        std::vector<remixapi_LightInfo> lightInfos;
+        lightHandles.reserve(count);
+        lightInfos.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+          LightHandle handle(DeviceBridge::get_data());
+          PullRemixApiLight(lights[i]);
+          if(!handle.isValid()) {
+            Logger::err("[RemixApi_UpdateLights] Invalid light handle!" );
+            continue;
+          }
+          lightHandles.push_back(handle);
+          lightInfos.push_back(lights[i].info);
+        }
+
+        if (remixapi::g_remix.UpdateLights) {
+          if (remixapi::g_remix.UpdateLights(lightHandles.data(), lightInfos.data(), (uint32_t) lightInfos.size()) != REMIXAPI_ERROR_CODE_SUCCESS) {
+            Logger::err("[RemixApi_UpdateLights] Remix API call failed!");
+          }
+        } else {
+          // Runtime predates the batched entry point, CreateLight overwrites a light with the same hash
+          for (const remixapi_LightInfo& lightInfo : lightInfos) {
+            remixapi_LightHandle lightHandle = nullptr;
+            if (remixapi::g_remix.CreateLight(&lightInfo, &lightHandle) != REMIXAPI_ERROR_CODE_SUCCESS) {
+              Logger::err("[RemixApi_UpdateLights] Remix API call failed!");
+            }
+          }
+        }
+        break;
+      }
+
       case RemixApi_DrawLightInstance:
       {
         LightHandle handle(DeviceBridge::get_data());
@@ -3129,11 +3733,11 @@ void ProcessDeviceCommandQueue() {
       case RemixApi_SetConfigVariable:
       {
         void* var_ptr = nullptr;
-        const uint32_t var_size = DeviceBridge::getReaderChannel().data->pull(&var_ptr);
+        const uint32_t var_size = DeviceBridge::get_data(&var_ptr);
         std::string var_str((const char*) var_ptr, var_size);
 
         void* value_ptr = nullptr;
-        const uint32_t value_size = DeviceBridge::getReaderChannel().data->pull(&value_ptr);
+        const uint32_t value_size = DeviceBridge::get_data(&value_ptr);
         std::string value_str((const char*) value_ptr, value_size);
 
         remixapi::g_remix.SetConfigVariable(var_str.c_str(), value_str.c_str());
@@ -3164,6 +3768,9 @@ void ProcessDeviceCommandQueue() {
       Logger::warn("Data not in sync");
     }
     assert(CHECK_DATA_OFFSET);
+    if (CommandTrace::isActive()) {
+      CommandTrace::commandProcessed(CommandTrace::Channel::Device, DeviceBridge::getReaderChannel(), rpcHeader, commandStart);
+    }
     *DeviceBridge::getReaderChannel().serverDataPos = DeviceBridge::get_data_pos();
     // Check if overwrite condition was met
     if (*DeviceBridge::getReaderChannel().clientDataExpectedPos != -1) {
@@ -3196,6 +3803,9 @@ void ProcessDeviceCommandQueue() {
 #endif
   }
 
+  // Make sure all pipelined commands are executed before device objects are torn down
+  pPipeline.reset();
+
   // Check if we exited the command processing loop unexpectedly while the bridge is still enabled
   if (!done && gbBridgeRunning) {
     Logger::debug("The device command processing loop was exited unexpectedly, either due to timing out or some other command queue issue.");
@@ -3304,6 +3914,10 @@ bool InitializeD3D() {
                                 version::fileSysV, dxvkVersions[version::FileSys]));
       bMismatchDetected = true;
     }
+    // Optional, older DXVK builds simply do not receive the client frame times
+    if(version::bridgeFrameTimesV == dxvkVersions[version::BridgeFrameTimes]) {
+      gpSetBridgeFrameTimes = (version::SetBridgeFrameTimesFunc)GetProcAddress(ghModule, version::SetBridgeFrameTimesFuncName);
+    }
     if(bMismatchDetected) {
       Logger::warn("One or more functional version mismatches detected. If you experience problems, consider updating either bridge or dxvk.");
     } else {
@@ -3385,6 +3999,53 @@ static bool RegisterMessageChannel() {
   return true;
 }
 
+// Runs the server on a captured command trace instead of a connected client
+static int ReplayCommandTrace(const std::string& path) {
+  if (!CommandTrace::loadReplay(path)) {
+    return 1;
+  }
+
+  initModuleBridge();
+  initDeviceBridge();
+
+  gpPresent = new NamedSemaphore("Present", GlobalOptions::getPresentSemaphoreMaxFrames(), GlobalOptions::getPresentSemaphoreMaxFrames());
+
+  Logger::info("Initializing D3D9...");
+  if (!InitializeD3D()) {
+    return 1;
+  }
+
+  // Skip the data that was consumed before the processing loops started during capture
+  for (size_t i = 0; i < CommandTrace::getReplayStartDataPos(CommandTrace::Channel::Device); ++i) {
+    DeviceBridge::get_data();
+  }
+  for (size_t i = 0; i < CommandTrace::getReplayStartDataPos(CommandTrace::Channel::Module); ++i) {
+    ModuleBridge::get_data();
+  }
+
+  if (!CommandTrace::startReplay()) {
+    return 1;
+  }
+  Logger::info("Replaying command trace " + path + "...");
+
+  std::atomic<bool> bSignalDone(false);
+  auto moduleCmdProcessingThread = std::thread([&]() {
+    processModuleCommandQueue(&bSignalDone);
+  });
+  ProcessDeviceCommandQueue();
+  bSignalDone.store(true);
+  moduleCmdProcessingThread.join();
+
+  CommandTrace::finishReplay();
+  CommandTrace::shutdown();
+
+  if (!dumpLeakedObjects()) {
+    bridge_util::Logger::debug("No leaked objects dicovered at Direct3D module eviction.");
+  }
+  ghModule = nullptr;
+  return 0;
+}
+
 static inline bool initFileSys() {
   auto parentPid = bridge_util::getParentPid();
   DWORD accessRights = PROCESS_QUERY_INFORMATION | PROCESS_VM_READ;
@@ -3426,6 +4087,11 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
   Logger::warn("Running in x86 mode! Are you sure this is what you want? RTX will not work this way, please run the 64-bit server instead!");
 #endif
 
+  const std::string& replayCommandTrace = ServerOptions::getReplayCommandTrace();
+  if (!replayCommandTrace.empty()) {
+    return ReplayCommandTrace(replayCommandTrace);
+  }
+
   int argCount;
   LPWSTR* argList = CommandLineToArgvW(pCmdLine, &argCount);
   BRIDGE_ASSERT_LOG((argCount >= 2), "Command line argument count received to launch server is not as expected");
@@ -3447,6 +4113,12 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
   if (GlobalOptions::getUseSharedHeap()) {
     SharedHeap::init();
   }
+  if (GlobalOptions::getUseVertexRing()) {
+    VertexRing::init();
+  }
+  if (GlobalOptions::getUseAsyncOcclusionQueries()) {
+    OcclusionQueryResults::init();
+  }
 
   gpPresent = new NamedSemaphore("Present", GlobalOptions::getPresentSemaphoreMaxFrames(), GlobalOptions::getPresentSemaphoreMaxFrames());
 
@@ -3509,6 +4181,11 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
   // (5) Ready to listen for incoming commands
   Logger::info("Handshake completed! Now waiting for incoming commands...");
 
+  const std::string& captureCommandTrace = ServerOptions::getCaptureCommandTrace();
+  if (!captureCommandTrace.empty()) {
+    CommandTrace::beginCapture(captureCommandTrace);
+  }
+
   std::atomic<bool> bSignalDone(false);
   auto moduleCmdProcessingThread = std::thread([&]() {
     processModuleCommandQueue(&bSignalDone);
@@ -3518,6 +4195,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
   bSignalDone.store(true);
   moduleCmdProcessingThread.join();
 
+  CommandTrace::shutdown();
+
   if (!dumpLeakedObjects()) {
     bridge_util::Logger::debug("No leaked objects dicovered at Direct3D module eviction.");
   }
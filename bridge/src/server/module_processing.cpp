@@ -3,6 +3,7 @@
 #include <windows.h>
 
 #include "module_processing.h"
+#include "command_trace.h"
 
 #include "remix_api.h"
 
@@ -74,9 +75,14 @@ namespace {
 }
 
 void processModuleCommandQueue(std::atomic<bool>* const pbSignalEnd) {
+  CommandTrace::beginChannel(CommandTrace::Channel::Module, ModuleBridge::getReaderChannel());
   bool destroyReceived = false;
   while (RESULT_SUCCESS(ModuleBridge::waitForCommand(
     Commands::Bridge_Any, 0, pbSignalEnd))) {
+    CommandTrace::Clock::time_point commandStart;
+    if (CommandTrace::isActive()) {
+      commandStart = CommandTrace::Clock::now();
+    }
     const Header rpcHeader = ModuleBridge::pop_front();
     PULL_U(currentUID);
 #if defined(_DEBUG) || defined(DEBUGOPT)
@@ -335,6 +341,9 @@ void processModuleCommandQueue(std::atomic<bool>* const pbSignalEnd) {
         break;
       }
     }
+    if (CommandTrace::isActive()) {
+      CommandTrace::commandProcessed(CommandTrace::Channel::Module, ModuleBridge::getReaderChannel(), rpcHeader, commandStart);
+    }
   }
   // Check if we exited the command processing loop unexpectedly while the bridge is still enabled
   if (!destroyReceived && gbBridgeRunning) {
@@ -48,4 +48,33 @@ namespace ServerOptions {
       bridge_util::Config::getOption<uint32_t>("server.shutdownRetries", 50);
     return shutdownRetries;
   }
+
+  // Splits device command processing into a decode and an execute stage running
+  // on separate threads, see command_pipeline.h. Has no effect when
+  // sendAllServerResponses is enabled.
+  inline bool getUseCommandPipeline() {
+    static const bool useCommandPipeline =
+      bridge_util::Config::getOption<bool>("server.useCommandPipeline", false);
+    return useCommandPipeline;
+  }
+  inline uint32_t getCommandPipelineSize() {
+    static const uint32_t commandPipelineSize =
+      bridge_util::Config::getOption<uint32_t>("server.commandPipelineSize", 4096);
+    return commandPipelineSize < 16 ? 16 : commandPipelineSize;
+  }
+
+  // Path of a file the command and data queue traffic received from the client is
+  // captured to, see command_trace.h. Capturing is disabled when empty.
+  inline const std::string& getCaptureCommandTrace() {
+    static const std::string captureCommandTrace =
+      bridge_util::Config::getOption<std::string>("server.captureCommandTrace", "");
+    return captureCommandTrace;
+  }
+  // Path of a captured command trace to replay. When set the server does not wait
+  // for a client, but replays the trace and exits once it has been processed.
+  inline const std::string& getReplayCommandTrace() {
+    static const std::string replayCommandTrace =
+      bridge_util::Config::getOption<std::string>("server.replayCommandTrace", "");
+    return replayCommandTrace;
+  }
 }
\ No newline at end of file
@@ -50,11 +50,18 @@ void GlobalOptions::initSharedHeapPolicy() {
       }
     }
 
+    // Zero-copy buffer transport: every vertex and index buffer is backed by shared heap
+    // chunks regardless of the lock mode or the individual buffer policies above.
+    sharedHeapForAllBuffers = bridge_util::Config::getOption<bool>("sharedHeapForAllBuffers", false);
+    if (sharedHeapForAllBuffers) {
+      sharedHeapPolicy |= SharedHeapPolicy::BuffersOnly;
+    }
+
     const bool bPolicyTextures = sharedHeapPolicy & SharedHeapPolicy::Textures;
           bool bPolicyDynamicBufs = sharedHeapPolicy & SharedHeapPolicy::DynamicBuffers;
     const bool bPolicyStaticBufs = sharedHeapPolicy & SharedHeapPolicy::StaticBuffers;
     
-    if(bridge_util::Config::isOptionDefined("useShadowMemoryForDynamicBuffers")) {
+    if(!sharedHeapForAllBuffers && bridge_util::Config::isOptionDefined("useShadowMemoryForDynamicBuffers")) {
       const bool bUseShadowMemoryForDynamicBuffers =
         bridge_util::Config::getOption<bool>("useShadowMemoryForDynamicBuffers");
       if(bUseShadowMemoryForDynamicBuffers == bPolicyDynamicBufs) {
@@ -86,5 +93,6 @@ void GlobalOptions::initSharedHeapPolicy() {
     bridge_util::Logger::info(policySS.str());
   } else {
     sharedHeapPolicy = SharedHeapPolicy::None;
+    sharedHeapForAllBuffers = false;
   }
 }
\ No newline at end of file
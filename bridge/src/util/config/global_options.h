@@ -23,6 +23,7 @@
 
 #include "config/config.h"
 #include "log/log.h"
+#include "util_adaptivewait.h"
 #include "util_bridgecommand.h"
 
 #include <d3d9.h>
@@ -103,7 +104,11 @@ public:
   }
 
   static bool getSendCreateFunctionServerResponses() {
-    return get().sendCreateFunctionServerResponses;
+    return get().sendCreateFunctionServerResponses && !get().asyncResourceCreation;
+  }
+
+  static bool getAsyncResourceCreation() {
+    return get().asyncResourceCreation && !get().sendAllServerResponses;
   }
 
   static bool getLogAllCalls() {
@@ -204,6 +209,10 @@ public:
     return (get().sharedHeapPolicy & SharedHeapPolicy::StaticBuffers) != 0;
   }
 
+  static bool getUseSharedHeapForAllBuffers() {
+    return get().sharedHeapForAllBuffers;
+  }
+
   static const uint32_t getSharedHeapDefaultSegmentSize() {
     return get().sharedHeapDefaultSegmentSize;
   }
@@ -216,6 +225,14 @@ public:
     return get().sharedHeapFreeChunkWaitTimeout;
   }
 
+  static bool getUseSharedHeapSizeClasses() {
+    return get().sharedHeapSizeClasses;
+  }
+
+  static uint32_t getSharedHeapCompactionInterval() {
+    return get().sharedHeapCompactionInterval;
+  }
+
   static const uint32_t getSemaphoreTimeout() {
     return get().commandTimeout;
   }
@@ -253,6 +270,42 @@ public:
     return get().eliminateRedundantSetterCalls;
   }
 
+  static bool getUseAdaptiveWait() {
+    return get().useAdaptiveWait;
+  }
+
+  static uint32_t getAdaptiveWaitSpinLimitUs() {
+    return get().adaptiveWaitSpinLimitUs;
+  }
+
+  static uint32_t getAdaptiveWaitYieldLimitUs() {
+    return get().adaptiveWaitYieldLimitUs;
+  }
+
+  static bool getCompressDataBlobs() {
+    return get().compressDataBlobs;
+  }
+
+  static uint32_t getCompressDataBlobsThreshold() {
+    return get().compressDataBlobsThreshold;
+  }
+
+  static bool getUseVertexRing() {
+    return get().useVertexRing;
+  }
+
+  static uint32_t getVertexRingSize() {
+    return get().vertexRingSize;
+  }
+
+  static bool getUseAsyncOcclusionQueries() {
+    return get().useAsyncOcclusionQueries;
+  }
+
+  static bool getWarmStartServer() {
+    return get().warmStartServer;
+  }
+
 private:
   GlobalOptions() = default;
 
@@ -318,6 +371,11 @@ private:
     // sendAllServerResponses are set to False.
     sendCreateFunctionServerResponses = bridge_util::Config::getOption<bool>("sendCreateFunctionServerResponses", true);
 
+    // Create API calls from the client do not wait for a response from the server when
+    // asyncResourceCreation is set, regardless of sendCreateFunctionServerResponses. Any
+    // failures on the server are instead reported by the client on the next Present.
+    asyncResourceCreation = bridge_util::Config::getOption<bool>("asyncResourceCreation", false);
+
     // In a Debug or DebugOptimized build of the bridge, setting LogApiCalls
     // to True will write each call to a D3D9 API function through the bridge
     // client to the the client log file("bridge32.log").
@@ -418,6 +476,13 @@ private:
     // The number of seconds to wait for a avaliable chunk to free up in the shared heap
     sharedHeapFreeChunkWaitTimeout = bridge_util::Config::getOption<uint32_t>("sharedHeapFreeChunkWaitTimeout", 10);
 
+    // Serve allocations of up to 4kB, 64kB and 1MB from slabs of same sized slots
+    sharedHeapSizeClasses = bridge_util::Config::getOption<bool>("sharedHeapSizeClasses", false);
+
+    // Interval in milliseconds at which the client returns freed chunks and empty slabs
+    // to the shared heap in the background, 0 disables background compaction
+    sharedHeapCompactionInterval = bridge_util::Config::getOption<uint32_t>("sharedHeapCompactionInterval", 0);
+
     // Thread-safety policy: 0 - use client's choice, 1 - force thread-safe, 2 - force non-thread-safe
     threadSafetyPolicy = bridge_util::Config::getOption<uint32_t>("threadSafetyPolicy", 0);
 
@@ -430,6 +495,38 @@ private:
     // If set, the bridge client will not send certain setter calls to the bridge server if the client knows the setter is writing
     // the the same value that is currently stored.
     eliminateRedundantSetterCalls = bridge_util::Config::getOption<bool>("eliminateRedundantSetterCalls", false);
+
+    // If set, waits on the IPC queues and semaphores measure how long recent waits took
+    // and pick between spinning, yielding and sleeping based on that, instead of always
+    // yielding. Waits expected to be shorter than the spin limit spin, waits expected
+    // to be shorter than the yield limit yield, and longer waits sleep.
+    useAdaptiveWait = bridge_util::Config::getOption<bool>("useAdaptiveWait", false);
+    adaptiveWaitSpinLimitUs = bridge_util::Config::getOption<uint32_t>("adaptiveWaitSpinLimitUs", 50);
+    adaptiveWaitYieldLimitUs = bridge_util::Config::getOption<uint32_t>("adaptiveWaitYieldLimitUs", 2'000);
+
+    auto& adaptiveWaitSettings = bridge_util::AdaptiveWait::settings();
+    adaptiveWaitSettings.enabled = useAdaptiveWait;
+    adaptiveWaitSettings.spinLimitUs = adaptiveWaitSpinLimitUs;
+    adaptiveWaitSettings.yieldLimitUs = adaptiveWaitYieldLimitUs;
+
+    // If set, the client LZ4 compresses data queue blobs of at least the threshold size in
+    // bytes, e.g. UP draw vertices, texture contents and shader bytecode, and the server
+    // decompresses them when reading. Trades CPU time for shared memory bandwidth.
+    compressDataBlobs = bridge_util::Config::getOption<bool>("compressDataBlobs", false);
+    compressDataBlobsThreshold = bridge_util::Config::getOption<uint32_t>("compressDataBlobsThreshold", 16 << 10);
+
+    // If set, DrawPrimitiveUP and DrawIndexedPrimitiveUP data is written to a persistent shared
+    // memory ring of the given size, and the draw commands only carry its position in the ring.
+    useVertexRing = bridge_util::Config::getOption<bool>("useVertexRing", false);
+    vertexRingSize = bridge_util::Config::getOption<uint32_t>("vertexRingSize", 16 << 20);
+
+    // If set, the server publishes occlusion query results through shared memory and the client
+    // answers IDirect3DQuery9::GetData for occlusion queries from there, without a server round trip.
+    useAsyncOcclusionQueries = bridge_util::Config::getOption<bool>("useAsyncOcclusionQueries", false);
+
+    // If set, the client launches the server and completes the handshake as soon as it is attached
+    // to the game process, rather than when the game first creates its D3D9 object.
+    warmStartServer = bridge_util::Config::getOption<bool>("warmStartServer", false);
   }
 
   void initSharedHeapPolicy();
@@ -456,6 +553,7 @@ private:
   bool sendReadOnlyCalls;
   bool sendAllServerResponses;
   bool sendCreateFunctionServerResponses;
+  bool asyncResourceCreation;
   bool logAllCalls;
   bool logApiCalls;
   bool logAllCommands;
@@ -474,12 +572,24 @@ private:
   bool disableTimeouts;
   bool useSharedHeap;
   uint32_t sharedHeapPolicy;
+  bool sharedHeapForAllBuffers;
   uint32_t sharedHeapSize;
   uint32_t sharedHeapDefaultSegmentSize;
   uint32_t sharedHeapChunkSize;
   uint32_t sharedHeapFreeChunkWaitTimeout;
+  bool sharedHeapSizeClasses;
+  uint32_t sharedHeapCompactionInterval;
   uint32_t threadSafetyPolicy;
   bool alwaysCopyEntireStaticBuffer;
   bool exposeRemixApi;
   bool eliminateRedundantSetterCalls;
+  bool useAdaptiveWait;
+  uint32_t adaptiveWaitSpinLimitUs;
+  uint32_t adaptiveWaitYieldLimitUs;
+  bool compressDataBlobs;
+  uint32_t compressDataBlobsThreshold;
+  bool useVertexRing;
+  uint32_t vertexRingSize;
+  bool useAsyncOcclusionQueries;
+  bool warmStartServer;
 };
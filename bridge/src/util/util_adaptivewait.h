@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "../tracy/tracy.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace bridge_util {
+
+  // Adaptive wait policy for the IPC queues and semaphores. Every waiter keeps a
+  // moving average of how long its recent waits took, and each wait goes through a
+  // spin, a yield and a sleep phase whose lengths are picked from that average.
+  // Short producer/consumer gaps are caught while spinning, long gaps such as the
+  // client waiting for the next frame end up sleeping instead of keeping a core busy.
+  class AdaptiveWait {
+  public:
+    struct Settings {
+      bool enabled = false;
+      uint32_t spinLimitUs = 50;
+      uint32_t yieldLimitUs = 2000;
+    };
+
+    // Filled in from GlobalOptions on startup
+    static Settings& settings() {
+      static Settings s;
+      return s;
+    }
+
+    static bool isEnabled() {
+      return settings().enabled;
+    }
+
+    explicit AdaptiveWait(const std::string& name)
+      : m_plotName(name + " wait (us)") {
+    }
+
+    AdaptiveWait(const AdaptiveWait&) = delete;
+
+    // Tracks a single wait, only valid while adaptive waits are enabled
+    class Scope {
+    public:
+      explicit Scope(AdaptiveWait& waiter)
+        : m_waiter(waiter)
+        , m_start(nowUs()) {
+        const Settings& s = settings();
+        const uint32_t avgGapUs = waiter.m_avgGapUs.load(std::memory_order_relaxed);
+        if (avgGapUs <= s.spinLimitUs) {
+          m_spinUntilUs = 2 * s.spinLimitUs;
+          m_yieldUntilUs = s.yieldLimitUs;
+        } else if (avgGapUs <= s.yieldLimitUs) {
+          m_spinUntilUs = s.spinLimitUs / 8;
+          m_yieldUntilUs = 2 * s.yieldLimitUs;
+        } else {
+          m_spinUntilUs = s.spinLimitUs / 8;
+          m_yieldUntilUs = s.spinLimitUs;
+        }
+      }
+
+      ~Scope() {
+        m_waiter.record(static_cast<uint32_t>(elapsedUs()));
+      }
+
+      // True while the wait has not reached its sleep phase
+      bool isPolling() const {
+        return elapsedUs() < m_yieldUntilUs;
+      }
+
+      // Called after every unsuccessful poll
+      void pause() {
+        const int64_t elapsed = elapsedUs();
+        if (elapsed < m_spinUntilUs) {
+          for (uint32_t i = 0; i < kSpinPauses; i++) {
+            YieldProcessor();
+          }
+        } else if (elapsed < m_yieldUntilUs) {
+          std::this_thread::yield();
+        } else {
+          Sleep(1);
+        }
+      }
+
+      int64_t elapsedUs() const {
+        return nowUs() - m_start;
+      }
+
+    private:
+      static constexpr uint32_t kSpinPauses = 32;
+
+      AdaptiveWait& m_waiter;
+      const int64_t m_start;
+      int64_t m_spinUntilUs;
+      int64_t m_yieldUntilUs;
+    };
+
+  private:
+    void record(const uint32_t gapUs) {
+      // Exponential moving average over roughly the last 8 waits
+      const uint32_t avgGapUs = m_avgGapUs.load(std::memory_order_relaxed);
+      const uint32_t newAvgGapUs = static_cast<uint32_t>((7ull * avgGapUs + gapUs) / 8);
+      m_avgGapUs.store(newAvgGapUs, std::memory_order_relaxed);
+      TracyPlot(m_plotName.c_str(), static_cast<int64_t>(newAvgGapUs));
+    }
+
+    static int64_t nowUs() {
+      static const int64_t frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart;
+      }();
+      LARGE_INTEGER counter;
+      QueryPerformanceCounter(&counter);
+      return counter.QuadPart * 1'000'000 / frequency;
+    }
+
+    const std::string m_plotName;
+    std::atomic<uint32_t> m_avgGapUs = 0;
+  };
+
+}
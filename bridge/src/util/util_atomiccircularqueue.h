@@ -21,6 +21,7 @@
  */
 #pragma once
 
+#include "util_adaptivewait.h"
 #include "util_common.h"
 
 #include "../tracy/tracy.hpp"
@@ -28,6 +29,7 @@
 #include <cstdio>
 #include <atomic>
 #include <assert.h>
+#include <optional>
 #include <vector>
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -47,6 +49,8 @@ namespace bridge_util {
 
     const size_t m_queueSize;
 
+    mutable AdaptiveWait m_waiter;
+
     static const size_t kAlignment = 128;
     static const size_t kWriteAtomicOffset = 0;
     static const size_t kReadAtomicOffset = kAlignment + kWriteAtomicOffset;
@@ -60,6 +64,7 @@ namespace bridge_util {
     AtomicCircularQueue(const std::string& name, void* pMemory, const size_t memSize, const size_t queueSize)
       : m_queueSize(queueSize)
       , m_data(nullptr) // INIT
+      , m_waiter(name)
     {
       // Ensure we have enough memory
       assert(memSize > kMemoryPoolOffset);
@@ -86,6 +91,7 @@ namespace bridge_util {
 
     // Push object to queue
     Result push(const T& obj) {
+      std::optional<AdaptiveWait::Scope> adaptiveWait;
       ULONGLONG start = 0, curTick;
       const DWORD timeoutMS = GlobalOptions::getCommandTimeout();
       do {
@@ -100,7 +106,7 @@ namespace bridge_util {
           return Result::Success;
         }
 
-        std::this_thread::yield();
+        pause(adaptiveWait);
 
         curTick = GetTickCount64();
         start = start > 0 ? start : curTick;
@@ -117,6 +123,7 @@ namespace bridge_util {
     // Returns a ref to the first element in the queue
     // Note: Blocks if the queue is empty
     const T& peek(Result& result, const DWORD timeoutMS = 0, std::atomic<bool>* const pbEarlyOutSignal = nullptr) const {
+      std::optional<AdaptiveWait::Scope> adaptiveWait;
       ULONGLONG start = 0, curTick;
       do {
         const auto currentWrite = m_write->load(std::memory_order_relaxed);
@@ -127,7 +134,7 @@ namespace bridge_util {
           return m_data[currentWrite];
         }
 
-        std::this_thread::yield();
+        pause(adaptiveWait);
 
         curTick = GetTickCount64();
         start = start > 0 ? start : curTick;
@@ -146,6 +153,7 @@ namespace bridge_util {
     // Returns a copy to the first element in queue, AND removes it
     // Note: Blocks if queue is empty
     const T& pull(Result& result, const DWORD timeoutMS = 0, std::atomic<bool>* const pbEarlyOutSignal = nullptr) {
+      std::optional<AdaptiveWait::Scope> adaptiveWait;
       ULONGLONG start = 0, curTick;
       do {
         const auto currentWrite = m_write->load(std::memory_order_relaxed);
@@ -157,7 +165,7 @@ namespace bridge_util {
           return m_data[currentWrite];
         }
 
-        std::this_thread::yield();
+        pause(adaptiveWait);
 
         curTick = GetTickCount64();
         start = start > 0 ? start : curTick;
@@ -212,6 +220,20 @@ namespace bridge_util {
     uint32_t queueIdxDec(uint32_t idx) const {
       return idx == 0 ?  m_queueSize - 1 : idx - 1 ;
     }
+
+  private:
+    // Backs off after an unsuccessful poll of the queue. The adaptive wait scope is
+    // only started once the first poll fails, so only actual waits are measured.
+    void pause(std::optional<AdaptiveWait::Scope>& adaptiveWait) const {
+      if (!AdaptiveWait::isEnabled()) {
+        std::this_thread::yield();
+        return;
+      }
+      if (!adaptiveWait.has_value()) {
+        adaptiveWait.emplace(m_waiter);
+      }
+      adaptiveWait->pause();
+    }
   };
 
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "util_blobcompression.h"
+
+// The vendored LZ4 is only compiled into the Tracy client when profiling is enabled
+#ifdef TRACY_ENABLE
+#include "../tracy/common/tracy_lz4.hpp"
+#else
+#include "../tracy/common/tracy_lz4.cpp"
+#endif
+
+#include <memory>
+#include <vector>
+
+namespace bridge_util {
+  namespace {
+    struct ScratchBuffer {
+      std::unique_ptr<char[]> data;
+      size_t size = 0;
+
+      char* reserve(const size_t requiredSize) {
+        if (size < requiredSize) {
+          data = std::make_unique<char[]>(requiredSize);
+          size = requiredSize;
+        }
+        return data.get();
+      }
+    };
+
+    thread_local ScratchBuffer tlsCompressBuffer;
+    // Decompressed blobs of the command currently being processed
+    thread_local std::vector<ScratchBuffer> tlsDecompressBuffers;
+    thread_local size_t tlsNumDecompressBuffersUsed = 0;
+  }
+
+  uint32_t BlobCompression::compress(const void* pSrc, const uint32_t size, const void*& pCompressed) {
+    const int bound = tracy::LZ4_compressBound((int) size);
+    if (size < kMinSize || bound <= 0) {
+      return 0;
+    }
+    char* const pDst = tlsCompressBuffer.reserve(bound);
+    const int compressedSize = tracy::LZ4_compress_default((const char*) pSrc, pDst, (int) size, bound);
+    // Require at least 1/8 to be saved, otherwise decoding costs more than the bandwidth saved
+    if (compressedSize <= 0 || (uint32_t) compressedSize > size - size / 8) {
+      return 0;
+    }
+    pCompressed = pDst;
+    return (uint32_t) compressedSize;
+  }
+
+  void* BlobCompression::decompress(const void* pSrc, const uint32_t compressedSize, const uint32_t size) {
+    if (tlsNumDecompressBuffersUsed == tlsDecompressBuffers.size()) {
+      tlsDecompressBuffers.emplace_back();
+    }
+    char* const pDst = tlsDecompressBuffers[tlsNumDecompressBuffersUsed].reserve(size);
+    const int decompressedSize = tracy::LZ4_decompress_safe((const char*) pSrc, pDst, (int) compressedSize, (int) size);
+    if (decompressedSize != (int) size) {
+      return nullptr;
+    }
+    ++tlsNumDecompressBuffersUsed;
+    return pDst;
+  }
+
+  void BlobCompression::releaseScratch() {
+    tlsNumDecompressBuffersUsed = 0;
+  }
+}
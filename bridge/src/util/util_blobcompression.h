@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace bridge_util {
+
+  // LZ4 framing for large data queue blobs. A compressed blob is sent as a marker
+  // word holding the uncompressed size with kCompressedFlag set, followed by a
+  // regular blob with the compressed bytes. Blob sizes never come close to 2GB,
+  // so the marker cannot be mistaken for the size word of a regular blob.
+  class BlobCompression {
+  public:
+    static constexpr uint32_t kCompressedFlag = 1u << 31;
+    // Smaller blobs are never compressed, which keeps fixed size structs raw
+    static constexpr uint32_t kMinSize = 1 << 10;
+
+    static bool isMarker(const uint32_t word) {
+      return (word & kCompressedFlag) != 0;
+    }
+
+    static uint32_t getMarker(const uint32_t size) {
+      return size | kCompressedFlag;
+    }
+
+    static uint32_t getSize(const uint32_t marker) {
+      return marker & ~kCompressedFlag;
+    }
+
+    // Compresses the blob into a per thread scratch buffer. Returns the compressed
+    // size, or 0 if compression did not save enough to be worth decoding.
+    static uint32_t compress(const void* pSrc, const uint32_t size, const void*& pCompressed);
+
+    // Decompresses a blob into per thread scratch memory that stays valid until
+    // releaseScratch() is called on the same thread. Returns nullptr on failure.
+    static void* decompress(const void* pSrc, const uint32_t compressedSize, const uint32_t size);
+
+    // Called before every command is processed
+    static void releaseScratch();
+  };
+}
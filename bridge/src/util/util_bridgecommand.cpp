@@ -120,6 +120,10 @@ DECL_BRIDGE_FUNC(Header, pop_front) {
   Result result;
   // No retries, but wait the same amount of time
   const auto response = getReaderChannel().commands->pull(result, get_default_timeout());
+#ifdef REMIX_BRIDGE_SERVER
+  // Blobs decompressed for the previous command are no longer referenced
+  BlobCompression::releaseScratch();
+#endif
   if (RESULT_FAILURE(result)) {
     // For now just log when things go wrong, but could use some robustness improvements
     Logger::err("CommandQueue get_response: Failed to retrieve the command response!");
@@ -265,20 +269,53 @@ DECL_COMMAND_FUNC(,Command,const Commands::D3D9Command command,
   // this issue I recommend enclosing the Command object in its own scope block, and make
   // sure there is no command nesting happening either.
 
+#ifdef REMIX_BRIDGE_CLIENT
+  // Commands that may wait for a response must go out in order right away
+  const bool bRecordable = (s_bCommandRecordingEnabled && CommandRecorder::isRecordable(command)) ||
+                           (s_bRemixApiRecordingEnabled && CommandRecorder::isRemixApiRecordable(command));
+  if (bRecordable && !GlobalOptions::getSendAllServerResponses()) {
+    m_pRecorder = &CommandRecorder::local();
+    m_pRecorder->begin(command, m_handle, commandFlags);
+    return;
+  }
+  s_pWriterChannel->m_mutex.lock();
+  if (CommandRecorder::hasPending()) {
+    // Sync point: everything recorded so far by any thread must precede this command
+    flushRecordedCommands_NoLock();
+  }
+#endif
+
+  beginCommand(command, m_handle);
+}
+
+DECL_COMMAND_FUNC(,~Command) {
+#ifdef REMIX_BRIDGE_CLIENT
+  if (m_pRecorder) {
+    if (m_pRecorder->end()) {
+      flushRecordedCommands();
+    }
+    return;
+  }
+#endif
+
+  endCommand(m_command, m_handle, m_commandFlags);
+
+#ifdef REMIX_BRIDGE_CLIENT
+  s_pWriterChannel->m_mutex.unlock();
+#endif
+}
+
+DECL_COMMAND_FUNC(void, beginCommand, const Commands::D3D9Command command, const uint32_t handle) {
 #if defined(_DEBUG) || defined(DEBUGOPT)
   if (GlobalOptions::getLogAllCommands()) {
 #ifdef REMIX_BRIDGE_CLIENT
     Logger::info("Requesting: " +toString(command) + " UID: " + std::to_string(s_cmdUID));
 #else
-    Logger::info("Responding: " + toString(command) + " UID: " + std::to_string(pHandle));
+    Logger::info("Responding: " + toString(command) + " UID: " + std::to_string(handle));
 #endif
   }
 #endif
 
-#ifdef REMIX_BRIDGE_CLIENT
-  s_pWriterChannel->m_mutex.lock();
-#endif
-
   assert(!s_pWriterChannel->pbCmdInProgress->load());
   if (s_pWriterChannel->pbCmdInProgress->load()) {
     Logger::errLogMessageBoxAndExit(logger_strings::MultipleActiveCommands);
@@ -308,7 +345,8 @@ DECL_COMMAND_FUNC(,Command,const Commands::D3D9Command command,
   }
 }
 
-DECL_COMMAND_FUNC(,~Command) {
+DECL_COMMAND_FUNC(void, endCommand, const Commands::D3D9Command command, const uint32_t handle,
+                                    const Commands::Flags commandFlags) {
   // Only actually send the command if the bridge is enabled, otherwise this becomes a no-op
   if (gbBridgeRunning) {
     s_pWriterChannel->data->end_batch();
@@ -318,10 +356,10 @@ DECL_COMMAND_FUNC(,~Command) {
     // We check if the bridge is enabled for each loop iteration in case it
     // was disabled externally by the server process exit callback.
     do {
-      result = s_pWriterChannel->commands->push({ m_command, m_commandFlags, (uint32_t) s_pWriterChannel->data->get_pos(), m_handle });
+      result = s_pWriterChannel->commands->push({ command, commandFlags, (uint32_t) s_pWriterChannel->data->get_pos(), handle });
 #if defined(_DEBUG) || defined(DEBUGOPT)
       if (GlobalOptions::getLogAllCommands()) {
-        Logger::info("Pushed: " + toString(m_command));
+        Logger::info("Pushed: " + toString(command));
       }
 #endif
     } while (
@@ -334,24 +372,48 @@ DECL_COMMAND_FUNC(,~Command) {
     );
 #ifdef REMIX_BRIDGE_CLIENT
     if (BridgeState::getServerState_NoLock() >= BridgeState::ProcessState::DoneProcessing) {
-      Logger::warn(format_string("The command %s will not be sent; Server is in the process of or has already shut down. Turning bridge off.", Commands::toString(m_command).c_str()));
+      Logger::warn(format_string("The command %s will not be sent; Server is in the process of or has already shut down. Turning bridge off.", Commands::toString(command).c_str()));
       gbBridgeRunning = false;;
     } else
 #endif
       if (RESULT_FAILURE(result) && gbBridgeRunning) {
-        Logger::err(format_string("The command %s could not be successfully sent, turning bridge off and falling back to client rendering!", Commands::toString(m_command).c_str()));
+        Logger::err(format_string("The command %s could not be successfully sent, turning bridge off and falling back to client rendering!", Commands::toString(command).c_str()));
         gbBridgeRunning = false;
       } else if (RESULT_SUCCESS(result) && numRetries > 1) {
-        std::string command = Commands::toString(m_command);
-        Logger::debug(format_string("The command %s took %d retries (%d ms)!", command.c_str(), numRetries, numRetries * GlobalOptions::getCommandTimeout()));
+        std::string commandStr = Commands::toString(command);
+        Logger::debug(format_string("The command %s took %d retries (%d ms)!", commandStr.c_str(), numRetries, numRetries * GlobalOptions::getCommandTimeout()));
       }
   }
   s_pWriterChannel->pbCmdInProgress->store(false);
 #ifdef REMIX_BRIDGE_CLIENT
   ++s_cmdUID;
-  s_pWriterChannel->m_mutex.unlock();
 #endif
 }
 
+#ifdef REMIX_BRIDGE_CLIENT
+DECL_BRIDGE_FUNC(void, flushRecordedCommands) {
+  ZoneScoped;
+  std::lock_guard lock(s_pWriterChannel->m_mutex);
+  flushRecordedCommands_NoLock();
+}
+
+DECL_BRIDGE_FUNC(void, flushRecordedCommands_NoLock) {
+  CommandRecorder::drain([](const CommandRecorder::Record& record, const uint32_t* words) {
+    Command::beginCommand(record.command, record.handle);
+    if (gbBridgeRunning) {
+      CommandRecorder::forEachOp(record, words,
+        [](const DataT value) {
+          syncDataQueue(1, false);
+          s_pWriterChannel->data->push(value);
+        },
+        [](const DataT size, const void* obj) {
+          push_blob(size, obj);
+        });
+    }
+    Command::endCommand(record.command, record.handle, record.flags);
+  });
+}
+#endif
+
 template class Bridge<BridgeId::Module>;
 template class Bridge<BridgeId::Device>;
\ No newline at end of file
@@ -24,9 +24,11 @@
 #include "config/global_options.h"
 
 #include "util_common.h"
+#include "util_blobcompression.h"
 #include "util_commands.h"
 #include "util_circularbuffer.h"
 #include "util_bridge_state.h"
+#include "util_commandrecorder.h"
 #include "util_ipcchannel.h"
 #include "util_singleton.h"
 #include "../tracy/tracy.hpp"
@@ -140,6 +142,11 @@ public:
   static inline const DataT& get_data(void** obj) {
     ZoneScoped;
     size_t prevPos = get_data_pos();
+#ifdef REMIX_BRIDGE_SERVER
+    if (BlobCompression::isMarker(getReaderChannel().data->peek())) {
+      return get_compressed_data(obj, prevPos);
+    }
+#endif
     const Bridge::DataT& retval = getReaderChannel().data->pull(obj);
     // Check if the server completed a loop
     if ((*getReaderChannel().serverResetPosRequired) &&
@@ -174,6 +181,28 @@ public:
     return getReaderChannel().data->get_pos();
   }
 
+#ifdef REMIX_BRIDGE_SERVER
+  // Decodes a blob the client sent LZ4 compressed, see BlobCompression. The returned
+  // object stays valid until the next command is popped from the queue.
+  static const DataT& get_compressed_data(void** obj, const size_t prevPos) {
+    ZoneScoped;
+    thread_local DataT tlsSize;
+    tlsSize = BlobCompression::getSize(getReaderChannel().data->pull());
+    void* pCompressed = nullptr;
+    const DataT compressedSize = getReaderChannel().data->pull(&pCompressed);
+    *obj = BlobCompression::decompress(pCompressed, compressedSize, tlsSize);
+    if (*obj == nullptr) {
+      Logger::err("DataQueue get_data: Failed to decompress data object!");
+    }
+    // Check if the server completed a loop
+    if ((*getReaderChannel().serverResetPosRequired) &&
+        (get_data_pos() < prevPos)) {
+      *getReaderChannel().serverResetPosRequired = false;
+    }
+    return tlsSize;
+  }
+#endif
+
   static inline bridge_util::Result begin_read_data() {
     ZoneScoped;
     if (gbBridgeRunning) {
@@ -190,6 +219,40 @@ public:
     return 0;
   }
 
+#ifdef REMIX_BRIDGE_CLIENT
+  // When enabled, commands that do not wait for a server response are recorded per thread
+  // and merged into the writer channel at sync points, see CommandRecorder.
+  static void setCommandRecordingEnabled(const bool enabled) {
+    s_bCommandRecordingEnabled = enabled;
+  }
+  // Same as above for the Remix API calls, see CommandRecorder::isRemixApiRecordable
+  static void setRemixApiRecordingEnabled(const bool enabled) {
+    s_bRemixApiRecordingEnabled = enabled;
+  }
+  // Merges all per-thread recorded commands into the writer channel
+  static void flushRecordedCommands();
+#endif
+
+  // Pushes a variable size object to the writer channel. On the client, objects of at
+  // least compressDataBlobsThreshold bytes are LZ4 compressed first if enabled.
+  static bridge_util::Result push_blob(const DataT size, const void* obj) {
+#ifdef REMIX_BRIDGE_CLIENT
+    if (obj != nullptr && GlobalOptions::getCompressDataBlobs() && size >= GlobalOptions::getCompressDataBlobsThreshold()) {
+      const void* pCompressed = nullptr;
+      const uint32_t compressedSize = BlobCompression::compress(obj, size, pCompressed);
+      if (compressedSize > 0) {
+        syncDataQueue(1, false);
+        s_pWriterChannel->data->push(BlobCompression::getMarker(size));
+        syncDataQueue((align<size_t>(compressedSize, sizeof(DataT)) / sizeof(DataT)) + 1, true);
+        return s_pWriterChannel->data->push(compressedSize, pCompressed);
+      }
+    }
+#endif
+    const size_t memUsed = (obj == nullptr) ? 1 : (align<size_t>(size, sizeof(DataT)) / sizeof(DataT)) + 1;
+    syncDataQueue(memUsed, true);
+    return s_pWriterChannel->data->push(size, obj);
+  }
+
   static Header pop_front();
   static void syncDataQueue(size_t expectedMemUsage, bool posResetOnLastIndex = false);
   static bridge_util::Result ensureQueueEmpty();
@@ -230,6 +293,12 @@ public:
 
     inline void send_data(const DataT obj) {
       ZoneScoped;
+#ifdef REMIX_BRIDGE_CLIENT
+      if (m_pRecorder) {
+        m_pRecorder->push(obj);
+        return;
+      }
+#endif
       if (gbBridgeRunning) {
         syncDataQueue(1, false);
         const auto result = s_pWriterChannel->data->push(obj);
@@ -242,10 +311,14 @@ public:
 
     inline void send_data(const DataT size, const void* obj) {
       ZoneScoped;
+#ifdef REMIX_BRIDGE_CLIENT
+      if (m_pRecorder) {
+        m_pRecorder->push(size, obj);
+        return;
+      }
+#endif
       if (gbBridgeRunning) {
-        size_t memUsed = (obj == nullptr) ? 1 : (align<size_t>(size, sizeof(DataT)) / sizeof(DataT)) + 1;
-        syncDataQueue(memUsed, true);
-        const auto result = s_pWriterChannel->data->push(size, obj);
+        const auto result = push_blob(size, obj);
         if (RESULT_FAILURE(result)) {
           // For now just log when things go wrong, but could use some robustness improvements
           Logger::err("DataQueue send_data: Failed to send data object!");
@@ -256,6 +329,12 @@ public:
     template<typename... Ts>
     inline void send_many(const Ts... objs) {
       ZoneScoped;
+#ifdef REMIX_BRIDGE_CLIENT
+      if (m_pRecorder) {
+        (m_pRecorder->push((DataT) objs), ...);
+        return;
+      }
+#endif
       if (gbBridgeRunning) {
         size_t count = sizeof...(Ts);
         syncDataQueue(count, false);
@@ -269,6 +348,10 @@ public:
 
     inline uint8_t* begin_data_blob(const size_t size) {
       ZoneScoped;
+#ifdef REMIX_BRIDGE_CLIENT
+      // Reserved blobs point into the channel memory and cannot be recorded
+      assert(m_pRecorder == nullptr);
+#endif
       uint8_t* blobPacketPtr = nullptr;
       if (gbBridgeRunning) {
         size_t memUsed = align<size_t>(size, sizeof(DataT)) / sizeof(DataT) + 1;
@@ -328,9 +411,18 @@ public:
     }
 
   private:
+    static void beginCommand(const Commands::D3D9Command command, const uint32_t handle);
+    static void endCommand(const Commands::D3D9Command command, const uint32_t handle,
+                           const Commands::Flags commandFlags);
+
     const Commands::D3D9Command m_command;
     const uint32_t m_handle;
     const Commands::Flags m_commandFlags;
+#ifdef REMIX_BRIDGE_CLIENT
+    CommandRecorder* m_pRecorder = nullptr;
+#endif
+
+    friend class Bridge;
   };
 
 private:
@@ -343,6 +435,12 @@ private:
   static inline size_t         s_cmdCounter = 0;
   // UIDs are assigned to commands to tag the responses from server to allow misorder responses to be handled correctly 
   static inline UID s_cmdUID = 0;
+#ifdef REMIX_BRIDGE_CLIENT
+  static inline bool s_bCommandRecordingEnabled = false;
+  static inline bool s_bRemixApiRecordingEnabled = false;
+  // Caller must hold the writer channel lock
+  static void flushRecordedCommands_NoLock();
+#endif
 #if defined(REMIX_BRIDGE_CLIENT)
   static constexpr char kWriterChannelName[] = "Client2Server";
   static constexpr char kReaderChannelName[] = "Server2Client";
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_commands.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bridge_util {
+
+  // Per-thread command recording buffer. Commands that never wait for a server
+  // response are recorded into the calling thread's recorder instead of taking the
+  // writer channel lock for every call. Remix API calls are recorded the same way,
+  // which batches a frame's worth of them into a single merge. All recorders are merged back into the
+  // channel in global submission order (see drain()) at sync points: before any
+  // command that is not recorded, e.g. Present, resource creation or anything that
+  // waits for a response, and whenever a recorder grows past its flush threshold.
+  class CommandRecorder {
+  public:
+    struct Record {
+      uint64_t seq;
+      Commands::D3D9Command command;
+      Commands::Flags flags;
+      uint32_t handle;
+      uint32_t firstWord;
+      uint32_t endWord;
+    };
+
+    // Record payload encoding, every op is prefixed by its type
+    enum OpType: uint32_t {
+      Word = 0, // [Word, value]
+      Blob = 1, // [Blob, size, payload words...]
+    };
+
+    static CommandRecorder& local() {
+      thread_local std::shared_ptr<CommandRecorder> tlsRecorder = registerRecorder();
+      return *tlsRecorder;
+    }
+
+    static bool isRecordable(const Commands::D3D9Command command) {
+      switch (command) {
+      case Commands::IDirect3DDevice9Ex_BeginScene:
+      case Commands::IDirect3DDevice9Ex_EndScene:
+      case Commands::IDirect3DDevice9Ex_Clear:
+      case Commands::IDirect3DDevice9Ex_SetTransform:
+      case Commands::IDirect3DDevice9Ex_MultiplyTransform:
+      case Commands::IDirect3DDevice9Ex_SetViewport:
+      case Commands::IDirect3DDevice9Ex_SetMaterial:
+      case Commands::IDirect3DDevice9Ex_SetLight:
+      case Commands::IDirect3DDevice9Ex_LightEnable:
+      case Commands::IDirect3DDevice9Ex_SetClipPlane:
+      case Commands::IDirect3DDevice9Ex_SetRenderState:
+      case Commands::IDirect3DDevice9Ex_SetTexture:
+      case Commands::IDirect3DDevice9Ex_SetTextureStageState:
+      case Commands::IDirect3DDevice9Ex_SetSamplerState:
+      case Commands::IDirect3DDevice9Ex_SetScissorRect:
+      case Commands::IDirect3DDevice9Ex_SetNPatchMode:
+      case Commands::IDirect3DDevice9Ex_DrawPrimitive:
+      case Commands::IDirect3DDevice9Ex_DrawIndexedPrimitive:
+      case Commands::IDirect3DDevice9Ex_DrawPrimitiveUP:
+      case Commands::IDirect3DDevice9Ex_DrawIndexedPrimitiveUP:
+      case Commands::IDirect3DDevice9Ex_SetVertexDeclaration:
+      case Commands::IDirect3DDevice9Ex_SetFVF:
+      case Commands::IDirect3DDevice9Ex_SetVertexShader:
+      case Commands::IDirect3DDevice9Ex_SetVertexShaderConstantF:
+      case Commands::IDirect3DDevice9Ex_SetVertexShaderConstantI:
+      case Commands::IDirect3DDevice9Ex_SetVertexShaderConstantB:
+      case Commands::IDirect3DDevice9Ex_SetStreamSource:
+      case Commands::IDirect3DDevice9Ex_SetStreamSourceFreq:
+      case Commands::IDirect3DDevice9Ex_SetIndices:
+      case Commands::IDirect3DDevice9Ex_SetPixelShader:
+      case Commands::IDirect3DDevice9Ex_SetPixelShaderConstantF:
+      case Commands::IDirect3DDevice9Ex_SetPixelShaderConstantI:
+      case Commands::IDirect3DDevice9Ex_SetPixelShaderConstantB:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // Remix API calls that only carry small payloads and never wait on the server. Material and
+    // mesh creation move bulk data and stay unrecorded, which also makes them sync points.
+    static bool isRemixApiRecordable(const Commands::D3D9Command command) {
+      switch (command) {
+      case Commands::RemixApi_DestroyMaterial:
+      case Commands::RemixApi_DestroyMesh:
+      case Commands::RemixApi_DrawInstance:
+      case Commands::RemixApi_DrawInstances:
+      case Commands::RemixApi_CreateInstance:
+      case Commands::RemixApi_UpdateInstanceTransform:
+      case Commands::RemixApi_UpdateInstanceMaterial:
+      case Commands::RemixApi_DestroyInstance:
+      case Commands::RemixApi_CreateLight:
+      case Commands::RemixApi_DestroyLight:
+      case Commands::RemixApi_UpdateLights:
+      case Commands::RemixApi_DrawLightInstance:
+      case Commands::RemixApi_SetConfigVariable:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // The recorder stays locked for the lifetime of the recorded command
+    void begin(const Commands::D3D9Command command, const uint32_t handle, const Commands::Flags flags) {
+      m_mutex.lock();
+      const uint32_t firstWord = static_cast<uint32_t>(m_words.size());
+      m_records.push_back({ s_nextSeq.fetch_add(1, std::memory_order_relaxed), command, flags, handle, firstWord, firstWord });
+      s_numPending.fetch_add(1, std::memory_order_release);
+    }
+
+    void push(const uint32_t value) {
+      m_words.push_back(OpType::Word);
+      m_words.push_back(value);
+    }
+
+    void push(const uint32_t size, const void* obj) {
+      const uint32_t payloadSize = (obj == nullptr) ? 0 : size;
+      const size_t numPayloadWords = (payloadSize + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+      const size_t offset = m_words.size();
+      m_words.resize(offset + 2 + numPayloadWords);
+      m_words[offset] = OpType::Blob;
+      m_words[offset + 1] = payloadSize;
+      if (payloadSize > 0) {
+        memcpy(&m_words[offset + 2], obj, payloadSize);
+      }
+    }
+
+    // Returns true if the recorders should be drained
+    bool end() {
+      m_records.back().endWord = static_cast<uint32_t>(m_words.size());
+      const bool bFull = m_records.size() >= kMaxRecords || m_words.size() >= kMaxWords;
+      m_mutex.unlock();
+      return bFull;
+    }
+
+    static bool hasPending() {
+      return s_numPending.load(std::memory_order_acquire) > 0;
+    }
+
+    // Hands all recorded commands of all threads to replay(const Record&, const uint32_t* words)
+    // in the order they were recorded. The caller must hold the writer channel lock.
+    template<typename ReplayFn>
+    static void drain(ReplayFn&& replay) {
+      std::lock_guard registryLock(s_registryMutex);
+      struct Entry {
+        uint64_t seq;
+        const Record* pRecord;
+        const uint32_t* pWords;
+      };
+      std::vector<Entry> entries;
+      for (auto& pRecorder : s_recorders) {
+        pRecorder->m_mutex.lock();
+        for (const auto& record : pRecorder->m_records) {
+          entries.push_back({ record.seq, &record, pRecorder->m_words.data() });
+        }
+      }
+      std::sort(entries.begin(), entries.end(),
+                [](const Entry& a, const Entry& b) { return a.seq < b.seq; });
+      for (const auto& entry : entries) {
+        replay(*entry.pRecord, entry.pWords);
+      }
+      s_numPending.store(0, std::memory_order_release);
+      for (auto& pRecorder : s_recorders) {
+        pRecorder->m_records.clear();
+        pRecorder->m_words.clear();
+        pRecorder->m_mutex.unlock();
+      }
+      // Recorders of threads that exited are only referenced by the registry
+      s_recorders.erase(std::remove_if(s_recorders.begin(), s_recorders.end(),
+                                       [](const auto& pRecorder) { return pRecorder.use_count() == 1; }),
+                        s_recorders.end());
+    }
+
+    // Calls pushWord(uint32_t) and pushBlob(uint32_t size, const void*) for every op of the record
+    template<typename PushWordFn, typename PushBlobFn>
+    static void forEachOp(const Record& record, const uint32_t* words,
+                          PushWordFn&& pushWord, PushBlobFn&& pushBlob) {
+      uint32_t pos = record.firstWord;
+      while (pos < record.endWord) {
+        if (words[pos] == OpType::Word) {
+          pushWord(words[pos + 1]);
+          pos += 2;
+        } else {
+          const uint32_t size = words[pos + 1];
+          pushBlob(size, size > 0 ? &words[pos + 2] : nullptr);
+          pos += 2 + (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+        }
+      }
+    }
+
+  private:
+    static std::shared_ptr<CommandRecorder> registerRecorder() {
+      auto pRecorder = std::make_shared<CommandRecorder>();
+      std::lock_guard registryLock(s_registryMutex);
+      s_recorders.push_back(pRecorder);
+      return pRecorder;
+    }
+
+    static constexpr size_t kMaxRecords = 512;
+    static constexpr size_t kMaxWords = 64 << 10;
+
+    std::mutex m_mutex;
+    std::vector<Record> m_records;
+    std::vector<uint32_t> m_words;
+
+    inline static std::atomic<uint64_t> s_nextSeq = 0;
+    inline static std::atomic<size_t> s_numPending = 0;
+    inline static std::mutex s_registryMutex;
+    inline static std::vector<std::shared_ptr<CommandRecorder>> s_recorders;
+  };
+}
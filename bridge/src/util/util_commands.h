@@ -41,10 +41,18 @@ namespace Commands {
     RemixApi_CreateMaterial,
     RemixApi_DestroyMaterial,
     RemixApi_CreateMesh,
+    RemixApi_CreateMeshAsync,
+    RemixApi_UpdateMeshVertices,
     RemixApi_DestroyMesh,
     RemixApi_DrawInstance,
+    RemixApi_DrawInstances,
+    RemixApi_CreateInstance,
+    RemixApi_UpdateInstanceTransform,
+    RemixApi_UpdateInstanceMaterial,
+    RemixApi_DestroyInstance,
     RemixApi_CreateLight,
     RemixApi_DestroyLight,
+    RemixApi_UpdateLights,
     RemixApi_DrawLightInstance,
     RemixApi_SetConfigVariable,
     RemixApi_CreateD3D9,
@@ -60,6 +68,8 @@ namespace Commands {
     // prevent leaks.
     Bridge_UnlinkResource,
     Bridge_UnlinkVolumeResource,
+    // Uploads the data of several UnlockRect() calls at once
+    Bridge_UnlockSurfaceBatch,
     // These are not actually official D3D9 API calls.
     IDirect3DDevice9Ex_LinkSwapchain,
     IDirect3DDevice9Ex_LinkBackBuffer,
@@ -479,10 +489,18 @@ namespace Commands {
     case RemixApi_CreateMaterial: return "RemixApi_CreateMaterial";
     case RemixApi_DestroyMaterial: return "RemixApi_DestroyMaterial";
     case RemixApi_CreateMesh: return "RemixApi_CreateMesh";
+    case RemixApi_CreateMeshAsync: return "RemixApi_CreateMeshAsync";
+    case RemixApi_UpdateMeshVertices: return "RemixApi_UpdateMeshVertices";
     case RemixApi_DestroyMesh: return "RemixApi_DestroyMesh";
     case RemixApi_DrawInstance: return "RemixApi_DrawInstance";
+    case RemixApi_DrawInstances: return "RemixApi_DrawInstances";
+    case RemixApi_CreateInstance: return "RemixApi_CreateInstance";
+    case RemixApi_UpdateInstanceTransform: return "RemixApi_UpdateInstanceTransform";
+    case RemixApi_UpdateInstanceMaterial: return "RemixApi_UpdateInstanceMaterial";
+    case RemixApi_DestroyInstance: return "RemixApi_DestroyInstance";
     case RemixApi_CreateLight: return "RemixApi_CreateLight";
     case RemixApi_DestroyLight: return "RemixApi_DestroyLight";
+    case RemixApi_UpdateLights: return "RemixApi_UpdateLights";
     case RemixApi_DrawLightInstance: return "DrawLightInstance";
     case RemixApi_SetConfigVariable: return "RemixApi_SetConfigVariable";
     case RemixApi_CreateD3D9: return "RemixApi_CreateD3D9";
@@ -494,6 +512,7 @@ namespace Commands {
     
     case Bridge_UnlinkResource: return "Bridge_UnlinkResource";
     case Bridge_UnlinkVolumeResource: return "Bridge_UnlinkVolumeResource";
+    case Bridge_UnlockSurfaceBatch: return "Bridge_UnlockSurfaceBatch";
 
     case IDirect3DDevice9Ex_LinkSwapchain: return "IDirect3DDevice9Ex_LinkSwapchain";
     case IDirect3DDevice9Ex_LinkBackBuffer: return "IDirect3DDevice9Ex_LinkBackBuffer";
@@ -872,6 +891,12 @@ namespace Commands {
                                     // and only allocation id(s) is transferred on the queue
     DataIsReserved   = 0b00000010,  // Data was already reserved in data queue and only its
                                     // offset is transferred
+    DataHasRanges    = 0b00000100,  // Data is transferred as a list of {offset, size} ranges
+                                    // that fall within the locked span
+    DataIsDelta      = 0b00001000,  // Data is a change mask followed by only the changed
+                                    // elements, relative to the last delta of that command
+    DataInVertexRing = 0b00010000,  // Draw data is stored in the UP vertex ring and only its
+                                    // ring position is transferred
   };
 
   inline bool IsDataInSharedHeap(Flags flags) {
@@ -881,6 +906,18 @@ namespace Commands {
   inline bool IsDataReserved(Flags flags) {
     return (flags & FlagBits::DataIsReserved) != 0;
   }
+
+  inline bool IsDataInRanges(Flags flags) {
+    return (flags & FlagBits::DataHasRanges) != 0;
+  }
+
+  inline bool IsDataDelta(Flags flags) {
+    return (flags & FlagBits::DataIsDelta) != 0;
+  }
+
+  inline bool IsDataInVertexRing(Flags flags) {
+    return (flags & FlagBits::DataInVertexRing) != 0;
+  }
 }
 
 struct Header {
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_commands.h"
+#include "util_sharedmemory.h"
+
+#include <atomic>
+
+namespace bridge_util {
+
+  // Failures of Create* calls that did not wait for a server response. The server
+  // records them into a small shared memory block and the client reports them on
+  // the next Present, so asynchronous resource creation does not lose errors.
+  class DeferredCreateErrors {
+  public:
+    struct Summary {
+      uint32_t numErrors = 0;
+      Commands::D3D9Command lastCommand = Commands::Bridge_Invalid;
+      HRESULT lastHResult = S_OK;
+    };
+
+    // Server side
+    static void record(const Commands::D3D9Command command, const HRESULT hresult) {
+      Shared& shared = get();
+      shared.lastCommand.store(command, std::memory_order_relaxed);
+      shared.lastHResult.store(hresult, std::memory_order_relaxed);
+      shared.numErrors.fetch_add(1, std::memory_order_release);
+    }
+
+    // Client side, returns and resets the errors recorded since the last call
+    static Summary consume() {
+      Shared& shared = get();
+      Summary summary;
+      summary.numErrors = shared.numErrors.exchange(0, std::memory_order_acquire);
+      if (summary.numErrors > 0) {
+        summary.lastCommand = static_cast<Commands::D3D9Command>(shared.lastCommand.load(std::memory_order_relaxed));
+        summary.lastHResult = shared.lastHResult.load(std::memory_order_relaxed);
+      }
+      return summary;
+    }
+
+  private:
+    struct Shared {
+      std::atomic<uint32_t> numErrors;
+      std::atomic<uint32_t> lastCommand;
+      std::atomic<HRESULT> lastHResult;
+    };
+
+    static Shared& get() {
+      static SharedMemory memory("DeferredCreateErrors", sizeof(Shared));
+      return *static_cast<Shared*>(memory.data());
+    }
+  };
+
+}
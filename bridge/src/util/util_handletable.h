@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <assert.h>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace bridge_util {
+
+  // Client handles of D3D objects are dense indices that are recycled once their object is
+  // destroyed, with a generation in the top bits that is bumped on every reuse. The server can
+  // then keep its objects in flat arrays indexed by the handle instead of hash maps. Index 0 is
+  // never handed out, so a handle of 0 still means no object.
+  struct ObjectHandle {
+    static constexpr uint32_t kIndexBits = 22;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kMaxIndex = kIndexMask;
+    static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+
+    static uint32_t getIndex(const uint32_t handle) {
+      return handle & kIndexMask;
+    }
+    static uint32_t getGeneration(const uint32_t handle) {
+      return handle >> kIndexBits;
+    }
+    static uint32_t make(const uint32_t index, const uint32_t generation) {
+      return (generation << kIndexBits) | index;
+    }
+  };
+
+  // Hands out object handles on the client. A handle may only be released once the command
+  // destroying its object on the server has been sent, commands using the recycled handle are
+  // then guaranteed to be processed after it.
+  class ObjectHandleAllocator {
+  public:
+    // Returns 0 if all indices are in use
+    uint32_t allocate() {
+      std::lock_guard lock(m_mutex);
+      if (!m_freeIndices.empty()) {
+        const uint32_t index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+        return ObjectHandle::make(index, m_generations[index]);
+      }
+
+      // Slot 0 is reserved for the null handle
+      if (m_generations.empty()) {
+        m_generations.push_back(0);
+      }
+      const uint32_t index = (uint32_t) m_generations.size();
+      if (index > ObjectHandle::kMaxIndex) {
+        return 0;
+      }
+      m_generations.push_back(0);
+      return ObjectHandle::make(index, 0);
+    }
+
+    void release(const uint32_t handle) {
+      const uint32_t index = ObjectHandle::getIndex(handle);
+      std::lock_guard lock(m_mutex);
+      assert(index > 0 && index < m_generations.size() && m_generations[index] == ObjectHandle::getGeneration(handle));
+      m_generations[index] = (m_generations[index] + 1) & ObjectHandle::kGenerationMask;
+      m_freeIndices.push_back(index);
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::vector<uint32_t> m_generations;
+    std::vector<uint32_t> m_freeIndices;
+  };
+
+  // Server side table of objects indexed by their client handle. Drop-in for the
+  // std::unordered_map<uint32_t, T*> it replaces: looking up a missing handle yields a null entry,
+  // and entries never move, so references to them stay valid while other handles are looked up.
+  // Debug builds remember the full handle an entry was stored with and assert on lookups of a
+  // stale handle, i.e. one whose slot has since been reused by a newer object.
+  template<typename T>
+  class HandleTable {
+  public:
+    T*& operator[](const uint32_t handle) {
+      const uint32_t index = ObjectHandle::getIndex(handle);
+      Page& page = getPage(index);
+      const uint32_t slot = index & kPageMask;
+#ifdef _DEBUG
+      if (page.objects[slot] == nullptr) {
+        page.handles[slot] = handle;
+      } else {
+        assert(page.handles[slot] == handle && "Stale object handle");
+      }
+#endif
+      return page.objects[slot];
+    }
+
+    size_t erase(const uint32_t handle) {
+      const uint32_t index = ObjectHandle::getIndex(handle);
+      Page* pPage = m_pages[index >> kPageBits].get();
+      if (pPage == nullptr || pPage->objects[index & kPageMask] == nullptr) {
+        return 0;
+      }
+#ifdef _DEBUG
+      assert(pPage->handles[index & kPageMask] == handle && "Stale object handle");
+#endif
+      pPage->objects[index & kPageMask] = nullptr;
+      return 1;
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    size_t size() const {
+      size_t count = 0;
+      forEach([&count](uint32_t, const T*) { ++count; });
+      return count;
+    }
+
+    // Calls fn(index, object) for every object in the table
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+      for (uint32_t pageIdx = 0; pageIdx < kNumPages; ++pageIdx) {
+        const Page* pPage = m_pages[pageIdx].get();
+        if (pPage == nullptr) {
+          continue;
+        }
+        for (uint32_t slot = 0; slot < kPageSize; ++slot) {
+          if (pPage->objects[slot] != nullptr) {
+            fn((pageIdx << kPageBits) | slot, pPage->objects[slot]);
+          }
+        }
+      }
+    }
+
+  private:
+    static constexpr uint32_t kPageBits = 12;
+    static constexpr uint32_t kPageSize = 1u << kPageBits;
+    static constexpr uint32_t kPageMask = kPageSize - 1;
+    static constexpr uint32_t kNumPages = (ObjectHandle::kMaxIndex + 1) / kPageSize;
+
+    struct Page {
+      T* objects[kPageSize] = {};
+#ifdef _DEBUG
+      uint32_t handles[kPageSize] = {};
+#endif
+    };
+
+    Page& getPage(const uint32_t index) {
+      std::unique_ptr<Page>& pPage = m_pages[index >> kPageBits];
+      if (pPage == nullptr) {
+        pPage = std::make_unique<Page>();
+      }
+      return *pPage;
+    }
+
+    std::array<std::unique_ptr<Page>, kNumPages> m_pages;
+  };
+}
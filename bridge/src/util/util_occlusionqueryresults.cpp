@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "util_occlusionqueryresults.h"
+
+#include "util_once.h"
+
+#include <assert.h>
+
+using namespace bridge_util;
+
+void OcclusionQueryResults::init() {
+  if (s_bEnabled) {
+    assert(!"OcclusionQueryResults already initialized! An attempt to re-init has been made!");
+    Logger::warn("OcclusionQueryResults already initialized! An attempt to re-init has been made!");
+    return;
+  }
+  get();
+  s_bEnabled = true;
+}
+
+// Fresh shared memory is zeroed, and issue number 0 is never handed out
+OcclusionQueryResults::Instance::Instance()
+  : m_shMem("OcclusionQueryResults", kNumSlots * sizeof(std::atomic<uint64_t>))
+  , m_pSlots(static_cast<std::atomic<uint64_t>*>(m_shMem.data())) {
+#ifdef REMIX_BRIDGE_CLIENT
+  m_freeSlots.reserve(kNumSlots);
+  for (uint32_t slot = kNumSlots; slot > 0; --slot) {
+    m_freeSlots.push_back(slot - 1);
+  }
+#endif
+  Logger::info(format_string("OcclusionQueryResults with %d slots initialized.", kNumSlots));
+}
+
+#ifdef REMIX_BRIDGE_CLIENT
+uint32_t OcclusionQueryResults::Instance::allocateSlot() {
+  std::scoped_lock lock(m_mutex);
+  if (m_freeSlots.empty()) {
+    ONCE(Logger::warn("All OcclusionQueryResults slots are in use, further occlusion queries wait for the server."));
+    return kInvalidSlot;
+  }
+  const uint32_t slot = m_freeSlots.back();
+  m_freeSlots.pop_back();
+  return slot;
+}
+
+void OcclusionQueryResults::Instance::releaseSlot(const uint32_t slot) {
+  std::scoped_lock lock(m_mutex);
+  m_freeSlots.push_back(slot);
+}
+
+uint32_t OcclusionQueryResults::Instance::nextIssue() {
+  uint32_t issue = ++m_lastIssue;
+  while (issue == 0) {
+    issue = ++m_lastIssue;
+  }
+  return issue;
+}
+
+bool OcclusionQueryResults::Instance::tryGetResult(const uint32_t slot, const uint32_t issue, DWORD& result) const {
+  const uint64_t value = m_pSlots[slot].load(std::memory_order_acquire);
+  if (static_cast<uint32_t>(value >> 32) != issue) {
+    return false;
+  }
+  result = static_cast<DWORD>(value);
+  return true;
+}
+#endif
+
+#ifdef REMIX_BRIDGE_SERVER
+void OcclusionQueryResults::Instance::publish(const uint32_t slot, const uint32_t issue, const DWORD result) {
+  assert(slot < kNumSlots);
+  m_pSlots[slot].store((static_cast<uint64_t>(issue) << 32) | result, std::memory_order_release);
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_common.h"
+#include "util_sharedmemory.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace bridge_util {
+
+  // Shared memory table through which the server publishes occlusion query results, so
+  // that the client can answer IDirect3DQuery9::GetData without a server round trip.
+  //
+  // Every occlusion query gets a slot in the table when it is created. Each of its
+  // Issue() calls is numbered by the client and the number is sent along with the
+  // command. Once the server finds the result of an ended query to be available it
+  // stores the number together with the result in the query's slot. The client only
+  // accepts a slot value carrying the number of the query's most recent Issue(), which
+  // also rules out stale results published for a previous owner of the slot.
+  class OcclusionQueryResults {
+  public:
+    static constexpr uint32_t kInvalidSlot = UINT32_MAX;
+
+    static void init();
+    static bool isEnabled() {
+      return s_bEnabled;
+    }
+
+#ifdef REMIX_BRIDGE_CLIENT
+    // Returns kInvalidSlot once all slots are taken, such queries use the regular GetData round trip
+    static uint32_t allocateSlot() {
+      return get().allocateSlot();
+    }
+    static void releaseSlot(const uint32_t slot) {
+      get().releaseSlot(slot);
+    }
+    // Returns a new issue number, never 0
+    static uint32_t nextIssue() {
+      return get().nextIssue();
+    }
+    // Returns true if the slot holds the result of the given issue
+    static bool tryGetResult(const uint32_t slot, const uint32_t issue, DWORD& result) {
+      return get().tryGetResult(slot, issue, result);
+    }
+#endif
+#ifdef REMIX_BRIDGE_SERVER
+    static void publish(const uint32_t slot, const uint32_t issue, const DWORD result) {
+      get().publish(slot, issue, result);
+    }
+#endif
+
+  private:
+    OcclusionQueryResults() = delete;
+    OcclusionQueryResults(const OcclusionQueryResults& b) = delete;
+    OcclusionQueryResults(const OcclusionQueryResults&& b) = delete;
+
+    static constexpr uint32_t kNumSlots = 4096;
+
+    class Instance {
+    public:
+      Instance();
+#ifdef REMIX_BRIDGE_CLIENT
+      uint32_t allocateSlot();
+      void releaseSlot(const uint32_t slot);
+      uint32_t nextIssue();
+      bool tryGetResult(const uint32_t slot, const uint32_t issue, DWORD& result) const;
+#endif
+#ifdef REMIX_BRIDGE_SERVER
+      void publish(const uint32_t slot, const uint32_t issue, const DWORD result);
+#endif
+
+    private:
+      Instance(const Instance& b) = delete;
+      Instance(const Instance&& b) = delete;
+
+      SharedMemory m_shMem;
+      // Issue number in the upper half, result in the lower half
+      std::atomic<uint64_t>* const m_pSlots;
+#ifdef REMIX_BRIDGE_CLIENT
+      std::mutex m_mutex;
+      std::vector<uint32_t> m_freeSlots;
+      std::atomic<uint32_t> m_lastIssue = 0;
+#endif
+    };
+
+    static Instance& get() {
+      static Instance instance;
+      return instance;
+    }
+
+    static inline bool s_bEnabled = false;
+  };
+}
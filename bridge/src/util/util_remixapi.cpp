@@ -36,6 +36,7 @@ namespace util {
 MaterialHandle::HandleMapT MaterialHandle::s_handleMap;
 MeshHandle::HandleMapT MeshHandle::s_handleMap;
 LightHandle::HandleMapT LightHandle::s_handleMap;
+InstanceHandle::HandleMapT InstanceHandle::s_handleMap;
 #endif
 }
 }
@@ -520,18 +521,18 @@ uint32_t InstanceInfoTransforms::_calcSize() const {
   size += sizeOf<remixapi_Transform>() * boneTransforms_count;
   return size;
 }
+// Transforms are tightly packed floats, so the palette is copied as a single block
+static_assert(sizeof(remixapi_Transform) == bridge_util::sizeOf<remixapi_Transform>());
 void InstanceInfoTransforms::_serialize(void*& pSerialize) const {
   bridge_util::serialize(sType, pSerialize);
   bridge_util::serialize(boneTransforms_count, pSerialize);
-  for(size_t iXform = 0; iXform < boneTransforms_count; ++iXform) {
-    bridge_util::serialize(boneTransforms_values[iXform], pSerialize);
-  }
+  bridge_util::serialize(boneTransforms_values, pSerialize, boneTransforms_count * sizeof(remixapi_Transform));
 }
 void InstanceInfoTransforms::_deserialize(void*& pDeserialize) {
   bridge_util::deserialize(pDeserialize, sType);
   pNext = nullptr;
   bridge_util::deserialize(pDeserialize, boneTransforms_count);
-  deserialize_const_p_for_each(pDeserialize, boneTransforms_values, boneTransforms_count);
+  deserialize_const_p(pDeserialize, boneTransforms_values, boneTransforms_count * sizeof(remixapi_Transform));
 }
 void InstanceInfoTransforms::_dtor() {
   delete boneTransforms_values;
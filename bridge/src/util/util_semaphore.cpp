@@ -32,7 +32,25 @@ namespace bridge_util {
 
   Result NamedSemaphore::wait(const DWORD timeoutMS) {
     // Note: WaitXXX commands decrement the semaphore value by 1
-    DWORD dwWaitResult = WaitForSingleObject(ghSemaphore, timeoutMS);
+    DWORD dwWaitResult;
+    if (AdaptiveWait::isEnabled() && timeoutMS != 0) {
+      // Poll the semaphore while the wait is expected to be short, which saves the
+      // cost of putting the thread to sleep and waking it up again in the kernel.
+      AdaptiveWait::Scope adaptiveWait(waiter);
+      dwWaitResult = WaitForSingleObject(ghSemaphore, 0);
+      while (dwWaitResult == WAIT_TIMEOUT && adaptiveWait.isPolling()) {
+        adaptiveWait.pause();
+        dwWaitResult = WaitForSingleObject(ghSemaphore, 0);
+      }
+      if (dwWaitResult == WAIT_TIMEOUT) {
+        const DWORD elapsedMS = static_cast<DWORD>(adaptiveWait.elapsedUs() / 1'000);
+        const DWORD remainingMS = (timeoutMS == INFINITE) ? INFINITE :
+                                  (timeoutMS > elapsedMS ? timeoutMS - elapsedMS : 0);
+        dwWaitResult = WaitForSingleObject(ghSemaphore, remainingMS);
+      }
+    } else {
+      dwWaitResult = WaitForSingleObject(ghSemaphore, timeoutMS);
+    }
     if (dwWaitResult == WAIT_OBJECT_0) {
       avail--;
       return Result::Success;
@@ -22,6 +22,7 @@
 #ifndef UTIL_SEMAPHORE_H_
 #define UTIL_SEMAPHORE_H_
 
+#include "util_adaptivewait.h"
 #include "util_common.h"
 #include "log/log.h"
 #include "util_guid.h"
@@ -43,12 +44,14 @@ namespace bridge_util {
     const size_t count;
     size_t avail;
     HANDLE ghSemaphore;
+    AdaptiveWait waiter;
 
   public:
     NamedSemaphore(const std::string& name, const size_t& init, const size_t& max)
       : baseName(name)
       , count(max)
-      , avail(init) {
+      , avail(init)
+      , waiter(name) {
 
       const auto uniqueName = gUniqueIdentifier.toString(name);
 
@@ -45,6 +45,9 @@ SharedHeap::Instance::Instance()
   : m_chunkSize(GlobalOptions::getSharedHeapChunkSize())
   , m_defaultSegmentSize(GlobalOptions::getSharedHeapDefaultSegmentSize())
   , m_nChunks(0)
+#ifdef REMIX_BRIDGE_CLIENT
+  , m_bUseSizeClasses(GlobalOptions::getUseSharedHeapSizeClasses())
+#endif
   , m_metaShMem("SharedHeap_meta", (kMax32BitHeapSize / m_chunkSize)) {
 #ifdef REMIX_BRIDGE_CLIENT
   assert(GlobalOptions::getUseSharedHeap());
@@ -54,15 +57,46 @@ SharedHeap::Instance::Instance()
   }
   addNewHeapSegment();
   assert(m_segments.size() == 1);
+
+  for (uint32_t sizeClass = 0; sizeClass < kNumSizeClasses; ++sizeClass) {
+    const uint32_t slotChunks = (kSizeClassSizes[sizeClass] + m_chunkSize - 1) / m_chunkSize;
+    // Size classes that would not fit at least two slots into a slab are not used
+    m_sizeClassChunks[sizeClass] = (2 * slotChunks * m_chunkSize <= kSlabSize) ? slotChunks : 0;
+  }
+
+  const uint32_t compactionIntervalMS = GlobalOptions::getSharedHeapCompactionInterval();
+  if (compactionIntervalMS > 0) {
+    m_compactionThread = std::thread([this, compactionIntervalMS]() {
+      compactionLoop(compactionIntervalMS);
+    });
+  }
+#endif
+}
+
+SharedHeap::Instance::~Instance() {
+#ifdef REMIX_BRIDGE_CLIENT
+  if (m_compactionThread.joinable()) {
+    {
+      std::lock_guard lock(m_mutex);
+      m_bExitCompaction = true;
+    }
+    m_compactionCond.notify_all();
+    m_compactionThread.join();
+  }
 #endif
 }
 
 BYTE* SharedHeap::Instance::getBuf(const AllocId id) {
+#ifdef REMIX_BRIDGE_CLIENT
+  std::lock_guard lock(m_mutex);
+#endif
   assert(m_cache.count(id) != 0);
-  const auto firstChunk = m_cache[id];
-  const auto segId = chunkIdToSegId(firstChunk);
-  BYTE* const pBuf = m_segments[segId].getBuf(firstChunk);
-  return pBuf;
+  return getChunkBuf(m_cache[id]);
+}
+
+BYTE* SharedHeap::Instance::getChunkBuf(const ChunkId chunkId) const {
+  const auto segId = chunkIdToSegId(chunkId);
+  return m_segments[segId].getBuf(chunkId);
 }
 
 size_t SharedHeap::Instance::getTotalHeapSize() const {
@@ -149,6 +183,7 @@ void SharedHeap::Instance::addNewHeapSegment(const uint32_t segmentSize) {
 
 #ifdef REMIX_BRIDGE_CLIENT
 SharedHeap::AllocId SharedHeap::Instance::allocate(const size_t size) {
+  std::lock_guard lock(m_mutex);
   if (size > m_defaultSegmentSize) {
     size_t newDefaultSegmentSize = m_defaultSegmentSize;
     while (size > newDefaultSegmentSize) {
@@ -165,12 +200,23 @@ SharedHeap::AllocId SharedHeap::Instance::allocate(const size_t size) {
     m_defaultSegmentSize = newDefaultSegmentSize;
   }
   // Resolve the number of chunks we need to allocate
-  const uint32_t numChunks =
+  uint32_t numChunks =
     ((size % m_chunkSize) == 0) ? (size / m_chunkSize) : (size / m_chunkSize + 1);
 
-  const auto alloc = findAllocation(numChunks);
-  assert(isValidAllocation(alloc));
-  if (!isValidAllocation(alloc)) {
+  ChunkId firstChunk = kInvalidId;
+  const uint32_t sizeClass = getSizeClass(numChunks);
+  if (sizeClass < kNumSizeClasses) {
+    firstChunk = allocateSlot(sizeClass);
+    numChunks = m_sizeClassChunks[sizeClass];
+  } else {
+    const auto alloc = findAllocation(numChunks);
+    if (isValidAllocation(alloc)) {
+      firstChunk = alloc.firstChunk;
+      m_allocations[alloc.firstChunk] = alloc.finalChunk;
+    }
+  }
+  assert(firstChunk != kInvalidId);
+  if (firstChunk == kInvalidId) {
     std::stringstream ss;
     ss << "[SharedHeap][allocate] Failed allocation. Size: ";
     ss << bridge_util::toByteUnitString(size);
@@ -179,20 +225,19 @@ SharedHeap::AllocId SharedHeap::Instance::allocate(const size_t size) {
   }
 
   const auto id = m_nextUid++;
-  m_cache[id] = alloc.firstChunk;
-  m_allocations[alloc.firstChunk] = alloc.finalChunk;
+  m_cache[id] = firstChunk;
   {
     ClientMessage c(Commands::Bridge_SharedHeap_Alloc, id);
-    c.send_data(alloc.firstChunk);
+    c.send_data(firstChunk);
   }
 
-  assert(getChunkState(alloc.firstChunk) == ChunkState::Unallocated);
-  setChunkState(alloc.firstChunk, ChunkState::Allocated);
+  assert(getChunkState(firstChunk) == ChunkState::Unallocated);
+  setChunkState(firstChunk, ChunkState::Allocated);
 
   const size_t sizeAllocated = numChunks * m_chunkSize;
   m_sizeAllocated += sizeAllocated;
 #ifdef _DEBUG
-  memset(getBuf(id), 0, sizeAllocated);
+  memset(getChunkBuf(firstChunk), 0, sizeAllocated);
 #endif
   return id;
 }
@@ -238,6 +283,7 @@ SharedHeap::Instance::findAllocation(const size_t numChunks) {
         Logger::warn(ss.str());
       }
       freeDeallocations();
+      releaseEmptySlabs();
       constexpr size_t kAttemptIncrease = 2;
       if (nFailedIterations == kAttemptIncrease) {
         Logger::info("[SharedHeap][findAllocation] Attempting to increase SharedHeap size.");
@@ -305,15 +351,107 @@ void SharedHeap::Instance::freeDeallocations() {
   for (const auto deallocatedId : deallocatedIds) {
     const auto firstChunk = m_cache[deallocatedId];
     m_cache.erase(deallocatedId);
-    assert(m_allocations.count(firstChunk) > 0);
-    const auto finalChunk = m_allocations[firstChunk];
-    const size_t numChunks = finalChunk - firstChunk + 1;
-    m_allocations.erase(firstChunk);
+    size_t numChunks = 0;
+    const auto slotIt = m_slotToSlab.find(firstChunk);
+    if (slotIt != m_slotToSlab.end()) {
+      // Slot in a size class slab, the slab itself stays allocated
+      auto& slab = m_slabs[slotIt->second];
+      const size_t slotIdx = (firstChunk - slotIt->second) / slab.slotChunks;
+      assert(slab.usedSlots[slotIdx]);
+      slab.usedSlots[slotIdx] = false;
+      --slab.numUsed;
+      numChunks = slab.slotChunks;
+      m_slotToSlab.erase(slotIt);
+    } else {
+      assert(m_allocations.count(firstChunk) > 0);
+      const auto finalChunk = m_allocations[firstChunk];
+      numChunks = finalChunk - firstChunk + 1;
+      m_allocations.erase(firstChunk);
+    }
     setChunkState(firstChunk, ChunkState::Unallocated);
     m_sizeAllocated -= numChunks * m_chunkSize;
   }
 }
 
+uint32_t SharedHeap::Instance::getSizeClass(const size_t numChunks) const {
+  if (m_bUseSizeClasses) {
+    for (uint32_t sizeClass = 0; sizeClass < kNumSizeClasses; ++sizeClass) {
+      if (m_sizeClassChunks[sizeClass] > 0 && numChunks <= m_sizeClassChunks[sizeClass]) {
+        return sizeClass;
+      }
+    }
+  }
+  return kNumSizeClasses;
+}
+
+ChunkId SharedHeap::Instance::allocateSlot(const uint32_t sizeClass) {
+  const uint32_t slotChunks = m_sizeClassChunks[sizeClass];
+  auto takeSlot = [&](const ChunkId slabFirstChunk, Slab& slab) {
+    for (size_t slotIdx = 0; slotIdx < slab.usedSlots.size(); ++slotIdx) {
+      if (!slab.usedSlots[slotIdx]) {
+        slab.usedSlots[slotIdx] = true;
+        ++slab.numUsed;
+        const ChunkId slotFirstChunk = slabFirstChunk + slotIdx * slotChunks;
+        m_slotToSlab[slotFirstChunk] = slabFirstChunk;
+        return slotFirstChunk;
+      }
+    }
+    assert(!"Slab has no free slot!");
+    return kInvalidId;
+  };
+  // Prefer the fullest slab with a free slot so that the others can drain
+  Slab* pBestSlab = nullptr;
+  ChunkId bestSlabFirstChunk = kInvalidId;
+  for (auto& [slabFirstChunk, slab] : m_slabs) {
+    if (slab.sizeClass == sizeClass && slab.numUsed < slab.usedSlots.size() &&
+        (pBestSlab == nullptr || slab.numUsed > pBestSlab->numUsed)) {
+      pBestSlab = &slab;
+      bestSlabFirstChunk = slabFirstChunk;
+    }
+  }
+  if (pBestSlab != nullptr) {
+    return takeSlot(bestSlabFirstChunk, *pBestSlab);
+  }
+  // All slabs of this size class are full, carve out a new one
+  const auto alloc = findAllocation(kSlabSize / m_chunkSize);
+  if (!isValidAllocation(alloc)) {
+    return kInvalidId;
+  }
+  m_allocations[alloc.firstChunk] = alloc.finalChunk;
+  auto& slab = m_slabs[alloc.firstChunk];
+  slab.sizeClass = sizeClass;
+  slab.slotChunks = slotChunks;
+  slab.usedSlots.resize(kSlabSize / (slotChunks * m_chunkSize), false);
+  return takeSlot(alloc.firstChunk, slab);
+}
+
+void SharedHeap::Instance::releaseEmptySlabs() {
+  // Keep a single empty slab per size class around to avoid churn
+  bool bKeptEmptySlab[kNumSizeClasses] = {};
+  for (auto it = m_slabs.begin(); it != m_slabs.end();) {
+    auto& slab = it->second;
+    if (slab.numUsed == 0 && bKeptEmptySlab[slab.sizeClass]) {
+      m_allocations.erase(it->first);
+      it = m_slabs.erase(it);
+    } else {
+      bKeptEmptySlab[slab.sizeClass] |= (slab.numUsed == 0);
+      ++it;
+    }
+  }
+}
+
+void SharedHeap::Instance::compactionLoop(const uint32_t intervalMS) {
+  std::unique_lock lock(m_mutex);
+  while (!m_compactionCond.wait_for(lock, std::chrono::milliseconds(intervalMS),
+                                    [this]() { return m_bExitCompaction; })) {
+    ZoneScopedN("SharedHeap compaction");
+    // Returns the chunks the server is done with and empty slabs to the heap
+    // ahead of time, rather than only once an allocation fails.
+    freeDeallocations();
+    releaseEmptySlabs();
+  }
+}
+
 bool SharedHeap::Instance::isValidAllocation(const Allocation& alloc) {
   if (alloc.firstChunk >= m_nChunks ||
       alloc.finalChunk >= m_nChunks ||
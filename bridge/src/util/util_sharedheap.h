@@ -24,8 +24,11 @@
 #include "util_common.h"
 #include "util_sharedmemory.h"
 
-#include <unordered_map>
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace bridge_util {
   class SharedHeap {
@@ -67,6 +70,7 @@ namespace bridge_util {
     class Instance {
     public:
       Instance();
+      ~Instance();
       BYTE* getBuf(const AllocId id);
 #ifdef REMIX_BRIDGE_CLIENT
       AllocId allocate(const size_t size);
@@ -81,6 +85,17 @@ namespace bridge_util {
     private:
       // Constants
       static constexpr uint32_t kMax32BitHeapSize = 2 << 30; // 2GB
+#ifdef REMIX_BRIDGE_CLIENT
+      // Small allocations are served from slabs of same sized slots so that they
+      // do not fragment the chunk space that large allocations need.
+      static constexpr uint32_t kSlabSize = 4 << 20; // 4MB
+      static constexpr size_t kNumSizeClasses = 3;
+      static constexpr uint32_t kSizeClassSizes[kNumSizeClasses] = {
+        4 << 10,  // 4kB
+        64 << 10, // 64kB
+        1 << 20,  // 1MB
+      };
+#endif
 
       // Members
       const uint32_t m_chunkSize;
@@ -91,6 +106,26 @@ namespace bridge_util {
       AllocId m_nextUid = 0;
       std::map<ChunkId, ChunkId> m_allocations;
       size_t m_sizeAllocated = 0;
+
+      // Size classes
+      struct Slab {
+        uint32_t sizeClass;
+        uint32_t slotChunks;
+        uint32_t numUsed = 0;
+        std::vector<bool> usedSlots;
+      };
+      const bool m_bUseSizeClasses;
+      uint32_t m_sizeClassChunks[kNumSizeClasses] = {};
+      // Slabs are regular allocations in m_allocations, keyed by their first chunk
+      std::map<ChunkId, Slab> m_slabs;
+      // First chunk of an allocated slot -> first chunk of its slab
+      std::unordered_map<ChunkId, ChunkId> m_slotToSlab;
+
+      // Background compaction
+      std::mutex m_mutex;
+      std::condition_variable m_compactionCond;
+      bool m_bExitCompaction = false;
+      std::thread m_compactionThread;
 #endif
 
       // Delete other ctors
@@ -100,6 +135,7 @@ namespace bridge_util {
       // Helpers
       size_t getTotalHeapSize() const;
       Id chunkIdToSegId(const ChunkId chunkId) const;
+      BYTE* getChunkBuf(const ChunkId chunkId) const;
 #ifdef REMIX_BRIDGE_CLIENT
       bool addNewHeapSegment();
       struct Allocation {
@@ -114,6 +150,10 @@ namespace bridge_util {
       Allocation findFreeInMiddle(const size_t numChunks);
       Allocation findFreeOnEnd(const size_t numChunks);
       void freeDeallocations();
+      uint32_t getSizeClass(const size_t numChunks) const;
+      ChunkId allocateSlot(const uint32_t sizeClass);
+      void releaseEmptySlabs();
+      void compactionLoop(const uint32_t intervalMS);
       bool isValidAllocation(const Allocation& alloc);
       bool allocationCrossesHeapSegBound(const Allocation& alloc);
 #endif
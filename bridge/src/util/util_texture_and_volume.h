@@ -253,6 +253,19 @@ namespace bridge_util {
     decomp.height = (pRect) ? pRect->bottom - pRect->top : desc.Height;
     return decomp;
   }
+
+  // A single surface upload of a Bridge_UnlockSurfaceBatch command. The surface data
+  // either lives in the shared heap allocation bufId, or at dataOffset in the data
+  // blob that follows the entries.
+  struct SurfaceUploadEntry {
+    uint32_t surfaceHandle;
+    RECT rect;
+    DWORD flags;
+    D3DFORMAT format;
+    uint32_t pitch;
+    uint32_t bufIdOrDataOffset;
+  };
+  static_assert(sizeof(SurfaceUploadEntry) == 32, "SurfaceUploadEntry must have the same layout on x86 and x64.");
 }
 
 #define FOR_EACH_RECT_ROW(LOCKED_RECT, HEIGHT, FORMAT, DO_THIS_TO_ptr)   \
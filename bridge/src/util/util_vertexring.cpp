@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "util_vertexring.h"
+
+#include "util_devicecommand.h"
+#include "config/global_options.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include <thread>
+
+using namespace bridge_util;
+
+namespace {
+  // Positions wrap around at 2^32, so the ring size has to be a power of two
+  uint32_t getRingSize() {
+    static constexpr uint32_t kMinRingSize = 1 << 20; // 1MB
+    uint32_t size = std::max(GlobalOptions::getVertexRingSize(), kMinRingSize);
+    while ((size & (size - 1)) != 0) {
+      size &= size - 1;
+    }
+    return size;
+  }
+}
+
+void VertexRing::init() {
+  if (s_bEnabled) {
+    assert(!"VertexRing already initialized! An attempt to re-init has been made!");
+    Logger::warn("VertexRing already initialized! An attempt to re-init has been made!");
+    return;
+  }
+  get();
+  s_bEnabled = true;
+}
+
+VertexRing::Instance::Instance()
+  : m_size(getRingSize())
+  , m_shMem("VertexRing", kHeaderSize + m_size)
+  , m_pReleasedPos(static_cast<std::atomic<uint32_t>*>(m_shMem.data()))
+  , m_pRing(static_cast<BYTE*>(m_shMem.data()) + kHeaderSize) {
+  Logger::info(format_string("VertexRing of %d bytes initialized.", m_size));
+}
+
+#ifdef REMIX_BRIDGE_CLIENT
+VertexRing::Writer::Writer(const uint32_t size) {
+  if (!isEnabled() || size == 0) {
+    return;
+  }
+  auto& ring = get();
+  m_lock = std::unique_lock(ring.getMutex());
+  m_size = align(size);
+  m_pData = ring.allocate(m_size, m_pos);
+  if (m_pData == nullptr) {
+    m_lock.unlock();
+  }
+}
+
+BYTE* VertexRing::Instance::allocate(const uint32_t size, uint32_t& pos) {
+  // Large draws would stall on the server constantly, leave them to the data queue
+  if (size > m_size / 4) {
+    return nullptr;
+  }
+
+  // A reservation never wraps, the rest of the ring is skipped instead
+  const uint32_t offset = m_nextPos & (m_size - 1);
+  const uint32_t padding = (offset + size > m_size) ? m_size - offset : 0;
+  const uint32_t required = padding + size;
+
+  auto getFreeSize = [this]() {
+    return m_size - (m_nextPos - m_pReleasedPos->load(std::memory_order_acquire));
+  };
+  if (getFreeSize() < required) {
+    ZoneScopedN("VertexRing wait");
+    // Whatever still occupies the ring may be sitting in a command recorder
+    DeviceBridge::flushRecordedCommands();
+    const uint32_t timeoutMS = GlobalOptions::getCommandTimeout();
+    const auto start = std::chrono::steady_clock::now();
+    while (getFreeSize() < required) {
+      const bool bTimedOut = timeoutMS != 0 &&
+        std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeoutMS);
+      if (!gbBridgeRunning || bTimedOut) {
+        Logger::debug("VertexRing is full, sending draw data through the data queue.");
+        return nullptr;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  pos = m_nextPos + padding;
+  m_nextPos = pos + size;
+  return getBuf(pos);
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "util_common.h"
+#include "util_sharedmemory.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace bridge_util {
+
+  // Persistent shared memory ring for the user pointer data of DrawPrimitiveUP and
+  // DrawIndexedPrimitiveUP. The client copies the vertices (and indices) straight
+  // into the ring and the command only carries their position, the server reads
+  // the data from its own mapping of the ring and hands it to the device as is.
+  // Remix API instance draws put their bone palettes in the ring the same way.
+  //
+  // Positions are free running byte counters, the ring offset is the position
+  // modulo the ring size. The client hands out space in command order and the
+  // server processes commands in that same order, so the end of the most recently
+  // released reservation, published by the server, is all the client needs to know
+  // which part of the ring is free again.
+  class VertexRing {
+  public:
+    static void init();
+    static bool isEnabled() {
+      return s_bEnabled;
+    }
+
+    static uint32_t align(const uint32_t size) {
+      return (size + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+#ifdef REMIX_BRIDGE_CLIENT
+    // Reserves ring space for the data of a single command. The ring stays locked
+    // for the lifetime of the writer so that reservations are handed out in the
+    // order the commands are sent in, which means the writer has to be created
+    // before the command and outlive it. An invalid writer means the data did not
+    // fit and has to be sent through the data queue instead.
+    class Writer {
+    public:
+      explicit Writer(const uint32_t size);
+
+      Writer(const Writer&) = delete;
+      Writer& operator=(const Writer&) = delete;
+
+      bool isValid() const {
+        return m_pData != nullptr;
+      }
+      BYTE* data() const {
+        return m_pData;
+      }
+      uint32_t getPos() const {
+        return m_pos;
+      }
+      uint32_t getSize() const {
+        return m_size;
+      }
+
+    private:
+      std::unique_lock<std::mutex> m_lock;
+      BYTE* m_pData = nullptr;
+      uint32_t m_pos = 0;
+      uint32_t m_size = 0;
+    };
+#endif
+#ifdef REMIX_BRIDGE_SERVER
+    static const BYTE* getBuf(const uint32_t pos) {
+      return get().getBuf(pos);
+    }
+    // Returns the reservation and everything before it to the client
+    static void release(const uint32_t pos, const uint32_t size) {
+      get().release(pos, size);
+    }
+#endif
+
+  private:
+    VertexRing() = delete;
+    VertexRing(const VertexRing& b) = delete;
+    VertexRing(const VertexRing&& b) = delete;
+
+    static constexpr uint32_t kAlignment = 16;
+    // The released position lives in its own cache line ahead of the ring data
+    static constexpr uint32_t kHeaderSize = 64;
+
+    class Instance {
+    public:
+      Instance();
+      BYTE* getBuf(const uint32_t pos) const {
+        return m_pRing + (pos & (m_size - 1));
+      }
+#ifdef REMIX_BRIDGE_CLIENT
+      BYTE* allocate(const uint32_t size, uint32_t& pos);
+      std::mutex& getMutex() {
+        return m_mutex;
+      }
+#endif
+#ifdef REMIX_BRIDGE_SERVER
+      void release(const uint32_t pos, const uint32_t size) {
+        m_pReleasedPos->store(pos + size, std::memory_order_release);
+      }
+#endif
+
+    private:
+      Instance(const Instance& b) = delete;
+      Instance(const Instance&& b) = delete;
+
+      const uint32_t m_size;
+      SharedMemory m_shMem;
+      std::atomic<uint32_t>* const m_pReleasedPos;
+      BYTE* const m_pRing;
+#ifdef REMIX_BRIDGE_CLIENT
+      std::mutex m_mutex;
+      uint32_t m_nextPos = 0;
+#endif
+    };
+
+    static Instance& get() {
+      static Instance instance;
+      return instance;
+    }
+
+    static inline bool s_bEnabled = false;
+  };
+}
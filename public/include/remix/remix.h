@@ -173,10 +173,20 @@ namespace remix {
     Result< void >                    DestroyMaterial(remixapi_MaterialHandle handle);
     Result< remixapi_MeshHandle >     CreateMesh(const remixapi_MeshInfo& info);
     Result< void >                    DestroyMesh(remixapi_MeshHandle handle);
+    Result< remixapi_MeshHandle >     CreateMeshAsync(const remixapi_MeshInfo& info);
+    Result< bool >                    IsMeshReady(remixapi_MeshHandle handle);
+    Result< void >                    UpdateMeshVertices(remixapi_MeshHandle handle, uint32_t surfaceIndex, uint64_t firstVertex,
+                                                         const remixapi_HardcodedVertex* vertices_values, uint64_t vertices_count);
     Result< void >                    SetupCamera(const remixapi_CameraInfo& info);
     Result< void >                    DrawInstance(const remixapi_InstanceInfo& info);
+    Result< void >                    DrawInstances(const remixapi_InstanceInfo* infos, uint32_t infos_count);
+    Result< remixapi_InstanceHandle > CreateInstance(const remixapi_InstanceInfo& info);
+    Result< void >                    UpdateInstanceTransform(remixapi_InstanceHandle handle, const remixapi_Transform& transform);
+    Result< void >                    UpdateInstanceMaterial(remixapi_InstanceHandle handle, remixapi_MaterialHandle material);
+    Result< void >                    DestroyInstance(remixapi_InstanceHandle handle);
     Result< remixapi_LightHandle >    CreateLight(const remixapi_LightInfo& info);
     Result< void >                    DestroyLight(remixapi_LightHandle handle);
+    Result< void >                    UpdateLights(const remixapi_LightHandle* handles, const remixapi_LightInfo* infos, uint32_t count);
     Result< void >                    DrawLightInstance(remixapi_LightHandle handle);
     Result< void >                    SetConfigVariable(const char* key, const char* value);
 
@@ -189,12 +199,19 @@ namespace remix {
                                                                       remixapi_dxvk_CopyRenderingOutputType type);
     Result< void >                           dxvk_SetDefaultOutput(remixapi_dxvk_CopyRenderingOutputType type,
                                                                    const remixapi_Float4D& color);
+    Result< remixapi_ReadbackHandle >        dxvk_RequestReadback(remixapi_dxvk_CopyRenderingOutputType type,
+                                                                  const remixapi_Rect2D* region = nullptr);
+    // Returns false while the copy is in flight
+    Result< bool >                           dxvk_GetReadback(remixapi_ReadbackHandle handle, remixapi_ReadbackData& out_data);
+    Result< void >                           dxvk_DestroyReadback(remixapi_ReadbackHandle handle);
     // Object picking utils
     template< typename CallbackLambda > // void( remix::Span<uint32_t> objectPickingValues )
     Result< void >                           pick_RequestObjectPicking(const Rect2D& region, CallbackLambda &&callback);
     Result< void >                           pick_HighlightObjects(const uint32_t* objectPickingValues_values,
                                                                    uint32_t objectPickingValues_count,
                                                                    uint8_t colorR, uint8_t colorG, uint8_t colorB);
+    Result< void >                           pick_HighlightObjectAtPixel(int32_t pixelX, int32_t pixelY,
+                                                                         uint8_t colorR, uint8_t colorG, uint8_t colorB);
     Result<UIState> GetUIState();
     Result<void> SetUIState(UIState state);
   };
@@ -216,7 +233,7 @@ namespace remix {
         return status;
       }
 
-      static_assert(sizeof(remixapi_Interface) == 184,
+      static_assert(sizeof(remixapi_Interface) == 280,
                     "Change version, update C++ wrapper when adding new functions");
 
       remix::Interface interfaceInCpp = {};
@@ -673,6 +690,38 @@ namespace remix {
     return m_CInterface.DestroyMesh(handle);
   }
 
+  inline Result< remixapi_MeshHandle > Interface::CreateMeshAsync(const remixapi_MeshInfo& info) {
+    if (!m_CInterface.CreateMeshAsync) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    remixapi_MeshHandle handle = nullptr;
+    remixapi_ErrorCode status = m_CInterface.CreateMeshAsync(&info, &handle);
+    if (status != REMIXAPI_ERROR_CODE_SUCCESS) {
+      return status;
+    }
+    return handle;
+  }
+
+  inline Result< bool > Interface::IsMeshReady(remixapi_MeshHandle handle) {
+    if (!m_CInterface.IsMeshReady) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    remixapi_Bool ready = false;
+    remixapi_ErrorCode status = m_CInterface.IsMeshReady(handle, &ready);
+    if (status != REMIXAPI_ERROR_CODE_SUCCESS) {
+      return status;
+    }
+    return ready != 0;
+  }
+
+  inline Result< void > Interface::UpdateMeshVertices(remixapi_MeshHandle handle, uint32_t surfaceIndex, uint64_t firstVertex,
+                                                      const remixapi_HardcodedVertex* vertices_values, uint64_t vertices_count) {
+    if (!m_CInterface.UpdateMeshVertices) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.UpdateMeshVertices(handle, surfaceIndex, firstVertex, vertices_values, vertices_count);
+  }
+
 
 
   using CameraType = remixapi_CameraType;
@@ -772,6 +821,46 @@ namespace remix {
     return m_CInterface.DrawInstance(&info);
   }
 
+  inline Result< void > Interface::DrawInstances(const remixapi_InstanceInfo* infos, uint32_t infos_count) {
+    if (!m_CInterface.DrawInstances) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.DrawInstances(infos, infos_count);
+  }
+
+  inline Result< remixapi_InstanceHandle > Interface::CreateInstance(const remixapi_InstanceInfo& info) {
+    if (!m_CInterface.CreateInstance) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    remixapi_InstanceHandle handle = nullptr;
+    remixapi_ErrorCode status = m_CInterface.CreateInstance(&info, &handle);
+    if (status != REMIXAPI_ERROR_CODE_SUCCESS) {
+      return status;
+    }
+    return handle;
+  }
+
+  inline Result< void > Interface::UpdateInstanceTransform(remixapi_InstanceHandle handle, const remixapi_Transform& transform) {
+    if (!m_CInterface.UpdateInstanceTransform) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.UpdateInstanceTransform(handle, &transform);
+  }
+
+  inline Result< void > Interface::UpdateInstanceMaterial(remixapi_InstanceHandle handle, remixapi_MaterialHandle material) {
+    if (!m_CInterface.UpdateInstanceMaterial) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.UpdateInstanceMaterial(handle, material);
+  }
+
+  inline Result< void > Interface::DestroyInstance(remixapi_InstanceHandle handle) {
+    if (!m_CInterface.DestroyInstance) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.DestroyInstance(handle);
+  }
+
 
 
   namespace detail {
@@ -947,6 +1036,13 @@ namespace remix {
     return m_CInterface.DestroyLight(handle);
   }
 
+  inline Result< void > Interface::UpdateLights(const remixapi_LightHandle* handles, const remixapi_LightInfo* infos, uint32_t count) {
+    if (!m_CInterface.UpdateLights) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.UpdateLights(handles, infos, count);
+  }
+
   inline Result< void > Interface::DrawLightInstance(remixapi_LightHandle handle) {
     return m_CInterface.DrawLightInstance(handle);
   }
@@ -1007,6 +1103,38 @@ namespace remix {
     return m_CInterface.dxvk_SetDefaultOutput(type, &color);
   }
 
+  inline Result< remixapi_ReadbackHandle > Interface::dxvk_RequestReadback(
+      remixapi_dxvk_CopyRenderingOutputType type, const remixapi_Rect2D* region) {
+    if (!m_CInterface.dxvk_RequestReadback) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    remixapi_ReadbackHandle handle = nullptr;
+    remixapi_ErrorCode status = m_CInterface.dxvk_RequestReadback(type, region, &handle);
+    if (status != REMIXAPI_ERROR_CODE_SUCCESS) {
+      return status;
+    }
+    return handle;
+  }
+
+  inline Result< bool > Interface::dxvk_GetReadback(remixapi_ReadbackHandle handle, remixapi_ReadbackData& out_data) {
+    if (!m_CInterface.dxvk_GetReadback) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    remixapi_Bool ready = false;
+    remixapi_ErrorCode status = m_CInterface.dxvk_GetReadback(handle, &ready, &out_data);
+    if (status != REMIXAPI_ERROR_CODE_SUCCESS) {
+      return status;
+    }
+    return ready != 0;
+  }
+
+  inline Result< void > Interface::dxvk_DestroyReadback(remixapi_ReadbackHandle handle) {
+    if (!m_CInterface.dxvk_DestroyReadback) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.dxvk_DestroyReadback(handle);
+  }
+
   template< typename CallbackLambda >
   inline Result< void > Interface::pick_RequestObjectPicking(const Rect2D& region, CallbackLambda&& callback) {
     using Func = std::function< void(Span<uint32_t>) >;
@@ -1035,4 +1163,12 @@ namespace remix {
                                               objectPickingValues_count,
                                               colorR, colorG, colorB);
   }
+
+  inline Result< void > Interface::pick_HighlightObjectAtPixel(int32_t pixelX, int32_t pixelY,
+                                                               uint8_t colorR, uint8_t colorG, uint8_t colorB) {
+    if (!m_CInterface.pick_HighlightObjectAtPixel) {
+      return REMIXAPI_ERROR_CODE_NOT_INITIALIZED;
+    }
+    return m_CInterface.pick_HighlightObjectAtPixel(pixelX, pixelY, colorR, colorG, colorB);
+  }
 }
@@ -54,7 +54,7 @@
 
 #define REMIXAPI_VERSION_MAJOR 0
 #define REMIXAPI_VERSION_MINOR 5
-#define REMIXAPI_VERSION_PATCH 1
+#define REMIXAPI_VERSION_PATCH 2
 
 
 // External
@@ -159,6 +159,7 @@ extern "C" {
   typedef struct remixapi_MaterialHandle_T* remixapi_MaterialHandle;
   typedef struct remixapi_MeshHandle_T* remixapi_MeshHandle;
   typedef struct remixapi_LightHandle_T* remixapi_LightHandle;
+  typedef struct remixapi_InstanceHandle_T* remixapi_InstanceHandle;
 
   typedef const wchar_t* remixapi_Path;
 
@@ -318,6 +319,26 @@ extern "C" {
     const remixapi_MeshInfo*  info,
     remixapi_MeshHandle*      out_handle);
 
+  // Same as CreateMesh, but only copies the source data before returning. The mesh's buffers are
+  // created on a separate thread, and instances of the mesh are drawn once that has finished,
+  // which can be checked with IsMeshReady.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_CreateMeshAsync)(
+    const remixapi_MeshInfo*  info,
+    remixapi_MeshHandle*      out_handle);
+
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_IsMeshReady)(
+    remixapi_MeshHandle       handle,
+    remixapi_Bool*            out_ready);
+
+  // Overwrites 'vertices_count' vertices of the surface at 'surfaceIndex', starting at 'firstVertex'.
+  // The index data is kept, so the acceleration structure of the surface is refit instead of rebuilt.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_UpdateMeshVertices)(
+    remixapi_MeshHandle             handle,
+    uint32_t                        surfaceIndex,
+    uint64_t                        firstVertex,
+    const remixapi_HardcodedVertex* vertices_values,
+    uint64_t                        vertices_count);
+
   typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DestroyMesh)(
     remixapi_MeshHandle       handle);
 
@@ -439,6 +460,30 @@ extern "C" {
   typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DrawInstance)(
     const remixapi_InstanceInfo* info);
 
+  // Same as DrawInstance for each element of 'infos', but submitted to the renderer at once.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DrawInstances)(
+    const remixapi_InstanceInfo* infos,
+    uint32_t                     infos_count);
+
+  // Retained instance, drawn every frame by the renderer until it's destroyed.
+  // Unlike DrawInstance, it needs to be resubmitted only when something about it changes.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_CreateInstance)(
+    const remixapi_InstanceInfo* info,
+    remixapi_InstanceHandle*     out_handle);
+
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_UpdateInstanceTransform)(
+    remixapi_InstanceHandle      handle,
+    const remixapi_Transform*    transform);
+
+  // Replaces the materials of all of the mesh's surfaces for this instance.
+  // NULL material restores the materials the mesh was created with.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_UpdateInstanceMaterial)(
+    remixapi_InstanceHandle      handle,
+    remixapi_MaterialHandle      material);
+
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DestroyInstance)(
+    remixapi_InstanceHandle      handle);
+
 
 
   typedef struct remixapi_LightInfoLightShaping {
@@ -561,6 +606,14 @@ extern "C" {
   typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DestroyLight)(
     remixapi_LightHandle      handle);
 
+  // Creates or updates 'count' lights in place, handles[i] gets infos[i]. An updated light keeps
+  // its identity, so the Renderer can keep reusing its samples from the previous frames.
+  // Dome lights are not supported here, use CreateLight for those.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_UpdateLights)(
+    const remixapi_LightHandle* handles,
+    const remixapi_LightInfo*   infos,
+    uint32_t                    count);
+
 
   typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_DrawLightInstance)(
     remixapi_LightHandle      lightHandle);
@@ -598,6 +651,17 @@ extern "C" {
     uint8_t                   colorG,
     uint8_t                   colorB);
 
+  // Highlights the object drawn at 'pixelX', 'pixelY' in the frames being rendered, until the call stops being
+  // repeated. The object picking value is fetched from that pixel on the GPU, so unlike pick_RequestObjectPicking
+  // followed by pick_HighlightObjects there is neither a readback nor a frame of latency, e.g. for hover highlighting.
+  // The pixel is specified relative to the output size, not render size.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_pick_HighlightObjectAtPixel)(
+    int32_t                   pixelX,
+    int32_t                   pixelY,
+    uint8_t                   colorR,
+    uint8_t                   colorG,
+    uint8_t                   colorB);
+
 
 
   typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_dxvk_CreateD3D9)(
@@ -631,6 +695,34 @@ extern "C" {
     remixapi_dxvk_CopyRenderingOutputType type,
     const remixapi_Float4D* color);
 
+  typedef struct remixapi_ReadbackHandle_T* remixapi_ReadbackHandle;
+
+  typedef struct remixapi_ReadbackData {
+    const void*               data; // Valid until the readback is destroyed
+    uint32_t                  width;
+    uint32_t                  height;
+    uint32_t                  rowPitch; // In bytes
+    uint32_t                  bytesPerPixel;
+  } remixapi_ReadbackData;
+
+  // Schedules a copy of a rendering output to host memory. 'region' is in output image pixels,
+  // NULL for the whole image. The copy is taken from the most recently rendered frame, and completes
+  // asynchronously on the GPU, so neither the call nor the frame wait for it.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_dxvk_RequestReadback)(
+    remixapi_dxvk_CopyRenderingOutputType type,
+    const remixapi_Rect2D*                region,
+    remixapi_ReadbackHandle*              out_handle);
+
+  // Never blocks. 'out_ready' is set once the copy has completed, 'out_data' is only filled in then.
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_dxvk_GetReadback)(
+    remixapi_ReadbackHandle               handle,
+    remixapi_Bool*                        out_ready,
+    remixapi_ReadbackData*                out_data);
+
+  // Every readback has to be destroyed, its memory is reused by later readbacks
+  typedef remixapi_ErrorCode(REMIXAPI_PTR* PFN_remixapi_dxvk_DestroyReadback)(
+    remixapi_ReadbackHandle               handle);
+
 
   typedef struct remixapi_InitializeLibraryInfo {
     remixapi_StructType sType;
@@ -666,6 +758,19 @@ extern "C" {
     PFN_remixapi_Present            Present;
     remixapi_UIState                (*GetUIState)(void);
     remixapi_ErrorCode              (*SetUIState)(remixapi_UIState state);
+    PFN_remixapi_DrawInstances      DrawInstances;
+    PFN_remixapi_CreateInstance            CreateInstance;
+    PFN_remixapi_UpdateInstanceTransform   UpdateInstanceTransform;
+    PFN_remixapi_UpdateInstanceMaterial    UpdateInstanceMaterial;
+    PFN_remixapi_DestroyInstance           DestroyInstance;
+    PFN_remixapi_CreateMeshAsync           CreateMeshAsync;
+    PFN_remixapi_IsMeshReady               IsMeshReady;
+    PFN_remixapi_UpdateMeshVertices        UpdateMeshVertices;
+    PFN_remixapi_UpdateLights              UpdateLights;
+    PFN_remixapi_dxvk_RequestReadback      dxvk_RequestReadback;
+    PFN_remixapi_dxvk_GetReadback          dxvk_GetReadback;
+    PFN_remixapi_dxvk_DestroyReadback      dxvk_DestroyReadback;
+    PFN_remixapi_pick_HighlightObjectAtPixel pick_HighlightObjectAtPixel;
   } remixapi_Interface;
 
   REMIXAPI remixapi_ErrorCode REMIXAPI_CALL remixapi_InitializeLibrary(
@@ -113,8 +113,14 @@ namespace dxvk {
         info.access |= VK_ACCESS_HOST_READ_BIT;
 
       memoryFlags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                  | VK_MEMORY_PROPERTY_HOST_CACHED_BIT
                   | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+      // NV-DXVK start: uncached dynamic buffers
+      // Without the cached bit the allocator picks host-visible VRAM (resizable BAR) when there is any, and
+      // uncached system memory otherwise, which the GPU reads directly but the CPU can only read slowly.
+      if (m_parent->GetOptions()->cachedDynamicBuffers || !(m_desc.Usage & D3DUSAGE_WRITEONLY))
+        memoryFlags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+      // NV-DXVK end
     }
     else {
       info.access |= VK_ACCESS_TRANSFER_WRITE_BIT;
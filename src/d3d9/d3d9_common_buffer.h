@@ -4,6 +4,10 @@
 #include "d3d9_format.h"
 #include "../dxvk/dxvk_buffer.h"
 #include "../util/util_memoization.h"
+#include "../dxvk/rtx_render/rtx_hashing.h"
+
+#include <atomic>
+#include <memory>
 
 namespace dxvk {
 
@@ -210,12 +214,57 @@ namespace dxvk {
     }
 
     // NV-DXVK start: Implement memoization for some expensive CPU operations
+    /**
+     * \brief Memoized geometry hash
+     *
+     * Shared between a memoized result and the geometry worker that computes
+     * the hash, stays empty until the worker publishes it.
+     */
+    struct RemixMemoizedHash {
+      std::atomic<XXH64_hash_t> hash { kEmptyHash };
+    };
+
     struct RemixIndexBufferMemoizationData {
       DxvkBufferSlice slice;
       uint32_t min, max;
+      // Unique for every memoized index range, identifies the indices vertex hashes were computed over
+      uint64_t id = 0;
+      std::shared_ptr<RemixMemoizedHash> indicesHash;
+      std::shared_ptr<RemixMemoizedHash> legacyIndicesHash;
     };
     using RemixIboMemoizer = MemoryRegionMemoizer<RemixIndexBufferMemoizationData>;
     RemixIboMemoizer remixMemoization;
+
+    /**
+     * \brief Memoized hash of a vertex element over a vertex range
+     *
+     * Every vertex range can be drawn with several index ranges and vertex
+     * declarations, each combination gets its own hash.
+     */
+    struct RemixVertexHashEntry {
+      uint64_t indicesId; // 0 for non-indexed draws
+      uint32_t elementOffset;
+      uint32_t stride;
+      VkFormat format;
+      std::shared_ptr<RemixMemoizedHash> hash;
+    };
+    using RemixVertexHashMemoizer = MemoryRegionMemoizer<std::shared_ptr<std::vector<RemixVertexHashEntry>>>;
+    RemixVertexHashMemoizer remixVertexHashMemoization;
+
+    /**
+     * \brief Write version of the buffer contents
+     *
+     * Incremented whenever the whole buffer is rewritten (discarded),
+     * partial writes invalidate only memoized results of the locked range.
+     * \returns Current write version
+     */
+    uint64_t GetRemixWriteVersion() const {
+      return m_remixWriteVersion;
+    }
+
+    void IncrementRemixWriteVersion() {
+      ++m_remixWriteVersion;
+    }
     // NV-DXVK end
 
   private:
@@ -253,6 +302,10 @@ namespace dxvk {
 
     uint64_t                    m_seq = 0ull;
 
+    // NV-DXVK start: Implement memoization for some expensive CPU operations
+    uint64_t                    m_remixWriteVersion = 0ull;
+    // NV-DXVK end
+
   };
 
 }
\ No newline at end of file
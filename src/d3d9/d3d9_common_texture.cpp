@@ -93,6 +93,11 @@ namespace dxvk {
     if (m_size != 0)
       m_device->ChangeReportedMemory(m_size);
 
+    // NV-DXVK start: asynchronous texture hashing
+    // The worker may still be reading the staging buffer
+    ResolvePendingHash();
+    // NV-DXVK end
+
     // Release this texture from ImGUI 
     if (m_image != nullptr) {
       if (m_image->getHash() != 0) {
@@ -658,7 +663,7 @@ namespace dxvk {
     if (m_type != D3DRTYPE_TEXTURE || (m_desc.Usage & D3DUSAGE_DEPTHSTENCIL))
       return;
 
-    if (m_image->getHash() != 0) {
+    if (m_image->getHash() != 0 || HasPendingHash()) {
       // Already setup.
       return;
     }
@@ -674,6 +679,17 @@ namespace dxvk {
     const bool useObsoleteHashMethod = NeedsUpload(subresource) &&
       RtxOptions::useObsoleteHashOnTextureUpload();
 
+    // Hash our own buffer on a worker thread, the texture resolves the hash before the buffer is written to again.
+    // Render target hashes are expected to be known once the texture exists, see CreateSampleView.
+    if (source == this && !IsRenderTarget()) {
+      m_pendingHash = m_device->RTX().ScheduleTextureHash(this, buffer->mapPtr(0), buffer->info().size, useObsoleteHashMethod);
+
+      if (m_pendingHash.valid()) {
+        m_pendingHashBuffer = buffer;
+        return;
+      }
+    }
+
     // Generate hash from CPU buffer
     XXH64_hash_t imageHash;
 
@@ -682,6 +698,24 @@ namespace dxvk {
     } else {
       imageHash = XXH3_64bits(buffer->mapPtr(0), buffer->info().size);
     }
+
+    SetImageHash(imageHash);
+  }
+
+  void D3D9CommonTexture::ResolvePendingHash() {
+    if (likely(m_pendingHashBuffer == nullptr)) {
+      return;
+    }
+
+    const XXH64_hash_t imageHash = m_pendingHash.get();
+
+    m_device->RTX().OnTextureHashResolved(this, m_pendingHashBuffer->info().size);
+    m_pendingHashBuffer = nullptr;
+
+    SetImageHash(imageHash);
+  }
+
+  void D3D9CommonTexture::SetImageHash(XXH64_hash_t imageHash) {
     // save hash to dxvkImage
     m_image->setHash(imageHash);
 
@@ -700,4 +734,15 @@ namespace dxvk {
     SetupForRtxFrom(this);
   }
 
+  // NV-DXVK start: reuse mip generators across mip updates
+  const Rc<DxvkMetaMipGenRenderPass>& D3D9CommonTexture::GetMipGenerator() {
+    const Rc<DxvkImageView>& view = GetSampleView(false);
+
+    if (m_mipGenerator == nullptr || m_mipGenerator->view() != view)
+      m_mipGenerator = new DxvkMetaMipGenRenderPass(m_device->GetDXVKDevice()->vkd(), view);
+
+    return m_mipGenerator;
+  }
+  // NV-DXVK end
+
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "../dxvk/dxvk_device.h"
 
 #include "../util/util_bit.h"
+#include "../util/util_threadpool.h"
 
 namespace dxvk {
 
@@ -404,11 +405,36 @@ namespace dxvk {
     void SetMipFilter(D3DTEXTUREFILTERTYPE filter) { m_mipFilter = filter; }
     D3DTEXTUREFILTERTYPE GetMipFilter() const { return m_mipFilter; }
 
+    // NV-DXVK start: reuse mip generators across mip updates
+    /**
+     * \brief Mip generator for the sample view
+     *
+     * Created on first use and kept with the texture, render
+     * targets and dynamic textures get their mips regenerated
+     * every time they are written to.
+     */
+    const Rc<DxvkMetaMipGenRenderPass>& GetMipGenerator();
+    // NV-DXVK end
+
     void PreLoadAll();
     void PreLoadSubresource(UINT Subresource);
 
     void SetupForRtx();
     void SetupForRtxFrom(const D3D9CommonTexture* source);
+
+    /**
+     * \brief Waits for a content hash scheduled by SetupForRtx
+     *
+     * The hash is applied to the image, and the staging
+     * buffer it was computed from is no longer held on to.
+     * Has to be called before the hash is used and before
+     * the staging buffer is written to again.
+     */
+    void ResolvePendingHash();
+
+    bool HasPendingHash() const {
+      return m_pendingHashBuffer != nullptr;
+    }
     
     void AddDirtyBox(CONST D3DBOX* pDirtyBox, uint32_t layer) {
       if (pDirtyBox) {
@@ -521,6 +547,17 @@ namespace dxvk {
 
     D3DTEXTUREFILTERTYPE          m_mipFilter = D3DTEXF_LINEAR;
 
+    // NV-DXVK start: reuse mip generators across mip updates
+    Rc<DxvkMetaMipGenRenderPass>  m_mipGenerator;
+    // NV-DXVK end
+
+    // NV-DXVK start: asynchronous texture hashing
+    Future<XXH64_hash_t>          m_pendingHash;
+    Rc<DxvkBuffer>                m_pendingHashBuffer;
+
+    void SetImageHash(XXH64_hash_t imageHash);
+    // NV-DXVK end
+
     std::array<D3DBOX, 6>         m_dirtyBoxes;
 
     /**
@@ -156,10 +156,28 @@ namespace dxvk {
     // NV-DXVK start: Consolidate RTX state
     m_rtx.Initialize();
     // NV-DXVK
+
+    // NV-DXVK start: fixed function shader disk cache
+    // Fixed function shaders are only ever generated on the CS thread
+    if (m_d3d9Options.enableFixedFunctionShaderCache) {
+      EmitCs([this](DxvkContext* ctx) {
+        m_ffModules.EnableDiskCache(this);
+      });
+    }
+    // NV-DXVK end
+
+    // NV-DXVK start: DXSO translation disk cache
+    if (m_d3d9Options.enableShaderTranslationCache)
+      m_shaderModules->EnableDiskCache();
+    // NV-DXVK end
   }
 
 
   D3D9DeviceEx::~D3D9DeviceEx() {
+    // NV-DXVK start: async DXSO translation
+    m_shaderModules->StopTranslation();
+    // NV-DXVK end
+
     Flush();
     SynchronizeCsThread();
 
@@ -2267,7 +2285,9 @@ namespace dxvk {
           break;
 
         case D3DRS_SHADEMODE:
-          if (m_state.pixelShader != nullptr) {
+          // NV-DXVK start: async DXSO translation
+          if (m_state.pixelShader != nullptr && !(m_pendingShaderBinds & PixelShaderBindBit)) {
+          // NV-DXVK end
             BindShader<DxsoProgramType::PixelShader>(
               GetCommonShader(m_state.pixelShader),
               GetPixelShaderPermutation());
@@ -2602,6 +2622,11 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
+    // NV-DXVK start: async DXSO translation
+    if (unlikely(!BindPendingShaders()))
+      return D3D_OK;
+    // NV-DXVK end
+
     // NV-DXVK start: geometry processing
     const D3D9Rtx::DrawContext drawContext { PrimitiveType, (INT) StartVertex, 0, 0, 0, PrimitiveCount, FALSE };
     const PrepareDrawFlags drawPrepare = m_rtx.PrepareDrawGeometryForRT(false, drawContext);
@@ -2656,6 +2681,11 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
+    // NV-DXVK start: async DXSO translation
+    if (unlikely(!BindPendingShaders()))
+      return D3D_OK;
+    // NV-DXVK end
+
     // NV-DXVK start: geometry processing
     const D3D9Rtx::DrawContext drawContext = { PrimitiveType, BaseVertexIndex, MinVertexIndex, NumVertices, StartIndex, PrimitiveCount, TRUE };
     const PrepareDrawFlags drawPrepare = m_rtx.PrepareDrawGeometryForRT(true, drawContext);
@@ -2710,6 +2740,11 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
+    // NV-DXVK start: async DXSO translation
+    if (unlikely(!BindPendingShaders()))
+      return D3D_OK;
+    // NV-DXVK end
+
     auto drawInfo = GenerateDrawInfo(PrimitiveType, PrimitiveCount, 0);
 
     const uint32_t dataSize = GetUPDataSize(drawInfo.vertexCount, VertexStreamZeroStride);
@@ -2779,6 +2814,11 @@ namespace dxvk {
     if (unlikely(!PrimitiveCount))
       return S_OK;
 
+    // NV-DXVK start: async DXSO translation
+    if (unlikely(!BindPendingShaders()))
+      return D3D_OK;
+    // NV-DXVK end
+
     auto drawInfo = GenerateDrawInfo(PrimitiveType, PrimitiveCount, 0);
 
     const uint32_t vertexDataSize = GetUPDataSize(MinVertexIndex + NumVertices, VertexStreamZeroStride);
@@ -2949,6 +2989,10 @@ namespace dxvk {
     dst->SetWrittenByGPU(true);
     TrackBufferMappingBufferSequenceNumber(dst);
 
+    // NV-DXVK start: Implement memoization for some expensive CPU operations
+    dst->IncrementRemixWriteVersion();
+    // NV-DXVK end
+
     return D3D_OK;
   }
 
@@ -3102,8 +3146,29 @@ namespace dxvk {
     if (shader == m_state.vertexShader.ptr())
       return D3D_OK;
 
-    auto* oldShader = GetCommonShader(m_state.vertexShader);
+    // NV-DXVK start: async DXSO translation
+    // Nothing of the old shader was bound if it was still pending
+    const D3D9CommonShader* oldShader = (m_pendingShaderBinds & VertexShaderBindBit)
+      ? nullptr : GetCommonShader(m_state.vertexShader);
+
+    m_state.vertexShader = shader;
+
+    if (shader != nullptr && !shader->GetCommonShader()->IsReady()) {
+      m_pendingShaderBinds |= VertexShaderBindBit;
+      return D3D_OK;
+    }
+
+    m_pendingShaderBinds &= ~VertexShaderBindBit;
+    BindVertexShaderState(oldShader);
+
+    return D3D_OK;
+  }
+
+
+  void D3D9DeviceEx::BindVertexShaderState(const D3D9CommonShader* oldShader) {
+    D3D9VertexShader* shader = m_state.vertexShader.ptr();
     auto* newShader = GetCommonShader(shader);
+    // NV-DXVK end
 
     bool oldCopies = oldShader && oldShader->GetMeta().needsConstantCopies;
     bool newCopies = newShader && newShader->GetMeta().needsConstantCopies;
@@ -3118,8 +3183,6 @@ namespace dxvk {
         || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB;
     }
 
-    m_state.vertexShader = shader;
-
     if (shader != nullptr) {
       BindShader<DxsoProgramTypes::VertexShader>(
         GetCommonShader(shader),
@@ -3131,8 +3194,6 @@ namespace dxvk {
       m_vsShaderMasks = D3D9ShaderMasks();
 
     m_flags.set(D3D9DeviceFlag::DirtyInputLayout);
-
-    return D3D_OK;
   }
 
 
@@ -3446,8 +3507,29 @@ namespace dxvk {
     if (shader == m_state.pixelShader.ptr())
       return D3D_OK;
 
-    auto* oldShader = GetCommonShader(m_state.pixelShader);
+    // NV-DXVK start: async DXSO translation
+    // Nothing of the old shader was bound if it was still pending
+    const D3D9CommonShader* oldShader = (m_pendingShaderBinds & PixelShaderBindBit)
+      ? nullptr : GetCommonShader(m_state.pixelShader);
+
+    m_state.pixelShader = shader;
+
+    if (shader != nullptr && !shader->GetCommonShader()->IsReady()) {
+      m_pendingShaderBinds |= PixelShaderBindBit;
+      return D3D_OK;
+    }
+
+    m_pendingShaderBinds &= ~PixelShaderBindBit;
+    BindPixelShaderState(oldShader);
+
+    return D3D_OK;
+  }
+
+
+  void D3D9DeviceEx::BindPixelShaderState(const D3D9CommonShader* oldShader) {
+    D3D9PixelShader* shader = m_state.pixelShader.ptr();
     auto* newShader = GetCommonShader(shader);
+    // NV-DXVK end
 
     bool oldCopies = oldShader && oldShader->GetMeta().needsConstantCopies;
     bool newCopies = newShader && newShader->GetMeta().needsConstantCopies;
@@ -3462,8 +3544,6 @@ namespace dxvk {
         || newShader->GetMeta().maxConstIndexB > oldShader->GetMeta().maxConstIndexB;
     }
 
-    m_state.pixelShader = shader;
-
     if (shader != nullptr) {
       m_flags.set(D3D9DeviceFlag::DirtyFFPixelShader);
 
@@ -3482,9 +3562,30 @@ namespace dxvk {
     }
 
     UpdateActiveHazardsRT(UINT32_MAX);
+  }
 
-    return D3D_OK;
+
+  // NV-DXVK start: async DXSO translation
+  bool D3D9DeviceEx::BindPendingShaders() {
+    if (m_pendingShaderBinds & VertexShaderBindBit) {
+      if (m_state.vertexShader != nullptr && !m_state.vertexShader->GetCommonShader()->IsReady())
+        return false;
+
+      m_pendingShaderBinds &= ~VertexShaderBindBit;
+      BindVertexShaderState(nullptr);
+    }
+
+    if (m_pendingShaderBinds & PixelShaderBindBit) {
+      if (m_state.pixelShader != nullptr && !m_state.pixelShader->GetCommonShader()->IsReady())
+        return false;
+
+      m_pendingShaderBinds &= ~PixelShaderBindBit;
+      BindPixelShaderState(nullptr);
+    }
+
+    return true;
   }
+  // NV-DXVK end
 
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::GetPixelShader(IDirect3DPixelShader9** ppShader) {
@@ -4294,6 +4395,15 @@ namespace dxvk {
     const uint32_t texturesToGen = m_activeTexturesToGen & usedTextureMask;
     if (unlikely(texturesToGen != 0))
       GenerateTextureMips(texturesToGen);
+
+    // The hashes of bound textures are about to be used
+    if (unlikely(m_rtx.HasPendingTextureHashes())) {
+      for (uint32_t idx : bit::BitMask(m_activeTextures)) {
+        if (D3D9CommonTexture* pTexInfo = GetCommonTexture(m_state.textures[idx])) {
+          pTexInfo->ResolvePendingHash();
+        }
+      }
+    }
   }
   // NV-DXVK end
 
@@ -4399,6 +4509,11 @@ namespace dxvk {
 
     if constexpr (UpBuffer) {
       memoryFlags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+      // NV-DXVK start: uncached dynamic buffers
+      if (!m_d3d9Options.cachedDynamicBuffers)
+        memoryFlags &= ~VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+      // NV-DXVK end
     }
 
     D3D9BufferSlice& currentSlice = UpBuffer ? m_upBuffer : m_managedUploadBuffer;
@@ -4564,6 +4679,11 @@ namespace dxvk {
     if (unlikely(pResource->GetLocked(Subresource)))
       return D3DERR_INVALIDCALL;
 
+    // NV-DXVK start: asynchronous texture hashing
+    // The staging buffer may still be read by a texture hashing worker
+    pResource->ResolvePendingHash();
+    // NV-DXVK end
+
     if (unlikely((Flags & (D3DLOCK_DISCARD | D3DLOCK_READONLY)) == (D3DLOCK_DISCARD | D3DLOCK_READONLY)))
       return D3DERR_INVALIDCALL;
 
@@ -4993,12 +5113,14 @@ namespace dxvk {
     if (pResource->IsManaged())
       UploadManagedTexture(pResource);
 
+    // NV-DXVK start: reuse mip generators across mip updates
     EmitCs([
-      cImageView = pResource->GetSampleView(false),
-      cFilter    = pResource->GetMipFilter()
+      cMipGenerator = pResource->GetMipGenerator(),
+      cFilter       = pResource->GetMipFilter()
     ] (DxvkContext* ctx) {
-      ctx->generateMipmaps(cImageView, DecodeFilter(cFilter));
+      ctx->generateMipmaps(cMipGenerator, DecodeFilter(cFilter));
     });
+    // NV-DXVK end
   }
 
 
@@ -5070,7 +5192,7 @@ namespace dxvk {
       pResource->GPUReadingRange().Clear();
 
       // NV-DXVK start: Implement memoization for some expensive CPU operations
-      pResource->remixMemoization.invalidateAll();
+      pResource->IncrementRemixWriteVersion();
       // NV-DXVK end
     }
     else {
@@ -5106,6 +5228,7 @@ namespace dxvk {
       // NV-DXVK start: Implement memoization for some expensive CPU operations
       if (!readOnly) {
         pResource->remixMemoization.invalidate(offset, size);
+        pResource->remixVertexHashMemoization.invalidate(offset, size);
       }
       // NV-DXVK end
     }
@@ -6979,7 +7102,27 @@ namespace dxvk {
         ? m_consts[ProgramType].meta.maxConstIndexF
         : m_consts[ProgramType].meta.maxConstIndexI;
 
-      m_consts[ProgramType].dirty |= StartRegister < maxCount;
+      // NV-DXVK start: skip redundant constant uploads
+      // Games commonly set the same constants again for every draw, so only
+      // the part of the range the current shader reads has to be compared.
+      // With float emulation the stored values may differ from the input,
+      // which simply counts as a change.
+      auto IsChanged = [&] (const auto& set) {
+        const uint32_t compareCount = std::min<uint32_t>(Count, maxCount - StartRegister);
+
+        if constexpr (ConstantType == D3D9ConstantType::Float)
+          return std::memcmp(set.fConsts[StartRegister].data, pConstantData, compareCount * sizeof(Vector4)) != 0;
+        else
+          return std::memcmp(set.iConsts[StartRegister].data, pConstantData, compareCount * sizeof(Vector4i)) != 0;
+      };
+
+      if (StartRegister < maxCount && !m_consts[ProgramType].dirty) {
+        if constexpr (ProgramType == DxsoProgramType::VertexShader)
+          m_consts[ProgramType].dirty = IsChanged(m_state.vsConsts);
+        else
+          m_consts[ProgramType].dirty = IsChanged(m_state.psConsts);
+      }
+      // NV-DXVK end
     } else if constexpr (ProgramType == DxsoProgramType::VertexShader) {
       if (unlikely(CanSWVP())) {
         m_consts[DxsoProgramType::VertexShader].dirty |= StartRegister < m_consts[ProgramType].meta.maxConstIndexB;
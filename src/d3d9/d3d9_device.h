@@ -878,6 +878,16 @@ namespace dxvk {
       const D3D9CommonShader*                 pShaderModule,
             D3D9ShaderPermutation             Permutation);
 
+    // NV-DXVK start: async DXSO translation
+    void BindVertexShaderState(const D3D9CommonShader* oldShader);
+
+    void BindPixelShaderState(const D3D9CommonShader* oldShader);
+
+    // Binds the shaders that were set while still being translated.
+    // Returns false if one of them still is, the draw is skipped then.
+    bool BindPendingShaders();
+    // NV-DXVK end
+
     void BindInputLayout();
 
     void BindVertexBuffer(
@@ -1271,6 +1281,12 @@ namespace dxvk {
     D3D9ShaderMasks                 m_vsShaderMasks = D3D9ShaderMasks();
     D3D9ShaderMasks                 m_psShaderMasks = FixedFunctionMask;
 
+    // NV-DXVK start: async DXSO translation
+    static constexpr uint32_t       VertexShaderBindBit = 1u << 0;
+    static constexpr uint32_t       PixelShaderBindBit  = 1u << 1;
+    uint32_t                        m_pendingShaderBinds = 0;
+    // NV-DXVK end
+
     bool                            m_isSWVP;
     bool                            m_amdATOC         = false;
     bool                            m_nvATOC          = false;
@@ -2801,6 +2801,10 @@ namespace dxvk {
 
     m_vsModules.insert({ShaderKey, shader});
 
+    // NV-DXVK start: fixed function shader disk cache
+    WriteCacheEntry(VK_SHADER_STAGE_VERTEX_BIT, ShaderKey);
+    // NV-DXVK end
+
     return shader;
   }
 
@@ -2818,10 +2822,127 @@ namespace dxvk {
 
     m_fsModules.insert({ShaderKey, shader});
 
+    // NV-DXVK start: fixed function shader disk cache
+    WriteCacheEntry(VK_SHADER_STAGE_FRAGMENT_BIT, ShaderKey);
+    // NV-DXVK end
+
     return shader;
   }
 
 
+  // NV-DXVK start: fixed function shader disk cache
+  namespace {
+    // Bump when the layout of the shader keys changes
+    constexpr uint32_t D3D9FFShaderCacheVersion = 1;
+
+    struct D3D9FFShaderCacheHeader {
+      char     magic[4]  = { 'D', '9', 'F', 'F' };
+      uint32_t version   = D3D9FFShaderCacheVersion;
+      uint32_t vsKeySize = sizeof(D3D9FFShaderKeyVS);
+      uint32_t fsKeySize = sizeof(D3D9FFShaderKeyFS);
+    };
+
+    std::wstring GetFFShaderCacheFileName() {
+      // Lives next to the state cache, which compiles the pipelines of the prewarmed shaders
+      std::string path = env::getEnvVar("DXVK_STATE_CACHE_PATH");
+
+      if (!path.empty() && *path.rbegin() != '/')
+        path += '/';
+
+      path += env::getExeBaseName() + ".d3d9-ff-cache";
+      return str::tows(path.c_str());
+    }
+  }
+
+
+  void D3D9FFShaderModuleSet::EnableDiskCache(
+          D3D9DeviceEx*         pDevice) {
+    const std::wstring fileName = GetFFShaderCacheFileName();
+
+    bool validFile = false;
+    uint32_t numShaders = 0;
+
+    std::ifstream ifile(fileName.c_str(), std::ios_base::binary);
+
+    D3D9FFShaderCacheHeader expected;
+    D3D9FFShaderCacheHeader header;
+
+    if (ifile && ifile.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      validFile = std::memcmp(&header, &expected, sizeof(header)) == 0;
+
+      if (!validFile)
+        Logger::warn("D3D9: Fixed function shader cache out of date, discarding");
+    }
+
+    if (validFile) {
+      uint32_t stage;
+
+      while (ifile.read(reinterpret_cast<char*>(&stage), sizeof(stage))) {
+        if (stage == VK_SHADER_STAGE_VERTEX_BIT) {
+          D3D9FFShaderKeyVS key;
+
+          if (!ifile.read(reinterpret_cast<char*>(&key), sizeof(key)))
+            break;
+
+          if (m_vsModules.find(key) == m_vsModules.end())
+            m_vsModules.insert({ key, D3D9FFShader(pDevice, key) });
+        } else if (stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+          D3D9FFShaderKeyFS key;
+
+          if (!ifile.read(reinterpret_cast<char*>(&key), sizeof(key)))
+            break;
+
+          if (m_fsModules.find(key) == m_fsModules.end())
+            m_fsModules.insert({ key, D3D9FFShader(pDevice, key) });
+        } else {
+          Logger::warn("D3D9: Corrupted fixed function shader cache entry, ignoring rest of the file");
+          break;
+        }
+
+        numShaders += 1;
+      }
+
+      Logger::info(str::format("D3D9: Prewarmed ", numShaders, " fixed function shaders"));
+    }
+
+    ifile.close();
+
+    if (validFile) {
+      m_cacheFile = std::ofstream(fileName.c_str(), std::ios_base::binary | std::ios_base::app);
+    } else {
+      m_cacheFile = std::ofstream(fileName.c_str(), std::ios_base::binary | std::ios_base::trunc);
+      m_cacheFile.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+    }
+
+    if (!m_cacheFile)
+      Logger::warn("D3D9: Failed to open fixed function shader cache for writing");
+
+    // Shaders compiled before the cache was enabled were not recorded yet
+    if (!validFile) {
+      for (const auto& entry : m_vsModules)
+        WriteCacheEntry(VK_SHADER_STAGE_VERTEX_BIT, entry.first);
+
+      for (const auto& entry : m_fsModules)
+        WriteCacheEntry(VK_SHADER_STAGE_FRAGMENT_BIT, entry.first);
+    }
+  }
+
+
+  template <typename T>
+  void D3D9FFShaderModuleSet::WriteCacheEntry(
+          VkShaderStageFlagBits Stage,
+    const T&                    ShaderKey) {
+    if (!m_cacheFile)
+      return;
+
+    const uint32_t stage = Stage;
+    m_cacheFile.write(reinterpret_cast<const char*>(&stage), sizeof(stage));
+    m_cacheFile.write(reinterpret_cast<const char*>(&ShaderKey), sizeof(ShaderKey));
+    m_cacheFile.flush();
+  }
+  // NV-DXVK end
+
+
   size_t D3D9FFShaderKeyHash::operator () (const D3D9FFShaderKeyVS& key) const {
     DxvkHashState state;
 
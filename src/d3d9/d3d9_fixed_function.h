@@ -10,6 +10,7 @@
 
 #include <unordered_map>
 #include <bitset>
+#include <fstream>
 
 namespace dxvk {
 
@@ -234,8 +235,31 @@ namespace dxvk {
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyFS&    ShaderKey);
 
+    // NV-DXVK start: fixed function shader disk cache
+    /**
+     * \brief Enables the on-disk fixed function shader cache
+     *
+     * Compiles the shaders of all keys recorded in the cache file,
+     * so that their pipelines can be compiled from the state cache
+     * ahead of use, and records the keys of every new shader from
+     * then on. Must be called on the thread using the module set.
+     * \param [in] pDevice The device to compile the shaders for
+     */
+    void EnableDiskCache(
+            D3D9DeviceEx*         pDevice);
+    // NV-DXVK end
+
   private:
 
+    // NV-DXVK start: fixed function shader disk cache
+    template <typename T>
+    void WriteCacheEntry(
+            VkShaderStageFlagBits Stage,
+      const T&                    ShaderKey);
+
+    std::ofstream m_cacheFile;
+    // NV-DXVK end
+
     std::unordered_map<
       D3D9FFShaderKeyVS,
       D3D9FFShader,
@@ -54,23 +54,11 @@ namespace dxvk {
           DxvkBufferSlice    Slice) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
+    // NV-DXVK start: Defer GPU initialization to the next flush
     m_transferCommands += 1;
 
-    m_context->clearBuffer(
-      Slice.buffer(),
-      Slice.offset(),
-      // NV-DXVK start: Mitigation to fix validation errors
-      // Hack: Use alignDown here as the clear length must be divisible by 4 but also less than the buffer size. A typical
-      // align operation will align upwards which will make this length longer than the buffer's length, so alignDown is
-      // used instead. This does have the effect of leaving up to 3 bytes of the end of the buffer non-zeroed, but given
-      // D3D9 buffers are supposed to be initialized to undefined this is probably fine for the vast majority of games (only
-      // games that incorrectly expect the buffer to be cleared and are actually touching these last few bytes will be affected,
-      // which in practice shouldn't cause any problems).
-      // Do note this hack can be removed once updating to a newer DXVK, as this fix has been integrated as part of this GitHub
-      // issue: https://github.com/doitsujin/dxvk/issues/4641
-      alignDown(Slice.length(), sizeof(uint32_t)),
-      // NV-DXVK end
-      0u);
+    m_pendingBufferClears.push_back(std::move(Slice));
+    // NV-DXVK end
 
     FlushImplicit();
   }
@@ -91,45 +79,16 @@ namespace dxvk {
           D3D9CommonTexture* pTexture) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
-    auto InitImage = [&](Rc<DxvkImage> image) {
-      if (image == nullptr)
-        return;
-
-      auto formatInfo = imageFormatInfo(image->info().format);
-
-      m_transferCommands += 1;
-      
-      // While the Microsoft docs state that resource contents are
-      // undefined if no initial data is provided, some applications
-      // expect a resource to be pre-cleared. We can only do that
-      // for non-compressed images, but that should be fine.
-      VkImageSubresourceRange subresources;
-      subresources.aspectMask     = formatInfo->aspectMask;
-      subresources.baseMipLevel   = 0;
-      subresources.levelCount     = image->info().mipLevels;
-      subresources.baseArrayLayer = 0;
-      subresources.layerCount     = image->info().numLayers;
-
-      if (formatInfo->flags.test(DxvkFormatFlag::BlockCompressed)) {
-        m_context->clearCompressedColorImage(image, subresources);
-      } else {
-        if (subresources.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT) {
-          VkClearColorValue value = { };
+    // NV-DXVK start: Defer GPU initialization to the next flush
+    Rc<DxvkImage> image = pTexture->GetImage();
 
-          m_context->clearColorImage(
-            image, value, subresources);
-        } else {
-          VkClearDepthStencilValue value;
-          value.depth   = 0.0f;
-          value.stencil = 0;
-          
-          m_context->clearDepthStencilImage(
-            image, value, subresources);
-        }
-      }
-    };
+    if (image == nullptr)
+      return;
 
-    InitImage(pTexture->GetImage());
+    m_transferCommands += 1;
+
+    m_pendingImageClears.push_back(std::move(image));
+    // NV-DXVK end
 
     FlushImplicit();
   }
@@ -183,7 +142,76 @@ namespace dxvk {
   }
 
 
+  // NV-DXVK start: Defer GPU initialization to the next flush
+  void D3D9Initializer::ClearBuffer(
+    const DxvkBufferSlice&   Slice) {
+    m_context->clearBuffer(
+      Slice.buffer(),
+      Slice.offset(),
+      // Mitigation to fix validation errors
+      // Hack: Use alignDown here as the clear length must be divisible by 4 but also less than the buffer size. A typical
+      // align operation will align upwards which will make this length longer than the buffer's length, so alignDown is
+      // used instead. This does have the effect of leaving up to 3 bytes of the end of the buffer non-zeroed, but given
+      // D3D9 buffers are supposed to be initialized to undefined this is probably fine for the vast majority of games (only
+      // games that incorrectly expect the buffer to be cleared and are actually touching these last few bytes will be affected,
+      // which in practice shouldn't cause any problems).
+      // Do note this hack can be removed once updating to a newer DXVK, as this fix has been integrated as part of this GitHub
+      // issue: https://github.com/doitsujin/dxvk/issues/4641
+      alignDown(Slice.length(), sizeof(uint32_t)),
+      0u);
+  }
+
+
+  void D3D9Initializer::ClearImage(
+    const Rc<DxvkImage>&     Image) {
+    auto formatInfo = imageFormatInfo(Image->info().format);
+
+    // While the Microsoft docs state that resource contents are
+    // undefined if no initial data is provided, some applications
+    // expect a resource to be pre-cleared. We can only do that
+    // for non-compressed images, but that should be fine.
+    VkImageSubresourceRange subresources;
+    subresources.aspectMask     = formatInfo->aspectMask;
+    subresources.baseMipLevel   = 0;
+    subresources.levelCount     = Image->info().mipLevels;
+    subresources.baseArrayLayer = 0;
+    subresources.layerCount     = Image->info().numLayers;
+
+    if (formatInfo->flags.test(DxvkFormatFlag::BlockCompressed)) {
+      m_context->clearCompressedColorImage(Image, subresources);
+    } else {
+      if (subresources.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT) {
+        VkClearColorValue value = { };
+
+        m_context->clearColorImage(
+          Image, value, subresources);
+      } else {
+        VkClearDepthStencilValue value;
+        value.depth   = 0.0f;
+        value.stencil = 0;
+
+        m_context->clearDepthStencilImage(
+          Image, value, subresources);
+      }
+    }
+  }
+  // NV-DXVK end
+
+
   void D3D9Initializer::FlushInternal() {
+    // NV-DXVK start: Defer GPU initialization to the next flush
+    ScopedCpuProfileZone();
+
+    for (const DxvkBufferSlice& slice : m_pendingBufferClears)
+      ClearBuffer(slice);
+
+    for (const Rc<DxvkImage>& image : m_pendingImageClears)
+      ClearImage(image);
+
+    m_pendingBufferClears.clear();
+    m_pendingImageClears.clear();
+    // NV-DXVK end
+
     m_context->flushCommandList();
     
     m_transferCommands = 0;
@@ -41,6 +41,13 @@ namespace dxvk {
     size_t            m_transferCommands  = 0;
     size_t            m_transferMemory    = 0;
 
+    // NV-DXVK start: Defer GPU initialization to the next flush
+    // Clears of device local resources are only recorded once the batch is
+    // flushed, which is always before the device submits any work using them
+    std::vector<DxvkBufferSlice> m_pendingBufferClears;
+    std::vector<Rc<DxvkImage>>   m_pendingImageClears;
+    // NV-DXVK end
+
     void InitDeviceLocalBuffer(
             DxvkBufferSlice    Slice);
 
@@ -54,6 +61,14 @@ namespace dxvk {
             D3D9CommonTexture* pTexture,
             void*              pInitialData);
     
+    // NV-DXVK start: Defer GPU initialization to the next flush
+    void ClearBuffer(
+      const DxvkBufferSlice&   Slice);
+
+    void ClearImage(
+      const Rc<DxvkImage>&     Image);
+    // NV-DXVK end
+
     void FlushImplicit();
     void FlushInternal();
 
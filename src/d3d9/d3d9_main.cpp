@@ -126,6 +126,7 @@ extern "C" {
 #include <remix/remix_c.h>
 #include "../util/util_messagechannel.h"
 #include "../util/util_version.h"
+#include "../dxvk/rtx_render/rtx_reflex.h"
 
 // https://stackoverflow.com/a/27490954
 constexpr bool strings_equal(char const * a, char const * b) {
@@ -150,6 +151,10 @@ extern "C" {
       {
         return version::fileSysV;
       }
+      case version::BridgeFrameTimes:
+      {
+        return version::bridgeFrameTimesV;
+      }
       default:
       {
         dxvk::Logger::err(dxvk::str::format("Could not find feature version for: ", feat));
@@ -159,6 +164,14 @@ extern "C" {
   }
 }
 
+extern "C" {
+  DLLEXPORT void __stdcall SetBridgeFrameTimes(uint64_t simulationStart, uint64_t simulationEnd, uint64_t presentReceived) {
+    static_assert(strings_equal(__func__, version::SetBridgeFrameTimesFuncName));
+    static_assert(std::is_same_v< decltype(&SetBridgeFrameTimes), version::SetBridgeFrameTimesFunc >);
+    dxvk::RtxReflex::setBridgeFrameTimes({ simulationStart, simulationEnd, presentReceived });
+  }
+}
+
 void dummy() {
   // need to reference a function so it's exported from d3d9.dll
   remixapi_InitializeLibrary(nullptr, nullptr);
@@ -102,11 +102,26 @@ namespace dxvk {
     this->alphaTestWiggleRoom           = config.getOption<bool>        ("d3d9.alphaTestWiggleRoom",           false);
     this->apitraceMode                  = config.getOption<bool>        ("d3d9.apitraceMode",                  false);
     this->deviceLocalConstantBuffers    = config.getOption<bool>        ("d3d9.deviceLocalConstantBuffers",    false);
+    // NV-DXVK start: uncached dynamic buffers
+    this->cachedDynamicBuffers          = config.getOption<bool>        ("d3d9.cachedDynamicBuffers",          true);
+    // NV-DXVK end
     this->maxEnabledLights              = config.getOption<int32_t>     ("d3d9.maxEnabledLights",              caps::MaxEnabledLights);
     // NV-DXVK start: adapter override conf
     this->adapterOverride = config.getOption<int32_t>("d3d9.adapterOverride", -1);
     // NV-DXVK end
 
+    // NV-DXVK start: fixed function shader disk cache
+    this->enableFixedFunctionShaderCache = config.getOption<bool>("d3d9.enableFixedFunctionShaderCache", true);
+    // NV-DXVK end
+
+    // NV-DXVK start: async DXSO translation
+    this->asyncShaderTranslation = config.getOption<bool>("d3d9.asyncShaderTranslation", false);
+    // NV-DXVK end
+
+    // NV-DXVK start: DXSO translation disk cache
+    this->enableShaderTranslationCache = config.getOption<bool>("d3d9.enableShaderTranslationCache", true);
+    // NV-DXVK end
+
     // If we are not Nvidia, enable general hazards.
     this->generalHazards = adapter != nullptr
                         && !adapter->matchesDriver(
@@ -193,10 +193,33 @@ namespace dxvk {
     /// Use device local memory for constant buffers.
     bool deviceLocalConstantBuffers;
 
+    // NV-DXVK start: uncached dynamic buffers
+    /// Keep dynamic write-only buffers and the UP buffer in cached memory
+    bool cachedDynamicBuffers;
+    // NV-DXVK end
+
     // NV-DXVK start: adapter override conf
     /// Override the adapter/GPU used for D3D9 (-1 = use application defined)
     int adapterOverride;
     // NV-DXVK end
+
+    // NV-DXVK start: fixed function shader disk cache
+    /// Record the keys of generated fixed function shaders on disk,
+    /// and generate those shaders again at device creation.
+    bool enableFixedFunctionShaderCache;
+    // NV-DXVK end
+
+    // NV-DXVK start: async DXSO translation
+    /// Translate shaders on worker threads, draws using a
+    /// shader that isn't translated yet are skipped.
+    bool asyncShaderTranslation;
+    // NV-DXVK end
+
+    // NV-DXVK start: DXSO translation disk cache
+    /// Store translated shaders on disk, so that
+    /// later runs don't have to translate them again.
+    bool enableShaderTranslationCache;
+    // NV-DXVK end
   };
 
 }
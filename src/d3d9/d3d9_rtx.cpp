@@ -14,6 +14,7 @@
 #include "d3d9_rtx_utils.h"
 #include "d3d9_texture.h"
 #include "../dxvk/rtx_render/rtx_terrain_baker.h"
+#include "../dxvk/rtx_render/rtx_thread_budget.h"
 
 namespace dxvk {
   static const bool s_isDxvkResolutionEnvVarSet = (env::getEnvVar("DXVK_RESOLUTION_WIDTH") != "") || (env::getEnvVar("DXVK_RESOLUTION_HEIGHT") != "");
@@ -26,9 +27,11 @@ namespace dxvk {
 
   D3D9Rtx::D3D9Rtx(D3D9DeviceEx* d3d9Device, bool enableDrawCallConversion)
     : m_rtStagingData(d3d9Device->GetDXVKDevice(), "RtxStagingDataAlloc: D3D9", (VkMemoryPropertyFlagBits) (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    , m_vertexCapturePool(d3d9Device->GetDXVKDevice().ptr())
     , m_parent(d3d9Device)
     , m_enableDrawCallConversion(enableDrawCallConversion)
-    , m_pGeometryWorkers(enableDrawCallConversion ? std::make_unique<GeometryProcessor>(numGeometryProcessingThreads(), "geometry-processing") : nullptr) {
+    , m_pGeometryWorkers(enableDrawCallConversion ? std::make_unique<GeometryProcessor>(RtxThreadBudget::getThreadCount(ThreadClass::FrameCritical, numGeometryProcessingThreads()), "geometry-processing") : nullptr)
+    , m_pTextureHashWorkers(enableDrawCallConversion ? std::make_unique<TextureHashProcessor>(1, "texture-hashing") : nullptr) {
 
     // Add space for 256 objects skinned with 256 bones each.
     m_stagedBones.resize(256 * 256);
@@ -78,7 +81,7 @@ namespace dxvk {
   }
 
   template<typename T>
-  DxvkBufferSlice D3D9Rtx::processIndexBuffer(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx, uint32_t& minIndex, uint32_t& maxIndex) {
+  void D3D9Rtx::processIndexBuffer(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx, ProcessedIndices& result) {
     ScopedCpuProfileZone();
 
     const uint32_t indexStride = sizeof(T);
@@ -106,17 +109,62 @@ namespace dxvk {
     if (enableIndexBufferMemoization() && indexCtx.ibo != nullptr) {
       // If we have an index buffer, we can utilize memoization
       D3D9CommonBuffer::RemixIboMemoizer& memoization = indexCtx.ibo->remixMemoization;
-      const auto result = memoization.memoize(indexOffset, numIndexBytes, processing);
-      minIndex = result.min;
-      maxIndex = result.max;
-      return result.slice;
+      const auto memoized = memoization.memoize(indexOffset, numIndexBytes, indexCtx.ibo->GetRemixWriteVersion(), [&processing](const size_t offset, const size_t size) {
+        // Ids start at 1, 0 is used by non-indexed draws
+        static std::atomic<uint64_t> s_nextMemoId = 1;
+
+        auto data = processing(offset, size);
+        data.id = s_nextMemoId++;
+        data.indicesHash = std::make_shared<D3D9CommonBuffer::RemixMemoizedHash>();
+        data.legacyIndicesHash = std::make_shared<D3D9CommonBuffer::RemixMemoizedHash>();
+        return data;
+      });
+      result.slice = memoized.slice;
+      result.minIndex = memoized.min;
+      result.maxIndex = memoized.max;
+      result.memoId = memoized.id;
+      result.indicesHash = memoized.indicesHash;
+      result.legacyIndicesHash = memoized.legacyIndicesHash;
+      return;
     }
 
     // No index buffer (so no memoization) - this could be a DrawPrimitiveUP call (where IB data is passed inline)
-    const auto result = processing(indexOffset, numIndexBytes);
-    minIndex = result.min;
-    maxIndex = result.max;
-    return result.slice;
+    const auto processed = processing(indexOffset, numIndexBytes);
+    result.slice = processed.slice;
+    result.minIndex = processed.min;
+    result.maxIndex = processed.max;
+  }
+
+  D3D9Rtx::ProcessedIndices D3D9Rtx::processIndices(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx) {
+    ProcessedIndices result;
+    if (indexCtx.indexType == VK_INDEX_TYPE_UINT16)
+      processIndexBuffer<uint16_t>(indexCount, startIndex, indexCtx, result);
+    else
+      processIndexBuffer<uint32_t>(indexCount, startIndex, indexCtx, result);
+    return result;
+  }
+
+  static std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> memoizeVertexHash(D3D9CommonBuffer* pVBO, const uint32_t vertexOffset, const uint32_t numVertexBytes,
+                                                                              const uint64_t indicesId, const RasterBuffer& buffer) {
+    // Bounds the number of index ranges and vertex declarations remembered per vertex range
+    static constexpr size_t kMaxHashesPerRange = 8;
+
+    auto entries = pVBO->remixVertexHashMemoization.memoize(vertexOffset, numVertexBytes, pVBO->GetRemixWriteVersion(), [](const size_t, const size_t) {
+      return std::make_shared<std::vector<D3D9CommonBuffer::RemixVertexHashEntry>>();
+    });
+
+    for (const auto& entry : *entries) {
+      if (entry.indicesId == indicesId && entry.elementOffset == buffer.offsetFromSlice() && entry.stride == buffer.stride() && entry.format == buffer.vertexFormat()) {
+        return entry.hash;
+      }
+    }
+
+    if (entries->size() >= kMaxHashesPerRange) {
+      entries->erase(entries->begin());
+    }
+
+    entries->push_back({ indicesId, buffer.offsetFromSlice(), buffer.stride(), buffer.vertexFormat(), std::make_shared<D3D9CommonBuffer::RemixMemoizedHash>() });
+    return entries->back().hash;
   }
 
   DxvkBufferSlice allocVertexCaptureBuffer(DxvkDevice* pDevice, const VkDeviceSize size) {
@@ -128,7 +176,7 @@ namespace dxvk {
     return DxvkBufferSlice(pDevice->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::AppBuffer, "Vertex Capture Buffer"));
   }
 
-  void D3D9Rtx::prepareVertexCapture(const int vertexIndexOffset) {
+  void D3D9Rtx::prepareVertexCapture(const int vertexIndexOffset, const bool discardRasterization) {
     ScopedCpuProfileZone();
 
     struct CapturedVertex {
@@ -159,7 +207,8 @@ namespace dxvk {
     const uint32_t stride = sizeof(CapturedVertex);
     const size_t vertexCaptureDataSize = align(geoData.vertexCount * stride, CACHE_LINE_SIZE);
 
-    DxvkBufferSlice slice = allocVertexCaptureBuffer(m_parent->GetDXVKDevice().ptr(), vertexCaptureDataSize);
+    DxvkBufferSlice slice = useVertexCaptureBufferPool() ? m_vertexCapturePool.alloc(vertexCaptureDataSize)
+                                                         : allocVertexCaptureBuffer(m_parent->GetDXVKDevice().ptr(), vertexCaptureDataSize);
 
     geoData.positionBuffer = RasterBuffer(slice, 0, stride, VK_FORMAT_R32G32B32A32_SFLOAT);
     assert(geoData.positionBuffer.offset() % 4 == 0);
@@ -192,6 +241,7 @@ namespace dxvk {
     data.projectionToWorld = inverse(ObjectToProjection);
     data.normalTransform = m_activeDrawCallState.transformData.objectToWorld;
     data.baseVertex = (uint32_t)std::max(0, vertexIndexOffset);
+    data.discardRasterization = discardRasterization ? 1 : 0;
 
     m_parent->EmitCs([cVertexDataSlice = slice,
                       cConstantBuffer = m_vsVertexCaptureData,
@@ -203,9 +253,23 @@ namespace dxvk {
       // customWorldToProjection is not invalidated as its use is controlled by D3D9SpecConstantId::CustomVertexTransformEnabled being enabled
       ctx->bindResourceBuffer(getVertexCaptureBufferSlot(), cVertexDataSlice);
     });
+
+    m_vertexCapturePrepared = true;
   }
 
-  void D3D9Rtx::processVertices(const VertexContext vertexContext[caps::MaxStreams], int vertexIndexOffset, RasterGeometry& geoData) {
+  void D3D9Rtx::setVertexCaptureEnabled(const bool enabled) {
+    if (m_vertexCaptureEnabled == enabled) {
+      return;
+    }
+
+    m_vertexCaptureEnabled = enabled;
+
+    m_parent->EmitCs([cEnabled = enabled](DxvkContext* ctx) {
+      ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, D3D9SpecConstantId::VertexCaptureEnabled, cEnabled);
+    });
+  }
+
+  void D3D9Rtx::processVertices(const VertexContext vertexContext[caps::MaxStreams], int vertexIndexOffset, RasterGeometry& geoData, MemoizedGeometryHashes* pMemoizedHashes) {
     DxvkBufferSlice streamCopies[caps::MaxStreams] {};
 
     // Process vertex buffers from CPU
@@ -294,6 +358,15 @@ namespace dxvk {
 
         *targetBuffer = RasterBuffer(streamCopies[element.Stream], element.Offset, ctx.stride, DecodeDecltype(D3DDECLTYPE(element.Type)));
         assert(targetBuffer->offset() % 4 == 0);
+
+        // Only ranges of D3D9 vertex buffers are memoized, the contents of user pointer draws are gone after the draw
+        if (pMemoizedHashes != nullptr && ctx.pVBO != nullptr && vertexOffset >= 0) {
+          if (targetBuffer == &geoData.positionBuffer) {
+            pMemoizedHashes->position = memoizeVertexHash(ctx.pVBO, vertexOffset, numVertexBytes, pMemoizedHashes->indicesId, *targetBuffer);
+          } else if (targetBuffer == &geoData.texcoordBuffer) {
+            pMemoizedHashes->texcoord = memoizeVertexHash(ctx.pVBO, vertexOffset, numVertexBytes, pMemoizedHashes->indicesId, *targetBuffer);
+          }
+        }
       }
     }
   }
@@ -375,7 +448,7 @@ namespace dxvk {
 
     if (m_drawCallID < (uint32_t)RtxOptions::drawCallRange().x ||
         m_drawCallID > (uint32_t)RtxOptions::drawCallRange().y) {
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredDrawCallRange };
     }
 
     // Raytraced Render Target Support
@@ -391,44 +464,44 @@ namespace dxvk {
 
     if (m_parent->UseProgrammableVS() && !useVertexCapture()) {
       ONCE(Logger::info("[RTX-Compatibility-Info] Skipping draw call with shader usage as vertex capture is not enabled."));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredNoVertexCapture };
     }
 
     if (drawContext.PrimitiveCount == 0) {
       ONCE(Logger::info("[RTX-Compatibility-Info] Skipped invalid drawcall, primitive count was 0."));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredNoPrimitives };
     }
 
     // Only certain draw calls are worth raytracing
     if (!isPrimitiveSupported(drawContext.PrimitiveType)) {
       ONCE(Logger::info(str::format("[RTX-Compatibility-Info] Trying to raytrace an unsupported primitive topology [", drawContext.PrimitiveType, "]. Ignoring.")));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredUnsupportedTopology };
     }
 
     if (!RtxOptions::enableAlphaTest() && m_parent->IsAlphaTestEnabled()) {
       ONCE(Logger::info(str::format("[RTX-Compatibility-Info] Raytracing an alpha-tested draw call when alpha-tested objects disabled in RT. Ignoring.")));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredAlphaTest };
     }
 
     if (!RtxOptions::enableAlphaBlend() && d3d9State().renderStates[D3DRS_ALPHABLENDENABLE]) {
       ONCE(Logger::info(str::format("[RTX-Compatibility-Info] Raytracing an alpha-blended draw call when alpha-blended objects disabled in RT. Ignoring.")));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredAlphaBlend };
     }
     
     if (m_activeOcclusionQueries > 0) {
       ONCE(Logger::info(str::format("[RTX-Compatibility-Info] Trying to raytrace an occlusion query. Ignoring.")));
-      return { RtxGeometryStatus::Rasterized, false };
+      return { RtxGeometryStatus::Rasterized, false, DrawCallOutcome::RasterizedOcclusionQuery };
     }
 
     if (d3d9State().renderTargets[kRenderTargetIndex] == nullptr) {
       ONCE(Logger::info("[RTX-Compatibility-Info] Skipped drawcall, as no color render target bound."));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredNoRenderTarget };
     }
 
     constexpr DWORD rgbWriteMask = D3DCOLORWRITEENABLE_RED | D3DCOLORWRITEENABLE_GREEN | D3DCOLORWRITEENABLE_BLUE;
     if ((d3d9State().renderStates[ColorWriteIndex(kRenderTargetIndex)] & rgbWriteMask) != rgbWriteMask) {
       ONCE(Logger::info("[RTX-Compatibility-Info] Skipped drawcall, colour write disabled."));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredColorWriteDisabled };
     }
 
     // Ensure present parameters for the swapchain have been cached
@@ -444,7 +517,7 @@ namespace dxvk {
       if (rtExt.width == rtExt.height && rtExt.width < m_activePresentParams->BackBufferWidth / 4 &&
           Resources::getFormatCompatibilityCategory(d3d9State().renderTargets[kRenderTargetIndex]->GetImageView(false)->imageInfo().format) == RtxTextureFormatCompatibilityCategory::InvalidFormatCompatibilityCategory) {
         ONCE(Logger::info("[RTX-Compatibility-Info] Skipped shadow mask drawcall."));
-        return { RtxGeometryStatus::Ignored, false };
+        return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredShadowMask };
       }
     }
 
@@ -456,7 +529,7 @@ namespace dxvk {
       D3D9CommonTexture* texture = GetCommonTexture(d3d9State().renderTargets[kRenderTargetIndex]->GetBaseTexture());
       if (texture && lookupHash(RtxOptions::raytracedRenderTargetTextures(), texture->GetImage()->getDescriptorHash())) {
         m_activeDrawCallState.isDrawingToRaytracedRenderTarget = true;
-        return { RtxGeometryStatus::RayTraced, false };
+        return { RtxGeometryStatus::RayTraced, false, DrawCallOutcome::RayTracedRenderTarget };
       }
     }
 
@@ -466,7 +539,7 @@ namespace dxvk {
 
       if (!isPrimary) {
         ONCE(Logger::info("[RTX-Compatibility-Info] Found a draw call to a non-primary, non-raytraced render target. Falling back to rasterization"));
-        return { RtxGeometryStatus::Rasterized, false };
+        return { RtxGeometryStatus::Rasterized, false, DrawCallOutcome::RasterizedNonPrimaryTarget };
       }
     }
 
@@ -478,7 +551,7 @@ namespace dxvk {
          d3d9State().renderStates[D3DRS_STENCILZFAIL] == D3DSTENCILOP_DECRSAT || d3d9State().renderStates[D3DRS_STENCILZFAIL] == D3DSTENCILOP_INCRSAT) &&
         d3d9State().renderStates[D3DRS_ZWRITEENABLE] == FALSE) {
       ONCE(Logger::info("[RTX-Compatibility-Info] Skipped stencil shadow drawcall."));
-      return { RtxGeometryStatus::Ignored, false };
+      return { RtxGeometryStatus::Ignored, false, DrawCallOutcome::IgnoredStencilShadow };
     }
 
     // Check UI only to the primary render target
@@ -486,6 +559,7 @@ namespace dxvk {
       return {
         RtxGeometryStatus::Rasterized,
         true, // UI rendering detected => trigger RTX injection
+        DrawCallOutcome::RasterizedUI,
       };
     }
 
@@ -493,14 +567,14 @@ namespace dxvk {
     if (d3d9State().vertexDecl != nullptr) {
       if (d3d9State().vertexDecl->TestFlag(D3D9VertexDeclFlag::HasPositionT)) {
         ONCE(Logger::info("[RTX-Compatibility-Info] Skipped drawcall, using pre-transformed vertices which isn't currently supported."));
-        return { RtxGeometryStatus::Rasterized, false };
+        return { RtxGeometryStatus::Rasterized, false, DrawCallOutcome::RasterizedPreTransformed };
       }
     }
 
-    return { RtxGeometryStatus::RayTraced, false };
+    return { RtxGeometryStatus::RayTraced, false, DrawCallOutcome::RayTraced };
   }
 
-  bool D3D9Rtx::checkBoundTextureCategory(const fast_unordered_set& textureCategory) const {
+  bool D3D9Rtx::isUiTextureBound() const {
     const uint32_t usedSamplerMask = m_parent->m_psShaderMasks.samplerMask | m_parent->m_vsShaderMasks.samplerMask;
     const uint32_t usedTextureMask = m_parent->m_activeTextures & usedSamplerMask;
     for (uint32_t idx : bit::BitMask(usedTextureMask)) {
@@ -510,7 +584,7 @@ namespace dxvk {
       auto texture = GetCommonTexture(d3d9State().textures[idx]);
 
       const XXH64_hash_t texHash = texture->GetSampleView(false)->image()->getHash();
-      if (textureCategory.find(texHash) != textureCategory.end()) {
+      if (lookupTextureCategories(texHash).isUiTexture) {
         return true;
       }
     }
@@ -529,20 +603,27 @@ namespace dxvk {
     }
 
     // Check if UI texture bound
-    return checkBoundTextureCategory(RtxOptions::uiTextures());
+    return isUiTextureBound();
   }
 
   PrepareDrawFlags D3D9Rtx::internalPrepareDraw(const IndexContext& indexContext, const VertexContext vertexContext[caps::MaxStreams], const DrawContext& drawContext) {
     ScopedCpuProfileZone();
 
+    m_vertexCapturePrepared = false;
+
     // RTX was injected => treat everything else as rasterized 
     if (m_rtxInjectTriggered) {
-      return RtxOptions::skipDrawCallsPostRTXInjection()
-             ? PrepareDrawFlag::Ignore
-             : PrepareDrawFlag::PreserveDrawCallAndItsState;
+      if (RtxOptions::skipDrawCallsPostRTXInjection()) {
+        recordDrawCallOutcome(DrawCallOutcome::IgnoredAfterInjection);
+        return PrepareDrawFlag::Ignore;
+      }
+      recordDrawCallOutcome(DrawCallOutcome::RasterizedAfterInjection);
+      return PrepareDrawFlag::PreserveDrawCallAndItsState;
     }
 
-    const auto [status, triggerRtxInjection] = makeDrawCallType(drawContext);
+    DrawCallStageTimer classificationTimer(m_drawCallStats, DrawCallStage::Classification);
+    const auto [status, triggerRtxInjection, outcome] = makeDrawCallType(drawContext);
+    classificationTimer.stop();
 
     // When raytracing is enabled we want to completely remove the ignored drawcalls from further processing as early as possible
     const PrepareDrawFlags prepareFlagsForIgnoredDraws = RtxOptions::enableRaytracing()
@@ -550,10 +631,13 @@ namespace dxvk {
                                                          : PrepareDrawFlag::PreserveDrawCallAndItsState;
 
     if (status == RtxGeometryStatus::Ignored) {
+      recordDrawCallOutcome(outcome);
       return prepareFlagsForIgnoredDraws;
     }
 
     if (triggerRtxInjection) {
+      recordDrawCallOutcome(outcome);
+
       // Bind all resources required for this drawcall to context first (i.e. render targets)
       m_parent->PrepareDraw(drawContext.PrimitiveType);
 
@@ -564,6 +648,7 @@ namespace dxvk {
     }
 
     if (status == RtxGeometryStatus::Rasterized) {
+      recordDrawCallOutcome(outcome);
       return PrepareDrawFlag::PreserveDrawCallAndItsState;
     }
 
@@ -580,31 +665,20 @@ namespace dxvk {
     // This can be negative!!
     int vertexIndexOffset = drawContext.BaseVertexIndex;
 
-    // Process index buffer
-    uint32_t minIndex = 0, maxIndex = 0;
-    if (indexContext.indexType != VK_INDEX_TYPE_NONE_KHR) {
+    const bool isIndexed = indexContext.indexType != VK_INDEX_TYPE_NONE_KHR;
+    if (isIndexed) {
       geoData.indexCount = GetVertexCount(drawContext.PrimitiveType, drawContext.PrimitiveCount);
-
-      if (indexContext.indexType == VK_INDEX_TYPE_UINT16)
-        geoData.indexBuffer = RasterBuffer(processIndexBuffer<uint16_t>(geoData.indexCount, drawContext.StartIndex, indexContext, minIndex, maxIndex), 0, 2, indexContext.indexType);
-      else
-        geoData.indexBuffer = RasterBuffer(processIndexBuffer<uint32_t>(geoData.indexCount, drawContext.StartIndex, indexContext, minIndex, maxIndex), 0, 4, indexContext.indexType);
-
-      // Unlikely, but invalid
-      if (maxIndex == minIndex) {
-        ONCE(Logger::info("[RTX-Compatibility-Info] Skipped invalid drawcall, no triangles detected in index buffer."));
-        return prepareFlagsForIgnoredDraws;
-      }
-
-      geoData.vertexCount = maxIndex - minIndex + 1;
-      vertexIndexOffset += minIndex;
-    } else {
-      geoData.vertexCount = GetVertexCount(drawContext.PrimitiveType, drawContext.PrimitiveCount);
     }
 
-    if (geoData.vertexCount == 0) {
-      ONCE(Logger::info("[RTX-Compatibility-Info] Skipped invalid drawcall, no vertices detected."));
-      return prepareFlagsForIgnoredDraws;
+    // Index processing does not depend on any render state, so large index buffers are processed
+    // on a worker while the render state and textures are processed below. Only the worker touches
+    // the staging allocator until the result is collected.
+    Future<ProcessedIndices> futureIndices;
+    if (isIndexed && enableParallelIndexProcessing() && geoData.indexCount >= parallelIndexProcessingMinIndexCount()) {
+      futureIndices = m_pGeometryWorkers->Schedule([this, indexContext, indexCount = geoData.indexCount, startIndex = drawContext.StartIndex]() -> ProcessedIndices {
+        ScopedCpuProfileZoneN("Process Indices");
+        return processIndices(indexCount, startIndex, indexContext);
+      });
     }
 
     if (RtxOptions::RaytracedRenderTarget::enable()) {
@@ -634,7 +708,54 @@ namespace dxvk {
     setFogState(m_parent, m_activeDrawCallState.fogState);
 
     // Fetch all the render state and send it to rtx context (textures, transforms, etc.)
-    if (!processRenderState()) {
+    DrawCallStageTimer renderStateTimer(m_drawCallStats, DrawCallStage::RenderState);
+    const bool isRenderStateValid = processRenderState();
+    renderStateTimer.stop();
+
+    // Process index buffer, the worker must be done with it before anything below can return
+    uint32_t minIndex = 0, maxIndex = 0;
+    MemoizedGeometryHashes memoizedHashes;
+    // Vertex hashes of indexed draws depend on the indices, so they can only be memoized along with them
+    bool canMemoizeVertexHashes = enableGeometryHashMemoization();
+    if (isIndexed) {
+      DrawCallStageTimer indexTimer(m_drawCallStats, DrawCallStage::IndexWait);
+      // The future is invalid when the worker queue was full
+      const ProcessedIndices indices = futureIndices.valid()
+        ? futureIndices.get()
+        : processIndices(geoData.indexCount, drawContext.StartIndex, indexContext);
+      minIndex = indices.minIndex;
+      maxIndex = indices.maxIndex;
+      if (enableGeometryHashMemoization()) {
+        memoizedHashes.indicesId = indices.memoId;
+        memoizedHashes.indices = indices.indicesHash;
+        memoizedHashes.legacyIndices = indices.legacyIndicesHash;
+        canMemoizeVertexHashes = indices.memoId != 0;
+      }
+      geoData.indexBuffer = RasterBuffer(indices.slice, 0, indexContext.indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4, indexContext.indexType);
+    }
+
+    if (!isRenderStateValid) {
+      recordDrawCallOutcome(DrawCallOutcome::IgnoredRenderState);
+      return prepareFlagsForIgnoredDraws;
+    }
+
+    if (isIndexed) {
+      // Unlikely, but invalid
+      if (maxIndex == minIndex) {
+        ONCE(Logger::info("[RTX-Compatibility-Info] Skipped invalid drawcall, no triangles detected in index buffer."));
+        recordDrawCallOutcome(DrawCallOutcome::IgnoredNoGeometry);
+        return prepareFlagsForIgnoredDraws;
+      }
+
+      geoData.vertexCount = maxIndex - minIndex + 1;
+      vertexIndexOffset += minIndex;
+    } else {
+      geoData.vertexCount = GetVertexCount(drawContext.PrimitiveType, drawContext.PrimitiveCount);
+    }
+
+    if (geoData.vertexCount == 0) {
+      ONCE(Logger::info("[RTX-Compatibility-Info] Skipped invalid drawcall, no vertices detected."));
+      recordDrawCallOutcome(DrawCallOutcome::IgnoredNoGeometry);
       return prepareFlagsForIgnoredDraws;
     }
 
@@ -642,22 +763,18 @@ namespace dxvk {
     const uint32_t maxOffsetedIndex = maxIndex - minIndex;
 
     // Copy all the vertices into a staging buffer.  Assign fields of the geoData structure.
-    processVertices(vertexContext, vertexIndexOffset, geoData);
-    geoData.futureGeometryHashes = computeHash(geoData, maxOffsetedIndex);
+    DrawCallStageTimer verticesTimer(m_drawCallStats, DrawCallStage::Vertices);
+    processVertices(vertexContext, vertexIndexOffset, geoData, canMemoizeVertexHashes ? &memoizedHashes : nullptr);
+    geoData.futureGeometryHashes = computeHash(geoData, maxOffsetedIndex, memoizedHashes);
     geoData.futureBoundingBox = computeAxisAlignedBoundingBox(geoData);
     
     // Process skinning data
     m_activeDrawCallState.futureSkinningData = processSkinning(geoData);
+    verticesTimer.stop();
 
     // Hash material data
     m_activeDrawCallState.materialData.updateCachedHash();
 
-    // For shader based drawcalls we also want to capture the vertex shader output
-    const bool needVertexCapture = m_parent->UseProgrammableVS() && useVertexCapture();
-    if (needVertexCapture) {
-      prepareVertexCapture(vertexIndexOffset);
-    }
-
     m_activeDrawCallState.usesVertexShader = m_parent->UseProgrammableVS();
     m_activeDrawCallState.usesPixelShader = m_parent->UseProgrammablePS();
 
@@ -689,10 +806,25 @@ namespace dxvk {
     // Ignore sky draw calls that are being drawn to a Raytraced Render Target
     // Raytraced Render Target scenes just use the same sky as the main scene, no need to duplicate them
     if (m_activeDrawCallState.isDrawingToRaytracedRenderTarget && m_activeDrawCallState.categories.test(InstanceCategories::Sky)) {
+      recordDrawCallOutcome(DrawCallOutcome::IgnoredSkyInRenderTarget);
       return prepareFlagsForIgnoredDraws;
     }
 
     assert(status == RtxGeometryStatus::RayTraced);
+    recordDrawCallOutcome(outcome);
+
+    // For shader based drawcalls we also want to capture the vertex shader output
+    const bool needVertexCapture = m_parent->UseProgrammableVS() && useVertexCapture();
+    if (needVertexCapture) {
+      // The original draw is only issued for the capture, its rasterized output gets overwritten by the ray traced image.
+      // Sky and terrain are baked from their rasterized output and draws into raytraced render targets are left alone.
+      const bool discardRasterization = elideRasterizationOfRayTracedDraws() &&
+        !m_activeDrawCallState.testCategoryFlags(CATEGORIES_REQUIRE_DRAW_CALL_STATE) &&
+        !m_activeDrawCallState.isDrawingToRaytracedRenderTarget;
+
+      DrawCallStageTimer vertexCaptureTimer(m_drawCallStats, DrawCallStage::VertexCapture);
+      prepareVertexCapture(vertexIndexOffset, discardRasterization);
+    }
 
     const bool preserveOriginalDraw = needVertexCapture;
 
@@ -702,7 +834,16 @@ namespace dxvk {
       (preserveOriginalDraw ? PrepareDrawFlag::PreserveDrawCallAndItsState : 0);
   }
 
+  void D3D9Rtx::emitExternalCommands() {
+    if (!m_externalCommands.empty()) {
+      m_parent->EmitCs(RtxExternalCommandQueue::Batch(m_externalCommands));
+    }
+  }
+
   void D3D9Rtx::triggerInjectRTX() {
+    // The frame's Remix API calls have to make it to the scene before it's ray traced
+    emitExternalCommands();
+
     // Flush any pending game and RTX work
     m_parent->Flush();
 
@@ -843,11 +984,7 @@ namespace dxvk {
       // Pass bone data to RT back-end
 
       SkinningData skinningData;
-      skinningData.pBoneMatrices.reserve(numBones);
-
-      for (uint32_t n = 0; n < numBones; n++) {
-        skinningData.pBoneMatrices.push_back(boneMatrices[n]);
-      }
+      skinningData.pBoneMatrices.assign(boneMatrices, boneMatrices + numBones);
 
       skinningData.minBoneIndex = minBoneIndex;
       skinningData.numBones = numBones;
@@ -1068,6 +1205,7 @@ namespace dxvk {
 
   PrepareDrawFlags D3D9Rtx::PrepareDrawGeometryForRT(const bool indexed, const DrawContext& context) {
     if (!RtxOptions::enableRaytracing() || !m_enableDrawCallConversion) {
+      setVertexCaptureEnabled(false);
       return PrepareDrawFlag::PreserveDrawCallAndItsState;
     }
 
@@ -1105,7 +1243,9 @@ namespace dxvk {
       }
     }
 
-    return internalPrepareDraw(indices, vertices, context);
+    const PrepareDrawFlags flags = internalPrepareDraw(indices, vertices, context);
+    setVertexCaptureEnabled(m_vertexCapturePrepared);
+    return flags;
   }
 
   PrepareDrawFlags D3D9Rtx::PrepareDrawUPGeometryForRT(const bool indexed,
@@ -1117,6 +1257,7 @@ namespace dxvk {
                                                        const uint32_t vertexStride,
                                                        const DrawContext& drawContext) {
     if (!RtxOptions::enableRaytracing() || !m_enableDrawCallConversion) {
+      setVertexCaptureEnabled(false);
       return PrepareDrawFlag::PreserveDrawCallAndItsState;
     }
 
@@ -1137,7 +1278,9 @@ namespace dxvk {
     vertices[0].mappedSlice = buffer.slice.getSliceHandle(0, vertexSize);
     vertices[0].canUseBuffer = true;
 
-    return internalPrepareDraw(indices, vertices, drawContext);
+    const PrepareDrawFlags flags = internalPrepareDraw(indices, vertices, drawContext);
+    setVertexCaptureEnabled(m_vertexCapturePrepared);
+    return flags;
   }
 
   void D3D9Rtx::ResetSwapChain(const D3DPRESENT_PARAMETERS& presentationParameters) {
@@ -1174,8 +1317,65 @@ namespace dxvk {
     });
   }
 
+  Future<XXH64_hash_t> D3D9Rtx::ScheduleTextureHash(D3D9CommonTexture* pTexture, const void* pData, size_t size, bool useObsoleteHashMethod) {
+    if (m_pTextureHashWorkers == nullptr || !enableAsyncTextureHashing()) {
+      return {};
+    }
+
+    ResolvePendingTextureHashes(kMaxPendingTextureHashes - 1, kMaxPendingTextureHashBytes - std::min(size, kMaxPendingTextureHashBytes));
+
+    Future<XXH64_hash_t> future = m_pTextureHashWorkers->Schedule([pData, size, useObsoleteHashMethod]() -> XXH64_hash_t {
+      ScopedCpuProfileZoneN("Texture Hash");
+      if (unlikely(useObsoleteHashMethod)) {
+        return XXH64(pData, size, 0);
+      }
+      return XXH3_64bits(pData, size);
+    });
+
+    if (future.valid()) {
+      std::lock_guard lock(m_pendingTextureHashMutex);
+      m_pendingTextureHashes.push_back(pTexture);
+      m_pendingTextureHashBytes += size;
+      m_pendingTextureHashCount.store(m_pendingTextureHashes.size(), std::memory_order_relaxed);
+    }
+
+    return future;
+  }
+
+  void D3D9Rtx::OnTextureHashResolved(D3D9CommonTexture* pTexture, size_t size) {
+    std::lock_guard lock(m_pendingTextureHashMutex);
+
+    auto iter = std::find(m_pendingTextureHashes.begin(), m_pendingTextureHashes.end(), pTexture);
+    if (iter != m_pendingTextureHashes.end()) {
+      m_pendingTextureHashes.erase(iter);
+      m_pendingTextureHashBytes -= size;
+      m_pendingTextureHashCount.store(m_pendingTextureHashes.size(), std::memory_order_relaxed);
+    }
+  }
+
+  void D3D9Rtx::ResolvePendingTextureHashes(uint32_t maxCount, size_t maxBytes) {
+    // Oldest first, those are the most likely to be done already
+    while (true) {
+      D3D9CommonTexture* pTexture = nullptr;
+      {
+        std::lock_guard lock(m_pendingTextureHashMutex);
+        if (m_pendingTextureHashes.size() <= maxCount && m_pendingTextureHashBytes <= maxBytes) {
+          return;
+        }
+        pTexture = m_pendingTextureHashes.front();
+      }
+
+      pTexture->ResolvePendingHash();
+    }
+  }
+
   void D3D9Rtx::EndFrame(const Rc<DxvkImage>& targetImage, bool callInjectRtx) {
     const auto currentReflexFrameId = GetReflexFrameId();
+
+    // Don't keep the staging buffers of textures that weren't drawn with alive across frames
+    ResolvePendingTextureHashes(0, 0);
+
+    emitExternalCommands();
     
     // Flush any pending game and RTX work
     m_parent->Flush();
@@ -1185,7 +1385,19 @@ namespace dxvk {
       static_cast<RtxContext*>(ctx)->endFrame(currentReflexFrameId, targetImage, callInjectRtx); 
     });
 
+    // The frame's draws have been recorded by now, so their command lists track the vertex capture buffers
+    m_parent->EmitCs([capturedBuffers = m_vertexCapturePool.onFrameEnd()](DxvkContext* ctx) {
+      for (const Rc<DxvkBuffer>& buffer : capturedBuffers) {
+        buffer->release(DxvkAccess::Read);
+      }
+    });
+
+    if (RtxDrawCallStats::enable()) {
+      m_parent->GetDXVKDevice()->getCommon()->drawCallStats().publish(m_drawCallStats);
+    }
+
     // Reset for the next frame
+    m_drawCallStats = {};
     m_rtxInjectTriggered = false;
     m_drawCallID = 0;
     m_seenCameraPositionsPrev = std::move(m_seenCameraPositions);
@@ -2,13 +2,18 @@
 
 #include "d3d9_state.h"
 #include "../dxvk/dxvk_buffer.h"
+#include "../dxvk/rtx_render/rtx_vertex_capture_pool.h"
+#include "../dxvk/rtx_render/rtx_draw_call_stats.h"
+#include "../dxvk/rtx_render/rtx_external_command_queue.h"
 #include "../util/util_threadpool.h"
 
+#include <deque>
 #include <vector>
 #include <optional>
 
 namespace dxvk {
   struct D3D9BufferSlice;
+  class D3D9CommonTexture;
   class DxvkDevice;
 
   enum class D3D9RtxFlag : uint32_t {
@@ -40,8 +45,14 @@ namespace dxvk {
     RTX_OPTION("rtx", bool, useVertexCapture, true, "When enabled, injects code into the original vertex shader to capture final shaded vertex positions.  Is useful for games using simple vertex shaders, that still also set the fixed function transform matrices.");
     RTX_OPTION("rtx", bool, useVertexCapturedNormals, true, "When enabled, vertex normals are read from the input assembler and used in raytracing.  This doesn't always work as normals can be in any coordinate space, but can help sometimes.");
     RTX_OPTION("rtx", bool, useWorldMatricesForShaders, true, "When enabled, Remix will utilize the world matrices being passed from the game via D3D9 fixed function API, even when running with shaders.  Sometimes games pass these matrices and they are useful, however for some games they are very unreliable, and should be filtered out.  If you're seeing precision related issues with shader vertex capture, try disabling this setting.");
+    RTX_OPTION("rtx", bool, elideRasterizationOfRayTracedDraws, false, "GPU performance optimization.  When enabled, the original draw calls that are only kept for vertex shader capture move all of their primitives out of the clip volume, so that only their vertex shaders run.  Their rasterized output would be overwritten by the ray traced image anyway.  Sky and terrain draw calls, draw calls into raytraced render targets and draw calls inside occlusion queries (which are always rasterized) are not affected.");
+    RTX_OPTION("rtx", bool, useVertexCaptureBufferPool, true, "CPU performance optimization.  When enabled, the buffers that vertex shader capture writes vertices to are sub-allocated from pages that are reused across frames, instead of creating a new buffer for every draw call.");
+    RTX_OPTION("rtx", bool, enableGeometryHashMemoization, true, "CPU performance optimization.  When enabled, the geometry hashes of index and vertex buffer ranges are cached, and only recomputed once the range is written to again.  Vertex hashes of indexed draw calls are only cached when rtx.enableIndexBufferMemoization is enabled too.");
     RTX_OPTION("rtx", bool, enableIndexBufferMemoization, true, "CPU performance optimization, should generally be enabled.  Will reduce main thread time by caching processIndexBuffer operations and reusing when possible, this will come at the expense of some CPU RAM.");
     RTX_OPTION("rtx", uint32_t, numGeometryProcessingThreads, 2, "The desired number of CPU threads to dedicate to geometry processing  Will be limited by the number of CPU cores.  There may be some advantage to lowering this number in games which are fairly simple and use a low number of draw calls per frame.  The default was determined by looking at a game with around 2000 draw calls per frame, and with a reasonably high average triangle count per draw.");
+    RTX_OPTION("rtx", bool, enableParallelIndexProcessing, false, "CPU performance optimization.  When enabled, the index buffer of an indexed draw call is copied and scanned for its index range on a geometry processing thread, while the main thread processes the render state and textures of the draw call.  Only draw calls with at least parallelIndexProcessingMinIndexCount indices are processed in parallel, smaller ones are cheaper to process directly.");
+    RTX_OPTION("rtx", bool, enableAsyncTextureHashing, false, "CPU performance optimization.  When enabled, the contents of newly uploaded textures are hashed on a worker thread instead of the thread that unlocks them, and the hash is waited for when the texture is first drawn with, locked again or at the end of the frame.  Mainly reduces the stalls of uploading many large textures during level loads.  The hashes are identical either way.");
+    RTX_OPTION("rtx", uint32_t, parallelIndexProcessingMinIndexCount, 4096, "The minimum number of indices a draw call must have for its index buffer to be processed on a geometry processing thread, see enableParallelIndexProcessing.");
 
     // Copy of the parameters issued to D3D9 on DrawXXX
     struct DrawContext {
@@ -171,15 +182,55 @@ namespace dxvk {
       return m_reflexFrameId;
     }
 
+    /**
+      * \brief: Hashes the first subresource of a texture on a worker thread, see rtx.enableAsyncTextureHashing.
+      * The data must stay unchanged until the texture resolves the returned future, in D3D9CommonTexture::ResolvePendingHash().
+      * Returns an invalid future when the data has to be hashed on the calling thread instead.
+      */
+    Future<XXH64_hash_t> ScheduleTextureHash(D3D9CommonTexture* pTexture, const void* pData, size_t size, bool useObsoleteHashMethod);
+
+    /**
+      * \brief: Removes a texture from the pending texture hashes, called once the texture resolved its hash.
+      */
+    void OnTextureHashResolved(D3D9CommonTexture* pTexture, size_t size);
+
+    bool HasPendingTextureHashes() const {
+      return m_pendingTextureHashCount.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+      * \brief: Queues a command for the CS thread, can be called from any thread without locking the device.
+      * Queued commands are emitted in the order they were queued in, before RTX is injected and at the end of the frame.
+      */
+    template<typename Cmd>
+    void QueueExternalCs(Cmd&& command) {
+      m_externalCommands.push(std::forward<Cmd>(command));
+    }
+
   private: 
     inline static const uint32_t kMaxConcurrentDraws = 6 * 1024; // some games issuing >3000 draw calls per frame...  account for some consumer thread lag with x2
     using GeometryProcessor = WorkerThreadPool<kMaxConcurrentDraws>;
     const std::unique_ptr<GeometryProcessor> m_pGeometryWorkers;
+
+    // Task slots of a worker pool are recycled, so no more hashes than this may be pending at once, and while
+    // pending, the texture keeps its staging buffer alive: the oldest hashes are resolved when either limit is reached
+    inline static const uint32_t kMaxPendingTextureHashes = 256;
+    inline static const size_t kMaxPendingTextureHashBytes = 256 << 20; // 256 MiB
+    using TextureHashProcessor = WorkerThreadPool<kMaxPendingTextureHashes, false, false>;
+    const std::unique_ptr<TextureHashProcessor> m_pTextureHashWorkers;
+    dxvk::mutex m_pendingTextureHashMutex;
+    std::deque<D3D9CommonTexture*> m_pendingTextureHashes;
+    size_t m_pendingTextureHashBytes = 0;
+    std::atomic<uint32_t> m_pendingTextureHashCount = 0;
+
+    void ResolvePendingTextureHashes(uint32_t maxCount, size_t maxBytes);
     AtomicQueue<DrawCallState, kMaxConcurrentDraws> m_drawCallStateQueue;
 
     DrawCallState m_activeDrawCallState;
 
     RtxStagingDataAlloc m_rtStagingData;
+    RtxVertexCapturePool m_vertexCapturePool;
+    RtxExternalCommandQueue m_externalCommands;
     D3D9DeviceEx* m_parent;
 
     std::optional<D3DPRESENT_PARAMETERS> m_activePresentParams;
@@ -199,6 +250,12 @@ namespace dxvk {
     const bool m_enableDrawCallConversion;
     bool m_rtxInjectTriggered = false;
     bool m_forceGeometryCopy = false;
+    // Whether the draw being prepared has its vertex shader output captured,
+    // and the last vertex capture spec constant value sent to the CS thread
+    bool m_vertexCapturePrepared = false;
+    bool m_vertexCaptureEnabled = false;
+    // Outcomes and stage timings of the frame's draw calls, only recorded while rtx.drawCallStats.enable is set
+    DrawCallFrameStats m_drawCallStats;
     DWORD m_texcoordIndex = 0;
 
     int m_activeOcclusionQueries = 0;
@@ -237,12 +294,38 @@ namespace dxvk {
     template<typename T>
     static void copyIndices(const uint32_t indexCount, T*& pIndicesDst, T* pIndices, uint32_t& minIndex, uint32_t& maxIndex);
 
+    struct ProcessedIndices {
+      DxvkBufferSlice slice;
+      uint32_t minIndex = 0;
+      uint32_t maxIndex = 0;
+      // Set when the indices were memoized, see D3D9CommonBuffer::RemixIndexBufferMemoizationData
+      uint64_t memoId = 0;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> indicesHash;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> legacyIndicesHash;
+    };
+
     template<typename T>
-    DxvkBufferSlice processIndexBuffer(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx, uint32_t& minIndex, uint32_t& maxIndex);
+    void processIndexBuffer(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx, ProcessedIndices& result);
 
-    void prepareVertexCapture(const int vertexIndexOffset);
+    ProcessedIndices processIndices(const uint32_t indexCount, const uint32_t startIndex, const IndexContext& indexCtx);
 
-    void processVertices(const VertexContext vertexContext[caps::MaxStreams], int vertexIndexOffset, RasterGeometry& geoData);
+    void prepareVertexCapture(const int vertexIndexOffset, const bool discardRasterization);
+
+    // Specializes the vertex shader capture writes in or out of the following draws
+    void setVertexCaptureEnabled(const bool enabled);
+
+    // Memoized geometry hashes of a draw call, hashes without a memo are computed every time
+    struct MemoizedGeometryHashes {
+      // Memo id of the indices the vertex hashes are memoized under, 0 for non-indexed draws
+      uint64_t indicesId = 0;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> indices;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> legacyIndices;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> position;
+      std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash> texcoord;
+    };
+
+    // Memoized vertex hashes are looked up for the position and texcoord streams when pMemoizedHashes is set
+    void processVertices(const VertexContext vertexContext[caps::MaxStreams], int vertexIndexOffset, RasterGeometry& geoData, MemoizedGeometryHashes* pMemoizedHashes);
 
     bool processRenderState();
 
@@ -253,14 +336,23 @@ namespace dxvk {
 
     void triggerInjectRTX();
 
+    void emitExternalCommands();
+
 
     struct DrawCallType {
       RtxGeometryStatus status;
       bool triggerRtxInjection;
+      DrawCallOutcome outcome;
     };
     DrawCallType makeDrawCallType(const DrawContext& drawContext);
 
-    bool checkBoundTextureCategory(const fast_unordered_set& textureCategory) const;
+    void recordDrawCallOutcome(DrawCallOutcome outcome) {
+      if (RtxDrawCallStats::enable()) {
+        m_drawCallStats.record(outcome);
+      }
+    }
+
+    bool isUiTextureBound() const;
 
     bool isRenderingUI();
 
@@ -268,7 +360,7 @@ namespace dxvk {
 
     Future<AxisAlignedBoundingBox> computeAxisAlignedBoundingBox(const RasterGeometry& geoData);
 
-    Future<GeometryHashes> computeHash(const RasterGeometry& geoData, const uint32_t maxIndexValue);
+    Future<GeometryHashes> computeHash(const RasterGeometry& geoData, const uint32_t maxIndexValue, const MemoizedGeometryHashes& memoizedHashes);
 
     void submitActiveDrawCallState();
   };
@@ -69,26 +69,59 @@ namespace dxvk {
     uniqueIndicesOut.resize(uniqueIndexCount);
   }
 
+  using MemoizedHash = std::shared_ptr<D3D9CommonBuffer::RemixMemoizedHash>;
+
+  bool isHashMemoized(const MemoizedHash& memo) {
+    return memo && memo->hash.load(std::memory_order_acquire) != kEmptyHash;
+  }
+
+  // Returns the memoized hash if it was computed already, otherwise computes it and publishes it for later draws
+  template<typename Func>
+  XXH64_hash_t getOrComputeHash(const MemoizedHash& memo, Func&& compute) {
+    if (isHashMemoized(memo)) {
+      return memo->hash.load(std::memory_order_acquire);
+    }
+
+    const XXH64_hash_t hash = compute();
+    if (memo) {
+      memo->hash.store(hash, std::memory_order_release);
+    }
+    return hash;
+  }
+
   template<typename T>
   void hashGeometryData(const size_t indexCount, const uint32_t maxIndexValue, const void* pIndexData,
-                        DxvkBuffer* indexBufferRef, const HashQuery vertexRegions[VertexRegions::Count], GeometryHashes& hashesOut) {
+                        DxvkBuffer* indexBufferRef, const HashQuery vertexRegions[VertexRegions::Count],
+                        const D3D9Rtx::MemoizedGeometryHashes& memoizedHashes, const HashRule& globalHashRule, GeometryHashes& hashesOut) {
     ScopedCpuProfileZone();
 
-    const HashRule& globalHashRule = RtxOptions::geometryHashGenerationRule();
+    const MemoizedHash vertexRegionHashes[VertexRegions::Count] = { memoizedHashes.position, memoizedHashes.texcoord };
+
+    // Unique indices are only needed for the vertex hashes that were not memoized
+    bool needsUniqueIndices = false;
+    for (const auto& [component, region] : componentToRegionMap) {
+      needsUniqueIndices |= globalHashRule.test(component) && !isHashMemoized(vertexRegionHashes[region]);
+    }
 
     // TODO (REMIX-658): Improve this by reducing allocation overhead of vector
     std::vector<T> uniqueIndices(0);
     if constexpr (!std::is_same<T, NoIndices>::value) {
       assert((indexCount > 0 && indexBufferRef));
-      deduplicateSortIndices(pIndexData, indexCount, maxIndexValue, uniqueIndices);
+      if (needsUniqueIndices) {
+        deduplicateSortIndices(pIndexData, indexCount, maxIndexValue, uniqueIndices);
+      }
 
       if (globalHashRule.test(HashComponents::Indices)) {
-        hashesOut[HashComponents::Indices] = hashContiguousMemory(pIndexData, indexCount * sizeof(T));
+        hashesOut[HashComponents::Indices] = getOrComputeHash(memoizedHashes.indices, [&]() {
+          return hashContiguousMemory(pIndexData, indexCount * sizeof(T));
+        });
       }
 
       // TODO (REMIX-656): Remove this once we can transition content to new hash
       if (globalHashRule.test(HashComponents::LegacyIndices)) {
-        hashesOut[HashComponents::LegacyIndices] = hashIndicesLegacy<T>(pIndexData, indexCount);
+        hashesOut[HashComponents::LegacyIndices] = getOrComputeHash(memoizedHashes.legacyIndices, [&]() {
+          return hashIndicesLegacy<T>(pIndexData, indexCount);
+        });
       }
 
       // Release this memory back to the staging allocator
@@ -96,13 +129,34 @@ namespace dxvk {
       indexBufferRef->decRef();
     }
 
-    // Do vertex based rules
-    for (uint32_t i = 0; i < (uint32_t) HashComponents::Count; i++) {
-      const HashComponents& component = (HashComponents) i;
+    // Do vertex based rules, the regions that aren't memoized are hashed together in one batch
+    HashComponents pendingComponents[VertexRegions::Count];
+    HashQuery pendingRegions[VertexRegions::Count];
+    const MemoizedHash* pendingMemos[VertexRegions::Count];
+    uint32_t numPending = 0;
+    for (const auto& [component, region] : componentToRegionMap) {
+      if (!globalHashRule.test(component)) {
+        continue;
+      }
+
+      if (isHashMemoized(vertexRegionHashes[region])) {
+        hashesOut[component] = vertexRegionHashes[region]->hash.load(std::memory_order_acquire);
+      } else {
+        pendingComponents[numPending] = component;
+        pendingMemos[numPending] = &vertexRegionHashes[region];
+        pendingRegions[numPending] = vertexRegions[(uint32_t)region];
+        ++numPending;
+      }
+    }
 
-      if (globalHashRule.test(component) && componentToRegionMap.count(component) > 0) {
-        const VertexRegions::Type region = componentToRegionMap.at(component);
-        hashesOut[component] = hashVertexRegionIndexed(vertexRegions[(uint32_t)region], uniqueIndices);
+    if (numPending > 0) {
+      XXH64_hash_t pendingHashes[VertexRegions::Count];
+      hashVertexRegionsIndexed(pendingRegions, numPending, uniqueIndices, pendingHashes);
+      for (uint32_t i = 0; i < numPending; i++) {
+        hashesOut[pendingComponents[i]] = pendingHashes[i];
+        if (*pendingMemos[i]) {
+          (*pendingMemos[i])->hash.store(pendingHashes[i], std::memory_order_release);
+        }
       }
     }
 
@@ -124,7 +178,7 @@ namespace dxvk {
     }
   }
 
-  Future<GeometryHashes> D3D9Rtx::computeHash(const RasterGeometry& geoData, const uint32_t maxIndexValue) {
+  Future<GeometryHashes> D3D9Rtx::computeHash(const RasterGeometry& geoData, const uint32_t maxIndexValue, const MemoizedGeometryHashes& memoizedHashes) {
     ScopedCpuProfileZone();
 
     const uint32_t indexCount = geoData.indexCount;
@@ -155,13 +209,20 @@ namespace dxvk {
     const size_t indexStride = geoData.indexBuffer.stride();
     const size_t indexDataSize = indexCount * indexStride;
 
+    // Only the components something consumes are computed. The legacy hashes are only used to look up mesh
+    // replacements authored against them, so there is nothing to compute them for while mesh replacements are off.
+    // Draws are hashed again every time they are submitted, so they pick up the legacy hashes once those are needed.
+    HashRule hashRule = RtxOptions::geometryHashGenerationRule();
+    if (!RtxOptions::getEnableReplacementMeshes()) {
+      hashRule.clr(HashComponents::LegacyPositions0, HashComponents::LegacyPositions1, HashComponents::LegacyIndices);
+    }
+
     // Assume the GPU changed the data via shaders, include the constant buffer data in hash
     XXH64_hash_t vertexShaderHash = kEmptyHash;
     if (m_parent->UseProgrammableVS() && useVertexCapture()) {
-      if (RtxOptions::geometryHashGenerationRule().test(HashComponents::GeometryDescriptor)) {
+      if (hashRule.test(HashComponents::GeometryDescriptor)) {
         const D3D9ConstantSets& cb = m_parent->m_consts[DxsoProgramTypes::VertexShader];
-        auto& shaderByteCode = d3d9State().vertexShader->GetCommonShader()->GetBytecode();
-        vertexShaderHash = XXH3_64bits(shaderByteCode.data(), shaderByteCode.size());
+        vertexShaderHash = d3d9State().vertexShader->GetCommonShader()->GetBytecodeHash();
         vertexShaderHash = XXH3_64bits_withSeed(&d3d9State().vsConsts.fConsts[0], cb.meta.maxConstIndexF * sizeof(float) * 4, vertexShaderHash);
         vertexShaderHash = XXH3_64bits_withSeed(&d3d9State().vsConsts.iConsts[0], cb.meta.maxConstIndexI * sizeof(int) * 4, vertexShaderHash);
         vertexShaderHash = XXH3_64bits_withSeed(&d3d9State().vsConsts.bConsts[0], cb.meta.maxConstIndexB * sizeof(uint32_t)/32, vertexShaderHash);
@@ -170,7 +231,7 @@ namespace dxvk {
 
     // Calculate this based on the RasterGeometry input data
     XXH64_hash_t geometryDescriptorHash = kEmptyHash;
-    if (RtxOptions::geometryHashGenerationRule().test(HashComponents::GeometryDescriptor)) {
+    if (hashRule.test(HashComponents::GeometryDescriptor)) {
       geometryDescriptorHash = hashGeometryDescriptor(geoData.indexCount, 
                                                       geoData.vertexCount, 
                                                       geoData.indexBuffer.indexType(), 
@@ -179,14 +240,14 @@ namespace dxvk {
 
     // Calculate this based on the RasterGeometry input data
     XXH64_hash_t vertexLayoutHash = kEmptyHash;
-    if (RtxOptions::geometryHashGenerationRule().test(HashComponents::VertexLayout)) {
+    if (hashRule.test(HashComponents::VertexLayout)) {
       vertexLayoutHash = hashVertexLayout(geoData);
     }
 
     return m_pGeometryWorkers->Schedule([vertexRegions, indexBufferRef = indexBufferRef.ptr(),
                                  pIndexData, indexStride, indexDataSize, indexCount,
                                  maxIndexValue, vertexShaderHash, geometryDescriptorHash,
-                                 vertexLayoutHash]() -> GeometryHashes {
+                                 vertexLayoutHash, memoizedHashes, hashRule]() -> GeometryHashes {
       ScopedCpuProfileZone();
 
       GeometryHashes hashes;
@@ -199,13 +260,13 @@ namespace dxvk {
       // Index hash
       switch (indexStride) {
       case 2:
-        hashGeometryData<uint16_t>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, hashes);
+        hashGeometryData<uint16_t>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, memoizedHashes, hashRule, hashes);
         break;
       case 4:
-        hashGeometryData<uint32_t>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, hashes);
+        hashGeometryData<uint32_t>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, memoizedHashes, hashRule, hashes);
         break;
       default:
-        hashGeometryData<NoIndices>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, hashes);
+        hashGeometryData<NoIndices>(indexCount, maxIndexValue, pIndexData, indexBufferRef, vertexRegions, memoizedHashes, hashRule, hashes);
         break;
       }
 
@@ -217,6 +278,29 @@ namespace dxvk {
     });
   }
 
+  static void computeHalfPositionMinMax(const uint32_t vertexCount, const uint8_t* pVertexData, const uint32_t vertexStride, float minPos[3], float maxPos[3]) {
+    static constexpr uint32_t kChunkSize = 256;
+    float decoded[4][kChunkSize];
+    float* const decodedStreams[4] = { decoded[0], decoded[1], decoded[2], decoded[3] };
+
+    for (uint32_t c = 0; c < 3; ++c) {
+      minPos[c] = FLT_MAX;
+      maxPos[c] = -FLT_MAX;
+    }
+
+    for (uint32_t first = 0; first < vertexCount; first += kChunkSize) {
+      const uint32_t count = std::min(kChunkSize, vertexCount - first);
+      fast::decodeVertexAttributes(fast::VertexAttributeFormat::Float16x4, count, pVertexData + (size_t) first * vertexStride, vertexStride, decodedStreams);
+
+      for (uint32_t c = 0; c < 3; ++c) {
+        for (uint32_t i = 0; i < count; ++i) {
+          minPos[c] = std::min(minPos[c], decoded[c][i]);
+          maxPos[c] = std::max(maxPos[c], decoded[c][i]);
+        }
+      }
+    }
+  }
+
   Future<AxisAlignedBoundingBox> D3D9Rtx::computeAxisAlignedBoundingBox(const RasterGeometry& geoData) {
     ScopedCpuProfileZone();
 
@@ -227,6 +311,8 @@ namespace dxvk {
     const void* pVertexData = geoData.positionBuffer.mapPtr((size_t)geoData.positionBuffer.offsetFromSlice());
     const uint32_t vertexCount = geoData.vertexCount;
     const size_t vertexStride = geoData.positionBuffer.stride();
+    // Half precision positions are decoded on the CPU, everything else is expected to be 32-bit float
+    const bool isHalfPosition = geoData.positionBuffer.vertexFormat() == VK_FORMAT_R16G16B16A16_SFLOAT;
 
     if (pVertexData == nullptr) {
       return Future<AxisAlignedBoundingBox>();
@@ -235,25 +321,19 @@ namespace dxvk {
     auto vertexBuffer = geoData.positionBuffer.buffer().ptr();
     vertexBuffer->incRef();
 
-    return m_pGeometryWorkers->Schedule([pVertexData, vertexCount, vertexStride, vertexBuffer]()->AxisAlignedBoundingBox {
+    return m_pGeometryWorkers->Schedule([pVertexData, vertexCount, vertexStride, isHalfPosition, vertexBuffer]()->AxisAlignedBoundingBox {
       ScopedCpuProfileZone();
 
-      __m128 minPos = _mm_set_ps1(FLT_MAX);
-      __m128 maxPos = _mm_set_ps1(-FLT_MAX);
-
-      const uint8_t* pVertex = static_cast<const uint8_t*>(pVertexData);
-      for (uint32_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx) {
-        const Vector3* const pVertexPos = reinterpret_cast<const Vector3* const>(pVertex);
-        __m128 vertexPos = _mm_set_ps(0.0f, pVertexPos->z, pVertexPos->y, pVertexPos->x);
-        minPos = _mm_min_ps(minPos, vertexPos);
-        maxPos = _mm_max_ps(maxPos, vertexPos);
-
-        pVertex += vertexStride;
+      float minPos[3], maxPos[3];
+      if (isHalfPosition) {
+        computeHalfPositionMinMax(vertexCount, static_cast<const uint8_t*>(pVertexData), (uint32_t) vertexStride, minPos, maxPos);
+      } else {
+        fast::findMinMaxFloat3(vertexCount, static_cast<const uint8_t*>(pVertexData), (uint32_t) vertexStride, minPos, maxPos);
       }
 
       AxisAlignedBoundingBox boundingBox{
-        Vector3{ minPos.m128_f32[0], minPos.m128_f32[1], minPos.m128_f32[2] },
-        Vector3{ maxPos.m128_f32[0], maxPos.m128_f32[1], maxPos.m128_f32[2] }
+        Vector3{ minPos[0], minPos[1], minPos[2] },
+        Vector3{ maxPos[0], maxPos[1], maxPos[2] }
       };
 
       vertexBuffer->decRef();
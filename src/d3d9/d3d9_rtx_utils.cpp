@@ -18,16 +18,11 @@ namespace dxvk {
     if (vertexCount == 0)
       return false;
 
-    minBoneIndex = 256;
-    maxBoneIndex = -1;
+    uint32_t minIndex, maxIndex;
+    fast::findMinMaxBytes(vertexCount, pBoneIndices, stride, numBonesPerVertex, minIndex, maxIndex);
 
-    for (uint32_t i = 0; i < vertexCount; ++i) {
-      for (uint32_t j = 0; j < numBonesPerVertex; ++j) {
-        minBoneIndex = std::min(minBoneIndex, (int) pBoneIndices[j]);
-        maxBoneIndex = std::max(maxBoneIndex, (int) pBoneIndices[j]);
-      }
-      pBoneIndices += stride;
-    }
+    minBoneIndex = (int) minIndex;
+    maxBoneIndex = (int) maxIndex;
 
     return true;
   }
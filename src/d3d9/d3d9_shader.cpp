@@ -1,9 +1,14 @@
 #include "d3d9_shader.h"
 
+#include <algorithm>
+
 #include "d3d9_caps.h"
 #include "d3d9_device.h"
 #include "d3d9_util.h"
 #include "../dxvk/dxvk_scoped_annotation.h"
+// NV-DXVK start
+#include "../dxvk/rtx_render/rtx_thread_budget.h"
+// NV-DXVK end
 
 
 namespace dxvk {
@@ -17,10 +22,14 @@ namespace dxvk {
       const DxsoModuleInfo*       pDxsoModuleInfo,
       const void*                 pShaderBytecode,
       const DxsoAnalysisInfo&     AnalysisInfo,
-            DxsoModule*           pModule) {
+            DxsoModule*           pModule,
+            D3D9ShaderDiskCache*  pDiskCache) {
     const uint32_t bytecodeLength = AnalysisInfo.bytecodeByteLength;
     m_bytecode.resize(bytecodeLength);
     std::memcpy(m_bytecode.data(), pShaderBytecode, bytecodeLength);
+    // NV-DXVK start: hash the bytecode once instead of for every draw
+    m_bytecodeHash = XXH3_64bits(m_bytecode.data(), m_bytecode.size());
+    // NV-DXVK end
 
     const std::string name = Key.toString();
     Logger::debug(str::format("Compiling shader ", name));
@@ -58,25 +67,39 @@ namespace dxvk {
     const D3D9ConstantLayout& constantLayout = ShaderStage == VK_SHADER_STAGE_VERTEX_BIT
       ? pDevice->GetVertexConstantLayout()
       : pDevice->GetPixelConstantLayout();
-    m_shaders      = pModule->compile(*pDxsoModuleInfo, name, AnalysisInfo, constantLayout);
-    m_isgn         = pModule->isgn();
-    // NV-DXVK start: expose shader outputs for vertex capture
-    m_osgn = pModule->osgn();
+
+    // NV-DXVK start: DXSO translation disk cache
+    const uint64_t inputHash = pDiskCache != nullptr
+      ? D3D9ShaderDiskCache::HashInputs(*pDxsoModuleInfo, constantLayout)
+      : 0;
+
+    if (pDiskCache == nullptr || !pDiskCache->Read(Key, inputHash, *this)) {
     // NV-DXVK end
-    m_usedSamplers = pModule->usedSamplers();
+      m_shaders      = pModule->compile(*pDxsoModuleInfo, name, AnalysisInfo, constantLayout);
+      m_isgn         = pModule->isgn();
+      // NV-DXVK start: expose shader outputs for vertex capture
+      m_osgn = pModule->osgn();
+      // NV-DXVK end
+      m_usedSamplers = pModule->usedSamplers();
+
+      // Shift up these sampler bits so we can just
+      // do an or per-draw in the device.
+      // We shift by 17 because 16 ps samplers + 1 dmap (tess)
+      if (ShaderStage == VK_SHADER_STAGE_VERTEX_BIT)
+        m_usedSamplers <<= caps::MaxTexturesPS + 1;
 
-    // Shift up these sampler bits so we can just
-    // do an or per-draw in the device.
-    // We shift by 17 because 16 ps samplers + 1 dmap (tess)
-    if (ShaderStage == VK_SHADER_STAGE_VERTEX_BIT)
-      m_usedSamplers <<= caps::MaxTexturesPS + 1;
+      m_usedRTs      = pModule->usedRTs();
 
-    m_usedRTs      = pModule->usedRTs();
+      m_info      = pModule->info();
+      m_meta      = pModule->meta();
+      m_constants = pModule->constants();
+      m_maxDefinedConst = pModule->maxDefinedConstant();
 
-    m_info      = pModule->info();
-    m_meta      = pModule->meta();
-    m_constants = pModule->constants();
-    m_maxDefinedConst = pModule->maxDefinedConstant();
+    // NV-DXVK start: DXSO translation disk cache
+      if (pDiskCache != nullptr)
+        pDiskCache->Write(Key, inputHash, *this);
+    }
+    // NV-DXVK end
 
     m_shaders[0]->setShaderKey(Key);
 
@@ -100,6 +123,481 @@ namespace dxvk {
   }
 
 
+  // NV-DXVK start: async DXSO translation
+  D3D9CommonShader::D3D9CommonShader(
+      const Rc<D3D9ShaderTranslation>& Translation,
+      const void*                 pShaderBytecode,
+            uint32_t              BytecodeLength)
+    : m_translation(Translation) {
+    m_bytecode.resize(BytecodeLength);
+    std::memcpy(m_bytecode.data(), pShaderBytecode, BytecodeLength);
+    m_bytecodeHash = XXH3_64bits(m_bytecode.data(), m_bytecode.size());
+  }
+
+
+  bool D3D9CommonShader::IsReady() const {
+    return m_translation == nullptr
+        || (m_translation->IsDone() && !m_translation->IsFailed());
+  }
+
+
+  const D3D9CommonShader& D3D9CommonShader::Resolve() const {
+    if (likely(m_translation == nullptr))
+      return *this;
+
+    return m_translation->Wait();
+  }
+
+
+  const D3D9CommonShader& D3D9ShaderTranslation::Wait() const {
+    if (!IsDone()) {
+      ScopedCpuProfileZone();
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+      m_cond.wait(lock, [this] () { return IsDone(); });
+    }
+
+    return m_shader;
+  }
+
+
+  void D3D9ShaderTranslation::Finish(bool Failed) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+    m_failed.store(Failed, std::memory_order_release);
+    m_done.store(true, std::memory_order_release);
+    m_cond.notify_all();
+  }
+
+
+  D3D9ShaderModuleSet::~D3D9ShaderModuleSet() {
+    StopTranslation();
+  }
+
+
+  void D3D9ShaderModuleSet::StopTranslation() {
+    { std::unique_lock<dxvk::mutex> lock(m_workerLock);
+      m_stopWorkers = true;
+      m_workerCond.notify_all();
+    }
+
+    for (auto& worker : m_workerThreads)
+      worker.join();
+
+    m_workerThreads.clear();
+
+    // Nothing can use these anymore, but don't leave anyone waiting on them
+    while (!m_workerQueue.empty()) {
+      m_workerQueue.front()->Finish(true);
+      m_workerQueue.pop();
+    }
+  }
+
+
+  void D3D9ShaderModuleSet::TranslateAsync(const Rc<D3D9ShaderTranslation>& Translation) {
+    std::unique_lock<dxvk::mutex> lock(m_workerLock);
+
+    if (unlikely(m_stopWorkers)) {
+      Translation->Finish(true);
+      return;
+    }
+
+    if (m_workerThreads.empty()) {
+      // NV-DXVK start: share the CPU with the other worker thread groups
+      const uint32_t numWorkers = RtxThreadBudget::getThreadCount(ThreadClass::Background, std::clamp(dxvk::thread::hardware_concurrency() / 2, 1u, 4u));
+      // NV-DXVK end
+
+      for (uint32_t i = 0; i < numWorkers; i++) {
+        m_workerThreads.emplace_back([this] () { WorkerFunc(); });
+        m_workerThreads[i].set_priority(ThreadPriority::Lowest);
+      }
+    }
+
+    m_workerQueue.push(Translation);
+    m_workerCond.notify_one();
+  }
+
+
+  void D3D9ShaderModuleSet::WorkerFunc() {
+    env::setThreadName("dxvk-dxso");
+
+    while (true) {
+      Rc<D3D9ShaderTranslation> translation;
+
+      { std::unique_lock<dxvk::mutex> lock(m_workerLock);
+
+        m_workerCond.wait(lock, [this] () {
+          return !m_workerQueue.empty() || m_stopWorkers;
+        });
+
+        if (m_stopWorkers)
+          return;
+
+        translation = std::move(m_workerQueue.front());
+        m_workerQueue.pop();
+      }
+
+      try {
+        DxsoReader reader(
+          reinterpret_cast<const char*>(translation->m_bytecode.data()));
+
+        DxsoModule module(reader);
+
+        translation->m_shader = D3D9CommonShader(
+          translation->m_device, translation->m_stage, translation->m_key,
+          &translation->m_moduleInfo, translation->m_bytecode.data(),
+          translation->m_analysis, &module, GetDiskCache());
+
+        translation->Finish(false);
+      } catch (const DxvkError& e) {
+        Logger::err(str::format("D3D9: Failed to translate shader ", translation->m_key.toString(), ": ", e.message()));
+        translation->Finish(true);
+      }
+    }
+  }
+  // NV-DXVK end
+
+
+  // NV-DXVK start: DXSO translation disk cache
+  namespace {
+    // Bump when the DXSO compiler output or the entry layout changes
+    constexpr uint32_t D3D9ShaderDiskCacheVersion = 2;
+
+    struct D3D9ShaderDiskCacheHeader {
+      char     magic[4]     = { 'D', '9', 'S', 'C' };
+      uint32_t version      = D3D9ShaderDiskCacheVersion;
+      uint32_t isgnSize     = sizeof(DxsoIsgn);
+      uint32_t metaSize     = sizeof(DxsoShaderMetaInfo);
+      uint32_t slotSize     = sizeof(DxvkResourceSlot);
+      uint32_t numShaders   = D3D9ShaderPermutations::Count;
+    };
+
+    struct D3D9ShaderDiskCacheEntryHeader {
+      DxvkShaderKey key;
+      uint32_t      size;
+      uint64_t      inputHash;
+      uint64_t      dataHash;
+    };
+
+    class D3D9ShaderDiskCacheWriter {
+
+    public:
+
+      template <typename T>
+      void Write(const T& Value) {
+        Write(&Value, sizeof(Value));
+      }
+
+      void Write(const void* pData, size_t Size) {
+        const char* data = reinterpret_cast<const char*>(pData);
+        m_data.insert(m_data.end(), data, data + Size);
+      }
+
+      const std::vector<char>& GetData() const {
+        return m_data;
+      }
+
+    private:
+
+      std::vector<char> m_data;
+
+    };
+
+    class D3D9ShaderDiskCacheReader {
+
+    public:
+
+      D3D9ShaderDiskCacheReader(const std::vector<char>& Data)
+        : m_data(Data) { }
+
+      template <typename T>
+      bool Read(T& Value) {
+        return Read(&Value, sizeof(Value));
+      }
+
+      bool Read(void* pData, size_t Size) {
+        if (Size > m_data.size() - m_offset)
+          return false;
+
+        std::memcpy(pData, m_data.data() + m_offset, Size);
+        m_offset += Size;
+        return true;
+      }
+
+    private:
+
+      const std::vector<char>& m_data;
+      size_t                   m_offset = 0;
+
+    };
+
+    std::wstring GetShaderDiskCacheFileName() {
+      // Lives next to the state cache, like the fixed function shader cache
+      std::string path = env::getEnvVar("DXVK_STATE_CACHE_PATH");
+
+      if (!path.empty() && *path.rbegin() != '/')
+        path += '/';
+
+      path += env::getExeBaseName() + ".d3d9-shader-cache";
+      return str::tows(path.c_str());
+    }
+  }
+
+
+  void D3D9ShaderDiskCache::Enable() {
+    const std::wstring fileName = GetShaderDiskCacheFileName();
+
+    bool validFile = false;
+
+    m_readFile = std::ifstream(fileName.c_str(), std::ios_base::binary);
+
+    D3D9ShaderDiskCacheHeader expected;
+    D3D9ShaderDiskCacheHeader header;
+
+    if (m_readFile && m_readFile.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      validFile = std::memcmp(&header, &expected, sizeof(header)) == 0;
+
+      if (!validFile)
+        Logger::warn("D3D9: Shader translation cache out of date, discarding");
+    }
+
+    if (validFile) {
+      m_readFile.seekg(0, std::ios_base::end);
+      const std::streamoff fileSize = m_readFile.tellg();
+      m_readFile.seekg(sizeof(header), std::ios_base::beg);
+
+      D3D9ShaderDiskCacheEntryHeader entryHeader;
+
+      // Only index the entries, the data is read once a shader is used.
+      // A truncated last entry is just left out of the index.
+      while (m_readFile.read(reinterpret_cast<char*>(&entryHeader), sizeof(entryHeader))) {
+        Entry entry;
+        entry.inputHash = entryHeader.inputHash;
+        entry.dataHash  = entryHeader.dataHash;
+        entry.offset    = m_readFile.tellg();
+        entry.size      = entryHeader.size;
+
+        if (entry.offset + entry.size > fileSize)
+          break;
+
+        m_entries.insert_or_assign(entryHeader.key, entry);
+        m_readFile.seekg(entry.size, std::ios_base::cur);
+      }
+
+      Logger::info(str::format("D3D9: Found ", m_entries.size(), " shaders in the shader translation cache"));
+
+      // Reading stopped at the end of the file, which
+      // left the stream in a state nothing can be read in
+      m_readFile.clear();
+    } else {
+      m_readFile.close();
+    }
+
+    if (validFile) {
+      m_writeFile = std::ofstream(fileName.c_str(), std::ios_base::binary | std::ios_base::app);
+    } else {
+      m_writeFile = std::ofstream(fileName.c_str(), std::ios_base::binary | std::ios_base::trunc);
+      m_writeFile.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+    }
+
+    if (!m_writeFile)
+      Logger::warn("D3D9: Failed to open shader translation cache for writing");
+
+    m_enabled = true;
+  }
+
+
+  uint64_t D3D9ShaderDiskCache::HashInputs(
+    const DxsoModuleInfo&       ModuleInfo,
+    const D3D9ConstantLayout&   Layout) {
+    // Listed one by one so that struct padding doesn't end up in the hash
+    const DxsoOptions& options = ModuleInfo.options;
+
+    const uint32_t inputs[] = {
+      options.useDemoteToHelperInvocation,
+      options.useSubgroupOpsForEarlyDiscard,
+      options.strictConstantCopies,
+      uint32_t(options.d3d9FloatEmulation),
+      options.strictPow,
+      options.shaderModel,
+      options.invariantPosition,
+      options.forceSamplerTypeSpecConstants,
+      options.vertexFloatConstantBufferAsSSBO,
+      options.longMad,
+      options.alphaTestWiggleRoom,
+      options.robustness2Supported,
+      Layout.floatCount,
+      Layout.intCount,
+      Layout.boolCount,
+      Layout.bitmaskCount,
+    };
+
+    return XXH3_64bits(inputs, sizeof(inputs));
+  }
+
+
+  bool D3D9ShaderDiskCache::Contains(
+    const DxvkShaderKey&        Key,
+          uint64_t              InputHash) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    auto entry = m_entries.find(Key);
+    return entry != m_entries.end() && entry->second.inputHash == InputHash;
+  }
+
+
+  bool D3D9ShaderDiskCache::Read(
+    const DxvkShaderKey&        Key,
+          uint64_t              InputHash,
+          D3D9CommonShader&     Shader) {
+    ScopedCpuProfileZone();
+    std::vector<char> data;
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      auto entry = m_entries.find(Key);
+      if (entry == m_entries.end() || entry->second.inputHash != InputHash)
+        return false;
+
+      data.resize(entry->second.size);
+
+      bool valid = m_readFile.seekg(entry->second.offset)
+                && m_readFile.read(data.data(), data.size())
+                && XXH3_64bits(data.data(), data.size()) == entry->second.dataHash;
+
+      if (!valid) {
+        Logger::warn(str::format("D3D9: Corrupted shader translation cache entry for ", Key.toString()));
+        m_readFile.clear();
+        m_entries.erase(entry);
+        return false;
+      }
+    }
+
+    D3D9ShaderDiskCacheReader reader(data);
+
+    uint32_t numConstants = 0;
+
+    bool valid = reader.Read(Shader.m_isgn)
+              && reader.Read(Shader.m_osgn)
+              && reader.Read(Shader.m_usedSamplers)
+              && reader.Read(Shader.m_usedRTs)
+              && reader.Read(Shader.m_info)
+              && reader.Read(Shader.m_meta)
+              && reader.Read(Shader.m_maxDefinedConst)
+              && reader.Read(numConstants);
+
+    if (valid) {
+      Shader.m_constants.resize(numConstants);
+      valid = reader.Read(Shader.m_constants.data(), numConstants * sizeof(DxsoDefinedConstant));
+    }
+
+    for (uint32_t i = 0; i < D3D9ShaderPermutations::Count && valid; i++) {
+      uint32_t present = 0;
+      valid = reader.Read(present);
+
+      if (!valid || !present) {
+        Shader.m_shaders[i] = nullptr;
+        continue;
+      }
+
+      DxvkInterfaceSlots iface;
+      uint32_t numSlots = 0;
+      uint32_t numDwords = 0;
+
+      valid = reader.Read(iface) && reader.Read(numSlots);
+
+      std::vector<DxvkResourceSlot> slots(valid ? numSlots : 0);
+      valid = valid && reader.Read(slots.data(), numSlots * sizeof(DxvkResourceSlot))
+                    && reader.Read(numDwords);
+
+      std::vector<uint32_t> code(valid ? numDwords : 0);
+      valid = valid && reader.Read(code.data(), numDwords * sizeof(uint32_t));
+
+      // Same options and constant data as the DXSO compiler uses
+      if (valid) {
+        Shader.m_shaders[i] = new DxvkShader(
+          VkShaderStageFlagBits(Key.type()),
+          slots.size(), slots.data(), iface,
+          SpirvCodeBuffer(code.size(), code.data()),
+          DxvkShaderOptions(), DxvkShaderConstData());
+      }
+    }
+
+    // The data hash matched, so this can only be a bug in the writer
+    if (!valid) {
+      Logger::err(str::format("D3D9: Failed to read shader translation cache entry for ", Key.toString()));
+      Shader.m_shaders = DxsoPermutations();
+    }
+
+    return valid;
+  }
+
+
+  void D3D9ShaderDiskCache::Write(
+    const DxvkShaderKey&        Key,
+          uint64_t              InputHash,
+    const D3D9CommonShader&     Shader) {
+    D3D9ShaderDiskCacheWriter writer;
+    writer.Write(Shader.m_isgn);
+    writer.Write(Shader.m_osgn);
+    writer.Write(Shader.m_usedSamplers);
+    writer.Write(Shader.m_usedRTs);
+    writer.Write(Shader.m_info);
+    writer.Write(Shader.m_meta);
+    writer.Write(Shader.m_maxDefinedConst);
+    writer.Write(uint32_t(Shader.m_constants.size()));
+    writer.Write(Shader.m_constants.data(), Shader.m_constants.size() * sizeof(DxsoDefinedConstant));
+
+    for (const auto& shader : Shader.m_shaders) {
+      writer.Write(uint32_t(shader != nullptr));
+
+      if (shader == nullptr)
+        continue;
+
+      const SpirvCodeBuffer code = shader->code();
+      const auto& slots = shader->resourceSlots();
+
+      writer.Write(shader->interfaceSlots());
+      writer.Write(uint32_t(slots.size()));
+      writer.Write(slots.data(), slots.size() * sizeof(DxvkResourceSlot));
+      writer.Write(code.dwords());
+      writer.Write(code.data(), code.size());
+    }
+
+    const std::vector<char>& data = writer.GetData();
+
+    D3D9ShaderDiskCacheEntryHeader header;
+    header.key       = Key;
+    header.size      = data.size();
+    header.inputHash = InputHash;
+    header.dataHash  = XXH3_64bits(data.data(), data.size());
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (!m_writeFile)
+      return;
+
+    m_writeFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_writeFile.write(data.data(), data.size());
+    m_writeFile.flush();
+  }
+
+
+  bool D3D9ShaderModuleSet::IsInDiskCache(
+          D3D9DeviceEx*         pDevice,
+          VkShaderStageFlagBits ShaderStage,
+    const DxvkShaderKey&        Key,
+    const DxsoModuleInfo*       pDxbcModuleInfo) {
+    if (!m_diskCache.IsEnabled())
+      return false;
+
+    const D3D9ConstantLayout& constantLayout = ShaderStage == VK_SHADER_STAGE_VERTEX_BIT
+      ? pDevice->GetVertexConstantLayout()
+      : pDevice->GetPixelConstantLayout();
+
+    return m_diskCache.Contains(Key, D3D9ShaderDiskCache::HashInputs(*pDxbcModuleInfo, constantLayout));
+  }
+  // NV-DXVK end
+
+
   void D3D9ShaderModuleSet::GetShaderModule(
             D3D9DeviceEx*         pDevice,
             D3D9CommonShader*     pShaderModule,
@@ -134,12 +632,43 @@ namespace dxvk {
       }
     }
     
+    // NV-DXVK start: async DXSO translation
+    // Hand the translation to a worker, the shader is added to the lookup table right
+    // away so that creating it again while it is being translated doesn't queue it twice.
+    // Shaders in the disk cache are cheap enough to create right away.
+    if (pDevice->GetOptions()->asyncShaderTranslation && !IsInDiskCache(pDevice, ShaderStage, lookupKey, pDxbcModuleInfo)) {
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      auto entry = m_modules.find(lookupKey);
+      if (entry != m_modules.end()) {
+        *pShaderModule = entry->second;
+        return;
+      }
+
+      Rc<D3D9ShaderTranslation> translation = new D3D9ShaderTranslation();
+      translation->m_device     = pDevice;
+      translation->m_stage      = ShaderStage;
+      translation->m_key        = lookupKey;
+      translation->m_moduleInfo = *pDxbcModuleInfo;
+      translation->m_analysis   = info;
+      translation->m_bytecode.assign(
+        reinterpret_cast<const uint8_t*>(pShaderBytecode),
+        reinterpret_cast<const uint8_t*>(pShaderBytecode) + info.bytecodeByteLength);
+
+      *pShaderModule = D3D9CommonShader(translation, pShaderBytecode, info.bytecodeByteLength);
+      m_modules.insert({ lookupKey, *pShaderModule });
+
+      TranslateAsync(translation);
+      return;
+    }
+    // NV-DXVK end
+
     // This shader has not been compiled yet, so we have to create a
     // new module. This takes a while, so we won't lock the structure.
     *pShaderModule = D3D9CommonShader(
       pDevice, ShaderStage, lookupKey,
       pDxbcModuleInfo, pShaderBytecode,
-      info, &module);
+      info, &module, GetDiskCache());
     
     // Insert the new module into the lookup table. If another thread
     // has compiled the same shader in the meantime, we should return
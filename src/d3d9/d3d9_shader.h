@@ -4,11 +4,17 @@
 #include "../dxso/dxso_module.h"
 #include "d3d9_shader_permutations.h"
 #include "d3d9_util.h"
+#include "../util/xxHash/xxhash.h"
 
 #include <array>
+#include <fstream>
+#include <queue>
 
 namespace dxvk {
 
+  class D3D9ShaderTranslation;
+  class D3D9ShaderDiskCache;
+
 
   /**
    * \brief Common shader object
@@ -30,15 +36,39 @@ namespace dxvk {
       const DxsoModuleInfo*       pDxbcModuleInfo,
       const void*                 pShaderBytecode,
       const DxsoAnalysisInfo&     AnalysisInfo,
-            DxsoModule*           pModule);
-
+            DxsoModule*           pModule,
+            // NV-DXVK start: DXSO translation disk cache
+            D3D9ShaderDiskCache*  pDiskCache = nullptr);
+            // NV-DXVK end
+
+    // NV-DXVK start: async DXSO translation
+    /**
+     * \brief Creates a shader that is being translated on a worker
+     *
+     * Only the bytecode is available right away, every other
+     * getter waits for the translation to finish. Use IsReady
+     * to find out whether that would block.
+     */
+    D3D9CommonShader(
+      const Rc<D3D9ShaderTranslation>& Translation,
+      const void*                 pShaderBytecode,
+            uint32_t              BytecodeLength);
+
+    /**
+     * \brief Checks whether the shader can be used
+     *
+     * False while the shader is still being translated,
+     * and for good if the translation failed.
+     */
+    bool IsReady() const;
+    // NV-DXVK end
 
     Rc<DxvkShader> GetShader(D3D9ShaderPermutation Permutation) const {
-      return m_shaders[Permutation];
+      return Resolve().m_shaders[Permutation];
     }
 
     std::string GetName() const {
-      return m_shaders[D3D9ShaderPermutations::None]->debugName();
+      return Resolve().m_shaders[D3D9ShaderPermutations::None]->debugName();
     }
 
     const std::vector<uint8_t>& GetBytecode() const {
@@ -46,26 +76,43 @@ namespace dxvk {
     }
 
     const DxsoIsgn& GetIsgn() const {
-      return m_isgn;
+      return Resolve().m_isgn;
     }
 
     // NV-DXVK start: expose shader outputs for vertex capture
     const DxsoIsgn& GetOsgn() const {
-      return m_osgn;
+      return Resolve().m_osgn;
     }
     // NV-DXVK end
 
-    const DxsoShaderMetaInfo& GetMeta() const { return m_meta; }
-    const DxsoDefinedConstants& GetConstants() const { return m_constants; }
+    // NV-DXVK start: hash the bytecode once instead of for every draw
+    XXH64_hash_t GetBytecodeHash() const {
+      return m_bytecodeHash;
+    }
+    // NV-DXVK end
 
-    D3D9ShaderMasks GetShaderMask() const { return D3D9ShaderMasks{ m_usedSamplers, m_usedRTs }; }
+    const DxsoShaderMetaInfo& GetMeta() const { return Resolve().m_meta; }
+    const DxsoDefinedConstants& GetConstants() const { return Resolve().m_constants; }
 
-    const DxsoProgramInfo& GetInfo() const { return m_info; }
+    D3D9ShaderMasks GetShaderMask() const { return D3D9ShaderMasks{ Resolve().m_usedSamplers, Resolve().m_usedRTs }; }
 
-    uint32_t GetMaxDefinedConstant() const { return m_maxDefinedConst; }
+    const DxsoProgramInfo& GetInfo() const { return Resolve().m_info; }
+
+    uint32_t GetMaxDefinedConstant() const { return Resolve().m_maxDefinedConst; }
 
   private:
 
+    // NV-DXVK start: DXSO translation disk cache
+    friend class D3D9ShaderDiskCache;
+    // NV-DXVK end
+
+    // NV-DXVK start: async DXSO translation
+    // Set for shaders that are translated on a worker, the translated shader lives there
+    Rc<D3D9ShaderTranslation> m_translation;
+
+    const D3D9CommonShader& Resolve() const;
+    // NV-DXVK end
+
     DxsoIsgn              m_isgn;
     // NV-DXVK start: expose shader outputs for vertex capture
     DxsoIsgn              m_osgn;
@@ -81,6 +128,9 @@ namespace dxvk {
     DxsoPermutations      m_shaders;
 
     std::vector<uint8_t>  m_bytecode;
+    // NV-DXVK start: hash the bytecode once instead of for every draw
+    XXH64_hash_t          m_bytecodeHash = 0;
+    // NV-DXVK end
 
   };
 
@@ -170,6 +220,132 @@ namespace dxvk {
 
   };
 
+  // NV-DXVK start: DXSO translation disk cache
+  /**
+   * \brief On-disk cache of translated shaders
+   *
+   * Stores the SPIR-V code and reflection data of translated
+   * shaders, keyed by the shader key and a hash of everything
+   * else the translation depends on, so that later runs don't
+   * have to translate them again. Only the index is read when
+   * the cache is enabled, entries are read on use. Thread-safe.
+   */
+  class D3D9ShaderDiskCache {
+
+  public:
+
+    /**
+     * \brief Opens the cache file
+     *
+     * Must be called before any shader is
+     * looked up in or written to the cache.
+     */
+    void Enable();
+
+    bool IsEnabled() const {
+      return m_enabled;
+    }
+
+    /**
+     * \brief Hashes the translation inputs besides the bytecode
+     *
+     * \param [in] ModuleInfo Module info the shader is compiled with
+     * \param [in] Layout Constant layout of the shader stage
+     * \returns Hash to look up and write entries with
+     */
+    static uint64_t HashInputs(
+      const DxsoModuleInfo&       ModuleInfo,
+      const D3D9ConstantLayout&   Layout);
+
+    bool Contains(
+      const DxvkShaderKey&        Key,
+            uint64_t              InputHash);
+
+    /**
+     * \brief Fills in a shader from the cache
+     *
+     * Creates the SPIR-V shaders and copies the reflection data,
+     * the shader keys still have to be set by the caller.
+     * \returns \c true if the shader was found and read
+     */
+    bool Read(
+      const DxvkShaderKey&        Key,
+            uint64_t              InputHash,
+            D3D9CommonShader&     Shader);
+
+    void Write(
+      const DxvkShaderKey&        Key,
+            uint64_t              InputHash,
+      const D3D9CommonShader&     Shader);
+
+  private:
+
+    struct Entry {
+      uint64_t       inputHash;
+      uint64_t       dataHash;
+      std::streamoff offset;
+      uint32_t       size;
+    };
+
+    bool          m_enabled = false;
+
+    dxvk::mutex   m_mutex;
+    std::ifstream m_readFile;
+    std::ofstream m_writeFile;
+
+    std::unordered_map<
+      DxvkShaderKey,
+      Entry,
+      DxvkHash, DxvkEq> m_entries;
+
+  };
+  // NV-DXVK end
+
+  // NV-DXVK start: async DXSO translation
+  /**
+   * \brief Shader translation running on a worker
+   *
+   * Shared by all copies of the common shader
+   * it was created for. Thread-safe.
+   */
+  class D3D9ShaderTranslation : public RcObject {
+    friend class D3D9ShaderModuleSet;
+  public:
+
+    bool IsDone() const {
+      return m_done.load(std::memory_order_acquire);
+    }
+
+    bool IsFailed() const {
+      return m_failed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Waits for the translation to finish
+     * \returns The translated shader, an empty one on failure
+     */
+    const D3D9CommonShader& Wait() const;
+
+  private:
+
+    D3D9DeviceEx*         m_device;
+    VkShaderStageFlagBits m_stage;
+    DxvkShaderKey         m_key;
+    DxsoModuleInfo        m_moduleInfo;
+    DxsoAnalysisInfo      m_analysis;
+    std::vector<uint8_t>  m_bytecode;
+
+    D3D9CommonShader      m_shader;
+
+    mutable dxvk::mutex              m_mutex;
+    mutable dxvk::condition_variable m_cond;
+    std::atomic<bool>     m_done   = { false };
+    std::atomic<bool>     m_failed = { false };
+
+    void Finish(bool Failed);
+  };
+  // NV-DXVK end
+
   /**
    * \brief Shader module set
    * 
@@ -181,6 +357,29 @@ namespace dxvk {
   class D3D9ShaderModuleSet : public RcObject {
     
   public:
+
+    // NV-DXVK start: async DXSO translation
+    ~D3D9ShaderModuleSet();
+
+    /**
+     * \brief Stops the translation workers
+     *
+     * Shaders that are still queued fail to translate.
+     * Must be called before the device goes away.
+     */
+    void StopTranslation();
+    // NV-DXVK end
+
+    // NV-DXVK start: DXSO translation disk cache
+    /**
+     * \brief Enables the on-disk translation cache
+     *
+     * Must be called before the first shader is created.
+     */
+    void EnableDiskCache() {
+      m_diskCache.Enable();
+    }
+    // NV-DXVK end
     
     void GetShaderModule(
             D3D9DeviceEx*         pDevice,
@@ -197,6 +396,32 @@ namespace dxvk {
       DxvkShaderKey,
       D3D9CommonShader,
       DxvkHash, DxvkEq> m_modules;
+
+    // NV-DXVK start: DXSO translation disk cache
+    D3D9ShaderDiskCache m_diskCache;
+
+    D3D9ShaderDiskCache* GetDiskCache() {
+      return m_diskCache.IsEnabled() ? &m_diskCache : nullptr;
+    }
+
+    bool IsInDiskCache(
+            D3D9DeviceEx*         pDevice,
+            VkShaderStageFlagBits ShaderStage,
+      const DxvkShaderKey&        Key,
+      const DxsoModuleInfo*       pDxbcModuleInfo);
+    // NV-DXVK end
+
+    // NV-DXVK start: async DXSO translation
+    dxvk::mutex                             m_workerLock;
+    dxvk::condition_variable                m_workerCond;
+    std::queue<Rc<D3D9ShaderTranslation>>   m_workerQueue;
+    std::vector<dxvk::thread>               m_workerThreads;
+    bool                                    m_stopWorkers = false;
+
+    void TranslateAsync(const Rc<D3D9ShaderTranslation>& Translation);
+
+    void WorkerFunc();
+    // NV-DXVK end
     
   };
 
@@ -24,6 +24,7 @@ namespace dxvk {
     CustomVertexTransformEnabled = 11,
     ReplacementTextureCategory = 12,
     ClipSpaceJitterEnabled = 13,
+    VertexCaptureEnabled = 14,
     // NV-DXVK end
 
     Count
@@ -38,7 +38,7 @@ namespace dxvk {
     uint32_t baseVertex = 0;
     float jitterX;
     float jitterY;
-    uint32_t padding;
+    uint32_t discardRasterization = 0;
   };
 
   enum class D3D9RtxVertexCaptureMembers {
@@ -48,6 +48,7 @@ namespace dxvk {
     BaseVertex,
     JitterX,
     JitterY,
+    DiscardRasterization,
 
     MemberCount
   };
@@ -496,6 +496,7 @@ namespace dxvk {
         uintType,
         floatType,
         floatType,
+        uintType,
       };
       static_assert(uint32_t(D3D9RtxVertexCaptureMembers::MemberCount) == std::size(members));
 
@@ -522,6 +523,7 @@ namespace dxvk {
       SetMemberName("base_vertex", offsetof(D3D9RtxVertexCaptureData, baseVertex));
       SetMemberName("jitter_x", offsetof(D3D9RtxVertexCaptureData, jitterX));
       SetMemberName("jitter_y", offsetof(D3D9RtxVertexCaptureData, jitterY));
+      SetMemberName("discard_rasterization", offsetof(D3D9RtxVertexCaptureData, discardRasterization));
 
       m_vs.vertexCaptureConstants = m_module.newVar(
         m_module.defPointerType(structType, spv::StorageClassUniform),
@@ -3721,6 +3723,20 @@ void DxsoCompiler::emitControlFlowGenericLoop(
     // Perform clip space to world space
     const uint32_t worldPosId = m_module.opVectorTimesMatrix(vec4typeId, projPosId, projToWorldRefId);
 
+    // Only write the vertex out if the draw is being captured, draws that aren't
+    // get a pipeline with the writes specialized away.
+    const uint32_t vertexCaptureEnabledId = m_module.specConstBool(false);
+    m_module.setDebugName(vertexCaptureEnabledId, "vertex_capture_enabled");
+    m_module.decorateSpecId(vertexCaptureEnabledId, getSpecId(D3D9SpecConstantId::VertexCaptureEnabled));
+
+    const uint32_t labelCapture = m_module.allocateId();
+    const uint32_t labelCaptureEnd = m_module.allocateId();
+
+    // if (vertexCaptureEnabled) { ... }
+    m_module.opSelectionMerge(labelCaptureEnd, spv::SelectionControlMaskNone);
+    m_module.opBranchConditional(vertexCaptureEnabledId, labelCapture, labelCaptureEnd);
+    m_module.opLabel(labelCapture);
+
     // Write the data to buffer
     SpirvImageOperands defaultOperands;
 
@@ -3785,6 +3801,9 @@ void DxsoCompiler::emitControlFlowGenericLoop(
       emitVertexCaptureWrite(writeAddress, normal0);
     }
 
+    m_module.opBranch(labelCaptureEnd);
+    m_module.opLabel(labelCaptureEnd);
+
     // Apply custom vertex transform if it's enabled
     {
       uint32_t labelIf = m_module.allocateId();
@@ -3867,6 +3886,32 @@ void DxsoCompiler::emitControlFlowGenericLoop(
         m_module.opLabel(labelEnd);
       }
     }
+
+    // Move the primitives of captured draws that are only ray traced out of the clip volume, so they aren't rasterized
+    {
+      const uint32_t boolTypeId = m_module.defBoolType();
+
+      const uint32_t labelIf = m_module.allocateId();
+      const uint32_t labelEnd = m_module.allocateId();
+
+      // The constant is only valid for captured draws
+      const uint32_t discardRasterizationId = LoadConstant(uintType, (uint32_t) (D3D9RtxVertexCaptureMembers::DiscardRasterization));
+      const uint32_t isDiscardingId = m_module.opLogicalAnd(boolTypeId, vertexCaptureEnabledId,
+                                                            m_module.opINotEqual(boolTypeId, discardRasterizationId, m_module.constu32(0)));
+
+      // if (vertexCaptureEnabled && discardRasterization) { ... }
+      m_module.opSelectionMerge(labelEnd, spv::SelectionControlMaskNone);
+      m_module.opBranchConditional(isDiscardingId, labelIf, labelEnd);
+      {
+        m_module.opLabel(labelIf);
+
+        // A negative w fails every clip plane test
+        m_module.opStore(m_vs.oPos.id, m_module.constvec4f32(0.0f, 0.0f, 0.0f, -1.0f));
+
+        m_module.opBranch(labelEnd);
+        m_module.opLabel(labelEnd);
+      }
+    }
   }
   // NV-DXVK end
 
@@ -13,14 +13,6 @@ namespace dxvk {
     const auto& graphicsQueue = m_device->queues().graphics;
     const auto& transferQueue = m_device->queues().transfer;
 
-    VkFenceCreateInfo fenceInfo;
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.pNext = nullptr;
-    fenceInfo.flags = 0;
-    
-    if (m_vkd->vkCreateFence(m_vkd->device(), &fenceInfo, nullptr, &m_fence) != VK_SUCCESS)
-      throw DxvkError("DxvkCommandList: Failed to create fence");
-    
     VkCommandPoolCreateInfo poolInfo;
     poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.pNext            = nullptr;
@@ -75,8 +67,6 @@ namespace dxvk {
     
     m_vkd->vkDestroyCommandPool(m_vkd->device(), m_graphicsPool, nullptr);
     m_vkd->vkDestroyCommandPool(m_vkd->device(), m_transferPool, nullptr);
-    
-    m_vkd->vkDestroyFence(m_vkd->device(), m_fence, nullptr);
   }
 
   // NV-DXVK start: DLFG integration
@@ -162,19 +152,37 @@ namespace dxvk {
     }
     // NV-DXVK end
 
-    return submitToQueue(graphics.queueHandle, m_fence, info);
+    // NV-DXVK start: timeline semaphore completion tracking
+    assert(m_timelineSemaphore != VK_NULL_HANDLE);
+    assert(info.wakeCount < (sizeof(info.wakeSync) / sizeof(info.wakeSync[0])));
+    info.wakeSync[info.wakeCount] = m_timelineSemaphore;
+    info.wakeValue[info.wakeCount] = m_timelineValue;
+    info.wakeCount += 1;
+
+    return submitToQueue(graphics.queueHandle, VK_NULL_HANDLE, info);
+    // NV-DXVK end
   }
   
   
   VkResult DxvkCommandList::synchronize() {
     ScopedCpuProfileZone();
+    // NV-DXVK start: timeline semaphore completion tracking
+    VkSemaphoreWaitInfo waitInfo;
+    waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.pNext          = nullptr;
+    waitInfo.flags          = 0;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &m_timelineSemaphore;
+    waitInfo.pValues        = &m_timelineValue;
+
     VkResult status = VK_TIMEOUT;
     
     while (status == VK_TIMEOUT) {
-      status = m_vkd->vkWaitForFences(
-        m_vkd->device(), 1, &m_fence, VK_FALSE,
+      status = m_vkd->vkWaitSemaphores(
+        m_vkd->device(), &waitInfo,
         1'000'000'000ull);
     }
+    // NV-DXVK end
     
     return status;
   }
@@ -196,9 +204,6 @@ namespace dxvk {
      || m_vkd->vkBeginCommandBuffer(m_sdmaBuffer, &info) != VK_SUCCESS)
       Logger::err("DxvkCommandList: Failed to begin command buffer");
     
-    if (m_vkd->vkResetFences(m_vkd->device(), 1, &m_fence) != VK_SUCCESS)
-      Logger::err("DxvkCommandList: Failed to reset fence");
-    
     // Unconditionally mark the exec buffer as used. There
     // is virtually no use case where this isn't correct.
     m_cmdBuffersUsed = DxvkCmdBuffer::ExecBuffer;
@@ -63,13 +63,13 @@ namespace dxvk {
     VkSemaphore           waitSync[3];
     VkPipelineStageFlags  waitMask[3];
     uint32_t              wakeCount;
-    VkSemaphore           wakeSync[3];
+    VkSemaphore           wakeSync[4];
     uint32_t              cmdBufferCount;
     VkCommandBuffer       cmdBuffers[4];
 
     // NV-DXVK: DLFG integration
     uint64_t              waitValue[3] = { uint64_t(-1), uint64_t(-1), uint64_t(-1) };
-    uint64_t              wakeValue[3] = { uint64_t(-1), uint64_t(-1), uint64_t(-1) };
+    uint64_t              wakeValue[4] = { uint64_t(-1), uint64_t(-1), uint64_t(-1), uint64_t(-1) };
     // NV-DXVK end
   };
 
@@ -99,6 +99,23 @@ namespace dxvk {
      */
     void addSignalSemaphore(VkSemaphore signalSemaphore, uint64_t signalSemaphoreValue = -1);
     // NV-DXVK end
+
+    // NV-DXVK start: timeline semaphore completion tracking
+    /**
+     * \brief Sets the timeline value that signals completion
+     *
+     * The graphics queue submission signals the given
+     * timeline semaphore to the given value, which is
+     * what \ref synchronize waits for. Must be called
+     * before every submission of the command list.
+     * \param [in] semaphore Timeline semaphore
+     * \param [in] value Value to signal on completion
+     */
+    void setCompletionTimeline(VkSemaphore semaphore, uint64_t value) {
+      m_timelineSemaphore = semaphore;
+      m_timelineValue     = value;
+    }
+    // NV-DXVK end
     
     /**
      * \brief Submits command list
@@ -120,8 +137,8 @@ namespace dxvk {
     /**
      * \brief Synchronizes command buffer execution
      * 
-     * Waits for the fence associated with
-     * this command buffer to get signaled.
+     * Waits for the completion timeline semaphore
+     * to reach the value of this command buffer.
      * \returns Synchronization status
      */
     VkResult synchronize();
@@ -919,7 +936,10 @@ namespace dxvk {
     Rc<vk::DeviceFn>    m_vkd;
     Rc<vk::InstanceFn>  m_vki;
     
-    VkFence             m_fence;
+    // NV-DXVK start: timeline semaphore completion tracking
+    VkSemaphore         m_timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t            m_timelineValue     = 0;
+    // NV-DXVK end
     
     VkCommandPool       m_graphicsPool = VK_NULL_HANDLE;
     VkCommandPool       m_transferPool = VK_NULL_HANDLE;
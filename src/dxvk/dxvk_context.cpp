@@ -75,6 +75,15 @@ namespace dxvk {
     m_cmd = cmdList;
     m_cmd->beginRecording();
 
+    // NV-DXVK start: Tracy GPU zones that survive command list submissions
+#ifdef TRACY_ENABLE
+    for (TracyGpuZone& zone : m_tracyGpuZones) {
+      zone.scope = std::make_unique<tracy::VkCtxScope>(m_device->queues().graphics.tracyCtx, zone.srcloc,
+                                                       m_cmd->getCmdBuffer(DxvkCmdBuffer::ExecBuffer), true);
+    }
+#endif
+    // NV-DXVK end
+
     // Mark all resources as untracked
     m_vbTracked.clear();
     m_rcTracked.clear();
@@ -119,10 +128,33 @@ namespace dxvk {
     m_initBarriers.recordCommands(m_cmd);
     m_execBarriers.recordCommands(m_cmd);
 
+    // NV-DXVK start: Tracy GPU zones that survive command list submissions
+#ifdef TRACY_ENABLE
+    for (auto zone = m_tracyGpuZones.rbegin(); zone != m_tracyGpuZones.rend(); ++zone) {
+      zone->scope.reset();
+    }
+#endif
+    // NV-DXVK end
+
     m_cmd->endRecording();
     return std::exchange(m_cmd, nullptr);
   }
 
+  // NV-DXVK start: Tracy GPU zones that survive command list submissions
+#ifdef TRACY_ENABLE
+  void DxvkContext::beginTracyGpuZone(const tracy::SourceLocationData* srcloc) {
+    m_tracyGpuZones.push_back({ srcloc, std::make_unique<tracy::VkCtxScope>(m_device->queues().graphics.tracyCtx, srcloc,
+                                                                            m_cmd->getCmdBuffer(DxvkCmdBuffer::ExecBuffer), true) });
+  }
+
+  void DxvkContext::endTracyGpuZone() {
+    if (!m_tracyGpuZones.empty()) {
+      m_tracyGpuZones.pop_back();
+    }
+  }
+#endif
+  // NV-DXVK end
+
 
   void DxvkContext::flushCommandList() {
     ScopedCpuProfileZone();
@@ -233,6 +265,15 @@ namespace dxvk {
     const Rc<DxvkImageView>& imageView,
     const Rc<DxvkBufferView>& bufferView) {
     ScopedCpuProfileZone();
+    // NV-DXVK start: skip redundant rebinds
+    // Remix passes rebind their common resources before every dispatch. Keeping the slot tracked
+    // saves re-tracking the resource, and the descriptor set is only rewritten if something changed.
+    // Buffer views are always rebound since the slice they point to may have been renamed.
+    if (bufferView == nullptr && m_rc[slot].bufferView == nullptr
+     && m_rc[slot].imageView == imageView && imageView != nullptr)
+      return;
+    // NV-DXVK end
+
     m_rc[slot].imageView = imageView;
     m_rc[slot].bufferView = bufferView;
     m_rc[slot].bufferSlice = bufferView != nullptr
@@ -251,6 +292,11 @@ namespace dxvk {
     uint32_t              slot,
     const Rc<DxvkSampler>& sampler) {
     ScopedCpuProfileZone();
+    // NV-DXVK start: skip redundant rebinds
+    if (m_rc[slot].sampler == sampler && sampler != nullptr)
+      return;
+    // NV-DXVK end
+
     m_rc[slot].sampler = sampler;
     m_rcTracked.clr(slot);
 
@@ -424,6 +470,14 @@ namespace dxvk {
       image->setLayout(layout);
 
       m_cmd->trackResource<DxvkAccess::Write>(image);
+
+      // NV-DXVK start: skip redundant rebinds
+      // Descriptors of views that are still bound carry the old layout
+      m_flags.set(
+        DxvkContextFlag::CpDirtyResources,
+        DxvkContextFlag::GpDirtyResources,
+        DxvkContextFlag::RpDirtyResources);
+      // NV-DXVK end
     }
   }
 
@@ -581,8 +635,6 @@ namespace dxvk {
     const VkImageSubresourceRange&  subresources) {
     ScopedCpuProfileZone();
     this->spillRenderPass(false);
-    
-    m_execBarriers.recordCommands(m_cmd);
 
     VkImageLayout imageLayoutClear = image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
@@ -1848,13 +1900,28 @@ namespace dxvk {
     if (imageView->info().numLevels <= 1)
       return;
     
-    this->spillRenderPass(false);
+    // NV-DXVK start: reuse mip generators across mip updates
+    // Create the a set of framebuffers and image views
+    this->generateMipmaps(new DxvkMetaMipGenRenderPass(m_device->vkd(), imageView), filter);
+  }
 
-    m_execBarriers.recordCommands(m_cmd);
 
-    // Create the a set of framebuffers and image views
-    const Rc<DxvkMetaMipGenRenderPass> mipGenerator
-      = new DxvkMetaMipGenRenderPass(m_device->vkd(), imageView);
+  void DxvkContext::generateMipmaps(
+    const Rc<DxvkMetaMipGenRenderPass>& mipGenerator,
+          VkFilter                  filter) {
+    ScopedCpuProfileZone();
+    const Rc<DxvkImageView>& imageView = mipGenerator->view();
+    if (imageView->info().numLevels <= 1)
+      return;
+    // NV-DXVK end
+    
+    this->spillRenderPass(false);
+
+    // NV-DXVK start: only flush pending barriers that touch the image, others stay batched
+    // with whatever comes next. The render passes themselves don't record any barriers.
+    if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write))
+      m_execBarriers.recordCommands(m_cmd);
+    // NV-DXVK end
 
     // Common descriptor set properties that we use to
     // bind the source image view to the fragment shader
@@ -6010,8 +6077,12 @@ namespace dxvk {
     ScopedCpuProfileZone();
     auto idx = shaders.hash() % m_cpLookupCache.size();
 
-    if (unlikely(!m_cpLookupCache[idx] || !shaders.eq(m_cpLookupCache[idx]->shaders())))
+    if (unlikely(!m_cpLookupCache[idx] || !shaders.eq(m_cpLookupCache[idx]->shaders()))) {
       m_cpLookupCache[idx] = m_common->pipelineManager().createComputePipeline(shaders);
+      // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+      m_common->pipelineManager().registerRemixPipelineUse(shaders.hash());
+      // NV-DXVK end
+    }
 
     return m_cpLookupCache[idx];
   }
@@ -6025,6 +6096,9 @@ namespace dxvk {
     if (unlikely(foundPipeline == m_rpLookupCache.end() || !shaders.eq(foundPipeline->second->shaders()))) {
       DxvkRaytracingPipeline* pipeline = m_common->pipelineManager().createRaytracingPipeline(shaders);
       m_rpLookupCache[pipeline->shaders().hash()] = pipeline;
+      // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+      m_common->pipelineManager().registerRemixPipelineUse(pipeline->shaders().hash());
+      // NV-DXVK end
       return pipeline;
     }
 
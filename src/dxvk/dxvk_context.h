@@ -27,6 +27,9 @@
 #include "dxvk_context_state.h"
 #include "dxvk_data.h"
 #include <optional>
+// NV-DXVK start: Tracy GPU zones that survive command list submissions
+#include "../tracy/TracyVulkan.hpp"
+// NV-DXVK end
 
 namespace dxvk {
 
@@ -742,6 +745,21 @@ namespace dxvk {
       const Rc<DxvkImageView>&        imageView,
             VkFilter                  filter);
     
+    // NV-DXVK start: reuse mip generators across mip updates
+    /**
+     * \brief Generates mip maps with an existing generator
+     * 
+     * Same as above, but skips creating the render pass, image
+     * views and framebuffers. Useful for images that have their
+     * mips regenerated often, such as render targets.
+     * \param [in] mipGenerator Mip generator of the image view
+     * \param [in] filter The filter to use for generation
+     */
+    void generateMipmaps(
+      const Rc<DxvkMetaMipGenRenderPass>& mipGenerator,
+            VkFilter                  filter);
+    // NV-DXVK end
+    
     /**
      * \brief Initializes or invalidates an image
      * 
@@ -1251,6 +1269,14 @@ namespace dxvk {
     VkCommandBuffer getCmdBuffer(DxvkCmdBuffer cmdBuffer) const { return m_cmd->getCmdBuffer(cmdBuffer); }
     Rc<DxvkCommandList> getCommandList() const { return m_cmd; }
 
+    // NV-DXVK start: Tracy GPU zones that survive command list submissions
+#ifdef TRACY_ENABLE
+    // Zones nest, endTracyGpuZone ends the zone begun last
+    void beginTracyGpuZone(const tracy::SourceLocationData* srcloc);
+    void endTracyGpuZone();
+#endif
+    // NV-DXVK end
+
     DxvkObjects* getCommonObjects() const { return m_common; }
     const Rc<DxvkDevice>& getDevice() const { return m_device; }
 
@@ -1314,6 +1340,19 @@ namespace dxvk {
 
     // NV-DXVK end
 
+    // NV-DXVK start: Tracy GPU zones that survive command list submissions
+#ifdef TRACY_ENABLE
+    // Zones of the ScopedGpuProfileZones open on this context, innermost last. A zone that is still open
+    // when the command list is submitted is ended in that command list and continued in the next one, as
+    // the end timestamp can't be written to a command buffer that has already been submitted.
+    struct TracyGpuZone {
+      const tracy::SourceLocationData* srcloc;
+      std::unique_ptr<tracy::VkCtxScope> scope;
+    };
+    std::vector<TracyGpuZone> m_tracyGpuZones;
+#endif
+    // NV-DXVK end
+
     std::array<Rc<DxvkFramebuffer>,    512> m_framebufferCache = { };
 
     void blitImageFb(
@@ -520,6 +520,7 @@ namespace dxvk {
     m_pipelineManager(device, &m_renderPassPool),
     m_eventPool(device),
     m_queryPool(device),
+    m_vramBudgetBroker(device),
     m_sceneManager(device),
     m_rtResources(device),
     m_rtInitializer(device),
@@ -539,6 +540,7 @@ namespace dxvk {
     m_primaryIndirectLightDenoiser(device, DenoiserType::IndirectLight),
     m_primaryCombinedLightDenoiser(device, DenoiserType::DirectAndIndirectLight),
     m_secondaryCombinedLightDenoiser(device, DenoiserType::Secondaries),
+    m_halfResolutionDenoise(device),
     m_ngxContext(device),
     m_fsr3Context(device),
     m_dlfg(device),
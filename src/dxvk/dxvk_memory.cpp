@@ -27,6 +27,17 @@
 
 namespace dxvk {
 
+// NV-DXVK start: small allocation pools
+namespace {
+  // Threads are spread over the pools of a memory type round-robin and stick to theirs
+  uint32_t getMemoryPoolIndex() {
+    static std::atomic<uint32_t> s_nextPoolIndex = { 0u };
+    thread_local uint32_t t_poolIndex = s_nextPoolIndex++ % DxvkMemoryType::PoolCount;
+    return t_poolIndex;
+  }
+}
+// NV-DXVK end
+
 DxvkMemoryStats& DxvkMemoryStats::operator=(const DxvkMemoryStats& other)
 {
   memoryAllocated = other.memoryAllocated.load();
@@ -203,7 +214,8 @@ DxvkMemory::DxvkMemory() { }
     m_offset  (std::exchange(other.m_offset, 0)),
     m_length  (std::exchange(other.m_length, 0)),
     m_mapPtr  (std::exchange(other.m_mapPtr, nullptr)),
-    m_category (std::exchange(other.m_category, DxvkMemoryStats::Category::Invalid)) { }
+    m_category (std::exchange(other.m_category, DxvkMemoryStats::Category::Invalid)),
+    m_slab    (std::exchange(other.m_slab,   nullptr)) { }
   
   
   DxvkMemory& DxvkMemory::operator = (DxvkMemory&& other) {
@@ -216,6 +228,7 @@ DxvkMemory::DxvkMemory() { }
     m_length  = std::exchange(other.m_length, 0);
     m_mapPtr  = std::exchange(other.m_mapPtr, nullptr);
     m_category = std::exchange(other.m_category, DxvkMemoryStats::Category::Invalid);
+    m_slab    = std::exchange(other.m_slab,   nullptr);
     return *this;
   }
   
@@ -504,12 +517,41 @@ DxvkMemory::DxvkMemory() { }
   
   //// NV-DXVK start: Free unused memory
   void DxvkMemoryAllocator::freeUnusedChunks() {
+    // NV-DXVK start: small allocation pools
+    freeUnusedSlabs();
+    // NV-DXVK end
+
     for (auto& heap : m_memHeaps) {
       freeEmptyChunks(&heap);
     }
   }
   //// NV-DXVK end
 
+  // NV-DXVK start: small allocation pools
+  void DxvkMemoryAllocator::freeUnusedSlabs() {
+    for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+      DxvkMemoryType* type = &m_memTypes[i];
+
+      for (DxvkMemoryPool& pool : type->pools) {
+        std::lock_guard<dxvk::mutex> poolLock(pool.mutex);
+
+        for (auto& slabs : pool.slabs) {
+          for (auto& slab : slabs) {
+            if (slab->isEmpty()) {
+              this->freeSlabMemory(type, slab.get());
+              slab.reset();
+            }
+          }
+
+          slabs.erase(
+            std::remove(slabs.begin(), slabs.end(), nullptr),
+            slabs.end());
+        }
+      }
+    }
+  }
+  // NV-DXVK end
+
   DxvkMemory DxvkMemoryAllocator::tryAlloc(
     const VkMemoryRequirements*             req,
     const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
@@ -541,8 +583,36 @@ DxvkMemory::DxvkMemory() { }
     const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
           DxvkMemoryStats::Category         category
           ) {
-    // NV-DXVK start: use a per-memory-type mutex
-    std::lock_guard<dxvk::mutex> lock(type->mutex);
+    // NV-DXVK start: small allocation pools
+    DxvkMemory memory;
+
+    if (m_device->instance()->options().enableSmallMemoryPools
+     && dedAllocInfo == nullptr
+     && !hints.test(DxvkMemoryFlag::IgnoreConstraints)
+     && std::max(size, align) <= (VkDeviceSize(1) << DxvkMemoryPool::MaxBlockSizeLog2))
+      memory = this->tryAllocFromPool(type, flags, size, align, hints, category);
+
+    if (!memory) {
+      std::lock_guard<dxvk::mutex> lock(type->mutex);
+      memory = this->tryAllocFromChunks(type, flags, size, align, hints, dedAllocInfo, category);
+    }
+
+    if (memory)
+      type->heap->stats.trackMemoryAssigned(category, memory.m_length);
+
+    return memory;
+  }
+
+
+  DxvkMemory DxvkMemoryAllocator::tryAllocFromChunks(
+          DxvkMemoryType*                   type,
+          VkMemoryPropertyFlags             flags,
+          VkDeviceSize                      size,
+          VkDeviceSize                      align,
+          DxvkMemoryFlags                   hints,
+    const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
+          DxvkMemoryStats::Category         category) {
+    // Must be called with the memory type's mutex held
     // NV-DXVK end
 
     // Prevent unnecessary external host memory fragmentation
@@ -593,11 +663,99 @@ DxvkMemory::DxvkMemory() { }
       }
     }
 
-    if (memory)
-      type->heap->stats.trackMemoryAssigned(category, memory.m_length);
+    return memory;
+  }
+
+
+  // NV-DXVK start: small allocation pools
+  DxvkMemory DxvkMemoryAllocator::tryAllocFromPool(
+          DxvkMemoryType*                   type,
+          VkMemoryPropertyFlags             flags,
+          VkDeviceSize                      size,
+          VkDeviceSize                      align,
+          DxvkMemoryFlags                   hints,
+          DxvkMemoryStats::Category         category) {
+    // Blocks are aligned to their size, so round both up to the next power of two
+    const uint32_t blockSizeLog2 = std::max(DxvkMemoryPool::MinBlockSizeLog2,
+      32u - bit::lzcnt(uint32_t(std::max(size, align)) - 1u));
+
+    const uint32_t poolIndex = getMemoryPoolIndex();
+    DxvkMemoryPool& pool = type->pools[poolIndex];
+
+    std::lock_guard<dxvk::mutex> lock(pool.mutex);
+
+    auto& slabs = pool.slabs[blockSizeLog2 - DxvkMemoryPool::MinBlockSizeLog2];
+    DxvkMemorySlab* slab = nullptr;
+
+    // Recently added slabs are the most likely to have free blocks
+    for (auto s = slabs.rbegin(); s != slabs.rend() && !slab; s++) {
+      if ((*s)->flags == flags && (*s)->hints == hints && !(*s)->freeBlocks.empty())
+        slab = s->get();
+    }
+
+    if (!slab) {
+      slab = this->tryAllocSlab(type, flags, hints, blockSizeLog2, poolIndex);
+
+      if (!slab)
+        return DxvkMemory();
+
+      slabs.emplace_back(slab);
+    }
+
+    const VkDeviceSize blockOffset = VkDeviceSize(slab->freeBlocks.back()) << blockSizeLog2;
+    slab->freeBlocks.pop_back();
+
+    void* mapPtr = (slab->mapPtr != nullptr) ? reinterpret_cast<char*>(slab->mapPtr) + blockOffset : nullptr;
 
+    DxvkMemory memory(this, nullptr, type, slab->memory,
+      slab->offset + blockOffset, VkDeviceSize(1) << blockSizeLog2,
+      mapPtr, category);
+    memory.m_slab = slab;
     return memory;
   }
+
+
+  DxvkMemorySlab* DxvkMemoryAllocator::tryAllocSlab(
+          DxvkMemoryType*                   type,
+          VkMemoryPropertyFlags             flags,
+          DxvkMemoryFlags                   hints,
+          uint32_t                          blockSizeLog2,
+          uint32_t                          poolIndex) {
+    std::unique_lock<dxvk::mutex> lock(type->mutex);
+
+    DxvkMemory memory = this->tryAllocFromChunks(type, flags,
+      VkDeviceSize(1) << DxvkMemoryPool::SlabSizeLog2,
+      VkDeviceSize(1) << blockSizeLog2,
+      hints, nullptr, DxvkMemoryStats::Category::Invalid);
+
+    lock.unlock();
+
+    if (!memory)
+      return nullptr;
+
+    DxvkMemorySlab* slab = new DxvkMemorySlab();
+    slab->chunk         = memory.m_chunk;
+    slab->memory        = memory.m_memory;
+    slab->offset        = memory.m_offset;
+    slab->length        = VkDeviceSize(1) << DxvkMemoryPool::SlabSizeLog2;
+    slab->mapPtr        = memory.m_mapPtr;
+    slab->flags         = flags;
+    slab->hints         = hints;
+    slab->blockSizeLog2 = blockSizeLog2;
+    slab->poolIndex     = poolIndex;
+
+    // Hand out blocks front to back
+    const uint32_t blockCount = slab->blockCount();
+    slab->freeBlocks.resize(blockCount);
+
+    for (uint32_t i = 0; i < blockCount; i++)
+      slab->freeBlocks[i] = uint16_t(blockCount - i - 1);
+
+    // The slab returns its memory through freeSlabMemory instead
+    memory.m_alloc = nullptr;
+    return slab;
+  }
+  // NV-DXVK end
   
   
   DxvkDeviceMemory DxvkMemoryAllocator::tryAllocDeviceMemory(
@@ -668,6 +826,29 @@ DxvkMemory::DxvkMemory() { }
 
   void DxvkMemoryAllocator::free(
     const DxvkMemory&           memory) {
+    // NV-DXVK start: small allocation pools
+    if (memory.m_slab != nullptr) {
+      DxvkMemoryType* type = memory.m_type;
+      DxvkMemorySlab* slab = memory.m_slab;
+      DxvkMemoryPool& pool = type->pools[slab->poolIndex];
+
+      type->heap->stats.trackMemoryReleased(memory.m_category, memory.m_length);
+
+      std::lock_guard<dxvk::mutex> lock(pool.mutex);
+      slab->freeBlocks.push_back(uint16_t((memory.m_offset - slab->offset) >> slab->blockSizeLog2));
+
+      if (slab->isEmpty() && this->shouldFreeSlab(type, &pool, slab)) {
+        auto& slabs = pool.slabs[slab->blockSizeLog2 - DxvkMemoryPool::MinBlockSizeLog2];
+
+        this->freeSlabMemory(type, slab);
+
+        slabs.erase(std::find_if(slabs.begin(), slabs.end(),
+          [slab] (const std::unique_ptr<DxvkMemorySlab>& s) { return s.get() == slab; }));
+      }
+      return;
+    }
+    // NV-DXVK end
+
     // NV-DXVK start: use a per-memory-type mutex
     std::lock_guard<dxvk::mutex> lock(memory.m_type->mutex);
     // NV-DXVK end
@@ -710,6 +891,24 @@ DxvkMemory::DxvkMemory() { }
   }
   
 
+  // NV-DXVK start: small allocation pools
+  void DxvkMemoryAllocator::freeSlabMemory(
+          DxvkMemoryType*       type,
+          DxvkMemorySlab*       slab) {
+    std::lock_guard<dxvk::mutex> lock(type->mutex);
+
+    if (slab->chunk != nullptr) {
+      this->freeChunkMemory(type, slab->chunk, slab->offset, slab->length);
+    } else {
+      DxvkDeviceMemory devMem;
+      devMem.memHandle  = slab->memory;
+      devMem.memSize    = slab->length;
+      this->freeDeviceMemory(type, devMem);
+    }
+  }
+  // NV-DXVK end
+
+
   void DxvkMemoryAllocator::freeDeviceMemory(
           DxvkMemoryType*       type,
           DxvkDeviceMemory      memory) {
@@ -766,6 +965,27 @@ DxvkMemory::DxvkMemory() { }
   }
 
 
+  // NV-DXVK start: small allocation pools
+  bool DxvkMemoryAllocator::shouldFreeSlab(
+    const DxvkMemoryType*       type,
+    const DxvkMemoryPool*       pool,
+    const DxvkMemorySlab*       slab) const {
+    if (this->shouldFreeEmptyChunks(type->heap, 0))
+      return true;
+
+    // Keep one empty slab of each kind around so that a
+    // single block being allocated and freed repeatedly
+    // does not keep going back to the chunk allocator.
+    for (const auto& s : pool->slabs[slab->blockSizeLog2 - DxvkMemoryPool::MinBlockSizeLog2]) {
+      if (s.get() != slab && s->isEmpty() && s->flags == slab->flags && s->hints == slab->hints)
+        return true;
+    }
+
+    return false;
+  }
+  // NV-DXVK end
+
+
   bool DxvkMemoryAllocator::shouldFreeEmptyChunks(
     const DxvkMemoryHeap*       heap,
           VkDeviceSize          allocationSize) const {
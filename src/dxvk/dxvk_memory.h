@@ -145,6 +145,73 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Memory allocation flags
+   *
+   * Used to batch similar allocations into the same
+   * set of chunks, which may help with fragmentation.
+   */
+  enum class DxvkMemoryFlag : uint32_t {
+    Small             = 0,  ///< Small allocation
+    GpuReadable       = 1,  ///< Medium-priority resource
+    GpuWritable       = 2,  ///< High-priority resource
+    Transient         = 3,  ///< Resource is short-lived
+    IgnoreConstraints = 4,  ///< Ignore most allocation flags
+  };
+
+  using DxvkMemoryFlags = Flags<DxvkMemoryFlag>;
+
+
+  // NV-DXVK start: small allocation pools
+  /**
+   * \brief Small allocation slab
+   *
+   * A slice of a regular memory chunk that is split into
+   * equally sized power-of-two blocks. Guarded by the mutex
+   * of the pool that owns it.
+   */
+  struct DxvkMemorySlab {
+    DxvkMemoryChunk*      chunk;
+    VkDeviceMemory        memory;
+    VkDeviceSize          offset;
+    VkDeviceSize          length;
+    void*                 mapPtr;
+    VkMemoryPropertyFlags flags;
+    DxvkMemoryFlags       hints;
+    uint32_t              blockSizeLog2;
+    uint32_t              poolIndex;
+    std::vector<uint16_t> freeBlocks;
+
+    uint32_t blockCount() const {
+      return uint32_t(length >> blockSizeLog2);
+    }
+
+    bool isEmpty() const {
+      return freeBlocks.size() == blockCount();
+    }
+  };
+
+
+  /**
+   * \brief Small allocation pool
+   *
+   * Slabs of a memory type, sorted by block size. Each memory
+   * type has a few of these and every thread allocates from
+   * its own one, so that threads allocating small resources
+   * at the same time do not serialize on the chunk list.
+   */
+  struct DxvkMemoryPool {
+    constexpr static uint32_t MinBlockSizeLog2 = 8;  // 256 B
+    constexpr static uint32_t MaxBlockSizeLog2 = 16; // 64 KiB
+    constexpr static uint32_t SlabSizeLog2     = 18; // 256 KiB
+
+    dxvk::mutex mutex;
+    std::array<std::vector<std::unique_ptr<DxvkMemorySlab>>,
+      MaxBlockSizeLog2 - MinBlockSizeLog2 + 1> slabs;
+  };
+  // NV-DXVK end
+
+
   /**
    * \brief Memory type
    * 
@@ -164,6 +231,11 @@ namespace dxvk {
     // NV-DXVK start: use a per-memory-type mutex rather than an allocator-wide mutex
     dxvk::mutex        mutex;
     // NV-DXVK end
+
+    // NV-DXVK start: small allocation pools
+    constexpr static uint32_t PoolCount = 8;
+    std::array<DxvkMemoryPool, PoolCount> pools;
+    // NV-DXVK end
   };
   
   
@@ -263,27 +335,13 @@ namespace dxvk {
     VkDeviceSize          m_length = 0;
     void*                 m_mapPtr = nullptr;
     DxvkMemoryStats::Category m_category = DxvkMemoryStats::Category::Invalid;
+    // NV-DXVK start: small allocation pools
+    DxvkMemorySlab*       m_slab   = nullptr;
+    // NV-DXVK end
     
     void free();
     
   };
-
-
-  /**
-   * \brief Memory allocation flags
-   *
-   * Used to batch similar allocations into the same
-   * set of chunks, which may help with fragmentation.
-   */
-  enum class DxvkMemoryFlag : uint32_t {
-    Small             = 0,  ///< Small allocation
-    GpuReadable       = 1,  ///< Medium-priority resource
-    GpuWritable       = 2,  ///< High-priority resource
-    Transient         = 3,  ///< Resource is short-lived
-    IgnoreConstraints = 4,  ///< Ignore most allocation flags
-  };
-
-  using DxvkMemoryFlags = Flags<DxvkMemoryFlag>;
   
   
   /**
@@ -454,6 +512,16 @@ namespace dxvk {
     void freeUnusedChunks();
     // NV-DXVK end
 
+    // NV-DXVK start: small allocation pools
+    /**
+     * \brief Frees all unused small allocation slabs
+     *
+     * Returns their memory to the chunks they were
+     * allocated from, so that those can be freed.
+     */
+    void freeUnusedSlabs();
+    // NV-DXVK end
+
   private:
 
     const Rc<vk::DeviceFn>                 m_vkd;
@@ -480,6 +548,41 @@ namespace dxvk {
       const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
       DxvkMemoryStats::Category               category);
     
+    // NV-DXVK start: small allocation pools
+    DxvkMemory tryAllocFromChunks(
+      DxvkMemoryType*                         type,
+      VkMemoryPropertyFlags                   flags,
+      VkDeviceSize                            size,
+      VkDeviceSize                            align,
+      DxvkMemoryFlags                         hints,
+      const VkMemoryDedicatedAllocateInfo*    dedAllocInfo,
+      DxvkMemoryStats::Category               category);
+
+    DxvkMemory tryAllocFromPool(
+      DxvkMemoryType*                         type,
+      VkMemoryPropertyFlags                   flags,
+      VkDeviceSize                            size,
+      VkDeviceSize                            align,
+      DxvkMemoryFlags                         hints,
+      DxvkMemoryStats::Category               category);
+
+    DxvkMemorySlab* tryAllocSlab(
+      DxvkMemoryType*                         type,
+      VkMemoryPropertyFlags                   flags,
+      DxvkMemoryFlags                         hints,
+      uint32_t                                blockSizeLog2,
+      uint32_t                                poolIndex);
+
+    void freeSlabMemory(
+            DxvkMemoryType*       type,
+            DxvkMemorySlab*       slab);
+
+    bool shouldFreeSlab(
+      const DxvkMemoryType*       type,
+      const DxvkMemoryPool*       pool,
+      const DxvkMemorySlab*       slab) const;
+    // NV-DXVK end
+
     DxvkDeviceMemory tryAllocDeviceMemory(
       DxvkMemoryType*                         type,
       VkMemoryPropertyFlags                   flags,
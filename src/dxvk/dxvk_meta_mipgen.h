@@ -72,6 +72,16 @@ namespace dxvk {
      */
     VkExtent3D passExtent(uint32_t passId) const;
     
+    // NV-DXVK start: reuse mip generators across mip updates
+    /**
+     * \brief Image view
+     * \returns The view this generator was created for
+     */
+    const Rc<DxvkImageView>& view() const {
+      return m_view;
+    }
+    // NV-DXVK end
+    
   private:
     
     Rc<vk::DeviceFn>  m_vkd;
@@ -40,6 +40,7 @@
 #include "rtx_render/rtx_demodulate.h"
 #include "rtx_render/rtx_nee_cache.h"
 #include "rtx_render/rtx_denoise.h"
+#include "rtx_render/rtx_half_resolution_denoise.h"
 #include "rtx_render/rtx_ngx_wrapper.h"
 #include "rtx_render/rtx_dlfg.h"
 #include "rtx_render/rtx_dlss.h"
@@ -58,6 +59,11 @@
 #include "rtx_render/rtx_reflex.h"
 #include "rtx_render/rtx_game_capturer.h"
 #include "rtx_render/rtx_dust_particles.h"
+#include "rtx_render/rtx_vram_budget_broker.h"
+#include "rtx_render/rtx_gpu_pass_profiler.h"
+#include "rtx_render/rtx_memory_telemetry.h"
+#include "rtx_render/rtx_frame_spike_detector.h"
+#include "rtx_render/rtx_draw_call_stats.h"
 
 #include "rtx_render/rtx_denoise_type.h"
 #include "../util/util_lazy.h"
@@ -189,6 +195,10 @@ namespace dxvk {
       return m_secondaryCombinedLightDenoiser.get();
     }
 
+    DxvkHalfResolutionDenoise& metaHalfResolutionDenoise() {
+      return m_halfResolutionDenoise.get();
+    }
+
     NGXContext& metaNGXContext() {
       return m_ngxContext.get();
     }
@@ -286,6 +296,10 @@ namespace dxvk {
     }
 
     RtxTextureManager& getTextureManager();
+
+    VramBudgetBroker& getVramBudgetBroker() {
+      return m_vramBudgetBroker;
+    }
     
     ImGUI& getImgui() {
       return m_imgui;
@@ -311,6 +325,22 @@ namespace dxvk {
       return m_dustParticles.get(m_device);
     }
 
+    RtxGpuPassProfiler& metaGpuPassProfiler() {
+      return m_gpuPassProfiler.get(m_device);
+    }
+
+    RtxMemoryTelemetry& metaMemoryTelemetry() {
+      return m_memoryTelemetry.get(m_device);
+    }
+
+    RtxFrameSpikeDetector& metaFrameSpikeDetector() {
+      return m_frameSpikeDetector.get(m_device);
+    }
+
+    RtxDrawCallStats& drawCallStats() {
+      return m_drawCallStats;
+    }
+
     void onDestroy();
 
     void setWindowHandle(const HWND hwnd) {
@@ -344,6 +374,8 @@ namespace dxvk {
     Lazy<AssetExporter>               m_exporter;
 
     // RTX Management
+    // Note: consumers register with the broker on construction, so it has to be initialized prior to them
+    VramBudgetBroker   m_vramBudgetBroker;
     SceneManager       m_sceneManager;
     Resources          m_rtResources;
     RtxInitializer     m_rtInitializer;
@@ -366,6 +398,7 @@ namespace dxvk {
     Active<DxvkDenoise>                     m_primaryIndirectLightDenoiser;
     Active<DxvkDenoise>                     m_primaryCombinedLightDenoiser;
     Active<DxvkDenoise>                     m_secondaryCombinedLightDenoiser;
+    Active<DxvkHalfResolutionDenoise>       m_halfResolutionDenoise;
     Active<NGXContext>                      m_ngxContext;
     Active<FSR3Context>                     m_fsr3Context;
     Active<DxvkDLFG>                        m_dlfg;
@@ -389,6 +422,10 @@ namespace dxvk {
     Active<DxvkPostFx>                      m_postFx;
     Lazy<RtxReflex>                         m_reflex;
     Lazy<RtxDustParticles>                  m_dustParticles;
+    Lazy<RtxGpuPassProfiler>                m_gpuPassProfiler;
+    Lazy<RtxMemoryTelemetry>                m_memoryTelemetry;
+    Lazy<RtxFrameSpikeDetector>             m_frameSpikeDetector;
+    RtxDrawCallStats                        m_drawCallStats;
 
     std::atomic<HWND>                       m_lastKnownWindowHandle;
   };
@@ -62,6 +62,10 @@ namespace dxvk {
     deviceLocalMemoryChunkSizeMB = config.getOption<uint32_t>("dxvk.deviceLocalMemoryChunkSizeMB", 320);
     otherMemoryChunkSizeMB = config.getOption<uint32_t>("dxvk.otherMemoryChunkSizeMB", 128);
     // NV-DXVK end
+
+    // NV-DXVK start: small allocation pools
+    enableSmallMemoryPools = config.getOption<bool>("dxvk.enableSmallMemoryPools", true);
+    // NV-DXVK end
   }
 
 }
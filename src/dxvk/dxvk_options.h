@@ -66,6 +66,10 @@ namespace dxvk {
     uint32_t deviceLocalMemoryChunkSizeMB;
     uint32_t otherMemoryChunkSizeMB;
     // NV-DXVK end
+
+    // NV-DXVK start: small allocation pools
+    bool enableSmallMemoryPools;
+    // NV-DXVK end
   };
 
 }
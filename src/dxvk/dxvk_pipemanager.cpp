@@ -129,6 +129,14 @@ namespace dxvk {
   }
   // NV-DXVK end
 
+  // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+  void DxvkPipelineManager::registerRemixPipelineUse(
+          size_t                        hash) {
+    if (m_stateCache != nullptr)
+      m_stateCache->registerRemixPipelineUse(hash);
+  }
+  // NV-DXVK end
+
   DxvkPipelineCount DxvkPipelineManager::getPipelineCount() const {
     DxvkPipelineCount result;
     result.numComputePipelines  = m_numComputePipelines.load();
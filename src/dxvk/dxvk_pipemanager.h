@@ -127,6 +127,18 @@ namespace dxvk {
       const DxvkRaytracingPipelineShaders& shaders);
     // NV-DXVK end
 
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    /**
+     * \brief Records the use of a Remix pipeline
+     *
+     * Pipelines used once are compiled ahead of other
+     * prewarmed pipelines in subsequent sessions.
+     * \param [in] hash Hash of the pipeline shaders
+     */
+    void registerRemixPipelineUse(
+            size_t                        hash);
+    // NV-DXVK end
+
     /**
      * \brief Retrieves total pipeline count
      * \returns Number of compute/graphics pipelines
@@ -30,6 +30,9 @@ namespace dxvk {
   
   DxvkSubmissionQueue::DxvkSubmissionQueue(DxvkDevice* device)
   : m_device(device),
+    // NV-DXVK start: timeline semaphore completion tracking
+    m_timelineSemaphore(createTimelineSemaphore(device)),
+    // NV-DXVK end
     m_submitThread([this] () { submitCmdLists(); }),
     m_finishThread([this] () { finishCmdLists(); }) {
   }
@@ -45,6 +48,10 @@ namespace dxvk {
 
     m_submitThread.join();
     m_finishThread.join();
+
+    // NV-DXVK start: timeline semaphore completion tracking
+    m_device->vkd()->vkDestroySemaphore(m_device->handle(), m_timelineSemaphore, nullptr);
+    // NV-DXVK end
   }
   
   
@@ -169,6 +176,10 @@ namespace dxvk {
             reflex.beginRendering(entry.submit.cachedReflexFrameId);
           }
 
+          // NV-DXVK start: timeline semaphore completion tracking
+          entry.submit.cmdList->setCompletionTimeline(m_timelineSemaphore, ++m_timelineValue);
+          // NV-DXVK end
+
           status = entry.submit.cmdList->submit(
             entry.submit.waitSync,
             entry.submit.wakeSync);
@@ -275,6 +286,29 @@ namespace dxvk {
   }
   
   
+  // NV-DXVK start: timeline semaphore completion tracking
+  VkSemaphore DxvkSubmissionQueue::createTimelineSemaphore(DxvkDevice* device) {
+    VkSemaphoreTypeCreateInfo typeInfo;
+    typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.pNext         = nullptr;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue  = 0;
+
+    VkSemaphoreCreateInfo info;
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = &typeInfo;
+    info.flags = 0;
+
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+
+    if (device->vkd()->vkCreateSemaphore(device->handle(), &info, nullptr, &semaphore) != VK_SUCCESS)
+      throw DxvkError("DxvkSubmissionQueue: Failed to create timeline semaphore");
+
+    return semaphore;
+  }
+  // NV-DXVK end
+
+
   void DxvkSubmissionQueue::finishCmdLists() {
     env::setThreadName("dxvk-queue");
 
@@ -269,12 +269,22 @@ namespace dxvk {
     std::queue<DxvkSubmitEntry> m_submitQueue;
     std::queue<DxvkSubmitEntry> m_finishQueue;
 
+    // NV-DXVK start: timeline semaphore completion tracking
+    // Signaled by every command list submission in order, only touched by the submit thread
+    VkSemaphore                 m_timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t                    m_timelineValue = 0;
+    // NV-DXVK end
+
     dxvk::thread                m_submitThread;
     dxvk::thread                m_finishThread;
 
     VkResult submitToQueue(
       const DxvkSubmitInfo& submission);
 
+    // NV-DXVK start: timeline semaphore completion tracking
+    static VkSemaphore createTimelineSemaphore(DxvkDevice* device);
+    // NV-DXVK end
+
     void submitCmdLists();
 
     void finishCmdLists();
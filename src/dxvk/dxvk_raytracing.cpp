@@ -7,6 +7,7 @@
 #include "rtx_render/rtx.h"
 #include "rtx_render/rtx_options.h"
 #include "rtx_render/rtx_opacity_micromap_manager.h"
+#include "rtx_render/rtx_thread_budget.h"
 #include "../util/util_threadpool.h"
 #include "../util/util_singleton.h"
 
@@ -124,7 +125,8 @@ namespace dxvk {
 
       if (m_threadPool == nullptr) {
         uint32_t numCpuCores = dxvk::thread::hardware_concurrency();
-        m_threadPool = new ThreadPoolType(numCpuCores / 4, "dxvk-deferredop-finalizer");
+        m_threadPool = new ThreadPoolType(RtxThreadBudget::getThreadCount(ThreadClass::Background, numCpuCores / 4), "dxvk-deferredop-finalizer",
+                                          RtxThreadBudget::getPriority(ThreadClass::Background));
       }
 
       Future<VkResult> future;
@@ -24,6 +24,7 @@
 #include "dxvk_scoped_annotation.h"
 #include "dxvk_context.h"
 #include "dxvk_device.h"
+#include "rtx_render/rtx_gpu_pass_profiler.h"
 #include "client/TracyProfiler.hpp"
 
 // Global overload
@@ -39,9 +40,31 @@ namespace dxvk {
     // NV-DXVK start: Integrate Aftermath
     m_ctx->deviceDiagnosticCheckpoint(name);
     // NV-DXVK end
+
+    if (RtxGpuPassProfiler::isEnabled()) {
+      m_gpuZone = m_ctx->getCommonObjects()->metaGpuPassProfiler().beginZone(m_ctx.ptr(), name);
+    }
+  }
+
+#ifdef TRACY_ENABLE
+  __ScopedAnnotation::__ScopedAnnotation(Rc<DxvkContext> ctx, const char* name, const tracy::SourceLocationData* tracySrcLoc)
+    : __ScopedAnnotation(ctx, name) {
+    m_ctx->beginTracyGpuZone(tracySrcLoc);
+    m_tracyGpuZone = true;
   }
+#endif
 
   __ScopedAnnotation::~__ScopedAnnotation() {
+#ifdef TRACY_ENABLE
+    if (m_tracyGpuZone) {
+      m_ctx->endTracyGpuZone();
+    }
+#endif
+
+    if (m_gpuZone != RtxGpuPassProfiler::kInvalidZone) {
+      m_ctx->getCommonObjects()->metaGpuPassProfiler().endZone(m_ctx.ptr(), m_gpuZone);
+    }
+
     m_ctx->endDebugLabel();
   }
 
@@ -24,10 +24,17 @@
 #define ProfilerPlotValueI64(name, val) \
         TracyPlot(name, int64_t(val))
 
-#define ScopedGpuProfileZone(ctx, name) \
-        ScopedCpuProfileZoneN(name); \
-        TracyVkZone((ctx)->getDevice()->queues().graphics.tracyCtx, (ctx)->getCmdBuffer(DxvkCmdBuffer::ExecBuffer), name); \
-        __ScopedAnnotation __scopedAnnotation(ctx, name)
+#ifdef TRACY_ENABLE
+  // The GPU zone is kept by the context, so that it can span command list submissions
+  #define ScopedGpuProfileZone(ctx, name) \
+          ScopedCpuProfileZoneN(name); \
+          static constexpr tracy::SourceLocationData TracyConcat(__tracy_gpu_source_location,__LINE__) { name, __FUNCTION__, __FILE__, (uint32_t) __LINE__, 0 }; \
+          __ScopedAnnotation __scopedAnnotation(ctx, name, &TracyConcat(__tracy_gpu_source_location,__LINE__))
+#else
+  #define ScopedGpuProfileZone(ctx, name) \
+          ScopedCpuProfileZoneN(name); \
+          __ScopedAnnotation __scopedAnnotation(ctx, name)
+#endif
 
 #define ScopedGpuProfileZoneQ(device, cmdbuf, queue, name) \
         ScopedCpuProfileZoneN(name); \
@@ -78,10 +85,18 @@ namespace dxvk {
   class __ScopedAnnotation {
   public:
     __ScopedAnnotation(Rc<DxvkContext> ctx, const char* name);
+#ifdef TRACY_ENABLE
+    __ScopedAnnotation(Rc<DxvkContext> ctx, const char* name, const tracy::SourceLocationData* tracySrcLoc);
+#endif
     ~__ScopedAnnotation();
 
   private:
     Rc<DxvkContext> m_ctx;
+    // Zone of the GPU pass profiler, if it is enabled
+    uint32_t m_gpuZone = UINT32_MAX;
+#ifdef TRACY_ENABLE
+    bool m_tracyGpuZone = false;
+#endif
   };
 
   class __ScopedQueueAnnotation {
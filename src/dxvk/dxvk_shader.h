@@ -184,6 +184,16 @@ namespace dxvk {
       return !m_slots.empty();
     }
 
+    // NV-DXVK start: DXSO translation disk cache
+    /**
+     * \brief Resource slots used by the shader
+     * \returns Resource slot definitions
+     */
+    const std::vector<DxvkResourceSlot>& resourceSlots() const {
+      return m_slots;
+    }
+    // NV-DXVK end
+
     /**
      * \brief Creates a shader module
      * 
@@ -236,6 +246,16 @@ namespace dxvk {
      * \param [in] outputStream Stream to write to 
      */
     void dump(std::ostream& outputStream) const;
+
+    // NV-DXVK start: DXSO translation disk cache
+    /**
+     * \brief Retrieves the uncompressed SPIR-V code
+     * \returns Shader code, with the original binding IDs
+     */
+    SpirvCodeBuffer code() const {
+      return m_code.decompress();
+    }
+    // NV-DXVK end
     
     /**
      * \brief Sets the shader key
@@ -22,6 +22,9 @@
 #include "dxvk_device.h"
 #include "dxvk_pipemanager.h"
 #include "dxvk_state_cache.h"
+// NV-DXVK start
+#include "rtx_render/rtx_thread_budget.h"
+// NV-DXVK end
 
 namespace dxvk {
 
@@ -206,6 +209,10 @@ namespace dxvk {
         writeCacheEntry(file, e);
     }
 
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    readRemixPipelineManifest();
+    // NV-DXVK end
+
     // Use half the available CPU cores for pipeline compilation
     uint32_t numCpuCores = dxvk::thread::hardware_concurrency();
     uint32_t numWorkers  = ((std::max(1u, numCpuCores) - 1) * 5) / 7;
@@ -213,6 +220,10 @@ namespace dxvk {
     if (numWorkers <  1) numWorkers =  1;
     if (numWorkers > 32) numWorkers = 32;
 
+    // NV-DXVK start: share the CPU with the other worker thread groups
+    numWorkers = RtxThreadBudget::getThreadCount(ThreadClass::Background, numWorkers);
+    // NV-DXVK end
+
     if (device->config().numCompilerThreads > 0)
       numWorkers = device->config().numCompilerThreads;
     
@@ -330,7 +341,7 @@ namespace dxvk {
           ++m_workerCompilingRemixShaders;
         }
 
-        m_workerQueue.push(item);
+        pushWorkerItem(item);
         m_workerItemsInFlight.insert(item.hash());
       }
       // NV-DXVK end
@@ -389,7 +400,7 @@ namespace dxvk {
       assert(item.isRemixShader);
       ++m_workerCompilingRemixShaders;
 
-      m_workerQueue.push(item);
+      pushWorkerItem(item);
       m_workerItemsInFlight.insert(item.hash());
 
       m_workerCond.notify_all();
@@ -397,6 +408,77 @@ namespace dxvk {
   }
   // NV-DXVK end
 
+  // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+  void DxvkStateCache::registerRemixPipelineUse(
+          size_t                    hash) {
+    std::lock_guard<dxvk::mutex> lock(m_remixPipelineLock);
+
+    if (!m_usedRemixPipelines.insert(hash).second)
+      return;
+
+    if (!m_remixPipelineFile) {
+      m_remixPipelineFile = std::ofstream(getRemixPipelineManifestFileName().c_str(),
+        std::ios_base::binary |
+        std::ios_base::app);
+    }
+
+    // Entries are appended as pipelines get used for the first time, so that
+    // the manifest survives sessions which do not shut down cleanly
+    const uint64_t entry = hash;
+    m_remixPipelineFile.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    m_remixPipelineFile.flush();
+  }
+
+
+  void DxvkStateCache::pushWorkerItem(
+    const WorkerItem&               item) {
+    if (item.isRemixShader && m_previousRemixPipelines.count(item.hash()) != 0)
+      m_priorityWorkerQueue.push(item);
+    else
+      m_workerQueue.push(item);
+  }
+
+
+  void DxvkStateCache::readRemixPipelineManifest() {
+    std::ifstream ifile(getRemixPipelineManifestFileName().c_str(), std::ios_base::binary);
+
+    DxvkRemixPipelineManifestHeader newHeader;
+    DxvkRemixPipelineManifestHeader curHeader;
+
+    if (ifile) {
+      ifile.read(reinterpret_cast<char*>(&curHeader), sizeof(curHeader));
+    }
+
+    if (!ifile
+     || std::memcmp(curHeader.magic, newHeader.magic, sizeof(newHeader.magic)) != 0
+     || curHeader.version != newHeader.version) {
+      Logger::info("DXVK: Creating new Remix pipeline manifest");
+
+      m_remixPipelineFile = std::ofstream(getRemixPipelineManifestFileName().c_str(),
+        std::ios_base::binary |
+        std::ios_base::trunc);
+
+      if (!m_remixPipelineFile && env::createDirectory(getCacheDir())) {
+        m_remixPipelineFile = std::ofstream(getRemixPipelineManifestFileName().c_str(),
+          std::ios_base::binary |
+          std::ios_base::trunc);
+      }
+
+      m_remixPipelineFile.write(reinterpret_cast<const char*>(&newHeader), sizeof(newHeader));
+      return;
+    }
+
+    uint64_t entry;
+
+    while (ifile.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+      m_previousRemixPipelines.insert(size_t(entry));
+
+    m_usedRemixPipelines = m_previousRemixPipelines;
+
+    Logger::info(str::format("DXVK: Read ", m_previousRemixPipelines.size(), " Remix pipelines from manifest"));
+  }
+  // NV-DXVK end
+
   void DxvkStateCache::stopWorkerThreads() {
     { std::lock_guard<dxvk::mutex> workerLock(m_workerLock);
       std::lock_guard<dxvk::mutex> writerLock(m_writerLock);
@@ -1048,22 +1130,29 @@ namespace dxvk {
 
       { std::unique_lock<dxvk::mutex> lock(m_workerLock);
 
-        if (m_workerQueue.empty()) {
+        // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+        if (m_workerQueue.empty() && m_priorityWorkerQueue.empty()) {
           m_workerBusy -= 1;
           m_workerCond.wait(lock, [this] () {
             return m_workerQueue.size()
+                || m_priorityWorkerQueue.size()
                 || m_stopThreads.load();
           });
 
-          if (!m_workerQueue.empty())
+          if (!m_workerQueue.empty() || !m_priorityWorkerQueue.empty())
             m_workerBusy += 1;
         }
 
-        if (m_workerQueue.empty())
+        if (!m_priorityWorkerQueue.empty()) {
+          item = m_priorityWorkerQueue.front();
+          m_priorityWorkerQueue.pop();
+        } else if (!m_workerQueue.empty()) {
+          item = m_workerQueue.front();
+          m_workerQueue.pop();
+        } else {
           break;
-        
-        item = m_workerQueue.front();
-        m_workerQueue.pop();
+        }
+        // NV-DXVK end
       }
 
       compilePipelines(item);
@@ -1129,6 +1218,20 @@ namespace dxvk {
   }
 
 
+  // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+  std::wstring DxvkStateCache::getRemixPipelineManifestFileName() const {
+    std::string path = getCacheDir();
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+    
+    std::string exeName = env::getExeBaseName();
+    path += exeName + ".remix-pipelines";
+    return str::tows(path.c_str());
+  }
+  // NV-DXVK end
+
+
   std::string DxvkStateCache::getCacheDir() const {
     return env::getEnvVar("DXVK_STATE_CACHE_PATH");
   }
@@ -110,6 +110,19 @@ namespace dxvk {
     void registerRaytracingShaders(
       const DxvkRaytracingPipelineShaders& shaders);
     // NV-DXVK end
+
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    /**
+     * \brief Records the use of a Remix pipeline
+     *
+     * Pipelines recorded in the Remix pipeline manifest
+     * are compiled ahead of other prewarmed pipelines in
+     * subsequent sessions.
+     * \param [in] hash Hash of the pipeline shaders
+     */
+    void registerRemixPipelineUse(
+            size_t                          hash);
+    // NV-DXVK end
     
     /**
      * \brief Explicitly stops worker threads
@@ -180,6 +193,9 @@ namespace dxvk {
     dxvk::mutex                       m_workerLock;
     dxvk::condition_variable          m_workerCond;
     std::queue<WorkerItem>            m_workerQueue;
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    std::queue<WorkerItem>            m_priorityWorkerQueue;
+    // NV-DXVK end
     // NV-DXVK start: do not compile same shader multiple times
     std::unordered_set<size_t>        m_workerItemsInFlight;  // stores hashes for work items in the queue
     // NV-DXVK end
@@ -189,6 +205,14 @@ namespace dxvk {
     // NV-DXVK end
     std::vector<dxvk::thread>         m_workerThreads;
 
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    // Pipelines read from the manifest, not modified after construction
+    std::unordered_set<size_t>        m_previousRemixPipelines;
+    dxvk::mutex                       m_remixPipelineLock;
+    std::unordered_set<size_t>        m_usedRemixPipelines;
+    std::ofstream                     m_remixPipelineFile;
+    // NV-DXVK end
+
     dxvk::mutex                       m_writerLock;
     dxvk::condition_variable          m_writerCond;
     std::queue<WriterItem>            m_writerQueue;
@@ -252,6 +276,15 @@ namespace dxvk {
     void writerFunc();
 
     std::wstring getCacheFileName() const;
+
+    // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+    void readRemixPipelineManifest();
+
+    void pushWorkerItem(
+      const WorkerItem&               item);
+
+    std::wstring getRemixPipelineManifestFileName() const;
+    // NV-DXVK end
     
     std::string getCacheDir() const;
 
@@ -58,6 +58,22 @@ namespace dxvk {
 
   static_assert(sizeof(DxvkStateCacheHeader) == 12);
 
+  // NV-DXVK start: prioritize Remix pipelines used in previous sessions
+  /**
+   * \brief Remix pipeline manifest header
+   *
+   * Followed by the 64-bit shader hashes of the Remix
+   * ray tracing and compute pipelines that were used
+   * in previous sessions.
+   */
+  struct DxvkRemixPipelineManifestHeader {
+    char     magic[4]   = { 'R', 'M', 'X', 'P' };
+    uint32_t version    = 1;
+  };
+
+  static_assert(sizeof(DxvkRemixPipelineManifestHeader) == 8);
+  // NV-DXVK end
+
 
   class DxvkBindingMaskV8 : DxvkBindingSet<128> {
 
@@ -40,6 +40,7 @@ namespace dxvk {
     RtxSamplers,                       ///< Number of samplers currently present in the scene
     RtxTexturesInFlight,               ///< Number of texture currently being loaded
     RtxLastTextureBatchDuration,       ///< Duration in ms of the last processed texture batch
+    RtxHashCollisionCount,             ///< Number of unique hashes hash collision detection found collisions for
     // NV-DXVK end
 
     NumCounters,              ///< Number of counters available
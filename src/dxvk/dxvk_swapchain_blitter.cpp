@@ -49,6 +49,16 @@ namespace dxvk {
     bool sameSize = dstRect.extent == srcRect.extent;
     bool usedResolveImage = false;
 
+    // NV-DXVK start: copy instead of drawing when possible
+    if (sameSize && canCopy(dstView, dstRect, srcView)) {
+      VkImageSubresourceLayers subresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+
+      ctx->copyImage(
+        dstView->image(), subresource, { dstRect.offset.x, dstRect.offset.y, 0 },
+        srcView->image(), subresource, { srcRect.offset.x, srcRect.offset.y, 0 },
+        { srcRect.extent.width, srcRect.extent.height, 1 });
+    } else
+    // NV-DXVK end
     if (srcView->imageInfo().sampleCount == VK_SAMPLE_COUNT_1_BIT) {
       this->draw(ctx, sameSize ? m_fsCopy : m_fsBlit,
         dstView, dstRect, srcView, srcRect);
@@ -72,6 +82,57 @@ namespace dxvk {
   }
 
 
+  // NV-DXVK start: copy instead of drawing when possible
+  bool DxvkSwapchainBlitter::canCopy(
+    const Rc<DxvkImageView>&  dstView,
+          VkRect2D            dstRect,
+    const Rc<DxvkImageView>&  srcView) const {
+    // The copy shader only does more than a copy when there is a gamma ramp to apply
+    if (m_gammaImage != nullptr)
+      return false;
+
+    if (srcView->imageInfo().sampleCount != VK_SAMPLE_COUNT_1_BIT)
+      return false;
+
+    // Views of the same format read and write the exact same bits, so the
+    // draw is equivalent to a copy of the underlying images
+    if (srcView->info().format != dstView->info().format
+     || srcView->imageInfo().format != srcView->info().format
+     || dstView->imageInfo().format != dstView->info().format)
+      return false;
+
+    // Swizzles are applied when sampling, e.g. to force the alpha of X8R8G8B8 back buffers
+    auto isIdentity = [] (VkComponentSwizzle swizzle, VkComponentSwizzle component) {
+      return swizzle == VK_COMPONENT_SWIZZLE_IDENTITY || swizzle == component;
+    };
+
+    const VkComponentMapping& swizzle = srcView->info().swizzle;
+
+    if (!isIdentity(swizzle.r, VK_COMPONENT_SWIZZLE_R)
+     || !isIdentity(swizzle.g, VK_COMPONENT_SWIZZLE_G)
+     || !isIdentity(swizzle.b, VK_COMPONENT_SWIZZLE_B)
+     || !isIdentity(swizzle.a, VK_COMPONENT_SWIZZLE_A))
+      return false;
+
+    if (!(srcView->imageInfo().usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+     || !(dstView->imageInfo().usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+      return false;
+
+    if (srcView->info().minLevel != 0 || srcView->info().minLayer != 0
+     || dstView->info().minLevel != 0 || dstView->info().minLayer != 0)
+      return false;
+
+    // The draw clears the rest of the swap chain image, a copy would leave it undefined
+    VkExtent2D dstExtent = {
+      dstView->imageInfo().extent.width,
+      dstView->imageInfo().extent.height };
+
+    return dstRect.offset.x == 0 && dstRect.offset.y == 0
+        && dstRect.extent == dstExtent;
+  }
+  // NV-DXVK end
+
+
   void DxvkSwapchainBlitter::setGammaRamp(
           uint32_t            cpCount,
     const DxvkGammaCp*        cpData) {
@@ -97,6 +97,13 @@ namespace dxvk {
       const Rc<DxvkImageView>&  srcView,
             VkRect2D            srcRect);
 
+    // NV-DXVK start: copy instead of drawing when possible
+    bool canCopy(
+      const Rc<DxvkImageView>&  dstView,
+            VkRect2D            dstRect,
+      const Rc<DxvkImageView>&  srcView) const;
+    // NV-DXVK end
+
     void resolve(
             DxvkContext*        ctx,
       const Rc<DxvkImageView>&  dstView,
@@ -49,6 +49,8 @@ namespace dxvk::hud {
     addItem<HudGpuLoadItem>("gpuload", -1, device);
     addItem<HudCompilerActivityItem>("compiler", -1, device);
     addItem<HudRtxActivityItem>("rtx", -1, device);
+    addItem<HudLatencyItem>("latency", -1, device);
+    addItem<HudGpuPassesItem>("gpupasses", -1, device);
     addItem<HudScrollingLineItem>("line", -1);
   }
   
@@ -3,6 +3,9 @@
 #include <iomanip>
 #include <version.h>
 
+#include "rtx_render/rtx_dlfg.h"
+#include "rtx_render/rtx_gpu_pass_profiler.h"
+#include "rtx_render/rtx_memory_telemetry.h"
 #include "rtx_render/rtx_options.h"
 #include "rtx_render/rtx_texture_manager.h"
 
@@ -573,6 +576,30 @@ namespace dxvk::hud {
   void HudMemoryStatsItem::update(dxvk::high_resolution_clock::time_point time) {
     for (uint32_t i = 0; i < m_memory.memoryHeapCount; i++)
       m_heaps[i] = m_device->getMemoryStats(i);
+
+    // NV-DXVK start: memory telemetry
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastTelemetryUpdate);
+    if (elapsed.count() < TelemetryUpdateInterval)
+      return;
+
+    m_lastTelemetryUpdate = time;
+    m_telemetryRows.clear();
+
+    const RtxMemoryTelemetry& telemetry = m_device->getCommon()->metaMemoryTelemetry();
+    for (const auto& entry : telemetry.getEntries()) {
+      if (entry.peak == 0)
+        continue;
+
+      m_telemetryRows.emplace_back(str::format(entry.name, ":"),
+        str::format(std::setfill(' '), std::setw(5), entry.current >> 20, " / ", std::setw(5), entry.peak >> 20, " MB  ",
+                    std::showpos, std::fixed, std::setprecision(1), entry.trendMibPerMinute, " MB/min"));
+    }
+
+    const auto residency = telemetry.getTextureResidency();
+    m_telemetryRows.emplace_back("Textures:",
+      str::format(residency.fullCount, " full, ", residency.partialCount, " partial, ",
+                  residency.pendingCount, " pending, ", residency.failedCount, " failed"));
+    // NV-DXVK end
   }
 
 
@@ -622,6 +649,29 @@ namespace dxvk::hud {
       }
     }
 
+    // NV-DXVK start: memory telemetry
+    position.y += 16.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 1.0f, 1.0f, 0.25f, 1.0f },
+      "Current / peak, trend:");
+    position.y += 4.0f;
+
+    for (const auto& row : m_telemetryRows) {
+      position.y += 16.0f;
+      renderer.drawText(16.0f,
+        { position.x + 16.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        row.first);
+
+      renderer.drawText(16.0f,
+        { position.x + 296.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        row.second);
+      position.y += 4.0f;
+    }
+    // NV-DXVK end
+
     position.y += 4.0f;
     return position;
   }
@@ -824,7 +874,8 @@ namespace dxvk::hud {
                                    "# Lights:",
                                    "# Samplers:",
                                    "# Textures in-flight:",
-                                   "# Last tex. batch (ms):"}; 
+                                   "# Last tex. batch (ms):",
+                                   "# Hash collisions:"}; 
     const uint64_t values[] = { counters.getCtr(DxvkStatCounter::QueuePresentCount),
                                 counters.getCtr(DxvkStatCounter::RtxBlasCount),
                                 counters.getCtr(DxvkStatCounter::RtxBufferCount),
@@ -836,7 +887,8 @@ namespace dxvk::hud {
                                 counters.getCtr(DxvkStatCounter::RtxLightCount),
                                 counters.getCtr(DxvkStatCounter::RtxSamplers),
                                 counters.getCtr(DxvkStatCounter::RtxTexturesInFlight),
-                                counters.getCtr(DxvkStatCounter::RtxLastTextureBatchDuration)};
+                                counters.getCtr(DxvkStatCounter::RtxLastTextureBatchDuration),
+                                counters.getCtr(DxvkStatCounter::RtxHashCollisionCount)};
 
     const uint32_t kNumLabels = sizeof(labels) / sizeof(labels[0]);
     static_assert(kNumLabels == sizeof(values) / sizeof(values[0]));
@@ -904,6 +956,136 @@ namespace dxvk::hud {
     return position;
   }
 
+  HudLatencyItem::HudLatencyItem(const Rc<DxvkDevice>& device)
+    : m_device(device) {
+  }
+
+  HudLatencyItem::~HudLatencyItem() {
+  }
+
+  void HudLatencyItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    if (ticks >= UpdateInterval) {
+      const DxvkDLFGLatencyTelemetry telemetry = m_device->getCommon()->metaDLFG().getLatencyTelemetry();
+
+      const float durations[] = { telemetry.simulationMs,
+                                  telemetry.bridgeQueueMs,
+                                  telemetry.renderMs,
+                                  telemetry.interpolateMs,
+                                  telemetry.presentMs,
+                                  telemetry.totalMs };
+
+      for (uint32_t i = 0; i < sizeof(durations) / sizeof(durations[0]); i++) {
+        m_stageStrings[i] = str::format(std::fixed, std::setprecision(2), std::setw(8), durations[i], " ms");
+      }
+
+      m_stageStrings[6] = str::format(std::setw(8), telemetry.interpolatedFrameCount);
+      m_stageStrings[7] = str::format(std::fixed, std::setprecision(2), std::setw(8), telemetry.pacerIntervalScale);
+
+      m_lastUpdate = time;
+    }
+  }
+
+  HudPos HudLatencyItem::render(
+    HudRenderer& renderer,
+    HudPos       position) {
+    const std::string labels[kNumStages] = { "Simulation:",
+                                             "Bridge queue:",
+                                             "Render:",
+                                             "Interpolate:",
+                                             "Present:",
+                                             "Total:",
+                                             "Interpolated frames:",
+                                             "Pacer interval scale:" };
+
+    position.y += 8.0f;
+
+    const float xOffset = 16.f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 0.25f, 1.0f },
+      DxvkDLFG::enableLatencyMode() ? "Latency (latency mode):" : "Latency:");
+
+    position.y += 16.0f;
+
+    for (uint32_t i = 0; i < kNumStages; i++) {
+      renderer.drawText(14.0f,
+        { position.x + xOffset, position.y },
+        { 1.0f, 1.0f, 0.25f, 1.0f },
+        labels[i]);
+
+      renderer.drawText(14.0f,
+        { position.x + xOffset + 250, position.y },
+        { 1.0f, 1.0f, 1.f, 1.0f },
+        m_stageStrings[i]);
+
+      position.y += 16.0f;
+    }
+
+    position.y += 8.0f;
+    return position;
+  }
+
+  HudGpuPassesItem::HudGpuPassesItem(const Rc<DxvkDevice>& device)
+    : m_device(device) {
+  }
+
+  HudGpuPassesItem::~HudGpuPassesItem() {
+  }
+
+  void HudGpuPassesItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    if (ticks >= UpdateInterval) {
+      m_rows.clear();
+
+      if (RtxGpuPassProfiler::isEnabled()) {
+        uint32_t frameId;
+        const auto timings = m_device->getCommon()->metaGpuPassProfiler().getLatestTimings(frameId);
+
+        for (uint32_t i = 0; i < timings.size() && i < MaxRows; i++) {
+          m_rows.emplace_back(
+            std::string(timings[i].depth * 2, ' ') + timings[i].name,
+            str::format(std::fixed, std::setprecision(3), std::setw(8), timings[i].gpuMs, " ms"));
+        }
+      }
+
+      m_lastUpdate = time;
+    }
+  }
+
+  HudPos HudGpuPassesItem::render(
+    HudRenderer& renderer,
+    HudPos       position) {
+    position.y += 8.0f;
+
+    const float xOffset = 16.f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 0.25f, 1.0f },
+      RtxGpuPassProfiler::isEnabled() ? "GPU passes:" : "GPU passes (set rtx.gpuProfiler.enable):");
+
+    position.y += 16.0f;
+
+    for (const auto& row : m_rows) {
+      renderer.drawText(14.0f,
+        { position.x + xOffset, position.y },
+        { 1.0f, 1.0f, 0.25f, 1.0f },
+        row.first);
+
+      renderer.drawText(14.0f,
+        { position.x + xOffset + 350, position.y },
+        { 1.0f, 1.0f, 1.f, 1.0f },
+        row.second);
+
+      position.y += 16.0f;
+    }
+
+    position.y += 8.0f;
+    return position;
+  }
+
   HudPos HudScrollingLineItem::render(HudRenderer& renderer, HudPos position) {
     if (m_linePosition >= renderer.surfaceSize().width)
       m_linePosition = 0;
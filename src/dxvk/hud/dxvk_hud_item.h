@@ -362,6 +362,9 @@ namespace dxvk::hud {
    * \brief HUD item to display memory usage
    */
   class HudMemoryStatsItem : public HudItem {
+    // NV-DXVK start: memory telemetry
+    constexpr static int64_t TelemetryUpdateInterval = 500'000;
+    // NV-DXVK end
 
   public:
 
@@ -380,6 +383,12 @@ namespace dxvk::hud {
     Rc<DxvkDevice>                    m_device;
     VkPhysicalDeviceMemoryProperties  m_memory;
     DxvkMemoryStats                   m_heaps[VK_MAX_MEMORY_HEAPS];
+    // NV-DXVK start: memory telemetry
+    std::vector<std::pair<std::string, std::string>> m_telemetryRows;
+
+    dxvk::high_resolution_clock::time_point m_lastTelemetryUpdate
+      = dxvk::high_resolution_clock::now();
+    // NV-DXVK end
 
   };
 
@@ -504,6 +513,65 @@ namespace dxvk::hud {
     Rc<DxvkDevice> m_device;
   };
 
+  /**
+   * \brief HUD item to display the per-stage latency of frame generation
+   */
+  class HudLatencyItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudLatencyItem(const Rc<DxvkDevice>& device);
+
+    ~HudLatencyItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer& renderer,
+            HudPos       position);
+
+  private:
+
+    static constexpr uint32_t kNumStages = 8;
+
+    Rc<DxvkDevice> m_device;
+
+    std::string m_stageStrings[kNumStages];
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+  };
+
+  /**
+   * \brief HUD item to display the GPU time of each profiled pass
+   */
+  class HudGpuPassesItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+    constexpr static uint32_t MaxRows = 48;
+  public:
+
+    HudGpuPassesItem(const Rc<DxvkDevice>& device);
+
+    ~HudGpuPassesItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer& renderer,
+            HudPos       position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    std::vector<std::pair<std::string, std::string>> m_rows;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+  };
+
   /**
    * \brief HUD item to display a scrolling vertical line to test for frame pacing issues
    */
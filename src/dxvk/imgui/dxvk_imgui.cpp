@@ -65,6 +65,8 @@
 namespace dxvk {
   extern size_t g_streamedTextures_budgetBytes;
   extern size_t g_streamedTextures_usedBytes;
+  extern size_t g_streamedTextures_noFeedbackUsedBytes;
+  extern uint32_t g_streamedTextures_hardBudgetDemotedCount;
 }
 
 
@@ -148,6 +150,8 @@ namespace dxvk {
     uint32_t textureFeatureFlags = 0;
   };
   std::unordered_map<XXH64_hash_t, ImGuiTexture> g_imguiTextureMap;
+  // Set when a texture the last built UI may still reference is released, as that UI must not be drawn again
+  bool g_imguiTextureReleased = false;
   fast_unordered_cache<FogState> g_imguiFogMap;
   XXH64_hash_t g_usedFogStateHash;
   std::mutex g_imguiFogMapMutex; // protects g_imguiFogMap
@@ -720,7 +724,9 @@ namespace dxvk {
     }
     
     // Note: Erase will do nothing if the hash does not exist in the map, and erase it if it is.
-    g_imguiTextureMap.erase(hash);
+    if (g_imguiTextureMap.erase(hash) > 0) {
+      g_imguiTextureReleased = true;
+    }
   }
 
   void ImGUI::SetFogStates(const fast_unordered_cache<FogState>& fogStates, XXH64_hash_t usedFogHash) {
@@ -980,6 +986,23 @@ namespace dxvk {
     ImGui::Render();
   }
 
+  bool ImGUI::shouldUpdate() {
+    const bool textureReleased = g_imguiTextureReleased;
+    g_imguiTextureReleased = false;
+
+    const auto now = std::chrono::steady_clock::now();
+    const float updateRate = maxUpdateRate();
+    if (m_hasDrawData && !textureReleased && updateRate > 0.f &&
+        now - m_lastUpdateTime < std::chrono::duration<float>(1.f / updateRate)) {
+      // Draw the last built UI again
+      return false;
+    }
+
+    m_lastUpdateTime = now;
+    m_hasDrawData = true;
+    return true;
+  }
+
   void ImGUI::updateQuickActions(const Rc<DxvkContext>& ctx) {
 #ifdef REMIX_DEVELOPMENT
     enum RtxQuickAction : uint32_t {
@@ -1907,6 +1930,27 @@ namespace dxvk {
       ImGui::Unindent();
     }
 
+    if (ImGui::CollapsingHeader("Draw Call Statistics", collapsingHeaderClosedFlags)) {
+      ImGui::Indent();
+      ImGui::Checkbox("Enable Draw Call Statistics", &RtxDrawCallStats::enableObject());
+      if (RtxDrawCallStats::enable()) {
+        const DrawCallFrameStats stats = ctx->getCommonObjects()->drawCallStats().getLatest();
+
+        ImGui::TextUnformatted("Draw calls by outcome:");
+        for (uint32_t i = 0; i < (uint32_t) DrawCallOutcome::Count; i++) {
+          if (stats.outcomes[i] != 0) {
+            ImGui::Text("  %s: %u", RtxDrawCallStats::getOutcomeName((DrawCallOutcome) i), stats.outcomes[i]);
+          }
+        }
+
+        ImGui::TextUnformatted("CPU time by stage:");
+        for (uint32_t i = 0; i < (uint32_t) DrawCallStage::Count; i++) {
+          ImGui::Text("  %s: %.3f", RtxDrawCallStats::getStageName((DrawCallStage) i), stats.stageMs[i]);
+        }
+      }
+      ImGui::Unindent();
+    }
+
     if (ImGui::CollapsingHeader("Developer Options", collapsingHeaderFlags)) {
       ImGui::Indent();
       ImGui::Checkbox("Enable Instance Debugging", &RtxOptions::enableInstanceDebuggingToolsObject());
@@ -1934,6 +1978,11 @@ namespace dxvk {
         ImGui::Unindent();
       }
       ImGui::Checkbox("Hash Collision Detection", &HashCollisionDetectionOptions::enableObject());
+      if (!HashCollisionDetectionOptions::enable()) {
+        ImGui::Indent();
+        ImGui::DragFloat("Geometry Sampling Rate", &HashCollisionDetectionOptions::geometrySamplingRateObject(), 0.01f, 0.f, 1.f, "%.2f", sliderFlags);
+        ImGui::Unindent();
+      }
       ImGui::Checkbox("Validate CPU index data", &RtxOptions::validateCPUIndexDataObject());
 
 #ifdef REMIX_DEVELOPMENT
@@ -2271,16 +2320,6 @@ namespace dxvk {
         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.f, 0.f, 0.f, 1.00f));
       }
 
-      // Lazily create the tex ID ImGUI wants
-      if (texImgui.texID == VK_NULL_HANDLE) {
-        texImgui.texID = ImGui_ImplVulkan_AddTexture(VK_NULL_HANDLE, texImgui.imageView->handle(), VK_IMAGE_LAYOUT_GENERAL);
-
-        if (texImgui.texID == VK_NULL_HANDLE) {
-          ONCE(Logger::err("Failed to allocate ImGUI handle for texture, likely because we're trying to render more textures than VkDescriptorPoolCreateInfo::maxSets.  As such, we will truncate the texture list to show only what we can."));
-          return;
-        }
-      }
-
       const auto& imageInfo = texImgui.imageView->imageInfo();
 
       // Calculate thumbnail extent with respect to image aspect
@@ -2295,9 +2334,27 @@ namespace dxvk {
       ImGui::SetCursorPosX(x + startX + (thumbnailSize - extent.x) / 2.f);
       ImGui::SetCursorPosY(y + (thumbnailSize - extent.y) / 2.f);
 
-      if (ImGui::ImageButton(texImgui.texID, extent)) {
-        clickedOnTextureButton = true;
-        texture_popup::g_wasLeftClick = true;
+      // Thumbnails scrolled out of view only take up their space, so that the cost of the list does not grow with its length.
+      // Note: The highlighted textures are always submitted as the list may need to scroll to them.
+      const bool isThumbnailVisible = ImGui::IsRectVisible(extent) || texHash == textureInPopup || texHash == g_jumpto.load();
+      if (!isThumbnailVisible) {
+        const ImVec2 framePadding = ImGui::GetStyle().FramePadding;
+        ImGui::Dummy(ImVec2(extent.x + 2.f * framePadding.x, extent.y + 2.f * framePadding.y));
+      } else {
+        // Lazily create the tex ID ImGUI wants
+        if (texImgui.texID == VK_NULL_HANDLE) {
+          texImgui.texID = ImGui_ImplVulkan_AddTexture(VK_NULL_HANDLE, texImgui.imageView->handle(), VK_IMAGE_LAYOUT_GENERAL);
+
+          if (texImgui.texID == VK_NULL_HANDLE) {
+            ONCE(Logger::err("Failed to allocate ImGUI handle for texture, likely because we're trying to render more textures than VkDescriptorPoolCreateInfo::maxSets.  As such, we will truncate the texture list to show only what we can."));
+            return;
+          }
+        }
+
+        if (ImGui::ImageButton(texImgui.texID, extent)) {
+          clickedOnTextureButton = true;
+          texture_popup::g_wasLeftClick = true;
+        }
       }
 
       if (!showLegacyTextureGui() || uniqueId == texture_popup::lastOpenCategoryId) {
@@ -2643,6 +2700,7 @@ namespace dxvk {
       ImGui::Separator();
 
       ImGui::DragFloat("Unique Object Search Distance", &RtxOptions::uniqueObjectDistanceObject(), 0.01f, FLT_MIN, FLT_MAX, "%.3f", sliderFlags);
+      ImGui::Checkbox("Preserve World Space Caches On Camera Cut", &RtxOptions::preserveWorldSpaceCachesOnCameraCutObject());
       ImGui::Separator();
 
       ImGui::DragFloat("Vertex Color Strength", &RtxOptions::vertexColorStrengthObject(), 0.001f, 0.0f, 1.0f);
@@ -2714,6 +2772,7 @@ namespace dxvk {
 
           ImGui::Combo("Sky Probe Extent", &extIdx, exts, IM_ARRAYSIZE(exts));
           RtxOptions::skyProbeSide.setDeferred(1 << (extIdx + 8));
+          ImGui::Checkbox("Reuse Sky Probe", &RtxOptions::skyProbeReuseObject());
 
           ImGui::Unindent();
         }
@@ -2849,6 +2908,11 @@ namespace dxvk {
       dlfgMfgModeCombo.getKey(&DxvkDLFG::maxInterpolatedFramesObject());
     }
 
+    m_userGraphicsSettingChanged |= ImGui::Checkbox("Latency Mode", &DxvkDLFG::enableLatencyModeObject());
+    if (DxvkDLFG::enableLatencyMode()) {
+      ImGui::DragFloat("Latency Target (ms)", &DxvkDLFG::latencyTargetMsObject(), 0.5f, 5.0f, 200.0f, "%.1f");
+    }
+
     const auto& reason = ctx->getCommonObjects()->metaNGXContext().getDLFGNotSupportedReason();
     if (reason.size()) {
       ImGui::SetTooltipToLastWidgetOnHover(reason.c_str());
@@ -3399,6 +3463,7 @@ namespace dxvk {
       if(ImGui::CollapsingHeader("Settings", collapsingHeaderClosedFlags)) {
         ImGui::Indent();
         ImGui::Checkbox("Separate Primary Direct/Indirect Denoiser", &RtxOptions::denoiseDirectAndIndirectLightingSeparatelyObject());
+        ImGui::Checkbox("Half Resolution Secondary Denoiser", &RtxOptions::denoiseSecondariesAtHalfResolutionObject());
         ImGui::Checkbox("Reset History On Settings Change", &RtxOptions::resetDenoiserHistoryOnSettingsChangeObject());
         ImGui::Checkbox("Replace Direct Specular HitT with Indirect Specular HitT", &RtxOptions::replaceDirectSpecularHitTWithIndirectSpecularHitTObject());
         ImGui::Checkbox("Use Virtual Shading Normals", &RtxOptions::useVirtualShadingNormalsForDenoisingObject());
@@ -3520,6 +3585,7 @@ namespace dxvk {
       ImGui::DragInt("Max Prims in Merged BLAS", &RtxOptions::maxPrimsInMergedBLASObject(), 1.f, 100, 0);
       ImGui::Checkbox("Force Merge All Meshes", &RtxOptions::forceMergeAllMeshesObject());
       ImGui::Checkbox("Minimize BLAS Merging", &RtxOptions::minimizeBlasMergingObject());
+      ImGui::Checkbox("Batch Decals", &RtxOptions::enableDecalBatchingObject());
       ImGui::Separator();
       ImGui::Checkbox("Portals: Virtual Instance Matching", &RtxOptions::useRayPortalVirtualInstanceMatchingObject());
       ImGui::Checkbox("Portals: Fade In Effect", &RtxOptions::enablePortalFadeInEffectObject());
@@ -3573,6 +3639,9 @@ namespace dxvk {
       if (ImGui::CollapsingHeader("Advanced##texstream", collapsingHeaderClosedFlags)) {
         ImGui::Indent();
         ImGui::Text("Streamed Texture VRAM usage: %.1f GB", float(g_streamedTextures_usedBytes) / 1024.F / 1024.F / 1024.F);
+        ImGui::Text("Without Sampler Feedback: %.1f GB", float(g_streamedTextures_noFeedbackUsedBytes) / 1024.F / 1024.F / 1024.F);
+        ImGui::DragInt("Hard Texture Budget (MiB)", &RtxOptions::TextureManager::hardBudgetMiBObject(), 64.f, 0, 1024 * 32);
+        ImGui::Text("Textures demoted by the hard budget: %u", g_streamedTextures_hardBudgetDemotedCount);
         ImGui::Dummy({ 0, 2 });
         ImGui::Separator();
         ImGui::Dummy({ 0, 2 });
@@ -3771,6 +3840,7 @@ namespace dxvk {
       }
       m_hwnd = hwnd;
       ImGui_ImplWin32_Init(hwnd);
+      m_hasDrawData = false;
     }
 
     if (!m_init) {
@@ -3798,7 +3868,9 @@ namespace dxvk {
       m_init = true;
     }
 
-    update(ctx);
+    if (shouldUpdate()) {
+      update(ctx);
+    }
 
     this->setupRendererState(ctx, surfaceFormat, surfaceSize);
 
@@ -166,6 +166,9 @@ namespace dxvk {
     float m_reflexLatencyStatsWindowHeight = 650.f;
     bool m_reflexLatencyStatsOpen = false;
     bool m_lastRenderVsyncStatus = false;
+    // When the ImGui frame was last built, see maxUpdateRate
+    std::chrono::steady_clock::time_point m_lastUpdateTime;
+    bool m_hasDrawData = false;
 
     static constexpr const char* tabNames[] = { "Rendering", "Game Setup", "Enhancements", "About" , "Dev Settings"};
     Tabs m_curTab = kTab_Count;
@@ -175,6 +178,7 @@ namespace dxvk {
     }
 
     void update(const Rc<DxvkContext>& ctx);
+    bool shouldUpdate();
 
     void updateQuickActions(const Rc<DxvkContext>& ctx);
 
@@ -239,6 +243,9 @@ namespace dxvk {
     RTX_OPTION("rtx.gui", std::uint32_t, hudMessageAnimatedDotDurationMilliseconds, 1000, "A duration in milliseconds between each dot in the animated dot sequence for HUD messages. Must be greater than 0.\nThese dots help indicate progress is happening to the user with a bit of animation which can be configured to animate at whatever speed is desired.");
     RTX_OPTION("rtx.gui", float, reflexStatRangeInterpolationRate, 0.05f, "A value controlling the interpolation rate applied to the Reflex stat graph ranges for smoother visualization.");
     RTX_OPTION("rtx.gui", float, reflexStatRangePaddingRatio, 0.05f, "A value specifying the amount of padding applied to the Reflex stat graph ranges as a ratio to the calculated range.");
+    RTX_OPTION("rtx.gui", float, maxUpdateRate, 0.f, "The maximum rate in Hz at which the Remix UI is rebuilt, the last built UI is drawn again on the frames in between.\n"
+               "Building the UI (especially the texture lists and debug views of the developer menu) can take a significant part of the frame, so limiting its update rate keeps the game's frame rate up while the menu is open at the cost of the UI responding less smoothly to input.\n"
+               "Note that object highlighting in the texture lists is only shown on frames where the UI is rebuilt. Set to 0 to rebuild the UI every frame.");
   
     void onCloseMenus();
     void onOpenMenus();
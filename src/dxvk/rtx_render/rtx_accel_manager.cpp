@@ -19,6 +19,7 @@
 * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 * DEALINGS IN THE SOFTWARE.
 */
+#include <algorithm>
 #include <mutex>
 #include <vector>
 #include <assert.h>
@@ -34,17 +35,303 @@
 
 #include "dxvk_scoped_annotation.h"
 #include "rtx_options.h"
+#include "../../util/util_filesys.h"
 
 #include "rtx/pass/instance_definitions.h"
 #include "rtx/concept/billboard.h"
 
 #include "rtx/pass/common_binding_indices.h"
 
+#include <fstream>
+
 namespace dxvk {
 
   // Make this static and not a member of AccelManager to make it safe updating the count from ~PooledBlas()
   static int g_blasCount = 0;
 
+  BlasDiskCache::BlasDiskCache(DxvkDevice* device)
+    : m_device(device) {
+  }
+
+  BlasDiskCache::~BlasDiskCache() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+      m_device->vkd()->vkDestroyQueryPool(m_device->handle(), m_queryPool, nullptr);
+    }
+  }
+
+  void BlasDiskCache::initialize() {
+    if (m_isInitialized) {
+      return;
+    }
+
+    m_isInitialized = true;
+    m_directory = util::RtxFileSys::path(util::RtxFileSys::Cache) / "blas";
+
+    std::error_code ec;
+    util::RtxFileSys::mkDirs(m_directory);
+
+    // Only the file names are read upfront, the contents are validated when a BLAS is loaded
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+      if (!entry.is_regular_file(ec) || entry.path().extension() != ".blas") {
+        continue;
+      }
+
+      const std::string stem = entry.path().stem().string();
+      char* end = nullptr;
+      const XXH64_hash_t key = std::strtoull(stem.c_str(), &end, 16);
+
+      if (end != stem.c_str() && *end == '\0') {
+        m_cachedKeys.insert(key);
+      }
+    }
+
+    Logger::info(str::format("DxvkRaytrace: Found ", m_cachedKeys.size(), " BLAS in the disk cache at ", m_directory.string()));
+  }
+
+  std::filesystem::path BlasDiskCache::getFilePath(XXH64_hash_t key) const {
+    return m_directory / (hashToString(key) + ".blas");
+  }
+
+  bool BlasDiskCache::contains(XXH64_hash_t key) {
+    initialize();
+
+    return m_cachedKeys.find(key) != m_cachedKeys.end();
+  }
+
+  bool BlasDiskCache::load(XXH64_hash_t key, std::vector<uint8_t>& data, VkDeviceSize& accelStructureSize) {
+    ScopedCpuProfileZone();
+
+    if (!contains(key)) {
+      return false;
+    }
+
+    // The serialized data starts with the driver and compatibility UUIDs, followed by the serialized and deserialized sizes
+    constexpr size_t kDeserializedSizeOffset = 2 * VK_UUID_SIZE + sizeof(uint64_t);
+
+    std::ifstream file(getFilePath(key), std::ios::binary);
+    FileHeader header;
+
+    const bool isValid =
+      file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+      header.magic == kMagic &&
+      header.version == kVersion &&
+      header.dataSize >= kDeserializedSizeOffset + sizeof(uint64_t);
+
+    if (isValid) {
+      data.resize(header.dataSize);
+
+      if (file.read(reinterpret_cast<char*>(data.data()), header.dataSize)) {
+        VkAccelerationStructureVersionInfoKHR versionInfo = { VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_VERSION_INFO_KHR };
+        versionInfo.pVersionData = data.data();
+
+        VkAccelerationStructureCompatibilityKHR compatibility = VK_ACCELERATION_STRUCTURE_COMPATIBILITY_INCOMPATIBLE_KHR;
+        m_device->vkd()->vkGetDeviceAccelerationStructureCompatibilityKHR(m_device->handle(), &versionInfo, &compatibility);
+
+        uint64_t deserializedSize = 0;
+        memcpy(&deserializedSize, data.data() + kDeserializedSizeOffset, sizeof(deserializedSize));
+
+        if (compatibility == VK_ACCELERATION_STRUCTURE_COMPATIBILITY_COMPATIBLE_KHR && deserializedSize != 0) {
+          accelStructureSize = deserializedSize;
+          return true;
+        }
+      }
+    }
+
+    // Stale, corrupt or from another driver, the BLAS will be built and written out again
+    m_cachedKeys.erase(key);
+    return false;
+  }
+
+  void BlasDiskCache::deserialize(Rc<DxvkContext> ctx, const std::vector<uint8_t>& data, PooledBlas& blas) {
+    DxvkBufferCreateInfo uploadBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    uploadBufferInfo.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    uploadBufferInfo.stages = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    uploadBufferInfo.access = VK_ACCESS_TRANSFER_READ_BIT;
+    uploadBufferInfo.size = data.size();
+    uploadBufferInfo.requiredAlignmentOverride = kSerializedDataAlignment;
+
+    // Host writes to coherent memory are visible to commands submitted afterwards, so the buffer needs no barrier
+    Rc<DxvkBuffer> uploadBuffer = m_device->createBuffer(uploadBufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DxvkMemoryStats::Category::RTXBuffer, "BLAS disk cache upload buffer");
+    memcpy(uploadBuffer->mapPtr(0), data.data(), data.size());
+
+    VkCopyMemoryToAccelerationStructureInfoKHR copyInfo = { VK_STRUCTURE_TYPE_COPY_MEMORY_TO_ACCELERATION_STRUCTURE_INFO_KHR };
+    copyInfo.src.deviceAddress = uploadBuffer->getDeviceAddress();
+    copyInfo.dst = blas.accelStructure->getAccelStructure();
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_DESERIALIZE_KHR;
+    ctx->vkCmdCopyMemoryToAccelerationStructureKHR(&copyInfo);
+
+    ctx->getCommandList()->trackResource<DxvkAccess::Read>(uploadBuffer);
+    ctx->getCommandList()->trackResource<DxvkAccess::Write>(blas.accelStructure);
+
+    blas.isInDiskCache = true;
+  }
+
+  void BlasDiskCache::releaseQuery(PooledBlas& blas) {
+    if (blas.serializationQuery == UINT32_MAX) {
+      return;
+    }
+
+    assert(m_queries[blas.serializationQuery].blas.ptr() == &blas);
+    m_freeQueries.push_back(blas.serializationQuery);
+    blas.serializationQuery = UINT32_MAX;
+    // Note: Reset last as this may be the last reference to the BLAS
+    m_queries[m_freeQueries.back()].blas = nullptr;
+  }
+
+  void BlasDiskCache::clear() {
+    for (uint32_t i = 0; i < m_queries.size(); ++i) {
+      if (m_queries[i].blas != nullptr) {
+        releaseQuery(*m_queries[i].blas);
+      }
+    }
+  }
+
+  void BlasDiskCache::garbageCollection(uint32_t currentFrame) {
+    // Drop queries of BLAS that haven't been drawn since the query was written
+    for (uint32_t i = 0; i < m_queries.size(); ++i) {
+      const SerializationQuery& query = m_queries[i];
+      if (query.blas != nullptr && query.frameWritten + kQueryTimeoutFrames < currentFrame) {
+        releaseQuery(*query.blas);
+      }
+    }
+  }
+
+  void BlasDiskCache::store(Rc<DxvkContext> ctx, XXH64_hash_t key, const Rc<PooledBlas>& blas) {
+    if (blas->isInDiskCache || m_numCommandsThisFrame >= RtxOptions::maxBlasDiskCacheWritesPerFrame() || contains(key)) {
+      return;
+    }
+
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+    const auto& vkd = m_device->vkd();
+
+    auto recordSerializationCommand = [&]() {
+      if (m_numCommandsThisFrame++ == 0) {
+        // The BLAS were built in earlier command lists
+        ctx->emitMemoryBarrier(0,
+          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+      }
+    };
+
+    if (blas->serializationQuery == UINT32_MAX) {
+      if (m_queryPool == VK_NULL_HANDLE) {
+        VkQueryPoolCreateInfo info = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        info.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR;
+        info.queryCount = kMaxQueries;
+
+        if (vkd->vkCreateQueryPool(m_device->handle(), &info, nullptr, &m_queryPool) != VK_SUCCESS) {
+          ONCE(Logger::err("DxvkRaytrace: Failed to create the BLAS serialization query pool, the BLAS disk cache is disabled"));
+          RtxOptions::enableBlasDiskCache.setDeferred(false);
+          return;
+        }
+
+        m_queries.resize(kMaxQueries);
+        for (uint32_t i = kMaxQueries; i > 0; --i) {
+          m_freeQueries.push_back(i - 1);
+        }
+      }
+
+      if (m_freeQueries.empty()) {
+        return;
+      }
+
+      const uint32_t query = m_freeQueries.back();
+      m_freeQueries.pop_back();
+      m_queries[query] = { blas, key, currentFrame };
+      blas->serializationQuery = query;
+
+      recordSerializationCommand();
+
+      const VkAccelerationStructureKHR accelStructure = blas->accelStructure->getAccelStructure();
+      ctx->getCommandList()->cmdResetQueryPool(m_queryPool, query, 1);
+      ctx->vkCmdWriteAccelerationStructuresPropertiesKHR(1, &accelStructure, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR, m_queryPool, query);
+      ctx->getCommandList()->trackResource<DxvkAccess::Read>(blas->accelStructure);
+      return;
+    }
+
+    // Check whether the size is available yet without waiting on the GPU
+    VkDeviceSize serializedSize = 0;
+    if (vkd->vkGetQueryPoolResults(m_device->handle(), m_queryPool, blas->serializationQuery, 1,
+                                   sizeof(serializedSize), &serializedSize, sizeof(serializedSize), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+      return;
+    }
+
+    const bool isSameGeometry = m_queries[blas->serializationQuery].key == key;
+    releaseQuery(*blas);
+
+    if (!isSameGeometry || serializedSize == 0) {
+      return;
+    }
+
+    DxvkBufferCreateInfo readbackBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    readbackBufferInfo.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    readbackBufferInfo.stages = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    readbackBufferInfo.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    readbackBufferInfo.size = serializedSize;
+    readbackBufferInfo.requiredAlignmentOverride = kSerializedDataAlignment;
+
+    Rc<DxvkBuffer> readbackBuffer = m_device->createBuffer(readbackBufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, DxvkMemoryStats::Category::RTXBuffer, "BLAS disk cache readback buffer");
+
+    if (readbackBuffer == nullptr) {
+      return;
+    }
+
+    recordSerializationCommand();
+
+    VkCopyAccelerationStructureToMemoryInfoKHR copyInfo = { VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_TO_MEMORY_INFO_KHR };
+    copyInfo.src = blas->accelStructure->getAccelStructure();
+    copyInfo.dst.deviceAddress = readbackBuffer->getDeviceAddress();
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_SERIALIZE_KHR;
+    ctx->vkCmdCopyAccelerationStructureToMemoryKHR(&copyInfo);
+
+    ctx->emitMemoryBarrier(0,
+      VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      VK_ACCESS_HOST_READ_BIT);
+
+    ctx->getCommandList()->trackResource<DxvkAccess::Read>(blas->accelStructure);
+    ctx->getCommandList()->trackResource<DxvkAccess::Write>(readbackBuffer);
+
+    blas->isInDiskCache = true;
+    m_pendingWrites.push_back(PendingWrite { key, readbackBuffer, serializedSize });
+  }
+
+  void BlasDiskCache::onFrameEnd() {
+    ScopedCpuProfileZone();
+
+    m_numCommandsThisFrame = 0;
+
+    uint32_t numWrites = 0;
+
+    for (auto iter = m_pendingWrites.begin(); iter != m_pendingWrites.end() && numWrites < RtxOptions::maxBlasDiskCacheWritesPerFrame(); ) {
+      // Readbacks complete in submission order, so later ones won't be done either
+      if (iter->readbackBuffer->isInUse()) {
+        break;
+      }
+
+      FileHeader header;
+      header.magic = kMagic;
+      header.version = kVersion;
+      header.dataSize = iter->size;
+
+      std::ofstream file(getFilePath(iter->key), std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(iter->readbackBuffer->mapPtr(0)), iter->size);
+
+      if (file) {
+        m_cachedKeys.insert(iter->key);
+      } else {
+        ONCE(Logger::warn(str::format("DxvkRaytrace: Failed to write to the BLAS disk cache at ", m_directory.string())));
+      }
+
+      iter = m_pendingWrites.erase(iter);
+      numWrites++;
+    }
+  }
+
   AccelManager::AccelManager(DxvkDevice* device)
     : CommonDeviceObject(device)
     // Note: The scratch buffer's device address must be aligned to the minimum alignment required by the Vulkan runtime, otherwise
@@ -53,11 +340,34 @@ namespace dxvk {
     //    // this alignment override created issues on Intel GPUs where the min scratch alignment is 128 bytes but the underlying buffer was
     //    // only allocated with a 64 byte alignment.
     //    // Note: This could use the value of m_scratchAlignment, but this is duplicated to avoid potential future initialization order issues.
-    , m_scratchAlignment(device->properties().khrDeviceAccelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment) {
+    , m_scratchAlignment(device->properties().khrDeviceAccelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment)
+    , m_diskCache(device) {
+    VramBudgetBroker::ConsumerDesc vramBudgetConsumer;
+    vramBudgetConsumer.priority = 1;
+    vramBudgetConsumer.reclaim = [this](VkDeviceSize size) { return reclaimUnusedBlas(size); };
+    device->getCommon()->getVramBudgetBroker().registerConsumer(VramBudgetBroker::Consumer::Blas, vramBudgetConsumer);
+  }
+
+  AccelManager::~AccelManager() {
+    m_device->getCommon()->getVramBudgetBroker().unregisterConsumer(VramBudgetBroker::Consumer::Blas);
+
+    if (m_compactionQueryPool != VK_NULL_HANDLE) {
+      m_device->vkd()->vkDestroyQueryPool(m_device->handle(), m_compactionQueryPool, nullptr);
+    }
   }
 
   void AccelManager::clear() {
     m_blasPool.clear();
+    m_decalBatchBlas.clear();
+    m_scratchBuffer = nullptr;
+
+    for (uint32_t i = 0; i < m_compactionQueries.size(); ++i) {
+      if (m_compactionQueries[i].blas != nullptr) {
+        releaseCompactionQuery(*m_compactionQueries[i].blas);
+      }
+    }
+
+    m_diskCache.clear();
   }
 
   void AccelManager::garbageCollection() {
@@ -68,6 +378,16 @@ namespace dxvk {
     // Remove instances past their lifetime or marked for GC explicitly
     const uint32_t currentFrame = m_device->getCurrentFrameId();
 
+    // Return the BLAS of decal batches that weren't drawn in the last frame to the pool, where they age out like any other BLAS
+    for (auto it = m_decalBatchBlas.begin(); it != m_decalBatchBlas.end();) {
+      if (it->second->frameLastTouched + 1 < currentFrame) {
+        m_blasPool.push_back(std::move(it->second));
+        it = m_decalBatchBlas.erase(it);
+        continue;
+      }
+      ++it;
+    }
+
     // Remove all pooled BLAS that haven't been used for a few frames
     for (uint32_t i = 0; i < m_blasPool.size();) {
       Rc<PooledBlas>& blas = m_blasPool[i];
@@ -81,8 +401,48 @@ namespace dxvk {
       }
       ++i;
     }
+
+    // Drop compaction queries of BLAS that haven't been drawn since the query was written
+    for (uint32_t i = 0; i < m_compactionQueries.size(); ++i) {
+      const CompactionQuery& query = m_compactionQueries[i];
+      if (query.blas != nullptr && query.frameWritten + kCompactionQueryTimeoutFrames < currentFrame) {
+        releaseCompactionQuery(*query.blas);
+      }
+    }
+
+    m_diskCache.garbageCollection(currentFrame);
   }
   
+  VkDeviceSize AccelManager::reclaimUnusedBlas(VkDeviceSize size) {
+    // Same as garbageCollection() but ignoring 'rtx.numFramesToKeepBLAS', oldest BLAS first
+    const uint32_t numFramesToKeepBLAS = RtxOptions::enablePreviousTLAS() ? 2u : 1u;
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+
+    std::sort(m_blasPool.begin(), m_blasPool.end(),
+              [](const Rc<PooledBlas>& a, const Rc<PooledBlas>& b) { return a->frameLastTouched < b->frameLastTouched; });
+
+    VkDeviceSize reclaimedSize = 0;
+    uint32_t numBlasToRemove = 0;
+
+    for (const Rc<PooledBlas>& blas : m_blasPool) {
+      if (reclaimedSize >= size || blas->frameLastTouched + numFramesToKeepBLAS >= currentFrame) {
+        break;
+      }
+
+      if (blas->compactionQuery != UINT32_MAX) {
+        releaseCompactionQuery(*blas);
+      }
+      m_diskCache.releaseQuery(*blas);
+
+      reclaimedSize += blas->accelStructure->info().size;
+      ++numBlasToRemove;
+    }
+
+    m_blasPool.erase(m_blasPool.begin(), m_blasPool.begin() + numBlasToRemove);
+
+    return reclaimedSize;
+  }
+
   PooledBlas::PooledBlas() {
     ++g_blasCount;
     buildInfo.geometryCount = 0;
@@ -122,7 +482,7 @@ namespace dxvk {
     return uint32_t(std::max(g_blasCount, 0));
   }
 
-  bool AccelManager::BlasBucket::tryAddInstance(RtInstance* instance) {
+  bool AccelManager::BlasBucket::tryAddInstance(RtInstance* instance, bool isDecalBatchInstance) {
     const uint8_t geometryInstanceMask = instance->getVkInstance().mask;
     const uint32_t geometryCustomIndexFlags = instance->getVkInstance().instanceCustomIndex & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK);
     const bool geometryUsesUnorderedApproximations = instance->usesUnorderedApproximations();
@@ -140,10 +500,30 @@ namespace dxvk {
         return false;
       if (usesUnorderedApproximations != geometryUsesUnorderedApproximations)
         return false;
+      if (isDecalBatch != isDecalBatchInstance)
+        return false;
+      if (isDecalBatch && decalBatchMaterialHash != instance->getMaterialHash())
+        return false;
     }
 
     BlasEntry* blasEntry = instance->getBlas();
 
+    if (RtxOptions::enableBlasMergeCostModel()) {
+      const AxisAlignedBoundingBox instanceBounds = blasEntry->input.getGeometryData().boundingBox.getTransformed(instance->getTransform());
+      const float instanceSurfaceArea = instanceBounds.getSurfaceArea();
+
+      if (!geometries.empty() && bounds.isValid() && instanceBounds.isValid()) {
+        // Keep instances that are far apart out of the same BLAS, as rays would have to traverse all the empty space between them
+        AxisAlignedBoundingBox mergedBounds = bounds;
+        mergedBounds.unionWith(instanceBounds);
+        if (mergedBounds.getSurfaceArea() > RtxOptions::maxMergedBlasSurfaceAreaRatio() * (sumInstanceSurfaceArea + instanceSurfaceArea))
+          return false;
+      }
+
+      bounds.unionWith(instanceBounds);
+      sumInstanceSurfaceArea += instanceSurfaceArea;
+    }
+
     geometries.insert(geometries.end(), blasEntry->buildGeometries.begin(), blasEntry->buildGeometries.end());
     ranges.insert(ranges.end(), blasEntry->buildRanges.begin(), blasEntry->buildRanges.end());
 
@@ -154,6 +534,19 @@ namespace dxvk {
     instanceBillboardIndices.insert(instanceBillboardIndices.end(), instance->billboardIndices.begin(), instance->billboardIndices.end());
     indexOffsets.insert(indexOffsets.end(), instance->indexOffsets.begin(), instance->indexOffsets.end());
 
+    if (isDecalBatchInstance) {
+      // The transform is baked into the merged BLAS, the geometry addresses aren't hashed as the same geometry may be uploaded again
+      const XXH64_hash_t geometryHash = blasEntry->input.getGeometryData().getHashForRule<rules::FullGeometryHash>();
+      decalBatchHash = XXH64(&geometryHash, sizeof(geometryHash), decalBatchHash);
+      decalBatchHash = XXH64(&instance->getVkInstance().transform, sizeof(VkTransformMatrixKHR), decalBatchHash);
+      for (const auto& geometry : blasEntry->buildGeometries) {
+        decalBatchHash = XXH64(&geometry.flags, sizeof(geometry.flags), decalBatchHash);
+      }
+      decalBatchHash = XXH64(blasEntry->buildRanges.data(), blasEntry->buildRanges.size() * sizeof(VkAccelerationStructureBuildRangeInfoKHR), decalBatchHash);
+      isDecalBatch = true;
+      decalBatchMaterialHash = instance->getMaterialHash();
+    }
+
     instanceShaderBindingTableRecordOffset = geometryInstanceShaderBindingTableRecordOffset;
     instanceMask = geometryInstanceMask;
     customIndexFlags = geometryCustomIndexFlags;
@@ -162,6 +555,68 @@ namespace dxvk {
     return true;
   }
 
+  // Decals can be batched when the batch hash covers their vertex positions, which isn't the case for positions produced on the GPU
+  static bool isDecalBatchable(const RtInstance& instance, const BlasEntry& blasEntry) {
+    const DrawCallState& input = blasEntry.input;
+    return instance.surface.alphaState.isDecal &&
+           instance.surface.instancesToObject == nullptr &&
+           blasEntry.buildGeometries.size() == 1 &&
+           input.getSkinningState().numBones == 0 &&
+           !input.usesVertexShader &&
+           input.getGeometryData().getHashForRule<rules::FullGeometryHash>() != kEmptyHash;
+  }
+
+  // Decides whether a mesh is cheaper to give its own BLAS, which is refit only when the vertices change, than to keep in the merged BLAS, which is rebuilt every frame.
+  // All instances of a mesh share its own BLAS, but each of them is added to the merged BLAS separately.
+  static bool evaluateDynamicBlasCost(BlasEntry& blasEntry, const uint32_t blasPrims, const uint32_t currentFrame) {
+    if (blasEntry.frameBlasCostEvaluated == currentFrame) {
+      return blasEntry.prefersDynamicBlas;
+    }
+    blasEntry.frameBlasCostEvaluated = currentFrame;
+
+    // Roughly the last 16 frames the geometry was drawn in
+    constexpr float kUpdateRateWeight = 1.f / 16.f;
+    const float updated = blasEntry.frameLastUpdated == currentFrame ? 1.f : 0.f;
+    blasEntry.vertexUpdateRate += (updated - blasEntry.vertexUpdateRate) * kUpdateRateWeight;
+
+    const float numInstances = static_cast<float>(std::max<size_t>(blasEntry.getLinkedInstances().size(), 1));
+    const float mergedCost = static_cast<float>(blasPrims) * numInstances;
+    const float dynamicCost = blasEntry.vertexUpdateRate * RtxOptions::blasRefitCostRatio() * static_cast<float>(blasPrims) +
+                              numInstances * RtxOptions::dynamicBlasInstanceCost();
+
+    const float hysteresis = 1.f + std::max(RtxOptions::blasMergeHysteresis(), 0.f);
+    if (blasEntry.prefersDynamicBlas) {
+      blasEntry.prefersDynamicBlas = dynamicCost <= mergedCost * hysteresis;
+    } else {
+      blasEntry.prefersDynamicBlas = dynamicCost * hysteresis < mergedCost;
+    }
+    return blasEntry.prefersDynamicBlas;
+  }
+
+  // Checks whether an instance is too far from the camera and too small from there to matter for the image, see 'rtx.tlasInstanceCullingDistance'
+  static bool isInstanceCulledByDistance(const RtInstance& instance, const Vector3& cameraPosition, const float cullingDistance, const float minAngularSize) {
+    // Point instancers and billboards are placed on the GPU, and view model instances are always close
+    if (instance.surface.instancesToObject != nullptr || instance.getBillboardCount() > 0 || instance.isViewModel()) {
+      return false;
+    }
+
+    const AxisAlignedBoundingBox bounds = instance.getBlas()->input.getGeometryData().boundingBox.getTransformed(instance.getTransform());
+    if (!bounds.isValid()) {
+      return false;
+    }
+
+    Vector3 offset;
+    for (uint32_t i = 0; i < 3; i++) {
+      offset[i] = std::max(std::max(bounds.minPos[i] - cameraPosition[i], cameraPosition[i] - bounds.maxPos[i]), 0.f);
+    }
+    const float distance = length(offset);
+    if (distance <= cullingDistance) {
+      return false;
+    }
+
+    return length(bounds.maxPos - bounds.minPos) < minAngularSize * distance;
+  }
+
   static void fillGeometryInfoFromBlasEntry(BlasEntry& blasEntry, RtInstance& instance, const OpacityMicromapManager* opacityMicromapManager) {
     ScopedCpuProfileZone();
     blasEntry.buildGeometries.clear();
@@ -334,9 +789,13 @@ namespace dxvk {
   }
 
   Rc<DxvkBuffer> AccelManager::getScratchMemory(const size_t requiredScratchAllocSize) {
+    // The scratch buffer is kept across frames and only ever grows, so reallocations stop once it reaches the high-water mark of the scene
     if (m_scratchBuffer == nullptr || m_scratchBuffer->info().size < requiredScratchAllocSize) {
+      const VkDeviceSize currentSize = m_scratchBuffer != nullptr ? m_scratchBuffer->info().size : 0;
+
       DxvkBufferCreateInfo bufferCreateInfo {};
-      bufferCreateInfo.size = requiredScratchAllocSize;
+      // Grow geometrically to avoid a reallocation every frame while a scene is streaming in
+      bufferCreateInfo.size = align(std::max<VkDeviceSize>(requiredScratchAllocSize, currentSize + currentSize / 2), m_scratchAlignment);
       bufferCreateInfo.access = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
       bufferCreateInfo.stages = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
       bufferCreateInfo.usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
@@ -357,10 +816,152 @@ namespace dxvk {
     newBlas->accelStructure = m_device->createAccelStructure(bufferCreateInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR, name);
 
     newBlas->accelerationStructureReference = newBlas->accelStructure->getAccelDeviceAddress();
+    newBlas->buildSize = bufferSize;
 
     return newBlas;
   }
 
+  void AccelManager::releaseCompactionQuery(PooledBlas& blas) {
+    if (blas.compactionQuery == UINT32_MAX) {
+      return;
+    }
+
+    assert(m_compactionQueries[blas.compactionQuery].blas.ptr() == &blas);
+    m_freeCompactionQueries.push_back(blas.compactionQuery);
+    blas.compactionQuery = UINT32_MAX;
+    // Note: Reset last as this may be the last reference to the BLAS
+    m_compactionQueries[m_freeCompactionQueries.back()].blas = nullptr;
+  }
+
+  void AccelManager::compactBlas(Rc<DxvkContext> ctx, BlasEntry& blasEntry) {
+    Rc<PooledBlas>& blas = blasEntry.dynamicBlas;
+    if (blas->isCompacted || blas->hasDeferredUpdate || (blas->buildInfo.flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR) == 0 ||
+        m_numCompactionCommandsThisFrame >= RtxOptions::maxBlasCompactionsPerFrame()) {
+      return;
+    }
+
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+    const auto& vkd = m_device->vkd();
+
+    auto recordCompactionCommand = [&]() {
+      if (m_numCompactionCommandsThisFrame++ == 0) {
+        // The BLAS were built in earlier command lists
+        ctx->emitMemoryBarrier(0,
+          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+      }
+    };
+
+    if (blas->compactionQuery == UINT32_MAX) {
+      if (currentFrame - blas->frameLastBuilt < RtxOptions::numFramesBeforeBlasCompaction()) {
+        return;
+      }
+
+      if (m_compactionQueryPool == VK_NULL_HANDLE) {
+        VkQueryPoolCreateInfo info = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        info.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+        info.queryCount = kMaxCompactionQueries;
+
+        if (vkd->vkCreateQueryPool(m_device->handle(), &info, nullptr, &m_compactionQueryPool) != VK_SUCCESS) {
+          ONCE(Logger::err("DxvkRaytrace: Failed to create the BLAS compaction query pool, BLAS compaction is disabled"));
+          RtxOptions::enableBlasCompaction.setDeferred(false);
+          return;
+        }
+
+        m_compactionQueries.resize(kMaxCompactionQueries);
+        for (uint32_t i = kMaxCompactionQueries; i > 0; --i) {
+          m_freeCompactionQueries.push_back(i - 1);
+        }
+      }
+
+      if (m_freeCompactionQueries.empty()) {
+        return;
+      }
+
+      const uint32_t query = m_freeCompactionQueries.back();
+      m_freeCompactionQueries.pop_back();
+      m_compactionQueries[query] = { blas, currentFrame };
+      blas->compactionQuery = query;
+
+      recordCompactionCommand();
+
+      const VkAccelerationStructureKHR accelStructure = blas->accelStructure->getAccelStructure();
+      ctx->getCommandList()->cmdResetQueryPool(m_compactionQueryPool, query, 1);
+      ctx->vkCmdWriteAccelerationStructuresPropertiesKHR(1, &accelStructure, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, m_compactionQueryPool, query);
+      ctx->getCommandList()->trackResource<DxvkAccess::Read>(blas->accelStructure);
+      return;
+    }
+
+    // Check whether the size is available yet without waiting on the GPU
+    VkDeviceSize compactedSize = 0;
+    if (vkd->vkGetQueryPoolResults(m_device->handle(), m_compactionQueryPool, blas->compactionQuery, 1,
+                                   sizeof(compactedSize), &compactedSize, sizeof(compactedSize), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+      return;
+    }
+
+    releaseCompactionQuery(*blas);
+
+    if (compactedSize == 0 || compactedSize >= blas->accelStructure->info().size) {
+      // Nothing to gain, check again after another while in case the BLAS changes
+      blas->frameLastBuilt = currentFrame;
+      return;
+    }
+
+    recordCompactionCommand();
+
+    Rc<PooledBlas> compactedBlas = createPooledBlas(compactedSize, "BLAS Dynamic Compacted");
+    compactedBlas->buildSize = blas->buildSize;
+    compactedBlas->frameLastTouched = blas->frameLastTouched;
+    compactedBlas->frameLastBuilt = blas->frameLastBuilt;
+    compactedBlas->numUpdatesSinceBuild = blas->numUpdatesSinceBuild;
+    compactedBlas->topologyHash = blas->topologyHash;
+    compactedBlas->opacityMicromapSourceHash = blas->opacityMicromapSourceHash;
+    compactedBlas->primitiveCounts = blas->primitiveCounts;
+    compactedBlas->isCompacted = true;
+    copyAccelerationStructureBuildGeometryInfo(blas->buildInfo, compactedBlas->buildInfo);
+
+    VkCopyAccelerationStructureInfoKHR copyInfo = { VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR };
+    copyInfo.src = blas->accelStructure->getAccelStructure();
+    copyInfo.dst = compactedBlas->accelStructure->getAccelStructure();
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+    ctx->vkCmdCopyAccelerationStructureKHR(&copyInfo);
+
+    ctx->getCommandList()->trackResource<DxvkAccess::Read>(blas->accelStructure);
+    ctx->getCommandList()->trackResource<DxvkAccess::Write>(compactedBlas->accelStructure);
+
+    // The full size BLAS goes back to the pool, which keeps it alive for the previous frame's TLAS
+    m_diskCache.releaseQuery(*blas);
+    m_blasPool.push_back(std::move(blas));
+    blas = std::move(compactedBlas);
+  }
+
+  XXH64_hash_t AccelManager::getBlasDiskCacheKey(const BlasEntry& blasEntry, const VkAccelerationStructureBuildGeometryInfoKHR& buildInfo,
+                                                 XXH64_hash_t boundOpacityMicromapHash) {
+    // Skinned and vertex shader positions are produced on the GPU, which the geometry hash doesn't cover,
+    // and BLAS with opacity micromaps reference the micromaps by handle
+    const DrawCallState& input = blasEntry.input;
+    if (input.getSkinningState().numBones != 0 || input.usesVertexShader || boundOpacityMicromapHash != kEmptyHash) {
+      return kEmptyHash;
+    }
+
+    XXH64_hash_t key = input.getGeometryData().getHashForRule<rules::FullGeometryHash>();
+    if (key == kEmptyHash) {
+      return kEmptyHash;
+    }
+
+    const VkAccelerationStructureGeometryKHR& geometry = blasEntry.buildGeometries[0];
+    key = XXH64(&buildInfo.flags, sizeof(buildInfo.flags), key);
+    key = XXH64(&geometry.flags, sizeof(geometry.flags), key);
+    key = XXH64(&geometry.geometry.triangles.vertexFormat, sizeof(geometry.geometry.triangles.vertexFormat), key);
+    key = XXH64(&geometry.geometry.triangles.maxVertex, sizeof(geometry.geometry.triangles.maxVertex), key);
+    key = XXH64(&geometry.geometry.triangles.indexType, sizeof(geometry.geometry.triangles.indexType), key);
+    key = XXH64(&blasEntry.buildRanges[0].primitiveCount, sizeof(blasEntry.buildRanges[0].primitiveCount), key);
+
+    return key;
+  }
+
   static void trackBlasBuildResources(Rc<DxvkContext> ctx, DxvkBarrierSet& execBarriers, const BlasEntry* blasEntry) {
     ScopedCpuProfileZone();
     ctx->getCommandList()->trackResource<DxvkAccess::Read>(blasEntry->modifiedGeometryData.positionBuffer.buffer());
@@ -408,12 +1009,18 @@ namespace dxvk {
       Logger::debug("DxvkRaytrace: Vulkan Transform Buffer Realloc");
     }
 
-    std::vector<VkTransformMatrixKHR> instanceTransforms;
-    instanceTransforms.reserve(instances.size());
+    // Simplify syntax for accessing the persistent containers
+    auto& instanceTransforms = mergeInstancesIntoBlasFuncState.instanceTransforms;
+    auto& blasToBuild = mergeInstancesIntoBlasFuncState.blasToBuild;
+    auto& blasRangesToBuild = mergeInstancesIntoBlasFuncState.blasRangesToBuild;
 
-    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> blasToBuild;
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR*> blasRangesToBuild;
+    instanceTransforms.clear();
+    blasToBuild.clear();
+    blasRangesToBuild.clear();
+    m_numCompactionCommandsThisFrame = 0;
+    m_numBlasBuildPrimitivesThisFrame = 0;
 
+    instanceTransforms.reserve(instances.size());
     blasToBuild.reserve(instances.size());
     blasRangesToBuild.reserve(instances.size());
 
@@ -440,7 +1047,16 @@ namespace dxvk {
     // NOTE: Would like to use the BLAS Linked instances here, but that misses viewmodel and virtual instances
     std::unordered_map<BlasEntry*, std::vector<RtInstance*>> uniqueBlas;
 
+    const float tlasInstanceCullingDistance = RtxOptions::tlasInstanceCullingDistance();
+    const float tlasInstanceCullingMinAngularSize = RtxOptions::tlasInstanceCullingMinAngularSize();
+    const Vector3 cameraPosition = cameraManager.getMainCamera().getPosition();
+
     for (RtInstance* instance : instances) {
+      // Leave out instances far outside of the camera's influence, as if they had a zero mask
+      if (tlasInstanceCullingDistance > 0.f && isInstanceCulledByDistance(*instance, cameraPosition, tlasInstanceCullingDistance, tlasInstanceCullingMinAngularSize)) {
+        continue;
+      }
+
       // If the instance has zero mask, do not build BLAS for it: no ray can intersect this instance.
       if (instance->getVkInstance().mask == 0) {
         
@@ -479,16 +1095,29 @@ namespace dxvk {
       const uint32_t maxPrimsForMergedBLAS = RtxOptions::maxPrimsInMergedBLAS();
       const uint32_t blasPrims = blasEntry->modifiedGeometryData.calculatePrimitiveCount();
 
+      const bool useCostModel = RtxOptions::enableBlasMergeCostModel();
+
       // Figure out if this blas should be a dynamic one
-      const bool requestDynamicBlas = instance->surface.instancesToObject != nullptr ||    // Point instancer geometry is replicated many times in a scene, we want to reuse the BLAS memory for these objects
-                                      blasEntry->input.getSkinningState().numBones != 0 || // Skinned meshes are always desirable to give a dynamic BLAS, since we'll want to make use of BVH update for performance reasons
-                                      blasEntry->getLinkedInstances().size() > 1  ||       // Meshes that are used in instances multiple times should benefit from BLAS reuse
-                                      blasEntry->dynamicBlas != nullptr ||                 // If we already have a dynamic BLAS, keep using it.
-                                      blasPrims > maxPrimsForMergedBLAS ||                 // Avoid large meshes ending up in the merged BLAS which is built every frame.  # prims is proportional to build cost.
-                                      RtxOptions::minimizeBlasMerging();                   // Option to attempt putting as many objects into dynamic BLAS as possible.
-
-      const bool forceMergedBlas = (blasEntry->buildGeometries.size() > 1 ||                                       // Currently we use multiple build geometries for particle billboards, which we prefer to merge into large BLAS
-                                    (!RtxOptions::minimizeBlasMerging() && blasPrims < minPrimsInDynamicBLAS) ||   // Avoid creating lots of small dynamic BLAS
+      bool requestDynamicBlas;
+      if (useCostModel) {
+        requestDynamicBlas = instance->surface.instancesToObject != nullptr ||                         // Point instancer geometry is replicated many times in a scene, we want to reuse the BLAS memory for these objects
+                             evaluateDynamicBlasCost(*blasEntry, blasPrims, m_device->getCurrentFrameId()) || // Skinned, instanced and large meshes are weighed against the per BLAS overhead
+                             RtxOptions::minimizeBlasMerging();                                          // Option to attempt putting as many objects into dynamic BLAS as possible.
+      } else {
+        requestDynamicBlas = instance->surface.instancesToObject != nullptr ||    // Point instancer geometry is replicated many times in a scene, we want to reuse the BLAS memory for these objects
+                             blasEntry->input.getSkinningState().numBones != 0 || // Skinned meshes are always desirable to give a dynamic BLAS, since we'll want to make use of BVH update for performance reasons
+                             blasEntry->getLinkedInstances().size() > 1  ||       // Meshes that are used in instances multiple times should benefit from BLAS reuse
+                             blasEntry->dynamicBlas != nullptr ||                 // If we already have a dynamic BLAS, keep using it.
+                             blasPrims > maxPrimsForMergedBLAS ||                 // Avoid large meshes ending up in the merged BLAS which is built every frame.  # prims is proportional to build cost.
+                             RtxOptions::minimizeBlasMerging();                   // Option to attempt putting as many objects into dynamic BLAS as possible.
+      }
+
+      // Small decals are batched per material into merged BLAS that are kept as long as the batch doesn't change
+      const bool isDecalBatchInstance = RtxOptions::enableDecalBatching() && blasPrims < minPrimsInDynamicBLAS && isDecalBatchable(*instance, *blasEntry);
+
+      const bool forceMergedBlas = (blasEntry->buildGeometries.size() > 1 ||
+                                    isDecalBatchInstance ||                                       // Currently we use multiple build geometries for particle billboards, which we prefer to merge into large BLAS
+                                    (!RtxOptions::minimizeBlasMerging() && !useCostModel && blasPrims < minPrimsInDynamicBLAS) || // Avoid creating lots of small dynamic BLAS
                                     RtxOptions::forceMergeAllMeshes()) &&                                          // Setting to force all meshes into the merged BLAS
                                       instance->surface.instancesToObject == nullptr;                              // Never merge point instancer geometry
 
@@ -501,6 +1130,8 @@ namespace dxvk {
         assert(uniqueBlas.find(blasEntry) == uniqueBlas.end());
 
         if (blasEntry->dynamicBlas != nullptr) {
+          releaseCompactionQuery(*blasEntry->dynamicBlas);
+          m_diskCache.releaseQuery(*blasEntry->dynamicBlas);
           // Move the BLAS used by this geometry to the common pool.
           // This also ensures the dynamic blas resource that's still being used by previous TLAS is properly tracked for the next frame
           m_blasPool.push_back(std::move(blasEntry->dynamicBlas));
@@ -516,10 +1147,15 @@ namespace dxvk {
           geometry.geometry.triangles.transformData.deviceAddress = transformDeviceAddress;
         }
 
+        // Merged BLAS are rebuilt every frame, decal batches are counted once it's known whether they're rebuilt
+        if (!isDecalBatchInstance) {
+          m_numBlasBuildPrimitivesThisFrame += blasPrims;
+        }
+
         // Try to merge the instance into one of the blasBuckets
         bool merged = false;
         for (auto& bucket : blasBuckets) {
-          if (bucket->tryAddInstance(instance)) {
+          if (bucket->tryAddInstance(instance, isDecalBatchInstance)) {
             merged = true;
             break;
           }
@@ -528,7 +1164,7 @@ namespace dxvk {
         // The instance couldn't be merged into any bucket - make a new one
         if (!merged) {
           auto newBucket = std::make_unique<BlasBucket>();
-          merged = newBucket->tryAddInstance(instance);
+          merged = newBucket->tryAddInstance(instance, isDecalBatchInstance);
           assert(merged);
 
           blasBuckets.push_back(std::move(newBucket));
@@ -540,7 +1176,7 @@ namespace dxvk {
     }
 
     // Build/Update the dynamic BLAS
-    for (const std::pair<BlasEntry*, std::vector<RtInstance*>> pair : uniqueBlas) {
+    for (const auto& pair : uniqueBlas) {
       BlasEntry* blasEntry = pair.first;
       if (pair.second.size() == 0) {
         continue;
@@ -587,6 +1223,9 @@ namespace dxvk {
       buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
       buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
       buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR | additionalAccelerationStructureFlags();
+      if (RtxOptions::enableBlasCompaction()) {
+        buildInfo.flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
+      }
       buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
       buildInfo.geometryCount = 1;
       buildInfo.pGeometries = blasEntry->buildGeometries.data();
@@ -600,32 +1239,80 @@ namespace dxvk {
       // Try to reuse our dynamic BLAS if it exists
       Rc<PooledBlas>& selectedBlas = blasEntry->dynamicBlas;
 
-      const bool build = forceRebuild || !selectedBlas.ptr() || selectedBlas->accelStructure->info().size != sizeInfo.accelerationStructureSize;
+      // Refit the existing BLAS when only the vertex data changed this frame, and rebuild it when the topology changed, the build info isn't
+      // update compatible or the BLAS has been refit for long enough that its quality is likely degraded
+      // Note: A compacted BLAS is rebuilt rather than updated in place, as the update may need more memory than the compacted allocation has
+      bool update = blasEntry->frameLastUpdated == currentFrame || (selectedBlas.ptr() && selectedBlas->hasDeferredUpdate);
+      const XXH64_hash_t topologyHash = blasEntry->input.getGeometryData().getHashForRule<rules::TopologicalHash>();
+      const uint32_t maxBlasUpdatesBeforeRebuild = RtxOptions::maxBlasUpdatesBeforeRebuild();
+      const bool mustBuild = forceRebuild || !selectedBlas.ptr() || selectedBlas->buildSize != sizeInfo.accelerationStructureSize ||
+                             (update && (selectedBlas->isCompacted ||
+                                         selectedBlas->topologyHash != topologyHash ||
+                                         !validateUpdateMode(selectedBlas->buildInfo, buildInfo)));
+      bool build = mustBuild || (update && maxBlasUpdatesBeforeRebuild != 0 && selectedBlas->numUpdatesSinceBuild >= maxBlasUpdatesBeforeRebuild);
+
+      // Once over the per frame budget, keep tracing the BLAS as it is for instances the camera can't see, it is updated in a later frame.
+      // Only BLAS that still match the geometry's topology can be deferred, the others would be traced with the wrong primitives.
+      const uint32_t blasPrims = blasEntry->buildRanges[0].primitiveCount;
+      const uint32_t maxBlasBuildPrimitivesPerFrame = RtxOptions::maxBlasBuildPrimitivesPerFrame();
+      if (update && !mustBuild && maxBlasBuildPrimitivesPerFrame != 0 && m_numBlasBuildPrimitivesThisFrame + blasPrims > maxBlasBuildPrimitivesPerFrame) {
+        const bool isVisible = std::any_of(pair.second.begin(), pair.second.end(), [](const RtInstance* rtInstance) { return rtInstance->surface.isInsideFrustum; });
+        if (!isVisible) {
+          selectedBlas->hasDeferredUpdate = true;
+          update = false;
+          build = false;
+        }
+      }
+
+      const XXH64_hash_t diskCacheKey = RtxOptions::enableBlasDiskCache() ? getBlasDiskCacheKey(*blasEntry, buildInfo, boundOpacityMicromapHash) : kEmptyHash;
+
+      // The BLAS of geometry seen for the first time is deserialized instead of built when it is in the disk cache
+      std::vector<uint8_t> serializedBlas;
+      VkDeviceSize deserializedSize = 0;
+      const bool loadFromDiskCache = build && !selectedBlas.ptr() && diskCacheKey != kEmptyHash &&
+                                     m_diskCache.load(diskCacheKey, serializedBlas, deserializedSize);
 
       // There is no such BLAS - create one
       if (build) {
         if (selectedBlas.ptr()) {
+          releaseCompactionQuery(*selectedBlas);
+          m_diskCache.releaseQuery(*selectedBlas);
           // Move the BLAS used by this geometry to the common pool.
           // This also ensures the dynamic blas resource that's still being used by previous TLAS is properly tracked for the next frame
           m_blasPool.push_back(std::move(selectedBlas));
         }
-        selectedBlas = createPooledBlas(sizeInfo.accelerationStructureSize, "BLAS Dynamic");
+        if (loadFromDiskCache) {
+          selectedBlas = createPooledBlas(deserializedSize, "BLAS Dynamic Cached");
+        } else {
+          selectedBlas = createPooledBlas(sizeInfo.accelerationStructureSize, "BLAS Dynamic");
+        }
       }
 
       assert(selectedBlas.ptr());
       selectedBlas->frameLastTouched = currentFrame;
       blasEntry->dynamicBlas->opacityMicromapSourceHash = boundOpacityMicromapHash;
 
-      // Validate that the selected blas is compatible with the current build info for update purposes
-      bool update = blasEntry->frameLastUpdated == currentFrame;
-      if (update && !build && !validateUpdateMode(selectedBlas->buildInfo, buildInfo)) {
-        update = false;
-      }
+      if (loadFromDiskCache) {
+        m_diskCache.deserialize(ctx, serializedBlas, *selectedBlas);
 
-      if (update || build) {
-        if (update && !build) {
+        // The cached BLAS may have been compacted before it was serialized, so it is rebuilt rather than updated like a compacted one
+        selectedBlas->buildSize = sizeInfo.accelerationStructureSize;
+        selectedBlas->isCompacted = true;
+        selectedBlas->numUpdatesSinceBuild = 0;
+        selectedBlas->topologyHash = topologyHash;
+        selectedBlas->frameLastBuilt = currentFrame;
+        copyAccelerationStructureBuildGeometryInfo(buildInfo, selectedBlas->buildInfo);
+      } else if (update || build) {
+        m_numBlasBuildPrimitivesThisFrame += blasPrims;
+        selectedBlas->hasDeferredUpdate = false;
+
+        if (build) {
+          selectedBlas->numUpdatesSinceBuild = 0;
+          selectedBlas->topologyHash = topologyHash;
+        } else {
           buildInfo.srcAccelerationStructure = selectedBlas->accelStructure->getAccelStructure();
           buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+          ++selectedBlas->numUpdatesSinceBuild;
         }
         // Use the selected BLAS for the build
         buildInfo.dstAccelerationStructure = selectedBlas->accelStructure->getAccelStructure();
@@ -645,6 +1332,24 @@ namespace dxvk {
         blasRangesToBuild.push_back(&blasEntry->buildRanges[0]);
 
         copyAccelerationStructureBuildGeometryInfo(buildInfo, selectedBlas->buildInfo);
+
+        // A pending compacted or serialized size no longer applies to the rebuilt BLAS
+        releaseCompactionQuery(*selectedBlas);
+        m_diskCache.releaseQuery(*selectedBlas);
+        selectedBlas->frameLastBuilt = currentFrame;
+      } else {
+        const PooledBlas* blasBeforeCompaction = selectedBlas.ptr();
+        if (RtxOptions::enableBlasCompaction()) {
+          compactBlas(ctx, *blasEntry);
+        }
+
+        // Store the BLAS of geometry that hasn't changed since it was first drawn once the BLAS has settled,
+        // after any compaction so that the compacted BLAS is what gets cached
+        const bool isStatic = blasEntry->frameLastUpdated == blasEntry->frameCreated && !selectedBlas->hasDeferredUpdate;
+        if (diskCacheKey != kEmptyHash && isStatic && selectedBlas.ptr() == blasBeforeCompaction && selectedBlas->compactionQuery == UINT32_MAX &&
+            currentFrame - selectedBlas->frameLastBuilt >= RtxOptions::numFramesBeforeBlasCompaction()) {
+          m_diskCache.store(ctx, diskCacheKey, selectedBlas);
+        }
       }
 
       for (RtInstance* rtInstance : pair.second) {
@@ -652,15 +1357,7 @@ namespace dxvk {
         if (rtInstance->surface.instancesToObject == nullptr) {
           addBlas(rtInstance, blasEntry, nullptr);
         } else {
-          // This RtInstance is a PointInstancer - it represents multiple instances on the GPU.
-          // Track the starting index for this block of instances in m_reorderedSurfaces.
-          rtInstance->surface.surfaceIndexOfFirstInstance = m_reorderedSurfaces.size();
-
-          // Add the same RtInstance pointer to m_reorderedSurfaces multiple times
-          // Add a separate VkAccelerationStructureInstanceKHR to m_mergedInstances each time.
-          for (auto& instanceToObject : *rtInstance->surface.instancesToObject) {
-            addBlas(rtInstance, blasEntry, &instanceToObject);
-          }
+          addPointInstancerBlas(rtInstance, blasEntry);
         }
       }
 
@@ -756,6 +1453,45 @@ namespace dxvk {
     m_reorderedSurfacesFirstIndexOffset.push_back(0);
   }
 
+  void AccelManager::addPointInstancerBlas(RtInstance* instance, BlasEntry* blasEntry) {
+    // This RtInstance is a PointInstancer - it represents multiple instances on the GPU, all sharing the same BLAS.
+    // Track the starting index for this block of instances in m_reorderedSurfaces.
+    const std::vector<Matrix4>& instancesToObject = *instance->surface.instancesToObject;
+    const size_t firstSurfaceIndex = m_reorderedSurfaces.size();
+    instance->surface.surfaceIndexOfFirstInstance = firstSurfaceIndex;
+
+    // Everything but the transform and the surface index is the same for all instances, so set it up once.
+    // PointInstancers can have tens of thousands of instances, keep the per instance work to a minimum.
+    VkAccelerationStructureInstanceKHR blasInstance = instance->getVkInstance();
+    blasInstance.accelerationStructureReference = blasEntry->dynamicBlas->accelerationStructureReference;
+    const uint32_t customIndexFlags = blasInstance.instanceCustomIndex & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK);
+
+    if (instance->isObjectToWorldMirrored()) {
+      blasInstance.flags ^= VK_GEOMETRY_INSTANCE_TRIANGLE_FLIP_FACING_BIT_KHR;
+    }
+
+    auto& mergedInstances = instance->usesUnorderedApproximations() && RtxOptions::enableSeparateUnorderedApproximations()
+                          ? m_mergedInstances[Tlas::Unordered]
+                          : m_mergedInstances[Tlas::Opaque];
+    mergedInstances.reserve(mergedInstances.size() + instancesToObject.size());
+
+    const Matrix4& objectToWorld = instance->surface.objectToWorld;
+    for (size_t i = 0; i < instancesToObject.size(); ++i) {
+      blasInstance.instanceCustomIndex = customIndexFlags | (uint32_t(firstSurfaceIndex + i) & uint32_t(CUSTOM_INDEX_SURFACE_MASK));
+
+      // The D3D matrix on input, needs to be transposed before feeding to the VK API (left/right handed conversion)
+      // NOTE: VkTransformMatrixKHR is 4x3 matrix, and Matrix4 is 4x4
+      const Matrix4 transform = transpose(objectToWorld * instancesToObject[i]);
+      memcpy(&blasInstance.transform, &transform, sizeof(VkTransformMatrixKHR));
+
+      mergedInstances.push_back(blasInstance);
+    }
+
+    // Add the same RtInstance pointer to m_reorderedSurfaces once per instance
+    m_reorderedSurfaces.insert(m_reorderedSurfaces.end(), instancesToObject.size(), instance);
+    m_reorderedSurfacesFirstIndexOffset.insert(m_reorderedSurfacesFirstIndexOffset.end(), instancesToObject.size(), 0);
+  }
+
   void AccelManager::createBlasBuffersAndInstances(Rc<DxvkContext> ctx, 
                                                    const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets,
                                                    std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
@@ -764,8 +1500,47 @@ namespace dxvk {
 
     const uint32_t currentFrame = m_device->getCurrentFrameId();
 
+    auto appendMergedInstance = [this](const BlasBucket& bucket, const PooledBlas& blas) {
+      static float identityTransform[3][4] = {
+        { 1.f, 0.f, 0.f, 0.f },
+        { 0.f, 1.f, 0.f, 0.f },
+        { 0.f, 0.f, 1.f, 0.f }
+      };
+
+      // Append an instance of this merged BLAS to the merged instance list
+      VkAccelerationStructureInstanceKHR instance {};
+      instance.accelerationStructureReference = blas.accelerationStructureReference;
+      instance.flags = bucket.instanceFlags;
+      instance.instanceShaderBindingTableRecordOffset = bucket.instanceShaderBindingTableRecordOffset;
+      instance.mask = bucket.instanceMask;
+      instance.instanceCustomIndex = 
+        (bucket.customIndexFlags & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK)) |
+        (bucket.reorderedSurfacesOffset & uint32_t(CUSTOM_INDEX_SURFACE_MASK));
+      memcpy(static_cast<void*>(&instance.transform.matrix[0][0]), &identityTransform[0][0], sizeof(VkTransformMatrixKHR));
+
+      if (bucket.usesUnorderedApproximations && RtxOptions::enableSeparateUnorderedApproximations())
+        m_mergedInstances[Tlas::Unordered].push_back(instance);
+      else
+        m_mergedInstances[Tlas::Opaque].push_back(instance);
+    };
+
     // Create or find a matching BLAS for each bucket, then build it
     for (const auto& bucket : blasBuckets) {
+      // A decal batch that hasn't changed since the last frame keeps its BLAS.
+      // Opacity micromaps are bound by handle and may have been rebuilt, so batches using them are always built.
+      const bool isReusableDecalBatch = bucket->isDecalBatch && !bucket->hasOmmInstances;
+      if (isReusableDecalBatch) {
+        auto decalBatchIt = m_decalBatchBlas.find(bucket->decalBatchHash);
+        if (decalBatchIt != m_decalBatchBlas.end()) {
+          PooledBlas& decalBatchBlas = *decalBatchIt->second;
+          decalBatchBlas.frameLastTouched = currentFrame;
+          ctx->getCommandList()->trackResource<DxvkAccess::Read>(decalBatchBlas.accelStructure);
+
+          appendMergedInstance(*bucket, decalBatchBlas);
+          continue;
+        }
+      }
+
       // Fill out the build info
       VkAccelerationStructureBuildGeometryInfoKHR buildInfo {};
       buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
@@ -783,7 +1558,9 @@ namespace dxvk {
 
       // Try to find an existing BLAS that is minimally sufficient to fit this bucket of geometries
       PooledBlas* selectedBlas = nullptr;
-      for (const auto& blas : m_blasPool) {
+      uint32_t selectedBlasIndex = UINT32_MAX;
+      for (uint32_t i = 0; i < m_blasPool.size(); ++i) {
+        const Rc<PooledBlas>& blas = m_blasPool[i];
         size_t bufferSize = blas->accelStructure->info().size;
         uint32_t paddedLastTouched = blas->frameLastTouched + 1 + (RtxOptions::enablePreviousTLAS() ? 1u : 0u); /* note: +2 because frameLastTouched is unsigned and init'd with UINT32_MAX, and keep the BLAS'es for one extra frame for previous TLAS access */
         if (bufferSize >= sizeInfo.accelerationStructureSize &&
@@ -791,26 +1568,42 @@ namespace dxvk {
             paddedLastTouched <= currentFrame)
         {
           selectedBlas = blas.ptr();
+          selectedBlasIndex = i;
         }
       }
 
       // Must ensure that if we are updating an existing blas, rather than rebuilding, the blas is compatible with our new build info
       // Cannot update a blas that contains OMM instances, this leads to sporadic device lost errors
-      if (!bucket->hasOmmInstances && selectedBlas && validateUpdateMode(selectedBlas->buildInfo, buildInfo) && selectedBlas->primitiveCounts == bucket->primitiveCounts) {
+      // Decal batches are kept for many frames, so they get a full build rather than an update of someone else's geometry
+      if (!bucket->hasOmmInstances && !bucket->isDecalBatch && selectedBlas && validateUpdateMode(selectedBlas->buildInfo, buildInfo) && selectedBlas->primitiveCounts == bucket->primitiveCounts) {
         buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
       }
 
       // There is no such BLAS - create one and put it into the pool
       if (!selectedBlas) {
-        auto newBlas = createPooledBlas(sizeInfo.accelerationStructureSize, "BLAS Merged");
+        auto newBlas = createPooledBlas(sizeInfo.accelerationStructureSize, bucket->isDecalBatch ? "BLAS Decal Batch" : "BLAS Merged");
 
         selectedBlas = newBlas.ptr();
+        selectedBlasIndex = static_cast<uint32_t>(m_blasPool.size());
 
         m_blasPool.push_back(std::move(newBlas));
       }
       assert(selectedBlas);
       selectedBlas->frameLastTouched = currentFrame;
 
+      if (bucket->isDecalBatch) {
+        for (const uint32_t primitiveCount : bucket->primitiveCounts) {
+          m_numBlasBuildPrimitivesThisFrame += primitiveCount;
+        }
+      }
+
+      // Take the BLAS of a new decal batch out of the pool so that it isn't handed to other buckets while the batch is drawn
+      if (isReusableDecalBatch) {
+        std::swap(m_blasPool[selectedBlasIndex], m_blasPool.back());
+        m_decalBatchBlas[bucket->decalBatchHash] = std::move(m_blasPool.back());
+        m_blasPool.pop_back();
+      }
+
       // Use the selected BLAS for the build
       buildInfo.dstAccelerationStructure = selectedBlas->accelStructure->getAccelStructure();
       
@@ -836,27 +1629,7 @@ namespace dxvk {
       blasToBuild.push_back(buildInfo);
       blasRangesToBuild.push_back(bucket->ranges.data());
 
-      static float identityTransform[3][4] = {
-        { 1.f, 0.f, 0.f, 0.f },
-        { 0.f, 1.f, 0.f, 0.f },
-        { 0.f, 0.f, 1.f, 0.f }
-      };
-
-      // Append an instance of this merged BLAS to the merged instance list
-      VkAccelerationStructureInstanceKHR instance {};
-      instance.accelerationStructureReference = selectedBlas->accelerationStructureReference;
-      instance.flags = bucket->instanceFlags;
-      instance.instanceShaderBindingTableRecordOffset = bucket->instanceShaderBindingTableRecordOffset;
-      instance.mask = bucket->instanceMask;
-      instance.instanceCustomIndex = 
-        (bucket->customIndexFlags & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK)) |
-        (bucket->reorderedSurfacesOffset & uint32_t(CUSTOM_INDEX_SURFACE_MASK));
-      memcpy(static_cast<void*>(&instance.transform.matrix[0][0]), &identityTransform[0][0], sizeof(VkTransformMatrixKHR));
-
-      if (bucket->usesUnorderedApproximations && RtxOptions::enableSeparateUnorderedApproximations())
-        m_mergedInstances[Tlas::Unordered].push_back(instance);
-      else
-        m_mergedInstances[Tlas::Opaque].push_back(instance);
+      appendMergedInstance(*bucket, *selectedBlas);
     }
   }
 
@@ -1064,15 +1837,99 @@ namespace dxvk {
     std::swap(currIndex, prevIndex);
   }
 
+  // Writes the parts of data that differ from what the buffer was last written with, comparing in units of the given granularity.
+  // Changes close to each other are written together since every write has a fixed cost. Data past the end of the uploaded data is always written.
+  static void writeChangedRangesToBuffer(Rc<DxvkContext> ctx, const Rc<DxvkBuffer>& buffer, const void* data, size_t size,
+                                         const void* uploadedData, size_t uploadedSize, size_t granularity) {
+    constexpr size_t kMaxGranulesBetweenMergedRanges = 4;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* uploadedBytes = static_cast<const unsigned char*>(uploadedData);
+    const size_t comparedSize = std::min(size, uploadedSize);
+
+    size_t rangeBegin = 0;
+    size_t rangeEnd = 0;
+
+    for (size_t offset = 0; offset < comparedSize; offset += granularity) {
+      const size_t granuleSize = std::min(granularity, comparedSize - offset);
+
+      if (memcmp(bytes + offset, uploadedBytes + offset, granuleSize) == 0) {
+        continue;
+      }
+
+      if (rangeEnd != 0 && offset > rangeEnd + kMaxGranulesBetweenMergedRanges * granularity) {
+        ctx->writeToBuffer(buffer, rangeBegin, rangeEnd - rangeBegin, bytes + rangeBegin);
+        rangeEnd = 0;
+      }
+
+      if (rangeEnd == 0) {
+        rangeBegin = offset;
+      }
+      rangeEnd = offset + granuleSize;
+    }
+
+    if (size > comparedSize) {
+      if (rangeEnd == 0 || comparedSize > rangeEnd + kMaxGranulesBetweenMergedRanges * granularity) {
+        if (rangeEnd != 0) {
+          ctx->writeToBuffer(buffer, rangeBegin, rangeEnd - rangeBegin, bytes + rangeBegin);
+        }
+        rangeBegin = comparedSize;
+      }
+      rangeEnd = size;
+    }
+
+    if (rangeEnd != 0) {
+      ctx->writeToBuffer(buffer, rangeBegin, rangeEnd - rangeBegin, bytes + rangeBegin);
+    }
+  }
+
+  // Groups surfaces that take similar paths through the integrator's material code, see SURFACE_SORT_KEY_*
+  static uint8_t calcSurfaceSortKey(const RtInstance& instance, const ResourceCache& resourceCache) {
+    const RtSurface& surface = instance.surface;
+    const uint32_t materialType = (instance.getVkInstance().instanceCustomIndex >> CUSTOM_INDEX_MATERIAL_TYPE_BIT) & surfaceMaterialTypeMask;
+
+    uint32_t feature = SURFACE_SORT_KEY_FEATURE_NONE;
+    if (materialType == surfaceMaterialTypeOpaque && surface.surfaceMaterialIndex != kSurfaceInvalidSurfaceMaterialIndex &&
+        resourceCache.get(surface.surfaceMaterialIndex).getType() == RtSurfaceMaterialType::Opaque) {
+      const RtOpaqueSurfaceMaterial& material = resourceCache.get(surface.surfaceMaterialIndex).getOpaqueSurfaceMaterial();
+      if (material.getSubsurfaceMaterialIndex() != kSurfaceMaterialInvalidTextureIndex) {
+        feature = SURFACE_SORT_KEY_FEATURE_SUBSURFACE;
+      } else if (!surface.alphaState.isFullyOpaque) {
+        feature = SURFACE_SORT_KEY_FEATURE_ALPHA;
+      } else if (material.getEnableEmission() || surface.isEmissive) {
+        feature = SURFACE_SORT_KEY_FEATURE_EMISSIVE;
+      }
+    }
+
+    uint32_t category = SURFACE_SORT_KEY_CATEGORY_WORLD;
+    if (instance.isViewModel() || instance.testCategoryFlags(InstanceCategories::ThirdPersonPlayerModel, InstanceCategories::ThirdPersonPlayerBody)) {
+      category = SURFACE_SORT_KEY_CATEGORY_CHARACTER;
+    } else if (surface.alphaState.isParticle || instance.testCategoryFlags(InstanceCategories::Particle, InstanceCategories::Beam)) {
+      category = SURFACE_SORT_KEY_CATEGORY_PARTICLE;
+    } else if (surface.alphaState.isDecal) {
+      category = SURFACE_SORT_KEY_CATEGORY_DECAL;
+    }
+
+    return uint8_t((materialType << SURFACE_SORT_KEY_MATERIAL_TYPE_BIT) |
+                   (feature << SURFACE_SORT_KEY_MATERIAL_FEATURE_BIT) |
+                   (category << SURFACE_SORT_KEY_CATEGORY_BIT));
+  }
+
   void AccelManager::uploadSurfaceData(Rc<DxvkContext> ctx) {
     ScopedCpuProfileZone();
     if (m_reorderedSurfaces.empty()) {
       return;
     }
 
+    const ResourceCache& resourceCache = ctx->getCommonObjects()->getSceneManager();
+
     // Simplify syntax for accessing the persistent containers
     auto& surfacesGPUData = uploadSurfaceDataFuncState.surfacesGPUData;
     auto& surfaceIndexMapping = uploadSurfaceDataFuncState.surfaceIndexMapping;
+    auto& uploadedSurfacesGPUData = uploadSurfaceDataFuncState.uploadedSurfacesGPUData;
+    auto& uploadedSurfaceIndexMapping = uploadSurfaceDataFuncState.uploadedSurfaceIndexMapping;
+
+    const bool uploadChangedDataOnly = RtxOptions::uploadChangedSurfaceDataOnly();
 
     // Surface buffer
     const auto surfacesGPUSize = m_reorderedSurfaces.size() * kSurfaceGPUSize;
@@ -1086,6 +1943,8 @@ namespace dxvk {
     info.size = align(surfacesGPUSize, kBufferAlignment);
     if (m_surfaceBuffer == nullptr || info.size > m_surfaceBuffer->info().size) {
       m_surfaceBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXAccelerationStructure, "Surface Buffer");
+      // A new buffer has no contents to compare against
+      uploadedSurfacesGPUData.clear();
     }
 
     uint32_t maxPreviousSurfaceIndex = 0;
@@ -1097,6 +1956,18 @@ namespace dxvk {
     for (uint32_t i = 0; i < m_reorderedSurfaces.size(); ++i) {
       const auto& currentInstance = *m_reorderedSurfaces[i];
       RtSurface& currentSurface = m_reorderedSurfaces[i]->surface;
+      currentSurface.sortKey = calcSurfaceSortKey(currentInstance, resourceCache);
+
+      if (currentInstance.surface.instancesToObject && i == currentSurface.surfaceIndexOfFirstInstance) {
+        // All instances of a PointInstancer are contiguous and written in one go, see addPointInstancerBlas
+        assert(m_reorderedSurfacesFirstIndexOffset[i] == 0);
+        currentSurface.writeInstancesGPUData(surfacesGPUData.data(), dataOffset, i);
+
+        // Find the size of the surface mapping buffer
+        maxPreviousSurfaceIndex = std::max(maxPreviousSurfaceIndex, uint32_t(currentInstance.getPreviousSurfaceIndex() + currentInstance.surface.instancesToObject->size()));
+        i += uint32_t(currentInstance.surface.instancesToObject->size()) - 1;
+        continue;
+      }
 
       // Split instance geometry need to have their first index offset set in their corresponding surface instances
       currentSurface.firstIndex += m_reorderedSurfacesFirstIndexOffset[i];
@@ -1114,7 +1985,14 @@ namespace dxvk {
     assert(dataOffset == surfacesGPUSize);
     assert(surfacesGPUData.size() == surfacesGPUSize);
 
-    ctx->writeToBuffer(m_surfaceBuffer, 0, surfacesGPUData.size(), surfacesGPUData.data());
+    if (uploadChangedDataOnly) {
+      writeChangedRangesToBuffer(ctx, m_surfaceBuffer, surfacesGPUData.data(), surfacesGPUData.size(),
+                                 uploadedSurfacesGPUData.data(), uploadedSurfacesGPUData.size(), kSurfaceGPUSize);
+      std::swap(surfacesGPUData, uploadedSurfacesGPUData);
+    } else {
+      ctx->writeToBuffer(m_surfaceBuffer, 0, surfacesGPUData.size(), surfacesGPUData.data());
+      uploadedSurfacesGPUData.clear();
+    }
 
     // Allocate and initialize the surface mapping buffer
     surfaceIndexMapping.resize(maxPreviousSurfaceIndex + 1);
@@ -1175,9 +2053,19 @@ namespace dxvk {
       info.size = align(surfaceIndexMapping.size() * sizeof(int), kBufferAlignment);
       if (m_surfaceMappingBuffer == nullptr || info.size > m_surfaceMappingBuffer->info().size) {
         m_surfaceMappingBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXAccelerationStructure, "Surface Mapping Buffer");
+        uploadedSurfaceIndexMapping.clear();
       }
 
-      ctx->writeToBuffer(m_surfaceMappingBuffer, 0, surfaceIndexMapping.size() * sizeof(surfaceIndexMapping[0]), surfaceIndexMapping.data());
+      if (uploadChangedDataOnly) {
+        // Compare in 64 byte granules, comparing single indices would split the writes up too much
+        writeChangedRangesToBuffer(ctx, m_surfaceMappingBuffer,
+                                   surfaceIndexMapping.data(), surfaceIndexMapping.size() * sizeof(surfaceIndexMapping[0]),
+                                   uploadedSurfaceIndexMapping.data(), uploadedSurfaceIndexMapping.size() * sizeof(uploadedSurfaceIndexMapping[0]), 64);
+        std::swap(surfaceIndexMapping, uploadedSurfaceIndexMapping);
+      } else {
+        ctx->writeToBuffer(m_surfaceMappingBuffer, 0, surfaceIndexMapping.size() * sizeof(surfaceIndexMapping[0]), surfaceIndexMapping.data());
+        uploadedSurfaceIndexMapping.clear();
+      }
     }
   }
 
@@ -1257,6 +2145,10 @@ namespace dxvk {
     }
   }
 
+  void AccelManager::onFrameEnd() {
+    m_diskCache.onFrameEnd();
+  }
+
   void AccelManager::buildTlas(Rc<DxvkContext> ctx) {
     if (m_vkInstanceBuffer == nullptr)
       return;
@@ -1275,6 +2167,9 @@ namespace dxvk {
     for (auto&& blas : m_blasPool) {
       ctx->getCommandList()->trackResource<DxvkAccess::Read>(blas->accelStructure);
     }
+    for (auto&& decalBatch : m_decalBatchBlas) {
+      ctx->getCommandList()->trackResource<DxvkAccess::Read>(decalBatch.second->accelStructure);
+    }
 
     size_t totalScratchSize = 0;
     internalBuildTlas<Tlas::Opaque>(ctx, totalScratchSize);
@@ -1286,9 +2181,6 @@ namespace dxvk {
       VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
       VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
 
-    // Release the scratch memory so it can be reused by rest of the frame.
-    m_scratchBuffer = nullptr;
-
     OpacityMicromapManager* opacityMicromapManager = ctx->getCommonObjects()->getSceneManager().getOpacityMicromapManager();
     if (opacityMicromapManager) {
       opacityMicromapManager->onFinishedBuilding();
@@ -23,6 +23,8 @@
 
 #include <mutex>
 #include <vector>
+#include <list>
+#include <filesystem>
 #include <unordered_set>
 #include <unordered_map>
 #include "../util/rc/util_rc_ptr.h"
@@ -40,6 +42,74 @@ class ResourceCache;
 class CameraManager;
 class OpacityMicromapManager;
 
+// Persists the dedicated BLAS of static geometry across runs, keyed by a hash of the geometry and its build parameters.
+// A BLAS is serialized in two steps, its serialized size is queried first and a copy to host memory is recorded once
+// the size is available. The copy is written to disk on the render thread a few frames later, when the readback is done.
+// Serialized BLAS embed the driver's compatibility UUIDs, cached BLAS the device can't deserialize are built again.
+class BlasDiskCache {
+public:
+  BlasDiskCache(BlasDiskCache const&) = delete;
+  BlasDiskCache& operator=(BlasDiskCache const&) = delete;
+
+  explicit BlasDiskCache(DxvkDevice* device);
+  ~BlasDiskCache();
+
+  bool contains(XXH64_hash_t key);
+  // Returns the serialized BLAS and the size of the acceleration structure it deserializes to,
+  // or false if it isn't cached or was serialized by an incompatible driver or device
+  bool load(XXH64_hash_t key, std::vector<uint8_t>& data, VkDeviceSize& accelStructureSize);
+  // Records the deserialization of a loaded BLAS into a BLAS of the size returned by load()
+  void deserialize(Rc<DxvkContext> ctx, const std::vector<uint8_t>& data, PooledBlas& blas);
+  // Advances the serialization of a BLAS that was neither built nor updated this frame, it is written to disk in a later onFrameEnd()
+  void store(Rc<DxvkContext> ctx, XXH64_hash_t key, const Rc<PooledBlas>& blas);
+  // Drops a pending serialized size query, the BLAS is about to change or be released
+  void releaseQuery(PooledBlas& blas);
+  void clear();
+  void garbageCollection(uint32_t currentFrame);
+  void onFrameEnd();
+
+private:
+  struct FileHeader {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t dataSize = 0;
+  };
+
+  struct SerializationQuery {
+    Rc<PooledBlas> blas;
+    XXH64_hash_t key = kEmptyHash;
+    uint32_t frameWritten = kInvalidFrameIndex;
+  };
+
+  struct PendingWrite {
+    XXH64_hash_t key;
+    Rc<DxvkBuffer> readbackBuffer;
+    VkDeviceSize size;
+  };
+
+  static constexpr uint32_t kMagic = 0x53414c42; // "BLAS"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kMaxQueries = 256;
+  // A pending query is dropped if its BLAS isn't drawn again within this many frames
+  static constexpr uint32_t kQueryTimeoutFrames = 120;
+  // Required alignment of the device addresses BLAS are serialized to and deserialized from
+  static constexpr VkDeviceSize kSerializedDataAlignment = 256;
+
+  void initialize();
+  std::filesystem::path getFilePath(XXH64_hash_t key) const;
+
+  DxvkDevice* m_device;
+  bool m_isInitialized = false;
+  std::filesystem::path m_directory;
+  std::unordered_set<XXH64_hash_t> m_cachedKeys;
+  std::list<PendingWrite> m_pendingWrites;
+
+  VkQueryPool m_queryPool = VK_NULL_HANDLE;
+  std::vector<SerializationQuery> m_queries;
+  std::vector<uint32_t> m_freeQueries;
+  uint32_t m_numCommandsThisFrame = 0;
+};
+
 // AccelManager is responsible for maintaining the acceleration structures (BLAS and TLAS)
 class AccelManager : public CommonDeviceObject {
   class BlasBucket {
@@ -57,11 +127,21 @@ class AccelManager : public CommonDeviceObject {
     bool usesUnorderedApproximations = false;
     uint32_t reorderedSurfacesOffset = UINT32_MAX;
     bool hasOmmInstances = false;
+    // World space bounds of the instances in the bucket and the sum of their individual surface areas
+    AxisAlignedBoundingBox bounds {};
+    float sumInstanceSurfaceArea = 0.f;
+    // Decal batches only hold decals of a single material, see 'rtx.enableDecalBatching'.
+    // The batch hash covers everything the BLAS build reads, so an unchanged batch can keep its BLAS.
+    bool isDecalBatch = false;
+    XXH64_hash_t decalBatchMaterialHash = kEmptyHash;
+    XXH64_hash_t decalBatchHash = kEmptyHash;
     
     // Tries to add a geometry instance to the bucket. The addition is successful if either:
     //   a) the bucket is empty,
-    //   b) the instance has the same mask etc. as all other instances in the bucket.
-    bool tryAddInstance(RtInstance* instance);
+    //   b) the instance has the same mask etc. as all other instances in the bucket,
+    //      and with the cost model enabled, it is close enough to them to not inflate the bucket's bounds.
+    // Decals that go into a decal batch are only ever added to decal batches of the same material.
+    bool tryAddInstance(RtInstance* instance, bool isDecalBatchInstance);
   };
 
 public:
@@ -69,6 +149,7 @@ public:
   AccelManager& operator=(AccelManager const&) = delete;
 
   explicit AccelManager(DxvkDevice* device);
+  ~AccelManager();
 
   // Returns a GPU buffer containing the surface data for active instances
   const Rc<DxvkBuffer> getSurfaceBuffer() const { return m_surfaceBuffer; }
@@ -111,6 +192,11 @@ public:
   uint32_t getSurfaceCount() const { return m_reorderedSurfaces.size(); }
   const std::vector<RtInstance*>& getOrderedInstances() const { return m_reorderedSurfaces; }
 
+  // Primitives of the merged and dynamic BLAS built or updated in the current frame
+  uint32_t getBlasBuildPrimitivesThisFrame() const { return m_numBlasBuildPrimitivesThisFrame; }
+
+  void onFrameEnd();
+
 private:
   struct SurfaceInfo {
     uint32_t surfaceMaterialIndex;
@@ -124,10 +210,20 @@ private:
     uint32_t prevIndex = 1;
   } buildParticleSurfaceMappingFuncState;
 
+  // Persistent containers to reduce frame to frame reallocations in ::mergeInstancesIntoBlas()
+  struct {
+    std::vector<VkTransformMatrixKHR> instanceTransforms;
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> blasToBuild;
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR*> blasRangesToBuild;
+  } mergeInstancesIntoBlasFuncState;
+
   // Persistent containers to reduce frame to frame reallocations in ::uploadSurfaceData()
   struct {
     std::vector<unsigned char> surfacesGPUData;
     std::vector<uint32_t> surfaceIndexMapping;
+    // Contents of the surface and surface mapping buffers as of the last upload, swapped with the above after every upload
+    std::vector<unsigned char> uploadedSurfacesGPUData;
+    std::vector<uint32_t> uploadedSurfaceIndexMapping;
   } uploadSurfaceDataFuncState;
 
   void buildBlases(Rc<DxvkContext> ctx, DxvkBarrierSet& execBarriers,
@@ -139,6 +235,7 @@ private:
                    float elapsedTime,
                    size_t& currentScratchOffset);
   void addBlas(RtInstance* instance, BlasEntry* blasEntry, const Matrix4* instanceToObject);
+  void addPointInstancerBlas(RtInstance* instance, BlasEntry* blasEntry);
   void createBlasBuffersAndInstances(Rc<DxvkContext> ctx, 
                                      const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets,
                                      std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
@@ -151,12 +248,24 @@ private:
 
   bool validateUpdateMode(const VkAccelerationStructureBuildGeometryInfoKHR& oldInfo, const VkAccelerationStructureBuildGeometryInfoKHR& newInfo);
 
+  // Advances the compaction of a dynamic BLAS that was neither built nor updated this frame: queries its compacted size
+  // once it has been unchanged for long enough, then replaces it with a compacted copy once the size is available
+  void compactBlas(Rc<DxvkContext> ctx, BlasEntry& blasEntry);
+  void releaseCompactionQuery(PooledBlas& blas);
+  // Returns the BLAS disk cache key of a dedicated BLAS, or kEmptyHash if its geometry can't be cached
+  static XXH64_hash_t getBlasDiskCacheKey(const BlasEntry& blasEntry, const VkAccelerationStructureBuildGeometryInfoKHR& buildInfo,
+                                          XXH64_hash_t boundOpacityMicromapHash);
+  // Drops pooled BLAS that are no longer used, oldest first, until the given size is freed. Returns the freed size.
+  VkDeviceSize reclaimUnusedBlas(VkDeviceSize size);
+
   std::vector<RtInstance*> m_reorderedSurfaces;
   std::vector<uint32_t> m_reorderedSurfacesFirstIndexOffset;
   std::vector<uint32_t> m_reorderedSurfacesPrimitiveIDPrefixSum;              // Exclusive prefix sum for this frame's surface primitive count array
   std::vector<uint32_t> m_reorderedSurfacesPrimitiveIDPrefixSumLastFrame;     // Exclusive prefix sum for last frame's surface primitive count array
   std::vector<VkAccelerationStructureInstanceKHR> m_mergedInstances[Tlas::Count];
   std::vector<Rc<PooledBlas>> m_blasPool;
+  // BLAS of the decal batches drawn in the last frames by batch hash, held outside of the pool while they're in use
+  std::unordered_map<XXH64_hash_t, Rc<PooledBlas>> m_decalBatchBlas;
 
   Rc<DxvkBuffer> m_vkInstanceBuffer; // Note: Holds Vulkan AS Instances, not RtInstances
   Rc<DxvkBuffer> m_surfaceBuffer;
@@ -177,6 +286,23 @@ private:
 
   VkDeviceSize m_scratchAlignment;
   Rc<DxvkBuffer> m_scratchBuffer;
+
+  static constexpr uint32_t kMaxCompactionQueries = 256;
+  // A pending query is dropped if its BLAS isn't drawn again within this many frames
+  static constexpr uint32_t kCompactionQueryTimeoutFrames = 120;
+
+  struct CompactionQuery {
+    Rc<PooledBlas> blas;
+    uint32_t frameWritten = kInvalidFrameIndex;
+  };
+
+  VkQueryPool m_compactionQueryPool = VK_NULL_HANDLE;
+  std::vector<CompactionQuery> m_compactionQueries;
+  std::vector<uint32_t> m_freeCompactionQueries;
+  uint32_t m_numCompactionCommandsThisFrame = 0;
+  BlasDiskCache m_diskCache;
+  // Primitives of the merged and dynamic BLAS built or updated this frame, see 'rtx.maxBlasBuildPrimitivesPerFrame'
+  uint32_t m_numBlasBuildPrimitivesThisFrame = 0;
 };
 
 }  // namespace dxvk
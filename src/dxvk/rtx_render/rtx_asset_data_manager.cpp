@@ -25,7 +25,12 @@
 #include "rtx_asset_package.h"
 #include "rtx_io.h"
 #include "dxvk_scoped_annotation.h"
+#include "../../util/util_filesys.h"
+#include "../../util/thread.h"
 #include <gli/gli.hpp>
+#include <cmath>
+#include <deque>
+#include <unordered_set>
 
 namespace dxvk {
 
@@ -337,6 +342,10 @@ namespace dxvk {
       offset64 = offset;
     }
 
+    int faces() const {
+      return m_faces;
+    }
+
     bool load(const std::string& filename) {
       if (parse(filename)) {
         m_info.type = type();
@@ -357,6 +366,103 @@ namespace dxvk {
     }
   };
 
+  bool AssetPackage::mapFile() {
+    if (m_mappedBase != nullptr) {
+      return true;
+    }
+    if (m_mappingFailed) {
+      return false;
+    }
+    // Don't retry on every blob if mapping is not possible
+    m_mappingFailed = true;
+
+    // RTX IO opens the package on its own, so the read access has to be shared
+    HANDLE hFile = CreateFile(m_filename.c_str(),
+                              GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      ONCE(Logger::warn(str::format("CreateFile fail (error=", GetLastError(), "): ", m_filename)));
+      return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize)) {
+      CloseHandle(hFile);
+      return false;
+    }
+
+    HANDLE hMapping = CreateFileMapping(hFile, NULL,
+                                        PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+      ONCE(Logger::warn(str::format("CreateFileMapping fail (error=", GetLastError(), "): ", m_filename)));
+      CloseHandle(hFile);
+      return false;
+    }
+
+    LPVOID lpBaseAddress = MapViewOfFile(hMapping,
+                                         FILE_MAP_READ, 0, 0, 0);
+    if (lpBaseAddress == NULL) {
+      ONCE(Logger::warn(str::format("MapViewOfFile fail (error=", GetLastError(), "): ", m_filename)));
+      CloseHandle(hMapping);
+      CloseHandle(hFile);
+      return false;
+    }
+
+    m_mappedFile = hFile;
+    m_mapping = hMapping;
+    m_mappedBase = (const uint8_t*) lpBaseAddress;
+    m_mappedSize = fileSize.QuadPart;
+    m_mappingFailed = false;
+
+    return true;
+  }
+
+  void AssetPackage::unmapFile() {
+    if (m_mappedBase) {
+      UnmapViewOfFile(m_mappedBase);
+      CloseHandle(m_mapping);
+      CloseHandle(m_mappedFile);
+      m_mappedFile = nullptr;
+      m_mapping = nullptr;
+      m_mappedBase = nullptr;
+      m_mappedSize = 0;
+    }
+  }
+
+  const void* AssetPackage::mapDataBlob(uint32_t idx) {
+    if (auto blobDesc = getDataBlobDesc(idx)) {
+      std::lock_guard<dxvk::mutex> lock(m_handleMutex);
+
+      if (!mapFile()) {
+        return nullptr;
+      }
+
+      if (blobDesc->offset + blobDesc->size > m_mappedSize) {
+        ONCE(Logger::warn(str::format("Data blob is out of the package bounds: ", m_filename)));
+        return nullptr;
+      }
+
+      return m_mappedBase + blobDesc->offset;
+    }
+
+    return nullptr;
+  }
+
+  void AssetPackage::prefetchDataBlob(uint32_t idx) {
+    if (auto blobDesc = getDataBlobDesc(idx)) {
+      std::lock_guard<dxvk::mutex> lock(m_handleMutex);
+
+      if (m_mappedBase == nullptr || blobDesc->offset + blobDesc->size > m_mappedSize) {
+        return;
+      }
+
+      WIN32_MEMORY_RANGE_ENTRY range;
+      range.VirtualAddress = (PVOID) (m_mappedBase + blobDesc->offset);
+      range.NumberOfBytes = blobDesc->size;
+      PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+  }
+
   class PackagedAssetData : public AssetData {
   public:
     PackagedAssetData() = delete;
@@ -437,6 +543,18 @@ namespace dxvk {
           throw DxvkError("Compressed data blobs are not supported for CPU readback.");
         }
 
+        if (RtxOptions::memoryMapAssetPackages()) {
+          if (const void* mapped = m_package->mapDataBlob(blobIdx)) {
+            // Mips are read from the largest one down, the mip tail blob is the last one
+            // to be read, so let the OS page it in while the other mips are copied
+            const uint32_t tailBlobIdx = getBlobIndex(layer, 0, m_assetDesc->numMips - 1);
+            if (tailBlobIdx != blobIdx) {
+              m_package->prefetchDataBlob(tailBlobIdx);
+            }
+            return mapped;
+          }
+        }
+
         std::vector<uint8_t> data(blobDesc->size);
         m_package->readDataBlob(blobIdx, data.data(), data.size());
 
@@ -509,7 +627,221 @@ namespace dxvk {
     std::unordered_map<uint32_t, std::vector<uint8_t>> m_data;
   };
 
-  AssetDataManager::AssetDataManager() {
+  namespace {
+    // Averages 2x2 texel blocks of an 8 bit per channel image, the odd edge texels are clamped.
+    // Color channels of sRGB images are averaged in linear space.
+    void downsampleBox(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                       uint8_t* dst, uint32_t channels, bool srgb) {
+      static const auto srgbToLinear = [] {
+        std::array<float, 256> table;
+        for (uint32_t i = 0; i < 256; i++) {
+          const float c = float(i) / 255.f;
+          table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+      }();
+
+      const uint32_t dstWidth = std::max(srcWidth >> 1, 1u);
+      const uint32_t dstHeight = std::max(srcHeight >> 1, 1u);
+      const uint32_t colorChannels = std::min(channels, 3u);
+
+      for (uint32_t y = 0; y < dstHeight; y++) {
+        const uint32_t y0 = std::min(2 * y, srcHeight - 1);
+        const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+        for (uint32_t x = 0; x < dstWidth; x++) {
+          const uint32_t x0 = std::min(2 * x, srcWidth - 1);
+          const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+          const uint8_t* texels[4] = {
+            src + (y0 * srcWidth + x0) * channels,
+            src + (y0 * srcWidth + x1) * channels,
+            src + (y1 * srcWidth + x0) * channels,
+            src + (y1 * srcWidth + x1) * channels,
+          };
+
+          for (uint32_t c = 0; c < channels; c++) {
+            float value;
+            if (srgb && c < colorChannels) {
+              const float linear = 0.25f * (srgbToLinear[texels[0][c]] + srgbToLinear[texels[1][c]] +
+                                            srgbToLinear[texels[2][c]] + srgbToLinear[texels[3][c]]);
+              value = 255.f * (linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.f / 2.4f) - 0.055f);
+            } else {
+              value = 0.25f * float(texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c]);
+            }
+            dst[(y * dstWidth + x) * channels + c] = uint8_t(std::clamp(value + 0.5f, 0.f, 255.f));
+          }
+        }
+      }
+    }
+
+    // Channel count of the formats the mip cache can filter, 0 if not supported
+    uint32_t getMipCacheChannelCount(VkFormat format, bool& srgb) {
+      srgb = false;
+      switch (format) {
+      case VK_FORMAT_R8_UNORM:
+        return 1;
+      case VK_FORMAT_R8G8_UNORM:
+        return 2;
+      case VK_FORMAT_R8G8B8A8_SRGB:
+      case VK_FORMAT_B8G8R8A8_SRGB:
+        srgb = true;
+        return 4;
+      case VK_FORMAT_R8G8B8A8_UNORM:
+      case VK_FORMAT_B8G8R8A8_UNORM:
+        return 4;
+      default:
+        return 0;
+      }
+    }
+  }
+
+  class AssetDataManager::MipCache {
+  public:
+    ~MipCache() {
+      {
+        std::unique_lock<dxvk::mutex> lock(m_mutex);
+        m_stop = true;
+        m_cond.notify_one();
+      }
+      if (m_thread.joinable()) {
+        m_thread.join();
+      }
+    }
+
+    static bool isCandidate(DdsTextureData& dds) {
+      const AssetInfo& info = dds.info();
+      bool srgb;
+      return info.mipLevels == 1 &&
+             info.numLayers == 1 &&
+             dds.faces() == 1 &&
+             info.type == AssetType::Image2D &&
+             (info.extent.width > 1 || info.extent.height > 1) &&
+             getMipCacheChannelCount(info.format, srgb) != 0;
+    }
+
+    // Returns the path of the mipped copy of the file if it's ready,
+    // otherwise queues the copy to be built and returns an empty path
+    std::filesystem::path lookup(const std::string& filename, std::filesystem::file_time_type lastWriteTime) {
+      const XXH64_hash_t key = XXH3_64bits_withSeed(filename.data(), filename.size(),
+                                                    static_cast<XXH64_hash_t>(lastWriteTime.time_since_epoch().count()));
+
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      // Assets are looked up from the mod loading threads too
+      if (m_directory.empty()) {
+        m_directory = util::RtxFileSys::path(util::RtxFileSys::Cache) / "textures";
+      }
+      const std::filesystem::path path = m_directory / (hashToString(key) + ".dds");
+
+      std::error_code ec;
+      if (std::filesystem::is_regular_file(path, ec)) {
+        return path;
+      }
+
+      if (m_queued.insert(key).second) {
+        m_jobs.push_back(Job { filename, path });
+        m_cond.notify_one();
+
+        if (!m_thread.joinable()) {
+          m_thread = dxvk::thread([this] { buildLoop(); });
+          m_thread.set_priority(ThreadPriority::Lowest);
+        }
+      }
+      return {};
+    }
+
+  private:
+    struct Job {
+      std::string source;
+      std::filesystem::path path;
+    };
+
+    void buildLoop() {
+      env::setThreadName("rtx-texture-mip-cache");
+
+      {
+        std::unique_lock<dxvk::mutex> lock(m_mutex);
+        util::RtxFileSys::mkDirs(m_directory);
+      }
+
+      while (true) {
+        Job job;
+        {
+          std::unique_lock<dxvk::mutex> lock(m_mutex);
+          m_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+          if (m_stop) {
+            return;
+          }
+          job = std::move(m_jobs.front());
+          m_jobs.pop_front();
+        }
+
+        try {
+          build(job);
+        } catch (const DxvkError& e) {
+          Logger::err(str::format("Failed to build mips for ", job.source, ": ", e.message()));
+        }
+      }
+    }
+
+    void build(const Job& job) {
+      ScopedCpuProfileZone();
+
+      // A separate instance, the one handed out by findAsset may be read by the texture loader at the same time
+      Rc<DdsTextureData> dds = new DdsTextureData;
+      if (!dds->load(job.source) || !isCandidate(*dds)) {
+        return;
+      }
+
+      const AssetInfo& info = dds->info();
+      bool srgb;
+      const uint32_t channels = getMipCacheChannelCount(info.format, srgb);
+
+      // Vulkan and GLI formats share values
+      gli::texture2d texture(static_cast<gli::format>(info.format), gli::extent2d(info.extent.width, info.extent.height));
+
+      const void* data = dds->data(0, 0);
+      if (data == nullptr || texture.size(0) != size_t(info.extent.width) * info.extent.height * channels) {
+        return;
+      }
+      memcpy(texture.data(0, 0, 0), data, texture.size(0));
+      dds->releaseSource();
+
+      for (size_t level = 1; level < texture.levels(); level++) {
+        const gli::extent2d srcExtent = texture.extent(level - 1);
+        downsampleBox(static_cast<const uint8_t*>(texture.data(0, 0, level - 1)), srcExtent.x, srcExtent.y,
+                      static_cast<uint8_t*>(texture.data(0, 0, level)), channels, srgb);
+      }
+
+      // Write to a temporary file first, so that a partially written texture is never picked up
+      std::filesystem::path tmpPath = job.path;
+      tmpPath += ".tmp";
+      if (!gli::save_dds(texture, tmpPath.string())) {
+        Logger::warn(str::format("Failed to write ", tmpPath.string()));
+        return;
+      }
+
+      std::error_code ec;
+      std::filesystem::rename(tmpPath, job.path, ec);
+      if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return;
+      }
+
+      Logger::info(str::format("Built ", texture.levels(), " mips for ", job.source, " in ", job.path.string()));
+    }
+
+    std::filesystem::path m_directory;
+
+    dxvk::mutex m_mutex;
+    dxvk::condition_variable m_cond;
+    std::deque<Job> m_jobs;
+    std::unordered_set<XXH64_hash_t> m_queued;
+    bool m_stop = false;
+    dxvk::thread m_thread;
+  };
+
+  AssetDataManager::AssetDataManager()
+    : m_mipCache(std::make_unique<MipCache>()) {
   }
 
   AssetDataManager::~AssetDataManager() {
@@ -556,8 +888,18 @@ namespace dxvk {
           }
         }
       }
+
+      // Packages of a set are looked up in reverse alphabetical order
+      PackageSetDirectory directory;
+      for (auto it = packageSet.rbegin(); it != packageSet.rend(); ++it) {
+        for (const auto& entry : it->second->getDirectory()) {
+          directory.push_back(PackageSetEntry { entry.nameHash, it->second.ptr(), entry.assetIdx });
+        }
+      }
+      std::stable_sort(directory.begin(), directory.end());
+
       m_packageSets.emplace(std::piecewise_construct, std::forward_as_tuple(priority),
-        std::forward_as_tuple(searchPath, std::move(packageSet)));
+        std::forward_as_tuple(searchPath, std::move(packageSet), std::move(directory)));
     }
   }
 
@@ -582,6 +924,15 @@ namespace dxvk {
     if (isDDS && RtxOptions::usePartialDdsLoader()) {
       Rc<DdsTextureData> dds = new DdsTextureData;
       if (dds->load(filename)) {
+        if (RtxOptions::TextureManager::MipCache::enable() && MipCache::isCandidate(*dds)) {
+          const std::filesystem::path mippedPath = m_mipCache->lookup(filename, dds->info().lastWriteTime);
+          if (!mippedPath.empty()) {
+            Rc<DdsTextureData> mipped = new DdsTextureData;
+            if (mipped->load(mippedPath.string())) {
+              return mipped;
+            }
+          }
+        }
         return dds;
       }
     }
@@ -593,15 +944,16 @@ namespace dxvk {
 
         // The base path is shorter - we can try to use it
         if (basePath.length() < filename.length()) {
-          const std::string relativePath = filename.substr(basePath.length());
+          const std::string_view relativePath = std::string_view(filename).substr(basePath.length());
+          const XXH64_hash_t nameHash = AssetPackage::hashAssetName(relativePath);
 
-          auto& packages = std::get<1>(itBase->second);
+          const auto& directory = std::get<2>(itBase->second);
 
-          // Iterate package set in reverse alphabetical order
-          for (auto it = packages.rbegin(); it != packages.rend(); ++it) {
-            uint32_t assetIdx = it->second->findAsset(relativePath);
-            if (AssetPackage::kNoAssetIdx != assetIdx) {
-              return new PackagedAssetData(it->second, assetIdx);
+          // First match in the package lookup order wins
+          auto it = std::lower_bound(directory.begin(), directory.end(), PackageSetEntry { nameHash, nullptr, 0 });
+          for (; it != directory.end() && it->nameHash == nameHash; ++it) {
+            if (relativePath == it->package->getAssetName(it->assetIdx)) {
+              return new PackagedAssetData(it->package, it->assetIdx);
             }
           }
         }
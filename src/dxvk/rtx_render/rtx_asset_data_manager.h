@@ -23,6 +23,8 @@
 
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <vector>
 #include "../util/util_singleton.h"
 #include "rtx_asset_data.h"
 #include "rtx_asset_package.h"
@@ -35,8 +37,26 @@ namespace dxvk {
   // the access to actual data.
   class AssetDataManager : public Singleton<AssetDataManager> {
     using PackageSet = std::map<std::string, Rc<AssetPackage>>;
-    std::map<uint32_t, std::tuple<std::string, PackageSet>> m_packageSets;
+
+    // Name directory merged over all packages of a set, sorted by the name hash.
+    // Entries of the same hash are in the package lookup order.
+    struct PackageSetEntry {
+      XXH64_hash_t nameHash;
+      AssetPackage* package;
+      uint32_t assetIdx;
+
+      bool operator<(const PackageSetEntry& other) const {
+        return nameHash < other.nameHash;
+      }
+    };
+    using PackageSetDirectory = std::vector<PackageSetEntry>;
+
+    std::map<uint32_t, std::tuple<std::string, PackageSet, PackageSetDirectory>> m_packageSets;
     std::map<uint32_t, std::string> m_searchPaths;
+
+    // Builds full mip chains for loose mip-less textures in the background, see findAsset
+    class MipCache;
+    std::unique_ptr<MipCache> m_mipCache;
   public:
     AssetDataManager();
     ~AssetDataManager();
@@ -77,6 +97,11 @@ namespace dxvk {
      *   2. if file is not found on disk, method attempts a search in
      *      the search paths set that is populated using addSearchPath() method
      *
+     * With rtx.texturemanager.mipCache.enable, an uncompressed DDS file without
+     * mips is replaced by its copy with a full mip chain from the Remix cache
+     * directory. If there's no such copy yet, it is built in the background, and
+     * the original file is used until the next time the asset is looked up.
+     *
      * \param [in] filename Asset file name
      */
     Rc<AssetData> findAsset(const std::string& filename);
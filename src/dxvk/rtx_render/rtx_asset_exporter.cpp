@@ -22,6 +22,7 @@
 #include "rtx_asset_exporter.h"
 #include "rtx_types.h"
 #include "rtx_context.h"
+#include "rtx_thread_budget.h"
 #include "../../util/sync/sync_signal.h"
 #include "../../util/util_threadpool.h"
 #include "../dxvk_device.h"
@@ -30,6 +31,7 @@
 #include <gli/gli.hpp>
 #include <gli/convert.hpp>
 #include <gli/save.hpp>
+#include <algorithm>
 #include <string>
 #include <charconv>
 #include <functional>
@@ -69,6 +71,32 @@ namespace {
 
 namespace dxvk {
 
+  struct AssetExporter::ReadbackBatch {
+    struct Readback {
+      DxvkBufferSlice slice;
+      BufferCallback callback;
+    };
+    std::vector<Readback> readbacks;
+    std::vector<Rc<DxvkBuffer>> stagingBuffers;
+    Rc<DxvkBuffer> currentPage;
+    VkDeviceSize pageOffset = 0;
+    std::atomic<size_t> numTasksLeft = 0;
+  };
+
+  struct AssetExporter::ImageExport {
+    std::string filename;
+    gli::format outFormat;
+    gli::swizzles swizzle;
+    DxvkImageCreateInfo dstDesc;
+    // One image per mip level, the temps are empty when the image is copied rather than blitted
+    std::vector<Rc<DxvkImage>> blitTemps;
+    std::vector<Rc<DxvkImage>> blitDests;
+    uint64_t syncValue = 0;
+  };
+
+  AssetExporter::~AssetExporter() {
+  }
+
   void AssetExporter::waitForAllExportsToComplete(const float numSecsToWait) {
 
     if (m_numExportsInFlight > 0) {
@@ -77,6 +105,8 @@ namespace dxvk {
       auto startTime = std::chrono::system_clock::now();
       while (m_numExportsInFlight > 0 &&
              std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - startTime).count() < numSecsToWait) {
+        // No more frames may come along to check on the image exports
+        dispatchCompletedImageExports();
         Sleep(1);
       }
 
@@ -87,11 +117,19 @@ namespace dxvk {
 
   std::unique_ptr<AssetExporter::ThreadPool>& AssetExporter::getExporterThread() {
     if (m_exporterThread == nullptr) {
-      m_exporterThread = std::make_unique<ThreadPool>(1, "rtx-asset-exporter");
+      m_exporterThread = std::make_unique<ThreadPool>(1, "rtx-asset-exporter", RtxThreadBudget::getPriority(ThreadClass::Background));
     }
     return m_exporterThread;
   }
 
+  AssetExporter::CallbackThreadPool& AssetExporter::getCallbackThreads() {
+    std::call_once(m_callbackThreadsOnce, [this] {
+      m_callbackThreads = std::make_unique<CallbackThreadPool>(RtxThreadBudget::getThreadCount(ThreadClass::Background, kNumCallbackThreads), "rtx-asset-export-callback",
+                                                               RtxThreadBudget::getPriority(ThreadClass::Background));
+    });
+    return *m_callbackThreads;
+  }
+
   void AssetExporter::exportImage(Rc<DxvkContext> ctx, const std::string& filename, Rc<DxvkImage> image, bool thumbnail/* = false*/) {
     ScopedCpuProfileZone();
     // NOTE: Should use a mutex here...
@@ -147,8 +185,17 @@ namespace dxvk {
 
     const uint32_t numMipLevels = dstDesc.mipLevels;
 
-    Rc<DxvkImage>* pBlitTemps = useBlit ? new Rc<DxvkImage>[numMipLevels] : nullptr;
-    Rc<DxvkImage>* pBlitDests = new Rc<DxvkImage>[numMipLevels];
+    auto pExport = std::make_shared<ImageExport>();
+    pExport->filename = filename;
+    pExport->outFormat = outFormat;
+    pExport->dstDesc = dstDesc;
+    pExport->swizzle = swizzle;
+    if (useBlit) {
+      pExport->blitTemps.resize(numMipLevels);
+    }
+    pExport->blitDests.resize(numMipLevels);
+    Rc<DxvkImage>* pBlitTemps = pExport->blitTemps.data();
+    Rc<DxvkImage>* pBlitDests = pExport->blitDests.data();
 
     // Push a copy operation to the GPU; get that GPU data in CPU addressable space!
     for (uint32_t level = 0; level < numMipLevels; ++level) {
@@ -171,7 +218,7 @@ namespace dxvk {
         desc.extent = dstExtent;
 
         // Temp image to blit into (pBlitDests is linear, so we can only copy into)
-        pBlitTemps[level] = ctx->getDevice()->createImage(desc, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXMaterialTexture, "exportImage blit temp");
+        pBlitTemps[level] = acquireReadbackImage(ctx, desc, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "exportImage blit temp");
       }
 
       {
@@ -188,7 +235,7 @@ namespace dxvk {
         desc.extent = dstExtent;
 
         // Make the image where we'll copy the GPU resource to CPU accessible mem
-        pBlitDests[level] = ctx->getDevice()->createImage(desc, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DxvkMemoryStats::Category::RTXMaterialTexture, "exportimage blit dest");
+        pBlitDests[level] = acquireReadbackImage(ctx, desc, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, "exportimage blit dest");
       }
 
       VkOffset3D srcOffset = VkOffset3D { 0,0,0 };
@@ -237,61 +284,110 @@ namespace dxvk {
       VK_ACCESS_HOST_READ_BIT);
 
     // Sync point, before writing to disk, we must wait on GPU
-    const uint64_t syncValue = ++m_signalValue;
-    ctx->signal(m_readbackSignal, syncValue);
+    pExport->syncValue = ++m_signalValue;
+    ctx->signal(m_readbackSignal, pExport->syncValue);
 
-    // Spawn a thread so we dont sync with the GPU here...(remember, GPU runs async with CPU!).  
-    Future<void> result = getExporterThread()->Schedule([this, device = ctx->getDevice(), pBlitDests, pBlitTemps, syncValue, filename, outFormat, dstDesc, swizzle] {
-      ScopedCpuProfileZoneN("Export Image Finalize");
-      // Stall until the GPU has completed its copy to system memory (GPU->CPU)
-      this->m_readbackSignal->wait(syncValue);
-    
-      // Push texture header to the GLI container
-      const gli::extent3d outExtent = { dstDesc.extent.width, dstDesc.extent.height, 1 };
-      gli::texture2d exportTex(outFormat, outExtent, dstDesc.mipLevels, swizzle);
+    // Don't sync with the GPU here (remember, GPU runs async with CPU!), the fence is checked in flushReadbacks
+    std::lock_guard lock(m_pendingImageExportsMutex);
+    m_pendingImageExports.push_back(std::move(pExport));
+  }
 
-      const DxvkFormatInfo* formatInfo = imageFormatInfo(gliFormatToVk(exportTex.format()));
+  Rc<DxvkImage> AssetExporter::acquireReadbackImage(Rc<DxvkContext> ctx, const DxvkImageCreateInfo& desc, VkMemoryPropertyFlags memFlags, const char* name) {
+    {
+      std::lock_guard lock(m_freeReadbackImagesMutex);
+      for (auto it = m_freeReadbackImages.begin(); it != m_freeReadbackImages.end(); ++it) {
+        const DxvkImageCreateInfo& info = (*it)->info();
+        if (info.format == desc.format && info.tiling == desc.tiling && info.usage == desc.usage &&
+            info.extent.width == desc.extent.width && info.extent.height == desc.extent.height && info.extent.depth == desc.extent.depth) {
+          Rc<DxvkImage> image = std::move(*it);
+          m_freeReadbackImages.erase(it);
+          return image;
+        }
+      }
+    }
+    return ctx->getDevice()->createImage(desc, memFlags, DxvkMemoryStats::Category::RTXMaterialTexture, name);
+  }
 
-      for (uint32_t level = 0; level < exportTex.levels(); ++level) {
-        const Rc<DxvkImage>& image = pBlitDests[level];
+  void AssetExporter::dispatchCompletedImageExports() {
+    std::vector<std::shared_ptr<ImageExport>> completedExports;
+    {
+      std::lock_guard lock(m_pendingImageExportsMutex);
+      if (m_pendingImageExports.empty()) {
+        return;
+      }
 
-        // Calculate the Subresource Layout for the Image
+      const uint64_t signaledValue = m_readbackSignal->value();
+      auto firstPending = std::stable_partition(m_pendingImageExports.begin(), m_pendingImageExports.end(),
+                                                [signaledValue](const std::shared_ptr<ImageExport>& pExport) { return pExport->syncValue <= signaledValue; });
+      completedExports.assign(std::make_move_iterator(m_pendingImageExports.begin()), std::make_move_iterator(firstPending));
+      m_pendingImageExports.erase(m_pendingImageExports.begin(), firstPending);
+    }
 
-        VkImageSubresource subresource;
-        subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        subresource.mipLevel = 0; // pBlitDests is an array implicitly separated by mip levels, indexing into it selects the level
-        subresource.arrayLayer = 0;
-        const VkSubresourceLayout subresourceLayout = image->querySubresourceLayout(subresource);
+    for (std::shared_ptr<ImageExport>& pExport : completedExports) {
+      auto task = [this, pExport] {
+        encodeImageExport(*pExport);
+      };
+      if (!getCallbackThreads().Schedule(task).valid()) {
+        task();
+      }
+    }
+  }
 
-        // Get destination and source pointers for writing/reading
+  void AssetExporter::encodeImageExport(ImageExport& imageExport) {
+    ScopedCpuProfileZoneN("Export Image Finalize");
+    const DxvkImageCreateInfo& dstDesc = imageExport.dstDesc;
 
-        void* pDst = (void*)exportTex.data(exportTex.base_layer(), exportTex.base_face(), level);
-        const void* pSrc = image->mapPtr(0);
+    // Push texture header to the GLI container
+    const gli::extent3d outExtent = { dstDesc.extent.width, dstDesc.extent.height, 1 };
+    gli::texture2d exportTex(imageExport.outFormat, outExtent, dstDesc.mipLevels, imageExport.swizzle);
 
-        const VkExtent3D levelExtent = gliExtentToVk(exportTex.extent(level));
-        const VkExtent3D elementCount = util::computeBlockCount(levelExtent, formatInfo->blockSize);
-        const uint32_t rowPitch = elementCount.width * formatInfo->elementSize;
-        const uint32_t layerPitch = rowPitch * elementCount.height;
+    const DxvkFormatInfo* formatInfo = imageFormatInfo(gliFormatToVk(exportTex.format()));
 
-        util::packImageData(pDst, pSrc, subresourceLayout.rowPitch, subresourceLayout.arrayPitch,
-                            rowPitch, layerPitch, VK_IMAGE_TYPE_2D, levelExtent, 1, formatInfo,
-                            subresource.aspectMask);
-      }
+    for (uint32_t level = 0; level < exportTex.levels(); ++level) {
+      const Rc<DxvkImage>& image = imageExport.blitDests[level];
 
-      // Write our file, converting its format first if nessecary
-      const bool success = gli::save(exportTex, filename);
-      if (!success) {
-        Logger::err(str::format("RTX: Failed to write texture \"", filename, "\""));
-      }
+      // Calculate the Subresource Layout for the Image
 
-      delete[] pBlitTemps;
-      delete[] pBlitDests;
-      m_numExportsInFlight--;
-    });
+      VkImageSubresource subresource;
+      subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      subresource.mipLevel = 0; // blitDests is implicitly separated by mip levels, indexing into it selects the level
+      subresource.arrayLayer = 0;
+      const VkSubresourceLayout subresourceLayout = image->querySubresourceLayout(subresource);
 
-    if (!result.valid()) {
-      Logger::err(str::format("RTX: Failed to write texture \"", filename, "\".  Coding error, kMaxConcurrentExports, may be too low (currently: ", kMaxConcurrentExports, ")."));
+      // Get destination and source pointers for writing/reading
+
+      void* pDst = (void*)exportTex.data(exportTex.base_layer(), exportTex.base_face(), level);
+      const void* pSrc = image->mapPtr(0);
+
+      const VkExtent3D levelExtent = gliExtentToVk(exportTex.extent(level));
+      const VkExtent3D elementCount = util::computeBlockCount(levelExtent, formatInfo->blockSize);
+      const uint32_t rowPitch = elementCount.width * formatInfo->elementSize;
+      const uint32_t layerPitch = rowPitch * elementCount.height;
+
+      util::packImageData(pDst, pSrc, subresourceLayout.rowPitch, subresourceLayout.arrayPitch,
+                          rowPitch, layerPitch, VK_IMAGE_TYPE_2D, levelExtent, 1, formatInfo,
+                          subresource.aspectMask);
+    }
+
+    // Write our file, converting its format first if nessecary
+    const bool success = gli::save(exportTex, imageExport.filename);
+    if (!success) {
+      Logger::err(str::format("RTX: Failed to write texture \"", imageExport.filename, "\""));
     }
+
+    {
+      std::lock_guard lock(m_freeReadbackImagesMutex);
+      for (std::vector<Rc<DxvkImage>>* pImages : { &imageExport.blitTemps, &imageExport.blitDests }) {
+        for (Rc<DxvkImage>& image : *pImages) {
+          if (m_freeReadbackImages.size() < kMaxFreeReadbackImages) {
+            m_freeReadbackImages.push_back(std::move(image));
+          }
+        }
+      }
+    }
+    imageExport.blitTemps.clear();
+    imageExport.blitDests.clear();
+    m_numExportsInFlight--;
   }
 
   void AssetExporter::exportBuffer(Rc<DxvkContext> ctx, const DxvkBufferSlice& buffer, BufferCallback bufferCallback) {
@@ -306,20 +402,61 @@ namespace dxvk {
 
     m_numExportsInFlight++;
 
-    // We want to retain most of the src image state
-    // NOTE: Some image formats arent well supported by DDS tools, like B8G8R8A8...  So we might want to blit rather than copy for such formats.
-    DxvkBufferCreateInfo desc = buffer.bufferInfo();
+    // Copy into the pending batch, waiting on the GPU is left to flushReadbacks()
+    const DxvkBufferSlice bufferDest = allocReadback(ctx, buffer.length());
+    ctx->copyBuffer(bufferDest.buffer(), bufferDest.offset(), buffer.buffer(), buffer.offset(), buffer.length());
+
+    m_pendingReadbacks->readbacks.push_back({ bufferDest, std::move(bufferCallback) });
+  }
 
-    // Modify the state we need for reading on the CPU
-    desc.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    desc.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    desc.access = VK_ACCESS_TRANSFER_WRITE_BIT;
-    desc.size = buffer.length();
+  DxvkBufferSlice AssetExporter::allocReadback(Rc<DxvkContext> ctx, VkDeviceSize size) {
+    if (m_pendingReadbacks == nullptr) {
+      m_pendingReadbacks = std::make_unique<ReadbackBatch>();
+    }
+    ReadbackBatch& batch = *m_pendingReadbacks;
+
+    auto createBuffer = [&ctx](VkDeviceSize size) {
+      DxvkBufferCreateInfo desc;
+      desc.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+      desc.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+      desc.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+      desc.size = size;
+      return ctx->getDevice()->createBuffer(desc, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, DxvkMemoryStats::Category::RTXBuffer, "Remix Data Export Buffer");
+    };
 
-    // Make the image where we'll copy the GPU resource to CPU accessible mem
-    Rc<DxvkBuffer> bufferDest = ctx->getDevice()->createBuffer(desc, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, DxvkMemoryStats::Category::RTXBuffer, "Remix Data Export Buffer");
+    if (size > kReadbackPageSize) {
+      batch.stagingBuffers.push_back(createBuffer(size));
+      return DxvkBufferSlice(batch.stagingBuffers.back(), 0, size);
+    }
 
-    ctx->copyBuffer(bufferDest, VkDeviceSize { 0 }, buffer.buffer(), buffer.offset(), desc.size);
+    VkDeviceSize offset = align(batch.pageOffset, kReadbackAlignment);
+    if (batch.currentPage == nullptr || offset + size > kReadbackPageSize) {
+      {
+        std::lock_guard lock(m_freeReadbackPagesMutex);
+        if (!m_freeReadbackPages.empty()) {
+          batch.currentPage = std::move(m_freeReadbackPages.back());
+          m_freeReadbackPages.pop_back();
+        } else {
+          batch.currentPage = nullptr;
+        }
+      }
+      if (batch.currentPage == nullptr) {
+        batch.currentPage = createBuffer(kReadbackPageSize);
+      }
+      batch.stagingBuffers.push_back(batch.currentPage);
+      offset = 0;
+    }
+    batch.pageOffset = offset + size;
+    return DxvkBufferSlice(batch.currentPage, offset, size);
+  }
+
+  void AssetExporter::flushReadbacks(Rc<DxvkContext> ctx) {
+    dispatchCompletedImageExports();
+
+    if (m_pendingReadbacks == nullptr || m_pendingReadbacks->readbacks.empty()) {
+      return;
+    }
+    ScopedCpuProfileZone();
 
     ctx->emitMemoryBarrier(0,
       VK_PIPELINE_STAGE_TRANSFER_BIT,
@@ -327,21 +464,62 @@ namespace dxvk {
       VK_PIPELINE_STAGE_HOST_BIT,
       VK_ACCESS_HOST_READ_BIT);
 
-    // Sync point, before writing to disk, we must wait on GPU
+    // Sync point for the whole batch, before reading the copies we must wait on GPU
     const uint64_t syncValue = ++m_signalValue;
     ctx->signal(m_readbackSignal, syncValue);
 
-    Future<void> result = getExporterThread()->Schedule([this, cDestBuffer = bufferDest, syncValue, bufferCallback] {
+    std::shared_ptr<ReadbackBatch> pBatch = std::move(m_pendingReadbacks);
+    const size_t numReadbacks = pBatch->readbacks.size();
+    Future<void> result = getExporterThread()->Schedule([this, pBatch, syncValue] {
       ScopedCpuProfileZoneN("Export Buffer Finalize");
       // Stall until the GPU has completed its copy to system memory (GPU->CPU)
       this->m_readbackSignal->wait(syncValue);
-      bufferCallback(cDestBuffer);
-      m_numExportsInFlight--;
+      dispatchReadbackCallbacks(pBatch);
     });
-    
+
     if (!result.valid()) {
-      Logger::err(str::format("RTX: Failed to dump buffer.  Coding error, kMaxConcurrentExports, may be too low (currently: ", kMaxConcurrentExports, ")."));
+      Logger::err(str::format("RTX: Failed to dump ", numReadbacks, " buffers.  Coding error, kMaxConcurrentExports, may be too low (currently: ", kMaxConcurrentExports, ")."));
+    }
+  }
+
+  void AssetExporter::dispatchReadbackCallbacks(const std::shared_ptr<ReadbackBatch>& pBatch) {
+    CallbackThreadPool& callbackThreads = getCallbackThreads();
+
+    const size_t numReadbacks = pBatch->readbacks.size();
+    const size_t numTasks = std::min<size_t>(kNumCallbackThreads, numReadbacks);
+    pBatch->numTasksLeft = numTasks;
+    auto makeTask = [this, &pBatch](const size_t begin, const size_t end) {
+      return [this, pBatch, begin, end] {
+        for (size_t i = begin; i < end; ++i) {
+          ReadbackBatch::Readback& readback = pBatch->readbacks[i];
+          readback.callback(readback.slice);
+          // Drop whatever the callback holds on to right away
+          readback.callback = nullptr;
+          m_numExportsInFlight--;
+        }
+        if (--pBatch->numTasksLeft == 0) {
+          recycleReadbackPages(*pBatch);
+        }
+      };
+    };
+    for (size_t task = 0; task < numTasks; ++task) {
+      const size_t begin = numReadbacks * task / numTasks;
+      const size_t end = numReadbacks * (task + 1) / numTasks;
+      if (!callbackThreads.Schedule(makeTask(begin, end)).valid()) {
+        makeTask(begin, end)();
+      }
+    }
+  }
+
+  void AssetExporter::recycleReadbackPages(ReadbackBatch& batch) {
+    std::lock_guard lock(m_freeReadbackPagesMutex);
+    for (Rc<DxvkBuffer>& buffer : batch.stagingBuffers) {
+      if (buffer->info().size == kReadbackPageSize && m_freeReadbackPages.size() < kMaxFreeReadbackPages) {
+        m_freeReadbackPages.push_back(std::move(buffer));
+      }
     }
+    batch.stagingBuffers.clear();
+    batch.currentPage = nullptr;
   }
 
   void AssetExporter::generateSceneThumbnail(Rc<DxvkContext> ctx, const std::string& dir, const std::string& filename) {
@@ -26,6 +26,7 @@
 #include <atomic>
 #include <future>
 #include <mutex>
+#include <vector>
 #include "../util/util_env.h"
 #include "rtx_constants.h"
 
@@ -41,7 +42,10 @@ namespace dxvk {
 
   class AssetExporter {
   public:
-    using BufferCallback = std::function<void(Rc<DxvkBuffer>)>;
+    ~AssetExporter();
+
+    // Receives the CPU visible copy of the exported slice, which is only valid for the duration of the call
+    using BufferCallback = std::function<void(const DxvkBufferSlice&)>;
 
     void waitForAllExportsToComplete(const float numSecsToWait = 10);
 
@@ -50,10 +54,16 @@ namespace dxvk {
       exportImage(ctx, str::format(dir, filename), image);
     }
 
+    // Buffer copies are batched, the callback runs only after the next flushReadbacks()
     void copyBufferFromGPU(Rc<DxvkContext> ctx, const DxvkBufferSlice& buffer, BufferCallback bufferCallback) {
       exportBuffer(ctx, buffer, bufferCallback);
     }
 
+    // Waits on all buffer copies issued since the last flush with a single fence signal, and
+    // runs their callbacks on the callback threads once the GPU is done. Also hands the image
+    // exports the GPU is done with to the callback threads for encoding. Call once per frame.
+    void flushReadbacks(Rc<DxvkContext> ctx);
+
     void generateSceneThumbnail(Rc<DxvkContext> ctx, const std::string& dir, const std::string& filename);
 
     void bakeSkyProbe(Rc<DxvkContext> ctx, const std::string& dir, const std::string& filename);
@@ -72,10 +82,44 @@ namespace dxvk {
     using ThreadPool = WorkerThreadPool<kMaxConcurrentExports, false, false>;
     std::unique_ptr<ThreadPool> m_exporterThread;
 
+    // Buffer readbacks are sub-allocated from shared staging pages, large ones get a buffer of their own
+    inline static const VkDeviceSize kReadbackPageSize = 4 << 20; // 4 MiB
+    inline static const VkDeviceSize kReadbackAlignment = 16;
+    inline static const size_t kMaxFreeReadbackPages = 8;
+    inline static const uint8_t kNumCallbackThreads = 4;
+    struct ReadbackBatch;
+    // Only touched on the thread issuing the copies
+    std::unique_ptr<ReadbackBatch> m_pendingReadbacks;
+    dxvk::mutex m_freeReadbackPagesMutex;
+    std::vector<Rc<DxvkBuffer>> m_freeReadbackPages;
+    // Callbacks of a batch are split up into one task per thread, completed image exports are encoded there too
+    using CallbackThreadPool = WorkerThreadPool<16, true, false>;
+    std::unique_ptr<CallbackThreadPool> m_callbackThreads;
+    std::once_flag m_callbackThreadsOnce;
+
+    // Image exports wait for their copies without blocking a thread, the fence is only polled
+    // once per frame and the encoding happens on the callback threads. The CPU visible images
+    // are recycled so that capturing every frame does not allocate every frame.
+    inline static const size_t kMaxFreeReadbackImages = 16;
+    struct ImageExport;
+    dxvk::mutex m_pendingImageExportsMutex;
+    std::vector<std::shared_ptr<ImageExport>> m_pendingImageExports;
+    dxvk::mutex m_freeReadbackImagesMutex;
+    std::vector<Rc<DxvkImage>> m_freeReadbackImages;
+
     void exportImage(Rc<DxvkContext> ctx, const std::string& filename, Rc<DxvkImage> image, bool thumbnail = false);
 
     void exportBuffer(Rc<DxvkContext> ctx, const DxvkBufferSlice& buffer, BufferCallback bufferCallback);
 
     std::unique_ptr<ThreadPool>& getExporterThread();
+    CallbackThreadPool& getCallbackThreads();
+
+    DxvkBufferSlice allocReadback(Rc<DxvkContext> ctx, VkDeviceSize size);
+    void dispatchReadbackCallbacks(const std::shared_ptr<ReadbackBatch>& pBatch);
+    void recycleReadbackPages(ReadbackBatch& batch);
+
+    Rc<DxvkImage> acquireReadbackImage(Rc<DxvkContext> ctx, const DxvkImageCreateInfo& desc, VkMemoryPropertyFlags memFlags, const char* name);
+    void dispatchCompletedImageExports();
+    void encodeImageExport(ImageExport& imageExport);
   };
 } // namespace dxvk
\ No newline at end of file
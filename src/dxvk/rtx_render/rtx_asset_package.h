@@ -24,12 +24,17 @@
 #include <stddef.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "../../util/rc/util_rc.h"
 #include "../../util/log/log.h"
 #include "../../util/util_string.h"
+#include "../../util/thread.h"
+#include "../../util/xxHash/xxhash.h"
 
 #ifdef WIN32
 #define fseek64 _fseeki64
@@ -100,12 +105,27 @@ namespace dxvk {
 
     static_assert(sizeof(BlobDesc) == 16, "Blob description structure size overrun!");
 
+    // An entry of the name directory, which is sorted by the name hash
+    struct DirectoryEntry {
+      XXH64_hash_t nameHash;
+      uint32_t assetIdx;
+
+      bool operator<(const DirectoryEntry& other) const {
+        return nameHash < other.nameHash;
+      }
+    };
+
+    static XXH64_hash_t hashAssetName(std::string_view name) {
+      return XXH3_64bits(name.data(), name.size());
+    }
+
     AssetPackage() = default;
     explicit AssetPackage(const std::string& filename)
       : m_filename { filename } { }
 
     ~AssetPackage() {
       closeFileHandle();
+      unmapFile();
     }
 
     bool initialize(const char* filename = nullptr) {
@@ -165,21 +185,40 @@ namespace dxvk {
         size_t nameTableSize = ftell64(m_handle) - nameTableOffset;
         fseek64(m_handle, nameTableOffset, SEEK_SET);
 
-        std::unique_ptr<char[]> names(new char[nameTableSize]);
+        m_names.reset(new char[nameTableSize + 1]);
 
-        if (1 != fread(names.get(), nameTableSize, 1, m_handle)) {
+        if (1 != fread(m_names.get(), nameTableSize, 1, m_handle)) {
           Logger::err(str::format("Malformed asset package ", m_filename));
           return false;
         }
+        // Guard against a name table that is not null-terminated
+        m_names[nameTableSize] = '\0';
 
         closeFileHandle();
 
-        auto namesPtr = names.get();
+        // Build a hashed directory of the names, so that a lookup is a binary search over
+        // the hashes and a single string compare, with no per-name allocations
+        m_nameOffsets.resize(m_assetCount);
+        m_directory.resize(m_assetCount);
+
+        size_t nameOffset = 0;
         for (uint32_t n = 0; n < m_assetCount; n++) {
-          m_nameHash.emplace(namesPtr, n);
-          namesPtr += strlen(namesPtr) + 1;
+          if (nameOffset >= nameTableSize) {
+            Logger::err(str::format("Malformed asset package ", m_filename));
+            return false;
+          }
+          const char* name = m_names.get() + nameOffset;
+          const size_t nameLength = strlen(name);
+
+          m_nameOffsets[n] = uint32_t(nameOffset);
+          m_directory[n] = DirectoryEntry { hashAssetName(std::string_view(name, nameLength)), n };
+
+          nameOffset += nameLength + 1;
         }
 
+        // Stable, so that the first of the duplicate names in the package is still found first
+        std::stable_sort(m_directory.begin(), m_directory.end());
+
         return true;
       }
 
@@ -231,6 +270,9 @@ namespace dxvk {
         if (outSize < blobDesc->size)
           return 0;
 
+        // Blobs of a package may be read by several texture loader threads at once
+        std::lock_guard<dxvk::mutex> lock(m_handleMutex);
+
         if (!openFileHandle())
           return 0;
 
@@ -241,7 +283,18 @@ namespace dxvk {
       return 0;
     }
 
+    // Returns a pointer to the blob in a read-only mapping of the package, so that the data can be
+    // copied out without a read into an intermediate buffer. The package is mapped once, on first use.
+    // Returns nullptr if the package can't be mapped, readDataBlob() has to be used then.
+    const void* mapDataBlob(uint32_t idx);
+
+    // Hints the OS to page in a blob of the mapping ahead of the access, non-blocking.
+    // Does nothing if the package is not mapped.
+    void prefetchDataBlob(uint32_t idx);
+
     size_t getDataSize() {
+      std::lock_guard<dxvk::mutex> lock(m_handleMutex);
+
       if (!openFileHandle())
         return 0;
 
@@ -256,11 +309,28 @@ namespace dxvk {
       return 0;
     }
 
-    uint32_t findAsset(const std::string& filename) const {
-      auto it = m_nameHash.find(filename);
+    const char* getAssetName(uint32_t idx) const {
+      if (idx >= m_nameOffsets.size())
+        return nullptr;
+
+      return m_names.get() + m_nameOffsets[idx];
+    }
 
-      if (it != m_nameHash.end()) {
-        return it->second;
+    const std::vector<DirectoryEntry>& getDirectory() const {
+      return m_directory;
+    }
+
+    uint32_t findAsset(std::string_view filename) const {
+      return findAsset(hashAssetName(filename), filename);
+    }
+
+    uint32_t findAsset(XXH64_hash_t nameHash, std::string_view filename) const {
+      auto it = std::lower_bound(m_directory.begin(), m_directory.end(), DirectoryEntry { nameHash, 0 });
+
+      for (; it != m_directory.end() && it->nameHash == nameHash; ++it) {
+        if (filename == getAssetName(it->assetIdx)) {
+          return it->assetIdx;
+        }
       }
 
       return kNoAssetIdx;
@@ -271,14 +341,29 @@ namespace dxvk {
     }
 
   private:
+    bool mapFile();
+    void unmapFile();
+
     std::string m_filename;
     FILE* m_handle = nullptr;
+    dxvk::mutex m_handleMutex;
+
+    // Read-only mapping of the whole package, guarded by m_handleMutex
+    void* m_mappedFile = nullptr;
+    void* m_mapping = nullptr;
+    const uint8_t* m_mappedBase = nullptr;
+    uint64_t m_mappedSize = 0;
+    bool m_mappingFailed = false;
 
     uint32_t m_assetCount = 0;
     uint32_t m_blobCount = 0;
 
     std::unique_ptr<uint8_t[]> m_metadata;
-    std::unordered_map<std::string, uint32_t> m_nameHash;
+
+    // Null-separated asset names, in the asset order
+    std::unique_ptr<char[]> m_names;
+    std::vector<uint32_t> m_nameOffsets;
+    std::vector<DirectoryEntry> m_directory;
   };
 
 } // namespace dxvk
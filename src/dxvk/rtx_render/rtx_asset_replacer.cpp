@@ -45,6 +45,10 @@ std::vector<AssetReplacement>* AssetReplacer::getReplacementsForMesh(XXH64_hash_
     if (auto replacement = mod->replacements().get<AssetReplacement::eMesh>(hash)) {
       return replacement;
     }
+    // A mod with a deferred replacement for this hash still takes priority over the ones after it
+    if (mod->requestMeshReplacement(hash)) {
+      return nullptr;
+    }
   }
 
   return nullptr;
@@ -80,6 +84,7 @@ MaterialData* AssetReplacer::getReplacementMaterial(XXH64_hash_t hash) {
 void AssetReplacer::initialize(const Rc<DxvkContext>& context) {
   for (auto& mod : m_modManager.mods()) {
     mod->load(context);
+    mod->replacements().publish();
   }
   updateSecretReplacements();
 }
@@ -90,6 +95,8 @@ bool AssetReplacer::checkForChanges(const Rc<DxvkContext>& context) {
   bool changed = false;
   for (auto& mod : m_modManager.mods()) {
     changed |= mod->checkForChanges(context);
+    // End of the frame, no replacement lookups are in flight
+    mod->replacements().publish();
   }
   if (changed) {
     updateSecretReplacements();
@@ -97,6 +104,12 @@ bool AssetReplacer::checkForChanges(const Rc<DxvkContext>& context) {
   return changed;
 }
 
+void AssetReplacer::onDestroy() {
+  for (auto& mod : m_modManager.mods()) {
+    mod->onDestroy();
+  }
+}
+
 bool AssetReplacer::areAllReplacementsLoaded() const {
   for (auto& mod : m_modManager.mods()) {
     if (mod->state().progressState != Mod::ProgressState::Loaded) {
@@ -188,6 +201,15 @@ void AssetReplacer::destroyExternalMaterial(remixapi_MaterialHandle handle) {
   m_extMaterials.erase(handle);
 }
 
+const Rc<ManagedTexture>* AssetReplacer::findExternalMaterialTexture(const std::string& path) const {
+  auto found = m_extMaterialTextures.find(path);
+  return found != m_extMaterialTextures.end() ? &found->second : nullptr;
+}
+
+void AssetReplacer::addExternalMaterialTexture(const std::string& path, const Rc<ManagedTexture>& texture) {
+  m_extMaterialTextures.emplace(path, texture);
+}
+
 void AssetReplacer::registerExternalMesh(remixapi_MeshHandle handle, std::vector<RasterGeometry>&& submeshes) {
   if (m_extMeshes.count(handle) > 0) {
     Logger::info("Ignoring repeated mesh registration (handle=" + tostr(handle) + ") ");
@@ -197,17 +219,56 @@ void AssetReplacer::registerExternalMesh(remixapi_MeshHandle handle, std::vector
   m_extMeshes.emplace(handle, std::move(submeshes));
 }
 
-const std::vector<RasterGeometry>& AssetReplacer::accessExternalMesh(remixapi_MeshHandle handle) const {
+void AssetReplacer::registerExternalMeshAsync(remixapi_MeshHandle handle, std::shared_ptr<PendingExternalMesh>&& pending) {
+  if (m_extMeshes.count(handle) > 0 || m_pendingExtMeshes.count(handle) > 0) {
+    Logger::info("Ignoring repeated mesh registration (handle=" + tostr(handle) + ") ");
+    return;
+  }
+
+  m_pendingExtMeshes.emplace(handle, std::move(pending));
+}
+
+const std::vector<RasterGeometry>& AssetReplacer::accessExternalMesh(remixapi_MeshHandle handle) {
   auto found = m_extMeshes.find(handle);
   if (found == m_extMeshes.end()) {
     static const auto s_empty = std::vector<RasterGeometry> {};
-    return s_empty;
+    auto pending = m_pendingExtMeshes.find(handle);
+    if (pending == m_pendingExtMeshes.end() || !pending->second->ready.load(std::memory_order_acquire)) {
+      return s_empty;
+    }
+    found = m_extMeshes.emplace(handle, std::move(pending->second->surfaces)).first;
+    m_pendingExtMeshes.erase(pending);
   }
   return found->second;
 }
 
+void AssetReplacer::updateExternalMeshVertices(DxvkContext& ctx, remixapi_MeshHandle handle, uint32_t surfaceIndex,
+                                               uint64_t firstVertex, const std::vector<remixapi_HardcodedVertex>& vertices,
+                                               XXH64_hash_t positionHash, XXH64_hash_t texcoordHash) {
+  auto found = m_extMeshes.find(handle);
+  if (found == m_extMeshes.end() || surfaceIndex >= found->second.size()) {
+    Logger::warn("Ignoring vertex update of an unknown mesh surface (handle=" + tostr(handle) + ") ");
+    return;
+  }
+
+  RasterGeometry& surface = found->second[surfaceIndex];
+  if (firstVertex + vertices.size() > surface.vertexCount) {
+    Logger::warn("Ignoring vertex update outside of the mesh surface (handle=" + tostr(handle) + ") ");
+    return;
+  }
+
+  // Ordered with the GPU's use of the buffer, unlike a write through the mapping
+  const VkDeviceSize offset = surface.positionBuffer.offset() + firstVertex * sizeof(remixapi_HardcodedVertex);
+  ctx.writeToBuffer(surface.positionBuffer.buffer(), offset, vertices.size() * sizeof(remixapi_HardcodedVertex), vertices.data());
+
+  surface.hashes[HashComponents::VertexPosition] = positionHash;
+  surface.hashes[HashComponents::VertexTexcoord] = texcoordHash;
+  surface.hashes.precombine();
+}
+
 void AssetReplacer::destroyExternalMesh(remixapi_MeshHandle handle) {
   m_extMeshes.erase(handle);
+  m_pendingExtMeshes.erase(handle);
 }
 
 } // namespace dxvk
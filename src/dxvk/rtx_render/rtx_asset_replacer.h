@@ -41,8 +41,32 @@ namespace dxvk {
     }
   };
 
+  struct MeshReplacement;
+
+  struct MeshLod {
+    const MeshReplacement* geometry;
+    // The LOD is drawn once the projected size of the mesh drops below this fraction of the viewport height
+    float maxScreenSize;
+  };
+
   struct MeshReplacement {
     RasterGeometry data;
+    // Object space bounds of the whole mesh, used to select a LOD
+    AxisAlignedBoundingBox bounds;
+    // Lower detail versions of this mesh, ordered from highest to lowest detail (see remix_lod:meshes)
+    std::vector<MeshLod> lods;
+
+    // Returns the lowest detail LOD that is still meant to be drawn at the given projected screen size
+    const MeshReplacement& selectLod(const float screenSize) const {
+      const MeshReplacement* selected = this;
+      for (const MeshLod& lod : lods) {
+        if (screenSize >= lod.maxScreenSize) {
+          break;
+        }
+        selected = lod.geometry;
+      }
+      return *selected;
+    }
   };
 
   struct AssetReplacement {
@@ -84,21 +108,50 @@ namespace dxvk {
 
   typedef fast_unordered_cache<std::vector<SecretReplacement>> SecretReplacements;
 
+  // Surfaces of an API mesh that are built on the mesh upload thread, see remixapi_CreateMeshAsync.
+  // The surfaces may only be touched once ready is set.
+  struct PendingExternalMesh {
+    std::atomic_bool ready = false;
+    std::vector<RasterGeometry> surfaces;
+  };
+
   // Asset replacements storage class.
   // Contains and owns the replacements, material and geometry objects.
+  //
+  // Lookups don't take a lock: they go through an immutable snapshot of pointers to the stored
+  // objects, and the stored objects themselves never move. Writers (the mod loading threads) add
+  // objects to the storage under a lock, which leaves the snapshot stale until the next publish().
+  // A lookup that misses the snapshot while there are unpublished writes falls back to the locked
+  // storage, so writers always see their own writes. Replaced snapshots and removed objects are
+  // kept alive until the publish() after, which has to be called at a point no lookup is in flight
+  // (the end of the frame, see AssetReplacer::checkForChanges).
   class AssetReplacements {
   public:
+    AssetReplacements()
+      : m_publishedSnapshot(std::make_unique<Snapshot>())
+      , m_snapshot(m_publishedSnapshot.get()) {
+    }
+
+    AssetReplacements(const AssetReplacements&) = delete;
+    AssetReplacements& operator=(const AssetReplacements&) = delete;
+
     // Returns a pointer to replacements of type T for a given hash value,
     // or a nullptr if no replacements found.
     template<AssetReplacement::Type T>
     std::vector<AssetReplacement>* get(XXH64_hash_t hash) {
-      std::lock_guard<sync::Spinlock> lock(m_spinlock);
-      auto& map = T == AssetReplacement::eMesh ? m_meshReplacers : m_lightReplacers;
+      const Snapshot* snapshot = m_snapshot.load(std::memory_order_acquire);
+      const auto& map = T == AssetReplacement::eMesh ? snapshot->meshReplacers : snapshot->lightReplacers;
       auto it = map.find(hash);
       if (it != map.end()) {
-        return &it->second;
+        return it->second;
+      }
+
+      if (!m_hasUnpublishedWrites.load(std::memory_order_acquire)) {
+        return nullptr;
       }
-      return nullptr;
+
+      std::lock_guard<sync::Spinlock> lock(m_spinlock);
+      return findStored(T == AssetReplacement::eMesh ? m_meshReplacers : m_lightReplacers, hash);
     }
 
     // Stores replacements of type T for a hash value.
@@ -106,28 +159,47 @@ namespace dxvk {
     void set(XXH64_hash_t hash, std::vector<AssetReplacement>&& v) {
       std::lock_guard<sync::Spinlock> lock(m_spinlock);
       auto& map = T == AssetReplacement::eMesh ? m_meshReplacers : m_lightReplacers;
-      map.emplace(hash, std::move(v));
+      auto [it, inserted] = map.try_emplace(hash);
+      if (inserted) {
+        it->second = std::make_unique<std::vector<AssetReplacement>>(std::move(v));
+        m_hasUnpublishedWrites.store(true, std::memory_order_release);
+      }
+    }
+
+    // Removes the replacements of type T for a hash value.
+    template<AssetReplacement::Type T>
+    void remove(XXH64_hash_t hash) {
+      std::lock_guard<sync::Spinlock> lock(m_spinlock);
+      auto& map = T == AssetReplacement::eMesh ? m_meshReplacers : m_lightReplacers;
+      auto it = map.find(hash);
+      if (it != map.end()) {
+        // The published snapshot may still point to them
+        m_removedObjects.replacers.push_back(std::move(it->second));
+        map.erase(it);
+        m_hasUnpublishedWrites.store(true, std::memory_order_release);
+      }
     }
 
     // Returns a pointer to the stored object of type T for a given hash value.
     // Return false if no object was found.
     template<typename T>
     bool getObject(XXH64_hash_t hash, T*& obj) {
-      std::lock_guard<sync::Spinlock> lock(m_spinlock);
-      if constexpr (std::is_same_v<T, MaterialData>) {
-        auto it = m_materials.find(hash);
-        if (it != m_materials.end()) {
-          obj = &it->second;
+      if constexpr (std::is_same_v<T, MaterialData> || std::is_same_v<T, MeshReplacement>) {
+        const Snapshot* snapshot = m_snapshot.load(std::memory_order_acquire);
+        const auto& map = getMap<T>(*snapshot);
+        auto it = map.find(hash);
+        if (it != map.end()) {
+          obj = it->second;
           return true;
         }
-        return false;
-      } else if constexpr (std::is_same_v<T, MeshReplacement>) {
-        auto it = m_geometries.find(hash);
-        if (it != m_geometries.end()) {
-          obj = &it->second;
-          return true;
+
+        if (!m_hasUnpublishedWrites.load(std::memory_order_acquire)) {
+          return false;
         }
-        return false;
+
+        std::lock_guard<sync::Spinlock> lock(m_spinlock);
+        obj = findStored(getStorage<T>(), hash);
+        return obj != nullptr;
       }
       return false;
     }
@@ -136,10 +208,13 @@ namespace dxvk {
     template<typename T>
     T& storeObject(XXH64_hash_t hash, T&& obj) {
       std::lock_guard<sync::Spinlock> lock(m_spinlock);
-      if constexpr (std::is_same_v<T, MaterialData>) {
-        return m_materials.try_emplace(hash, std::move(obj)).first->second;
-      } else if constexpr (std::is_same_v<T, MeshReplacement>) {
-        return m_geometries.try_emplace(hash, std::move(obj)).first->second;
+      if constexpr (std::is_same_v<T, MaterialData> || std::is_same_v<T, MeshReplacement>) {
+        auto [it, inserted] = getStorage<T>().try_emplace(hash);
+        if (inserted) {
+          it->second = std::make_unique<T>(std::move(obj));
+          m_hasUnpublishedWrites.store(true, std::memory_order_release);
+        }
+        return *it->second;
       } else {
         return m_secretReplacements[hash].emplace_back(obj);
       }
@@ -149,18 +224,55 @@ namespace dxvk {
     template<typename T>
     void removeObject(XXH64_hash_t hash) {
       std::lock_guard<sync::Spinlock> lock(m_spinlock);
-      if constexpr (std::is_same_v<T, MaterialData>) {
-        m_materials.erase(hash);
-      } else if constexpr (std::is_same_v<T, MeshReplacement>) {
-        m_geometries.erase(hash);
+      if constexpr (std::is_same_v<T, MaterialData> || std::is_same_v<T, MeshReplacement>) {
+        auto& map = getStorage<T>();
+        auto it = map.find(hash);
+        if (it != map.end()) {
+          // The published snapshot may still point to it
+          getRetired<T>(m_removedObjects).push_back(std::move(it->second));
+          map.erase(it);
+          m_hasUnpublishedWrites.store(true, std::memory_order_release);
+        }
       } else {
         m_secretReplacements.erase(hash);
       }
     }
 
-    // Destroys all replacements and stored objects.
+    // Makes everything stored so far visible to lock-free lookups. Must not be called while
+    // lookups are in flight.
+    void publish() {
+      // Nothing can still be using what the previous publish retired
+      m_retired = Retired();
+
+      std::lock_guard<sync::Spinlock> lock(m_spinlock);
+      if (!m_hasUnpublishedWrites.load(std::memory_order_relaxed)) {
+        return;
+      }
+
+      auto snapshot = std::make_unique<Snapshot>();
+      copyStored(m_meshReplacers, snapshot->meshReplacers);
+      copyStored(m_lightReplacers, snapshot->lightReplacers);
+      copyStored(m_geometries, snapshot->geometries);
+      copyStored(m_materials, snapshot->materials);
+
+      m_snapshot.store(snapshot.get(), std::memory_order_release);
+      m_hasUnpublishedWrites.store(false, std::memory_order_release);
+
+      m_retired = std::move(m_removedObjects);
+      m_removedObjects = Retired();
+      m_retired.snapshot = std::move(m_publishedSnapshot);
+      m_publishedSnapshot = std::move(snapshot);
+    }
+
+    // Destroys all replacements and stored objects. Must not be called while lookups are in flight.
     void clear() {
       std::lock_guard<sync::Spinlock> lock(m_spinlock);
+      m_publishedSnapshot = std::make_unique<Snapshot>();
+      m_snapshot.store(m_publishedSnapshot.get(), std::memory_order_release);
+      m_hasUnpublishedWrites.store(false, std::memory_order_release);
+      m_retired = Retired();
+      m_removedObjects = Retired();
+
       m_meshReplacers.clear();
       m_lightReplacers.clear();
       m_materials.clear();
@@ -173,20 +285,87 @@ namespace dxvk {
     }
 
   private:
+    template<typename T>
+    using Storage = fast_unordered_cache<std::unique_ptr<T>>;
+
+    // Pointers to the stored objects, never modified once published
+    struct Snapshot {
+      fast_unordered_cache<std::vector<AssetReplacement>*> meshReplacers;
+      fast_unordered_cache<std::vector<AssetReplacement>*> lightReplacers;
+      fast_unordered_cache<MeshReplacement*> geometries;
+      fast_unordered_cache<MaterialData*> materials;
+    };
+
+    // Whatever lookups may still be using until the next publish
+    struct Retired {
+      std::unique_ptr<Snapshot> snapshot;
+      std::vector<std::unique_ptr<std::vector<AssetReplacement>>> replacers;
+      std::vector<std::unique_ptr<MeshReplacement>> geometries;
+      std::vector<std::unique_ptr<MaterialData>> materials;
+    };
+
+    template<typename T>
+    Storage<T>& getStorage() {
+      if constexpr (std::is_same_v<T, MaterialData>) {
+        return m_materials;
+      } else {
+        return m_geometries;
+      }
+    }
+
+    template<typename T>
+    static const fast_unordered_cache<T*>& getMap(const Snapshot& snapshot) {
+      if constexpr (std::is_same_v<T, MaterialData>) {
+        return snapshot.materials;
+      } else {
+        return snapshot.geometries;
+      }
+    }
+
+    template<typename T>
+    static std::vector<std::unique_ptr<T>>& getRetired(Retired& retired) {
+      if constexpr (std::is_same_v<T, MaterialData>) {
+        return retired.materials;
+      } else {
+        return retired.geometries;
+      }
+    }
+
+    template<typename T>
+    static T* findStored(const Storage<T>& storage, XXH64_hash_t hash) {
+      auto it = storage.find(hash);
+      return it != storage.end() ? it->second.get() : nullptr;
+    }
+
+    template<typename T>
+    static void copyStored(const Storage<T>& storage, fast_unordered_cache<T*>& pointers) {
+      pointers.reserve(storage.size());
+      for (const auto& [hash, obj] : storage) {
+        pointers.emplace(hash, obj.get());
+      }
+    }
+
     mutable sync::Spinlock m_spinlock;
 
     // Replacements ready to be fed to the renderer
-    fast_unordered_cache<std::vector<AssetReplacement>> m_meshReplacers;
-    fast_unordered_cache<std::vector<AssetReplacement>> m_lightReplacers;
+    Storage<std::vector<AssetReplacement>> m_meshReplacers;
+    Storage<std::vector<AssetReplacement>> m_lightReplacers;
 
     // Replacement geometry storage
-    fast_unordered_cache<MeshReplacement> m_geometries;
+    Storage<MeshReplacement> m_geometries;
 
     // Replacement material storage
-    fast_unordered_cache<MaterialData> m_materials;
+    Storage<MaterialData> m_materials;
 
     // Secret replacements if any
     SecretReplacements m_secretReplacements;
+
+    std::unique_ptr<Snapshot> m_publishedSnapshot;
+    std::atomic<const Snapshot*> m_snapshot;
+    std::atomic<bool> m_hasUnpublishedWrites { false };
+
+    Retired m_removedObjects;
+    Retired m_retired;
   };
 
   struct AssetReplacer {
@@ -200,6 +379,9 @@ namespace dxvk {
     // returns true if the state of replacements has changed.
     bool checkForChanges(const Rc<DxvkContext>& context);
 
+    // Stops the background work of all mods.
+    void onDestroy();
+
 
     // Returns true if all replacement mods are in the loaded state, false otherwise.
     bool areAllReplacementsLoaded() const;
@@ -226,9 +408,20 @@ namespace dxvk {
     void makeMaterialWithTexturePreload(DxvkContext& ctx, remixapi_MaterialHandle handle, MaterialData&& data);
     [[nodiscard]] const MaterialData* accessExternalMaterial(remixapi_MaterialHandle handle) const;
     void destroyExternalMaterial(remixapi_MaterialHandle handle);
+    // Textures of external materials by path, so that a path shared by several materials is resolved once.
+    // A null texture is a path that has no loadable asset. Returns nullptr if the path wasn't resolved yet.
+    [[nodiscard]] const Rc<ManagedTexture>* findExternalMaterialTexture(const std::string& path) const;
+    void addExternalMaterialTexture(const std::string& path, const Rc<ManagedTexture>& texture);
 
     void registerExternalMesh(remixapi_MeshHandle handle, std::vector<RasterGeometry>&& submeshes);
-    [[nodiscard]] const std::vector<RasterGeometry>& accessExternalMesh(remixapi_MeshHandle handle) const;
+    // The mesh is drawn with no surfaces until the pending surfaces are ready
+    void registerExternalMeshAsync(remixapi_MeshHandle handle, std::shared_ptr<PendingExternalMesh>&& pending);
+    [[nodiscard]] const std::vector<RasterGeometry>& accessExternalMesh(remixapi_MeshHandle handle);
+    // Overwrites a range of a surface's vertices in place. The new hashes make the next draw of the
+    // surface refit its BLAS, as the index data and so the topology stay the same.
+    void updateExternalMeshVertices(DxvkContext& ctx, remixapi_MeshHandle handle, uint32_t surfaceIndex,
+                                    uint64_t firstVertex, const std::vector<remixapi_HardcodedVertex>& vertices,
+                                    XXH64_hash_t positionHash, XXH64_hash_t texcoordHash);
     void destroyExternalMesh(remixapi_MeshHandle handle);
 
   private:
@@ -248,7 +441,9 @@ namespace dxvk {
     ModManager m_modManager;
 
     std::unordered_map<remixapi_MaterialHandle, std::optional<MaterialData>> m_extMaterials {};
+    std::unordered_map<std::string, Rc<ManagedTexture>> m_extMaterialTextures {};
     std::unordered_map<remixapi_MeshHandle, std::vector<RasterGeometry>> m_extMeshes {};
+    std::unordered_map<remixapi_MeshHandle, std::shared_ptr<PendingExternalMesh>> m_pendingExtMeshes {};
   };
 } // namespace dxvk
 
@@ -276,8 +276,11 @@ namespace dxvk {
         ScopedGpuProfileZone(ctx, "Histogram");
         static_cast<RtxContext*>(ctx.ptr())->setFramePassStage(RtxFramePassStage::AutoExposure_Histogram);
         // Prepare shader arguments
+        const bool useCompositeOutput = meterCompositeOutput();
+        const VkExtent3D& inputExtent = useCompositeOutput ? rtOutput.m_compositeOutputExtent : rtOutput.m_finalOutputExtent;
+
         ToneMappingAutoExposureArgs pushArgs = {};
-        pushArgs.numPixels = rtOutput.m_finalOutputExtent.width * rtOutput.m_finalOutputExtent.height;
+        pushArgs.numPixels = inputExtent.width * inputExtent.height;
         // Note: Autoexposure speed is in units per second, so convert from milliseconds to seconds here.
         pushArgs.autoExposureSpeed = autoExposureSpeed() * (0.001f * frameTimeMilliseconds);
         pushArgs.evMinValue = evMinValue();
@@ -291,10 +294,12 @@ namespace dxvk {
 
         // Calculate histogram
         ctx->bindResourceView(AUTO_EXPOSURE_HISTOGRAM_INPUT_OUTPUT, m_exposureHistogram.view, nullptr);
-        ctx->bindResourceView(AUTO_EXPOSURE_COLOR_INPUT, rtOutput.m_finalOutput.view(Resources::AccessType::Read), nullptr);
+        ctx->bindResourceView(AUTO_EXPOSURE_COLOR_INPUT,
+                              useCompositeOutput ? rtOutput.m_compositeOutput.view(Resources::AccessType::Read) : rtOutput.m_finalOutput.view(Resources::AccessType::Read),
+                              nullptr);
 
         ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, AutoExposureHistogramShader::getShader());
-        const VkExtent3D workgroups = util::computeBlockCount(rtOutput.m_finalOutputExtent, VkExtent3D { 16, 16, 1 });
+        const VkExtent3D workgroups = util::computeBlockCount(inputExtent, VkExtent3D { 16, 16, 1 });
         ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
       }
 
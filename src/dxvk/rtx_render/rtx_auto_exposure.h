@@ -51,6 +51,7 @@ namespace dxvk {
 
     void createResources(Rc<DxvkContext> ctx);
     const Resources::Resource& getExposureTexture() const { return m_exposure; }
+    bool isMeteringCompositeOutput() const { return meterCompositeOutput(); }
 
   private:
 
@@ -75,6 +76,10 @@ namespace dxvk {
     };
 
     RTX_OPTION("rtx.autoExposure", bool, enabled, true, "Automatically adjusts exposure so that the image won't be too bright or too dark.");
+    RTX_OPTION("rtx.autoExposure", bool, meterCompositeOutput, false,
+               "If true, exposure is metered on the render resolution composite output right after composition rather than on the final output right before tone mapping. "
+               "This takes the histogram off the chain of full resolution passes between upscaling and present and reads fewer pixels when upscaling, "
+               "at the cost of bloom and post effects no longer being part of the metered image.");
 
     // Exposure Settings
     RTX_OPTION("rtx.autoExposure", float, autoExposureSpeed, 5.f, "Average exposure changing speed (in units per second) when the image changes.");
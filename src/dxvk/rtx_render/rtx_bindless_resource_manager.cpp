@@ -32,6 +32,16 @@
 
 namespace dxvk {
 
+  namespace {
+    bool isSameDescriptor(const VkDescriptorImageInfo& a, const VkDescriptorImageInfo& b) {
+      return a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+    }
+
+    bool isSameDescriptor(const VkDescriptorBufferInfo& a, const VkDescriptorBufferInfo& b) {
+      return a.buffer == b.buffer && a.offset == b.offset && a.range == b.range;
+    }
+  }
+
   BindlessResourceManager::BindlessResourceManager(DxvkDevice* device)
   : CommonDeviceObject(device) { 
     for (int i = 0; i < kMaxFramesInFlight; i++) {
@@ -59,12 +69,40 @@ namespace dxvk {
     const size_t numDescriptors = std::max((size_t) 1, engineObjects.size()); // Must always leave 1 to have a valid binding set
     assert(numDescriptors <= kMaxBindlessResources);
 
-    std::vector<T> descriptorInfos(numDescriptors);
+    BindlessTable* table;
+    switch (Type) {
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+      table = m_tables[Table::Textures][currentIdx()].get();
+      break;
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+      table = m_tables[Table::Buffers][currentIdx()].get();
+      break;
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+      table = m_tables[Table::Samplers][currentIdx()].get();
+      break;
+    }
+
+    std::vector<T>* writtenInfos;
+    if constexpr (std::is_same_v<T, VkDescriptorImageInfo>) {
+      writtenInfos = &table->writtenImageInfos;
+    } else if constexpr (std::is_same_v<T, VkDescriptorBufferInfo>) {
+      writtenInfos = &table->writtenBufferInfos;
+    }
+
+    // Persistent containers to avoid allocations every frame
+    static std::vector<T> descriptorInfos;
+    static std::vector<Rc<DxvkResource>> resources;
+    static std::vector<VkWriteDescriptorSet> descWrites;
+
+    descriptorInfos.resize(numDescriptors);
+    resources.resize(numDescriptors);
     descriptorInfos[0] = dummyDescriptor; // we set the first descriptor to be a dummy (size is always at least 1) and overwrite it if there are valid engine objects
+    resources[0] = nullptr;
 
     uint32_t idx = 0;
     for (auto&& engineObject : engineObjects) {
       descriptorInfos[idx] = dummyDescriptor;
+      resources[idx] = nullptr;
 
       if constexpr (Type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE) {
         DxvkImageView* imageView = engineObject.getImageView();
@@ -72,17 +110,20 @@ namespace dxvk {
           descriptorInfos[idx].sampler = nullptr;
           descriptorInfos[idx].imageView = imageView->handle();
           descriptorInfos[idx].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+          resources[idx] = imageView;
           ctx->getCommandList()->trackResource<DxvkAccess::Read>(imageView);
         }
       } else if constexpr (Type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
         if (engineObject.defined()) {
           descriptorInfos[idx] = engineObject.getDescriptor().buffer;
+          resources[idx] = engineObject.buffer();
           ctx->getCommandList()->trackResource<DxvkAccess::Read>(engineObject.buffer());
         }
       } else if constexpr (Type == VK_DESCRIPTOR_TYPE_SAMPLER) {
         if (engineObject != nullptr) {
           descriptorInfos[idx].sampler = engineObject->handle();
           descriptorInfos[idx].imageView = nullptr;
+          resources[idx] = engineObject;
         }
       } else {
         static_assert(Type != VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || Type != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || Type != VK_DESCRIPTOR_TYPE_SAMPLER, "Support for this descriptor type has not been implemented yet.");
@@ -92,29 +133,52 @@ namespace dxvk {
       ++idx;
     }
 
-    VkWriteDescriptorSet descWrites;
-    memset(&descWrites, 0, sizeof(descWrites));
-    descWrites.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descWrites.descriptorCount = numDescriptors;
-    descWrites.descriptorType = Type;
+    // Only write the runs of descriptors that differ from what this ring slot's set was last written with.
+    // Descriptors past the end of the table are left as they are, nothing indexes them this frame.
+    const bool partialUpdates = RtxOptions::bindlessPartialUpdates();
+    auto isUnchanged = [&](size_t i) {
+      return partialUpdates && i < writtenInfos->size() && isSameDescriptor((*writtenInfos)[i], descriptorInfos[i]);
+    };
+
+    descWrites.clear();
+    for (size_t i = 0; i < numDescriptors; ) {
+      if (isUnchanged(i)) {
+        ++i;
+        continue;
+      }
 
-    if constexpr (std::is_same_v<T, VkDescriptorImageInfo>) {
-      descWrites.pImageInfo = &descriptorInfos[0];
-    } else if constexpr (std::is_same_v<T, VkDescriptorBufferInfo>) {
-      descWrites.pBufferInfo = &descriptorInfos[0];
+      const size_t first = i;
+      size_t last = i;
+      for (++i; i < numDescriptors && i - last <= kMaxUnchangedDescriptorsInWrite; ++i) {
+        if (!isUnchanged(i)) {
+          last = i;
+        }
+      }
+      i = last + 1;
+
+      VkWriteDescriptorSet& descWrite = descWrites.emplace_back();
+      memset(&descWrite, 0, sizeof(descWrite));
+      descWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descWrite.dstArrayElement = first;
+      descWrite.descriptorCount = last - first + 1;
+      descWrite.descriptorType = Type;
+
+      if constexpr (std::is_same_v<T, VkDescriptorImageInfo>) {
+        descWrite.pImageInfo = &descriptorInfos[first];
+      } else if constexpr (std::is_same_v<T, VkDescriptorBufferInfo>) {
+        descWrite.pBufferInfo = &descriptorInfos[first];
+      }
     }
 
-    switch (Type) {
-    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-      m_tables[Table::Textures][currentIdx()]->updateDescriptors(descWrites);
-      break;
-    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-      m_tables[Table::Buffers][currentIdx()]->updateDescriptors(descWrites);
-      break;
-    case VK_DESCRIPTOR_TYPE_SAMPLER:
-      m_tables[Table::Samplers][currentIdx()]->updateDescriptors(descWrites);
-      break;
+    if (!table->updateDescriptors(descWrites.data(), descWrites.size())) {
+      writtenInfos->clear();
+      table->writtenResources.clear();
+      return;
     }
+
+    writtenInfos->assign(descriptorInfos.begin(), descriptorInfos.end());
+    table->writtenResources.swap(resources);
+    resources.clear();
   }
 
   void BindlessResourceManager::prepareSceneData(const Rc<DxvkContext> ctx, const std::vector<TextureRef>& rtTextures, const std::vector<RaytraceBuffer>& rtBuffers, const std::vector<Rc<DxvkSampler>>& samplers) {
@@ -177,22 +241,28 @@ namespace dxvk {
       throw DxvkError("BindlessTable: Failed to create descriptor set layout");
   }
 
-  void BindlessResourceManager::BindlessTable::updateDescriptors(VkWriteDescriptorSet set) {
+  bool BindlessResourceManager::BindlessTable::updateDescriptors(VkWriteDescriptorSet* sets, uint32_t numSets) {
     if (bindlessDescSet == nullptr) {
       // Allocate the descriptor set
       bindlessDescSet = m_pManager->m_globalBindlessPool[m_pManager->currentIdx()]->alloc(layout, "bindless descriptor set");
       if (bindlessDescSet == nullptr) {
-        Logger::err(str::format("BindlessTable: failed to allocate a descriptor set for ", set.descriptorCount, " ",
-                                (set.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) ? "buffers" : "textures"));
-        return;
+        Logger::err("BindlessTable: failed to allocate a descriptor set");
+        return false;
       }
     }
 
-    // Update the write descriptor with our set
-    set.dstSet = bindlessDescSet;
+    if (numSets == 0) {
+      return true;
+    }
+
+    // Update the write descriptors with our set
+    for (uint32_t i = 0; i < numSets; i++) {
+      sets[i].dstSet = bindlessDescSet;
+    }
 
     // Do the write
-    vkd()->vkUpdateDescriptorSets(vkd()->device(), 1, &set, 0, nullptr);
+    vkd()->vkUpdateDescriptorSets(vkd()->device(), numSets, sets, 0, nullptr);
+    return true;
   }
 
   void BindlessResourceManager::createGlobalBindlessDescPool() {
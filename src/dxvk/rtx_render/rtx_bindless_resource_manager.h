@@ -65,8 +65,15 @@ namespace dxvk {
       VkDescriptorSetLayout layout = VK_NULL_HANDLE;
       VkDescriptorSet bindlessDescSet = VK_NULL_HANDLE;
 
+      // What was last written to bindlessDescSet. The set of a ring slot is written again kMaxFramesInFlight frames later,
+      // so only the descriptors that changed since then need to be rewritten. The resources are held on to so that a handle
+      // can't be recycled by a different object while a descriptor still refers to it.
+      std::vector<VkDescriptorImageInfo> writtenImageInfos;
+      std::vector<VkDescriptorBufferInfo> writtenBufferInfos;
+      std::vector<Rc<DxvkResource>> writtenResources;
+
       void createLayout(const VkDescriptorType type);
-      void updateDescriptors(VkWriteDescriptorSet set);
+      bool updateDescriptors(VkWriteDescriptorSet* sets, uint32_t numSets);
 
     private:
       const Rc<vk::DeviceFn> vkd() const;
@@ -93,6 +100,9 @@ namespace dxvk {
 
     void createGlobalBindlessDescPool();
 
+    // Unchanged descriptors closer together than this are rewritten instead of splitting the write
+    static const uint32_t kMaxUnchangedDescriptorsInWrite = 32;
+
     template<VkDescriptorType Type, typename T, typename U>
     void createDescriptorSet(const Rc<DxvkContext>& ctx, const std::vector<U>& engineObjects, const T& dummyDescriptor);
   };
@@ -95,7 +95,8 @@ namespace dxvk {
 
   void DxvkBloom::dispatch(Rc<RtxContext> ctx, 
                            Rc<DxvkSampler> linearSampler, 
-                           const Resources::Resource& inOutColorBuffer) {
+                           const Resources::Resource& inOutColorBuffer,
+                           const bool performComposite) {
     ScopedGpuProfileZone(ctx, "Bloom");
     ctx->setFramePassStage(RtxFramePassStage::Bloom);
 
@@ -119,7 +120,9 @@ namespace dxvk {
       dispatchUpsampleStep(ctx, linearSampler, *res[i], *res[i - 1]);
     }
 
-    dispatchComposite(ctx, linearSampler, inOutColorBuffer, m_bloomBuffer[0]);
+    if (performComposite) {
+      dispatchComposite(ctx, linearSampler, inOutColorBuffer, m_bloomBuffer[0]);
+    }
   }
 
   void DxvkBloom::dispatchDownsampleStep(
@@ -191,7 +194,7 @@ namespace dxvk {
     BloomCompositeArgs pushArgs = {};
     pushArgs.imageSize = { outputSize.width, outputSize.height };
     pushArgs.imageSizeInverse = { 1.f / float(outputSize.width), 1.f / float(outputSize.height) };
-    pushArgs.intensity = 0.01f * std::max(burnIntensity(), 0.0f);
+    pushArgs.intensity = getCompositeIntensity();
     ctx->pushConstants(0, sizeof(pushArgs), &pushArgs);
 
     VkExtent3D workgroups = util::computeBlockCount(outputSize, VkExtent3D{ 16 , 16, 1 });
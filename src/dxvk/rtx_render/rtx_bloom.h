@@ -40,13 +40,19 @@ namespace dxvk {
     DxvkBloom& operator=(const DxvkBloom&) = delete;
     DxvkBloom& operator=(DxvkBloom&&) noexcept = delete;
 
+    // When performComposite is false only the bloom buffer is built, and compositing it onto the
+    // color buffer is left to a later pass, see getBloomBuffer and getCompositeIntensity.
     void dispatch(
       Rc<RtxContext> ctx,
       Rc<DxvkSampler> linearSampler,
-      const Resources::Resource& inOutColorBuffer);
+      const Resources::Resource& inOutColorBuffer,
+      const bool performComposite = true);
 
     void showImguiSettings();
 
+    const Resources::Resource& getBloomBuffer() const { return m_bloomBuffer[0]; }
+    float getCompositeIntensity() const { return 0.01f * std::max(burnIntensity(), 0.0f); }
+
   private:
     void dispatchDownsampleStep(
       Rc<DxvkContext> ctx,
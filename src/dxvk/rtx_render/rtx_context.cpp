@@ -44,6 +44,7 @@
 #include "rtx_debug_view.h"
 
 #include "rtx/pass/common_binding_indices.h"
+#include "rtx/pass/instance_definitions.h"
 #include "rtx/pass/raytrace_args.h"
 #include "rtx/pass/volume_args.h"
 #include "rtx/utility/debug_view_indices.h"
@@ -56,6 +57,7 @@
 
 #include "../util/log/metrics.h"
 #include "../util/util_defer.h"
+#include "../util/util_timer.h"
 
 #include "rtx_imgui.h"
 #include "dxvk_scoped_annotation.h"
@@ -93,8 +95,28 @@ namespace dxvk {
       path += '/';
     }
 
+    // Periodic captures are taken many times a second, so they need the frame to tell them apart
+    const std::string frameSuffix = RtxOptions::screenshotInterval() != 0 ? str::format("_frame", m_device->getCurrentFrameId()) : "";
+
     auto& exporter = getCommonObjects()->metaExporter();
-    exporter.dumpImageToFile(this, path, str::format(imageName, "_", tm.tm_mday, tm.tm_mon, tm.tm_year, "-", tm.tm_hour, tm.tm_min, tm.tm_sec, ".dds"), image);
+    exporter.dumpImageToFile(this, path, str::format(imageName, "_", tm.tm_mday, tm.tm_mon, tm.tm_year, "-", tm.tm_hour, tm.tm_min, tm.tm_sec, frameSuffix, ".dds"), image);
+  }
+
+  bool RtxContext::isPeriodicScreenshotFrame() {
+    // Sized to absorb a few frames of encoding falling behind before captures are dropped
+    static constexpr size_t kMaxPeriodicExportsInFlight = 8;
+
+    const uint32_t interval = RtxOptions::screenshotInterval();
+    if (interval == 0 || m_device->getCurrentFrameId() % interval != 0) {
+      return false;
+    }
+
+    // Skip the capture rather than stall or queue up readbacks when the encoding can't keep up
+    if (getCommonObjects()->metaExporter().getNumExportsInFlights() >= kMaxPeriodicExportsInFlight) {
+      Logger::debug(str::format("RTX: Skipped periodic screenshot of frame ", m_device->getCurrentFrameId(), ", previous captures are still being written"));
+      return false;
+    }
+    return true;
   }
 
   void RtxContext::blitImageHelper(Rc<DxvkContext> ctx, const Rc<DxvkImage>& srcImage, const Rc<DxvkImage>& dstImage, VkFilter filter) {
@@ -265,6 +287,12 @@ namespace dxvk {
       downscaleExtent.depth = 1;
     } else {
       downscaleExtent = upscaleExtent;
+      // Without an upscaler there is nothing to bring a lower resolution back up to the output
+      m_dynamicResolutionScale = 1.f;
+    }
+    if (m_dynamicResolutionScale < 1.f) {
+      downscaleExtent.width = uint32_t(std::roundf(downscaleExtent.width * m_dynamicResolutionScale));
+      downscaleExtent.height = uint32_t(std::roundf(downscaleExtent.height * m_dynamicResolutionScale));
     }
     downscaleExtent.width = std::max(downscaleExtent.width, 1u);
     downscaleExtent.height = std::max(downscaleExtent.height, 1u);
@@ -274,6 +302,54 @@ namespace dxvk {
     return downscaleExtent;
   }
 
+  void RtxContext::updateDynamicResolutionScale(const float frameTimeMilliseconds, const float gpuIdleTimeMilliseconds) {
+    if (!RtxOptions::DynamicResolution::enable()) {
+      m_dynamicResolutionScale = 1.f;
+      m_dynamicResolutionFrameCount = 0;
+      m_dynamicResolutionFrameTimeSum = 0.f;
+      m_dynamicResolutionGpuIdleTimeSum = 0.f;
+      return;
+    }
+
+    m_dynamicResolutionFrameTimeSum += frameTimeMilliseconds;
+    m_dynamicResolutionGpuIdleTimeSum += gpuIdleTimeMilliseconds;
+    if (++m_dynamicResolutionFrameCount < std::max(RtxOptions::DynamicResolution::framesPerAdjustment(), 1u)) {
+      return;
+    }
+
+    const float averageFrameTime = m_dynamicResolutionFrameTimeSum / m_dynamicResolutionFrameCount;
+    const float averageGpuIdleTime = m_dynamicResolutionGpuIdleTimeSum / m_dynamicResolutionFrameCount;
+    m_dynamicResolutionFrameCount = 0;
+    m_dynamicResolutionFrameTimeSum = 0.f;
+    m_dynamicResolutionGpuIdleTimeSum = 0.f;
+
+    // Note: Every change of the scale resizes the resolution dependent resources, so the scale keeps to multiples of the step
+    // and only moves when the average frame time leaves a band around the target. The band is wide enough that a single step
+    // up from within it is not expected to push the frame time straight back over the target.
+    const float step = std::clamp(RtxOptions::DynamicResolution::scaleStep(), 0.01f, 1.f);
+    const float minScale = std::clamp(RtxOptions::DynamicResolution::minScale(), step, 1.f);
+    const float targetFrameTime = RtxOptions::DynamicResolution::targetFrameTimeMs();
+    constexpr float kOverBudgetFactor = 1.05f;
+    constexpr float kUnderBudgetFactor = 0.8f;
+    // A GPU idling for this much of the frame is waiting on the CPU, a lower resolution would not make the frame any shorter
+    constexpr float kGpuBoundIdleFraction = 0.1f;
+
+    float scale = m_dynamicResolutionScale;
+    if (averageFrameTime > targetFrameTime * kOverBudgetFactor) {
+      if (averageGpuIdleTime < averageFrameTime * kGpuBoundIdleFraction) {
+        scale -= step;
+      }
+    } else if (averageFrameTime < targetFrameTime * kUnderBudgetFactor) {
+      scale += step;
+    }
+    scale = std::clamp(std::roundf(scale / step) * step, minScale, 1.f);
+
+    if (scale != m_dynamicResolutionScale) {
+      Logger::debug(str::format("RTX: Dynamic resolution scale changed to ", scale, " (average frame time ", averageFrameTime, " ms)"));
+      m_dynamicResolutionScale = scale;
+    }
+  }
+
   void RtxContext::resetScreenResolution(const VkExtent3D& upscaleExtent) {
     // Calculate extents based on if DLSS is enabled or not
     const VkExtent3D downscaleExtent = setDownscaleExtent(upscaleExtent);
@@ -403,6 +479,17 @@ namespace dxvk {
       m_resetHistory = true;
     }
 
+    // Camera cuts keeping the scene around (see SceneManager::prepareSceneData) still invalidate everything reprojected from the
+    // previous view, so reset the screen space history but leave the world space caches alone
+    m_resetScreenSpaceHistoryOnly = false;
+    if (RtxOptions::preserveWorldSpaceCachesOnCameraCut() && !m_resetHistory &&
+        getSceneManager().getCameraManager().isCameraCutThisFrame() &&
+        getSceneManager().getRayPortalManager().getCameraTeleportationRayPortalDirectionInfo() == nullptr) {
+      Logger::info(str::format("Camera cut detected on frame ", m_device->getCurrentFrameId(), ", resetting screen space history only"));
+      m_resetHistory = true;
+      m_resetScreenSpaceHistoryOnly = true;
+    }
+
     // Release resources when switching upscalers
     m_currentUpscaler = getCurrentFrameUpscaler();
     if (m_currentUpscaler != m_previousUpscaler) {
@@ -428,6 +515,7 @@ namespace dxvk {
   // Hooked into D3D9 presentImage (same place HUD rendering is)
   void RtxContext::injectRTX(std::uint64_t cachedReflexFrameId, Rc<DxvkImage> targetImage) {
     ScopedCpuProfileZone();
+    AccumulatingTimer injectTimer(m_injectRtxMilliseconds);
 #ifdef REMIX_DEVELOPMENT
     m_currentPassStage = RtxFramePassStage::FrameBegin;
 #endif
@@ -443,6 +531,10 @@ namespace dxvk {
 
     auto common = getCommonObjects();
     const auto isRaytracingEnabled = RtxOptions::enableRaytracing();
+
+    // Start compiling the pipelines option changes may have made reachable before deciding whether to wait on async compilation
+    common->getRtxInitializer().prewarmChangedShaders();
+
     const auto asyncShaderCompilationActive = RtxOptions::Shader::enableAsyncCompilation() && common->pipelineManager().remixShaderCompilationCount() > 0;
 
     // Determine and set present throttle delay
@@ -500,7 +592,8 @@ namespace dxvk {
     ShaderManager::getInstance()->update();
 #endif
 
-    const float frameTimeMilliseconds = RtxOptions::timeDeltaBetweenFrames() == 0.f ? getWallTimeSinceLastCall() : RtxOptions::timeDeltaBetweenFrames();
+    const float fixedTimeDelta = RtxOptions::timeDeltaBetweenFrames() != 0.f ? RtxOptions::timeDeltaBetweenFrames() : RtxGpuPassProfiler::getBenchmarkTimeDelta();
+    const float frameTimeMilliseconds = fixedTimeDelta == 0.f ? getWallTimeSinceLastCall() : fixedTimeDelta;
     const float gpuIdleTimeMilliseconds = getGpuIdleTimeSinceLastCall();
 
     // Note: Only engage ray tracing when it is enabled, the camera is valid and when no shaders are currently being compiled asynchronously (as
@@ -511,7 +604,8 @@ namespace dxvk {
       }
 
       const bool captureTestScreenshot = (m_screenshotFrameEnabled && m_device->getCurrentFrameId() == m_screenshotFrameNum);
-      const bool captureScreenImage = s_triggerScreenshot || (captureTestScreenshot && !s_capturePrePresentTestScreenshot);
+      const bool captureRequestedScreenImage = s_triggerScreenshot || (captureTestScreenshot && !s_capturePrePresentTestScreenshot);
+      const bool captureScreenImage = captureRequestedScreenImage || isPeriodicScreenshotFrame();
       const bool captureDebugImage = RtxOptions::captureDebugImage();
       
       if (s_triggerUsdCapture) {
@@ -537,7 +631,11 @@ namespace dxvk {
 
       this->spillRenderPass(false);
 
-      getCommonObjects()->getTextureManager().submitTexturesToDeviceLocal(this, m_execBarriers, m_execAcquires);
+      // Retained API instances are not resubmitted by the application, draw them ahead of building the scene
+      getSceneManager().submitExternalInstances(this);
+
+      getCommonObjects()->getTextureManager().submitTexturesToDeviceLocal(this,
+        { m_sdmaAcquires, m_sdmaBarriers, m_initBarriers, m_execAcquires, m_execBarriers });
 
       m_execBarriers.recordCommands(m_cmd);
 
@@ -559,6 +657,11 @@ namespace dxvk {
       // If we really don't have any RT to do, just bail early (could be UI/menus rendering)
       if (getSceneManager().getSurfaceBuffer() != nullptr) {
 
+        // Note: A fixed time delta between frames says nothing about how long the GPU took, so it does not drive the resolution.
+        if (fixedTimeDelta == 0.f) {
+          updateDynamicResolutionScale(frameTimeMilliseconds, gpuIdleTimeMilliseconds);
+        }
+
         VkExtent3D downscaledExtent = onFrameBegin(targetImage->info().extent, frameTimeMilliseconds);
 
         Resources::RaytracingOutput& rtOutput = getResourceManager().getRaytracingOutput();
@@ -585,6 +688,9 @@ namespace dxvk {
         // Neural Radiance Cache
         m_common->metaNeuralRadianceCache().dispatchTrainingAndResolve(*this, rtOutput);
 
+        // Interleaved indirect tracing reconstruction
+        m_common->metaPathtracerIntegrateIndirect().dispatchInterleavedReconstruction(this, rtOutput);
+
         // RTXDI confidence
         m_common->metaRtxdiRayQuery().dispatchConfidence(this, rtOutput);
 
@@ -618,6 +724,11 @@ namespace dxvk {
         // Composition
         dispatchComposite(rtOutput);
 
+        // Auto exposure may meter the composite output, which keeps it off the passes following the upscaler
+        if (m_common->metaAutoExposure().isMeteringCompositeOutput()) {
+          dispatchAutoExposure(rtOutput, frameTimeMilliseconds);
+        }
+
         // Post composite Debug View that may overwrite Composite output
         dispatchReplaceCompositeWithDebugView(rtOutput);
         
@@ -658,13 +769,17 @@ namespace dxvk {
         RtxDustParticles& dust = m_common->metaDustParticles();
         dust.simulateAndDraw(this, m_state, rtOutput, frameTimeMilliseconds / 1000);
 
-        dispatchBloom(rtOutput);
-        dispatchPostFx(rtOutput);
+        // The bloom composite is folded into the post-fx lens effect pass whenever that pass runs on the final output
+        const bool fuseBloomIntoPostFx = m_common->metaBloom().isActive() &&
+          m_common->metaPostFx().canFuseBloomComposite(getSceneManager().getCamera().isCameraCut());
+        dispatchBloom(rtOutput, !fuseBloomIntoPostFx);
+        dispatchPostFx(rtOutput, fuseBloomIntoPostFx);
 
         // Tone mapping
         // WAR for TREX-553 - disable sRGB conversion as NVTT implicitly applies it during dds->png
         // conversion for 16bit float formats
-        const bool performSRGBConversion = !captureScreenImage && g_allowSrgbConversionForOutput;
+        // Note: Periodic captures keep the conversion so the frames presented in between do not change.
+        const bool performSRGBConversion = !captureRequestedScreenImage && g_allowSrgbConversionForOutput;
         dispatchToneMapping(rtOutput, performSRGBConversion, frameTimeMilliseconds);
 
         if (captureScreenImage) {
@@ -699,7 +814,7 @@ namespace dxvk {
         }
 
         // Log stats when an image is taken
-        if (captureScreenImage) {
+        if (captureRequestedScreenImage) {
           getSceneManager().logStatistics();
         }
 
@@ -764,6 +879,9 @@ namespace dxvk {
     }
     s_triggerScreenshot = false;
 
+    // Hand the screenshots the GPU is done with over for encoding
+    getCommonObjects()->metaExporter().flushReadbacks(this);
+
     // Some time in the future kill process
     if (m_triggerDelayedTerminate &&
         (m_device->getCurrentFrameId() > m_terminateAppFrameNum) &&
@@ -777,6 +895,13 @@ namespace dxvk {
 
     // This needs to happen at the end of frame, after ImGUI rendering
     GpuMemoryTracker::onFrameEnd();
+
+    m_common->metaMemoryTelemetry().update();
+
+    if (RtxFrameSpikeDetector::isEnabled()) {
+      m_common->metaFrameSpikeDetector().onFrameEnd(m_injectRtxMilliseconds);
+    }
+    m_injectRtxMilliseconds = 0.f;
   }
 
   void RtxContext::updateMetrics(const float frameTimeMilliseconds, const float gpuIdleTimeMilliseconds) const {
@@ -982,6 +1107,15 @@ namespace dxvk {
     constants.russianRoulette1stBounceMaxContinueProbability = RtxOptions::russianRoulette1stBounceMaxContinueProbability();
     constants.pathMinBounces = RtxOptions::pathMinBounces();
     constants.pathMaxBounces = RtxOptions::pathMaxBounces();
+    // Note: Only the checkerboard and 2x2 quad patterns exist, anything else rounds down to the nearest of them.
+    const uint32_t interleavedIndirectRate = RtxOptions::InterleavedIndirect::rate();
+    constants.interleavedIndirectRate = interleavedIndirectRate >= 4 ? 4 : (interleavedIndirectRate >= 2 ? 2 : 1);
+    constants.interleavedIndirectFovealRadius = std::max(RtxOptions::InterleavedIndirect::fovealRadius(), 0.0f);
+    constants.serSurfaceSortKeyHintBits = std::min(RtxOptions::serSurfaceSortKeyHintBits(), uint32_t(SURFACE_SORT_KEY_NUM_BITS));
+    // Note: Stability is judged against the previous frame's primary surfaces, which are not usable after a history reset.
+    constants.enableAdaptiveIndirectSampling = RtxOptions::AdaptiveIndirectSampling::enable() && !m_resetHistory;
+    constants.adaptiveIndirectSamplingStableMaxBounces = RtxOptions::AdaptiveIndirectSampling::stableMaxBounces();
+    constants.adaptiveIndirectSamplingLightingChangeThreshold = RtxOptions::AdaptiveIndirectSampling::lightingChangeThreshold();
     // Note: Probability adjustments always in the 0-1 range and therefore less than FLOAT16_MAX.
     constants.opaqueDiffuseLobeSamplingProbabilityZeroThreshold =
       glm::packHalf1x16(RtxOptions::opaqueDiffuseLobeSamplingProbabilityZeroThreshold());
@@ -1111,8 +1245,10 @@ namespace dxvk {
       restirGISampleStealingMode = ReSTIRGISampleStealing::StealSample;
     }
     constants.enableReSTIRGI = restirGI.isActive();
-    constants.enableReSTIRGITemporalReuse = restirGI.useTemporalReuse();
+    // Reservoirs of the previous view have nothing to do with the current one after a camera cut
+    constants.enableReSTIRGITemporalReuse = restirGI.useTemporalReuse() && !m_resetScreenSpaceHistoryOnly;
     constants.enableReSTIRGISpatialReuse = restirGI.useSpatialReuse();
+    constants.enableReSTIRGIHalfResolutionReuse = restirGI.isHalfResolutionReuseActive();
     constants.reSTIRGIMISMode = (uint32_t)restirGI.misMode();
     constants.enableReSTIRGIFinalVisibility = restirGI.useFinalVisibility();
     constants.enableReSTIRGIReflectionReprojection = restirGI.useReflectionReprojection();
@@ -1156,7 +1292,7 @@ namespace dxvk {
     constants.allowNrcTraining = NeuralRadianceCache::NrcOptions::trainCache();
     nrc.setRaytraceArgs(constants);
 
-    m_common->metaNeeCache().setRaytraceArgs(constants, m_resetHistory);
+    m_common->metaNeeCache().setRaytraceArgs(constants, m_resetHistory && !m_resetScreenSpaceHistoryOnly);
     constants.surfaceCount = getSceneManager().getAccelManager().getSurfaceCount();
 
     auto* cameraTeleportDirectionInfo = getSceneManager().getRayPortalManager().getCameraTeleportationRayPortalDirectionInfo();
@@ -1232,6 +1368,9 @@ namespace dxvk {
     constants.timeSinceStartSeconds = (static_cast<uint32_t>(getSceneManager().getGameTimeSinceStartMS()) & ((1U << 24U) - 1U)) / 1000.f;
 
     m_common->metaRtxdiRayQuery().setRaytraceArgs(rtOutput);
+    if (m_resetScreenSpaceHistoryOnly) {
+      constants.enableRtxdiTemporalReuse = false;
+    }
     getSceneManager().getLightManager().setRaytraceArgs(
       constants,
       m_common->metaRtxdiRayQuery().initialSampleCount(),
@@ -1288,6 +1427,7 @@ namespace dxvk {
     Rc<DxvkBuffer> lightBuffer = getSceneManager().getLightManager().getLightBuffer();
     Rc<DxvkBuffer> previousLightBuffer = getSceneManager().getLightManager().getPreviousLightBuffer();
     Rc<DxvkBuffer> lightMappingBuffer = getSceneManager().getLightManager().getLightMappingBuffer();
+    Rc<DxvkBuffer> lightTreeBuffer = getSceneManager().getLightManager().getLightTreeBuffer();
     Rc<DxvkBuffer> gpuPrintBuffer = getResourceManager().getRaytracingOutput().m_gpuPrintBuffer;
     Rc<DxvkImageView> valueNoiseLut = getResourceManager().getValueNoiseLut(this);
     Rc<DxvkSampler> linearSampler = getResourceManager().getSampler(VK_FILTER_LINEAR, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
@@ -1306,6 +1446,7 @@ namespace dxvk {
     bindResourceBuffer(BINDING_LIGHT_DATA_BUFFER, DxvkBufferSlice(lightBuffer, 0, lightBuffer.ptr() ? lightBuffer->info().size : 0));
     bindResourceBuffer(BINDING_PREVIOUS_LIGHT_DATA_BUFFER, DxvkBufferSlice(previousLightBuffer, 0, previousLightBuffer.ptr() ? previousLightBuffer->info().size : 0));
     bindResourceBuffer(BINDING_LIGHT_MAPPING, DxvkBufferSlice(lightMappingBuffer, 0, lightMappingBuffer.ptr() ? lightMappingBuffer->info().size : 0));
+    bindResourceBuffer(BINDING_LIGHT_TREE_BUFFER, DxvkBufferSlice(lightTreeBuffer, 0, lightTreeBuffer.ptr() ? lightTreeBuffer->info().size : 0));
     bindResourceBuffer(BINDING_BILLBOARDS_BUFFER, DxvkBufferSlice(billboardsBuffer, 0, billboardsBuffer.ptr() ? billboardsBuffer->info().size : 0));
     bindResourceView(BINDING_BLUE_NOISE_TEXTURE, getResourceManager().getBlueNoiseTexture(this), nullptr);
     bindResourceBuffer(BINDING_CONSTANTS, DxvkBufferSlice(constantsBuffer, 0, constantsBuffer->info().size));
@@ -1566,7 +1707,21 @@ namespace dxvk {
       denoiseOutput.diffuse_hitT = &rtOutput.m_secondaryCombinedDiffuseRadiance.resource(Resources::AccessType::Write);
       denoiseOutput.specular_hitT = &rtOutput.m_secondaryCombinedSpecularRadiance.resource(Resources::AccessType::Write);
 
-      runDenoising(denoiser2, referenceDenoiserSecondLobe2, denoiseInput, denoiseOutput);
+      DxvkHalfResolutionDenoise& halfResolutionDenoise = m_common->metaHalfResolutionDenoise();
+
+      if (halfResolutionDenoise.isActive() && !denoiser2.isReferenceDenoiserEnabled()) {
+        const float missLinearViewZ = denoiser2.getNrdArgs().missLinearViewZ;
+
+        DxvkDenoise::Input halfResolutionInput;
+        DxvkDenoise::Output halfResolutionOutput;
+        halfResolutionDenoise.dispatchDownsample(this, denoiseInput, missLinearViewZ, halfResolutionInput, halfResolutionOutput);
+
+        runDenoising(denoiser2, referenceDenoiserSecondLobe2, halfResolutionInput, halfResolutionOutput);
+
+        halfResolutionDenoise.dispatchUpsample(this, denoiseInput, missLinearViewZ, denoiseOutput);
+      } else {
+        runDenoising(denoiser2, referenceDenoiserSecondLobe2, denoiseInput, denoiseOutput);
+      }
     }
   }
 
@@ -1635,6 +1790,28 @@ namespace dxvk {
       rtOutput, settings);
   }
 
+  namespace {
+    float getAdjustedFrameTimeMilliseconds(const float frameTimeMilliseconds) {
+      float adjustedFrameTimeMilliseconds = frameTimeMilliseconds;
+      if (NrdSettings::getTimeDeltaBetweenFrames() > 0) {
+        adjustedFrameTimeMilliseconds = NrdSettings::getTimeDeltaBetweenFrames();
+      }
+      return std::max(0.f, adjustedFrameTimeMilliseconds);
+    }
+  }
+
+  void RtxContext::dispatchAutoExposure(const Resources::RaytracingOutput& rtOutput, const float frameTimeMilliseconds) {
+    ScopedCpuProfileZone();
+
+    this->spillRenderPass(false);
+    this->unbindComputePipeline();
+
+    DxvkAutoExposure& autoExposure = m_common->metaAutoExposure();
+    autoExposure.dispatch(this,
+      getResourceManager().getSampler(VK_FILTER_LINEAR, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER),
+      rtOutput, getAdjustedFrameTimeMilliseconds(frameTimeMilliseconds));
+  }
+
   void RtxContext::dispatchToneMapping(const Resources::RaytracingOutput& rtOutput, bool performSRGBConversion, const float frameTimeMilliseconds) {
     ScopedCpuProfileZone();
 
@@ -1646,16 +1823,12 @@ namespace dxvk {
     this->spillRenderPass(false);
     this->unbindComputePipeline();
 
-    float adjustedFrameTimeMilliseconds = frameTimeMilliseconds;
-    if (NrdSettings::getTimeDeltaBetweenFrames() > 0) {
-      adjustedFrameTimeMilliseconds = NrdSettings::getTimeDeltaBetweenFrames();
-    }
-    adjustedFrameTimeMilliseconds = std::max(0.f, adjustedFrameTimeMilliseconds);
+    const float adjustedFrameTimeMilliseconds = getAdjustedFrameTimeMilliseconds(frameTimeMilliseconds);
 
-    DxvkAutoExposure& autoExposure = m_common->metaAutoExposure();    
-    autoExposure.dispatch(this, 
-      getResourceManager().getSampler(VK_FILTER_LINEAR, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER),
-      rtOutput, adjustedFrameTimeMilliseconds, performSRGBConversion);
+    DxvkAutoExposure& autoExposure = m_common->metaAutoExposure();
+    if (!autoExposure.isMeteringCompositeOutput()) {
+      dispatchAutoExposure(rtOutput, frameTimeMilliseconds);
+    }
 
     // We don't reset history for tonemapper on m_resetHistory for easier comparison when toggling raytracing modes.
     // The tone curve shouldn't be too different between raytracing modes, 
@@ -1678,7 +1851,7 @@ namespace dxvk {
     }
   }
 
-  void RtxContext::dispatchBloom(const Resources::RaytracingOutput& rtOutput) {
+  void RtxContext::dispatchBloom(const Resources::RaytracingOutput& rtOutput, const bool performComposite) {
     ScopedCpuProfileZone();
     DxvkBloom& bloom = m_common->metaBloom();
     if (!bloom.isActive()) {
@@ -1691,10 +1864,11 @@ namespace dxvk {
 
     bloom.dispatch(this,
       getResourceManager().getSampler(VK_FILTER_LINEAR, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE),
-      rtOutput.m_finalOutput.resource(Resources::AccessType::ReadWrite));
+      rtOutput.m_finalOutput.resource(Resources::AccessType::ReadWrite),
+      performComposite);
   }
 
-  void RtxContext::dispatchPostFx(Resources::RaytracingOutput& rtOutput) {
+  void RtxContext::dispatchPostFx(Resources::RaytracingOutput& rtOutput, const bool compositeBloom) {
     ScopedCpuProfileZone();
     DxvkPostFx& postFx = m_common->metaPostFx();
     RtCamera& mainCamera = getSceneManager().getCamera();
@@ -1708,7 +1882,9 @@ namespace dxvk {
       mainCamera.getShaderConstants().resolution,
       RtxOptions::rngSeedWithFrameIndex() ? m_device->getCurrentFrameId() : 0,
       rtOutput,
-      mainCamera.isCameraCut());
+      mainCamera.isCameraCut(),
+      compositeBloom ? &m_common->metaBloom().getBloomBuffer() : nullptr,
+      compositeBloom ? m_common->metaBloom().getCompositeIntensity() : 0.0f);
   }
 
   void RtxContext::dispatchDebugView(Rc<DxvkImage>& srcImage, const Resources::RaytracingOutput& rtOutput, bool captureScreenImage)  {
@@ -2023,6 +2199,8 @@ namespace dxvk {
   }
 
   void RtxContext::dispatchDLFG() {
+    m_common->metaDLFG().updateLatencyMode(isDLFGEnabled());
+
     if (!isDLFGEnabled()) {
       return;
     }
@@ -2285,6 +2463,62 @@ namespace dxvk {
     }
   }
 
+  bool RtxContext::tryReuseSkyProbe(const DrawParameters& params, const DrawCallState& drawCallState, const DxvkImageView* replacementTexture) {
+    const uint32_t currentFrameId = m_device->getCurrentFrameId();
+
+    // First sky draw call of the frame, the draw set of the last frame with sky draw calls is complete
+    if (m_skyProbeDrawSetFrameId != currentFrameId) {
+      // Compared against the draw set rasterized before the last frame, so that the probe
+      // keeps being rasterized every frame while the sky draw calls keep changing
+      const bool isDrawSetUnchanged = m_skyProbeDrawSetHash == m_skyProbeContentHash;
+
+      if (m_skyProbeRasterizedThisFrame) {
+        m_skyProbeContentHash = m_skyProbeDrawSetHash;
+      }
+
+      // The probe is reused for the whole frame if the sky draw calls have settled on what the probe contains
+      const bool reuse =
+        RtxOptions::skyProbeReuse() &&
+        m_skyProbeContentHash != kEmptyHash &&
+        isDrawSetUnchanged;
+
+      m_skyProbeDrawSetFrameId = currentFrameId;
+      m_skyProbeDrawSetHash = kEmptyHash;
+      m_skyProbeRasterizedThisFrame = !reuse;
+    }
+
+    const Matrix4& worldToView = drawCallState.usesVertexShader
+      ? drawCallState.getTransformData().worldToView
+      : static_cast<D3D9FixedFunctionVS*>(m_rtState.vsFixedFunctionCB->mapPtr(0))->View;
+    const Vector3 camPos = inverse(worldToView).data[3].xyz();
+
+    // The probe is rasterized around the sky camera, so only the camera relative placement matters
+    Matrix4 objectToCamera = drawCallState.usesVertexShader
+      ? drawCallState.getTransformData().objectToWorld
+      : static_cast<D3D9FixedFunctionVS*>(m_rtState.vsFixedFunctionCB->mapPtr(0))->World;
+    objectToCamera[3] -= Vector4(camPos, 0.f);
+
+    const VkImage skyProbeImage = m_skyProbeImage->handle();
+
+    XXH64_hash_t h = drawCallState.getGeometryData().getHashForRule<rules::FullGeometryHash>();
+    h = XXH64(&objectToCamera, sizeof(objectToCamera), h);
+    h = XXH64(&params, sizeof(params), h);
+    h = XXH64(&replacementTexture, sizeof(replacementTexture), h);
+    h = XXH64(&skyProbeImage, sizeof(skyProbeImage), h);
+    h = XXH64(&m_skyRtColorFormat, sizeof(m_skyRtColorFormat), h);
+
+    const XXH64_hash_t materialHash = drawCallState.getMaterialData().getHash();
+    h = XXH64(&materialHash, sizeof(materialHash), h);
+
+    if (m_skyClearDirty) {
+      h = XXH64(&m_skyClearValue, sizeof(m_skyClearValue), h);
+    }
+
+    m_skyProbeDrawSetHash = XXH64(&h, sizeof(h), m_skyProbeDrawSetHash);
+
+    return !m_skyProbeRasterizedThisFrame;
+  }
+
   void RtxContext::rasterizeToSkyProbe(const DrawParameters& params, const DrawCallState& drawCallState) {
     ScopedGpuProfileZone(this, "rasterizeToSkyProbe");
 
@@ -2553,7 +2787,10 @@ namespace dxvk {
     const DxvkViewportState curVp = m_state.vp;
 
     rasterizeToSkyMatte(params, drawCallState);
-    rasterizeToSkyProbe(params, drawCallState);
+
+    if (!tryReuseSkyProbe(params, drawCallState, replacementTexture.ptr())) {
+      rasterizeToSkyProbe(params, drawCallState);
+    }
 
     m_skyClearDirty = false;
 
@@ -2829,6 +3066,94 @@ namespace dxvk {
 
     // Output the results to the GUI field
     Resources::s_aliasingAnalyzerResultText = !availableAliasingText.empty() ? availableAliasingText : "Can't find any resources that can be aliased.\n";
+    Resources::s_aliasingAnalyzerResultText += planResourceAliasing();
+  }
+
+  std::string RtxContext::planResourceAliasing() const {
+    // Each slot is a single allocation that can back all of its resources as their pass stage lifetimes do not overlap
+    struct AliasingSlot {
+      std::vector<const ResourceCache*> resources;
+      VkDeviceSize size = 0;
+    };
+
+    auto isLifetimeDisjoint = [](const ResourceCache& a, const ResourceCache& b) {
+      return a.endPassStage < b.beginPassStage || a.beginPassStage > b.endPassStage ||
+             (a.beginPassStage != a.endPassStage && b.beginPassStage != b.endPassStage &&
+              (a.endPassStage == b.beginPassStage || a.beginPassStage == b.endPassStage));
+    };
+
+    auto isResourceCompatible = [](const ResourceCache& a, const ResourceCache& b) {
+      const auto& imageInfo = a.view->image()->info();
+      const auto& otherImageInfo = b.view->image()->info();
+      return imageInfo.extent == otherImageInfo.extent &&
+             imageInfo.numLayers == otherImageInfo.numLayers &&
+             imageInfo.type == otherImageInfo.type;
+    };
+
+    std::vector<AliasingSlot> slots;
+    VkDeviceSize totalSize = 0;
+    uint32_t numResources = 0;
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(RtxTextureFormatCompatibilityCategory::Count); ++index) {
+      std::vector<const ResourceCache*> resources;
+      for (const ResourceCache& resource : m_resourceCacheTable[index]) {
+        resources.push_back(&resource);
+      }
+
+      // Greedy interval partitioning, processing resources in the order they start being used in a frame
+      std::stable_sort(resources.begin(), resources.end(), [](const ResourceCache* a, const ResourceCache* b) {
+        return a->beginPassStage < b->beginPassStage;
+      });
+
+      const size_t firstCategorySlot = slots.size();
+
+      for (const ResourceCache* resource : resources) {
+        const VkDeviceSize size = resource->view->image()->memSize();
+        totalSize += size;
+        ++numResources;
+
+        // Dynamic resources are aliased manually in Resources::onFrameBegin, so keep them in their own allocations
+        const bool isDynamic = Resources::s_dynamicAliasingResourcesSet.find(resource->view.ptr()) != Resources::s_dynamicAliasingResourcesSet.end();
+
+        AliasingSlot* matchedSlot = nullptr;
+        for (size_t i = firstCategorySlot; i < slots.size() && !isDynamic; ++i) {
+          const bool fitsSlot = std::all_of(slots[i].resources.begin(), slots[i].resources.end(), [&](const ResourceCache* other) {
+            return isLifetimeDisjoint(*resource, *other) && isResourceCompatible(*resource, *other) &&
+                   Resources::s_dynamicAliasingResourcesSet.find(other->view.ptr()) == Resources::s_dynamicAliasingResourcesSet.end();
+          });
+
+          if (fitsSlot) {
+            matchedSlot = &slots[i];
+            break;
+          }
+        }
+
+        if (!matchedSlot) {
+          matchedSlot = &slots.emplace_back();
+        }
+
+        matchedSlot->resources.push_back(resource);
+        matchedSlot->size = std::max(matchedSlot->size, size);
+      }
+    }
+
+    VkDeviceSize plannedSize = 0;
+    std::string sharedSlotsText;
+
+    for (const AliasingSlot& slot : slots) {
+      plannedSize += slot.size;
+
+      if (slot.resources.size() > 1) {
+        sharedSlotsText += "[" + std::to_string(slot.size >> 20) + " MB]";
+        for (const ResourceCache* resource : slot.resources) {
+          sharedSlotsText += " " + *resource->names.begin();
+        }
+        sharedSlotsText += "\n";
+      }
+    }
+
+    return "\nAliasing Plan: " + std::to_string(numResources) + " resources in " + std::to_string(slots.size()) + " allocations, " +
+           std::to_string(totalSize >> 20) + " MB -> " + std::to_string(plannedSize >> 20) + " MB\n" + sharedSlotsText;
   }
 #endif
 } // namespace dxvk
@@ -175,6 +175,7 @@ namespace dxvk {
     void reportCpuSimdSupport();
 
     void takeScreenshot(std::string imageName, Rc<DxvkImage> image);
+    bool isPeriodicScreenshotFrame();
 
     void checkOpacityMicromapSupport();
     void checkShaderExecutionReorderingSupport();
@@ -198,15 +199,18 @@ namespace dxvk {
     void dispatchNIS(const Resources::RaytracingOutput& rtOutput);
     void dispatchTemporalAA(const Resources::RaytracingOutput& rtOutput);
     void dispatchToneMapping(const Resources::RaytracingOutput& rtOutput, bool performSRGBConversion, const float frameTimeMilliseconds);
-    void dispatchBloom(const Resources::RaytracingOutput& rtOutput);
-    void dispatchPostFx(Resources::RaytracingOutput& rtOutput);
+    void dispatchAutoExposure(const Resources::RaytracingOutput& rtOutput, const float frameTimeMilliseconds);
+    void dispatchBloom(const Resources::RaytracingOutput& rtOutput, const bool performComposite);
+    void dispatchPostFx(Resources::RaytracingOutput& rtOutput, const bool compositeBloom);
     void dispatchDebugView(Rc<DxvkImage>& srcImage, const Resources::RaytracingOutput& rtOutput, bool captureScreenImage);
     void dispatchObjectPicking(Resources::RaytracingOutput& rtOutput, const VkExtent3D& srcExtent, const VkExtent3D& targetExtent);
     void dispatchDLFG();
     void updateMetrics(const float frameTimeMilliseconds, const float gpuIdleTimeMilliseconds) const;
+    void updateDynamicResolutionScale(const float frameTimeMilliseconds, const float gpuIdleTimeMilliseconds);
 
     void rasterizeToSkyMatte(const DrawParameters& params, const DrawCallState& drawCallState);
     void initSkyProbe();
+    bool tryReuseSkyProbe(const DrawParameters& params, const DrawCallState& drawCallState, const DxvkImageView* replacementTexture);
     void rasterizeToSkyProbe(const DrawParameters& params, const DrawCallState& drawCallState);
     void rasterizeSky(const DrawParameters& params, const DrawCallState& drawCallState);
     enum class TryHandleSkyResult {
@@ -232,6 +236,12 @@ namespace dxvk {
     VkClearValue m_skyClearValue;
     bool m_skyClearDirty = false;
 
+    // Sky probe reuse state, see RtxOptions::skyProbeReuse
+    XXH64_hash_t m_skyProbeDrawSetHash = kEmptyHash;      // Sky draw calls of the frame being rendered so far
+    XXH64_hash_t m_skyProbeContentHash = kEmptyHash;      // Sky draw calls of the last frame rasterized into the probe
+    uint32_t m_skyProbeDrawSetFrameId = kInvalidFrameIndex;
+    bool m_skyProbeRasterizedThisFrame = false;
+
     bool shouldUseDLSS() const;
     bool shouldUseRayReconstruction() const;
     bool shouldUseNIS() const;
@@ -249,9 +259,18 @@ namespace dxvk {
     uint64_t m_cachedReflexFrameId = 0;
 
     bool m_resetHistory = true;    // Discards use of temporal data in passes
+    bool m_resetScreenSpaceHistoryOnly = false;  // Set along with m_resetHistory on camera cuts that keep the world space caches
 
     std::chrono::time_point<std::chrono::steady_clock> m_prevRunningTime;
     uint64_t m_prevGpuIdleTicks;
+    // CPU time spent in injectRTX since the last present, for the frame spike detector
+    float m_injectRtxMilliseconds = 0.f;
+
+    // Scale applied on top of the upscaler's render resolution, see rtx.dynamicResolution
+    float m_dynamicResolutionScale = 1.f;
+    uint32_t m_dynamicResolutionFrameCount = 0;
+    float m_dynamicResolutionFrameTimeSum = 0.f;
+    float m_dynamicResolutionGpuIdleTimeSum = 0.f;
 
     bool m_screenshotFrameEnabled = false;
     bool m_triggerDelayedTerminate = false;
@@ -274,6 +293,7 @@ namespace dxvk {
     void queryAvailableResourceAliasing();
     void clearResourceAliasingCache();
     void analyzeResourceAliasing();
+    std::string planResourceAliasing() const;
 
     struct ResourceCache {
       Rc<DxvkImageView> view;
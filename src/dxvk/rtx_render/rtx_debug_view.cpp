@@ -56,6 +56,15 @@ namespace dxvk {
   static const auto colormap75 = turboColormap(0.75f);
   static const auto colormap100 = turboColormap(1.0f);
 
+  // Inverse of floatToOrderedUint in debug_view.comp.slang
+  static float orderedUintToFloat(uint32_t value) {
+    value = (value & 0x80000000u) ? (value & 0x7FFFFFFFu) : ~value;
+
+    float result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+  }
+
   ImGui::ComboWithKey<uint32_t>::ComboEntries debugViewEntries = { {
         {DEBUG_VIEW_PRIMITIVE_INDEX, "Primitive Index"},
         {DEBUG_VIEW_GEOMETRY_HASH, "Geometry Hash"},
@@ -547,6 +556,7 @@ namespace dxvk {
         RW_TEXTURE2D(DEBUG_VIEW_BINDING_ACCUMULATED_DEBUG_VIEW_INPUT_OUTPUT)
 
         RW_STRUCTURED_BUFFER(DEBUG_VIEW_BINDING_STATISTICS_BUFFER_OUTPUT)
+        RW_STRUCTURED_BUFFER(DEBUG_VIEW_BINDING_STATISTICS_MIN_MAX_BUFFER_OUTPUT)
 
         SAMPLER(DEBUG_VIEW_BINDING_NEAREST_SAMPLER)
         SAMPLER(DEBUG_VIEW_BINDING_LINEAR_SAMPLER)
@@ -630,24 +640,36 @@ namespace dxvk {
 
     displayType.setDeferred(static_cast<DebugViewDisplayType>(std::min(static_cast<uint32_t>(displayType()), static_cast<uint32_t>(DebugViewDisplayType::Count) - 1)));
   
-    const uint32_t bufferLength = kMaxFramesInFlight;
+    // Note: The min/max part of a slot is bound separately, so both parts have to respect the storage buffer offset alignment.
+    const VkDeviceSize offsetAlignment = std::max<VkDeviceSize>(m_device->properties().core.properties.limits.minStorageBufferOffsetAlignment, sizeof(vec4));
+    m_statisticsMinMaxOffset = dxvk::align(sizeof(vec4), offsetAlignment);
+    m_statisticsSlotSize = dxvk::align(m_statisticsMinMaxOffset + kStatisticsMinMaxSize, offsetAlignment);
 
     DxvkBufferCreateInfo statisticsBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
     statisticsBufferInfo.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
     statisticsBufferInfo.stages = VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
     statisticsBufferInfo.access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT;
-    statisticsBufferInfo.size = bufferLength * sizeof(m_outputStatistics);
+    statisticsBufferInfo.size = kMaxFramesInFlight * m_statisticsSlotSize;
     m_statisticsBuffer = m_device->createBuffer(statisticsBufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DxvkMemoryStats::Category::RTXBuffer, "Debug View Statistics");
 
     if (areDebugViewStatisticsSupported()) {
-      // Zero init the whole buffer
-      vec4* gpuMappedVec4 = reinterpret_cast<vec4*>(m_statisticsBuffer->mapPtr(0));
       for (uint32_t i = 0; i < kMaxFramesInFlight; i++) {
-        gpuMappedVec4[i] = vec4(0.f, 0.f, 0.f, 0.f);
+        resetStatisticsSlot(i);
       }
     }
   }
 
+  void DebugView::resetStatisticsSlot(uint32_t slotIdx) {
+    const VkDeviceSize slotOffset = slotIdx * m_statisticsSlotSize;
+
+    *reinterpret_cast<vec4*>(m_statisticsBuffer->mapPtr(slotOffset)) = vec4(0.f, 0.f, 0.f, 0.f);
+
+    // Start the minimum at the largest and the maximum at the smallest encoded value so any output value replaces them
+    uint32_t* minMax = reinterpret_cast<uint32_t*>(m_statisticsBuffer->mapPtr(slotOffset + m_statisticsMinMaxOffset));
+    std::fill(minMax, minMax + 4, UINT32_MAX);
+    std::fill(minMax + 4, minMax + 8, 0u);
+  }
+
   void getDebugViewCombo(std::string searchWord, uint32_t& lastView) {
     // turn search word into lower case
     auto toLowerCase = [](std::string& word) {
@@ -698,18 +720,24 @@ namespace dxvk {
     Rc<RtxContext>& ctx,
     const Resources::RaytracingOutput& rtOutput) {
     
-    if (m_showOutputStatistics) {
-      const uint32_t frameIdx = ctx->getDevice()->getCurrentFrameId();
+    if (!shouldCalculateStatistics()) {
+      return;
+    }
+
+    const uint32_t frameIdx = ctx->getDevice()->getCurrentFrameId();
 
-      // Read from the oldest element as it is guaranteed to be written out to by the GPU by now
-      VkDeviceSize offset = ((frameIdx + 1) % kMaxFramesInFlight) * sizeof(m_outputStatistics);
-      vec4* gpuMappedVec4 = reinterpret_cast<vec4*>(m_statisticsBuffer->mapPtr(offset));
+    // Read from the oldest element as it is guaranteed to be written out to by the GPU by now
+    const uint32_t slotIdx = (frameIdx + 1) % kMaxFramesInFlight;
+    const VkDeviceSize slotOffset = slotIdx * m_statisticsSlotSize;
 
-      m_outputStatistics = *gpuMappedVec4;
+    m_outputStatistics = *reinterpret_cast<const vec4*>(m_statisticsBuffer->mapPtr(slotOffset));
 
-      // Zero out the backing memory
-      *gpuMappedVec4 = vec4(0.f, 0.f, 0.f, 0.f);
-    }
+    const uint32_t* minMax = reinterpret_cast<const uint32_t*>(m_statisticsBuffer->mapPtr(slotOffset + m_statisticsMinMaxOffset));
+    m_outputStatisticsMin = vec4(orderedUintToFloat(minMax[0]), orderedUintToFloat(minMax[1]), orderedUintToFloat(minMax[2]), orderedUintToFloat(minMax[3]));
+    m_outputStatisticsMax = vec4(orderedUintToFloat(minMax[4]), orderedUintToFloat(minMax[5]), orderedUintToFloat(minMax[6]), orderedUintToFloat(minMax[7]));
+
+    // Reset the backing memory for the frame that will write to it next
+    resetStatisticsSlot(slotIdx);
 
     // Normalize the retrieved values in case the input was supersampled due to resolution mismatch
     // between debug and the resolution of underlying data embedded in it
@@ -721,7 +749,7 @@ namespace dxvk {
       default:
         break;
       case DEBUG_VIEW_NRC_RESOLVE:
-        if (m_outputStatisticsMode == DebugViewOutputStatisticsMode::Sum
+        if (Statistics::mode() == DebugViewOutputStatisticsMode::Sum
             && nrc.isUpdateResolveModeActive()) {
           // NRC resolve loads training pixels numerous times for all query pixels,
           // so we need to divide by number of query pixels per training pixel to get the sum
@@ -740,33 +768,39 @@ namespace dxvk {
           static_cast<float>(nrc.getNumQueryPixelsPerTrainingPixel().x * nrc.getNumQueryPixelsPerTrainingPixel().y);
         break;
     }
+
+    // Note: Printed here rather than from the GUI so the statistics can be logged without the developer menu open
+    if (Statistics::printToLog()) {
+      Logger::info(str::format(
+        "Debug View Statistics: RGBA ",
+        Statistics::mode() == DebugViewOutputStatisticsMode::Sum ? "Sum " : "Mean ",
+        m_outputStatistics.x, ", ", m_outputStatistics.y, ", ", m_outputStatistics.z, ", ", m_outputStatistics.w,
+        " Min ",
+        m_outputStatisticsMin.x, ", ", m_outputStatisticsMin.y, ", ", m_outputStatisticsMin.z, ", ", m_outputStatisticsMin.w,
+        " Max ",
+        m_outputStatisticsMax.x, ", ", m_outputStatisticsMax.y, ", ", m_outputStatisticsMax.z, ", ", m_outputStatisticsMax.w));
+    }
   }
 
   void DebugView::showOutputStatistics() {
 
     if (areDebugViewStatisticsSupported()) {
-      ImGui::Checkbox("Show Output Statistics", &m_showOutputStatistics);
+      ImGui::Checkbox("Show Output Statistics", &Statistics::enableObject());
     }
 
-    if (m_showOutputStatistics) {
+    if (shouldCalculateStatistics()) {
       ImGui::Indent();
 
-      ImGui::Checkbox("Print Output Statistics", &m_printOutputStatistics);
+      ImGui::Checkbox("Print Output Statistics", &Statistics::printToLogObject());
+      ImGui::Checkbox("Statistics Only", &Statistics::statisticsOnlyObject());
       
-      outputStatisticsCombo.getKey(&m_outputStatisticsMode);
-
-      const std::string statisticsString = str::format(
-        "RGBA ",
-        m_outputStatistics.x, ", ",
-        m_outputStatistics.y, ", ",
-        m_outputStatistics.z, ", ",
-        m_outputStatistics.w);
-      
-      ImGui::Text(statisticsString.c_str());
+      outputStatisticsCombo.getKey(&Statistics::modeObject());
 
-      if (m_printOutputStatistics) {
-        Logger::info("Debug View Statistics: " + statisticsString);
-      }
+      ImGui::Text("RGBA %s %.4f, %.4f, %.4f, %.4f",
+                  Statistics::mode() == DebugViewOutputStatisticsMode::Sum ? "Sum" : "Mean",
+                  m_outputStatistics.x, m_outputStatistics.y, m_outputStatistics.z, m_outputStatistics.w);
+      ImGui::Text("RGBA Min %.4f, %.4f, %.4f, %.4f", m_outputStatisticsMin.x, m_outputStatisticsMin.y, m_outputStatisticsMin.z, m_outputStatisticsMin.w);
+      ImGui::Text("RGBA Max %.4f, %.4f, %.4f, %.4f", m_outputStatisticsMax.x, m_outputStatisticsMax.y, m_outputStatisticsMax.z, m_outputStatisticsMax.w);
 
       ImGui::Unindent();
     }
@@ -1188,8 +1222,8 @@ namespace dxvk {
     debugViewArgs.writeToCompositeOutput = shouldRunDispatchPostCompositePass();
 
     // Statistics params
-    debugViewArgs.calculateStatistics = m_showOutputStatistics;
-    debugViewArgs.statisticsMode = m_outputStatisticsMode;
+    debugViewArgs.calculateStatistics = shouldCalculateStatistics();
+    debugViewArgs.statisticsMode = Statistics::mode();
     debugViewArgs.rcpNumOutputPixels = 1.f /
       (debugViewArgs.debugViewResolution.x * debugViewArgs.debugViewResolution.y);
 
@@ -1316,8 +1350,9 @@ namespace dxvk {
     // Outputs
 
     const uint32_t frameIdx = ctx->getDevice()->getCurrentFrameId();
-    VkDeviceSize statisticsBufferOffset = (frameIdx % kMaxFramesInFlight) * sizeof(m_outputStatistics);
-    ctx->bindResourceBuffer(DEBUG_VIEW_BINDING_STATISTICS_BUFFER_OUTPUT, DxvkBufferSlice(m_statisticsBuffer, statisticsBufferOffset, m_statisticsBuffer->info().size));
+    const VkDeviceSize statisticsSlotOffset = (frameIdx % kMaxFramesInFlight) * m_statisticsSlotSize;
+    ctx->bindResourceBuffer(DEBUG_VIEW_BINDING_STATISTICS_BUFFER_OUTPUT, DxvkBufferSlice(m_statisticsBuffer, statisticsSlotOffset, sizeof(vec4)));
+    ctx->bindResourceBuffer(DEBUG_VIEW_BINDING_STATISTICS_MIN_MAX_BUFFER_OUTPUT, DxvkBufferSlice(m_statisticsBuffer, statisticsSlotOffset + m_statisticsMinMaxOffset, kStatisticsMinMaxSize));
 
     // Samplers
 
@@ -1330,6 +1365,11 @@ namespace dxvk {
     const VkExtent3D workgroups = util::computeBlockCount(outputExtent, VkExtent3D { 16, 8, 1 });
     ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
 
+    // Statistics are gathered by the debug view pass itself, nothing reads the postprocessed result when only they are requested
+    if (shouldOnlyCalculateStatistics()) {
+      return;
+    }
+
     // Dispatch postprocess pass
     dispatchPostprocess(ctx, debugViewArgs, debugViewConstantBuffer, rtOutput);
   }
@@ -1417,6 +1457,14 @@ namespace dxvk {
       ctx->writeToBuffer(cb, 0, sizeof(DebugViewArgs), &debugViewArgs);
       ctx->getCommandList()->trackResource<DxvkAccess::Read>(cb);
 
+      // Note: Only the debug view pass runs when just the statistics are requested, the rendered output is left untouched
+      // rather than having the debug view written into it at full resolution.
+      if (shouldOnlyCalculateStatistics()) {
+        dispatchDebugViewInternal(ctx, nearestSampler, linearSampler, debugViewArgs, cb, rtOutput, common);
+        m_accumulation.onFrameEnd();
+        return;
+      }
+
       // Clear HDR Waveform textures when in use before they are accumulated into
       if (displayType() == DebugViewDisplayType::HDRWaveform) {
         VkClearColorValue clearColor;
@@ -1522,6 +1570,10 @@ namespace dxvk {
     // Dispatch Debug View 
     dispatchDebugViewInternal(ctx, nearestSampler, linearSampler, debugViewArgs, cb, rtOutput, common);
 
+    if (shouldOnlyCalculateStatistics()) {
+      return;
+    }
+
     // Write debugView into output image
     dispatchRenderToOutput(ctx, debugViewArgs, cb, rtOutput);
 
@@ -1655,6 +1707,19 @@ namespace dxvk {
     m_instrumentation.reset();
   }
 
+  bool DebugView::shouldCalculateStatistics() const {
+    return Statistics::enable() && areDebugViewStatisticsSupported();
+  }
+
+  bool DebugView::shouldOnlyCalculateStatistics() const {
+    // Note: Composite debug views, the cached image and the denoiser reference mode all rely on the debug view output,
+    // so they keep the full debug view path.
+    return Statistics::statisticsOnly() && shouldCalculateStatistics() &&
+      static_cast<CompositeDebugView>(Composite::compositeViewIdx()) == CompositeDebugView::Disabled &&
+      !m_showCachedImage && !m_cacheCurrentImage &&
+      !RtxOptions::useDenoiserReferenceMode();
+  }
+
   bool DebugView::isEnabled() const {
     return debugViewIdx() != DEBUG_VIEW_DISABLED || 
       static_cast<CompositeDebugView>(m_composite.compositeViewIdx()) != CompositeDebugView::Disabled ||
@@ -83,6 +83,19 @@ namespace dxvk {
       RTX_OPTION("rtx.debugView.gpuPrint", Vector2i, pixelIndex, Vector2i(INT32_MAX, INT32_MAX), "Pixel position to GPU print for. Requires useMousePosition to be turned off.");
     } gpuPrint;
 
+    // Output Statistics
+    static struct Statistics {
+      friend class DebugView;
+      RTX_OPTION("rtx.debugView.statistics", bool, enable, false, "Enables calculating statistics (mean or sum, minimum and maximum per channel) of the debug view output on the GPU. Requires support for float atomics.");
+      RTX_OPTION("rtx.debugView.statistics", DebugViewOutputStatisticsMode, mode, DebugViewOutputStatisticsMode::Mean,
+                 "The statistic accumulated across the debug view output alongside the minimum and maximum.\n"
+                 "Supported modes are: 0 = Mean, 1 = Sum");
+      RTX_OPTION("rtx.debugView.statistics", bool, printToLog, false, "Prints the debug view output statistics to the log every frame.");
+      RTX_OPTION("rtx.debugView.statistics", bool, statisticsOnly, false,
+                 "Only calculates the debug view output statistics without displaying the debug view, leaving the rendered output as is.\n"
+                 "Skips the debug view postprocessing and the full resolution writes into the output, meant for scripted captures of debug view values.");
+    } statistics;
+
   private:
     void initCompositeDebugViews();
     void updateCompositeView(Rc<DxvkContext>& ctx);
@@ -92,6 +105,7 @@ namespace dxvk {
     void createConstantsBuffer();
     Rc<DxvkBuffer> getDebugViewConstantsBuffer();
     bool areDebugViewStatisticsSupported() const;
+    void resetStatisticsSlot(uint32_t slotIdx);
 
     DebugViewArgs getCommonDebugViewArgs(RtxContext& ctx, const Resources::RaytracingOutput& rtOutput, DxvkObjects& common);
 
@@ -109,6 +123,8 @@ namespace dxvk {
     void dispatchPostprocess(Rc<RtxContext> ctx, DebugViewArgs& debugViewArgs, Rc<DxvkBuffer>& debugViewConstantBuffer, const Resources::RaytracingOutput& rtOutput);
     void dispatchRenderToOutput(Rc<RtxContext> ctx, DebugViewArgs& debugViewArgs, Rc<DxvkBuffer>& debugViewConstantBuffer, const Resources::RaytracingOutput& rtOutput);
     bool shouldRunDispatchPostCompositePass() const;
+    bool shouldCalculateStatistics() const;
+    bool shouldOnlyCalculateStatistics() const;
     Rc<DxvkShader> getDebugViewShader() const;
 
     Rc<DxvkBuffer> m_debugViewConstants;
@@ -212,8 +228,6 @@ namespace dxvk {
 
     bool m_cacheCurrentImage = false;
     bool m_showCachedImage = false;
-    bool m_showOutputStatistics = false;
-    bool m_printOutputStatistics = false;
 
     RtxAccumulation m_accumulation;
 
@@ -225,9 +239,16 @@ namespace dxvk {
     Resources::Resource m_accumulatedFrameDebugView;
 
     // Statistics
-    DebugViewOutputStatisticsMode m_outputStatisticsMode = DebugViewOutputStatisticsMode::Mean;
+    // Per channel minimum and maximum
+    static constexpr VkDeviceSize kStatisticsMinMaxSize = 2 * sizeof(uvec4);
+    // Note: Each frame in flight has its own slot in the statistics buffer, holding the accumulated mean or sum as floats
+    // followed by the per channel minimum and maximum encoded as order preserving uints.
     Rc<DxvkBuffer> m_statisticsBuffer;
+    VkDeviceSize m_statisticsMinMaxOffset = 0;
+    VkDeviceSize m_statisticsSlotSize = 0;
     vec4 m_outputStatistics;
+    vec4 m_outputStatisticsMin;
+    vec4 m_outputStatisticsMax;
 
     Resources::Resource m_hdrWaveformRed;
     Resources::Resource m_hdrWaveformGreen;
@@ -1,10 +1,18 @@
 #include "dxvk_device.h"
 #include "rtx_dlfg.h"
+#include "rtx_reflex.h"
 
 namespace {
   constexpr uint32_t kDLFGMaxInterpolatedFrames = 4;
   constexpr uint64_t kPacerDoNotWait = uint64_t(-1);
 
+  // latency mode tuning
+  constexpr float kLatencySmoothing = 0.1f;          // weight of the newest frame in the smoothed latency
+  constexpr float kLatencyHeadroom = 0.75f;          // the latency has to drop under this fraction of the target before frame generation is restored
+  constexpr uint32_t kLatencyAdjustFrames = 30;      // consecutive frames over or under the target before adjusting
+  constexpr float kPacerIntervalScaleStep = 0.1f;
+  constexpr float kMinPacerIntervalScale = 0.5f;
+
   // debugging flags
   constexpr bool kSkipPacerSemaphoreWait = false;  // do not wait on pacer semaphore; this disables frame pacing, but still runs the pacer code
 };
@@ -224,7 +232,7 @@ namespace dxvk {
       assert(m_backbufferInFlight[acquiredImageIndex] == false);
       m_backbufferInFlight[acquiredImageIndex] = true;
 
-      m_presentQueue.push({ status, acquiredImageIndex, presentInfo, frameInterpolationInfo });
+      m_presentQueue.push({ status, acquiredImageIndex, presentInfo, frameInterpolationInfo, high_resolution_clock::now() });
 
       m_presentThread.condWorkAvailable.notify_all();
     }
@@ -749,6 +757,8 @@ namespace dxvk {
 
         pacerSemaphoreValue++;
 
+        dlfg.reportInterpolateDuration(std::chrono::duration<float, std::milli>(high_resolution_clock::now() - present.queueTime).count());
+
         if (!usePresentMetering) {
           m_dlfgPacerSemaphoreValue += present.frameInterpolation.interpolatedFrameCount;
           assert(pacerSemaphoreValue == m_dlfgPacerSemaphoreValue);
@@ -785,7 +795,8 @@ namespace dxvk {
 
     std::unique_lock<dxvk::mutex> lock(m_pacerThread.mutex);
 
-    Rc<DxvkDLFGTimestampQueryPool> queryPoolDLFG = m_device->getCommon()->metaDLFG().getDLFGQueryPool();
+    DxvkDLFG& dlfg = m_device->getCommon()->metaDLFG();
+    Rc<DxvkDLFGTimestampQueryPool> queryPoolDLFG = dlfg.getDLFGQueryPool();
 
     VkPhysicalDeviceLimits limits = m_device->adapter()->deviceProperties().limits;
     const double nsPerGpuIncrement = limits.timestampPeriod;
@@ -931,14 +942,17 @@ namespace dxvk {
         // skip the pacer logic if the timestamps don't make sense
         if (frameToFrame > 0.0 && frameToFrame < kMaxFrameTimeMs) {
           // time the present to land at the halfway point between the two DLFG interpolated frames
+          // the latency mode may shorten the spacing to hold the rendered frame back for less time
           const uint64_t frameTimeGpuTicks = dlfgTimestamp - lastFrameDlfgEndGpuTicks;
-          uint64_t deltaGpuPresentTicks = frameTimeGpuTicks / (1 + pacer.interpolatedFrameCount);
+          uint64_t deltaGpuPresentTicks = uint64_t(double(frameTimeGpuTicks / (1 + pacer.interpolatedFrameCount)) * dlfg.getPacerIntervalScale());
 
           const double deltaPresentNs = gpuTicksToNs(deltaGpuPresentTicks);
           const double deltaPresentQpcNs = qpcTicksToNs(gpuTicksToQpc(dlfgTimestamp + deltaGpuPresentTicks * pacer.interpolatedFrameCount) - high_resolution_clock::getCounter());
           ProfilerPlotValue("DLFG pacer: measured GPU sleep time (ms)", nsToMs(deltaPresentNs));
           ProfilerPlotValue("DLFG pacer: remaining CPU sleep time (ms)", nsToMs(deltaPresentQpcNs));
 
+          dlfg.reportPresentDelay(float(nsToMs(deltaPresentNs * pacer.interpolatedFrameCount)));
+
           for (uint32_t frameIndex = 0; frameIndex < pacer.interpolatedFrameCount; frameIndex++) {
 
             // ignore sleeps longer than kMaxFrameTimeMs in case something goes wrong with the math above
@@ -1287,6 +1301,92 @@ namespace dxvk {
   }
 
   uint32_t DxvkDLFG::getInterpolatedFrameCount() {
-    return std::min(maxInterpolatedFrames(), getMaxSupportedInterpolatedFrameCount());
+    return std::min({ maxInterpolatedFrames(), getMaxSupportedInterpolatedFrameCount(), m_latencyInterpolatedFrameCount });
+  }
+
+  void DxvkDLFG::updateLatencyMode(bool isDLFGEnabled) {
+    const LatencyStats latencyStats = m_device->getCommon()->metaReflex().getLatencyStats();
+    const uint32_t lastFrame = LatencyStats::statFrames - 1;
+
+    DxvkDLFGLatencyTelemetry telemetry;
+    telemetry.simulationMs = latencyStats.simDuration[lastFrame];
+    telemetry.renderMs = std::max(latencyStats.gameToRenderDuration[lastFrame] - telemetry.simulationMs, 0.0f);
+
+    // Note: Under the bridge the simulation of the renderer side only spans the server replaying the commands of the frame, which
+    // overlaps the client simulation, so the client simulation and the bridge transit replace it.
+    const BridgeFrameTimes bridgeFrameTimes = RtxReflex::getBridgeFrameTimes();
+    if (bridgeFrameTimes.simulationStart <= bridgeFrameTimes.simulationEnd && bridgeFrameTimes.simulationEnd <= bridgeFrameTimes.presentReceived &&
+        bridgeFrameTimes.presentReceived != 0) {
+      const double msPerTick = 1000.0 / double(high_resolution_clock::getFrequency());
+      telemetry.simulationMs = float(double(bridgeFrameTimes.simulationEnd - bridgeFrameTimes.simulationStart) * msPerTick);
+      telemetry.bridgeQueueMs = float(double(bridgeFrameTimes.presentReceived - bridgeFrameTimes.simulationEnd) * msPerTick);
+    }
+
+    if (isDLFGEnabled) {
+      telemetry.interpolateMs = m_interpolateDurationMs.load();
+      telemetry.presentMs = m_presentDelayMs.load();
+    }
+
+    telemetry.totalMs = telemetry.simulationMs + telemetry.bridgeQueueMs + telemetry.renderMs + telemetry.interpolateMs + telemetry.presentMs;
+
+    const uint32_t maxFrameCount = getMaxSupportedInterpolatedFrameCount();
+    float pacerIntervalScale = m_pacerIntervalScale.load();
+
+    if (!isDLFGEnabled || !enableLatencyMode() || maxFrameCount == 0) {
+      m_latencyInterpolatedFrameCount = std::numeric_limits<uint32_t>::max();
+      m_smoothedLatencyMs = telemetry.totalMs;
+      m_framesOverLatencyTarget = 0;
+      m_framesUnderLatencyTarget = 0;
+      pacerIntervalScale = 1.0f;
+    } else {
+      m_latencyInterpolatedFrameCount = std::clamp(m_latencyInterpolatedFrameCount, 1u, maxFrameCount);
+
+      // Note: Smoothed and gated by a number of consecutive frames so that a single slow frame does not flip the mode back and forth.
+      m_smoothedLatencyMs = lerp(m_smoothedLatencyMs, telemetry.totalMs, kLatencySmoothing);
+
+      if (m_smoothedLatencyMs > latencyTargetMs()) {
+        m_framesUnderLatencyTarget = 0;
+
+        if (++m_framesOverLatencyTarget >= kLatencyAdjustFrames) {
+          m_framesOverLatencyTarget = 0;
+
+          // Drop interpolated frames first, only then start shortening the pacer wait
+          if (m_latencyInterpolatedFrameCount > 1) {
+            --m_latencyInterpolatedFrameCount;
+          } else {
+            pacerIntervalScale = std::max(pacerIntervalScale - kPacerIntervalScaleStep, kMinPacerIntervalScale);
+          }
+        }
+      } else if (m_smoothedLatencyMs < latencyTargetMs() * kLatencyHeadroom) {
+        m_framesOverLatencyTarget = 0;
+
+        if (++m_framesUnderLatencyTarget >= kLatencyAdjustFrames) {
+          m_framesUnderLatencyTarget = 0;
+
+          // Restore in the reverse order
+          if (pacerIntervalScale < 1.0f) {
+            pacerIntervalScale = std::min(pacerIntervalScale + kPacerIntervalScaleStep, 1.0f);
+          } else if (m_latencyInterpolatedFrameCount < maxFrameCount) {
+            ++m_latencyInterpolatedFrameCount;
+          }
+        }
+      } else {
+        m_framesOverLatencyTarget = 0;
+        m_framesUnderLatencyTarget = 0;
+      }
+    }
+
+    m_pacerIntervalScale.store(pacerIntervalScale);
+
+    telemetry.interpolatedFrameCount = isDLFGEnabled ? getInterpolatedFrameCount() : 0;
+    telemetry.pacerIntervalScale = pacerIntervalScale;
+
+    std::lock_guard<dxvk::mutex> lock(m_latencyTelemetryMutex);
+    m_latencyTelemetry = telemetry;
+  }
+
+  DxvkDLFGLatencyTelemetry DxvkDLFG::getLatencyTelemetry() const {
+    std::lock_guard<dxvk::mutex> lock(m_latencyTelemetryMutex);
+    return m_latencyTelemetry;
   }
 } // namespace dxvk
@@ -181,6 +181,7 @@ namespace dxvk {
       uint32_t acquiredImageIndex;
       DxvkPresentInfo present;
       DxvkFrameInterpolationInfo frameInterpolation;
+      high_resolution_clock::time_point queueTime;
     };
 
     WorkerThread m_presentThread;
@@ -243,6 +244,23 @@ namespace dxvk {
     uint32_t m_nextQueryIndex = 0;
   };
 
+  // Per-stage latency of the most recent frames as seen by the DLFG latency mode, all durations are in milliseconds
+  struct DxvkDLFGLatencyTelemetry {
+    // Start to end of the simulation. Under the bridge this is measured by the client, otherwise it is the application side of the frame
+    float simulationMs = 0.0f;
+    // End of the client simulation until its Present reached the bridge server, zero when not running under the bridge
+    float bridgeQueueMs = 0.0f;
+    // End of the simulation to the end of GPU rendering
+    float renderMs = 0.0f;
+    // Hand-off of a rendered frame to the DLFG present thread until its present was queued, including frame generation
+    float interpolateMs = 0.0f;
+    // Time the CPU pacer held the rendered frame back after frame generation finished
+    float presentMs = 0.0f;
+    float totalMs = 0.0f;
+    uint32_t interpolatedFrameCount = 0;
+    float pacerIntervalScale = 1.0f;
+  };
+
   class DxvkDLFG : public CommonDeviceObject {
   public:
     explicit DxvkDLFG(DxvkDevice* device);
@@ -287,9 +305,32 @@ namespace dxvk {
     // returns the currently configured number of interpolated frames
     uint32_t getInterpolatedFrameCount();
 
+    // updates the latency telemetry from the latest Reflex stats, bridge frame times and DLFG stage timings, and the latency mode from
+    // those, called once per rendered frame whether DLFG is enabled or not
+    void updateLatencyMode(bool isDLFGEnabled);
+    DxvkDLFGLatencyTelemetry getLatencyTelemetry() const;
+
+    // stage timings reported by the DLFG present and pacer threads
+    void reportInterpolateDuration(float durationMs) {
+      m_interpolateDurationMs.store(durationMs);
+    }
+
+    void reportPresentDelay(float delayMs) {
+      m_presentDelayMs.store(delayMs);
+    }
+
+    // scale applied by the CPU pacer to the spacing of the presents of a frame
+    float getPacerIntervalScale() const {
+      return m_pacerIntervalScale.load();
+    }
+
     RTX_OPTION_ENV("rtx.dlfg", bool, enable, true, "RTX_DLFG_ENABLE", "Enables DLSS 3.0 frame generation which generates interpolated frames to increase framerate at the cost of slightly more latency."); // note: always use DxvkDevice::isDLFGEnabled() to check if DLFG is enabled, not this option directly
     RTX_OPTION("rtx.dlfg", uint32_t, maxInterpolatedFrames, 2, "For DLSS 4.0 frame generation, controls the number of interpolated frames for each rendered frame. Ignored for DLSS 3.0.");
     RTX_OPTION("rtx.dlfg", bool, enablePresentMetering, true, "Use hardware present metering for DLSS 4.0 frame generation instead of CPU pacing.");
+    RTX_OPTION("rtx.dlfg", bool, enableLatencyMode, false, "Adapts frame generation to keep the measured latency from the start of the simulation to the present of a rendered frame under rtx.dlfg.latencyTargetMs, for cases where predictable latency matters more than frame rate.\n"
+               "The number of interpolated frames is lowered first. Once a single interpolated frame is left, the CPU pacer shortens the spacing of the presents so that the rendered frame is held back for less time. Both are restored once the latency is comfortably under the target again.\n"
+               "The pacing adjustment only applies to CPU pacing, not to hardware present metering.");
+    RTX_OPTION("rtx.dlfg", float, latencyTargetMs, 30.0f, "The latency target in milliseconds for rtx.dlfg.enableLatencyMode.");
 
   private:
     std::unique_ptr<NGXDLFGContext> m_dlfgContext = nullptr;
@@ -304,5 +345,18 @@ namespace dxvk {
 
     // timestamp query pool for the DLFG pacer
     Rc<DxvkDLFGTimestampQueryPool> m_queryPoolDLFG;
+
+    // latency mode state, updated on the thread dispatching DLFG
+    uint32_t m_latencyInterpolatedFrameCount = std::numeric_limits<uint32_t>::max();
+    float m_smoothedLatencyMs = 0.0f;
+    uint32_t m_framesOverLatencyTarget = 0;
+    uint32_t m_framesUnderLatencyTarget = 0;
+
+    std::atomic<float> m_interpolateDurationMs = { 0.0f };
+    std::atomic<float> m_presentDelayMs = { 0.0f };
+    std::atomic<float> m_pacerIntervalScale = { 1.0f };
+
+    mutable dxvk::mutex m_latencyTelemetryMutex;
+    DxvkDLFGLatencyTelemetry m_latencyTelemetry;
   };
 } // namespace dxvk
@@ -21,11 +21,34 @@
 */
 #include "rtx_draw_call_cache.h"
 #include "../d3d9/d3d9_state.h"
+#include "../util/util_bit.h"
+
+#include <utility>
 
 namespace dxvk 
 {
 
 namespace {
+  constexpr uint8_t kEmptyControl = 0x80;
+  constexpr uint8_t kDeletedControl = 0xFE;
+  constexpr uint32_t kGroupSize = 16;
+  constexpr uint32_t kInitialCapacity = 1024;
+
+  // Full slots store the top 7 bits of their hash, the low bits of the hash pick the group to start probing at
+  uint8_t getControlHash(const XXH64_hash_t hash) {
+    return (uint8_t) (hash >> 57);
+  }
+
+  // Returns a mask of the slots in the group whose control byte matches
+  uint32_t matchGroup(const uint8_t* pControl, const uint8_t control) {
+    const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl));
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) control)));
+  }
+
+  // Returns a mask of the empty and deleted slots in the group, the only control bytes with the top bit set
+  uint32_t matchGroupFree(const uint8_t* pControl) {
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl)));
+  }
   bool exactMatch(const DrawCallState& drawCall, BlasEntry& blas) {
     auto isSky = [](CameraType::Enum t) {
       return t == CameraType::Sky;
@@ -42,25 +65,33 @@ namespace {
 }
 
 DrawCallCache::DrawCallCache(DxvkDevice* device) : CommonDeviceObject(device) {
-  m_entries.reserve(1024);
+  resizeTable(kInitialCapacity);
 }
 DrawCallCache::~DrawCallCache() {}
 
+void DrawCallCache::clear() {
+  m_nodes.clear();
+  m_freeNode = kInvalidIndex;
+  m_eraseCursor = 0;
+  std::fill(m_control.begin(), m_control.end(), kEmptyControl);
+  m_numFullSlots = 0;
+  m_numDeletedSlots = 0;
+}
+
 DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, BlasEntry** out) {
   // First, find the right bucket:
   const XXH64_hash_t hash = drawCall.getGeometryData().getHashForRule<rules::TopologicalHash>();
-  auto range = m_entries.equal_range(hash);
-  if (range.first == m_entries.end()) {
+  const uint32_t slot = findSlot(hash);
+  if (slot == kInvalidIndex) {
     // New bucket
-    *out = allocateEntry(hash, drawCall);
+    *out = allocateEntry(hash, kInvalidIndex, drawCall);
     return CacheState::kNew;
   }
   // Handle buckets with 1 entry:
-  auto iter = range.first;
-  iter++;
-  if (iter == range.second) {
+  const uint32_t head = m_slots[slot].head;
+  if (m_nodes[head].next == kInvalidIndex) {
     // Only 1 element
-    BlasEntry& entry = range.first->second;
+    BlasEntry& entry = *m_nodes[head].entry;
 
     const bool updatedThisFrame = entry.frameLastTouched == m_device->getCurrentFrameId();
     const bool vertexDataMatches = entry.input.getGeometryData().getHashForRule<rules::VertexDataHash>() == drawCall.getGeometryData().getHashForRule<rules::VertexDataHash>();
@@ -76,7 +107,7 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
     } else {
       // First frame of having two mismatching instances, and the first instance has already 
       // been paired with the existing BlasEntry.
-      *out = allocateEntry(hash, drawCall);
+      *out = allocateEntry(hash, slot, drawCall);
       return CacheState::kNew;
     }
   }
@@ -87,8 +118,8 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
   Matrix4 newTransform = drawCall.getTransformData().objectToWorld;
   const Vector3 newWorldPosition = drawCall.getGeometryData().boundingBox.getTransformedCentroid(newTransform);
 
-  for (auto bucketIter = range.first; bucketIter != range.second; bucketIter++) {
-    BlasEntry& blas  = bucketIter->second;
+  for (uint32_t nodeIdx = head; nodeIdx != kInvalidIndex; nodeIdx = m_nodes[nodeIdx].next) {
+    BlasEntry& blas = *m_nodes[nodeIdx].entry;
     if (exactMatch(drawCall, blas)) {
       *out = &blas;
       return CacheState::kExisted;
@@ -120,18 +151,133 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
   }
   if (*out == nullptr) {
     // Failed to find similar blas, so allocate a new one
-    *out = allocateEntry(hash, drawCall);
+    *out = allocateEntry(hash, slot, drawCall);
     return CacheState::kNew;
   }
   return CacheState::kExisted;
 
 }
 
-BlasEntry* DrawCallCache::allocateEntry(XXH64_hash_t hash, const DrawCallState& drawCall) {
-  auto iter = m_entries.emplace(hash, drawCall);
-  BlasEntry* result = &iter->second;
+BlasEntry* DrawCallCache::allocateEntry(XXH64_hash_t hash, uint32_t slot, const DrawCallState& drawCall) {
+  if (slot == kInvalidIndex) {
+    slot = insertSlot(hash);
+  }
+
+  uint32_t nodeIdx = m_freeNode;
+  if (nodeIdx != kInvalidIndex) {
+    m_freeNode = m_nodes[nodeIdx].next;
+  } else {
+    nodeIdx = (uint32_t) m_nodes.size();
+    m_nodes.emplace_back();
+  }
+
+  Node& node = m_nodes[nodeIdx];
+  node.hash = hash;
+  node.next = kInvalidIndex;
+  node.entry.emplace(drawCall);
+
+  // Append to the bucket, so that older entries are preferred when scores tie
+  uint32_t* pLink = &m_slots[slot].head;
+  while (*pLink != kInvalidIndex) {
+    pLink = &m_nodes[*pLink].next;
+  }
+  *pLink = nodeIdx;
+
+  BlasEntry* result = &*node.entry;
   result->frameCreated = m_device->getCurrentFrameId();
   return result;
 }
 
+uint32_t DrawCallCache::findSlot(XXH64_hash_t hash) const {
+  const uint8_t control = getControlHash(hash);
+  const uint32_t groupMask = (uint32_t) m_control.size() / kGroupSize - 1;
+
+  // Triangular probing visits every group once, as the group count is a power of two
+  uint32_t group = (uint32_t) hash & groupMask;
+  for (uint32_t probe = 1; probe <= groupMask + 1; ++probe) {
+    const uint8_t* pControl = &m_control[group * kGroupSize];
+
+    for (uint32_t i : bit::BitMask(matchGroup(pControl, control))) {
+      const uint32_t slot = group * kGroupSize + i;
+      if (m_slots[slot].hash == hash) {
+        return slot;
+      }
+    }
+
+    // A group with an empty slot ends every probe sequence passing through it
+    if (matchGroup(pControl, kEmptyControl) != 0) {
+      break;
+    }
+
+    group = (group + probe) & groupMask;
+  }
+
+  return kInvalidIndex;
+}
+
+uint32_t DrawCallCache::insertSlot(XXH64_hash_t hash) {
+  // Keep the table at most 7/8 full, deleted slots included, as probing stops at empty slots only
+  const uint32_t capacity = (uint32_t) m_control.size();
+  if ((m_numFullSlots + m_numDeletedSlots + 1) * 8 > capacity * 7) {
+    // Grow when mostly full with live buckets, otherwise this just sweeps out the deleted slots
+    resizeTable((m_numFullSlots + 1) * 2 > capacity ? capacity * 2 : capacity);
+  }
+
+  const uint32_t groupMask = (uint32_t) m_control.size() / kGroupSize - 1;
+
+  uint32_t group = (uint32_t) hash & groupMask;
+  for (uint32_t probe = 1; ; ++probe) {
+    const uint32_t freeMask = matchGroupFree(&m_control[group * kGroupSize]);
+    if (freeMask != 0) {
+      const uint32_t slot = group * kGroupSize + bit::tzcnt(freeMask);
+      if (m_control[slot] == kDeletedControl) {
+        --m_numDeletedSlots;
+      }
+      m_control[slot] = getControlHash(hash);
+      m_slots[slot] = { hash, kInvalidIndex };
+      ++m_numFullSlots;
+      return slot;
+    }
+
+    group = (group + probe) & groupMask;
+  }
+}
+
+void DrawCallCache::resizeTable(uint32_t capacity) {
+  const std::vector<uint8_t> oldControl = std::exchange(m_control, std::vector<uint8_t>(capacity, kEmptyControl));
+  const std::vector<Slot> oldSlots = std::exchange(m_slots, std::vector<Slot>(capacity));
+  m_numFullSlots = 0;
+  m_numDeletedSlots = 0;
+
+  for (uint32_t i = 0; i < (uint32_t) oldControl.size(); ++i) {
+    if ((oldControl[i] & kEmptyControl) == 0) {
+      const uint32_t slot = insertSlot(oldSlots[i].hash);
+      m_slots[slot].head = oldSlots[i].head;
+    }
+  }
+}
+
+void DrawCallCache::eraseNode(uint32_t nodeIdx) {
+  Node& node = m_nodes[nodeIdx];
+  const uint32_t slot = findSlot(node.hash);
+  assert(slot != kInvalidIndex);
+
+  uint32_t* pLink = &m_slots[slot].head;
+  while (*pLink != nodeIdx) {
+    pLink = &m_nodes[*pLink].next;
+  }
+  *pLink = node.next;
+
+  if (m_slots[slot].head == kInvalidIndex) {
+    // Other buckets may have probed past this slot, so it can only become empty again on a resize
+    m_control[slot] = kDeletedControl;
+    --m_numFullSlots;
+    ++m_numDeletedSlots;
+  }
+
+  node.entry.reset();
+  node.next = m_freeNode;
+  m_freeNode = nodeIdx;
+}
+
 }  // namespace nvvk
@@ -21,9 +21,10 @@
 */
 #pragma once
 
+#include <deque>
 #include <vector>
 #include <limits>
-#include <unordered_map>
+#include <optional>
 
 #include "../util/util_vector.h"
 #include "dxvk_scoped_annotation.h"
@@ -38,10 +39,13 @@ class DxvkDevice;
 
 // A cache of the BlasEntries across frames.  This maintains stable BlasEntry pointers until that BlasEntry
 // is erased by sceneManager's garbage collection.
+//
+// Entries are bucketed by their topological hash.  The buckets live in an open addressing table that is
+// probed 16 slots at a time by comparing a byte of the hash per slot with SSE2, and every bucket links
+// the entries sharing its hash.  The entries themselves live in a pool that never moves them, so erasing
+// an entry leaves every other BlasEntry pointer intact.
 class DrawCallCache : public CommonDeviceObject {
 public:
-  using MultimapType = std::unordered_multimap<XXH64_hash_t, BlasEntry, XXH64_hash_passthrough>;
-
   enum class CacheState
   {
     kNew = 0,
@@ -56,22 +60,83 @@ public:
 
   CacheState get(const DrawCallState& drawCall, BlasEntry** out);
 
-  MultimapType& getEntries() {return m_entries;}
+  // Calls shouldErase for every entry, and erases the entries it returns true for
+  template<typename Func>
+  void eraseIf(Func&& shouldErase) {
+    for (uint32_t i = 0; i < (uint32_t) m_nodes.size(); ++i) {
+      if (m_nodes[i].entry.has_value() && shouldErase(*m_nodes[i].entry)) {
+        eraseNode(i);
+      }
+    }
+  }
 
-  void clear() {
-    m_entries.clear();
+  // Same as eraseIf, but visits at most maxVisitedNodes pool nodes, continuing from the node the previous
+  // call stopped at.  Spreads a pass over a large cache across multiple calls, 0 visits the whole pool.
+  template<typename Func>
+  void eraseIfIncremental(Func&& shouldErase, uint32_t maxVisitedNodes) {
+    const uint32_t numNodes = (uint32_t) m_nodes.size();
+    if (maxVisitedNodes == 0 || maxVisitedNodes >= numNodes) {
+      eraseIf(std::forward<Func>(shouldErase));
+      m_eraseCursor = 0;
+      return;
+    }
+
+    uint32_t i = m_eraseCursor < numNodes ? m_eraseCursor : 0;
+    for (uint32_t visited = 0; visited < maxVisitedNodes; ++visited) {
+      if (m_nodes[i].entry.has_value() && shouldErase(*m_nodes[i].entry)) {
+        eraseNode(i);
+      }
+      if (++i == numNodes) {
+        i = 0;
+      }
+    }
+    m_eraseCursor = i;
   }
+
+  void clear();
   
   void rebuildSpatialMaps() {
-    for (auto iter = m_entries.begin(); iter != m_entries.end(); ++iter) {
-      iter->second.rebuildSpatialMap();
+    for (Node& node : m_nodes) {
+      if (node.entry.has_value()) {
+        node.entry->rebuildSpatialMap();
+      }
     }
   }
 
 private:
-  MultimapType m_entries;
+  static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    XXH64_hash_t hash;
+    // First node of the bucket
+    uint32_t head;
+  };
+
+  struct Node {
+    XXH64_hash_t hash = 0;
+    // Next node in the same bucket, or the next free node
+    uint32_t next = kInvalidIndex;
+    std::optional<BlasEntry> entry;
+  };
+
+  // One control byte per slot, either empty, deleted, or the top 7 bits of the hash in the slot
+  std::vector<uint8_t> m_control;
+  std::vector<Slot> m_slots;
+  uint32_t m_numFullSlots = 0;
+  uint32_t m_numDeletedSlots = 0;
+
+  // A deque never moves its elements when growing, which is what keeps BlasEntry pointers stable
+  std::deque<Node> m_nodes;
+  uint32_t m_freeNode = kInvalidIndex;
+  // Node eraseIfIncremental continues from
+  uint32_t m_eraseCursor = 0;
+
+  uint32_t findSlot(XXH64_hash_t hash) const;
+  uint32_t insertSlot(XXH64_hash_t hash);
+  void resizeTable(uint32_t capacity);
+  void eraseNode(uint32_t nodeIdx);
 
-  BlasEntry* allocateEntry(XXH64_hash_t hash, const DrawCallState& drawCall);
+  BlasEntry* allocateEntry(XXH64_hash_t hash, uint32_t slot, const DrawCallState& drawCall);
 };
 
 }  // namespace nvvk
@@ -0,0 +1,94 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "rtx_draw_call_stats.h"
+#include "dxvk_scoped_annotation.h"
+
+namespace dxvk {
+
+  namespace {
+    // Tracy identifies plots by the address of their name, so these have to stay string literals
+    constexpr const char* kOutcomeNames[] = {
+      "Draw calls: raytraced",
+      "Draw calls: raytraced render target",
+      "Draw calls: rasterized, UI",
+      "Draw calls: rasterized, after RTX injection",
+      "Draw calls: rasterized, occlusion query",
+      "Draw calls: rasterized, non-primary render target",
+      "Draw calls: rasterized, pre-transformed vertices",
+      "Draw calls: ignored, outside draw call range",
+      "Draw calls: ignored, vertex capture disabled",
+      "Draw calls: ignored, no primitives",
+      "Draw calls: ignored, unsupported topology",
+      "Draw calls: ignored, alpha test",
+      "Draw calls: ignored, alpha blend",
+      "Draw calls: ignored, no render target",
+      "Draw calls: ignored, color write disabled",
+      "Draw calls: ignored, shadow mask",
+      "Draw calls: ignored, stencil shadow",
+      "Draw calls: ignored, after RTX injection",
+      "Draw calls: ignored, render state or textures",
+      "Draw calls: ignored, no geometry",
+      "Draw calls: ignored, sky in raytraced render target",
+    };
+    static_assert(std::size(kOutcomeNames) == (size_t) DrawCallOutcome::Count);
+
+    constexpr const char* kStageNames[] = {
+      "Draw call CPU time: classification (ms)",
+      "Draw call CPU time: render state and textures (ms)",
+      "Draw call CPU time: index processing wait (ms)",
+      "Draw call CPU time: vertices and hashing (ms)",
+      "Draw call CPU time: vertex capture (ms)",
+    };
+    static_assert(std::size(kStageNames) == (size_t) DrawCallStage::Count);
+
+    // Length of the common "Draw calls: " and "Draw call CPU time: " prefixes
+    constexpr size_t kOutcomePrefixLength = 12;
+    constexpr size_t kStagePrefixLength = 20;
+  }
+
+  const char* RtxDrawCallStats::getOutcomeName(DrawCallOutcome outcome) {
+    return kOutcomeNames[(size_t) outcome] + kOutcomePrefixLength;
+  }
+
+  const char* RtxDrawCallStats::getStageName(DrawCallStage stage) {
+    return kStageNames[(size_t) stage] + kStagePrefixLength;
+  }
+
+  void RtxDrawCallStats::publish(const DrawCallFrameStats& stats) {
+    for (size_t i = 0; i < stats.outcomes.size(); i++) {
+      ProfilerPlotValueI64(kOutcomeNames[i], stats.outcomes[i]);
+    }
+
+    for (size_t i = 0; i < stats.stageMs.size(); i++) {
+      ProfilerPlotValueF64(kStageNames[i], stats.stageMs[i]);
+    }
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    m_latest = stats;
+  }
+
+  DrawCallFrameStats RtxDrawCallStats::getLatest() const {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_latest;
+  }
+
+} // namespace dxvk
@@ -0,0 +1,134 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+
+#include "dxvk_include.h"
+#include "rtx_option.h"
+#include "../../util/util_time.h"
+
+namespace dxvk {
+
+  // What the D3D9 draw call classification decided to do with a draw call, and why
+  enum class DrawCallOutcome : uint32_t {
+    RayTraced,
+    RayTracedRenderTarget,
+    RasterizedUI,
+    RasterizedAfterInjection,
+    RasterizedOcclusionQuery,
+    RasterizedNonPrimaryTarget,
+    RasterizedPreTransformed,
+    IgnoredDrawCallRange,
+    IgnoredNoVertexCapture,
+    IgnoredNoPrimitives,
+    IgnoredUnsupportedTopology,
+    IgnoredAlphaTest,
+    IgnoredAlphaBlend,
+    IgnoredNoRenderTarget,
+    IgnoredColorWriteDisabled,
+    IgnoredShadowMask,
+    IgnoredStencilShadow,
+    IgnoredAfterInjection,
+    IgnoredRenderState,
+    IgnoredNoGeometry,
+    IgnoredSkyInRenderTarget,
+
+    Count
+  };
+
+  // Parts of preparing a draw call for raytracing that are timed
+  enum class DrawCallStage : uint32_t {
+    Classification,
+    RenderState,
+    IndexWait,
+    Vertices,
+    VertexCapture,
+
+    Count
+  };
+
+  struct DrawCallFrameStats {
+    std::array<uint32_t, (size_t) DrawCallOutcome::Count> outcomes {};
+    std::array<double, (size_t) DrawCallStage::Count> stageMs {};
+
+    void record(DrawCallOutcome outcome) {
+      ++outcomes[(size_t) outcome];
+    }
+  };
+
+  // Adds the time from construction until stop() or destruction to a stage of the frame's stats.
+  // Does nothing while rtx.drawCallStats.enable is off, so it can be left in hot paths.
+  class DrawCallStageTimer {
+  public:
+    DrawCallStageTimer(DrawCallFrameStats& stats, DrawCallStage stage);
+    ~DrawCallStageTimer() {
+      stop();
+    }
+
+    DrawCallStageTimer(const DrawCallStageTimer&) = delete;
+    DrawCallStageTimer& operator=(const DrawCallStageTimer&) = delete;
+
+    void stop() {
+      if (m_stats != nullptr) {
+        m_stats->stageMs[(size_t) m_stage] += std::chrono::duration<double, std::milli>(high_resolution_clock::now() - m_start).count();
+        m_stats = nullptr;
+      }
+    }
+
+  private:
+    DrawCallFrameStats* m_stats;
+    DrawCallStage m_stage;
+    high_resolution_clock::time_point m_start;
+  };
+
+  // Per-frame breakdown of the D3D9 draw call classification, for tuning texture categories
+  // and skip heuristics. Frames are collected by the D3D9 device on the thread issuing draws
+  // and published once they end, the latest frame can be read from any thread.
+  class RtxDrawCallStats {
+  public:
+    RTX_OPTION("rtx.drawCallStats", bool, enable, false,
+               "Counts the draw calls of every frame by how they were classified (raytraced, rasterized or ignored, and why), and measures the CPU time of each stage of preparing them for raytracing.\n"
+               "The results are shown in the developer menu and plotted in Tracy. Timing every draw call has a small CPU cost, so this should be left disabled when not tuning.");
+
+    static const char* getOutcomeName(DrawCallOutcome outcome);
+    static const char* getStageName(DrawCallStage stage);
+
+    // Replaces the latest frame, and plots its counts and timings in Tracy
+    void publish(const DrawCallFrameStats& stats);
+
+    DrawCallFrameStats getLatest() const;
+
+  private:
+    mutable dxvk::mutex m_mutex;
+    DrawCallFrameStats m_latest;
+  };
+
+  inline DrawCallStageTimer::DrawCallStageTimer(DrawCallFrameStats& stats, DrawCallStage stage)
+    : m_stats(RtxDrawCallStats::enable() ? &stats : nullptr)
+    , m_stage(stage) {
+    if (m_stats != nullptr) {
+      m_start = high_resolution_clock::now();
+    }
+  }
+
+} // namespace dxvk
@@ -29,6 +29,7 @@
 #include "rtx_context.h"
 #include "rtx_imgui.h"
 
+#include <rtx_shaders/dust_particles_simulate.h>
 #include <rtx_shaders/dust_particles_vertex.h>
 #include <rtx_shaders/dust_particles_fragment.h>
 #include "dxvk_context_state.h"
@@ -38,6 +39,20 @@ namespace dxvk {
   // Defined within an unnamed namespace to ensure unique definition across binary
   namespace {
 
+    class DustParticleSimulateShader : public ManagedShader {
+      SHADER_SOURCE(DustParticleSimulateShader, VK_SHADER_STAGE_COMPUTE_BIT, dust_particles_simulate)
+
+      PUSH_CONSTANTS(ParticleSystemConstants)
+
+      BEGIN_PARAMETER()
+        COMMON_RAYTRACING_BINDINGS
+
+        RW_STRUCTURED_BUFFER(DUST_PARTICLES_BINDING_PARTICLES_BUFFER_INOUT)
+        RW_STRUCTURED_BUFFER(DUST_PARTICLES_BINDING_VISIBLE_INDICES_INOUT)
+        RW_STRUCTURED_BUFFER(DUST_PARTICLES_BINDING_DRAW_ARGS_INOUT)
+      END_PARAMETER()
+    };
+
     class DustParticleVertexShader : public ManagedShader {
       SHADER_SOURCE(DustParticleVertexShader, VK_SHADER_STAGE_VERTEX_BIT, dust_particles_vertex)
 
@@ -49,6 +64,7 @@ namespace dxvk {
         SAMPLER3D(DUST_PARTICLES_BINDING_FILTERED_RADIANCE_Y_INPUT)
         SAMPLER3D(DUST_PARTICLES_BINDING_FILTERED_RADIANCE_CO_CG_INPUT)
         RW_STRUCTURED_BUFFER(DUST_PARTICLES_BINDING_PARTICLES_BUFFER_INOUT)
+        RW_STRUCTURED_BUFFER(DUST_PARTICLES_BINDING_VISIBLE_INDICES_INOUT)
       END_PARAMETER()
 
       // Particle color and center pos output
@@ -249,34 +265,59 @@ namespace dxvk {
     pushArgs.frustumDet = pushArgs.frustumB * pushArgs.frustumB - 4 * pushArgs.frustumA * pushArgs.frustumC;
 
     pushArgs.isCameraLhs = camera.isLHS();
+    pushArgs.numberOfParticles = numberOfParticles();
+  }
+
+  void RtxDustParticles::createBuffers(RtxContext* ctx) {
+    const Rc<DxvkDevice>& device = ctx->getDevice();
+
+    DxvkBufferCreateInfo info;
+    info.size = sizeof(GpuParticle) * numberOfParticles();
+    info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+      | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+      | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    info.access = VK_ACCESS_TRANSFER_WRITE_BIT
+      | VK_ACCESS_TRANSFER_READ_BIT
+      | VK_ACCESS_SHADER_WRITE_BIT
+      | VK_ACCESS_SHADER_READ_BIT;
+    m_particles = device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Dust Particles");
+
+    ctx->clearBuffer(m_particles, 0, info.size, 0);
+
+    info.size = sizeof(uint32_t) * numberOfParticles();
+    m_visibleParticleIndices = device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Dust Particles Visible Indices");
+
+    info.size = sizeof(VkDrawIndirectCommand);
+    info.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    info.stages |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    info.access |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    m_drawArgs = device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Dust Particles Draw Args");
   }
 
   static_assert(sizeof(GpuParticle) == 8 * 4, "Unexpected, please check perf");// be careful with performance when increasing this!
 
+  void RtxDustParticles::releaseBuffers() {
+    m_particles = nullptr;
+    m_visibleParticleIndices = nullptr;
+    m_drawArgs = nullptr;
+    m_disabledFrameCount = 0;
+  }
+
   void RtxDustParticles::simulateAndDraw(RtxContext* ctx, DxvkContextState& dxvkCtxState, const Resources::RaytracingOutput& rtOutput, const float frameTimeSecs) {
     if (!enable()) { 
+      if (m_particles != nullptr && ++m_disabledFrameCount >= kDisabledFramesBeforeRelease) {
+        releaseBuffers();
+      }
       return;
     }
+    m_disabledFrameCount = 0;
 
     ScopedGpuProfileZone(ctx, "Dust Particles");
     ctx->setFramePassStage(RtxFramePassStage::DustParticles);
 
     if(m_particles == nullptr || m_particles->info().size != sizeof(GpuParticle) * numberOfParticles()) {
-      const Rc<DxvkDevice>& device = ctx->getDevice();
-
-      DxvkBufferCreateInfo info;
-      info.size = sizeof(GpuParticle) * numberOfParticles();
-      info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
-        | VK_BUFFER_USAGE_TRANSFER_DST_BIT
-        | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-      info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-      info.access = VK_ACCESS_TRANSFER_WRITE_BIT
-        | VK_ACCESS_TRANSFER_READ_BIT
-        | VK_ACCESS_SHADER_WRITE_BIT
-        | VK_ACCESS_SHADER_READ_BIT;
-      m_particles = device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Dust Particles");
-
-      ctx->clearBuffer(m_particles, 0, info.size, 0);
+      createBuffers(ctx);
     }
 
     ctx->bindCommonRayTracingResources(rtOutput);
@@ -292,21 +333,34 @@ namespace dxvk {
     ctx->bindResourceView(DUST_PARTICLES_BINDING_FILTERED_RADIANCE_CO_CG_INPUT, globalVolumetrics.getCurrentVolumeAccumulatedRadianceCoCg().view, nullptr);
     ctx->bindResourceSampler(DUST_PARTICLES_BINDING_FILTERED_RADIANCE_CO_CG_INPUT, linearSampler);
     ctx->bindResourceBuffer(DUST_PARTICLES_BINDING_PARTICLES_BUFFER_INOUT, DxvkBufferSlice(m_particles));
+    ctx->bindResourceBuffer(DUST_PARTICLES_BINDING_VISIBLE_INDICES_INOUT, DxvkBufferSlice(m_visibleParticleIndices));
+    ctx->bindResourceBuffer(DUST_PARTICLES_BINDING_DRAW_ARGS_INOUT, DxvkBufferSlice(m_drawArgs));
     ctx->bindResourceView(DUST_PARTICLES_BINDING_DEPTH_INPUT, rtOutput.m_primaryDepth.view, nullptr);
     ctx->bindResourceSampler(DUST_PARTICLES_BINDING_DEPTH_INPUT, linearSampler);
     
-    setupRasterizerState(ctx, rtOutput.m_finalOutput.resource(Resources::AccessType::ReadWrite));
-    
-    ctx->bindShader(VK_SHADER_STAGE_VERTEX_BIT, DustParticleVertexShader::getShader());
-    ctx->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, DustParticlePixelShader::getShader());
-
     ctx->setPushConstantBank(DxvkPushConstantBank::RTX);
 
     ParticleSystemConstants pushArgs;
     setupConstants(ctx, frameTimeSecs, resourceManager, pushArgs);
     ctx->pushConstants(0, sizeof(pushArgs), &pushArgs);
 
-    ctx->draw(numberOfParticles(), 1, 0, 0);
+    // Simulate all particles and append the visible ones to the draw, so that lighting and
+    // rasterization only run for particles on screen
+    {
+      const VkDrawIndirectCommand drawArgs = { 0, 1, 0, 0 };
+      ctx->updateBuffer(m_drawArgs, 0, sizeof(drawArgs), &drawArgs);
+
+      ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, DustParticleSimulateShader::getShader());
+      ctx->dispatch(divCeil<uint32_t>(numberOfParticles(), DUST_PARTICLES_SIMULATE_THREAD_GROUP_SIZE), 1, 1);
+    }
+
+    setupRasterizerState(ctx, rtOutput.m_finalOutput.resource(Resources::AccessType::ReadWrite));
+    
+    ctx->bindShader(VK_SHADER_STAGE_VERTEX_BIT, DustParticleVertexShader::getShader());
+    ctx->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, DustParticlePixelShader::getShader());
+
+    ctx->bindDrawBuffers(DxvkBufferSlice(m_drawArgs), DxvkBufferSlice());
+    ctx->drawIndirect(0, 1, sizeof(VkDrawIndirectCommand));
 
     dxvkCtxState = stateCopy;
   }
@@ -33,6 +33,12 @@ namespace dxvk {
 
   class RtxDustParticles {
     Rc<DxvkBuffer> m_particles;
+    Rc<DxvkBuffer> m_visibleParticleIndices;
+    Rc<DxvkBuffer> m_drawArgs;
+
+    // The buffers are kept around for a while after the simulation is disabled so that toggling it does not recreate them
+    static constexpr uint32_t kDisabledFramesBeforeRelease = 120;
+    uint32_t m_disabledFrameCount = 0;
 
     RTX_OPTION("rtx.dust", bool, enable, false, "Enables dust particle simulation and rendering.");
     RTX_OPTION("rtx.dust", int, numberOfParticles, 1000000, "Maximum number of particles to simulate simultaneously.");
@@ -52,6 +58,8 @@ namespace dxvk {
     RTX_OPTION("rtx.dust", float, turbulenceFrequency, .05f, "The rate of change of turbulence forces.");
     RTX_OPTION("rtx.dust", float, rotationSpeed, 5.f, "How quickly the particle is rotating (this primarily only affects light interaction).");
 
+    void createBuffers(RtxContext* ctx);
+    void releaseBuffers();
     void setupConstants(RtxContext* ctx, const float frameTimeSecs, Resources& resourceManager, ParticleSystemConstants& constants);
 
   public:
@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace dxvk {
+
+  class DxvkContext;
+
+  // Lock-free multi-producer queue of commands for the CS thread. Any thread can queue a command
+  // with a single compare-exchange, while only the thread that owns the device's CS chunk drains
+  // the queue and hands the commands to the CS thread in the order they were queued in.
+  class RtxExternalCommandQueue {
+    struct Node {
+      virtual ~Node() = default;
+      virtual void run(DxvkContext* ctx) = 0;
+      Node* next = nullptr;
+    };
+
+    template<typename Cmd>
+    struct TypedNode final : Node {
+      explicit TypedNode(Cmd&& cmd) : command(std::move(cmd)) { }
+      explicit TypedNode(const Cmd& cmd) : command(cmd) { }
+      void run(DxvkContext* ctx) override {
+        command(ctx);
+      }
+      Cmd command;
+    };
+
+    static void destroy(Node* node) {
+      while (node) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+      }
+    }
+
+  public:
+    RtxExternalCommandQueue() = default;
+    RtxExternalCommandQueue(const RtxExternalCommandQueue&) = delete;
+    RtxExternalCommandQueue& operator=(const RtxExternalCommandQueue&) = delete;
+
+    ~RtxExternalCommandQueue() {
+      // Commands that were never drained are dropped along with the device
+      destroy(m_head.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    template<typename Cmd>
+    void push(Cmd&& command) {
+      Node* node = new TypedNode<std::decay_t<Cmd>>(std::forward<Cmd>(command));
+      node->next = m_head.load(std::memory_order_relaxed);
+      while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+      }
+    }
+
+    bool empty() const {
+      return m_head.load(std::memory_order_relaxed) == nullptr;
+    }
+
+    // Takes all of the queued commands and runs them in queue order on the CS thread. Has to be
+    // created on the thread emitting to the CS chunk, and then emitted as a single CS command.
+    class Batch {
+    public:
+      explicit Batch(RtxExternalCommandQueue& queue) {
+        // The list is pushed to at its head, so it has to be reversed to get the submission order
+        Node* node = queue.m_head.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+          Node* next = node->next;
+          node->next = m_first;
+          m_first = node;
+          node = next;
+        }
+      }
+
+      Batch(Batch&& other) noexcept
+        : m_first(std::exchange(other.m_first, nullptr)) {
+      }
+
+      Batch(const Batch&) = delete;
+      Batch& operator=(const Batch&) = delete;
+
+      ~Batch() {
+        destroy(m_first);
+      }
+
+      void operator()(DxvkContext* ctx) {
+        for (Node* node = m_first; node; node = node->next) {
+          node->run(ctx);
+        }
+      }
+
+    private:
+      Node* m_first = nullptr;
+    };
+
+  private:
+    std::atomic<Node*> m_head = nullptr;
+  };
+
+} // namespace dxvk
@@ -0,0 +1,170 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <iomanip>
+
+#include "rtx_frame_spike_detector.h"
+#include "rtx_gpu_pass_profiler.h"
+#include "dxvk_device.h"
+#include "dxvk_scoped_annotation.h"
+
+namespace dxvk {
+
+  namespace {
+    // A frame still running after this long is reported without waiting for it to end
+    constexpr std::chrono::milliseconds kHangTimeout { 1000 };
+  }
+
+  RtxFrameSpikeDetector::RtxFrameSpikeDetector(DxvkDevice* device)
+    : CommonDeviceObject(device)
+    , m_lastFrameEnd(Clock::now())
+    , m_watchdog([this] { return writePendingReport(); }, "rtx-frame-spike-detector") {
+    m_watchdog.start();
+  }
+
+  RtxFrameSpikeDetector::~RtxFrameSpikeDetector() {
+    m_watchdog.stop();
+  }
+
+  void RtxFrameSpikeDetector::onFrameEnd(float injectRtxMs) {
+    ScopedCpuProfileZone();
+
+    const Clock::time_point now = Clock::now();
+    const DxvkStatCounters counters = m_device->getStatCounters();
+    DxvkObjects* common = m_device->getCommon();
+
+    auto takeDelta = [](uint64_t current, uint64_t& prev) {
+      const uint64_t delta = current - prev;
+      prev = current;
+      return delta;
+    };
+
+    FrameTimings frame {};
+    frame.frameId = m_device->getCurrentFrameId();
+    frame.frameMs = std::chrono::duration<float, std::milli>(now - m_lastFrameEnd).count();
+    // The tick counters are in microseconds
+    frame.csSyncMs = float(takeDelta(counters.getCtr(DxvkStatCounter::CsSyncTicks), m_prevCsSyncTicks)) * 0.001f;
+    frame.injectRtxMs = injectRtxMs;
+    frame.gpuSyncMs = float(takeDelta(counters.getCtr(DxvkStatCounter::GpuSyncTicks), m_prevGpuSyncTicks)) * 0.001f;
+    frame.gpuIdleMs = float(takeDelta(counters.getCtr(DxvkStatCounter::GpuIdleTicks), m_prevGpuIdleTicks)) * 0.001f;
+
+    if (RtxGpuPassProfiler::isEnabled()) {
+      uint32_t frameId;
+      for (const auto& timing : common->metaGpuPassProfiler().getLatestTimings(frameId)) {
+        if (timing.depth == 0) {
+          frame.gpuMs += timing.gpuMs;
+        }
+      }
+    }
+
+    frame.texturesUploaded = uint32_t(takeDelta(common->getTextureManager().getUploadedTextureCount(), m_prevUploadedTextureCount));
+    frame.shadersCompiling = common->pipelineManager().remixShaderCompilationCount();
+    frame.blasBuildPrimitives = common->getSceneManager().getAccelManager().getBlasBuildPrimitivesThisFrame();
+    frame.modsLoading = !common->getSceneManager().areAllReplacementsLoaded();
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    m_lastFrameEnd = now;
+    m_hangReported = false;
+
+    // The first frame is measured from whenever the detector was created
+    if (!m_hasFrames) {
+      m_hasFrames = true;
+      return;
+    }
+
+    const size_t capacity = size_t(std::max(historyFrames(), 1));
+    if (m_historyCapacity != capacity) {
+      m_historyCapacity = capacity;
+      m_history.clear();
+      m_history.reserve(capacity);
+      m_historyEnd = 0;
+    }
+
+    if (m_history.size() < capacity) {
+      m_history.push_back(frame);
+    } else {
+      m_history[m_historyEnd] = frame;
+    }
+    m_historyEnd = (m_historyEnd + 1) % capacity;
+
+    if (frame.frameMs > thresholdMs()) {
+      TracyMessageL("Frame spike");
+
+      if (!m_hasReported || now - m_lastReport >= std::chrono::duration<float>(minReportIntervalSeconds())) {
+        queueReport("Frame spike", frame.frameMs);
+      }
+    }
+  }
+
+  void RtxFrameSpikeDetector::queueReport(const char* reason, float milliseconds) {
+    const size_t size = m_history.size();
+    const size_t begin = size < m_historyCapacity ? 0 : m_historyEnd;
+
+    m_pendingReport.clear();
+    for (size_t i = 0; i < size; i++) {
+      m_pendingReport.push_back(m_history[(begin + i) % size]);
+    }
+    m_pendingReason = str::format(reason, " of ", std::fixed, std::setprecision(1), milliseconds, " ms");
+
+    m_lastReport = Clock::now();
+    m_hasReported = true;
+  }
+
+  bool RtxFrameSpikeDetector::writePendingReport() {
+    std::vector<FrameTimings> report;
+    std::string reason;
+    {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      const Clock::duration sinceFrameEnd = Clock::now() - m_lastFrameEnd;
+      if (m_pendingReport.empty() && m_hasFrames && !m_hangReported && sinceFrameEnd > kHangTimeout) {
+        m_hangReported = true;
+        queueReport("Frame still running after a stall", std::chrono::duration<float, std::milli>(sinceFrameEnd).count());
+      }
+
+      if (m_pendingReport.empty()) {
+        return false;
+      }
+      report.swap(m_pendingReport);
+      reason = std::move(m_pendingReason);
+    }
+
+    Logger::warn(str::format("Frame spike detector: ", reason, ", previous ", report.size(), " frames:"));
+    Logger::warn("     frame  frameMs csSyncMs injectMs gpuSyncMs gpuIdleMs    gpuMs texUploads shaderCompiles  blasPrims modsLoading");
+    for (const FrameTimings& frame : report) {
+      Logger::warn(str::format(std::setfill(' '), std::fixed, std::setprecision(2),
+                               std::setw(10), frame.frameId,
+                               std::setw(9), frame.frameMs,
+                               std::setw(9), frame.csSyncMs,
+                               std::setw(9), frame.injectRtxMs,
+                               std::setw(10), frame.gpuSyncMs,
+                               std::setw(10), frame.gpuIdleMs,
+                               std::setw(9), frame.gpuMs,
+                               std::setw(11), frame.texturesUploaded,
+                               std::setw(15), frame.shadersCompiling,
+                               std::setw(11), frame.blasBuildPrimitives,
+                               std::setw(12), frame.modsLoading ? "yes" : "no"));
+    }
+    return true;
+  }
+
+} // namespace dxvk
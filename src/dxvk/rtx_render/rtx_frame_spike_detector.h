@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "dxvk_include.h"
+#include "rtx_common_object.h"
+#include "rtx_option.h"
+#include "../../util/util_watchdog.h"
+
+namespace dxvk {
+
+  // Keeps the stage timings and the loader activity of the most recent frames, and writes them to the log
+  // when a frame takes longer than rtx.frameSpikeDetector.thresholdMs, so that a hitch reported by a player
+  // comes with what was going on around it. A frame that does not end at all for a second is reported the
+  // same way while it is still running, to catch hangs.
+  //
+  // Frames are recorded on the CS thread. Reports are formatted and written by a watchdog thread, so that
+  // the frame after a spike does not pay for the logging. Spikes are marked in Tracy captures as well.
+  class RtxFrameSpikeDetector : public CommonDeviceObject {
+  public:
+    explicit RtxFrameSpikeDetector(DxvkDevice* device);
+    ~RtxFrameSpikeDetector();
+
+    static bool isEnabled() {
+      return enable();
+    }
+
+    // Records the frame that just ended, called once per frame on the CS thread
+    void onFrameEnd(float injectRtxMs);
+
+  private:
+    RTX_OPTION("rtx.frameSpikeDetector", bool, enable, true,
+               "Writes the stage timings and the loader activity (texture uploads, mod loading, shader compilation, BLAS builds) of the last rtx.frameSpikeDetector.historyFrames frames to the log "
+               "whenever a frame takes longer than rtx.frameSpikeDetector.thresholdMs.");
+    RTX_OPTION("rtx.frameSpikeDetector", float, thresholdMs, 100.f,
+               "The frame time in milliseconds above which a frame is reported as a spike.");
+    RTX_OPTION("rtx.frameSpikeDetector", int, historyFrames, 60,
+               "The number of frames, up to and including the spike, that a spike report contains.");
+    RTX_OPTION("rtx.frameSpikeDetector", float, minReportIntervalSeconds, 30.f,
+               "The minimum time in seconds between two spike reports, so that a stretch of slow frames, e.g. a loading screen, does not flood the log.");
+
+    using Clock = std::chrono::steady_clock;
+
+    struct FrameTimings {
+      uint32_t frameId;
+      float frameMs;
+      // Time the D3D9 thread spent waiting for the CS thread, which is where the bridge waits on a busy runtime
+      float csSyncMs;
+      float injectRtxMs;
+      // Time the CS thread spent waiting for the GPU
+      float gpuSyncMs;
+      float gpuIdleMs;
+      // Only measured while the GPU pass profiler is enabled
+      float gpuMs;
+      uint32_t texturesUploaded;
+      uint32_t shadersCompiling;
+      uint32_t blasBuildPrimitives;
+      bool modsLoading;
+    };
+
+    // Takes a copy of the history for the watchdog thread to write, m_mutex must be held
+    void queueReport(const char* reason, float milliseconds);
+    // Runs on the watchdog thread. Returns true if a report was written.
+    bool writePendingReport();
+
+    mutable dxvk::mutex m_mutex;
+
+    std::vector<FrameTimings> m_history;
+    size_t m_historyCapacity = 0;
+    size_t m_historyEnd = 0;
+
+    std::vector<FrameTimings> m_pendingReport;
+    std::string m_pendingReason;
+
+    Clock::time_point m_lastFrameEnd;
+    Clock::time_point m_lastReport;
+    bool m_hasFrames = false;
+    bool m_hasReported = false;
+    bool m_hangReported = false;
+
+    uint64_t m_prevCsSyncTicks = 0;
+    uint64_t m_prevGpuSyncTicks = 0;
+    uint64_t m_prevGpuIdleTicks = 0;
+    uint64_t m_prevUploadedTextureCount = 0;
+
+    Watchdog<250> m_watchdog;
+  };
+
+} // namespace dxvk
@@ -52,13 +52,8 @@ namespace dxvk {
   }
 
   DxvkFSR3::DxvkFSR3(DxvkDevice* device) : CommonDeviceObject(device), RtxPass(device) {
-    // Create FSR3 context
-    if (!m_fsr3Context) {
-      m_fsr3Context = device->getCommon()->metaFSR3Context().createFSR3UpscalerContext();
-      if (!m_fsr3Context) {
-        Logger::warn("[FSR3] Failed to create FSR3 upscaler context");
-      }
-    }
+    // Note: The FSR3 upscaler context is created on first use (see setSetting and initializeFSR3) rather than here, as this pass
+    // is constructed with the rest of the device objects and most users never enable FSR3.
   }
 
   DxvkFSR3::~DxvkFSR3() { }
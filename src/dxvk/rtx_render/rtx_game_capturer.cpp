@@ -50,6 +50,7 @@
 #include "rtx_matrix_helpers.h"
 #include "rtx_lights.h"
 
+#include <algorithm>
 #include <filesystem>
 
 #define BASE_DIR (util::RtxFileSys::path(util::RtxFileSys::Captures).string())
@@ -137,6 +138,8 @@ namespace dxvk {
     if (m_state.has<State::BeginExport>()) {
       exportUsd(ctx);
     }
+    // Kick off this frame's mesh buffer readbacks in one go
+    m_exporter.flushReadbacks(ctx);
   }
 
   void GameCapturer::setInstanceUpdateFlag(const RtInstance& rtInstance, const InstFlag flag) {
@@ -198,6 +201,7 @@ namespace dxvk {
 
     m_pCap->currentFrameNum += (frameTimeMilliseconds * 0.001f) * static_cast<float>(m_options.fps);
     captureFrame(ctx);
+    streamMeshes(*m_pCap, static_cast<float>(m_options.fps), static_cast<size_t>(maxMeshMemoryMiB()) << 20, false);
 
     if (m_pCap->numFramesCaptured >= m_options.numFrames) {
       m_state.set<State::BeginExport, true>();
@@ -381,12 +385,12 @@ namespace dxvk {
     for (const RtInstance* pRtInstance : m_sceneManager.getInstanceTable()) {
       assert(pRtInstance->getBlas() != nullptr);
 
-      const XXH64_hash_t instanceId = pRtInstance->getId();
-      if (instanceId == UINT64_MAX) {
+      if (pRtInstance->isCreatedByRenderer()) {
         // Ignore "virtual" instances, as they are used primarily for special render
         // passes, rather than representing real entities that we want captured
         continue;
       }
+      const XXH64_hash_t instanceId = pRtInstance->getId();
       assert(instanceId != UINT64_MAX);
 
       if (pRtInstance->getBlas()->input.cameraType == CameraType::Sky) {
@@ -463,6 +467,7 @@ namespace dxvk {
         m_pCap->meshes[meshHash] = std::make_shared<Mesh>();
         m_pCap->meshes[meshHash]->instanceCount = 0;
         m_pCap->meshes[meshHash]->matHash = matHash;
+        m_pCap->meshes[meshHash]->pCapturedBufferBytes = &m_pCap->numMeshBufferBytes;
       }
       instanceNum = m_pCap->meshes[meshHash]->instanceCount++;
     }
@@ -527,6 +532,12 @@ namespace dxvk {
       std::lock_guard lock(m_meshMutex);
       pMesh = m_pCap->meshes[currentMeshHash];
     }
+    if (pMesh->bStreamed) {
+      // Stage has been written already, there is nowhere to put the update
+      assert(!bIsNewMesh);
+      return;
+    }
+    pMesh->lastUpdateTime = m_pCap->currentFrameNum;
           
     // Note: Ensures that reading a Vec3 from the position buffer will result in the proper values. This can be extended if
     // games use odd formats like R32G32B32A32 in the future, but cannot be less than 3 components unless the code is modified
@@ -602,11 +613,10 @@ namespace dxvk {
                                           const float currentFrameNum,
                                           std::shared_ptr<Mesh> pMesh) {
                                             
-    AssetExporter::BufferCallback captureMeshPositionsAsync = [this, ctx, numVertices, inputPositionBuffer, currentFrameNum, pMesh](Rc<DxvkBuffer> posBuf) {
+    AssetExporter::BufferCallback captureMeshPositionsAsync = [this, ctx, numVertices, inputPositionBuffer, currentFrameNum, pMesh](const DxvkBufferSlice& positionBuffer) {
       // Prep helper vars
       constexpr size_t positionSubElementSize = sizeof(float);
       const size_t positionStride = inputPositionBuffer.stride() / positionSubElementSize;
-      const DxvkBufferSlice positionBuffer(posBuf, 0, posBuf->info().size);
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t)inputPositionBuffer.stride() + sizeof(pxr::GfVec3f)) <=
             (positionBuffer.length() - inputPositionBuffer.offsetFromSlice()));
@@ -648,12 +658,11 @@ namespace dxvk {
                                         const float currentFrameNum,
                                         std::shared_ptr<Mesh> pMesh) {
                                           
-    AssetExporter::BufferCallback captureMeshNormalsAsync = [ctx, numVertices, inputNormalBuffer, currentFrameNum, pMesh](Rc<DxvkBuffer> norBuf) {
+    AssetExporter::BufferCallback captureMeshNormalsAsync = [ctx, numVertices, inputNormalBuffer, currentFrameNum, pMesh](const DxvkBufferSlice& normalBuffer) {
       assert(inputNormalBuffer.vertexFormat() == VK_FORMAT_R32G32B32_SFLOAT);
       // Prep helper vars
       constexpr size_t normalSubElementSize = sizeof(float);
       const size_t normalStride = inputNormalBuffer.stride() / normalSubElementSize;
-      const DxvkBufferSlice normalBuffer(norBuf, 0, norBuf->info().size );
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t)inputNormalBuffer.stride() + sizeof(pxr::GfVec3f)) <=
             (normalBuffer.length() - inputNormalBuffer.offsetFromSlice()));
@@ -699,9 +708,8 @@ namespace dxvk {
                                         const lss::Camera& capCam,
                                         std::shared_ptr<Mesh> pMesh) {
 
-    AssetExporter::BufferCallback captureMeshIndicesAsync = [ctx, geomData, currentFrameNum, pMesh, capCam, this](Rc<DxvkBuffer> idxBuf) {
+    AssetExporter::BufferCallback captureMeshIndicesAsync = [ctx, geomData, currentFrameNum, pMesh, capCam, this](const DxvkBufferSlice& indexBuffer) {
       const size_t numIndices = geomData.indexCount;
-      const DxvkBufferSlice indexBuffer(idxBuf, 0, idxBuf->info().size);
       // Copy GPU buffer to local VtArray
       pxr::VtArray<int> indices;
       indices.reserve(numIndices);
@@ -746,14 +754,13 @@ namespace dxvk {
                                           const float currentFrameNum,
                                           std::shared_ptr<Mesh> pMesh) {
 
-    AssetExporter::BufferCallback captureMeshTexCoordsAsync = [ctx, geomData, currentFrameNum, pMesh](Rc<DxvkBuffer> texBuf) {
+    AssetExporter::BufferCallback captureMeshTexCoordsAsync = [ctx, geomData, currentFrameNum, pMesh](const DxvkBufferSlice& texcoordBuffer) {
       assert(geomData.texcoordBuffer.vertexFormat() == VK_FORMAT_R32G32_SFLOAT ||
              geomData.texcoordBuffer.vertexFormat() == VK_FORMAT_R32G32B32_SFLOAT);
       // Prep helper vars
       const size_t numVertices = geomData.vertexCount;
       constexpr size_t texcoordSubElementSize = sizeof(float);
       const size_t texcoordStride = geomData.texcoordBuffer.stride() / texcoordSubElementSize;
-      const DxvkBufferSlice texcoordBuffer(texBuf, 0, texBuf->info().size);
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t) geomData.texcoordBuffer.stride() + sizeof(pxr::GfVec2f)) <=
              (texcoordBuffer.length() - geomData.texcoordBuffer.offsetFromSlice()));
@@ -786,13 +793,12 @@ namespace dxvk {
                                       const float currentFrameNum,
                                       std::shared_ptr<Mesh> pMesh) {
 
-    AssetExporter::BufferCallback captureMeshColorAsync = [ctx, geomData, currentFrameNum, pMesh](Rc<DxvkBuffer> colBuf) {
+    AssetExporter::BufferCallback captureMeshColorAsync = [ctx, geomData, currentFrameNum, pMesh](const DxvkBufferSlice& colorBuffer) {
       assert(geomData.color0Buffer.vertexFormat() == VK_FORMAT_B8G8R8A8_UNORM);
       // Prep helper vars
       const size_t numVertices = geomData.vertexCount;
       constexpr size_t colorSubElementSize = sizeof(uint8_t);
       const size_t colorStride = geomData.color0Buffer.stride() / colorSubElementSize;
-      const DxvkBufferSlice colorBuffer(colBuf, 0, colBuf->info().size);
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t) geomData.color0Buffer.stride() + sizeof(uint8_t) * 3) <=
              (colorBuffer.length() - geomData.color0Buffer.offsetFromSlice()));
@@ -826,12 +832,11 @@ namespace dxvk {
                                          const RasterGeometry& geomData,
                                          const float currentFrameNum,
                                          std::shared_ptr<Mesh> pMesh) {
-    AssetExporter::BufferCallback captureMeshBlendWeightsAsync = [ctx, geomData, currentFrameNum, pMesh](Rc<DxvkBuffer> inBuf) {
+    AssetExporter::BufferCallback captureMeshBlendWeightsAsync = [ctx, geomData, currentFrameNum, pMesh](const DxvkBufferSlice& bufferSlice) {
       // Prep helper vars
       const size_t numVertices = geomData.vertexCount;
       const size_t bonesPerVertex = pMesh->lssData.bonesPerVertex;
       const size_t stride = geomData.blendWeightBuffer.stride() / sizeof(float);
-      const DxvkBufferSlice bufferSlice(inBuf, 0, inBuf->info().size);
       const VkFormat format = geomData.blendWeightBuffer.vertexFormat();
       if (bonesPerVertex <= 2) {
         assert(format == VK_FORMAT_R32_SFLOAT || format == VK_FORMAT_R32G32_SFLOAT || format == VK_FORMAT_R32G32B32_SFLOAT);
@@ -868,13 +873,12 @@ namespace dxvk {
       // Cache buffer iff new buffer differs from previous buffer
       evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.blendWeightBufs, targetBuffer, currentFrameNum, weightsDifferentEnough);
     };
-    AssetExporter::BufferCallback captureMeshBlendIndicesAsync = [ctx, geomData, currentFrameNum, pMesh](Rc<DxvkBuffer> inBuf) {
+    AssetExporter::BufferCallback captureMeshBlendIndicesAsync = [ctx, geomData, currentFrameNum, pMesh](const DxvkBufferSlice& bufferSlice) {
       assert(geomData.blendIndicesBuffer.vertexFormat() == VK_FORMAT_R8G8B8A8_USCALED);
       // Prep helper vars
       const size_t numVertices = geomData.vertexCount;
       const size_t bonesPerVertex = pMesh->lssData.bonesPerVertex;
       const size_t stride = geomData.blendIndicesBuffer.stride() / sizeof(uint8_t);
-      const DxvkBufferSlice bufferSlice(inBuf, 0, inBuf->info().size);
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t) geomData.blendIndicesBuffer.stride() + sizeof(uint8_t) * bonesPerVertex) <=
              (bufferSlice.length() - geomData.blendIndicesBuffer.offsetFromSlice()));
@@ -931,6 +935,11 @@ namespace dxvk {
     }
     // Cache VtArray if there is a large enough delta
     if (bSufficientlyDifferent) {
+      const size_t numBytes = newBuffer.size() * sizeof(T);
+      pMesh->numBufferBytes += numBytes;
+      if (pMesh->pCapturedBufferBytes != nullptr) {
+        *pMesh->pCapturedBufferBytes += numBytes;
+      }
       bufferCache[currentFrameNum] = std::move(newBuffer);
     }
     pMesh->meshSync.numOutstanding--;
@@ -952,6 +961,9 @@ namespace dxvk {
       const float texExportTimeout = numTexExportsInProgress * kTimePerTexExport;
       m_exporter.waitForAllExportsToComplete(texExportTimeout);
       assert(pState->has<State::PreppingExport>());
+      // Write out the remaining mesh stages in parallel, exportUsd then only references them
+      streamMeshes(cap, framesPerSecond, 0, true);
+      waitForStreamedMeshes(cap);
       const auto exportPrep = prepExport(cap, framesPerSecond);
       pState->set<State::PreppingExport, false>();
       pState->set<State::Exporting, true>();
@@ -982,6 +994,95 @@ namespace dxvk {
                 static_cast<float>(m_options.fps)).detach();
   }
 
+  void GameCapturer::streamMeshes(Capture& cap,
+                                  const float framesPerSecond,
+                                  const size_t maxBufferBytes,
+                                  const bool bWaitForReadbacks) {
+    if (cap.numMeshBufferBytes.load() <= maxBufferBytes) {
+      return;
+    }
+
+    // Meshes that have not been updated in a while are the least likely to be updated again
+    std::vector<std::shared_ptr<Mesh>> candidates;
+    {
+      std::lock_guard lock(m_meshMutex);
+      for (auto& [hash, pMesh] : cap.meshes) {
+        // Skeletons are generated from the mesh buffers at export time
+        if (!pMesh->bStreamed && pMesh->lssData.numBones == 0) {
+          candidates.push_back(pMesh);
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::shared_ptr<Mesh>& a, const std::shared_ptr<Mesh>& b) { return a->lastUpdateTime < b->lastUpdateTime; });
+
+    lss::Export exportPrep;
+    prepExportMetaData(cap, framesPerSecond, exportPrep);
+    prepExportMaterials(cap, exportPrep);
+    if (exportPrep.bExportInstanceStage) {
+      exportPrep.camera = cap.camera;
+    }
+    const auto pExportPrep = std::make_shared<const lss::Export>(std::move(exportPrep));
+
+    if (m_pStreamThreads == nullptr) {
+      m_pStreamThreads = std::make_unique<StreamThreadPool>(2, "rtx-capture-mesh-stream");
+    }
+
+    // Go well below the budget, so that the next few frames don't each stream a mesh or two
+    const size_t targetBufferBytes = maxBufferBytes / 2;
+    size_t numStreamed = 0;
+    for (const std::shared_ptr<Mesh>& pMesh : candidates) {
+      if (cap.numMeshBufferBytes.load() <= targetBufferBytes) {
+        break;
+      }
+      std::unique_lock lock(pMesh->meshSync.mutex);
+      if (bWaitForReadbacks) {
+        pMesh->meshSync.cond.wait(lock,
+          [pNumOutstanding = &pMesh->meshSync.numOutstanding] { return *pNumOutstanding == 0; });
+      } else if (pMesh->meshSync.numOutstanding > 0) {
+        continue;
+      }
+      if (pMesh->lssData.numIndices == 0 && pMesh->lssData.numVertices == 0) {
+        continue;
+      }
+
+      // VtArrays are shared on copy, the buffers are freed once the stage has been written
+      auto pLssMesh = std::make_shared<lss::Mesh>(pMesh->lssData);
+      if (cap.materials.count(pMesh->matHash) > 0) {
+        pLssMesh->matId = pMesh->matHash;
+      }
+      if (correctBakedTransforms()) {
+        pLssMesh->origin = pMesh->originCalc.calc();
+      }
+      pMesh->lssData.buffers = lss::MeshBuffers();
+      pMesh->lssData.bStageExported = true;
+      pMesh->bStreamed = true;
+      cap.numMeshBufferBytes -= pMesh->numBufferBytes;
+      pMesh->numBufferBytes = 0;
+      lock.unlock();
+
+      cap.streamSync.numOutstandingInc();
+      const auto result = m_pStreamThreads->Schedule([pExportPrep, pLssMesh, pStreamSync = &cap.streamSync] {
+        lss::GameExporter::exportMeshStage(*pExportPrep, *pLssMesh);
+        pStreamSync->numOutstandingDec();
+      });
+      if (!result.valid()) {
+        // Too many in flight, write this one right away
+        lss::GameExporter::exportMeshStage(*pExportPrep, *pLssMesh);
+        cap.streamSync.numOutstandingDec();
+      }
+      ++numStreamed;
+    }
+    Logger::debug(str::format("[GameCapturer][", cap.idStr, "] Streamed ", numStreamed, " meshes, ",
+                              cap.numMeshBufferBytes.load() >> 20, " MiB of mesh buffers left in memory"));
+  }
+
+  void GameCapturer::waitForStreamedMeshes(Capture& cap) {
+    std::unique_lock lock(cap.streamSync.mutex);
+    cap.streamSync.cond.wait(lock,
+      [pNumOutstanding = &cap.streamSync.numOutstanding] { return *pNumOutstanding == 0; });
+  }
+
   lss::Export GameCapturer::prepExport(const Capture& cap,
                                              const float framesPerSecond) {
     lss::Export exportPrep;
@@ -79,12 +79,14 @@
 #include "../../util/rc/util_rc.h"
 #include "../../util/util_flags.h"
 #include "../../util/util_matrix.h"
+#include "../../util/util_threadpool.h"
 #include "../../util/xxHash/xxhash.h"
 #include "../imgui/dxvk_imgui.h"
 
 #include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
 
 namespace dxvk 
 {
@@ -114,6 +116,11 @@ public:
                 "to all have identity xform matrices, enabling will attempt to correct this and\n"
                 "improve stage + mesh viewability in tools.\n"
                 "Hashes are unaffected.");
+  RTX_OPTION("rtx.capture", uint32_t, maxMeshMemoryMiB, 2048,
+                "Upper bound for the mesh buffers a capture keeps in memory, in mebibytes. Once exceeded,\n"
+                "meshes that are done reading back are written to their USD layers on worker threads and\n"
+                "released, least recently updated first. Multi-frame updates to a written mesh are dropped.\n"
+                "Skinned meshes are always kept until the end of the capture.");
 
   GameCapturer(DxvkDevice* const pDevice, SceneManager& sceneManager, AssetExporter& exporter);
   ~GameCapturer();
@@ -188,6 +195,12 @@ private:
     XXH64_hash_t     matHash;
     MeshSync         meshSync;
     AtomicOriginCalc originCalc;
+    // Size of the cached buffers, guarded by meshSync.mutex. Also accumulated into the capture's total.
+    size_t               numBufferBytes = 0;
+    std::atomic<size_t>* pCapturedBufferBytes = nullptr;
+    float            lastUpdateTime = 0.f;
+    // Stage already written out and buffers released, see streamMeshes()
+    bool             bStreamed = false;
   };
 
   struct Instance {
@@ -255,6 +268,11 @@ private:
                                     CompareTReturnBool compareT);
   void exportUsd(const Rc<DxvkContext> ctx);
   struct Capture;
+  void streamMeshes(Capture& cap,
+                    const float framesPerSecond,
+                    const size_t maxBufferBytes,
+                    const bool bWaitForReadbacks);
+  void waitForStreamedMeshes(Capture& cap);
   static lss::Export prepExport(const Capture& cap,
                                 const float framesPerSecond);
   static void prepExportMetaData(const Capture& cap,
@@ -316,6 +334,12 @@ private:
   SceneManager& m_sceneManager; // We only use SceneManager get()ers, but none are const
   AssetExporter& m_exporter;
 
+  // Writes streamed mesh stages. Only one thread schedules at any time: the render thread
+  // while capturing, then the export thread of that capture.
+  inline static const size_t kMaxStreamedMeshesInFlight = 1024;
+  using StreamThreadPool = WorkerThreadPool<kMaxStreamedMeshesInFlight, false, false>;
+  std::unique_ptr<StreamThreadPool> m_pStreamThreads;
+
   // Capturing
   dxvk::mutex m_meshMutex;
   struct Capture {
@@ -337,6 +361,8 @@ private:
     std::unordered_map<XXH64_hash_t, Instance> instances;
     std::unordered_map<XXH64_hash_t, uint8_t> instanceFlags;
     HWND hwnd;
+    std::atomic<size_t> numMeshBufferBytes = 0;
+    MeshSync streamSync;
   };
   std::unique_ptr<Capture> m_pCap;
 };
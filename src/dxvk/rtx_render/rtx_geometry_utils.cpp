@@ -73,6 +73,7 @@ namespace dxvk {
         STRUCTURED_BUFFER(BINDING_BLEND_INDICES_INPUT)
         RW_STRUCTURED_BUFFER(BINDING_NORMAL_OUTPUT)
         STRUCTURED_BUFFER(BINDING_NORMAL_INPUT)
+        STRUCTURED_BUFFER(BINDING_BONE_PALETTE_INPUT)
       END_PARAMETER()
     };
 
@@ -218,6 +219,22 @@ namespace dxvk {
       }
       return result;
     }
+
+    // Writes geometry data produced on the CPU to the start of a geometry buffer. Buffers that were just created and are not
+    // referenced by any command yet are filled through the context's upload path, which runs ahead of all other commands of the
+    // submission and synchronizes every such upload with the barriers recorded once at the end of the submission. Otherwise the
+    // data is written in place, which interrupts the current render pass and needs a barrier of its own.
+    void uploadGeometryData(const Rc<DxvkContext>& ctx, const Rc<DxvkBuffer>& buffer, VkDeviceSize size, const void* data, bool isNewBuffer) {
+      if (size == 0) {
+        return;
+      }
+
+      if (isNewBuffer) {
+        ctx->uploadBuffer(buffer, data, uint32_t(size));
+      } else {
+        ctx->writeToBuffer(buffer, 0, size, data);
+      }
+    }
   }
 
   RtxGeometryUtils::RtxGeometryUtils(DxvkDevice* device) : CommonDeviceObject(device) {
@@ -227,6 +244,14 @@ namespace dxvk {
       (VkMemoryPropertyFlagBits) (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT),
       VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
+    // Note: All skinned draws of a frame share this buffer for their bone palettes, each draw only takes up as many matrices as it has bones.
+    m_pBonePaletteData = std::make_unique<RtxStagingDataAlloc>(
+      device,
+      "RtxStagingDataAlloc: Skinning Bone Palettes",
+      (VkMemoryPropertyFlagBits) (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_READ_BIT, device->properties().core.properties.limits.minStorageBufferOffsetAlignment);
+
     m_skinningContext = device->createContext();
   }
 
@@ -234,6 +259,7 @@ namespace dxvk {
 
   void RtxGeometryUtils::onDestroy() {
     m_pCbData = nullptr;
+    m_pBonePaletteData = nullptr;
     m_skinningContext = nullptr;
   }
 
@@ -255,8 +281,6 @@ namespace dxvk {
     assert(normalVertexFormat == VK_FORMAT_R32G32B32_SFLOAT || normalVertexFormat == VK_FORMAT_R32G32B32A32_SFLOAT || normalVertexFormat == VK_FORMAT_R32_UINT);
     assert(drawCallState.getGeometryData().blendWeightBuffer.defined());
 
-    memcpy(&params.bones[0], &drawCallState.getSkinningState().pBoneMatrices[0], sizeof(Matrix4) * drawCallState.getSkinningState().numBones);
-
     params.dstPositionStride = geo.positionBuffer.stride();
     params.dstPositionOffset = geo.positionBuffer.offsetFromSlice();
     params.dstNormalStride = geo.normalBuffer.stride();
@@ -301,7 +325,13 @@ namespace dxvk {
       memcpy(cb.mapPtr(0), &params, sizeof(SkinningArgs));
       ctx->getCommandList()->trackResource<DxvkAccess::Write>(cb.buffer());
 
+      const VkDeviceSize bonePaletteSize = sizeof(Matrix4) * drawCallState.getSkinningState().numBones;
+      DxvkBufferSlice bonePalette = m_pBonePaletteData->alloc(devInfo.limits.minStorageBufferOffsetAlignment, bonePaletteSize);
+      memcpy(bonePalette.mapPtr(0), drawCallState.getSkinningState().pBoneMatrices.data(), bonePaletteSize);
+      ctx->getCommandList()->trackResource<DxvkAccess::Write>(bonePalette.buffer());
+
       ctx->bindResourceBuffer(BINDING_SKINNING_CONSTANTS, cb);
+      ctx->bindResourceBuffer(BINDING_BONE_PALETTE_INPUT, bonePalette);
       ctx->bindResourceBuffer(BINDING_POSITION_OUTPUT, geo.positionBuffer);
       ctx->bindResourceBuffer(BINDING_POSITION_INPUT, drawCallState.getGeometryData().positionBuffer);
       ctx->bindResourceBuffer(BINDING_NORMAL_OUTPUT, geo.normalBuffer);
@@ -316,6 +346,7 @@ namespace dxvk {
       const VkExtent3D workgroups = util::computeBlockCount(VkExtent3D { params.numVertices, 1, 1 }, VkExtent3D { 128, 1, 1 });
       ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
       ctx->getCommandList()->trackResource<DxvkAccess::Read>(cb.buffer());
+      ctx->getCommandList()->trackResource<DxvkAccess::Read>(bonePalette.buffer());
     } else {
       const float* srcPosition = reinterpret_cast<float*>(drawCallState.getGeometryData().positionBuffer.mapPtr(0));
       const float* srcNormal = reinterpret_cast<float*>(drawCallState.getGeometryData().normalBuffer.mapPtr(0));
@@ -332,7 +363,7 @@ namespace dxvk {
       float dstNormal[3];
 
       for (uint32_t idx = 0; idx < params.numVertices; idx++) {
-        skinning(idx, &dstPosition[0], &dstNormal[0], srcPosition, srcBlendWeight, srcBlendIndices, srcNormal, params);
+        skinning(idx, &dstPosition[0], &dstNormal[0], srcPosition, srcBlendWeight, srcBlendIndices, srcNormal, drawCallState.getSkinningState().pBoneMatrices.data(), params);
 
         ctx->writeToBuffer(geo.positionBuffer.buffer(), geo.positionBuffer.offsetFromSlice() + idx * geo.positionBuffer.stride(), sizeof(dstPosition), &dstPosition[0]);
         ctx->writeToBuffer(geo.normalBuffer.buffer(), geo.normalBuffer.offsetFromSlice() + idx * geo.normalBuffer.stride(), sizeof(dstNormal), &dstNormal[0]);
@@ -656,18 +687,18 @@ namespace dxvk {
     return (vertexCount < 64 * 1024) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
   }
 
-  bool RtxGeometryUtils::cacheIndexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output) {
+  bool RtxGeometryUtils::cacheIndexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output, bool isNewBuffer) {
     ScopedCpuProfileZone();
     // Handle index buffer replacement - since the BVH builder does not support legacy primitive topology
     if (input.isTopologyRaytraceReady()) {
       ctx->copyBuffer(output.indexCacheBuffer, 0, input.indexBuffer.buffer(), input.indexBuffer.offset() + input.indexBuffer.offsetFromSlice(), input.indexCount * input.indexBuffer.stride());
     } else {
-      return RtxGeometryUtils::generateTriangleList(ctx, input, output.indexCacheBuffer);
+      return RtxGeometryUtils::generateTriangleList(ctx, input, output.indexCacheBuffer, isNewBuffer);
     }
     return true;
   }
 
-  bool RtxGeometryUtils::generateTriangleList(const Rc<DxvkContext>& ctx, const RasterGeometry& input, Rc<DxvkBuffer> output) {
+  bool RtxGeometryUtils::generateTriangleList(const Rc<DxvkContext>& ctx, const RasterGeometry& input, Rc<DxvkBuffer> output, bool isNewBuffer) {
     ScopedCpuProfileZone();
 
     const uint32_t indexCount = getOptimalTriangleListSize(input);
@@ -693,7 +724,7 @@ namespace dxvk {
     pushArgs.minVertex = 0;
     pushArgs.maxVertex = input.vertexCount - 1;
 
-    ctx->getCommonObjects()->metaGeometryUtils().dispatchGenTriList(ctx, pushArgs, DxvkBufferSlice(output), pushArgs.useIndexBuffer ? &input.indexBuffer : nullptr);
+    ctx->getCommonObjects()->metaGeometryUtils().dispatchGenTriList(ctx, pushArgs, DxvkBufferSlice(output), pushArgs.useIndexBuffer ? &input.indexBuffer : nullptr, isNewBuffer);
 
     if (indexCount % 3 != 0) {
       ONCE(Logger::err(str::format("Generating indices for a mesh which has non triangle topology: (indices%3) != 0, geometry hash = 0x", std::hex, input.getHashForRule(RtxOptions::geometryAssetHashRule()))));
@@ -703,7 +734,7 @@ namespace dxvk {
     return true;
   }
 
-  void RtxGeometryUtils::dispatchGenTriList(const Rc<DxvkContext>& ctx, const GenTriListArgs& cb, const DxvkBufferSlice& dstSlice, const RasterBuffer* srcBuffer) const {
+  void RtxGeometryUtils::dispatchGenTriList(const Rc<DxvkContext>& ctx, const GenTriListArgs& cb, const DxvkBufferSlice& dstSlice, const RasterBuffer* srcBuffer, bool isNewBuffer) const {
     ScopedGpuProfileZone(ctx, "generateTriangleList");
     // At some point, its more efficient to do these calculations on the GPU, this limit is somewhat arbitrary however, and might require better tuning...
     const uint32_t kNumTrianglesToProcessOnCPU = 512;
@@ -732,7 +763,7 @@ namespace dxvk {
         generateIndices(idx, dst, src, cb);
       }
 
-      ctx->writeToBuffer(dstSlice.buffer(), 0, cb.primCount * 3 * sizeof(uint16_t), dst);
+      uploadGeometryData(ctx, dstSlice.buffer(), cb.primCount * 3 * sizeof(uint16_t), dst, isNewBuffer);
     }
   }
 
@@ -787,7 +818,7 @@ namespace dxvk {
     return stride;
   }
 
-  void RtxGeometryUtils::cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output) {
+  void RtxGeometryUtils::cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output, bool isNewBuffer) {
     ScopedCpuProfileZone();
     if (input.isVertexDataInterleaved() && input.areFormatsGpuFriendly()) {
       const size_t vertexBufferSize = input.vertexCount * input.positionBuffer.stride();
@@ -797,6 +828,7 @@ namespace dxvk {
     } else {
       RtxGeometryUtils::InterleavedGeometryDescriptor interleaveResult;
       interleaveResult.buffer = output.historyBuffer[0];
+      interleaveResult.isNewBuffer = isNewBuffer;
 
       ctx->getCommonObjects()->metaGeometryUtils().interleaveGeometry(ctx, input, interleaveResult);
 
@@ -905,7 +937,7 @@ namespace dxvk {
         interleaver::interleave(i, dst, inputData.positionData, inputData.normalData, inputData.texcoordData, inputData.vertexColorData, args);
       }
 
-      ctx->writeToBuffer(output.buffer, 0, input.vertexCount * output.stride, dst);
+      uploadGeometryData(ctx, output.buffer, input.vertexCount * output.stride, dst, output.isNewBuffer);
     }
 
     uint32_t offset = 0;
@@ -48,6 +48,7 @@ namespace dxvk {
   */
   class RtxGeometryUtils : public CommonDeviceObject {
     std::unique_ptr<RtxStagingDataAlloc> m_pCbData;
+    std::unique_ptr<RtxStagingDataAlloc> m_pBonePaletteData;
     Rc<DxvkContext> m_skinningContext;
     uint32_t m_skinningCommands = 0;
 
@@ -151,19 +152,21 @@ namespace dxvk {
       uint32_t texcoordOffset = 0;
       bool hasColor0 = false;
       uint32_t color0Offset = 0;
+      // Set when the buffer was just created and nothing has used it yet, see uploadGeometryData
+      bool isNewBuffer = false;
     };
 
     // Helpers for promoting Geometry Snapshots from raster pipeline to Geometry Data for RT pipeline
     // Index related:
     static uint32_t getOptimalTriangleListSize(const RasterGeometry& input);
     static VkIndexType getOptimalIndexFormat(uint32_t vertexCount);
-    static bool cacheIndexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output);
-    static bool generateTriangleList(const Rc<DxvkContext>& ctx, const RasterGeometry& input, Rc<DxvkBuffer> output);
+    static bool cacheIndexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output, bool isNewBuffer);
+    static bool generateTriangleList(const Rc<DxvkContext>& ctx, const RasterGeometry& input, Rc<DxvkBuffer> output, bool isNewBuffer);
     // Vertex related:
     static void processGeometryBuffers(const InterleavedGeometryDescriptor& desc, RaytraceGeometry& output);
     static void processGeometryBuffers(const RasterGeometry& input, RaytraceGeometry& output);
     static size_t computeOptimalVertexStride(const RasterGeometry& input);
-    static void cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output);
+    static void cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output, bool isNewBuffer);
     
     // Calculate the maximum UV tile size (i.e. minimum UV density) of a draw call.
     static float computeMaxUVTileSize(const RasterGeometry& input, const Matrix4& objectToWorld);
@@ -171,7 +174,7 @@ namespace dxvk {
     /**
      * \brief Execute a compute shader to generate a triangle list from arbitrary topologies
      */
-    void dispatchGenTriList(const Rc<DxvkContext>& ctx, const GenTriListArgs& args, const DxvkBufferSlice& dst, const RasterBuffer* srcBuffer) const;
+    void dispatchGenTriList(const Rc<DxvkContext>& ctx, const GenTriListArgs& args, const DxvkBufferSlice& dst, const RasterBuffer* srcBuffer, bool isNewBuffer = false) const;
     
     /**
       * \brief Execute a compute shader to interleave vertex data into a single buffer
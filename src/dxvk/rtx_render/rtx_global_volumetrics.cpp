@@ -181,6 +181,9 @@ namespace dxvk {
     RTX_OPTION_CLAMP_MIN(froxelMaxDistanceMeters, 0.0f);
     // Note: Clamp to positive values as negative luminance thresholds are not valid.
     RTX_OPTION_CLAMP_MIN(froxelFireflyFilteringLuminanceThreshold, 0.0f);
+    RTX_OPTION_CLAMP(stableFroxelUpdateInterval, static_cast<uint8_t>(1), std::numeric_limits<uint8_t>::max());
+    RTX_OPTION_CLAMP(stableFroxelMinHistoryAge, 0.0f, 1.0f);
+    RTX_OPTION_CLAMP(densityAdaptiveFroxelDistanceMinTransmittance, 1e-6f, 1.0f);
 
     RTX_OPTION_CLAMP_MIN(initialRISSampleCount, static_cast<uint32_t>(1));
     RTX_OPTION_CLAMP(temporalReuseMaxSampleCount, static_cast<uint16_t>(1), std::numeric_limits<uint16_t>::max());
@@ -275,6 +278,12 @@ namespace dxvk {
         ImGui::DragFloat("Froxel Depth Slice Distribution Exponent", &froxelDepthSliceDistributionExponentObject(), 0.01f, 0.0f, FLT_MAX, "%.3f", ImGuiSliderFlags_AlwaysClamp);
         ImGui::DragFloat("Froxel Max Distance", &froxelMaxDistanceMetersObject(), 0.25f, 0.0f, FLT_MAX, "%.2f", ImGuiSliderFlags_AlwaysClamp);
         ImGui::DragFloat("Froxel Firefly Filtering Luminance Threshold", &froxelFireflyFilteringLuminanceThresholdObject(), 0.1f, 0.0f, FLT_MAX, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::DragInt("Stable Froxel Update Interval", &stableFroxelUpdateIntervalObject(), 0.1f, 1, UINT8_MAX);
+        ImGui::DragFloat("Stable Froxel Min History Age", &stableFroxelMinHistoryAgeObject(), 0.01f, 0.0f, 1.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::Checkbox("Density Adaptive Froxel Distance", &enableDensityAdaptiveFroxelDistanceObject());
+        ImGui::BeginDisabled(!enableDensityAdaptiveFroxelDistance());
+        ImGui::DragFloat("Density Adaptive Froxel Distance Min Transmittance", &densityAdaptiveFroxelDistanceMinTransmittanceObject(), 0.001f, 1e-6f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::EndDisabled();
         ImGui::Checkbox("Per-Portal Volumes", &enableInPortalsObject());
 
         ImGui::Separator();
@@ -591,6 +600,18 @@ namespace dxvk {
     volumeArgs.maxAccumulationFrames = static_cast<uint16_t>(maxAccumulationFrames());
     volumeArgs.froxelDepthSliceDistributionExponent = froxelDepthSliceDistributionExponent();
     volumeArgs.froxelMaxDistance = froxelMaxDistanceMeters() * RtxOptions::getMeterToWorldUnitScale();
+
+    // Note: Beyond the distance at which homogeneous fog has attenuated light down to the minimum transmittance the in-scattered
+    // radiance hardly changes anymore, so the depth slices are better spent closer to the camera. Heterogeneous fog and the atmosphere
+    // vary the density away from the base attenuation coefficient so the grid is left at its full extent for them.
+    if (enableDensityAdaptiveFroxelDistance() && !enableHeterogeneousFog() && !enableAtmosphere()) {
+      const float minAttenuationCoefficient = std::min({ volumetricAttenuationCoefficient.x, volumetricAttenuationCoefficient.y, volumetricAttenuationCoefficient.z });
+
+      if (minAttenuationCoefficient > 0.0f) {
+        const float opaqueDistance = -log(densityAdaptiveFroxelDistanceMinTransmittance()) / minAttenuationCoefficient;
+        volumeArgs.froxelMaxDistance = std::min(volumeArgs.froxelMaxDistance, opaqueDistance);
+      }
+    }
     volumeArgs.froxelFireflyFilteringLuminanceThreshold = froxelFireflyFilteringLuminanceThreshold();
     volumeArgs.attenuationCoefficient = volumetricAttenuationCoefficient;
     volumeArgs.enable = enable() && canUsePhysicalFog;
@@ -672,6 +693,9 @@ namespace dxvk {
     // Note: We need to invalidate the volumetric history buffers (radiance and age buffers) when detecting camera cut to avoid accumulating the history from different scenes
     volumeArgs.resetHistory = cameraManager.getMainCamera().isCameraCut();
 
+    volumeArgs.stableFroxelUpdateInterval = enableReferenceMode() ? 1 : stableFroxelUpdateInterval();
+    volumeArgs.stableFroxelMinHistoryAge = stableFroxelMinHistoryAge();
+
     return volumeArgs;
   }
 
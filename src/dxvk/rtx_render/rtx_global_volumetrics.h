@@ -96,6 +96,17 @@ namespace dxvk {
     RTX_OPTION("rtx.volumetrics", float, froxelDepthSliceDistributionExponent, 2.0f, "The exponent to use on depth values to nonlinearly distribute froxels away from the camera. Higher values bias more froxels closer to the camera with 1 being linear.");
     RTX_OPTION("rtx.volumetrics", float, froxelMaxDistanceMeters, 20.0f, "The maximum distance in world units to allocate the froxel grid out to. Should be less than the distance between the camera's near and far plane, as the froxel grid will clip to the far plane otherwise.  The unit of measurement is meters.");
     RTX_OPTION("rtx.volumetrics", float, froxelFireflyFilteringLuminanceThreshold, 1000.0f, "Sets the maximum luminance threshold for the volumetric firefly filtering to clamp to.");
+    RTX_OPTION("rtx.volumetrics", uint8_t, stableFroxelUpdateInterval, 1,
+               "The number of frames between lighting updates of froxels with long, successfully reprojected histories (see rtx.volumetrics.stableFroxelMinHistoryAge). "
+               "In between updates such froxels only reproject their history, with the froxels updated on a given frame spread evenly throughout the grid.\n"
+               "A value of 1 updates every froxel every frame. Larger values reduce the cost of volumetric integration in static scenes at the cost of slower reaction to lighting changes.");
+    RTX_OPTION("rtx.volumetrics", float, stableFroxelMinHistoryAge, 0.5f,
+               "The normalized [0, 1] history age a froxel's reprojected history must have for the froxel to be considered stable and be updated at the rtx.volumetrics.stableFroxelUpdateInterval rate.");
+    RTX_OPTION("rtx.volumetrics", bool, enableDensityAdaptiveFroxelDistance, false,
+               "Limits the distance the froxel grid is allocated out to (rtx.volumetrics.froxelMaxDistanceMeters) to the distance at which the fog's transmittance falls to rtx.volumetrics.densityAdaptiveFroxelDistanceMinTransmittance, "
+               "so that in dense fog the depth slices are spent on the range the fog is actually visible in. Only applies to homogeneous fog without the atmosphere enabled.");
+    RTX_OPTION("rtx.volumetrics", float, densityAdaptiveFroxelDistanceMinTransmittance, 0.01f,
+               "The transmittance beyond which the froxel grid is not extended when rtx.volumetrics.enableDensityAdaptiveFroxelDistance is enabled. Lower values extend the grid further into dense fog.");
     RTX_OPTION("rtx.volumetrics", uint32_t, initialRISSampleCount, 32,
                "The number of RIS samples to select from the global pool of lights when constructing a Reservoir sample.\n"
                "Higher values generally increases the quality of the selected light sample, though similar to the general RIS light sample count has diminishing returns.");
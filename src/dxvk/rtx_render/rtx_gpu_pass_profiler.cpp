@@ -0,0 +1,286 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <iomanip>
+
+#include "rtx_gpu_pass_profiler.h"
+#include "dxvk_device.h"
+#include "dxvk_context.h"
+#include "dxvk_scoped_annotation.h"
+
+namespace dxvk {
+
+  RtxGpuPassProfiler::RtxGpuPassProfiler(DxvkDevice* device)
+    : CommonDeviceObject(device) {
+  }
+
+  RtxGpuPassProfiler::~RtxGpuPassProfiler() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+      m_device->vkd()->vkDestroyQueryPool(m_device->handle(), m_queryPool, nullptr);
+    }
+  }
+
+  bool RtxGpuPassProfiler::createQueryPool() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+      return true;
+    }
+
+    // Queries are reset from the host at the start of a frame so that zones may be recorded inside of render passes
+    if (!m_device->features().vulkan12Features.hostQueryReset) {
+      ONCE(Logger::warn("GPU pass profiler: hostQueryReset is not supported, GPU timings are not available."));
+      return false;
+    }
+
+    VkQueryPoolCreateInfo info;
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.pNext = nullptr;
+    info.flags = 0;
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = kQueriesPerFrame * kMaxFramesInFlight;
+    info.pipelineStatistics = 0;
+
+    if (m_device->vkd()->vkCreateQueryPool(m_device->handle(), &info, nullptr, &m_queryPool) != VK_SUCCESS) {
+      ONCE(Logger::err("GPU pass profiler: vkCreateQueryPool failed"));
+      m_queryPool = VK_NULL_HANDLE;
+      return false;
+    }
+
+    m_msPerTick = double(m_device->adapter()->deviceProperties().limits.timestampPeriod) / 1000000.0;
+    return true;
+  }
+
+  uint32_t RtxGpuPassProfiler::beginZone(DxvkContext* ctx, const char* name) {
+    std::lock_guard lock(m_mutex);
+
+    const uint32_t frameId = m_device->getCurrentFrameId();
+    if (frameId != m_currentFrameId) {
+      beginFrame(frameId);
+    }
+
+    FrameData& frame = m_frames[m_frameIdx];
+    if (!m_recording || frame.zones.size() >= kMaxZonesPerFrame) {
+      return kInvalidZone;
+    }
+
+    const uint32_t zoneIdx = frame.zones.size();
+    frame.zones.push_back({ name, m_depth++, false, std::chrono::steady_clock::now() });
+
+    m_device->vkd()->vkCmdWriteTimestamp(ctx->getCmdBuffer(DxvkCmdBuffer::ExecBuffer),
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, m_frameIdx * kQueriesPerFrame + zoneIdx * 2);
+
+    return m_frameIdx * kMaxZonesPerFrame + zoneIdx;
+  }
+
+  void RtxGpuPassProfiler::endZone(DxvkContext* ctx, uint32_t zone) {
+    if (zone == kInvalidZone) {
+      return;
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    const uint32_t frameIdx = zone / kMaxZonesPerFrame;
+    const uint32_t zoneIdx = zone % kMaxZonesPerFrame;
+
+    // Zones that span a frame boundary still end in the range of the frame they began in
+    Zone& endedZone = m_frames[frameIdx].zones[zoneIdx];
+    endedZone.ended = true;
+    endedZone.cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - endedZone.cpuBegin).count();
+    if (frameIdx == m_frameIdx && m_depth > 0) {
+      --m_depth;
+    }
+
+    m_device->vkd()->vkCmdWriteTimestamp(ctx->getCmdBuffer(DxvkCmdBuffer::ExecBuffer),
+      VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, frameIdx * kQueriesPerFrame + zoneIdx * 2 + 1);
+  }
+
+  std::vector<RtxGpuPassProfiler::PassTiming> RtxGpuPassProfiler::getLatestTimings(uint32_t& frameId) const {
+    std::lock_guard lock(m_mutex);
+    frameId = m_latestFrameId;
+    return m_latestTimings;
+  }
+
+  void RtxGpuPassProfiler::beginFrame(uint32_t frameId) {
+    m_currentFrameId = frameId;
+    m_depth = 0;
+    m_recording = false;
+
+    if (!createQueryPool()) {
+      return;
+    }
+
+    m_frameIdx = (m_frameIdx + 1) % kMaxFramesInFlight;
+    FrameData& frame = m_frames[m_frameIdx];
+
+    if (frame.pending) {
+      if (!readBack(frame)) {
+        // The GPU is still behind, leave this frame unmeasured and try again once the range comes around again
+        return;
+      }
+
+      writeCsv(frame.frameId);
+      if (frameCount() > 0 && !m_benchmarkDone) {
+        addBenchmarkFrame();
+      }
+    }
+
+    m_device->vkd()->vkResetQueryPool(m_device->handle(), m_queryPool, m_frameIdx * kQueriesPerFrame, kQueriesPerFrame);
+
+    frame.frameId = frameId;
+    frame.pending = true;
+    frame.zones.clear();
+    m_recording = true;
+  }
+
+  bool RtxGpuPassProfiler::readBack(FrameData& frame) {
+    ScopedCpuProfileZone();
+    const uint32_t frameIdx = uint32_t(&frame - m_frames.data());
+    const uint32_t queryCount = uint32_t(frame.zones.size()) * 2;
+
+    if (queryCount != 0) {
+      // Pairs of timestamp and availability, queries of zones that were never ended are not available
+      std::array<std::array<uint64_t, 2>, kQueriesPerFrame> results;
+
+      const VkResult res = m_device->vkd()->vkGetQueryPoolResults(m_device->handle(), m_queryPool,
+        frameIdx * kQueriesPerFrame, queryCount, queryCount * sizeof(results[0]), results.data(), sizeof(results[0]),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+      if (res != VK_SUCCESS && res != VK_NOT_READY) {
+        return false;
+      }
+
+      for (uint32_t i = 0; i < frame.zones.size(); i++) {
+        if (frame.zones[i].ended && (results[i * 2][1] == 0 || results[i * 2 + 1][1] == 0)) {
+          return false;
+        }
+      }
+
+      std::vector<PassTiming> timings;
+      timings.reserve(frame.zones.size());
+
+      for (uint32_t i = 0; i < frame.zones.size(); i++) {
+        const Zone& zone = frame.zones[i];
+        if (!zone.ended) {
+          continue;
+        }
+
+        const uint64_t ticks = results[i * 2 + 1][0] - results[i * 2][0];
+        timings.push_back({ zone.name, zone.depth, float(double(ticks) * m_msPerTick), zone.cpuMs });
+      }
+
+      m_latestTimings = std::move(timings);
+    } else {
+      m_latestTimings.clear();
+    }
+
+    m_latestFrameId = frame.frameId;
+    frame.pending = false;
+    return true;
+  }
+
+  void RtxGpuPassProfiler::writeCsv(uint32_t frameId) {
+    const std::string& path = csvPath();
+    if (path != m_csvPath) {
+      m_csv.close();
+      m_csvPath = path;
+
+      if (!path.empty()) {
+        m_csv.open(path, std::ios::out | std::ios::app);
+        if (!m_csv.is_open()) {
+          Logger::err(str::format("GPU pass profiler: failed to open ", path));
+        } else if (m_csv.tellp() == 0) {
+          m_csv << "frame,depth,pass,gpuMs,cpuMs\n";
+        }
+      }
+    }
+
+    if (!m_csv.is_open()) {
+      return;
+    }
+
+    for (const PassTiming& timing : m_latestTimings) {
+      m_csv << frameId << ',' << timing.depth << ",\"" << timing.name << "\"," << std::fixed << std::setprecision(4)
+            << timing.gpuMs << ',' << timing.cpuMs << '\n';
+    }
+    m_csv.flush();
+  }
+
+  void RtxGpuPassProfiler::addBenchmarkFrame() {
+    if (m_benchmarkFrames++ < uint32_t(std::max(warmupFrames(), 0))) {
+      return;
+    }
+    if (m_benchmarkFrames == uint32_t(std::max(warmupFrames(), 0)) + 1) {
+      Logger::info(str::format("Benchmark: measuring ", frameCount(), " frames"));
+    }
+
+    for (const PassTiming& timing : m_latestTimings) {
+      // Passes are matched by name and depth, a pass that doesn't run every frame just has fewer samples
+      auto pass = std::find_if(m_benchmarkPasses.begin(), m_benchmarkPasses.end(), [&timing](const BenchmarkPass& p) {
+        return p.depth == timing.depth && p.name == timing.name;
+      });
+      if (pass == m_benchmarkPasses.end()) {
+        pass = m_benchmarkPasses.insert(m_benchmarkPasses.end(), BenchmarkPass { timing.name, timing.depth });
+      }
+      pass->gpuMs.push_back(timing.gpuMs);
+      pass->cpuMs.push_back(timing.cpuMs);
+    }
+
+    if (m_benchmarkFrames == uint32_t(std::max(warmupFrames(), 0) + frameCount())) {
+      writeBenchmarkReport();
+      m_benchmarkPasses.clear();
+      m_benchmarkDone = true;
+    }
+  }
+
+  void RtxGpuPassProfiler::writeBenchmarkReport() {
+    std::ofstream report(reportPath(), std::ios::out | std::ios::trunc);
+    if (!report.is_open()) {
+      Logger::err(str::format("Benchmark: failed to open ", reportPath()));
+      return;
+    }
+
+    // Mean, median and 95th percentile
+    auto summarize = [](std::vector<float>& samples) {
+      std::sort(samples.begin(), samples.end());
+      double sum = 0.0;
+      for (float sample : samples) {
+        sum += sample;
+      }
+      return std::array<float, 3> {
+        float(sum / samples.size()),
+        samples[samples.size() / 2],
+        samples[std::min(samples.size() - 1, samples.size() * 95 / 100)]
+      };
+    };
+
+    report << "depth,pass,frames,gpuMeanMs,gpuMedianMs,gpuP95Ms,cpuMeanMs,cpuMedianMs,cpuP95Ms\n";
+    for (BenchmarkPass& pass : m_benchmarkPasses) {
+      const std::array<float, 3> gpu = summarize(pass.gpuMs);
+      const std::array<float, 3> cpu = summarize(pass.cpuMs);
+      report << pass.depth << ",\"" << pass.name << "\"," << pass.gpuMs.size() << std::fixed << std::setprecision(4)
+             << ',' << gpu[0] << ',' << gpu[1] << ',' << gpu[2]
+             << ',' << cpu[0] << ',' << cpu[1] << ',' << cpu[2] << '\n';
+    }
+
+    Logger::info(str::format("Benchmark: done, report written to ", reportPath()));
+  }
+
+} // namespace dxvk
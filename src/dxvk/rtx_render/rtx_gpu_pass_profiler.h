@@ -0,0 +1,158 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dxvk_include.h"
+#include "rtx_common_object.h"
+#include "rtx_constants.h"
+#include "rtx_option.h"
+#include "rtx_utils.h"
+
+namespace dxvk {
+
+  class DxvkContext;
+
+  // Measures the GPU time of every ScopedGpuProfileZone with a pair of timestamp queries, so that the cost
+  // of each RTX pass can be looked at on any configuration without an external profiler. Zones keep their
+  // nesting, a zone's time includes the time of the zones within it.
+  //
+  // Every frame in flight writes to its own range of a single query pool. A frame's results are read back
+  // once its range comes around again, when the GPU is normally done with it. If it is not, the frame about
+  // to start is not measured rather than waiting on the GPU.
+  //
+  // Zones are recorded from whichever thread records the context they belong to, the results can be read
+  // from any thread. Along with the GPU time, a zone measures the CPU time spent recording it.
+  //
+  // Setting rtx.benchmark.frameCount runs a benchmark of the current scene: frames advance by a fixed time
+  // delta, and after the warm up frames the timings of frameCount measured frames are summarized per pass
+  // into rtx.benchmark.reportPath. Running the same scene, e.g. a saved game or a demo, with different
+  // builds, drivers or option presets makes the reports comparable.
+  class RtxGpuPassProfiler : public CommonDeviceObject {
+  public:
+    struct PassTiming {
+      std::string name;
+      uint32_t depth = 0;
+      float gpuMs = 0.0f;
+      float cpuMs = 0.0f;
+    };
+
+    explicit RtxGpuPassProfiler(DxvkDevice* device);
+    ~RtxGpuPassProfiler();
+
+    static bool isEnabled() {
+      return enable() || frameCount() > 0;
+    }
+
+    // Time delta in milliseconds that frames advance by during a benchmark, 0 when not running one
+    static float getBenchmarkTimeDelta() {
+      return frameCount() > 0 ? timeDeltaMs() : 0.f;
+    }
+
+    // Writes the begin timestamp of a zone, returns the zone index to end it with.
+    // Nothing is written (and kInvalidZone returned) once the frame has run out of queries.
+    uint32_t beginZone(DxvkContext* ctx, const char* name);
+    void endZone(DxvkContext* ctx, uint32_t zone);
+
+    // Zones of the most recent frame that was read back, in the order they were begun in
+    std::vector<PassTiming> getLatestTimings(uint32_t& frameId) const;
+
+    static constexpr uint32_t kInvalidZone = UINT32_MAX;
+
+  private:
+    RTX_OPTION("rtx.gpuProfiler", bool, enable, false,
+               "Measures the GPU time of every profiled RTX pass with timestamp queries. The results are shown by the \"gpupasses\" DXVK_HUD item and can be written to rtx.gpuProfiler.csvPath.\n"
+               "The timestamps themselves have a small GPU cost, so this should be left disabled when not looking at GPU timings.");
+    RTX_OPTION("rtx.gpuProfiler", std::string, csvPath, "",
+               "When set along with rtx.gpuProfiler.enable, the per-pass GPU timings of every measured frame are appended to the CSV file at this path.");
+    RTX_OPTION_ENV("rtx.benchmark", int, frameCount, 0, "RTX_BENCHMARK_FRAME_COUNT",
+                   "When greater than 0, benchmarks the scene being rendered: the GPU pass profiler is enabled, and the per-pass GPU and CPU timings of this many frames after rtx.benchmark.warmupFrames are summarized into rtx.benchmark.reportPath.\n"
+                   "Frames advance by rtx.benchmark.timeDeltaMs, unless rtx.timeDeltaBetweenFrames is set, so that animations play out the same way in every run.");
+    RTX_OPTION("rtx.benchmark", int, warmupFrames, 120,
+               "The number of frames to skip before a benchmark starts measuring, so that caches, shaders and the denoisers' history are settled.");
+    RTX_OPTION("rtx.benchmark", float, timeDeltaMs, 16.666f,
+               "The time delta in milliseconds that frames advance by while rtx.benchmark.frameCount is set, see rtx.timeDeltaBetweenFrames.");
+    RTX_OPTION("rtx.benchmark", std::string, reportPath, "rtx-benchmark.csv",
+               "The CSV file a benchmark writes its report to, with the mean, median and 95th percentile of the GPU and CPU time of every pass.");
+
+    static constexpr uint32_t kMaxZonesPerFrame = 256;
+    static constexpr uint32_t kQueriesPerFrame = kMaxZonesPerFrame * 2;
+
+    struct Zone {
+      std::string name;
+      uint32_t depth = 0;
+      bool ended = false;
+      std::chrono::steady_clock::time_point cpuBegin;
+      float cpuMs = 0.0f;
+    };
+
+    struct FrameData {
+      uint32_t frameId = kInvalidFrameIndex;
+      // Set while the range holds queries of frameId that were not read back yet
+      bool pending = false;
+      std::vector<Zone> zones;
+    };
+
+    mutable dxvk::mutex m_mutex;
+
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    double m_msPerTick = 0.0;
+
+    std::array<FrameData, kMaxFramesInFlight> m_frames;
+    uint32_t m_frameIdx = 0;
+    uint32_t m_currentFrameId = kInvalidFrameIndex;
+    // Whether the current frame got a range of queries to write to
+    bool m_recording = false;
+    uint32_t m_depth = 0;
+
+    std::vector<PassTiming> m_latestTimings;
+    uint32_t m_latestFrameId = kInvalidFrameIndex;
+
+    std::ofstream m_csv;
+    std::string m_csvPath;
+
+    struct BenchmarkPass {
+      std::string name;
+      uint32_t depth = 0;
+      std::vector<float> gpuMs;
+      std::vector<float> cpuMs;
+    };
+
+    // Frames read back since the first one, including the warm up frames
+    uint32_t m_benchmarkFrames = 0;
+    bool m_benchmarkDone = false;
+    std::vector<BenchmarkPass> m_benchmarkPasses;
+
+    bool createQueryPool();
+    void beginFrame(uint32_t frameId);
+    bool readBack(FrameData& frame);
+    void writeCsv(uint32_t frameId);
+    void addBenchmarkFrame();
+    void writeBenchmarkReport();
+  };
+
+} // namespace dxvk
@@ -0,0 +1,189 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "rtx_half_resolution_denoise.h"
+#include "rtx_context.h"
+#include "dxvk_device.h"
+#include "dxvk_scoped_annotation.h"
+#include "rtx_render/rtx_shader_manager.h"
+#include "rtx/pass/denoise/half_resolution_denoise.h"
+
+#include <rtx_shaders/half_resolution_denoise_downsample.h>
+#include <rtx_shaders/half_resolution_denoise_upsample.h>
+
+namespace dxvk {
+  // Defined within an unnamed namespace to ensure unique definition across binary
+  namespace {
+    class HalfResolutionDenoiseDownsampleShader : public ManagedShader
+    {
+      SHADER_SOURCE(HalfResolutionDenoiseDownsampleShader, VK_SHADER_STAGE_COMPUTE_BIT, half_resolution_denoise_downsample)
+
+      PUSH_CONSTANTS(HalfResolutionDenoiseArgs)
+
+      BEGIN_PARAMETER()
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_INPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_OUTPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_OUTPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_OUTPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_OUTPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_OUTPUT)
+      END_PARAMETER()
+    };
+
+    PREWARM_SHADER_PIPELINE(HalfResolutionDenoiseDownsampleShader);
+
+    class HalfResolutionDenoiseUpsampleShader : public ManagedShader
+    {
+      SHADER_SOURCE(HalfResolutionDenoiseUpsampleShader, VK_SHADER_STAGE_COMPUTE_BIT, half_resolution_denoise_upsample)
+
+      PUSH_CONSTANTS(HalfResolutionDenoiseArgs)
+
+      BEGIN_PARAMETER()
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_HALF_LINEAR_VIEW_Z_INPUT)
+        TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_LINEAR_VIEW_Z_INPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_OUTPUT)
+        RW_TEXTURE2D(HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_OUTPUT)
+      END_PARAMETER()
+    };
+
+    PREWARM_SHADER_PIPELINE(HalfResolutionDenoiseUpsampleShader);
+
+    HalfResolutionDenoiseArgs getHalfResolutionDenoiseArgs(const VkExtent3D& fullExtent, const VkExtent3D& halfExtent, float missLinearViewZ) {
+      HalfResolutionDenoiseArgs args = {};
+      args.fullResolution = { fullExtent.width, fullExtent.height };
+      args.halfResolution = { halfExtent.width, halfExtent.height };
+      args.missLinearViewZ = missLinearViewZ;
+      return args;
+    }
+  }
+
+  DxvkHalfResolutionDenoise::DxvkHalfResolutionDenoise(DxvkDevice* device) : RtxPass(device) {
+  }
+
+  DxvkHalfResolutionDenoise::~DxvkHalfResolutionDenoise() {
+  }
+
+  void DxvkHalfResolutionDenoise::dispatchDownsample(
+    RtxContext* ctx,
+    const DxvkDenoise::Input& fullResolutionInput,
+    float missLinearViewZ,
+    DxvkDenoise::Input& outHalfResolutionInput,
+    DxvkDenoise::Output& outHalfResolutionOutput) {
+    ScopedGpuProfileZone(ctx, "Half Resolution Denoise Downsample");
+
+    const VkExtent3D fullExtent = fullResolutionInput.linearViewZ->image->info().extent;
+    const VkExtent3D halfExtent = m_linearViewZ.image->info().extent;
+
+    ctx->setPushConstantBank(DxvkPushConstantBank::RTX);
+
+    const HalfResolutionDenoiseArgs pushArgs = getHalfResolutionDenoiseArgs(fullExtent, halfExtent, missLinearViewZ);
+    ctx->pushConstants(0, sizeof(pushArgs), &pushArgs);
+
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_INPUT, fullResolutionInput.diffuse_hitT->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_INPUT, fullResolutionInput.specular_hitT->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_INPUT, fullResolutionInput.normal_roughness->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_INPUT, fullResolutionInput.linearViewZ->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_INPUT, fullResolutionInput.motionVector->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_OUTPUT, m_diffuseRadiance.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_OUTPUT, m_specularRadiance.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_OUTPUT, m_normalRoughness.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_OUTPUT, m_linearViewZ.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_OUTPUT, m_motionVector.view, nullptr);
+
+    const VkExtent3D workgroups = util::computeBlockCount(halfExtent, VkExtent3D{ 16, 8, 1 });
+    ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, HalfResolutionDenoiseDownsampleShader::getShader());
+    ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
+
+    // Note: The remaining inputs are full resolution specific and not carried over
+    outHalfResolutionInput = {};
+    outHalfResolutionInput.diffuse_hitT = &m_diffuseRadiance;
+    outHalfResolutionInput.specular_hitT = &m_specularRadiance;
+    outHalfResolutionInput.normal_roughness = &m_normalRoughness;
+    outHalfResolutionInput.linearViewZ = &m_linearViewZ;
+    outHalfResolutionInput.motionVector = &m_motionVector;
+    outHalfResolutionInput.frameTimeMs = fullResolutionInput.frameTimeMs;
+    outHalfResolutionInput.reset = fullResolutionInput.reset;
+
+    outHalfResolutionOutput = {};
+    outHalfResolutionOutput.diffuse_hitT = &m_diffuseRadiance;
+    outHalfResolutionOutput.specular_hitT = &m_specularRadiance;
+  }
+
+  void DxvkHalfResolutionDenoise::dispatchUpsample(
+    RtxContext* ctx,
+    const DxvkDenoise::Input& fullResolutionInput,
+    float missLinearViewZ,
+    const DxvkDenoise::Output& fullResolutionOutput) {
+    ScopedGpuProfileZone(ctx, "Half Resolution Denoise Upsample");
+
+    const VkExtent3D fullExtent = fullResolutionInput.linearViewZ->image->info().extent;
+    const VkExtent3D halfExtent = m_linearViewZ.image->info().extent;
+
+    ctx->setPushConstantBank(DxvkPushConstantBank::RTX);
+
+    const HalfResolutionDenoiseArgs pushArgs = getHalfResolutionDenoiseArgs(fullExtent, halfExtent, missLinearViewZ);
+    ctx->pushConstants(0, sizeof(pushArgs), &pushArgs);
+
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_INPUT, m_diffuseRadiance.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_INPUT, m_specularRadiance.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_HALF_LINEAR_VIEW_Z_INPUT, m_linearViewZ.view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_LINEAR_VIEW_Z_INPUT, fullResolutionInput.linearViewZ->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_OUTPUT, fullResolutionOutput.diffuse_hitT->view, nullptr);
+    ctx->bindResourceView(HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_OUTPUT, fullResolutionOutput.specular_hitT->view, nullptr);
+
+    const VkExtent3D workgroups = util::computeBlockCount(fullExtent, VkExtent3D{ 16, 8, 1 });
+    ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, HalfResolutionDenoiseUpsampleShader::getShader());
+    ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
+  }
+
+  void DxvkHalfResolutionDenoise::createDownscaledResource(Rc<DxvkContext>& ctx, const VkExtent3D& downscaledExtent) {
+    const VkExtent3D halfExtent = {
+      util::ceilDivide(downscaledExtent.width, 2),
+      util::ceilDivide(downscaledExtent.height, 2),
+      1
+    };
+
+    // Note: Same formats as the full resolution secondary surface denoiser inputs
+    m_diffuseRadiance = Resources::createImageResource(ctx, "half resolution denoise diffuse radiance", halfExtent, VK_FORMAT_R16G16B16A16_SFLOAT);
+    m_specularRadiance = Resources::createImageResource(ctx, "half resolution denoise specular radiance", halfExtent, VK_FORMAT_R16G16B16A16_SFLOAT);
+    m_normalRoughness = Resources::createImageResource(ctx, "half resolution denoise normal roughness", halfExtent, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+    m_linearViewZ = Resources::createImageResource(ctx, "half resolution denoise linear view z", halfExtent, VK_FORMAT_R32_SFLOAT);
+    m_motionVector = Resources::createImageResource(ctx, "half resolution denoise motion vector", halfExtent, VK_FORMAT_R16G16B16A16_SFLOAT);
+  }
+
+  void DxvkHalfResolutionDenoise::releaseDownscaledResource() {
+    m_diffuseRadiance.reset();
+    m_specularRadiance.reset();
+    m_normalRoughness.reset();
+    m_linearViewZ.reset();
+    m_motionVector.reset();
+  }
+
+  bool DxvkHalfResolutionDenoise::isEnabled() const {
+    return RtxOptions::denoiseSecondariesAtHalfResolution();
+  }
+}
@@ -0,0 +1,77 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "dxvk_include.h"
+#include "dxvk_context.h"
+#include "rtx_resources.h"
+#include "rtx_denoise.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+  class RtxContext;
+
+  // Runs a denoiser at half of the render resolution. The full resolution denoiser inputs are reduced to one pixel
+  // per 2x2 quad, the denoiser runs on the reduced copies and its output is resolved back into the full resolution
+  // outputs with a depth aware upsample. Currently used for the secondary surface denoiser only, as reflections and
+  // refractions rarely need the full resolution.
+  class DxvkHalfResolutionDenoise : public RtxPass {
+
+  public:
+    explicit DxvkHalfResolutionDenoise(DxvkDevice* device);
+    ~DxvkHalfResolutionDenoise();
+
+    DxvkHalfResolutionDenoise(const DxvkHalfResolutionDenoise&) = delete;
+    DxvkHalfResolutionDenoise(DxvkHalfResolutionDenoise&&) noexcept = delete;
+    DxvkHalfResolutionDenoise& operator=(const DxvkHalfResolutionDenoise&) = delete;
+    DxvkHalfResolutionDenoise& operator=(DxvkHalfResolutionDenoise&&) noexcept = delete;
+
+    // Reduces the given full resolution inputs and returns the half resolution inputs and outputs to denoise with instead
+    void dispatchDownsample(
+      RtxContext* ctx,
+      const DxvkDenoise::Input& fullResolutionInput,
+      float missLinearViewZ,
+      DxvkDenoise::Input& outHalfResolutionInput,
+      DxvkDenoise::Output& outHalfResolutionOutput);
+
+    // Resolves the denoised half resolution signal into the given full resolution outputs
+    void dispatchUpsample(
+      RtxContext* ctx,
+      const DxvkDenoise::Input& fullResolutionInput,
+      float missLinearViewZ,
+      const DxvkDenoise::Output& fullResolutionOutput);
+
+  private:
+    virtual void createDownscaledResource(Rc<DxvkContext>& ctx, const VkExtent3D& downscaledExtent) override;
+    virtual void releaseDownscaledResource() override;
+
+    virtual bool isEnabled() const override;
+
+    Resources::Resource m_diffuseRadiance;
+    Resources::Resource m_specularRadiance;
+    Resources::Resource m_normalRoughness;
+    Resources::Resource m_linearViewZ;
+    Resources::Resource m_motionVector;
+  };
+
+}
@@ -28,6 +28,7 @@ namespace dxvk {
 
   static constexpr const char* HashSourceDataCategoryName[] = {
     "OpacityMicromap",
+    "Geometry",
   };
   static_assert(std::size(HashSourceDataCategoryName) == static_cast<size_t>(HashSourceDataCategory::Count));
 
@@ -55,14 +56,29 @@ namespace dxvk {
   uint32_t HashCollisionDetection::getHashSourceDataSize(HashSourceDataCategory category) {
     switch (category) {
     case HashSourceDataCategory::OpacityMicromap: return sizeof(OpacityMicromapHashSourceData);
+    case HashSourceDataCategory::Geometry: return sizeof(GeometryHashSourceData);
     default:
       assert(!"Invalid category specified.");
       return 0;
     }
   }
 
+  bool HashCollisionDetection::shouldCheck(XXH64_hash_t hash, HashSourceDataCategory category) {
+    if (HashCollisionDetectionOptions::enable()) {
+      return true;
+    }
+
+    if (category != HashSourceDataCategory::Geometry) {
+      return false;
+    }
+
+    // Sample by hash rather than by draw so that all draws of a colliding hash are seen
+    const float samplingRate = HashCollisionDetectionOptions::geometrySamplingRate();
+    return samplingRate > 0.f && static_cast<float>(hash & 0xFFFF) < samplingRate * 65536.f;
+  }
+
   void HashCollisionDetection::registerHashedSourceData(XXH64_hash_t hash, void* hashSourceData, HashSourceDataCategory category) {
-    if (!HashCollisionDetectionOptions::enable()) {
+    if (!shouldCheck(hash, category)) {
       return;
     }
 
@@ -82,7 +98,11 @@ namespace dxvk {
       const void* cachedHashSourceData = cacheItemIter->second;
 
       // Validate the source data matches
-      if (!bitExactMatch(hashSourceData, cachedHashSourceData, hashSourceDataSize)) {
+      // Report each colliding hash once, as sampled checks are meant to be left running
+      if (!bitExactMatch(hashSourceData, cachedHashSourceData, hashSourceDataSize) &&
+          s_collidingHashes.insert(hash ^ static_cast<uint8_t>(category)).second) {
+        s_collisionCount.fetch_add(1, std::memory_order_relaxed);
+
         std::stringstream ssHash;
         ssHash << "0x" << std::uppercase << std::setfill('0') << std::hex << hash;
 
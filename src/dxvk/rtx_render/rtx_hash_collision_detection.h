@@ -21,6 +21,8 @@
 */
 #pragma once
 
+#include <atomic>
+
 #include "rtx_utils.h"
 #include "rtx_option.h"
 #include "../util/xxHash/xxhash.h"
@@ -29,14 +31,26 @@ namespace dxvk {
 
   enum class HashSourceDataCategory : uint8_t {
     OpacityMicromap = 0,
+    Geometry,
 
     Count
   };
 
+  // Compact fingerprint of the geometry a geometry asset hash was generated from
+  struct GeometryHashSourceData {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    XXH64_hash_t boundingBoxHash;
+  };
+
   struct HashCollisionDetectionOptions {
     friend class ImGUI;
 
     RTX_OPTION_ENV("rtx.hashCollisionDetection", bool, enable, false, "RTX_HASH_COLLISION_DETECTION", "Enables hash collision detection.");
+    RTX_OPTION("rtx.hashCollisionDetection", float, geometrySamplingRate, 0.f,
+               "Fraction of geometry asset hashes, in the [0, 1] range, that are checked for hash collisions even when full hash collision detection is disabled.\n"
+               "A hash is either always or never sampled, so every draw using a sampled hash gets checked. Only a fingerprint of the vertex count, index count and bounding box is kept per hash,\n"
+               "which keeps the check cheap enough to leave enabled. Collisions are logged once per hash and counted in the RTX HUD.");
   };
 
   class HashSourceDataCache {
@@ -57,12 +71,19 @@ namespace dxvk {
   public:
     ~HashCollisionDetection();
 
+    // Returns true if hash source data registered for the hash would be checked, to skip gathering it otherwise
+    static bool shouldCheck(XXH64_hash_t hash, HashSourceDataCategory category);
     static void registerHashedSourceData(XXH64_hash_t hash, void* hashSourceData, HashSourceDataCategory category);
+
+    // Number of unique hashes found to collide so far
+    static uint32_t getCollisionCount() { return s_collisionCount.load(std::memory_order_relaxed); }
   
   private:
     static uint32_t getHashSourceDataSize(HashSourceDataCategory category);
 
     inline static HashSourceDataCache s_caches;
+    inline static fast_unordered_set s_collidingHashes;
+    inline static std::atomic<uint32_t> s_collisionCount = 0;
     inline static dxvk::mutex s_cacheAccessMutex;
    };
 }  // namespace dxvk
@@ -104,28 +104,41 @@ namespace dxvk {
 
   template<typename T>
   XXH64_hash_t hashVertexRegionIndexed(const HashQuery& query, const std::vector<T>& uniqueIndices) {
-    ScopedCpuProfileZone();
+    XXH64_hash_t result;
+    hashVertexRegionsIndexed(&query, 1, uniqueIndices, &result);
+    return result;
+  }
 
-    XXH64_hash_t result = 0;
+  template<typename T>
+  void hashVertexRegionsIndexed(const HashQuery* queries, const uint32_t numQueries, const std::vector<T>& uniqueIndices, XXH64_hash_t* hashesOut) {
+    ScopedCpuProfileZone();
 
     constexpr bool hasIndices = std::is_same<T, uint16_t>::value || std::is_same<T, uint32_t>::value;
 
-    if (hasIndices && uniqueIndices.size() > 0) {
-      for (const T idx : uniqueIndices) {
-        const uint8_t* pData = (query.pBase + idx * query.stride);
-        result = XXH3_64bits_withSeed(pData, query.elementSize, result);
-      }
-    } else {
-      for (uint32_t i = 0; i < query.size; i += query.stride) {
-        const uint8_t* pData = (query.pBase + i);
-        result = XXH3_64bits_withSeed(pData, query.elementSize, result);
+    constexpr uint32_t kMaxStreams = 8;
+    assert(numQueries <= kMaxStreams);
+    fast::HashElementStream streams[kMaxStreams];
+
+    for (uint32_t i = 0; i < numQueries; i++) {
+      const HashQuery& query = queries[i];
+      fast::HashElementStream& stream = streams[i];
+      stream.data = query.pBase;
+      stream.stride = (uint32_t) query.stride;
+      stream.elementSize = (uint32_t) query.elementSize;
+
+      if (hasIndices && uniqueIndices.size() > 0) {
+        stream.count = (uint32_t) uniqueIndices.size();
+        stream.indices = uniqueIndices.data();
+        stream.indexSize = sizeof(T);
+      } else {
+        assert(query.stride > 0 || query.size == 0);
+        stream.count = query.size == 0 ? 0 : (uint32_t) ((query.size + query.stride - 1) / query.stride);
       }
     }
 
-    return result;
+    fast::hashElementsChained(streams, numQueries, hashesOut);
   }
 
-
   // TODO (REMIX-656): Remove this once we can transition content to new hash
   constexpr static uint32_t MaxGeomHashSize = 512; // 512b - this is a performance optimization
 
@@ -221,6 +234,10 @@ namespace dxvk {
   template XXH64_hash_t hashVertexRegionIndexed(const HashQuery& query, const std::vector<uint32_t>& uniqueIndices);
   template XXH64_hash_t hashVertexRegionIndexed(const HashQuery& query, const std::vector<int>& uniqueIndices);
 
+  template void hashVertexRegionsIndexed(const HashQuery* queries, const uint32_t numQueries, const std::vector<uint16_t>& uniqueIndices, XXH64_hash_t* hashesOut);
+  template void hashVertexRegionsIndexed(const HashQuery* queries, const uint32_t numQueries, const std::vector<uint32_t>& uniqueIndices, XXH64_hash_t* hashesOut);
+  template void hashVertexRegionsIndexed(const HashQuery* queries, const uint32_t numQueries, const std::vector<int>& uniqueIndices, XXH64_hash_t* hashesOut);
+
   template XXH64_hash_t hashIndicesLegacy<uint16_t>(const void* pIndexData, const size_t indexCount);
   template XXH64_hash_t hashIndicesLegacy<uint32_t>(const void* pIndexData, const size_t indexCount);
 }
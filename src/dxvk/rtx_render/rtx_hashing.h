@@ -79,6 +79,7 @@ namespace dxvk {
   struct GeometryHashes {
     GeometryHashes() {
       memset(&fields[0], kEmptyHash, sizeof(fields));
+      memset(&precombined[0], kEmptyHash, sizeof(precombined));
     }
 
     // Simple getters for hash components
@@ -212,6 +213,17 @@ namespace dxvk {
   template<typename T>
   XXH64_hash_t hashVertexRegionIndexed(const HashQuery& query, const std::vector<T>& uniqueIndices);
 
+  /**
+    * \brief Hashes several regions of sparse memory in one batch, same result as hashVertexRegionIndexed per region
+    *
+    *   queries [in]: structures containing information about each region
+    *   numQueries [in]: number of regions
+    *   uniqueIndices [in]: indices (byte offsets as multiples of query.stride) to hash, shared by all regions
+    *   hashesOut [out]: one hash per region
+    */
+  template<typename T>
+  void hashVertexRegionsIndexed(const HashQuery* queries, const uint32_t numQueries, const std::vector<T>& uniqueIndices, XXH64_hash_t* hashesOut);
+
   template<typename T>
   [[deprecated("(REMIX-656): Remove this once we can transition content to new hash)")]]
   XXH64_hash_t hashIndicesLegacy(const void* pIndexData, const size_t indexCount);
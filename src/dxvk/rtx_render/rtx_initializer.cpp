@@ -31,13 +31,29 @@
 #include "rtx_io.h"
 #include "dxvk_raytracing.h"
 #include "rtx_debug_view.h"
+#include "rtx_nee_cache.h"
+#include "dxvk_scoped_annotation.h"
+
+#include <chrono>
 
 namespace dxvk {
+  namespace {
+    using StartupClock = std::chrono::steady_clock;
+
+    void logStartupPhase(const char* phase, const StartupClock::time_point start) {
+      const double durationMs = std::chrono::duration<double, std::milli>(StartupClock::now() - start).count();
+      Logger::info(str::format("[RTX] Initializer: ", phase, " took ", durationMs, " ms"));
+    }
+  }
+
   RtxInitializer::RtxInitializer(DxvkDevice* device)
   : CommonDeviceObject(device) { 
   }
 
   void RtxInitializer::initialize() {
+    const StartupClock::time_point initializeStart = StartupClock::now();
+    StartupClock::time_point phaseStart = initializeStart;
+
     ShaderManager::getInstance()->setDevice(m_device);
 
 #ifdef WITH_RTXIO
@@ -86,26 +102,40 @@ namespace dxvk {
     // Need to promote all of the hardware support Options before prewarming shaders.
     RtxOption<bool>::applyPendingValues();
 
-    // Kick off shader prewarming
-    startPrewarmShaders();
+    logStartupPhase("option and preset setup", phaseStart);
 
-    // Load assets (if any) as early as possible
+    // Load assets (if any) as early as possible. Asset discovery and mod composition do not depend on any of the
+    // steps below, so when loading asynchronously the thread is started first to overlap with the shader prewarm
+    // registration and upscaler initialization rather than only with the prewarm compilation.
     if (RtxOptions::asyncAssetLoading()) {
       // Async asset loading (USD)
       m_asyncAssetLoadThread = dxvk::thread([this] {
         env::setThreadName("rtx-initialize-assets");
         loadAssets();
       });
-    } else {
+    }
+
+    // Kick off shader prewarming
+    phaseStart = StartupClock::now();
+    m_prewarmStart = phaseStart;
+    startPrewarmShaders();
+    logStartupPhase("shader prewarm registration", phaseStart);
+
+    if (!RtxOptions::asyncAssetLoading()) {
       loadAssets();
     }
+
+    phaseStart = StartupClock::now();
     pCommon->metaDLSS(); // Lazy allocator triggers init in ctor
     pCommon->metaDLFG();
+    logStartupPhase("DLSS and DLFG initialization", phaseStart);
 
     if (!asyncShaderFinalizing()) {
       // Wait for all prewarming to complete before calling "RTX initialized"
       waitForShaderPrewarm();
     }
+
+    logStartupPhase("initialization", initializeStart);
   }
 
   void RtxInitializer::release() {
@@ -122,6 +152,7 @@ namespace dxvk {
 
   void RtxInitializer::loadAssets() {
     m_assetsLoaded = false;
+    const StartupClock::time_point loadStart = StartupClock::now();
 
     Rc<DxvkContext> ctx = m_device->createContext();
 
@@ -132,24 +163,28 @@ namespace dxvk {
 
     ctx->flushCommandList();
 
+    logStartupPhase("asset loading", loadStart);
+
     m_assetsLoaded = true;
   }
 
-  void RtxInitializer::startPrewarmShaders() {
+  bool RtxInitializer::isShaderPrewarmingEnabled() const {
     // If we want to run without shader prewarming, then pipelines will be built inline with other GPU work on first use (typically means
     // long stutters whenever a yet to be compiled pipeline comes into use).
-    if (!asyncShaderPrewarming()
+    return asyncShaderPrewarming()
         // WAR: Shader prewarming caused a deadlock on AMD in the past so it is forcibly disabled, should re-evaluate this at some point.
-        || m_device->properties().core.properties.vendorID == static_cast<uint32_t>(DxvkGpuVendor::Amd)) {
+        && m_device->properties().core.properties.vendorID != static_cast<uint32_t>(DxvkGpuVendor::Amd);
+  }
+
+  void RtxInitializer::startPrewarmShaders() {
+    if (!isShaderPrewarmingEnabled()) {
       return;
     }
 
     DxvkObjects* pCommon = m_device->getCommon();
 
     // Prewarm all the shaders we'll need for RT by registering them (per-pass) with the driver
-    pCommon->metaPathtracerGbuffer().prewarmShaders(pCommon->pipelineManager());
-    pCommon->metaPathtracerIntegrateDirect().prewarmShaders(pCommon->pipelineManager());
-    pCommon->metaPathtracerIntegrateIndirect().prewarmShaders(pCommon->pipelineManager());
+    prewarmRaytracingShaders();
 
     pCommon->metaDebugView().prewarmShaders(pCommon->pipelineManager());
 
@@ -157,6 +192,48 @@ namespace dxvk {
     AutoShaderPipelinePrewarmer::prewarmComputePipelines(pCommon->pipelineManager());
   }
 
+  void RtxInitializer::prewarmRaytracingShaders() {
+    DxvkObjects* pCommon = m_device->getCommon();
+
+    // Note: Without prewarmAllVariants the passes only register the permutations reachable from the current options (and those the
+    // graphics presets may switch to), with SER and OMM permutations only when the device supports them.
+    pCommon->metaPathtracerGbuffer().prewarmShaders(pCommon->pipelineManager());
+    pCommon->metaPathtracerIntegrateDirect().prewarmShaders(pCommon->pipelineManager());
+    pCommon->metaPathtracerIntegrateIndirect().prewarmShaders(pCommon->pipelineManager());
+
+    m_prewarmedPermutationKey = getPrewarmedPermutationKey();
+  }
+
+  RtxInitializer::PrewarmedPermutationKey RtxInitializer::getPrewarmedPermutationKey() {
+    return {
+      (uint32_t) RtxOptions::renderPassGBufferRaytraceMode(),
+      (uint32_t) RtxOptions::renderPassIntegrateDirectRaytraceMode(),
+      (uint32_t) RtxOptions::renderPassIntegrateIndirectRaytraceMode(),
+      (uint32_t) RtxOptions::isShaderExecutionReorderingInPathtracerGbufferEnabled(),
+      (uint32_t) RtxOptions::isShaderExecutionReorderingInPathtracerIntegrateIndirectEnabled(),
+      (uint32_t) RtxOptions::getEnableOpacityMicromap(),
+      (uint32_t) RtxOptions::OpacityMicromap::enable(),
+      (uint32_t) RtxOptions::integrateIndirectMode(),
+      (uint32_t) NeeCachePass::enable(),
+    };
+  }
+
+  void RtxInitializer::prewarmChangedShaders() {
+    // Note: With all variants prewarmed on startup there is nothing an option change can make reachable.
+    if (!isShaderPrewarmingEnabled() || RtxOptions::Shader::prewarmAllVariants()) {
+      return;
+    }
+
+    if (getPrewarmedPermutationKey() == m_prewarmedPermutationKey) {
+      return;
+    }
+
+    ScopedCpuProfileZone();
+
+    // Note: Permutations that were already prewarmed are skipped by the pipeline manager, so only the newly reachable ones are compiled.
+    prewarmRaytracingShaders();
+  }
+
   void RtxInitializer::waitForShaderPrewarm() {
     if (m_warmupComplete) {
       return;
@@ -169,6 +246,11 @@ namespace dxvk {
 
     DxvkRaytracingPipeline::releaseFinalizer();
 
+    // Note: Not logged when prewarming never started, e.g. when the device is destroyed before initialization
+    if (isShaderPrewarmingEnabled() && m_prewarmStart != StartupClock::time_point {}) {
+      logStartupPhase("shader prewarming", m_prewarmStart);
+    }
+
     m_warmupComplete = true;
   }
 }
\ No newline at end of file
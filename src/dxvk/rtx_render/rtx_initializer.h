@@ -20,6 +20,8 @@
 * DEALINGS IN THE SOFTWARE.
 */
 #pragma once
+#include <array>
+#include <chrono>
 #include "../../util/rc/util_rc_ptr.h"
 #include "rtx_option.h"
 #include "rtx_common_object.h"
@@ -47,6 +49,10 @@ namespace dxvk {
 
     void waitForShaderPrewarm();
 
+    // Prewarms the raytracing pipeline permutations that became reachable through option changes since the last call,
+    // compiling them in the background rather than inline on their first use. Should be called once per frame.
+    void prewarmChangedShaders();
+
     bool getWarmupComplete() const {
       return m_warmupComplete;
     }
@@ -54,9 +60,18 @@ namespace dxvk {
   private:
     bool m_warmupComplete = false;
     bool m_assetsLoaded = false;
+    // When shader prewarm registration started, for the startup timings
+    std::chrono::steady_clock::time_point m_prewarmStart;
 
     void loadAssets();
+    bool isShaderPrewarmingEnabled() const;
     void startPrewarmShaders();
+    void prewarmRaytracingShaders();
+
+    // The options which select the raytracing pipeline permutations that can be reached, as of the last prewarm
+    using PrewarmedPermutationKey = std::array<uint32_t, 9>;
+    static PrewarmedPermutationKey getPrewarmedPermutationKey();
+    PrewarmedPermutationKey m_prewarmedPermutationKey {};
 
     dxvk::thread m_asyncAssetLoadThread;
 
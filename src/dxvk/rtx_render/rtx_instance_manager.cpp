@@ -91,44 +91,107 @@ namespace dxvk {
     return flags;
   }
 
-  RtInstance::RtInstance(const uint64_t id, uint32_t instanceVectorId)
+  uint32_t InstanceFrameState::add() {
+    frameLastUpdated.push_back(kInvalidFrameIndex);
+    surfaceIndex.push_back(BINDING_INDEX_INVALID);
+    isMarkedForGC.push_back(false);
+    return size() - 1;
+  }
+
+  void InstanceFrameState::swapAndPopBack(uint32_t instanceVectorId) {
+    frameLastUpdated[instanceVectorId] = frameLastUpdated.back();
+    surfaceIndex[instanceVectorId] = surfaceIndex.back();
+    isMarkedForGC[instanceVectorId] = isMarkedForGC.back();
+
+    frameLastUpdated.pop_back();
+    surfaceIndex.pop_back();
+    isMarkedForGC.pop_back();
+  }
+
+  void InstanceFrameState::clear() {
+    frameLastUpdated.clear();
+    surfaceIndex.clear();
+    isMarkedForGC.clear();
+  }
+
+  uint64_t InstanceIdPool::allocate() {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+      index = m_freeIndices.back();
+      m_freeIndices.pop_back();
+    } else {
+      index = m_generations.size();
+      m_generations.push_back(0);
+      m_isSlotAlive.push_back(false);
+    }
+
+    m_isSlotAlive[index] = true;
+    return makeId(index, m_generations[index]);
+  }
+
+  void InstanceIdPool::release(uint64_t id) {
+    const uint32_t index = getIndex(id);
+    assert(isAlive(id));
+
+    m_isSlotAlive[index] = false;
+    // A slot whose generation would wrap around is retired rather than ever handing out an id twice
+    if (++m_generations[index] != UINT32_MAX) {
+      m_freeIndices.push_back(index);
+    }
+  }
+
+  bool InstanceIdPool::isAlive(uint64_t id) const {
+    const uint32_t index = getIndex(id);
+    return index < m_generations.size() && m_isSlotAlive[index] && m_generations[index] == getGeneration(id);
+  }
+
+  RtInstance::RtInstance(const uint64_t id, uint32_t instanceVectorId, InstanceFrameState& frameState)
     : m_id(id)
     , m_instanceVectorId(instanceVectorId)
-    , m_surfaceIndex(BINDING_INDEX_INVALID)
+    , m_frameState(&frameState)
     , m_previousSurfaceIndex(BINDING_INDEX_INVALID) { }
 
   // Makes a copy of an instance
-  RtInstance::RtInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId)
-    : surface(src.surface)
-    , m_id(id)
+  RtInstance::RtInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId, InstanceFrameState& frameState)
+    : m_id(id)
     , m_instanceVectorId(instanceVectorId)
-    , m_seenCameraTypes(src.m_seenCameraTypes)
-    , m_materialType(src.m_materialType)
-    , m_albedoOpacityTextureIndex(src.m_albedoOpacityTextureIndex)
-    , m_samplerIndex(src.m_samplerIndex)
-    , m_secondaryOpacityTextureIndex(src.m_secondaryOpacityTextureIndex)
-    , m_secondarySamplerIndex(src.m_secondarySamplerIndex)
-    , m_isAnimated(src.m_isAnimated)
-    , m_opacityMicromapInstanceData(src.m_opacityMicromapInstanceData)
-    , m_surfaceIndex(src.m_surfaceIndex)
-    , m_previousSurfaceIndex(src.m_previousSurfaceIndex)
-    , m_isHidden(src.m_isHidden)
-    , m_isPlayerModel(src.m_isPlayerModel)
-    , m_isWorldSpaceUI(src.m_isWorldSpaceUI)
-    , m_isUnordered(src.m_isUnordered)
-    , m_isObjectToWorldMirrored(src.m_isObjectToWorldMirrored)
-    , m_linkedBlas(src.m_linkedBlas)
-    , m_materialHash(src.m_materialHash)
-    , m_materialDataHash(src.m_materialDataHash)
-    , m_texcoordHash(src.m_texcoordHash)
-    , m_indexHash(src.m_indexHash)
-    , m_vkInstance(src.m_vkInstance)
-    , m_geometryFlags(src.m_geometryFlags)
-    , m_firstBillboard(src.m_firstBillboard)
-    , m_billboardCount(src.m_billboardCount)
-    , m_categoryFlags(src.m_categoryFlags) {
+    , m_frameState(&frameState)
+    , m_previousSurfaceIndex(src.m_previousSurfaceIndex) {
+    copyStateFrom(src);
+    setSurfaceIndex(src.getSurfaceIndex());
+  }
+
+  void RtInstance::copyStateFrom(const RtInstance& src) {
+    surface = src.surface;
+    m_seenCameraTypes = src.m_seenCameraTypes;
+    m_materialType = src.m_materialType;
+    m_albedoOpacityTextureIndex = src.m_albedoOpacityTextureIndex;
+    m_samplerIndex = src.m_samplerIndex;
+    m_secondaryOpacityTextureIndex = src.m_secondaryOpacityTextureIndex;
+    m_secondarySamplerIndex = src.m_secondarySamplerIndex;
+    m_isAnimated = src.m_isAnimated;
+    m_opacityMicromapInstanceData = src.m_opacityMicromapInstanceData;
+    m_isHidden = src.m_isHidden;
+    m_isPlayerModel = src.m_isPlayerModel;
+    m_isWorldSpaceUI = src.m_isWorldSpaceUI;
+    m_isUnordered = src.m_isUnordered;
+    m_isObjectToWorldMirrored = src.m_isObjectToWorldMirrored;
+    m_linkedBlas = src.m_linkedBlas;
+    m_materialHash = src.m_materialHash;
+    m_materialDataHash = src.m_materialDataHash;
+    m_texcoordHash = src.m_texcoordHash;
+    m_indexHash = src.m_indexHash;
+    m_vkInstance = src.m_vkInstance;
+    m_geometryFlags = src.m_geometryFlags;
+    m_firstBillboard = src.m_firstBillboard;
+    m_billboardCount = src.m_billboardCount;
+    m_categoryFlags = src.m_categoryFlags;
+
     // Members for which state carry over is intentionally skipped
     /*
+       m_id
+       m_instanceVectorId
+       m_previousSurfaceIndex (copied by the copy ctor only)
        m_isMarkedForGC
        m_isUnlinkedForGC
        m_isInsideFrustum
@@ -142,14 +205,14 @@ namespace dxvk {
        indexOffsets
      */
   }
-  // Ensure the copy ctor copies all needed members when size changes, and update the object size check.
+  // Ensure copyStateFrom copies all needed members when size changes, and update the object size check.
   // Note: The object has a different size on Debug builds. 
   //       Checking the non-Debug flavors is good enough for the sake of convenience of tracking just a single size.
  #if defined(DEBUG_OPTIMIZED) || defined(NDEBUG)
   namespace {
     template<int RtInstanceSize> struct CheckRtInstanceSize {
       // The second line of the build error should contain the new size of RtInstance in the template argument, i.e. `dxvk::CheckRtInstanceSize<newSize>`
-      static_assert(RtInstanceSize == 688, "RtInstance size has changed.  Fix the copy constructor above this message, then update the expected size.");
+      static_assert(RtInstanceSize == 696, "RtInstance size has changed.  Fix copyStateFrom above this message, then update the expected size.");
     };
     CheckRtInstanceSize<sizeof(RtInstance)> _rtInstanceSizeTest;
   }
@@ -242,10 +305,10 @@ namespace dxvk {
   // instance's per frame state is reset as well
   // Returns true if this is the first update this frame
   bool RtInstance::setFrameLastUpdated(const uint32_t frameIndex) {
-    if (m_frameLastUpdated != frameIndex) {
+    if (getFrameLastUpdated() != frameIndex) {
       m_seenCameraTypes.clear();
 
-      m_frameLastUpdated = frameIndex;
+      m_frameState->frameLastUpdated[m_instanceVectorId] = frameIndex;
 
       return true;
     }
@@ -254,7 +317,7 @@ namespace dxvk {
   }
 
   void RtInstance::markForGarbageCollection() const {
-    m_isMarkedForGC = true;
+    m_frameState->isMarkedForGC[m_instanceVectorId] = true;
   }
 
   void RtInstance::markAsUnlinkedFromBlasEntryForGarbageCollection() const {
@@ -331,7 +394,9 @@ namespace dxvk {
     }
 
     m_instances.clear();
+    m_frameState.clear();
     m_viewModelCandidates.clear();
+    m_viewModelInstances.clear();
     m_playerModelInstances.clear();
   }  
 
@@ -351,32 +416,42 @@ namespace dxvk {
         delete instance;
       }
       m_instances.clear();
+      m_frameState.clear();
       m_viewModelCandidates.clear();
+      m_viewModelInstances.clear();
       m_playerModelInstances.clear();
       m_previousViewModelState = isViewModelEnabled;
     }
 
     const bool forceGarbageCollection = (m_instances.size() >= RtxOptions::AntiCulling::Object::numObjectsToKeep());
+    const bool isObjectAntiCullingEnabled = RtxOptions::AntiCulling::isObjectAntiCullingEnabled();
     for (uint32_t i = 0; i < m_instances.size();) {
       // Must take a ref here since we'll be swapping
       RtInstance*& pInstance = m_instances[i];
       assert(pInstance != nullptr);
+      assert(pInstance->m_instanceVectorId == i);
+
+      // Only the frame state arrays are touched for instances that are still in use
+      const bool isMarkedForGC = m_frameState.isMarkedForGC[i];
+      if (!isMarkedForGC && m_frameState.frameLastUpdated[i] + numFramesToKeepInstances > currentFrame) {
+        ++i;
+        continue;
+      }
 
       const bool enableGarbageCollection =
-        !RtxOptions::AntiCulling::isObjectAntiCullingEnabled() || // It's always True if anti-culling is disabled
+        !isObjectAntiCullingEnabled || // It's always True if anti-culling is disabled
         (pInstance->m_isInsideFrustum) ||
         (pInstance->getBlas()->input.getSkinningState().numBones > 0) ||
         (pInstance->m_isAnimated) ||
         (pInstance->m_isPlayerModel);
 
-      if (((forceGarbageCollection || enableGarbageCollection) &&
-           pInstance->m_frameLastUpdated + numFramesToKeepInstances <= currentFrame) ||
-          pInstance->m_isMarkedForGC) {
+      if (forceGarbageCollection || enableGarbageCollection || isMarkedForGC) {
         // Note: Pop and swap for performance, index not incremented to process swapped instance on next iteration
         removeInstance(pInstance);
 
         // NOTE: pInstance is now the (previously) last element
         std::swap(pInstance, m_instances.back());
+        m_frameState.swapAndPopBack(i);
 
         m_instances[i]->m_instanceVectorId = i;
 
@@ -390,6 +465,27 @@ namespace dxvk {
     }
   }
 
+  void InstanceManager::findInstancesInsideFrustum(RtCamera& camera, const uint32_t planeCount, std::vector<uint8_t>& insideOut) {
+    ScopedCpuProfileZone();
+
+    const Matrix4d& worldToView = camera.getWorldToView(false);
+    const bool useBoundingBox = RtxOptions::needsMeshBoundingBox();
+
+    m_frustumTestBatch.clear();
+    for (const RtInstance* instance : m_instances) {
+      const Matrix4 objectToView = worldToView * instance->getTransform();
+      if (useBoundingBox && instance->getBlas() != nullptr) {
+        const AxisAlignedBoundingBox& boundingBox = instance->getBlas()->input.getGeometryData().boundingBox;
+        m_frustumTestBatch.add(boundingBox.minPos, boundingBox.maxPos, objectToView);
+      } else {
+        m_frustumTestBatch.add(Vector3(0.0f), Vector3(0.0f), objectToView);
+      }
+    }
+
+    insideOut.resize(m_instances.size());
+    boundingBoxBatchIntersectsFrustum(camera.getFrustum(), m_frustumTestBatch, planeCount, insideOut.data());
+  }
+
   void InstanceManager::onFrameEnd() {
     m_viewModelCandidates.clear();
     m_playerModelInstances.clear();
@@ -652,7 +748,7 @@ namespace dxvk {
       // (need to check a 2x2x2 patch of cells to account for positions close to a border)
       result = const_cast<RtInstance*>(blas.getSpatialMap().getNearestData(worldPosition, uniqueObjectDistanceSqr, nearestDistSqr,
         [&] (const RtInstance* instance) {
-          return instance->m_frameLastUpdated != currentFrameIdx && instance->m_materialHash == material.getHash();
+          return instance->getFrameLastUpdated() != currentFrameIdx && instance->m_materialHash == material.getHash();
         }
       ));
       if (nearestDistSqr == 0.0f && result != nullptr) {
@@ -668,7 +764,7 @@ namespace dxvk {
         RtxOptions::useRayPortalVirtualInstanceMatching() ) {
       const Matrix4* teleportMatrix = nullptr;
       for (const RtInstance* instance : blas.getLinkedInstances()) {
-        if (instance->m_frameLastUpdated != currentFrameIdx - 1 || 
+        if (instance->getFrameLastUpdated() != currentFrameIdx - 1 || 
             instance->m_materialHash != material.getHash()) {
           continue;
         }
@@ -720,8 +816,9 @@ namespace dxvk {
   RtInstance* InstanceManager::addInstance(BlasEntry& blas) {
     const uint32_t currentFrameIdx = m_device->getCurrentFrameId();
 
-    const uint32_t instanceIdx = m_instances.size();
-    RtInstance* newInst = new RtInstance(m_nextInstanceId++, instanceIdx);
+    const uint32_t instanceIdx = m_frameState.add();
+    assert(instanceIdx == m_instances.size());
+    RtInstance* newInst = new RtInstance(m_instanceIdPool.allocate(), instanceIdx, m_frameState);
     m_instances.push_back(newInst);
 
     RtInstance* currentInstance = m_instances[instanceIdx];
@@ -750,14 +847,13 @@ namespace dxvk {
   }
 
   // Creates a copy of an instance
-  // If the copy is temporary and is not tracked via callbacks/externally, it doesn't need
-  // a valid unique instance ID. In that case, set generateValidID to false to avoid overflowing the ID value
-  RtInstance* InstanceManager::createInstanceCopy(const RtInstance& reference, bool generateValidID) {
+  // Temporary copies recreated every frame recycle the id slots of the previous frame's copies
+  RtInstance* InstanceManager::createInstanceCopy(const RtInstance& reference) {
 
-    const uint32_t instanceIdx = m_instances.size();
+    const uint32_t instanceIdx = m_frameState.add();
+    assert(instanceIdx == m_instances.size());
 
-    uint64_t id = generateValidID ? m_nextInstanceId++ : UINT64_MAX;
-    RtInstance* newInstance = new RtInstance(reference, id, instanceIdx);
+    RtInstance* newInstance = new RtInstance(reference, m_instanceIdPool.allocate(), instanceIdx, m_frameState);
     newInstance->m_isCreatedByRenderer = true;
     m_instances.push_back(newInstance);
 
@@ -1159,13 +1255,40 @@ namespace dxvk {
     // In these cases we skip calling onInstanceDestroyed:
     //   Some view model and player instances are created in the renderer and don't have onInstanceAdded called,
     //   so not call onInstanceDestroyed either.
-    if (instance->m_isCreatedByRenderer) {
-      return;
+    if (!instance->m_isCreatedByRenderer) {
+      for (auto& event : m_eventHandlers) {
+        event.onInstanceDestroyedCallback(*instance);
+      }
     }
 
-    
-    for (auto& event : m_eventHandlers) {
-      event.onInstanceDestroyedCallback(*instance);
+    // Kept view model instances are normally released through releaseStaleViewModelInstances, this covers forced removals
+    if (instance->m_isCreatedByRenderer && instance->isViewModel()) {
+      for (auto it = m_viewModelInstances.begin(); it != m_viewModelInstances.end(); ++it) {
+        if (it->second == instance) {
+          m_viewModelInstances.erase(it);
+          break;
+        }
+      }
+    }
+
+    m_instanceIdPool.release(instance->getId());
+  }
+
+  void InstanceManager::releaseStaleViewModelInstances(uint32_t frameId) {
+    for (auto it = m_viewModelInstances.begin(); it != m_viewModelInstances.end();) {
+      RtInstance* viewModelInstance = it->second;
+      if (viewModelInstance->getFrameLastUpdated() == frameId) {
+        ++it;
+        continue;
+      }
+
+      // The instance stays in the instance list until the next garbage collection, keep it out of this frame's TLAS
+      // and out of the reference view model handling that a zero mask would otherwise opt it into
+      viewModelInstance->m_vkInstance.mask = 0;
+      viewModelInstance->setCustomIndexBit(CUSTOM_INDEX_IS_VIEW_MODEL, false);
+      viewModelInstance->m_billboardCount = 0;
+      viewModelInstance->markForGarbageCollection();
+      it = m_viewModelInstances.erase(it);
     }
   }
 
@@ -1174,22 +1297,24 @@ namespace dxvk {
                                                        const Matrix4d& perspectiveCorrection,
                                                        const Matrix4d& prevPerspectiveCorrection) {
 
-    // Create a view model instance corresponding to the reference instance, for one frame 
+    // Create a view model instance corresponding to the reference instance. The instance is kept for as long as the reference
+    // keeps being drawn with the view model camera and is only refreshed from it in later frames, so first person models don't
+    // add a new instance (and a new surface without a previous frame counterpart) every frame.
 
-    // Don't pollute global instance id with View Models since they're not tracked in game capturer
-    const bool needValidGlobalInstanceId = false;
+    const uint32_t frameId = m_device->getCurrentFrameId();
 
-    RtInstance* viewModelInstance = createInstanceCopy(reference, needValidGlobalInstanceId);
+    RtInstance*& viewModelInstance = m_viewModelInstances[reference.getId()];
+    if (viewModelInstance == nullptr) {
+      viewModelInstance = createInstanceCopy(reference);
+      viewModelInstance->setFrameCreated(frameId);
+    } else {
+      viewModelInstance->copyStateFrom(reference);
+    }
 
-    const uint32_t frameId = m_device->getCurrentFrameId();
-    viewModelInstance->setFrameCreated(frameId);
     viewModelInstance->setFrameLastUpdated(frameId);
     viewModelInstance->m_vkInstance.mask = OBJECT_MASK_VIEWMODEL;
     viewModelInstance->setCustomIndexBit(CUSTOM_INDEX_IS_VIEW_MODEL, true);
 
-    // View model instances are recreated every frame
-    viewModelInstance->markForGarbageCollection();
-
     if (RtxOptions::ViewModel::perspectiveCorrection()) {
       // A transform that looks "correct" only from a main camera's point of view
       const auto corrected = perspectiveCorrection * reference.getTransform();
@@ -1226,7 +1351,7 @@ namespace dxvk {
 
     // Note this is an instance copy of a input reference. It is unknown to the source engine, so we don't call onInstanceAdded callbacks for it
     // It also results in this instance not being linked to reference instance BLAS and thus not considered in findSimilarInstances' lookups
-    // This is desired as ViewModel instances are not to be linked frame to frame
+    // This is desired as ViewModel instances are only linked frame to frame through their reference
 
     return viewModelInstance;
   }
@@ -1236,17 +1361,19 @@ namespace dxvk {
                                                  const RayPortalManager& rayPortalManager) {
     ScopedGpuProfileZone(ctx, "ViewModel");
 
-    if (!RtxOptions::ViewModel::enable())
-      return;
+    const uint32_t frameId = m_device->getCurrentFrameId();
 
-    if (!cameraManager.isCameraValid(CameraType::ViewModel))
+    if (!RtxOptions::ViewModel::enable() || !cameraManager.isCameraValid(CameraType::ViewModel)) {
+      releaseStaleViewModelInstances(frameId);
       return;
+    }
 
     // If the first person player model is enabled, hide the view model.
     if (RtxOptions::PlayerModel::enableInPrimarySpace()) {
       for (auto* candidateInstance : m_viewModelCandidates) {
         candidateInstance->m_vkInstance.mask = 0;
       }
+      releaseStaleViewModelInstances(frameId);
       return;
     }
 
@@ -1299,6 +1426,8 @@ namespace dxvk {
       viewModelInstances.push_back(createViewModelInstance(ctx, *candidateInstance, perspectiveCorrection, prevPerspectiveCorrection));
     }
 
+    releaseStaleViewModelInstances(frameId);
+
     // Create virtual instances for the view model instances
     createRayPortalVirtualViewModelInstances(viewModelInstances, cameraManager, rayPortalManager);
   }
@@ -1551,10 +1680,7 @@ namespace dxvk {
       if (!createVirtualInstances)
         continue;
       
-      // Don't pollute global instance id with Player Models since they're not tracked in game capturer
-      const bool needValidGlobalInstanceId = false;
-
-      RtInstance* clonedInstance = createInstanceCopy(*originalInstance, needValidGlobalInstanceId);
+      RtInstance* clonedInstance = createInstanceCopy(*originalInstance);
       
       clonedInstance->setFrameCreated(frameId);
       clonedInstance->setFrameLastUpdated(frameId);
@@ -1678,15 +1804,32 @@ namespace dxvk {
     
     const uint32_t frameId = m_device->getCurrentFrameId();
 
+    // A virtual instance sits as far from the opposing portal as its reference is from the closest one,
+    // so references out of view model range of the portal opening would only add instances no ray reaches
+    const float maxDistanceToPortal = RtxOptions::ViewModel::rangeMeters() * RtxOptions::getMeterToWorldUnitScale() +
+      length(closestPortalInfo.entryPortalInfo.planeHalfExtents);
+    const Vector3& portalCentroid = closestPortalInfo.entryPortalInfo.centroid;
+
     // Create virtual instances for view model instances that are close to portals
     for (RtInstance* referenceInstance : viewModelReferenceInstances) {
 
-      // Create a view model virtual instance corresponding to the view model instance, for one frame
+      const AxisAlignedBoundingBox& boundingBox = referenceInstance->getBlas()->input.getGeometryData().boundingBox;
+
+      if (boundingBox.isValid()) {
+        const AxisAlignedBoundingBox worldBoundingBox = boundingBox.getTransformed(referenceInstance->getTransform());
+        Vector3 closestPoint;
+
+        for (uint32_t i = 0; i < 3; i++) {
+          closestPoint[i] = std::clamp(portalCentroid[i], worldBoundingBox.minPos[i], worldBoundingBox.maxPos[i]);
+        }
+
+        if (length(closestPoint - portalCentroid) > maxDistanceToPortal)
+          continue;
+      }
 
-      // Don't pollute global instance id with View Models since they're not tracked in game capturer
-      const bool needValidGlobalInstanceId = false;
+      // Create a view model virtual instance corresponding to the view model instance, for one frame
 
-      RtInstance* virtualInstance = createInstanceCopy(*referenceInstance, needValidGlobalInstanceId);
+      RtInstance* virtualInstance = createInstanceCopy(*referenceInstance);
 
       virtualInstance->setFrameCreated(frameId);
       virtualInstance->setFrameLastUpdated(frameId);
@@ -1711,8 +1854,7 @@ namespace dxvk {
   }
 
   void InstanceManager::resetSurfaceIndices() {
-    for (auto instance : m_instances)
-      instance->m_surfaceIndex = BINDING_INDEX_INVALID;
+    std::fill(m_frameState.surfaceIndex.begin(), m_frameState.surfaceIndex.end(), BINDING_INDEX_INVALID);
   }
 
   inline bool isFpSpecial(float x) {
@@ -1748,6 +1890,11 @@ namespace dxvk {
 
     const Matrix4 instanceTransform = instance.getTransform();
 
+    // The texcoord and opacity hashes only identify billboard OMMs, skip them when OMMs are off
+    const bool calculateOmmHashes = RtxOptions::getEnableOpacityMicromap();
+
+    m_billboards.reserve(m_billboards.size() + geometryData.indexCount / indicesPerQuad);
+
     // Go over all quads in this draw call.
     // Note: decals are often batched into a few draw calls, and we want to offset each decal separately.
     for (int indexOffset = 0; indexOffset + indicesPerQuad <= geometryData.indexCount; indexOffset += indicesPerQuad) {
@@ -1784,7 +1931,7 @@ namespace dxvk {
         if (hasNonIdentityTextureTransform)
           texcoords[idx] = (instance.surface.textureTransform * Vector4(texcoords[idx].x, texcoords[idx].y, 0.f, 1.f)).xy();
 
-        if (bufferData.vertexColorData)
+        if (bufferData.vertexColorData && calculateOmmHashes)
           vertexOpacities8bit[idx] = bufferData.getVertexColor(indices[idx]) >> 24;
       }
 
@@ -1832,10 +1979,12 @@ namespace dxvk {
       const Vector2 yVectorUV { texcoords[1] - texcoords[0] };
       const Vector2 centerUV { (texcoords[2] + texcoords[0]) * 0.5f };
 
-      // Fill in data for the quad's last/4th vertex
-      texcoords[3] = bufferData.getTexCoord(indices[5]);
-      if (bufferData.vertexColorData)
-        vertexOpacities8bit[3] = bufferData.getVertexColor(indices[5]) >> 24;
+      // Fill in data for the quad's last/4th vertex, it's only needed for the hashes
+      if (calculateOmmHashes) {
+        texcoords[3] = bufferData.getTexCoord(indices[5]);
+        if (bufferData.vertexColorData)
+          vertexOpacities8bit[3] = bufferData.getVertexColor(indices[5]) >> 24;
+      }
 
       billboard.center = center;
       billboard.xAxis = xVector / xLength;
@@ -1848,8 +1997,8 @@ namespace dxvk {
       billboard.instance = &instance;
       billboard.vertexColor = vertexColor;
       billboard.instanceMask = instance.getVkInstance().mask & OBJECT_MASK_UNORDERED_ALL_INTERSECTION_PRIMITIVE;
-      billboard.texCoordHash = XXH64(texcoords, sizeof(texcoords), kEmptyHash);
-      billboard.vertexOpacityHash = XXH64(vertexOpacities8bit, sizeof(vertexOpacities8bit), kEmptyHash);
+      billboard.texCoordHash = calculateOmmHashes ? XXH64(texcoords, sizeof(texcoords), kEmptyHash) : kEmptyHash;
+      billboard.vertexOpacityHash = calculateOmmHashes ? XXH64(vertexOpacities8bit, sizeof(vertexOpacities8bit), kEmptyHash) : kEmptyHash;
       billboard.allowAsIntersectionPrimitive = true;
       billboard.isBeam = false;
       billboard.isCameraFacing = isCameraFacing;
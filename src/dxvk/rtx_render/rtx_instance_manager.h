@@ -30,6 +30,7 @@
 #include "../util/util_vector.h"
 #include "../util/util_matrix.h"
 #include "rtx_camera_manager.h"
+#include "rtx_intersection_test_helpers.h"
 #include "dxvk_cmdlist.h"
 #include "rtx_opacity_micromap_manager.h"
 
@@ -40,16 +41,56 @@ class DxvkDevice;
 class ResourceCache;
 class CameraManager;
 
+// Per-frame state of every instance in the instance manager, kept in arrays indexed by the instance vector id
+// rather than in RtInstance itself so that the passes over all instances each frame stay cache linear.
+struct InstanceFrameState {
+  std::vector<uint32_t> frameLastUpdated;
+  std::vector<uint32_t> surfaceIndex;
+  std::vector<uint8_t> isMarkedForGC;
+
+  uint32_t size() const { return frameLastUpdated.size(); }
+
+  // Returns the vector id for the new instance
+  uint32_t add();
+  // Moves the last instance's state into the given slot, matching a swap and pop of the instance vector
+  void swapAndPopBack(uint32_t instanceVectorId);
+  void clear();
+};
+
+// Hands out instance ids made of a slot index and the slot's generation. Slots are recycled once their instance
+// is destroyed, with the generation bumped, so the ids of short lived instances never run out and a destroyed
+// instance's id never matches a later instance. UINT64_MAX is never handed out and remains the invalid id.
+class InstanceIdPool {
+public:
+  static uint32_t getIndex(uint64_t id) { return static_cast<uint32_t>(id); }
+  static uint32_t getGeneration(uint64_t id) { return static_cast<uint32_t>(id >> 32); }
+
+  uint64_t allocate();
+  void release(uint64_t id);
+  // Returns true if the id belongs to an instance that has not been destroyed yet
+  bool isAlive(uint64_t id) const;
+
+  uint32_t getSlotCount() const { return m_generations.size(); }
+
+private:
+  static uint64_t makeId(uint32_t index, uint32_t generation) { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+  std::vector<uint32_t> m_generations;
+  std::vector<uint8_t> m_isSlotAlive;
+  std::vector<uint32_t> m_freeIndices;
+};
+
 // RtInstance defines a SceneObjects placement/parameterization within the current scene.
 class RtInstance {
 public:
   RtSurface surface;
 
   RtInstance() = delete;
-  RtInstance(const uint64_t id, uint32_t instanceVectorId);
-  RtInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId);
+  RtInstance(const uint64_t id, uint32_t instanceVectorId, InstanceFrameState& frameState);
+  RtInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId, InstanceFrameState& frameState);
 
   uint64_t getId() const { return m_id; }
+  uint32_t getInstanceVectorId() const { return m_instanceVectorId; }
   const VkAccelerationStructureInstanceKHR& getVkInstance() const { return m_vkInstance; }
   VkAccelerationStructureInstanceKHR& getVkInstance() { return m_vkInstance; }
   bool isObjectToWorldMirrored() const { return m_isObjectToWorldMirrored; }
@@ -91,8 +132,8 @@ public:
   void setFrameCreated(const uint32_t frameIndex);
   // Returns if this is the first occurence in a given frame
   bool setFrameLastUpdated(const uint32_t frameIndex);
-  uint32_t getFrameLastUpdated() const { return m_frameLastUpdated; } 
-  uint32_t getFrameAge() const { return m_frameLastUpdated - m_frameCreated; }
+  uint32_t getFrameLastUpdated() const { return m_frameState->frameLastUpdated[m_instanceVectorId]; } 
+  uint32_t getFrameAge() const { return getFrameLastUpdated() - m_frameCreated; }
   // Signal this object should be collected on the next GC pass
   void markForGarbageCollection() const;
   void markAsUnlinkedFromBlasEntryForGarbageCollection() const;
@@ -119,10 +160,10 @@ public:
     return m_isAnimated;
   }
   void setSurfaceIndex(uint32_t surfaceIndex) {
-    m_surfaceIndex = surfaceIndex;
+    m_frameState->surfaceIndex[m_instanceVectorId] = surfaceIndex;
   }
   uint32_t getSurfaceIndex() const {
-    return m_surfaceIndex;
+    return m_frameState->surfaceIndex[m_instanceVectorId];
   }
   void setPreviousSurfaceIndex(uint32_t surfaceIndex) {
     m_previousSurfaceIndex = surfaceIndex;
@@ -148,6 +189,8 @@ public:
   bool isViewModelVirtual() const;
 
   bool isUnlinkedForGC() const { return m_isUnlinkedForGC; }
+  // Instances created by the renderer (view model, player model and portal virtual instances) are unknown to the game
+  bool isCreatedByRenderer() const { return m_isCreatedByRenderer; }
 private:
 
   Matrix4 calcFirstInstanceObjectToWorld() {
@@ -157,18 +200,18 @@ private:
     return surface.objectToWorld;
   }
   void onTransformChanged();
+  // Copies everything but the identity, frame tracking and previous surface index of another instance
+  void copyStateFrom(const RtInstance& src);
   friend class InstanceManager;
 
-  // Unique ID of the RtInstance.
-  // Sentinel value UINT64_MAX indicates that such RtInstance is a "virtual" instance, and is ignored by some features,
-  // most notably the GameCapturer
+  // Unique ID of the RtInstance, allocated from the instance manager's InstanceIdPool
   const uint64_t m_id;
   mutable uint32_t m_instanceVectorId; // Index within instance vector in instance manager
+  // Frame last updated, surface index and GC mark live in the instance manager's arrays at m_instanceVectorId
+  InstanceFrameState* const m_frameState;
 
-  mutable bool m_isMarkedForGC = false;
   mutable bool m_isUnlinkedForGC = false;
   mutable bool m_isInsideFrustum = true;
-  mutable uint32_t m_frameLastUpdated = kInvalidFrameIndex;
   mutable uint32_t m_frameCreated = kInvalidFrameIndex;
 
   std::vector<CameraType::Enum> m_seenCameraTypes;  // Camera types with which the instance has been originally rendered with
@@ -187,8 +230,7 @@ private:
   // Stored in instance object to avoid indirection of looking it up for an instance
   OpacityMicromapInstanceData m_opacityMicromapInstanceData;
 
-  uint32_t m_surfaceIndex;        // Material surface index for reordered surfaces by AccelManager
-  uint32_t m_previousSurfaceIndex;
+  uint32_t m_previousSurfaceIndex; // Material surface index from the previous frame, the current one is kept in InstanceFrameState
 
   bool m_isHidden = false;
   bool m_isPlayerModel = false;
@@ -267,6 +309,10 @@ public:
 
   // Returns the active number of instances in scene
   const uint32_t getActiveCount() const { return m_instances.size(); }
+
+  // Tests the bounding boxes of all instances against the camera frustum in a single batch. insideOut is indexed
+  // like the instance table, instances without a known bounding box are tested by their origin.
+  void findInstancesInsideFrustum(RtCamera& camera, const uint32_t planeCount, std::vector<uint8_t>& insideOut);
   
   void onFrameEnd();
 
@@ -289,10 +335,12 @@ public:
     BlasEntry& blas, const DrawCallState& drawCall, const MaterialData& materialData, const RtSurfaceMaterial& material);
 
   // Creates a copy of a reference instance and adds it to the instance pool
-  // Temporary single frame instances generated every frame should disable valid id generation to avoid overflowing it
-  RtInstance* createInstanceCopy(const RtInstance& reference, bool generateValidID = true);
+  RtInstance* createInstanceCopy(const RtInstance& reference);
 
-  // Creates a view model instance from the reference and adds it to the instance pool
+  // Returns true if the id refers to an instance that is currently tracked by the manager
+  bool isInstanceIdAlive(uint64_t id) const { return m_instanceIdPool.isAlive(id); }
+
+  // Creates a view model instance from the reference and adds it to the instance pool, or updates the one created for it in an earlier frame
   RtInstance* createViewModelInstance(Rc<DxvkContext> ctx, const RtInstance& reference, const Matrix4d& perspectiveCorrection, const Matrix4d& prevPerspectiveCorrection);
 
   // Creates view model instances and their virtual counterparts
@@ -314,12 +362,16 @@ public:
 private:
   ResourceCache* m_pResourceCache;
 
-  uint64_t m_nextInstanceId = 0;
+  InstanceIdPool m_instanceIdPool;
 
   std::vector<RtInstance*> m_instances; 
+  InstanceFrameState m_frameState;
   std::vector<RtInstance*> m_viewModelCandidates;
+  // View model instances kept across frames, keyed by the id of their reference instance
+  std::unordered_map<uint64_t, RtInstance*> m_viewModelInstances;
   std::vector<RtInstance*> m_playerModelInstances;
   std::vector<IntersectionBillboard> m_billboards;
+  BoundingBoxBatch m_frustumTestBatch;
 
   bool m_previousViewModelState = false;
   RtInstance* targetInstance = nullptr;
@@ -347,6 +399,9 @@ private:
 
   void removeInstance(RtInstance* instance);
 
+  // Hides and schedules for removal the kept view model instances whose reference was not drawn with the view model camera this frame
+  void releaseStaleViewModelInstances(uint32_t frameId);
+
   static RtSurface::AlphaState calculateAlphaState(const DrawCallState& drawCall, const MaterialData& materialData, const RtSurfaceMaterial& material);
 
   // Modifies an instance given active developer options. Returns true if the instance was modified
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "MathLib/MathLib.h"
 #include "../util/util_matrix.h"
@@ -131,6 +132,122 @@ static inline bool boundingBoxIntersectsFrustum(
   return true;
 }
 
+// View space bounding boxes of many objects, packed as structure of arrays for the batch frustum check below.
+// Each box is kept as its center and 3 half extent axes, so it stays exact under any object to view transform.
+struct BoundingBoxBatch {
+  std::vector<float> center[3];
+  std::vector<float> halfAxis[3][3]; // [axis][component]
+
+  uint32_t size() const {
+    return (uint32_t) center[0].size();
+  }
+
+  void clear() {
+    for (uint32_t c = 0; c < 3; ++c) {
+      center[c].clear();
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        halfAxis[axis][c].clear();
+      }
+    }
+  }
+
+  void add(const dxvk::Vector3& minPos, const dxvk::Vector3& maxPos, const dxvk::Matrix4& objectToView) {
+    const dxvk::Vector4 centerView = objectToView * dxvk::Vector4((minPos + maxPos) * 0.5f, 1.0f);
+    const dxvk::Vector3 halfExtent = (maxPos - minPos) * 0.5f;
+    const std::array axisView {
+      objectToView * dxvk::Vector4(halfExtent.x, 0.0f, 0.0f, 0.0f),
+      objectToView * dxvk::Vector4(0.0f, halfExtent.y, 0.0f, 0.0f),
+      objectToView * dxvk::Vector4(0.0f, 0.0f, halfExtent.z, 0.0f)
+    };
+
+    for (uint32_t c = 0; c < 3; ++c) {
+      center[c].push_back(centerView[c]);
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        halfAxis[axis][c].push_back(axisView[axis][c]);
+      }
+    }
+  }
+};
+
+// Batch BoundingBox-Frustum intersection check, 4 boxes at a time with SSE.
+// Writes 0 to insideOut for every box that lies fully outside one of the first planeCount planes and 1 otherwise.
+// This is a conservative test, boundingBoxIntersectsFrustumSATInternal can only reject more boxes.
+static inline void boundingBoxBatchIntersectsFrustum(
+  cFrustum& frustum,               // The frustum check for intersection
+  const BoundingBoxBatch& batch,   // View space bounding boxes to check
+  const uint32_t planeCount,       // Number of frustum planes to check, e.g. PLANES_NO_FAR for an infinite far plane
+  uint8_t* insideOut) {            // One result per box in the batch
+  const uint32_t count = batch.size();
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+
+  // A box is outside a plane when its center is further behind it than the box's extent along the plane normal
+  auto testBoxes = [&](const __m128 (&center)[3], const __m128 (&halfAxis)[3][3]) -> int {
+    __m128 outside = _mm_setzero_ps();
+    for (uint32_t planeIdx = 0; planeIdx < planeCount; ++planeIdx) {
+      const float4 plane = frustum.GetPlane(planeIdx);
+      const __m128 nx = _mm_set1_ps(plane.x);
+      const __m128 ny = _mm_set1_ps(plane.y);
+      const __m128 nz = _mm_set1_ps(plane.z);
+
+      const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, center[0]), _mm_mul_ps(ny, center[1])),
+                                         _mm_add_ps(_mm_mul_ps(nz, center[2]), _mm_set1_ps(plane.w)));
+      __m128 extent = _mm_setzero_ps();
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        const __m128 projection = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, halfAxis[axis][0]), _mm_mul_ps(ny, halfAxis[axis][1])),
+                                             _mm_mul_ps(nz, halfAxis[axis][2]));
+        extent = _mm_add_ps(extent, _mm_andnot_ps(signMask, projection));
+      }
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, extent), _mm_setzero_ps()));
+    }
+    return _mm_movemask_ps(outside);
+  };
+
+  uint32_t first = 0;
+  for (; first + 4 <= count; first += 4) {
+    __m128 center[3];
+    __m128 halfAxis[3][3];
+    for (uint32_t c = 0; c < 3; ++c) {
+      center[c] = _mm_loadu_ps(&batch.center[c][first]);
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        halfAxis[axis][c] = _mm_loadu_ps(&batch.halfAxis[axis][c][first]);
+      }
+    }
+
+    const int outsideMask = testBoxes(center, halfAxis);
+    for (uint32_t i = 0; i < 4; ++i) {
+      insideOut[first + i] = (outsideMask & (1 << i)) ? 0 : 1;
+    }
+  }
+
+  // Remaining boxes, the unused lanes are zero and their results are dropped
+  if (first < count) {
+    alignas(16) float center[3][4] = {};
+    alignas(16) float halfAxis[3][3][4] = {};
+    for (uint32_t i = first; i < count; ++i) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        center[c][i - first] = batch.center[c][i];
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          halfAxis[axis][c][i - first] = batch.halfAxis[axis][c][i];
+        }
+      }
+    }
+
+    __m128 centerSimd[3];
+    __m128 halfAxisSimd[3][3];
+    for (uint32_t c = 0; c < 3; ++c) {
+      centerSimd[c] = _mm_load_ps(center[c]);
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        halfAxisSimd[axis][c] = _mm_load_ps(halfAxis[axis][c]);
+      }
+    }
+
+    const int outsideMask = testBoxes(centerSimd, halfAxisSimd);
+    for (uint32_t i = first; i < count; ++i) {
+      insideOut[i] = (outsideMask & (1 << (i - first))) ? 0 : 1;
+    }
+  }
+}
+
 // Internal function for Robust BoundingBox-Frustum intersection check with Separation Axis Theorem (SAT)
 static bool boundingBoxIntersectsFrustumSATInternal(
   const dxvk::Vector3& minPos,                 // The minimum position of AABB bounding box of the object
@@ -21,6 +21,7 @@
 */
 #include "rtx_io.h"
 #include "../../util/log/log.h"
+#include "../../util/util_env.h"
 
 #ifdef WITH_RTXIO
 
@@ -136,6 +137,21 @@ namespace dxvk {
     return true;
   }
 
+  size_t RtxIo::calcMemoryBudgetMB() const {
+    if (!adaptiveMemoryBudget()) {
+      return memoryBudgetMB();
+    }
+
+    uint64_t availableSize;
+    if (!env::getAvailableSystemPhysicalMemory(availableSize)) {
+      return memoryBudgetMB();
+    }
+
+    // Leave the vast majority of the system memory to the game and the rest of the runtime
+    const size_t budgetMB = static_cast<size_t>(availableSize / 16 / (1024 * 1024));
+    return std::clamp(budgetMB, memoryBudgetMB(), std::max(memoryBudgetMB(), maxMemoryBudgetMB()));
+  }
+
   void RtxIo::updateMemoryStats(int64_t memAdjustmentMB) {
     if (m_device == nullptr) {
       return;
@@ -236,7 +252,8 @@ namespace dxvk {
 
     RTXIOInstanceDesc instanceDesc{ RTXIO_VERSION };
     instanceDesc.flags = RTXIO_VULKAN + RTXIO_SCHEDULE_BULK;
-    instanceDesc.memoryBudget = memoryBudgetMB() * 1024 * 1024;
+    m_memoryBudgetMB = calcMemoryBudgetMB();
+    instanceDesc.memoryBudget = m_memoryBudgetMB * 1024 * 1024;
     instanceDesc.queueCapacity = 2048;
     instanceDesc.shareDevice = &vkDevice;
 
@@ -256,8 +273,10 @@ namespace dxvk {
     }
 
     m_device = device;
+    m_targetBatchSize = kSmallBatchSize;
 
-    updateMemoryStats(memoryBudgetMB());
+    Logger::info(str::format("RTX IO staging memory budget: ", m_memoryBudgetMB, " MB"));
+    updateMemoryStats(m_memoryBudgetMB);
 
     return true;
   }
@@ -272,7 +291,7 @@ namespace dxvk {
     }
 
     m_rtxio = nullptr;
-    updateMemoryStats(-static_cast<int64_t>(memoryBudgetMB()));
+    updateMemoryStats(-static_cast<int64_t>(m_memoryBudgetMB));
 
     m_device = nullptr;
   }
@@ -307,46 +326,64 @@ namespace dxvk {
   }
 
   uint64_t RtxIo::enqueueRead(const ImageDest& dst, const FileSource& src) {
-    assert(dst.image != nullptr && "Image is a nullptr");
-    assert(dst.image->handle() != VK_NULL_HANDLE && "Image handle is null");
-
-    RTXIOUpdateRequest req;
-
-    req.source.type = RTXIO_SRC_FILE;
-    req.source.compression = src.isCompressed ?
-      RTXIO_COMPRESSION_GDEFLATE_1_0 : RTXIO_COMPRESSION_NONE;
-    req.source.flags = 0;
-    req.source.encryptionContext = 0;
-    req.source.file = src.file;
-    req.source.offset = src.offset;
-    req.source.size = src.size;
-
-    // Add slack to account for disk sector overread and alignment
-    const size_t sizeWithSlack = src.size + 4096 + kRtxIoDataAlignment;
-
-    const auto& imageInfo = dst.image->info();
-
-    RTXIOVkImage vkImage;
-    vkImage.image = dst.image->handle();
-    vkImage.type = imageInfo.type;
-    vkImage.format = imageInfo.format;
-    vkImage.extent = imageInfo.extent;
-    vkImage.mipLevels = imageInfo.mipLevels;
-    vkImage.arrayLayers = imageInfo.numLayers;
-
-    req.destination.type = RTXIO_DST_SUBRESOURCE_RANGE;
-    req.destination.flags = RTXIO_DST_STATE_READ_OPTIMAL;
-    req.destination.resource = &vkImage;
-    req.destination.subresourceRange.first =
-      rtxioVulkanGetSubresourceIndex(dst.startMip, dst.startSlice, dst.count);
-    req.destination.subresourceRange.count = dst.count;
+    const Read read { dst, src };
+    return enqueueReads(&read, 1);
+  }
+
+  uint64_t RtxIo::enqueueReads(const Read* reads, uint32_t count) {
+    if (count == 0) {
+      return 0;
+    }
+
+    std::vector<RTXIOUpdateRequest> reqs(count);
+    std::vector<RTXIOVkImage> vkImages(count);
+    size_t sizeWithSlack = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+      const ImageDest& dst = reads[i].dst;
+      const FileSource& src = reads[i].src;
+
+      assert(dst.image != nullptr && "Image is a nullptr");
+      assert(dst.image->handle() != VK_NULL_HANDLE && "Image handle is null");
+
+      RTXIOUpdateRequest& req = reqs[i];
+
+      req.source.type = RTXIO_SRC_FILE;
+      req.source.compression = src.isCompressed ?
+        RTXIO_COMPRESSION_GDEFLATE_1_0 : RTXIO_COMPRESSION_NONE;
+      req.source.flags = 0;
+      req.source.encryptionContext = 0;
+      req.source.file = src.file;
+      req.source.offset = src.offset;
+      req.source.size = src.size;
+
+      // Add slack to account for disk sector overread and alignment
+      sizeWithSlack += src.size + 4096 + kRtxIoDataAlignment;
+
+      const auto& imageInfo = dst.image->info();
+
+      RTXIOVkImage& vkImage = vkImages[i];
+      vkImage.image = dst.image->handle();
+      vkImage.type = imageInfo.type;
+      vkImage.format = imageInfo.format;
+      vkImage.extent = imageInfo.extent;
+      vkImage.mipLevels = imageInfo.mipLevels;
+      vkImage.arrayLayers = imageInfo.numLayers;
+
+      req.destination.type = RTXIO_DST_SUBRESOURCE_RANGE;
+      req.destination.flags = RTXIO_DST_STATE_READ_OPTIMAL;
+      req.destination.resource = &vkImage;
+      req.destination.subresourceRange.first =
+        rtxioVulkanGetSubresourceIndex(dst.startMip, dst.startSlice, dst.count);
+      req.destination.subresourceRange.count = dst.count;
+    }
 
     // Although RTXIO enqueue API is thread-safe, it may interfere
     // with RTXIO flushes which at the moment are not guaranteed to happen
     // serially with the enqueues. Hold flush lock.
     std::lock_guard<dxvk::mutex> _(m_flushMutex);
 
-    if (auto result = rtxioEnqueueUpdateRequests(m_rtxio, 0, 1, &req)) {
+    if (auto result = rtxioEnqueueUpdateRequests(m_rtxio, 0, count, reqs.data())) {
       Logger::err(str::format("RTX IO request enqueue failed with ", result));
       return 0;
     }
@@ -383,7 +420,7 @@ namespace dxvk {
 
       // Check if there's too little data and we're
       // dispatching it too fast.
-      if (m_sizeInFlight == 0 || (m_sizeInFlight < kSmallBatchSize &&
+      if (m_sizeInFlight == 0 || (m_sizeInFlight < m_targetBatchSize &&
           framesSinceFlush < kSmallBatchPeriod)) {
         return false;
       }
@@ -409,6 +446,8 @@ namespace dxvk {
     m_sizeInFlight = 0;
     m_lastFlushFrame = m_device->getCurrentFrameId();
 
+    updateTargetBatchSize();
+
 #ifdef DEBUG
     dumpStats();
 #endif
@@ -416,6 +455,27 @@ namespace dxvk {
     return true;
   }
 
+  void RtxIo::updateTargetBatchSize() {
+    if (!adaptiveBatching()) {
+      m_targetBatchSize = kSmallBatchSize;
+      return;
+    }
+
+    uint64_t decodeTimeUs, totalInBytes;
+    rtxioGetCounter(m_rtxio, RTXIO_COUNTER_DECODE_TIME_US, 0, &decodeTimeUs);
+    rtxioGetCounter(m_rtxio, RTXIO_COUNTER_TOTAL_INPUT_BYTES, 0, &totalInBytes);
+
+    if (decodeTimeUs == 0) {
+      return;
+    }
+
+    // Never hold back more than half of the staging budget, RTX IO
+    // would have to stall on the first half to make room otherwise.
+    const size_t bytesPerUs = static_cast<size_t>(totalInBytes / decodeTimeUs);
+    const size_t maxBatchSize = std::max<size_t>(kSmallBatchSize, m_memoryBudgetMB * 1024 * 1024 / 2);
+    m_targetBatchSize = std::clamp<size_t>(bytesPerUs * kTargetBatchDecodeTimeUs, kSmallBatchSize, maxBatchSize);
+  }
+
   void RtxIo::dumpStats() const {
     uint64_t uploadTimeUs, flushTimeUs, copyTimeUs, readbackTimeUs, cmdBuffTimeUs, ioTimeUs,
       executionTimeUs;
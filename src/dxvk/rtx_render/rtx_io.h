@@ -65,6 +65,9 @@ namespace dxvk {
     // Calculated for 64 64KB tiles at ~1.66 ratio.
     static constexpr uint32_t kSmallBatchSize = ((64 * 65536) * 5) / 3;
     static constexpr uint32_t kSmallBatchPeriod = 10;
+    // With adaptive batching a batch is sized to keep the decoder
+    // busy for this long at the throughput measured so far.
+    static constexpr uint64_t kTargetBatchDecodeTimeUs = 4000;
   public:
     typedef void* Handle;
 
@@ -97,6 +100,11 @@ namespace dxvk {
       const DxvkDeviceQueue& queue;
     };
 
+    struct Read {
+      ImageDest dst;
+      FileSource src;
+    };
+
     bool initialize(DxvkDevice* device);
     void release();
 
@@ -105,6 +113,9 @@ namespace dxvk {
 
     bool enqueueWait(const Rc<RtxSemaphore>& sema, uint64_t value);
     uint64_t enqueueRead(const ImageDest& dst, const FileSource& src);
+    // Enqueues the reads with a single lock and request submission,
+    // returns the completion sync point of the whole set.
+    uint64_t enqueueReads(const Read* reads, uint32_t count);
     bool enqueueSignal(const Rc<RtxSemaphore>& sema, uint64_t value);
 
     bool isComplete(uint64_t syncpt) const;
@@ -122,7 +133,9 @@ namespace dxvk {
     void lockQueue(const DxvkDeviceQueue& queue);
     void unlockQueue(const DxvkDeviceQueue& queue);
 
+    size_t calcMemoryBudgetMB() const;
     void updateMemoryStats(int64_t memAdjustmentMB);
+    void updateTargetBatchSize();
     void dumpStats() const;
 
     DxvkDevice* m_device;
@@ -136,10 +149,20 @@ namespace dxvk {
 
     // TODO(iterentiev): implement real batching
     size_t m_sizeInFlight = 0;
+    size_t m_targetBatchSize = kSmallBatchSize;
+    size_t m_memoryBudgetMB = 0;
 
     uint32_t m_lastFlushFrame = 0;
 
-    RTX_OPTION("rtx.io", size_t, memoryBudgetMB, 256, "");
+    RTX_OPTION("rtx.io", size_t, memoryBudgetMB, 256, "The staging memory budget of RTX IO in megabytes. Used as the lower bound of the budget when adaptive memory budget is enabled.");
+    RTX_OPTION("rtx.io", bool, adaptiveMemoryBudget, false,
+      "When enabled the staging memory budget is sized from the system memory available when RTX IO is initialized, "
+      "between rtx.io.memoryBudgetMB and rtx.io.maxMemoryBudgetMB. A larger budget lets more requests be in flight during level streaming.");
+    RTX_OPTION("rtx.io", size_t, maxMemoryBudgetMB, 1024, "The upper bound of the staging memory budget in megabytes when adaptive memory budget is enabled.");
+    RTX_OPTION("rtx.io", bool, adaptiveBatching, false,
+      "When enabled asynchronous flushes accumulate requests until there is enough data to keep the decoder busy for a few milliseconds "
+      "at its measured throughput, instead of flushing as soon as a small fixed amount has been queued. "
+      "Batches are still flushed after a few frames, no matter their size.");
     RTX_OPTION("rtx.io", bool, useAsyncQueue, true, "");
     RTX_OPTION_ENV("rtx.io", bool, forceCpuDecoding, false, "DXVK_RTXIO_FORCE_CPU_DECODING",
       "Force CPU decoding in RTX IO.");
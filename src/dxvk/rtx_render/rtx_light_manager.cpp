@@ -19,6 +19,7 @@
 * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 * DEALINGS IN THE SOFTWARE.
 */
+#include <atomic>
 #include <vector>
 #include <cmath>
 #include <cassert>
@@ -27,6 +28,7 @@
 #include "rtx_context.h"
 #include "rtx_options.h"
 #include "rtx_utils.h"
+#include "rtx_thread_budget.h"
 
 #include "../d3d9/d3d9_state.h"
 #include "rtx/pass/common_binding_indices.h"
@@ -34,6 +36,7 @@
 #include "math.h"
 #include "rtx_lights.h"
 #include "rtx_intersection_test.h"
+#include "../../util/util_threadpool.h"
 
 /*  Light Manager (blurb)
 * 
@@ -162,57 +165,165 @@ namespace dxvk {
     garbageCollectionInternal();
   }
 
-  void LightManager::dynamicLightMatching() {
-    ScopedCpuProfileZone();
-    // Try match up any stragglers now we have the full light list this frame.
-    for (auto it = m_lights.cbegin(); it != m_lights.cend(); ) {
-      const RtLight& light = it->second;
-      // Only looking for instances of dynamic lights that have been updated on the previous frame
-      if (light.getFrameLastTouched() + 1 != m_device->getCurrentFrameId()) {
-        ++it;
-        continue;
+  namespace {
+    // Note: Splitting the matching over threads only pays off with at least this many lights to match per thread.
+    constexpr size_t kMinDynamicLightMatchesPerThread = 128;
+    constexpr size_t kDynamicLightMatchBatchSize = 32;
+
+    Vector3i getLightMatchingCell(const Vector3& position, float distanceThreshold) {
+      const Vector3 scaledPosition = position / distanceThreshold;
+      return Vector3i(int(std::floor(scaledPosition.x)), int(std::floor(scaledPosition.y)), int(std::floor(scaledPosition.z)));
+    }
+  }
+
+  RtLight* LightManager::findDynamicLightMatch(const RtLight& light, float distanceThreshold) const {
+    float currentSimilarity = -1.f;
+    RtLight* similarLight = nullptr;
+
+    auto considerLight = [&](RtLight* newLight) {
+      // Skip lights already matched to an earlier light, which no longer count as new.
+      if (newLight->getBufferIdx() != kNewLightIdx) {
+        return;
       }
-      // Only interested in updating lights that have been around a while, this implicitly avoids searching for new lights that have been updated.
-      if (light.getBufferIdx() == kNewLightIdx) {
-        ++it;
-        continue;
+
+      const float similarity = isSimilar(light, *newLight, distanceThreshold);
+      if (similarity > currentSimilarity) {
+        similarLight = newLight;
+        currentSimilarity = similarity;
+      }
+    };
+
+    if (light.getType() == RtLightType::Distant) {
+      for (RtLight* newLight : m_newDistantLights) {
+        considerLight(newLight);
+      }
+    } else {
+      // Note: Similar lights are at most the distance threshold apart, which is the cell size, so they are always in a neighboring cell.
+      const Vector3i cell = getLightMatchingCell(light.getPosition(), distanceThreshold);
+
+      for (int z = cell.z - 1; z <= cell.z + 1; ++z) {
+        for (int y = cell.y - 1; y <= cell.y + 1; ++y) {
+          for (int x = cell.x - 1; x <= cell.x + 1; ++x) {
+            auto newLights = m_newLightCells.find(Vector3i(x, y, z));
+            if (newLights == m_newLightCells.end()) {
+              continue;
+            }
+
+            for (RtLight* newLight : newLights->second) {
+              considerLight(newLight);
+            }
+          }
+        }
       }
+    }
+
+    return currentSimilarity >= 0 ? similarLight : nullptr;
+  }
+
+  void LightManager::findDynamicLightMatches(float distanceThreshold) {
+    const size_t numThreads = std::min<size_t>(RtxThreadBudget::getThreadCount(ThreadClass::FrameCritical, numLightMatchingThreads()), m_dynamicLightMatches.size() / kMinDynamicLightMatchesPerThread);
+
+    if (numThreads <= 1) {
+      for (DynamicLightMatch& match : m_dynamicLightMatches) {
+        match.similarLight = findDynamicLightMatch(match.light->second, distanceThreshold);
+      }
+      return;
+    }
+
+    // Note: The thread issuing the frame works on the matches as well, so the pool has one thread less.
+    const uint32_t numWorkers = numThreads - 1;
+    if (m_lightMatchingThreads == nullptr || m_numLightMatchingWorkers != numWorkers) {
+      m_lightMatchingThreads.reset();
+      m_lightMatchingThreads = std::make_unique<LightMatchingThreadPool>(numWorkers, "rtx-light-matching");
+      m_numLightMatchingWorkers = numWorkers;
+    }
+
+    // Note: Finding the matches only reads the lights, every thread writes the matches of its own batches.
+    std::atomic<size_t> nextMatch = 0;
+    auto findMatches = [&]() {
+      for (size_t begin = nextMatch.fetch_add(kDynamicLightMatchBatchSize); begin < m_dynamicLightMatches.size(); begin = nextMatch.fetch_add(kDynamicLightMatchBatchSize)) {
+        const size_t end = std::min(begin + kDynamicLightMatchBatchSize, m_dynamicLightMatches.size());
+
+        for (size_t i = begin; i < end; ++i) {
+          m_dynamicLightMatches[i].similarLight = findDynamicLightMatch(m_dynamicLightMatches[i].light->second, distanceThreshold);
+        }
+      }
+    };
+
+    std::vector<Future<void>> futures;
+    for (uint32_t i = 0; i < numWorkers; ++i) {
+      futures.push_back(m_lightMatchingThreads->Schedule(findMatches));
+    }
+
+    findMatches();
+
+    for (const Future<void>& future : futures) {
+      if (future.valid()) {
+        future.get();
+      }
+    }
+  }
+
+  void LightManager::dynamicLightMatching() {
+    ScopedCpuProfileZone();
+
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+    const float distanceThreshold = RtxOptions::uniqueObjectDistance();
+
+    // Gather the lights to try to match up with the stragglers, and the stragglers themselves, now we have the full light list this frame.
+
+    m_dynamicLightMatches.clear();
+    m_newLightCells.clear();
+    m_newDistantLights.clear();
+
+    for (auto it = m_lights.begin(); it != m_lights.end(); ++it) {
+      RtLight& light = it->second;
+
       // Not interested in static lights here.
       if (light.isChildOfMesh()) {
-        ++it;
         continue;
       }
 
-      float currentSimilarity = -1.f;
-      // Note: Using an iterator for the found similar light is safe here because the m_lights map will not change between where
-      // it is found and where it is accessed.
-      std::optional<decltype(m_lights)::iterator> similarLight;
-      for (auto similarLightIterator = m_lights.begin(); similarLightIterator != m_lights.end(); ++similarLightIterator) {
-        const RtLight& newLight = similarLightIterator->second;
-        // Skip comparing to old lights, this check implicitly avoids comparing the exact same light.
-        if (newLight.getBufferIdx() != kNewLightIdx || newLight.isChildOfMesh())
-          continue;
-
-        const float similarity = isSimilar(light, newLight, RtxOptions::uniqueObjectDistance());
-        // Update the cached light if it's similar.
-        if (similarity > currentSimilarity) {
-          similarLight = similarLightIterator;
-          currentSimilarity = similarity;
+      if (light.getBufferIdx() == kNewLightIdx) {
+        if (light.getType() == RtLightType::Distant) {
+          m_newDistantLights.emplace_back(&light);
+        } else {
+          m_newLightCells[getLightMatchingCell(light.getPosition(), distanceThreshold)].emplace_back(&light);
         }
+      } else if (light.getFrameLastTouched() + 1 == currentFrame) {
+        // Only looking for instances of dynamic lights that have been updated on the previous frame, and only interested in lights
+        // that have been around a while, this implicitly avoids searching for new lights that have been updated.
+        m_dynamicLightMatches.push_back(DynamicLightMatch { it, nullptr });
+      }
+    }
+
+    if (m_dynamicLightMatches.empty() || (m_newLightCells.empty() && m_newDistantLights.empty())) {
+      return;
+    }
+
+    findDynamicLightMatches(distanceThreshold);
+
+    // Apply the matches in light table order
+    // Note: Iterators to the matched lights stay valid here since only the lights being matched are erased from the light table.
+
+    for (DynamicLightMatch& match : m_dynamicLightMatches) {
+      const RtLight& light = match.light->second;
+      RtLight* dynamicLight = match.similarLight;
+
+      // Note: An earlier light may have taken this match already, look again among the remaining new lights as a serial search would.
+      if (dynamicLight != nullptr && dynamicLight->getBufferIdx() != kNewLightIdx) {
+        dynamicLight = findDynamicLightMatch(light, distanceThreshold);
       }
 
-      if (currentSimilarity >= 0 && similarLight.has_value()) {
+      if (dynamicLight != nullptr) {
         // This is a dynamic light!
-        RtLight& dynamicLight = (*similarLight)->second;
-        dynamicLight.isDynamic = true;
+        dynamicLight->isDynamic = true;
 
         // This is the same light, so update our new light
-        updateLight(light, dynamicLight);
+        updateLight(light, *dynamicLight);
 
         // Remove the previous frames version
-        it = m_lights.erase(it);
-      } else {
-        ++it;
+        m_lights.erase(match.light);
       }
     }
   }
@@ -303,12 +414,6 @@ namespace dxvk {
       }
     }
 
-    // Light buffer
-    const uint32_t previousLightActiveCount = m_currentActiveLightCount;
-    m_currentActiveLightCount = 0;
-
-    std::swap(m_lightBuffer, m_previousLightBuffer);
-
     // Linearize the light list
     // Note: This is done rather than just iterating over the light list twice mostly so that the fallback light
     // can be processed like all other lights without complex logic at the cost of potentially more computational
@@ -336,7 +441,9 @@ namespace dxvk {
 
     // Count the active light of each type
 
-    m_lightTypeRanges.fill(LightRange {});
+    std::array<uint32_t, lightTypeCount> activeLightCounts{};
+    uint32_t activeLightCount = 0;
+
     for (auto&& linearizedLight : m_linearizedLights) {
       const RtLight& light = *linearizedLight;
 
@@ -344,23 +451,130 @@ namespace dxvk {
         continue;
       }
 
-      ++m_lightTypeRanges[static_cast<uint32_t>(light.getType())].count;
-      ++m_currentActiveLightCount;
+      ++activeLightCounts[static_cast<uint32_t>(light.getType())];
+      ++activeLightCount;
 
       // Note: Highest light index reserved for the invalid index sentinel.
-      if (m_currentActiveLightCount == LIGHT_INDEX_INVALID) {
+      if (activeLightCount == LIGHT_INDEX_INVALID) {
         ONCE(Logger::info(str::format("[RTX-Compatibility-Info] Raytracing support more than 65535 lights currently, skipping some lights for now.")));
         break;
       }
     }
 
+    m_activeLightTypeCounts = activeLightCounts;
+
+    if (canKeepLightSlots(activeLightCounts)) {
+      updateLightBuffer(ctx, activeLightCount);
+    } else {
+      rebuildLightBuffer(ctx, activeLightCounts, activeLightCount);
+    }
+
+    buildLightTree(ctx);
+
+    // If there are no lights with >0 intensity, then clear the list...
+    if (m_currentActiveLightCount == 0)
+      clear();
+
+    // Generate a GPU dome light if necessary
+    DomeLight activeDomeLight;
+    if (getActiveDomeLight(activeDomeLight)) {
+      // Ensures a texture stays in VidMem
+      SceneManager& sceneManager = device()->getCommon()->getSceneManager();
+      sceneManager.trackTexture(activeDomeLight.texture, m_gpuDomeLightArgs.textureIndex, true, false);
+
+      m_gpuDomeLightArgs.active = true;
+      m_gpuDomeLightArgs.radiance = activeDomeLight.radiance;
+      m_gpuDomeLightArgs.worldToLightTransform = activeDomeLight.worldToLight;
+    } else {
+      m_gpuDomeLightArgs.active = false;
+      m_gpuDomeLightArgs.radiance = Vector3(0.0f);
+      m_gpuDomeLightArgs.textureIndex = BINDING_INDEX_INVALID;
+    }
+
+    // Reset external active light list.
+    m_externalActiveDomeLight = nullptr;
+    m_externalActiveLightList.clear();
+  }
+
+  namespace {
+    // Note: Free slots in the light buffer are filled with a light of the slot's type that has no radiance. This keeps every slot
+    // within the range of a type decodable as that type, while giving free slots no weight in any of the light sampling.
+    const unsigned char* getFreeLightSlotGPUData(uint32_t lightType) {
+      static const auto freeLightSlotGPUData = [] {
+        const Vector3 position(0.0f);
+        const Vector3 radiance(0.0f);
+        const Vector3 xAxis(1.0f, 0.0f, 0.0f);
+        const Vector3 yAxis(0.0f, 1.0f, 0.0f);
+        const Vector3 zAxis(0.0f, 0.0f, 1.0f);
+
+        const RtLight lights[lightTypeCount] = {
+          RtLight(RtSphereLight(position, radiance, 1.0f, RtLightShaping())),
+          RtLight(RtRectLight(position, Vector2(1.0f), xAxis, yAxis, zAxis, radiance, RtLightShaping())),
+          RtLight(RtDiskLight(position, Vector2(1.0f), xAxis, yAxis, zAxis, radiance, RtLightShaping())),
+          RtLight(RtCylinderLight(position, 1.0f, zAxis, 1.0f, radiance)),
+          RtLight(RtDistantLight(zAxis, 0.01f, radiance)),
+        };
+
+        std::array<std::array<unsigned char, kLightGPUSize>, lightTypeCount> data{};
+
+        for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+          assert(static_cast<uint32_t>(lights[lightType].getType()) == lightType);
+
+          std::size_t offset = 0;
+          lights[lightType].writeGPUData(data[lightType].data(), offset);
+        }
+
+        return data;
+      }();
+
+      return freeLightSlotGPUData[lightType].data();
+    }
+
+    // Note: Dirty slots closer together than this are merged into one range to keep the number of copies down.
+    constexpr uint32_t kDirtyLightSlotMergeDistance = 8;
+
+    void addDirtyLightSlot(std::vector<LightSlotRange>& ranges, uint32_t slot) {
+      if (!ranges.empty() && slot <= ranges.back().end + kDirtyLightSlotMergeDistance) {
+        ranges.back().end = slot + 1;
+      } else {
+        ranges.push_back(LightSlotRange { slot, slot + 1 });
+      }
+    }
+  }
+
+  bool LightManager::canKeepLightSlots(const std::array<uint32_t, lightTypeCount>& activeLightCounts) const {
+    if (!enableIncrementalLightUpdates() || m_currentActiveLightCount == 0 || m_lightBuffer == nullptr) {
+      return false;
+    }
+
+    for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+      const uint32_t slotCount = m_lightTypeRanges[lightType].count;
+
+      // Note: Rebuild when new lights do not fit, or when more than a quarter of the slots of a type would be free, as free slots
+      // still take up light samples.
+      if (activeLightCounts[lightType] > slotCount || slotCount - activeLightCounts[lightType] > slotCount / 4) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void LightManager::rebuildLightBuffer(Rc<DxvkContext> ctx, const std::array<uint32_t, lightTypeCount>& activeLightCounts, uint32_t activeLightCount) {
+    ScopedCpuProfileZone();
+
+    const uint32_t previousLightActiveCount = m_currentActiveLightCount;
+    m_currentActiveLightCount = activeLightCount;
+
+    std::swap(m_lightBuffer, m_previousLightBuffer);
+
     // Arrange the ligth ranges of each types sequentially in the buffer, reset the counts
 
     uint offset = 0;
     for (uint lightType = 0; lightType < lightTypeCount; ++lightType) {
       LightRange& range = m_lightTypeRanges[lightType];
       range.offset = offset;
-      offset += range.count;
+      offset += activeLightCounts[lightType];
       range.count = 0;
     }
 
@@ -417,9 +631,9 @@ namespace dxvk {
 
     // Allocate the light buffer and copy its contents from host to device memory
     DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
     info.size = align(lightsGPUSize, kBufferAlignment);
 
     // Note: Only allocating the light buffer here, not the previous light buffer as on the first frame it is fine for it to be null as
@@ -443,29 +657,336 @@ namespace dxvk {
       ctx->writeToBuffer(m_lightMappingBuffer, 0, m_lightMappingData.size() * sizeof(uint16_t), m_lightMappingData.data());
     }
 
-    // If there are no lights with >0 intensity, then clear the list...
-    if (m_currentActiveLightCount == 0)
-      clear();
+    // Note: The previous light buffer now holds last frame's lights in last frame's layout, so all of it has to be caught up should
+    // the layout be kept next frame.
+    m_previousDirtyLightSlotRanges.clear();
 
-    // Generate a GPU dome light if necessary
-    DomeLight activeDomeLight;
-    if (getActiveDomeLight(activeDomeLight)) {
-      // Ensures a texture stays in VidMem
-      SceneManager& sceneManager = device()->getCommon()->getSceneManager();
-      sceneManager.trackTexture(activeDomeLight.texture, m_gpuDomeLightArgs.textureIndex, true, false);
+    if (m_currentActiveLightCount > 0) {
+      m_previousDirtyLightSlotRanges.push_back(LightSlotRange { 0, m_currentActiveLightCount });
+    }
+  }
 
-      m_gpuDomeLightArgs.active = true;
-      m_gpuDomeLightArgs.radiance = activeDomeLight.radiance;
-      m_gpuDomeLightArgs.worldToLightTransform = activeDomeLight.worldToLight;
+  void LightManager::updateLightBuffer(Rc<DxvkContext> ctx, uint32_t activeLightCount) {
+    ScopedCpuProfileZone();
+
+    // Note: The light type ranges, and so the slot count, stay as they were last frame.
+    const uint32_t slotCount = m_currentActiveLightCount;
+
+    // Lights keep the slot they had last frame, as long as it is still in the range of their type and not taken yet
+
+    m_lightSlots.assign(slotCount, nullptr);
+    m_lightsWithoutSlot.clear();
+
+    uint32_t lightsWritten = 0;
+
+    for (auto&& linearizedLight : m_linearizedLights) {
+      RtLight& light = *linearizedLight;
+
+      if (light.getColorAndIntensity().w <= 0 || lightsWritten >= activeLightCount) {
+        // This light is either disabled or didn't fit into the buffer, so set its buffer index to invalid.
+        light.setBufferIdx(kNewLightIdx);
+        continue;
+      }
+
+      ++lightsWritten;
+
+      const LightRange& range = m_lightTypeRanges[static_cast<uint32_t>(light.getType())];
+      const uint32_t bufferIdx = light.getBufferIdx();
+
+      if (bufferIdx >= range.offset && bufferIdx < range.offset + range.count && m_lightSlots[bufferIdx] == nullptr) {
+        m_lightSlots[bufferIdx] = &light;
+      } else {
+        m_lightsWithoutSlot.emplace_back(&light);
+      }
+    }
+
+    // Hand out the free slots of each type to the lights without one, lowest slots first
+
+    for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+      const LightRange& range = m_lightTypeRanges[lightType];
+      std::vector<uint16_t>& freeSlots = m_freeLightSlots[lightType];
+
+      freeSlots.clear();
+
+      for (uint32_t slot = range.offset + range.count; slot > range.offset; --slot) {
+        if (m_lightSlots[slot - 1] == nullptr) {
+          freeSlots.emplace_back(slot - 1);
+        }
+      }
+    }
+
+    for (RtLight* light : m_lightsWithoutSlot) {
+      std::vector<uint16_t>& freeSlots = m_freeLightSlots[static_cast<uint32_t>(light->getType())];
+
+      // Note: Guaranteed by canKeepLightSlots, every type has at least as many slots as active lights.
+      assert(!freeSlots.empty());
+
+      m_lightSlots[freeSlots.back()] = light;
+      freeSlots.pop_back();
+    }
+
+    // Write the slots whose contents changed, and the light mapping entries that changed
+    // Note: With the layout kept, a light that kept its slot maps to that same slot in both directions. Lights that were given a
+    // new slot are treated as new lights by RTXDI, just like lights that were not present last frame.
+
+    const uint32_t lightMappingBufferEntries = 2 * slotCount;
+    bool lightMappingResized = false;
+
+    // Note: The light mapping only spans twice the slot count once the layout was kept for a frame, see rebuildLightBuffer.
+    if (m_lightMappingData.size() != lightMappingBufferEntries) {
+      m_lightMappingData.resize(lightMappingBufferEntries);
+      memset(m_lightMappingData.data(), kNewLightIdx, sizeof(uint16_t) * m_lightMappingData.size());
+      lightMappingResized = true;
+    }
+
+    m_dirtyLightSlotRanges.clear();
+    m_dirtyLightMappingRanges.clear();
+
+    for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+      const LightRange& range = m_lightTypeRanges[lightType];
+
+      for (uint32_t slot = range.offset; slot < range.offset + range.count; ++slot) {
+        RtLight* light = m_lightSlots[slot];
+
+        unsigned char* currentGPUData = m_lightsGPUData.data() + slot * kLightGPUSize;
+        unsigned char slotGPUData[kLightGPUSize];
+
+        if (light != nullptr) {
+          // Note: Padding is not written in release builds, start from the current contents so it does not show up as a change.
+          memcpy(slotGPUData, currentGPUData, kLightGPUSize);
+
+          std::size_t dataOffset = 0;
+          light->writeGPUData(slotGPUData, dataOffset);
+        } else {
+          memcpy(slotGPUData, getFreeLightSlotGPUData(lightType), kLightGPUSize);
+        }
+
+        if (memcmp(currentGPUData, slotGPUData, kLightGPUSize) != 0) {
+          memcpy(currentGPUData, slotGPUData, kLightGPUSize);
+          addDirtyLightSlot(m_dirtyLightSlotRanges, slot);
+        }
+
+        const uint16_t lightMapping = (light != nullptr && light->getBufferIdx() == slot) ? static_cast<uint16_t>(slot) : kNewLightIdx;
+
+        if (m_lightMappingData[slot] != lightMapping) {
+          m_lightMappingData[slot] = lightMapping;
+          addDirtyLightSlot(m_dirtyLightMappingRanges, slot);
+        }
+
+        if (light != nullptr) {
+          light->setBufferIdx(slot);
+        }
+      }
+    }
+
+    // Note: The previous to current half holds the same mapping as the current to previous half
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+      if (m_lightMappingData[slotCount + slot] != m_lightMappingData[slot]) {
+        m_lightMappingData[slotCount + slot] = m_lightMappingData[slot];
+        addDirtyLightSlot(m_dirtyLightMappingRanges, slotCount + slot);
+      }
+    }
+
+    // Catch the previous light buffer up with the light buffer as it was at the end of last frame, which only differs from the
+    // previous light buffer in the slots changed last frame, then update the slots changed this frame
+
+    DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    info.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    info.size = align(slotCount * kLightGPUSize, kBufferAlignment);
+
+    if (m_previousLightBuffer == nullptr || info.size > m_previousLightBuffer->info().size) {
+      m_previousLightBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Light Buffer");
+
+      m_previousDirtyLightSlotRanges.clear();
+      m_previousDirtyLightSlotRanges.push_back(LightSlotRange { 0, slotCount });
+    }
+
+    for (const LightSlotRange& range : m_previousDirtyLightSlotRanges) {
+      ctx->copyBuffer(m_previousLightBuffer, range.begin * kLightGPUSize, m_lightBuffer, range.begin * kLightGPUSize, (range.end - range.begin) * kLightGPUSize);
+    }
+
+    for (const LightSlotRange& range : m_dirtyLightSlotRanges) {
+      ctx->writeToBuffer(m_lightBuffer, range.begin * kLightGPUSize, (range.end - range.begin) * kLightGPUSize, m_lightsGPUData.data() + range.begin * kLightGPUSize);
+    }
+
+    std::swap(m_previousDirtyLightSlotRanges, m_dirtyLightSlotRanges);
+
+    info.size = align(lightMappingBufferEntries * sizeof(uint16_t), kBufferAlignment);
+    if (m_lightMappingBuffer == nullptr || info.size > m_lightMappingBuffer->info().size) {
+      m_lightMappingBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Light Mapping Buffer");
+      lightMappingResized = true;
+    }
+
+    if (lightMappingResized) {
+      ctx->writeToBuffer(m_lightMappingBuffer, 0, m_lightMappingData.size() * sizeof(uint16_t), m_lightMappingData.data());
     } else {
-      m_gpuDomeLightArgs.active = false;
-      m_gpuDomeLightArgs.radiance = Vector3(0.0f);
-      m_gpuDomeLightArgs.textureIndex = BINDING_INDEX_INVALID;
+      for (const LightSlotRange& range : m_dirtyLightMappingRanges) {
+        // Note: Buffer updates have to be 4 byte aligned, the light mapping always has an even number of entries.
+        const uint32_t begin = range.begin & ~1u;
+        const uint32_t end = (range.end + 1) & ~1u;
+
+        ctx->writeToBuffer(m_lightMappingBuffer, begin * sizeof(uint16_t), (end - begin) * sizeof(uint16_t), m_lightMappingData.data() + begin);
+      }
     }
+  }
 
-    // Reset external active light list.
-    m_externalActiveDomeLight = nullptr;
-    m_externalActiveLightList.clear();
+  namespace {
+    // Note: Keeps lights with a degenerate size from getting a zero probability in the light tree.
+    constexpr float kMinLightTreeLightArea = 1e-3f;
+
+    float estimateLightPower(const Vector3& radiance, float area) {
+      const float luminance = dot(radiance, Vector3(0.2126f, 0.7152f, 0.0722f));
+      return luminance * std::max(area, kMinLightTreeLightArea);
+    }
+  }
+
+  void LightManager::buildLightTree(Rc<DxvkContext> ctx) {
+    ScopedCpuProfileZone();
+
+    m_lightTreeNodes.clear();
+    m_lightTreeInputs.clear();
+
+    // Note: Distant lights are not part of the tree, all other active lights are.
+    uint32_t localLightCount = 0;
+    for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+      if (lightType != lightTypeDistant) {
+        localLightCount += m_activeLightTypeCounts[lightType];
+      }
+    }
+
+    if (!enableLightTree() || localLightCount == 0 || localLightCount < lightTreeMinLightCount()) {
+      return;
+    }
+
+    for (const RtLight* linearizedLight : m_linearizedLights) {
+      const RtLight& light = *linearizedLight;
+
+      if (light.getBufferIdx() == kNewLightIdx || light.getType() == RtLightType::Distant) {
+        continue;
+      }
+
+      LightTreeInput& input = m_lightTreeInputs.emplace_back();
+      input.lightIndex = light.getBufferIdx();
+
+      Vector3 extent;
+      float area;
+
+      switch (light.getType()) {
+      case RtLightType::Sphere: {
+        const RtSphereLight& sphereLight = light.getSphereLight();
+        extent = Vector3(sphereLight.getRadius());
+        area = 4.0f * kPi * sphereLight.getRadius() * sphereLight.getRadius();
+        input.power = estimateLightPower(sphereLight.getRadiance(), area);
+        break;
+      }
+      case RtLightType::Rect: {
+        const RtRectLight& rectLight = light.getRectLight();
+        const Vector2 halfDimensions = rectLight.getDimensions() * 0.5f;
+        extent = abs(rectLight.getXAxis()) * halfDimensions.x + abs(rectLight.getYAxis()) * halfDimensions.y;
+        area = rectLight.getDimensions().x * rectLight.getDimensions().y;
+        input.power = estimateLightPower(rectLight.getRadiance(), area);
+        break;
+      }
+      case RtLightType::Disk: {
+        const RtDiskLight& diskLight = light.getDiskLight();
+        const Vector2 halfDimensions = diskLight.getHalfDimensions();
+        extent = abs(diskLight.getXAxis()) * halfDimensions.x + abs(diskLight.getYAxis()) * halfDimensions.y;
+        area = kPi * halfDimensions.x * halfDimensions.y;
+        input.power = estimateLightPower(diskLight.getRadiance(), area);
+        break;
+      }
+      case RtLightType::Cylinder: {
+        const RtCylinderLight& cylinderLight = light.getCylinderLight();
+        extent = abs(cylinderLight.getAxis()) * (cylinderLight.getAxisLength() * 0.5f) + Vector3(cylinderLight.getRadius());
+        area = 2.0f * kPi * cylinderLight.getRadius() * cylinderLight.getAxisLength();
+        input.power = estimateLightPower(cylinderLight.getRadiance(), area);
+        break;
+      }
+      default:
+        assert(false);
+        extent = Vector3(0.0f);
+        input.power = 0.0f;
+        break;
+      }
+
+      input.boundsMin = light.getPosition() - extent;
+      input.boundsMax = light.getPosition() + extent;
+    }
+
+    if (m_lightTreeInputs.empty()) {
+      return;
+    }
+
+    // Note: A binary tree with one light per leaf always has 2n - 1 nodes, so the node vector never reallocates while building.
+    m_lightTreeNodes.reserve(m_lightTreeInputs.size() * 2 - 1);
+    m_lightTreeNodes.emplace_back();
+    buildLightTreeNode(0, 0, m_lightTreeInputs.size());
+
+    const size_t lightTreeGPUSize = m_lightTreeNodes.size() * sizeof(LightTreeNode);
+
+    DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    info.size = align(lightTreeGPUSize, kBufferAlignment);
+
+    if (m_lightTreeBuffer == nullptr || info.size > m_lightTreeBuffer->info().size) {
+      m_lightTreeBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Light Tree Buffer");
+    }
+
+    ctx->writeToBuffer(m_lightTreeBuffer, 0, lightTreeGPUSize, m_lightTreeNodes.data());
+  }
+
+  void LightManager::buildLightTreeNode(uint32_t nodeIndex, uint32_t begin, uint32_t end) {
+    Vector3 boundsMin(FLT_MAX);
+    Vector3 boundsMax(-FLT_MAX);
+    Vector3 centerMin(FLT_MAX);
+    Vector3 centerMax(-FLT_MAX);
+    float power = 0.0f;
+
+    for (uint32_t i = begin; i < end; ++i) {
+      const LightTreeInput& input = m_lightTreeInputs[i];
+      const Vector3 center = (input.boundsMin + input.boundsMax) * 0.5f;
+
+      boundsMin = min(boundsMin, input.boundsMin);
+      boundsMax = max(boundsMax, input.boundsMax);
+      centerMin = min(centerMin, center);
+      centerMax = max(centerMax, center);
+      power += input.power;
+    }
+
+    {
+      LightTreeNode& node = m_lightTreeNodes[nodeIndex];
+      node.boundsMin = boundsMin;
+      node.boundsMax = boundsMax;
+      node.power = power;
+
+      if (end - begin == 1) {
+        node.childOrLightIndex = m_lightTreeInputs[begin].lightIndex | lightTreeLeafFlag;
+        return;
+      }
+
+      node.childOrLightIndex = m_lightTreeNodes.size();
+    }
+
+    // Split at the median along the axis the light centers are spread out the most on
+    const Vector3 centerExtent = centerMax - centerMin;
+    const uint32_t axis = centerExtent.x >= centerExtent.y ? (centerExtent.x >= centerExtent.z ? 0 : 2) : (centerExtent.y >= centerExtent.z ? 1 : 2);
+    const uint32_t middle = begin + (end - begin) / 2;
+
+    std::nth_element(m_lightTreeInputs.begin() + begin, m_lightTreeInputs.begin() + middle, m_lightTreeInputs.begin() + end,
+                     [axis](const LightTreeInput& a, const LightTreeInput& b) {
+                       return a.boundsMin[axis] + a.boundsMax[axis] < b.boundsMin[axis] + b.boundsMax[axis];
+                     });
+
+    const uint32_t firstChildIndex = m_lightTreeNodes.size();
+    m_lightTreeNodes.emplace_back();
+    m_lightTreeNodes.emplace_back();
+
+    buildLightTreeNode(firstChildIndex, begin, middle);
+    buildLightTreeNode(firstChildIndex + 1, middle, end);
   }
 
   static const float kNotSimilar = -1.f;
@@ -662,9 +1183,10 @@ namespace dxvk {
   void LightManager::addExternalLight(remixapi_LightHandle handle, const RtLight& rtlight) {
     auto found = m_externalLights.find(handle);
     if (found != m_externalLights.end()) {
-      // TODO: warn the user about id collision,
-      //       or just overwriting existing one is fine?
+      // Overwriting is how the API updates a light, keep the buffer slot so that it stays the same light for RTXDI
+      const uint32_t bufferIdx = found->second.getBufferIdx();
       found->second = rtlight;
+      found->second.setBufferIdx(bufferIdx);
     } else {
       m_externalLights.emplace(handle, rtlight);
     }
@@ -755,13 +1277,25 @@ namespace dxvk {
       raytraceArgs.volumeRISTotalSampleCount += dstRange.volumeRISSampleCount;
       raytraceArgs.risTotalSampleCount += dstRange.risSampleCount;
     }
+
+    // Note: When the light tree is present it takes over the RIS candidates of all non-distant light types, keeping their total count.
+    raytraceArgs.lightTreeNodeCount = m_lightTreeNodes.size();
+    raytraceArgs.lightTreeRisSampleCount = 0;
+
+    if (!m_lightTreeNodes.empty()) {
+      for (uint32_t lightType = 0; lightType < lightTypeCount; ++lightType) {
+        if (lightType != lightTypeDistant) {
+          raytraceArgs.lightTreeRisSampleCount += raytraceArgs.lightRanges[lightType].risSampleCount;
+        }
+      }
+    }
   }
 
   uint LightManager::getLightCount(uint type) {
     if (type >= lightTypeCount) {
       return 0;
     }
-    return m_lightTypeRanges[type].count;
+    return m_activeLightTypeCounts[type];
   }
 
 }  // namespace dxvk
@@ -28,11 +28,13 @@
 #include "rtx_types.h"
 #include "rtx/utility/shader_types.h"
 #include "rtx/concept/light/light_types.h"
+#include "rtx/concept/light/light_tree.h"
 #include "rtx_lights.h"
 #include "rtx_camera_manager.h"
 #include "rtx_common_object.h"
 #include "rtx/pass/common_binding_indices.h"
 #include "rtx/pass/raytrace_args.h"
+#include "../util/util_fast_cache.h"
 
 using remixapi_LightHandle = struct remixapi_LightHandle_T*;
 
@@ -41,12 +43,19 @@ struct RaytraceArgs;
 namespace dxvk {
 class DxvkContext;
 class DxvkDevice;
+template<size_t NumTasksPerThread, bool WorkStealing, bool LowLatency> class WorkerThreadPool;
 
 struct LightRange {
   uint32_t offset;
   uint32_t count;
 };
 
+// Range of light buffer slots (or light mapping entries), end exclusive
+struct LightSlotRange {
+  uint32_t begin;
+  uint32_t end;
+};
+
 struct LightManager : public CommonDeviceObject {
 public:
   enum class FallbackLightMode : int {
@@ -74,6 +83,7 @@ public:
   const Rc<DxvkBuffer> getLightBuffer() const { return m_lightBuffer; }
   const Rc<DxvkBuffer> getPreviousLightBuffer() const { return m_previousLightBuffer.ptr() ? m_previousLightBuffer : m_lightBuffer; }
   const Rc<DxvkBuffer> getLightMappingBuffer() const { return m_lightMappingBuffer; }
+  const Rc<DxvkBuffer> getLightTreeBuffer() const { return m_lightTreeBuffer; }
   const uint32_t getActiveCount() const { return m_currentActiveLightCount; }
   const DomeLightArgs& getDomeLightArgs() const { return m_gpuDomeLightArgs; }
 
@@ -113,27 +123,81 @@ private:
   Rc<DxvkBuffer> m_lightBuffer;
   Rc<DxvkBuffer> m_previousLightBuffer;
   Rc<DxvkBuffer> m_lightMappingBuffer;
+  Rc<DxvkBuffer> m_lightTreeBuffer;
 
+  // Note: Number of slots in the light buffer, which may include free slots when the light buffer is updated incrementally.
   uint32_t m_currentActiveLightCount = 0;
   std::array<LightRange, lightTypeCount> m_lightTypeRanges;
+  std::array<uint32_t, lightTypeCount> m_activeLightTypeCounts{};
   // Note: The following vectors are included as members rather as local variables in the
   // prepareSceneData function where they are primarily used to prevent redundant allocations/frees
   // of the memory behind these buffers between each call (at the cost of slightly more persistent
   // memory usage, but these buffers are fairly small at only 4 MiB or so max with 2^16 lights present).
   std::vector<RtLight*> m_linearizedLights{};
+  // Note: Lights from the previous frame to find the dynamic light they turned into, and the new lights of this frame they can
+  // match with, binned by position in cells of the unique object distance (distant lights, which match by direction, kept apart).
+  struct DynamicLightMatch {
+    std::unordered_map<XXH64_hash_t, RtLight>::iterator light;
+    RtLight* similarLight;
+  };
+  std::vector<DynamicLightMatch> m_dynamicLightMatches{};
+  fast_spatial_cache<std::vector<RtLight*>> m_newLightCells{};
+  std::vector<RtLight*> m_newDistantLights{};
   std::vector<unsigned char> m_lightsGPUData{};
   std::vector<uint16_t> m_lightMappingData{};
+  std::vector<LightTreeNode> m_lightTreeNodes{};
+  // Note: Slot of every light in the light buffer this frame (nullptr for free slots), and the lights that still need a slot, then
+  // the free slots of each light type, used when keeping the light buffer layout from the previous frame.
+  std::vector<RtLight*> m_lightSlots{};
+  std::vector<RtLight*> m_lightsWithoutSlot{};
+  std::array<std::vector<uint16_t>, lightTypeCount> m_freeLightSlots{};
+  // Note: The slots changed in the light buffer this and last frame, and the entries changed in the light mapping buffer this frame.
+  std::vector<LightSlotRange> m_dirtyLightSlotRanges{};
+  std::vector<LightSlotRange> m_previousDirtyLightSlotRanges{};
+  std::vector<LightSlotRange> m_dirtyLightMappingRanges{};
+  // Note: Scratch data for building the light tree, kept for the same reason as above
+  struct LightTreeInput {
+    Vector3 boundsMin;
+    Vector3 boundsMax;
+    float power;
+    uint32_t lightIndex;
+  };
+  std::vector<LightTreeInput> m_lightTreeInputs{};
+
+  using LightMatchingThreadPool = WorkerThreadPool<4, false, false>;
+  std::unique_ptr<LightMatchingThreadPool> m_lightMatchingThreads;
+  uint32_t m_numLightMatchingWorkers = 0;
 
   bool getActiveDomeLight(DomeLight& lightOut);
 
   void garbageCollectionInternal();
 
+  RtLight* findDynamicLightMatch(const RtLight& light, float distanceThreshold) const;
+  void findDynamicLightMatches(float distanceThreshold);
+
+  bool canKeepLightSlots(const std::array<uint32_t, lightTypeCount>& activeLightCounts) const;
+  void rebuildLightBuffer(Rc<DxvkContext> ctx, const std::array<uint32_t, lightTypeCount>& activeLightCounts, uint32_t activeLightCount);
+  void updateLightBuffer(Rc<DxvkContext> ctx, uint32_t activeLightCount);
+  void buildLightTree(Rc<DxvkContext> ctx);
+  void buildLightTreeNode(uint32_t nodeIndex, uint32_t begin, uint32_t end);
+
   // Similarity check.
   //  Returns -1 if not similar
   //  Returns 0~1 if similar, higher is more similar
   static float isSimilar(const RtLight& a, const RtLight& b, float distanceThreshold);
   static void updateLight(const RtLight& in, RtLight& out);
 
+  RTX_OPTION("rtx", uint32_t, numLightMatchingThreads, 4,
+             "The number of threads that match the lights of the previous frame to moved (dynamic) lights of the current frame, including the thread issuing the frame.\n"
+             "Only used when there are enough lights to match for splitting the work up to pay off. 0 or 1 matches every light on the thread issuing the frame.");
+  RTX_OPTION("rtx", bool, enableIncrementalLightUpdates, true,
+             "Keeps lights in the same slot of the light buffer across frames and only uploads the slots that changed, rather than rebuilding and uploading the whole light buffer every frame.\n"
+             "Slots of removed lights are left free for new lights of the same type. The light buffer is rebuilt when a light type runs out of free slots or too many of its slots are free.");
+  RTX_OPTION("rtx", bool, enableLightTree, false,
+             "Importance samples the RIS light candidates of non-distant lights from a light tree, built every frame over the bounds and estimated power of the lights, rather than drawing them evenly from each light type.\n"
+             "Keeps the sample quality from dropping as the number of lights in the scene grows, at the cost of building the tree and traversing it for every candidate. Applies to the RIS light sampling of the integrator, not to the initial samples of RTXDI.");
+  RTX_OPTION("rtx", uint32_t, lightTreeMinLightCount, 256,
+             "The number of non-distant lights from which on the light tree is used when it is enabled. With fewer lights, drawing candidates evenly is cheaper and samples the lights well enough.");
   RTX_OPTION("rtx", bool, suppressLightKeeping, false, 
              "If true, Remix doesn't keep game's original light sources for many frames. "
              "For example, if a game switches a point light off, then, in Remix, the light might still be rendered as if it's enabled: "
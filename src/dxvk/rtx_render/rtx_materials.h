@@ -98,9 +98,7 @@ struct RtSurface {
     writeGPUHelperExplicit<2>(data, offset, color0BufferIndex);
 
     writeGPUHelperExplicit<1>(data, offset, normalFormat == VK_FORMAT_R32_UINT ? 1 : 0);
-
-    // 1 unused bytes here.
-    writeGPUPadding<1>(data, offset);
+    writeGPUHelperExplicit<1>(data, offset, sortKey);
 
     const uint16_t packedHash =
       (uint16_t) (associatedGeometryHash >> 48) ^
@@ -156,56 +154,13 @@ struct RtSurface {
 
     writeGPUHelper(data, offset, flags);
 
-    // Note: Matricies are stored on the cpu side in column-major order, the same as the GPU.
-
-    Matrix4 instanceToWorld = objectToWorld;
-    Matrix4 prevInstanceToWorld = prevObjectToWorld;
-    Matrix3 normalInstanceToWorld = normalObjectToWorld;
-
-    if (instancesToObject && surfaceIndexOfFirstInstance != SIZE_MAX && surfaceIndex != SIZE_MAX) {
-      const size_t instanceIndex = surfaceIndex - surfaceIndexOfFirstInstance;
-      if (instanceIndex >= instancesToObject->size()) {
-        // Note: This should never happen.
-        assert(false);
-        Logger::err("Error: invalid instance index in RtSurface::WriteGPUData.");
-      } else {
-        instanceToWorld = objectToWorld * (*instancesToObject)[instanceIndex];
-        prevInstanceToWorld = prevObjectToWorld * (*instancesToObject)[instanceIndex];
-        normalInstanceToWorld = transpose(inverse(Matrix3(instanceToWorld)));
-      }
-    }
-
-    // Note: Last row of object to world matrix not needed as it does not encode any useful information
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].x);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].y);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].z);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].x);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].y);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].z);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].x);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].y);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].z);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].x);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].y);
-    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].z);
-
-    writeGPUHelper(data, offset, normalInstanceToWorld.data[0]);
-    writeGPUHelper(data, offset, normalInstanceToWorld.data[1]);
-    writeGPUHelper(data, offset, normalInstanceToWorld.data[2].x);
-    writeGPUHelper(data, offset, normalInstanceToWorld.data[2].y);
+    Matrix4 instanceToWorld;
+    Matrix4 prevInstanceToWorld;
+    Matrix3 normalInstanceToWorld;
+    getInstanceTransforms(surfaceIndex, instanceToWorld, prevInstanceToWorld, normalInstanceToWorld);
 
-    writeGPUHelper(data, offset, instanceToWorld.data[0].x);
-    writeGPUHelper(data, offset, instanceToWorld.data[0].y);
-    writeGPUHelper(data, offset, instanceToWorld.data[0].z);
-    writeGPUHelper(data, offset, instanceToWorld.data[1].x);
-    writeGPUHelper(data, offset, instanceToWorld.data[1].y);
-    writeGPUHelper(data, offset, instanceToWorld.data[1].z);
-    writeGPUHelper(data, offset, instanceToWorld.data[2].x);
-    writeGPUHelper(data, offset, instanceToWorld.data[2].y);
-    writeGPUHelper(data, offset, instanceToWorld.data[2].z);
-    writeGPUHelper(data, offset, instanceToWorld.data[3].x);
-    writeGPUHelper(data, offset, instanceToWorld.data[3].y);
-    writeGPUHelper(data, offset, instanceToWorld.data[3].z);
+    assert(offset - oldOffset == kSurfaceGPUTransformsOffset);
+    writeGPUTransforms(data, offset, instanceToWorld, prevInstanceToWorld, normalInstanceToWorld);
 
     // Note: Only 2 rows of texture transform written for now due to limit of 2 element restriction.
     writeGPUHelper(data, offset, textureTransform.data[0].x);
@@ -249,6 +204,7 @@ struct RtSurface {
     writeGPUHelper(data, offset, textureFlags);
 
     // Note: This element of the normal object to world matrix is encoded to minimize padding
+    assert(offset - oldOffset == kSurfaceGPUNormalZOffset);
     writeGPUHelper(data, offset, normalInstanceToWorld.data[2].z);
 
     writeGPUHelper(data, offset, clipPlane);
@@ -256,6 +212,31 @@ struct RtSurface {
     assert(offset - oldOffset == kSurfaceGPUSize);
   }
 
+  // Writes the surfaces of all instances of a PointInstancer surface, starting at firstSurfaceIndex. Only the
+  // transforms differ between the instances, so the rest of the surface is encoded once and copied to the others.
+  void writeInstancesGPUData(unsigned char* data, std::size_t& offset, size_t firstSurfaceIndex) const {
+    assert(instancesToObject && firstSurfaceIndex == surfaceIndexOfFirstInstance);
+
+    const std::size_t firstOffset = offset;
+    writeGPUData(data, offset, firstSurfaceIndex);
+
+    for (size_t instanceIndex = 1; instanceIndex < instancesToObject->size(); ++instanceIndex) {
+      std::memcpy(data + offset, data + firstOffset, kSurfaceGPUSize);
+
+      Matrix4 instanceToWorld;
+      Matrix4 prevInstanceToWorld;
+      Matrix3 normalInstanceToWorld;
+      getInstanceTransforms(firstSurfaceIndex + instanceIndex, instanceToWorld, prevInstanceToWorld, normalInstanceToWorld);
+
+      std::size_t transformsOffset = offset + kSurfaceGPUTransformsOffset;
+      writeGPUTransforms(data, transformsOffset, instanceToWorld, prevInstanceToWorld, normalInstanceToWorld);
+      std::size_t normalZOffset = offset + kSurfaceGPUNormalZOffset;
+      writeGPUHelper(data, normalZOffset, normalInstanceToWorld.data[2].z);
+
+      offset += kSurfaceGPUSize;
+    }
+  }
+
   uint32_t positionBufferIndex = kSurfaceInvalidBufferIndex;
   uint32_t previousPositionBufferIndex = kSurfaceInvalidBufferIndex;
   uint32_t positionOffset = 0;
@@ -348,11 +329,73 @@ struct RtSurface {
   XXH64_hash_t associatedGeometryHash; // NOTE: This is used for the debug view
   uint32_t objectPickingValue = 0; // NOTE: a value to fill GBUFFER_BINDING_PRIMARY_OBJECT_PICKING_OUTPUT
   uint32_t decalSortOrder = 0; // see: InstanceManager::m_decalSortOrderCounter
+  uint8_t sortKey = 0; // see: AccelManager::uploadSurfaceData
 
   // PointInstancer support - this surface may represent multiple instances, one for each transform in instancesToObject
   const std::vector<Matrix4>* instancesToObject = nullptr;
   // on the GPU, multiple copies of this surface with different transforms will exist.  They will be in a continuous block, starting at surfaceIndexOfFirstInstance.
   size_t surfaceIndexOfFirstInstance = SIZE_MAX;
+
+private:
+  // Byte offsets of the transforms within the GPU surface, see writeGPUData
+  static constexpr std::size_t kSurfaceGPUTransformsOffset = 3 * 4 * 4;
+  static constexpr std::size_t kSurfaceGPUNormalZOffset = kSurfaceGPUSize - 5 * 4;
+
+  void getInstanceTransforms(size_t surfaceIndex, Matrix4& instanceToWorld, Matrix4& prevInstanceToWorld, Matrix3& normalInstanceToWorld) const {
+    instanceToWorld = objectToWorld;
+    prevInstanceToWorld = prevObjectToWorld;
+    normalInstanceToWorld = normalObjectToWorld;
+
+    if (instancesToObject && surfaceIndexOfFirstInstance != SIZE_MAX && surfaceIndex != SIZE_MAX) {
+      const size_t instanceIndex = surfaceIndex - surfaceIndexOfFirstInstance;
+      if (instanceIndex >= instancesToObject->size()) {
+        // Note: This should never happen.
+        assert(false);
+        Logger::err("Error: invalid instance index in RtSurface::WriteGPUData.");
+      } else {
+        instanceToWorld = objectToWorld * (*instancesToObject)[instanceIndex];
+        prevInstanceToWorld = prevObjectToWorld * (*instancesToObject)[instanceIndex];
+        normalInstanceToWorld = transpose(inverse(Matrix3(instanceToWorld)));
+      }
+    }
+  }
+
+  static void writeGPUTransforms(unsigned char* data, std::size_t& offset, const Matrix4& instanceToWorld,
+                                 const Matrix4& prevInstanceToWorld, const Matrix3& normalInstanceToWorld) {
+    // Note: Matricies are stored on the cpu side in column-major order, the same as the GPU.
+
+    // Note: Last row of object to world matrix not needed as it does not encode any useful information
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].x);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].y);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[0].z);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].x);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].y);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[1].z);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].x);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].y);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[2].z);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].x);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].y);
+    writeGPUHelper(data, offset, prevInstanceToWorld.data[3].z);
+
+    writeGPUHelper(data, offset, normalInstanceToWorld.data[0]);
+    writeGPUHelper(data, offset, normalInstanceToWorld.data[1]);
+    writeGPUHelper(data, offset, normalInstanceToWorld.data[2].x);
+    writeGPUHelper(data, offset, normalInstanceToWorld.data[2].y);
+
+    writeGPUHelper(data, offset, instanceToWorld.data[0].x);
+    writeGPUHelper(data, offset, instanceToWorld.data[0].y);
+    writeGPUHelper(data, offset, instanceToWorld.data[0].z);
+    writeGPUHelper(data, offset, instanceToWorld.data[1].x);
+    writeGPUHelper(data, offset, instanceToWorld.data[1].y);
+    writeGPUHelper(data, offset, instanceToWorld.data[1].z);
+    writeGPUHelper(data, offset, instanceToWorld.data[2].x);
+    writeGPUHelper(data, offset, instanceToWorld.data[2].y);
+    writeGPUHelper(data, offset, instanceToWorld.data[2].z);
+    writeGPUHelper(data, offset, instanceToWorld.data[3].x);
+    writeGPUHelper(data, offset, instanceToWorld.data[3].y);
+    writeGPUHelper(data, offset, instanceToWorld.data[3].z);
+  }
 };
 
 // Shared Material Defaults/Limits
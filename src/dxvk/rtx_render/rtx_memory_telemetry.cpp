@@ -0,0 +1,186 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <array>
+#include <iomanip>
+
+#include "rtx_memory_telemetry.h"
+#include "dxvk_device.h"
+#include "dxvk_scoped_annotation.h"
+#include "../../util/util_env.h"
+
+namespace dxvk {
+
+  namespace {
+    constexpr uint32_t kCategoryCount = DxvkMemoryStats::Category::Last - DxvkMemoryStats::Category::First + 1;
+    // Everything but the memory categories, as well as the trend, is sampled at this interval
+    constexpr double kSlowSampleIntervalSeconds = 1.0;
+
+    enum SlowEntry : uint32_t {
+      TexturesFullyResident,
+      TexturesPartiallyResident,
+      ProcessPrivateMemory,
+      SlowEntryCount
+    };
+
+    size_t vidEntry(uint32_t category) {
+      return 2 * (category - DxvkMemoryStats::Category::First);
+    }
+
+    size_t sysEntry(uint32_t category) {
+      return vidEntry(category) + 1;
+    }
+  }
+
+  RtxMemoryTelemetry::RtxMemoryTelemetry(DxvkDevice* device)
+    : CommonDeviceObject(device)
+    , m_startTime(Clock::now()) {
+    for (uint32_t cat = DxvkMemoryStats::Category::First; cat <= DxvkMemoryStats::Category::Last; cat++) {
+      const char* name = DxvkMemoryStats::categoryToString(DxvkMemoryStats::Category(cat));
+      m_entries.push_back({ str::format("Vidmem ", name) });
+      m_entries.push_back({ str::format("Sysmem ", name) });
+    }
+
+    m_firstSlowEntry = m_entries.size();
+    m_entries.resize(m_firstSlowEntry + SlowEntryCount);
+    m_entries[m_firstSlowEntry + TexturesFullyResident].name = "Textures fully resident";
+    m_entries[m_firstSlowEntry + TexturesPartiallyResident].name = "Textures partially resident";
+    m_entries[m_firstSlowEntry + ProcessPrivateMemory].name = "Process private memory";
+  }
+
+  void RtxMemoryTelemetry::update() {
+    ScopedCpuProfileZone();
+
+    const VkPhysicalDeviceMemoryProperties memProps = m_device->adapter()->memoryProperties();
+
+    std::array<VkDeviceSize, kCategoryCount * 2> used {};
+    for (uint32_t heap = 0; heap < memProps.memoryHeapCount; heap++) {
+      const bool isDeviceLocal = memProps.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+      const DxvkMemoryStats stats = m_device->getMemoryStats(heap);
+      for (uint32_t cat = DxvkMemoryStats::Category::First; cat <= DxvkMemoryStats::Category::Last; cat++) {
+        used[isDeviceLocal ? vidEntry(cat) : sysEntry(cat)] += stats.usedByCategory(DxvkMemoryStats::Category(cat));
+      }
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - m_startTime).count();
+
+    {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
+      for (size_t i = 0; i < used.size(); i++) {
+        m_entries[i].current = used[i];
+        m_entries[i].peak = std::max(m_entries[i].peak, used[i]);
+      }
+    }
+
+    if (m_lastSlowSampleSeconds < 0.0 || seconds - m_lastSlowSampleSeconds >= kSlowSampleIntervalSeconds) {
+      m_lastSlowSampleSeconds = seconds;
+      sampleSlow(seconds);
+    }
+
+    if (!csvPath().empty() && (m_lastCsvSeconds < 0.0 || seconds - m_lastCsvSeconds >= csvIntervalSeconds())) {
+      m_lastCsvSeconds = seconds;
+      writeCsv(seconds);
+    }
+  }
+
+  void RtxMemoryTelemetry::sampleSlow(double seconds) {
+    const RtxTextureManager::ResidencyStats residency = m_device->getCommon()->getTextureManager().getResidencyStats();
+
+    uint64_t privateMemory = 0;
+    env::getProcessPrivateMemory(privateMemory);
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    m_textureResidency = residency;
+
+    const VkDeviceSize slowValues[SlowEntryCount] = { residency.fullBytes, residency.partialBytes, privateMemory };
+    for (uint32_t i = 0; i < SlowEntryCount; i++) {
+      Entry& entry = m_entries[m_firstSlowEntry + i];
+      entry.current = slowValues[i];
+      entry.peak = std::max(entry.peak, slowValues[i]);
+    }
+
+    updateTrends(seconds);
+  }
+
+  void RtxMemoryTelemetry::updateTrends(double seconds) {
+    Sample& sample = m_samples.emplace_back();
+    sample.seconds = seconds;
+    sample.values.reserve(m_entries.size());
+    for (const Entry& entry : m_entries) {
+      sample.values.push_back(entry.current);
+    }
+
+    while (m_samples.size() > 2 && seconds - m_samples.front().seconds > trendWindowSeconds()) {
+      m_samples.pop_front();
+    }
+
+    const Sample& oldest = m_samples.front();
+    const double minutes = (seconds - oldest.seconds) / 60.0;
+    for (size_t i = 0; i < m_entries.size(); i++) {
+      const double deltaMib = (double(m_entries[i].current) - double(oldest.values[i])) / double(1 << 20);
+      m_entries[i].trendMibPerMinute = minutes > 0.0 ? float(deltaMib / minutes) : 0.f;
+    }
+  }
+
+  void RtxMemoryTelemetry::writeCsv(double seconds) {
+    const std::string& path = csvPath();
+    if (path != m_csvPath) {
+      m_csv.close();
+      m_csvPath = path;
+
+      m_csv.open(path, std::ios::out | std::ios::app);
+      if (!m_csv.is_open()) {
+        Logger::err(str::format("Memory telemetry: failed to open ", path));
+      } else if (m_csv.tellp() == 0) {
+        m_csv << "seconds,frame";
+        for (const Entry& entry : m_entries) {
+          m_csv << ",\"" << entry.name << " MiB\"";
+        }
+        m_csv << ",texturesFullyResident,texturesPartiallyResident,texturesPending,texturesFailed\n";
+      }
+    }
+
+    if (!m_csv.is_open()) {
+      return;
+    }
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    m_csv << std::fixed << std::setprecision(1) << seconds << ',' << m_device->getCurrentFrameId();
+    for (const Entry& entry : m_entries) {
+      m_csv << ',' << std::setprecision(2) << double(entry.current) / double(1 << 20);
+    }
+    m_csv << ',' << m_textureResidency.fullCount << ',' << m_textureResidency.partialCount
+          << ',' << m_textureResidency.pendingCount << ',' << m_textureResidency.failedCount << '\n';
+    m_csv.flush();
+  }
+
+  std::vector<RtxMemoryTelemetry::Entry> RtxMemoryTelemetry::getEntries() const {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_entries;
+  }
+
+  RtxTextureManager::ResidencyStats RtxMemoryTelemetry::getTextureResidency() const {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_textureResidency;
+  }
+
+} // namespace dxvk
@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dxvk_memory.h"
+#include "rtx_common_object.h"
+#include "rtx_option.h"
+#include "rtx_texture_manager.h"
+
+namespace dxvk {
+
+  // Tracks the memory used by every allocation category, in video and in system memory, along with
+  // the residency of the streamed textures and the private memory of the process. Entries keep their
+  // peak and a trend over a rolling window, so that slow growth in a long session stands out from the
+  // normal ups and downs of loading a map. Acceleration structures, opacity micromaps, replacement
+  // geometry and the render targets of all passes (denoisers, NRC, G-buffer) each map to their memory
+  // category.
+  //
+  // Memory categories are sampled every frame so that short lived peaks are not missed, everything
+  // else once per second. The samples can be appended to rtx.memoryTelemetry.csvPath periodically.
+  class RtxMemoryTelemetry : public CommonDeviceObject {
+  public:
+    struct Entry {
+      std::string name;
+      VkDeviceSize current = 0;
+      VkDeviceSize peak = 0;
+      // Change over the trend window, in MiB per minute
+      float trendMibPerMinute = 0.f;
+    };
+
+    explicit RtxMemoryTelemetry(DxvkDevice* device);
+
+    // Samples memory use, called once per frame on the CS thread
+    void update();
+
+    // Can be called from any thread
+    std::vector<Entry> getEntries() const;
+    RtxTextureManager::ResidencyStats getTextureResidency() const;
+
+  private:
+    RTX_OPTION("rtx.memoryTelemetry", std::string, csvPath, "",
+               "When set, the memory use of every category tracked by the memory telemetry is appended to the CSV file at this path every rtx.memoryTelemetry.csvIntervalSeconds.\n"
+               "The same numbers, with their peaks and trends, are shown by the \"memory\" DXVK_HUD item.");
+    RTX_OPTION("rtx.memoryTelemetry", float, csvIntervalSeconds, 10.f,
+               "The interval in seconds at which memory telemetry is written to rtx.memoryTelemetry.csvPath.");
+    RTX_OPTION("rtx.memoryTelemetry", float, trendWindowSeconds, 300.f,
+               "The window in seconds over which the memory telemetry trend of every category is measured. Longer windows smooth over loading spikes and make leaks in long sessions easier to spot.");
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+      double seconds;
+      std::vector<VkDeviceSize> values;
+    };
+
+    void sampleSlow(double seconds);
+    void updateTrends(double seconds);
+    void writeCsv(double seconds);
+
+    mutable dxvk::mutex m_mutex;
+
+    std::vector<Entry> m_entries;
+    // Index of the first entry that is not one of the memory categories
+    size_t m_firstSlowEntry = 0;
+    RtxTextureManager::ResidencyStats m_textureResidency;
+
+    std::deque<Sample> m_samples;
+    Clock::time_point m_startTime;
+    double m_lastSlowSampleSeconds = -1.0;
+    double m_lastCsvSeconds = -1.0;
+
+    std::ofstream m_csv;
+    std::string m_csvPath;
+  };
+
+} // namespace dxvk
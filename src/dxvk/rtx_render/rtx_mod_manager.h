@@ -23,6 +23,7 @@
 
 #include "../../util/rc/util_rc_ptr.h"
 #include "../../lssusd/game_exporter_paths.h"
+#include "../../util/xxHash/xxhash.h"
 
 #include <string>
 #include <filesystem>
@@ -75,6 +76,13 @@ public:
   virtual void unload() = 0;
   // Updates the replacements if mod changed.
   virtual bool checkForChanges(const Rc<DxvkContext>& context) = 0;
+  // Asks the mod to build the mesh replacements of a hash it has deferred, see rtx.lazyReplacementMeshLoading.
+  // Returns true while such replacements are still being built, the original mesh should be drawn in the meantime.
+  virtual bool requestMeshReplacement(XXH64_hash_t hash) {
+    return false;
+  }
+  // Stops any background work of the mod, called before the device is destroyed.
+  virtual void onDestroy() { }
 
   State state() const {
     const auto encodedState{ m_state.load() };
@@ -31,15 +31,22 @@
 #include "rtx_utils.h"
 #include "rtx_asset_data_manager.h"
 #include "rtx_texture_manager.h"
+#include "rtx_usd_mesh_cache.h"
+#include "rtx_thread_budget.h"
 
 #include "../../lssusd/usd_include_begin.h"
 #include <pxr/base/gf/matrix4f.h>
 #include <pxr/base/gf/rotation.h>
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+#include <pxr/base/tf/weakPtr.h>
+#include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/types.h>
 #include <pxr/usd/usd/tokens.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usd/prim.h>
 #include <pxr/usd/usd/primCompositionQuery.h>
+#include <pxr/usd/usd/notice.h>
 #include <pxr/usd/usd/attribute.h>
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/pointInstancer.h>
@@ -57,6 +64,7 @@
 #include <pxr/base/arch/fileSystem.h>
 #include "../../lssusd/usd_include_end.h"
 #include "../util/util_watchdog.h"
+#include "../../util/util_threadpool.h"
 
 #include "../../lssusd/game_exporter_common.h"
 #include "../../lssusd/game_exporter_paths.h"
@@ -66,6 +74,7 @@
 #include "rtx_lights_data.h"
 #include <filesystem>
 #include <algorithm>
+#include <unordered_set>
 
 namespace fs = std::filesystem;
 
@@ -73,16 +82,23 @@ namespace dxvk {
 constexpr uint32_t kMaxU16Indices = 64 * 1024;
 const char* const kStatusKey = "remix_replacement_status";
 
-class UsdMod::Impl {
+class UsdMod::Impl : public pxr::TfWeakBase {
 public:
   Impl(UsdMod& owner) 
     : m_owner{owner}
     , m_usdChangeWatchdog([this] { return this->haveFilesChanged(); }, "usd-mod-watchdog")
   {}
 
+  ~Impl() {
+    stopLazyLoading();
+    stopTrackingChanges();
+  }
+
   void load(const Rc<DxvkContext>& context);
   void unload();
   bool checkForChanges(const Rc<DxvkContext>& context);
+  bool requestMeshReplacement(XXH64_hash_t hash);
+  void onDestroy();
 
 private:
   UsdMod& m_owner;
@@ -105,8 +121,12 @@ private:
   MaterialData* processMaterialUser(Args& args, const pxr::UsdPrim& prim);
   bool processMesh(const pxr::UsdPrim& prim, Args& args);
   void processPrim(Args& args, const pxr::UsdPrim& prim);
+  void processMeshLods(Args& args, const pxr::UsdPrim& prim, MeshReplacement& replacement);
   void processPointInstancer(Args& args, const pxr::UsdPrim& prim);
 
+  void prepareMeshes(const std::vector<pxr::UsdPrim>& meshPrims);
+  std::unique_ptr<lss::UsdMeshImporter> importMesh(const pxr::UsdPrim& prim, const uint limitedBonesPerVertex);
+
   void processLight(Args& args, const pxr::UsdPrim& lightPrim, const bool isOverride);
   bool processReplacement(Args& args);
   void processReplacementRecursive(Args& args, const pxr::UsdPrim& prim, bool isRoot = false);
@@ -129,6 +149,83 @@ private:
   std::unordered_map<dxvk::DxvkCommandList*, std::thread> m_cmdListSyncThreads;
   // Asset replacement vector and hash to add when command list execution is complete
   std::unordered_map<dxvk::DxvkCommandList*, std::unordered_map<XXH64_hash_t, std::vector<AssetReplacement>>> m_meshReplacementsToAdd;
+
+  // Meshes imported on worker threads ahead of processMesh, see prepareMeshes
+  struct PreparedMesh {
+    std::unique_ptr<lss::UsdMeshImporter> mesh;
+    std::string error;
+  };
+  std::unordered_map<pxr::SdfPath, PreparedMesh, pxr::SdfPath::Hash> m_preparedMeshes;
+
+  // Only exists while the meshes of the mod are being processed, including lazily built ones
+  std::unique_ptr<UsdMeshCache> m_meshCache;
+
+  // Lazy replacement loading, see rtx.lazyReplacementMeshLoading. The replacement roots found at load time only
+  // get processed once the game draws their mesh hash, on a thread of their own. The deferred set is not modified
+  // while lazy loading is active, so the render thread can look it up without taking the lock.
+  enum class DeferredState : uint8_t {
+    Deferred,
+    Requested,
+    Done
+  };
+  struct DeferredReplacement {
+    pxr::SdfPath rootPath;
+    std::atomic<DeferredState> state = DeferredState::Deferred;
+  };
+  std::unordered_map<XXH64_hash_t, DeferredReplacement> m_deferredReplacements;
+  pxr::UsdStageRefPtr m_lazyStage;
+  DxvkDevice* m_lazyDevice = nullptr;
+  std::atomic<bool> m_lazyLoadingActive = false;
+  dxvk::mutex m_lazyMutex;
+  dxvk::condition_variable m_lazyCondition;
+  std::vector<XXH64_hash_t> m_requestedReplacements;
+  bool m_stopLazyLoading = false;
+  dxvk::thread m_lazyLoadThread;
+
+  void startLazyLoading(const Rc<DxvkContext>& context, const pxr::UsdStageRefPtr& stage);
+  void stopLazyLoading();
+  void lazyLoadReplacements();
+
+  // Incremental hot reload, see rtx.incrementalModReload. The stage stays open while the mod is loaded and the
+  // objects every replacement root stored are tracked, so that a root the change notices of a layer reload touch
+  // can be taken out of the replacements and processed again on its own.
+  enum class RootType : uint8_t {
+    Material,
+    Mesh,
+    Light
+  };
+  struct ReplacementRoot {
+    RootType type;
+    // Replacement hash of mesh and light roots
+    XXH64_hash_t hash = 0;
+    // Objects stored while processing the root, other roots may be using them too
+    std::vector<XXH64_hash_t> materials;
+    std::vector<XXH64_hash_t> geometries;
+  };
+  struct WatchedLayer {
+    pxr::SdfLayerHandle layer;
+    std::string path;
+    fs::file_time_type modificationTime;
+  };
+  pxr::UsdStageRefPtr m_stage;
+  std::vector<WatchedLayer> m_watchedLayers;
+  std::unordered_map<pxr::SdfPath, ReplacementRoot, pxr::SdfPath::Hash> m_replacementRoots;
+  ReplacementRoot* m_currentRoot = nullptr;
+  // Secret replacement variants come from stages of their own, none of which are tracked
+  bool m_hasUntrackedReplacements = false;
+  pxr::TfNotice::Key m_objectsChangedKey;
+  pxr::SdfPathSet m_changedPaths;
+
+  void watchLayers(const pxr::UsdStageRefPtr& stage);
+  void trackRoot(const pxr::UsdPrim& root, RootType type, XXH64_hash_t hash);
+  void startTrackingChanges();
+  void stopTrackingChanges();
+  void onObjectsChanged(const pxr::UsdNotice::ObjectsChanged& notice);
+  bool reloadChangedRoots(const Rc<DxvkContext>& context, bool& changed);
+
+  // Number of replacement roots whose meshes are imported together, bounds how many imported meshes are held at once
+  static constexpr size_t kMeshImportBatchSize = 256;
+  using MeshImportPool = WorkerThreadPool<4, false, false>;
 };
 
 // context and member variable arguments to pass down to anonymous functions (to avoid having USD in the header)
@@ -183,6 +280,19 @@ XXH64_hash_t getModelHash(const pxr::UsdPrim& prim) {
   return getNamedHash(prim.GetName().GetString(), prefix, len);
 }
 
+// Gathers the mesh prims processReplacementRecursive would run processPrim on, point instancer prototypes are left out
+void collectReplacementMeshes(const pxr::UsdPrim& prim, std::vector<pxr::UsdPrim>& meshPrims) {
+  if (prim.IsA<pxr::UsdGeomMesh>()) {
+    meshPrims.push_back(prim);
+  } else if (prim.IsA<pxr::UsdGeomPointInstancer>()) {
+    return;
+  }
+  auto children = prim.GetFilteredChildren(pxr::UsdPrimIsActive);
+  for (auto child : children) {
+    collectReplacementMeshes(child, meshPrims);
+  }
+}
+
 XXH64_hash_t getLightHash(const pxr::UsdPrim& prim) {
   static const char* prefix = lss::prefix::light.c_str();
   static const size_t len = strlen(prefix);
@@ -366,14 +476,20 @@ MaterialData* UsdMod::Impl::processMaterial(Args& args, const pxr::UsdPrim& matP
   auto getTextureFunctor = [&](const pxr::UsdPrim& shader, const pxr::TfToken& name) {
                              return getTexture(args, shader, name, preloadTextures);
                            };
+  auto storeMaterial = [&](MaterialData&& material) {
+                         if (m_currentRoot) {
+                           m_currentRoot->materials.push_back(materialHash);
+                         }
+                         return &m_owner.m_replacements->storeObject(materialHash, std::move(material));
+                       };
 
   switch (materialType) {
   case RtSurfaceMaterialType::Opaque:
-    return &m_owner.m_replacements->storeObject(materialHash, MaterialData(OpaqueMaterialData::deserialize(getTextureFunctor, shader), shouldIgnore));
+    return storeMaterial(MaterialData(OpaqueMaterialData::deserialize(getTextureFunctor, shader), shouldIgnore));
   case RtSurfaceMaterialType::Translucent:
-    return &m_owner.m_replacements->storeObject(materialHash, MaterialData(TranslucentMaterialData::deserialize(getTextureFunctor, shader), shouldIgnore));
+    return storeMaterial(MaterialData(TranslucentMaterialData::deserialize(getTextureFunctor, shader), shouldIgnore));
   case RtSurfaceMaterialType::RayPortal:
-    return &m_owner.m_replacements->storeObject(materialHash, MaterialData(RayPortalMaterialData::deserialize(getTextureFunctor, shader)));
+    return storeMaterial(MaterialData(RayPortalMaterialData::deserialize(getTextureFunctor, shader)));
   }
 
   return nullptr;
@@ -400,6 +516,11 @@ void UsdMod::Impl::processPrim(Args& args, const pxr::UsdPrim& prim) {
     if (!processMesh(prim, args)) {
       return;
     }
+
+    // Note: LODs are attached before any AssetReplacement refers to the mesh, so drawing never sees them change
+    if (m_owner.m_replacements->getObject(usdOriginHash, pTemp)) {
+      processMeshLods(args, prim, *pTemp);
+    }
   }
 
   MaterialData* materialData = processMaterialUser(args, prim);
@@ -441,6 +562,66 @@ void UsdMod::Impl::processPrim(Args& args, const pxr::UsdPrim& prim) {
   }
 }
 
+static const pxr::TfToken kLodMeshesToken("remix_lod:meshes");
+static const pxr::TfToken kLodScreenSizesToken("remix_lod:screen_sizes");
+
+// LOD meshes are children of the mesh they stand in for, and are only ever drawn in its place
+bool isLodMesh(const pxr::UsdPrim& prim) {
+  const pxr::UsdPrim parent = prim.GetParent();
+  if (!parent || !parent.IsA<pxr::UsdGeomMesh>()) {
+    return false;
+  }
+
+  const pxr::UsdRelationship lodMeshes = parent.GetRelationship(kLodMeshesToken);
+  pxr::SdfPathVector lodPaths;
+  if (!lodMeshes || !lodMeshes.GetTargets(&lodPaths)) {
+    return false;
+  }
+  return std::find(lodPaths.begin(), lodPaths.end(), prim.GetPath()) != lodPaths.end();
+}
+
+void UsdMod::Impl::processMeshLods(Args& args, const pxr::UsdPrim& prim, MeshReplacement& replacement) {
+  const pxr::UsdRelationship lodMeshes = prim.GetRelationship(kLodMeshesToken);
+  pxr::SdfPathVector lodPaths;
+  if (!lodMeshes || !lodMeshes.GetTargets(&lodPaths) || lodPaths.empty()) {
+    return;
+  }
+
+  pxr::VtArray<float> screenSizes;
+  if (!prim.GetAttribute(kLodScreenSizesToken).Get(&screenSizes) || screenSizes.size() != lodPaths.size()) {
+    Logger::err(str::format("Prim: ", prim.GetPath().GetString(), ", needs one ", kLodScreenSizesToken.GetString(), " entry per ", kLodMeshesToken.GetString(), " target, ignoring its LODs."));
+    return;
+  }
+
+  std::vector<MeshLod> lods;
+  for (size_t i = 0; i < lodPaths.size(); i++) {
+    const pxr::UsdPrim lodPrim = prim.GetStage()->GetPrimAtPath(lodPaths[i]);
+    if (!lodPrim || !lodPrim.IsA<pxr::UsdGeomMesh>() || lodPrim.GetParent() != prim) {
+      Logger::err(str::format("Prim: ", prim.GetPath().GetString(), ", LOD ", lodPaths[i].GetString(), " has to be a child mesh of the prim, ignoring its LODs."));
+      return;
+    }
+    if (i > 0 && screenSizes[i] >= screenSizes[i - 1]) {
+      Logger::err(str::format("Prim: ", prim.GetPath().GetString(), ", ", kLodScreenSizesToken.GetString(), " has to be in decreasing order, ignoring its LODs."));
+      return;
+    }
+
+    // Note: LOD meshes are processed like any other mesh, so a LOD shared by several meshes also shares its BLAS.
+    // LODs with GeomSubsets are not supported, the LOD has to be a single mesh like the mesh it stands in for.
+    const XXH64_hash_t lodOriginHash = getStrongestOpinionatedPathHash(lodPrim);
+    MeshReplacement* pLodGeometry;
+    if (!m_owner.m_replacements->getObject(lodOriginHash, pLodGeometry)) {
+      if (!processMesh(lodPrim, args) || !m_owner.m_replacements->getObject(lodOriginHash, pLodGeometry)) {
+        Logger::err(str::format("Prim: ", prim.GetPath().GetString(), ", failed to load LOD ", lodPaths[i].GetString(), ", ignoring its LODs."));
+        return;
+      }
+    }
+
+    lods.push_back(MeshLod { pLodGeometry, screenSizes[i] });
+  }
+
+  replacement.lods = std::move(lods);
+}
+
 bool hasExplicitTransform(const pxr::UsdPrim& prim) {
   return prim.HasAttribute(pxr::TfToken("xformOp:rotateZYX")) || prim.HasAttribute(pxr::TfToken("xformOp:scale")) || prim.HasAttribute(pxr::TfToken("xformOp:translate")) || prim.HasAttribute(pxr::TfToken("xformOpOrder"));
 }
@@ -700,8 +881,77 @@ bool UsdMod::Impl::processReplacement(Args& args) {
   }
 }
 
+void UsdMod::Impl::prepareMeshes(const std::vector<pxr::UsdPrim>& meshPrims) {
+  ScopedCpuProfileZone();
+  m_preparedMeshes.clear();
+
+  // Only the first prim of each mesh gets processed, the rest reuse its replacement
+  std::vector<pxr::UsdPrim> uniqueMeshPrims;
+  std::unordered_set<XXH64_hash_t> seenOrigins;
+  for (const pxr::UsdPrim& prim : meshPrims) {
+    const XXH64_hash_t usdOriginHash = getStrongestOpinionatedPathHash(prim);
+    MeshReplacement* pTemp;
+    if (seenOrigins.insert(usdOriginHash).second && !m_owner.m_replacements->getObject(usdOriginHash, pTemp)) {
+      uniqueMeshPrims.push_back(prim);
+    }
+  }
+
+  const uint32_t numThreads = std::min<size_t>(RtxThreadBudget::getThreadCount(ThreadClass::Streaming, RtxOptions::numMeshImportThreads()), uniqueMeshPrims.size());
+  if (numThreads <= 1) {
+    return;
+  }
+
+  // The importers only read from the stage, which is safe to do from multiple threads. Everything that touches
+  // the device or the replacement tables stays in processMesh, so the replacements come out the same as a serial load.
+  std::vector<PreparedMesh> preparedMeshes(uniqueMeshPrims.size());
+  std::atomic<size_t> nextMesh = 0;
+  const uint limitedBonesPerVertex = RtxOptions::limitedBonesPerVertex();
+  {
+    MeshImportPool pool(numThreads, "rtx-usd-mesh-import", RtxThreadBudget::getPriority(ThreadClass::Streaming));
+    std::vector<Future<void>> futures;
+    for (uint32_t i = 0; i < numThreads; i++) {
+      futures.push_back(pool.Schedule([&]() {
+        for (size_t meshIdx = nextMesh++; meshIdx < uniqueMeshPrims.size(); meshIdx = nextMesh++) {
+          try {
+            preparedMeshes[meshIdx].mesh = importMesh(uniqueMeshPrims[meshIdx], limitedBonesPerVertex);
+          } catch (const DxvkError& e) {
+            preparedMeshes[meshIdx].error = e.message();
+          }
+        }
+      }));
+    }
+    for (const Future<void>& future : futures) {
+      if (future.valid()) {
+        future.get();
+      }
+    }
+  }
+
+  for (size_t i = 0; i < uniqueMeshPrims.size(); i++) {
+    m_preparedMeshes.emplace(uniqueMeshPrims[i].GetPath(), std::move(preparedMeshes[i]));
+  }
+}
+
+std::unique_ptr<lss::UsdMeshImporter> UsdMod::Impl::importMesh(const pxr::UsdPrim& prim, const uint limitedBonesPerVertex) {
+  if (m_meshCache) {
+    if (std::unique_ptr<lss::UsdMeshImporter> cachedMesh = m_meshCache->find(prim)) {
+      return cachedMesh;
+    }
+  }
+
+  std::unique_ptr<lss::UsdMeshImporter> mesh = std::make_unique<lss::UsdMeshImporter>(prim, limitedBonesPerVertex);
+
+  if (m_meshCache) {
+    m_meshCache->add(prim, *mesh);
+  }
+  return mesh;
+}
+
 void UsdMod::Impl::processReplacementRecursive(Args& args, const pxr::UsdPrim& prim, bool isRoot) {
   if (prim.IsA<pxr::UsdGeomMesh>()) {
+    if (isLodMesh(prim)) {
+      return;  // drawn in place of its parent mesh, see processMeshLods
+    }
     processPrim(args, prim);
   } else if (prim.IsA<pxr::UsdGeomPointInstancer>()) {
     processPointInstancer(args, prim);
@@ -728,6 +978,8 @@ void UsdMod::Impl::load(const Rc<DxvkContext>& context) {
 void UsdMod::Impl::unload() {
   if (m_owner.state().progressState == ProgressState::Loaded) {
     m_usdChangeWatchdog.stop();
+    stopLazyLoading();
+    stopTrackingChanges();
 
     m_owner.m_replacements->clear();
     AssetDataManager::get().clearSearchPaths();
@@ -736,12 +988,146 @@ void UsdMod::Impl::unload() {
   }
 }
 
+void UsdMod::Impl::onDestroy() {
+  stopLazyLoading();
+}
+
+bool UsdMod::Impl::requestMeshReplacement(XXH64_hash_t hash) {
+  if (!m_lazyLoadingActive.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  auto it = m_deferredReplacements.find(hash);
+  if (it == m_deferredReplacements.end()) {
+    return false;
+  }
+
+  DeferredState expected = DeferredState::Deferred;
+  if (it->second.state.compare_exchange_strong(expected, DeferredState::Requested)) {
+    std::lock_guard<dxvk::mutex> lock(m_lazyMutex);
+    m_requestedReplacements.push_back(hash);
+    m_lazyCondition.notify_one();
+    return true;
+  }
+
+  return expected != DeferredState::Done;
+}
+
+void UsdMod::Impl::startLazyLoading(const Rc<DxvkContext>& context, const pxr::UsdStageRefPtr& stage) {
+  m_lazyStage = stage;
+  // Not an Rc, the mod must not keep the device alive
+  m_lazyDevice = context->getDevice().ptr();
+  m_stopLazyLoading = false;
+  m_lazyLoadThread = dxvk::thread([this] { lazyLoadReplacements(); });
+  m_lazyLoadingActive.store(true, std::memory_order_release);
+
+  Logger::info(str::format("[UsdMod] Deferred ", m_deferredReplacements.size(), " mesh replacements until their meshes are drawn."));
+}
+
+void UsdMod::Impl::stopLazyLoading() {
+  if (!m_lazyLoadThread.joinable()) {
+    return;
+  }
+
+  m_lazyLoadingActive.store(false, std::memory_order_release);
+  {
+    std::lock_guard<dxvk::mutex> lock(m_lazyMutex);
+    m_stopLazyLoading = true;
+    m_lazyCondition.notify_one();
+  }
+  m_lazyLoadThread.join();
+
+  if (m_meshCache) {
+    m_meshCache->finish();
+    m_meshCache.reset();
+  }
+
+  m_requestedReplacements.clear();
+  m_deferredReplacements.clear();
+  m_lazyStage = nullptr;
+  m_lazyDevice = nullptr;
+}
+
+void UsdMod::Impl::lazyLoadReplacements() {
+  env::setThreadName("rtx-usd-lazy-load");
+
+  pxr::UsdGeomXformCache xformCache;
+  std::vector<XXH64_hash_t> requested;
+  std::vector<std::pair<XXH64_hash_t, std::vector<AssetReplacement>>> loaded;
+
+  while (true) {
+    {
+      std::unique_lock<dxvk::mutex> lock(m_lazyMutex);
+      m_lazyCondition.wait(lock, [this] { return m_stopLazyLoading || !m_requestedReplacements.empty(); });
+      if (m_stopLazyLoading) {
+        return;
+      }
+      requested.swap(m_requestedReplacements);
+    }
+
+    ScopedCpuProfileZoneN("Lazy Replacement Loading");
+
+    // A context per batch, a context held across batches would keep the device alive
+    Rc<DxvkContext> context = m_lazyDevice->createContext();
+    context->beginRecording(m_lazyDevice->createCommandList());
+
+    for (const XXH64_hash_t hash : requested) {
+      DeferredReplacement& deferred = m_deferredReplacements.at(hash);
+      pxr::UsdPrim rootPrim = m_lazyStage->GetPrimAtPath(deferred.rootPath);
+      std::vector<AssetReplacement> replacementVec;
+      Args args = {context, xformCache, rootPrim, replacementVec};
+
+      try {
+        if (processReplacement(args)) {
+          loaded.emplace_back(hash, std::move(replacementVec));
+          continue;
+        }
+      } catch (const DxvkError& e) {
+        Logger::err(e.message());
+      }
+      // Nothing to replace the mesh with, let the mods after this one have a go at it
+      deferred.state = DeferredState::Done;
+    }
+    requested.clear();
+
+    context->emitMemoryBarrier(0,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+      VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+
+    // Same as addReplacementsSync, the replacements may only be used once their uploads are done
+    Rc<sync::Fence> uploadSignal = new sync::Fence(0);
+    context->getCommandList()->queueSignal(uploadSignal, 1);
+    context->flushCommandList();
+    context = nullptr;
+    uploadSignal->wait(1);
+
+    for (auto& [hash, replacementVec] : loaded) {
+      m_owner.m_replacements->set<AssetReplacement::eMesh>(hash, std::move(replacementVec));
+      m_deferredReplacements.at(hash).state = DeferredState::Done;
+    }
+    loaded.clear();
+  }
+}
+
 bool UsdMod::Impl::haveFilesChanged() {
   if (m_openedFilePath.empty())
     return false;
 
   fs::file_time_type newModTime;
   if (m_owner.state().progressState == ProgressState::Loaded) {
+    // Any layer of the mod, the sublayers and referenced files included
+    for (const WatchedLayer& watched : m_watchedLayers) {
+      std::error_code ec;
+      newModTime = fs::last_write_time(fs::path(watched.path), ec);
+      if (ec || newModTime > watched.modificationTime) {
+        return true;
+      }
+    }
+    if (!m_watchedLayers.empty()) {
+      return false;
+    }
     newModTime = fs::last_write_time(fs::path(m_openedFilePath));
   } else {
     bool fileFound = false;
@@ -759,14 +1145,297 @@ bool UsdMod::Impl::haveFilesChanged() {
 
 bool UsdMod::Impl::checkForChanges(const Rc<DxvkContext>& context) {
   if (m_usdChangeWatchdog.hasSignaled()) {
+    // The watched layers are updated by the reload
+    m_usdChangeWatchdog.stop();
+
+    bool changed = true;
+    if (m_owner.state().progressState == ProgressState::Loaded && reloadChangedRoots(context, changed)) {
+      m_usdChangeWatchdog.start();
+      return changed;
+    }
+
     unload();
     load(context);
+    m_usdChangeWatchdog.start();
     return true;
   }
 
   return false;
 }
 
+void UsdMod::Impl::watchLayers(const pxr::UsdStageRefPtr& stage) {
+  m_watchedLayers.clear();
+  for (const pxr::SdfLayerHandle& layer : stage->GetUsedLayers()) {
+    const std::string& path = layer->GetRealPath();
+    if (layer->IsAnonymous() || path.empty()) {
+      continue;
+    }
+
+    std::error_code ec;
+    const fs::file_time_type modificationTime = fs::last_write_time(fs::path(path), ec);
+    if (!ec) {
+      m_watchedLayers.push_back({ layer, path, modificationTime });
+    }
+  }
+}
+
+void UsdMod::Impl::trackRoot(const pxr::UsdPrim& root, RootType type, XXH64_hash_t hash) {
+  if (!m_stage) {
+    return;
+  }
+
+  ReplacementRoot& record = m_replacementRoots[root.GetPath()];
+  record = ReplacementRoot { type, hash };
+  m_currentRoot = &record;
+}
+
+void UsdMod::Impl::startTrackingChanges() {
+  m_currentRoot = nullptr;
+  if (!m_stage) {
+    return;
+  }
+
+  if (m_hasUntrackedReplacements) {
+    m_stage = nullptr;
+    m_replacementRoots.clear();
+    return;
+  }
+
+  m_objectsChangedKey = pxr::TfNotice::Register(pxr::TfWeakPtr<Impl>(this), &Impl::onObjectsChanged, pxr::UsdStageWeakPtr(m_stage));
+}
+
+void UsdMod::Impl::stopTrackingChanges() {
+  pxr::TfNotice::Revoke(m_objectsChangedKey);
+  m_stage = nullptr;
+  m_watchedLayers.clear();
+  m_replacementRoots.clear();
+  m_currentRoot = nullptr;
+  m_hasUntrackedReplacements = false;
+  m_changedPaths.clear();
+}
+
+void UsdMod::Impl::onObjectsChanged(const pxr::UsdNotice::ObjectsChanged& notice) {
+  for (const pxr::SdfPath& path : notice.GetResyncedPaths()) {
+    m_changedPaths.insert(path.GetPrimPath());
+  }
+  for (const pxr::SdfPath& path : notice.GetChangedInfoOnlyPaths()) {
+    m_changedPaths.insert(path.GetPrimPath());
+  }
+}
+
+bool UsdMod::Impl::reloadChangedRoots(const Rc<DxvkContext>& context, bool& changed) {
+  if (!m_stage) {
+    return false;
+  }
+
+  ScopedCpuProfileZone();
+
+  // Reloading a layer sends the change notices for all the composed values its new contents changed
+  m_changedPaths.clear();
+  for (WatchedLayer& watched : m_watchedLayers) {
+    std::error_code ec;
+    const fs::file_time_type modificationTime = fs::last_write_time(fs::path(watched.path), ec);
+    if (ec || !watched.layer) {
+      return false;
+    }
+    if (modificationTime > watched.modificationTime) {
+      if (!watched.layer->Reload()) {
+        return false;
+      }
+      watched.modificationTime = modificationTime;
+    }
+  }
+
+  // Map the changed paths to the replacement roots they belong to
+  static const pxr::SdfPath kLooksPath("/RootNode/Looks");
+  static const pxr::SdfPath kMeshesPath("/RootNode/meshes");
+  static const pxr::SdfPath kLightsPath("/RootNode/lights");
+  static const std::pair<pxr::SdfPath, RootType> kCategories[] = {
+    { kLooksPath, RootType::Material },
+    { kMeshesPath, RootType::Mesh },
+    { kLightsPath, RootType::Light }
+  };
+  std::unordered_map<pxr::SdfPath, RootType, pxr::SdfPath::Hash> changedRoots;
+  for (const pxr::SdfPath& path : m_changedPaths) {
+    // Anything outside of the categories only matters through the roots composing it, which get notices of their own
+    for (const auto& [categoryPath, type] : kCategories) {
+      if (categoryPath.HasPrefix(path)) {
+        // The layer structure, the root layer metadata or a whole category changed
+        return false;
+      }
+      if (path.HasPrefix(categoryPath)) {
+        changedRoots.emplace(path.GetPrefixes()[categoryPath.GetPathElementCount()], type);
+      }
+    }
+  }
+  m_changedPaths.clear();
+
+  if (changedRoots.empty()) {
+    changed = false;
+    return true;
+  }
+
+  // A root has to be processed again when it uses an object a changed root stored, and when it shares its hash
+  // with a changed root, so that the first root of a hash in stage order still wins.
+  std::unordered_set<XXH64_hash_t> changedMeshHashes;
+  std::unordered_set<XXH64_hash_t> changedLightHashes;
+  std::unordered_set<const MaterialData*> removedMaterials;
+  std::unordered_set<const MeshReplacement*> removedGeometries;
+  std::vector<pxr::SdfPath> newlyChanged;
+  for (const auto& [path, type] : changedRoots) {
+    newlyChanged.push_back(path);
+  }
+
+  while (!newlyChanged.empty()) {
+    for (const pxr::SdfPath& path : newlyChanged) {
+      const RootType type = changedRoots.at(path);
+      XXH64_hash_t hash = 0;
+      if (auto it = m_replacementRoots.find(path); it != m_replacementRoots.end()) {
+        hash = it->second.hash;
+        for (const XXH64_hash_t materialHash : it->second.materials) {
+          MaterialData* material;
+          if (m_owner.m_replacements->getObject(materialHash, material)) {
+            removedMaterials.insert(material);
+          }
+        }
+        for (const XXH64_hash_t geometryHash : it->second.geometries) {
+          MeshReplacement* geometry;
+          if (m_owner.m_replacements->getObject(geometryHash, geometry)) {
+            removedGeometries.insert(geometry);
+          }
+        }
+      } else if (pxr::UsdPrim prim = m_stage->GetPrimAtPath(path)) {
+        // Added by the change
+        hash = type == RootType::Mesh ? getModelHash(prim) : type == RootType::Light ? getLightHash(prim) : 0;
+      }
+
+      if (type == RootType::Mesh) {
+        changedMeshHashes.insert(hash);
+      } else if (type == RootType::Light) {
+        changedLightHashes.insert(hash);
+      }
+    }
+    newlyChanged.clear();
+
+    for (const auto& [path, root] : m_replacementRoots) {
+      if (changedRoots.count(path) != 0) {
+        continue;
+      }
+
+      bool isAffected = false;
+      if (root.type == RootType::Mesh) {
+        isAffected = changedMeshHashes.count(root.hash) != 0;
+        if (const std::vector<AssetReplacement>* replacements = m_owner.m_replacements->get<AssetReplacement::eMesh>(root.hash)) {
+          for (const AssetReplacement& replacement : *replacements) {
+            isAffected |= removedGeometries.count(replacement.geometry) != 0 || removedMaterials.count(replacement.materialData) != 0;
+          }
+        }
+      } else if (root.type == RootType::Light) {
+        isAffected = changedLightHashes.count(root.hash) != 0;
+      }
+
+      if (isAffected) {
+        changedRoots.emplace(path, root.type);
+        newlyChanged.push_back(path);
+      }
+    }
+  }
+
+  // Take everything the changed roots stored out of the replacements
+  const size_t numTrackedRoots = m_replacementRoots.size();
+  for (const auto& [path, type] : changedRoots) {
+    auto it = m_replacementRoots.find(path);
+    if (it == m_replacementRoots.end()) {
+      continue;
+    }
+    for (const XXH64_hash_t materialHash : it->second.materials) {
+      m_owner.m_replacements->removeObject<MaterialData>(materialHash);
+    }
+    for (const XXH64_hash_t geometryHash : it->second.geometries) {
+      m_owner.m_replacements->removeObject<MeshReplacement>(geometryHash);
+    }
+    if (type == RootType::Mesh) {
+      m_owner.m_replacements->remove<AssetReplacement::eMesh>(it->second.hash);
+    } else if (type == RootType::Light) {
+      m_owner.m_replacements->remove<AssetReplacement::eLight>(it->second.hash);
+    }
+    m_replacementRoots.erase(it);
+  }
+
+  // And process them again in the same order a full load would
+  pxr::UsdGeomXformCache xformCache;
+
+  pxr::UsdPrim materialRoot = m_stage->GetPrimAtPath(kLooksPath);
+  if (materialRoot.IsValid()) {
+    std::vector<AssetReplacement> placeholder;
+    Args args = {context, xformCache, materialRoot, placeholder};
+
+    for (pxr::UsdPrim materialPrim : materialRoot.GetFilteredChildren(pxr::UsdPrimIsActive)) {
+      if (changedRoots.count(materialPrim.GetPath()) != 0) {
+        trackRoot(materialPrim, RootType::Material, 0);
+        processMaterial(args, materialPrim);
+      }
+    }
+  }
+
+  pxr::UsdPrim meshes = m_stage->GetPrimAtPath(kMeshesPath);
+  if (meshes.IsValid()) {
+    std::vector<pxr::UsdPrim> changedMeshRoots;
+    std::vector<pxr::UsdPrim> meshPrims;
+    for (pxr::UsdPrim child : meshes.GetFilteredChildren(pxr::UsdPrimIsActive)) {
+      if (changedRoots.count(child.GetPath()) != 0 && getModelHash(child) != 0) {
+        changedMeshRoots.push_back(child);
+        collectReplacementMeshes(child, meshPrims);
+      }
+    }
+    prepareMeshes(meshPrims);
+
+    for (pxr::UsdPrim& child : changedMeshRoots) {
+      const auto hash = getModelHash(child);
+      std::vector<AssetReplacement> replacementVec;
+      Args args = {context, xformCache, child, replacementVec};
+
+      trackRoot(child, RootType::Mesh, hash);
+      if (processReplacement(args)) {
+        addReplacementsSync(args.context->getCommandList(), hash, replacementVec);
+      }
+    }
+    m_preparedMeshes.clear();
+  }
+
+  pxr::UsdPrim lights = m_stage->GetPrimAtPath(kLightsPath);
+  if (lights.IsValid()) {
+    for (pxr::UsdPrim child : lights.GetFilteredChildren(pxr::UsdPrimIsActive)) {
+      const auto hash = getLightHash(child);
+      if (hash == 0 || changedRoots.count(child.GetPath()) == 0) {
+        continue;
+      }
+
+      std::vector<AssetReplacement> replacementVec;
+      Args args = {context, xformCache, child, replacementVec};
+
+      trackRoot(child, RootType::Light, hash);
+      if (processReplacement(args)) {
+        m_owner.m_replacements->set<AssetReplacement::eLight>(hash, std::move(replacementVec));
+      }
+    }
+  }
+  m_currentRoot = nullptr;
+
+  context->emitMemoryBarrier(0,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    VK_ACCESS_TRANSFER_WRITE_BIT,
+    VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+    VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+
+  // Layers the change added to the stage get watched from now on
+  watchLayers(m_stage);
+
+  Logger::info(str::format("[UsdMod] Reloaded ", changedRoots.size(), " of ", numTrackedRoots, " replacement roots of ", m_openedFilePath, "."));
+  changed = true;
+  return true;
+}
+
 void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
   ScopedCpuProfileZone();
   std::string replacementsUsdPath(m_owner.m_filePath.string());
@@ -804,6 +1473,11 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
   m_fileModificationTime = fs::last_write_time(fs::path(m_openedFilePath));
   pxr::UsdGeomXformCache xformCache;
 
+  watchLayers(stage);
+  if (RtxOptions::incrementalModReload() && !RtxOptions::lazyReplacementMeshLoading()) {
+    m_stage = stage;
+  }
+
   pxr::VtDictionary layerData = stage->GetRootLayer()->GetCustomLayerData();
   if (layerData.empty()) {
     m_owner.m_status = "Layer Data Missing";
@@ -829,6 +1503,7 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
     Args args = {context, xformCache, materialRoot, placeholder};
 
     for (pxr::UsdPrim materialPrim : children) {
+      trackRoot(materialPrim, RootType::Material, 0);
       processMaterial(args, materialPrim);
 
       // Note: Update the state progress only every 16 materials to reduce the number of atomic writes.
@@ -842,31 +1517,64 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
 
   m_owner.setStateWithCount(ProgressState::ProcessingMeshes, 0);
 
+  if (RtxOptions::enableUsdMeshCache()) {
+    m_meshCache = std::make_unique<UsdMeshCache>(m_owner.m_filePath, stage, RtxOptions::limitedBonesPerVertex());
+  }
+
   fast_unordered_cache<uint32_t> variantCounts;
   pxr::UsdPrim meshes = stage->GetPrimAtPath(pxr::SdfPath("/RootNode/meshes"));
   if (meshes.IsValid()) {
-    const auto children = meshes.GetFilteredChildren(pxr::UsdPrimIsActive);
+    const auto childRange = meshes.GetFilteredChildren(pxr::UsdPrimIsActive);
+    const std::vector<pxr::UsdPrim> children(childRange.begin(), childRange.end());
     std::uint32_t currentMeshCount{ 0U };
 
-    for (pxr::UsdPrim child : children) {
-      const auto hash = getModelHash(child);
-
-      if (hash != 0) {
-        std::vector<AssetReplacement> replacementVec;
-        Args args = {context, xformCache, child, replacementVec};
-
-        if (processReplacement(args)) {
+    if (RtxOptions::lazyReplacementMeshLoading()) {
+      for (const pxr::UsdPrim& child : children) {
+        const auto hash = getModelHash(child);
+        if (hash != 0) {
+          m_deferredReplacements[hash].rootPath = child.GetPath();
           variantCounts[hash]++;
+        }
+      }
+    }
 
-          addReplacementsSync(args.context->getCommandList(), hash, replacementVec);
+    std::vector<pxr::UsdPrim> meshPrims;
+    for (size_t batchStart = 0; batchStart < children.size() && m_deferredReplacements.empty(); batchStart += kMeshImportBatchSize) {
+      const size_t batchEnd = std::min(batchStart + kMeshImportBatchSize, children.size());
+
+      // Import the meshes of the whole batch up front, the replacements are then built in stage order
+      meshPrims.clear();
+      for (size_t i = batchStart; i < batchEnd; i++) {
+        if (getModelHash(children[i]) != 0) {
+          collectReplacementMeshes(children[i], meshPrims);
         }
       }
+      prepareMeshes(meshPrims);
+
+      for (size_t i = batchStart; i < batchEnd; i++) {
+        const pxr::UsdPrim& child = children[i];
+        const auto hash = getModelHash(child);
 
-      // Note: Update the state progress only every 16 meshes to reduce the number of atomic writes.
-      if ((++currentMeshCount & 0b1111u) == 0u) {
-        m_owner.setStateWithCount(ProgressState::ProcessingMeshes, currentMeshCount);
+        if (hash != 0) {
+          std::vector<AssetReplacement> replacementVec;
+          pxr::UsdPrim rootPrim = child;
+          Args args = {context, xformCache, rootPrim, replacementVec};
+
+          trackRoot(child, RootType::Mesh, hash);
+          if (processReplacement(args)) {
+            variantCounts[hash]++;
+
+            addReplacementsSync(args.context->getCommandList(), hash, replacementVec);
+          }
+        }
+
+        // Note: Update the state progress only every 16 meshes to reduce the number of atomic writes.
+        if ((++currentMeshCount & 0b1111u) == 0u) {
+          m_owner.setStateWithCount(ProgressState::ProcessingMeshes, currentMeshCount);
+        }
       }
     }
+    m_preparedMeshes.clear();
   }
 
   // Process Secret Meshes
@@ -890,6 +1598,8 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
       }
       auto rootPrim = pStage->GetDefaultPrim();
       auto variantHash = hash + secretReplacement.variantId;
+      m_currentRoot = nullptr;
+      m_hasUntrackedReplacements = true;
       std::vector<AssetReplacement> replacementVec;
 
       Args args = {context, xformCache, rootPrim, replacementVec};
@@ -900,6 +1610,12 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
     }
   }
 
+  // Deferred meshes can still add to the cache
+  if (m_meshCache && m_deferredReplacements.empty()) {
+    m_meshCache->finish();
+    m_meshCache.reset();
+  }
+
   // Process Lights
 
   m_owner.setStateWithCount(ProgressState::ProcessingLights, 0);
@@ -916,6 +1632,7 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
         std::vector<AssetReplacement> replacementVec;
         Args args = {context, xformCache, child, replacementVec};
 
+        trackRoot(child, RootType::Light, hash);
         if (processReplacement(args)) {
           m_owner.m_replacements->set<AssetReplacement::eLight>(hash, std::move(replacementVec));
         }
@@ -935,6 +1652,11 @@ void UsdMod::Impl::processUSD(const Rc<DxvkContext>& context) {
     VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
     VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR);
 
+  if (!m_deferredReplacements.empty()) {
+    startLazyLoading(context, stage);
+  }
+  startTrackingChanges();
+
   m_owner.setState(ProgressState::Loaded);
 }
 
@@ -1152,12 +1874,24 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
 
   std::unique_ptr<lss::UsdMeshImporter> processedMesh;
 
-  try {
-    processedMesh = std::make_unique<lss::UsdMeshImporter>(prim, RtxOptions::limitedBonesPerVertex());
-  }
-  catch (DxvkError e) {
-    Logger::err(e.message());
-    return false;
+  auto prepared = m_preparedMeshes.find(prim.GetPath());
+  if (prepared != m_preparedMeshes.end()) {
+    processedMesh = std::move(prepared->second.mesh);
+    const std::string error = std::move(prepared->second.error);
+    m_preparedMeshes.erase(prepared);
+
+    if (!processedMesh) {
+      Logger::err(error);
+      return false;
+    }
+  } else {
+    try {
+      processedMesh = importMesh(prim, RtxOptions::limitedBonesPerVertex());
+    }
+    catch (DxvkError e) {
+      Logger::err(e.message());
+      return false;
+    }
   }
 
   geometryData.vertexCount = processedMesh->GetNumVertices();
@@ -1204,9 +1938,17 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
 
   for (const auto& element : processedMesh->GetVertexDecl()) {
     switch (element.attribute) {
-    case lss::UsdMeshImporter::VertexPositions:
+    case lss::UsdMeshImporter::VertexPositions: {
       geometryData.positionBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32G32B32_SFLOAT);
+
+      const uint8_t* pVertexData = reinterpret_cast<const uint8_t*>(processedMesh->GetVertexData().data());
+      for (size_t i = 0; i < processedMesh->GetNumVertices(); i++) {
+        Vector3 position;
+        memcpy(&position, pVertexData + i * processedMesh->GetVertexStride() + element.offset, sizeof(position));
+        replacement.bounds.unionWith(AxisAlignedBoundingBox { position, position });
+      }
       break;
+    }
     case lss::UsdMeshImporter::Normals:
       geometryData.normalBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32_UINT);
       break;
@@ -1250,6 +1992,9 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
     MeshReplacement* childGeometryData;
     if (!m_owner.m_replacements->getObject(usdOriginHash, childGeometryData)) {
       MeshReplacement& newReplacement = m_owner.m_replacements->storeObject(usdOriginHash, MeshReplacement(replacement));
+      if (m_currentRoot) {
+        m_currentRoot->geometries.push_back(usdOriginHash);
+      }
       RasterGeometry& newGeomData = newReplacement.data;
 
       const size_t indexDataSize = submesh.GetNumIndices() * sizeof(uint32_t);
@@ -1301,6 +2046,14 @@ bool UsdMod::checkForChanges(const Rc<DxvkContext>& context) {
   return m_impl->checkForChanges(context);
 }
 
+bool UsdMod::requestMeshReplacement(XXH64_hash_t hash) {
+  return m_impl->requestMeshReplacement(hash);
+}
+
+void UsdMod::onDestroy() {
+  m_impl->onDestroy();
+}
+
 struct UsdModTypeInfo final : public ModTypeInfo {
   std::unique_ptr<Mod> construct(const Mod::Path& modFilePath) const {
     return std::unique_ptr<UsdMod>(new UsdMod(modFilePath));
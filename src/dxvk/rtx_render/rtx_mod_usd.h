@@ -42,6 +42,8 @@ namespace dxvk {
     void load(const Rc<DxvkContext>& context) override;
     void unload() override;
     bool checkForChanges(const Rc<DxvkContext>& context) override;
+    bool requestMeshReplacement(XXH64_hash_t hash) override;
+    void onDestroy() override;
 
     static const ModTypeInfo& getTypeInfo();
 
@@ -96,6 +96,7 @@ namespace dxvk {
     ImGui::DragFloat("Triangle Exploration Accept Range Ratio", &triangleExplorationAcceptRangeRatioObject(), 1.f, 0.0f, 1.0f, "%.3f");
     ImGui::DragInt("Triangle Exploration Max Range", &triangleExplorationMaxRangeObject(), 0.1f, 1, 1000, "%d", ImGuiSliderFlags_AlwaysClamp);
     ImGui::Checkbox("Enable Spatial Reuse", &enableSpatialReuseObject());
+    ImGui::Checkbox("Persist Across Camera Cuts", &persistAcrossCameraCutsObject());
   }
 
   void NeeCachePass::setRaytraceArgs(RaytraceArgs& constants, bool resetHistory) const {    
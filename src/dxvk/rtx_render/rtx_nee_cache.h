@@ -69,6 +69,9 @@ namespace dxvk {
     RTX_OPTION("rtx.neeCache", float, triangleExplorationRangeRatio, 0.1, "Index range to triangle count ratio, when triangle exploration is enabled.");
     RTX_OPTION("rtx.neeCache", float, triangleExplorationAcceptRangeRatio, 0.33, "Accept index range to search range ratio, when triangle exploration is enabled.");
     RTX_OPTION("rtx.neeCache", bool,  enableSpatialReuse, true, "Enable NEE cell share statistics information with neighbors.");
+    RTX_OPTION("rtx.neeCache", bool,  persistAcrossCameraCuts, false, "Keep the NEE cache across camera cuts, e.g. on respawn or when the game teleports the player within the same map.\n"
+               "Cache entries refer to the scene's surfaces, so this also keeps the scene from being cleared on a camera cut, the same way teleportation through ray portals already does.\n"
+               "Objects left behind are still released by the regular garbage collection and the cache entries referring to them fade out.");
   private:
     Rc<vk::DeviceFn> m_vkd;
   };
@@ -1068,19 +1068,21 @@ namespace dxvk {
 
         // Create barrier batch infos
         // ToDo - check if all these are needed - NRC also adds barriers
-        std::vector<VkBufferMemoryBarrier> barriers;
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryPathInfo, srcAccessMask, destAccessMask));
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::TrainingPathInfo, srcAccessMask, destAccessMask));
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::TrainingPathVertices, srcAccessMask, destAccessMask));
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryRadianceParams, srcAccessMask, destAccessMask));
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryRadiance, srcAccessMask, destAccessMask));
-        barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::Counter, srcAccessMask, destAccessMask));
+        // Note: Kept on the stack, this runs every frame on the thread recording the frame
+        std::array<VkBufferMemoryBarrier, 7> barriers;
+        uint32_t numBarriers = 0;
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryPathInfo, srcAccessMask, destAccessMask);
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::TrainingPathInfo, srcAccessMask, destAccessMask);
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::TrainingPathVertices, srcAccessMask, destAccessMask);
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryRadianceParams, srcAccessMask, destAccessMask);
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::QueryRadiance, srcAccessMask, destAccessMask);
+        barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::Counter, srcAccessMask, destAccessMask);
         if (NrcCtxOptions::enableDebugBuffers()) {
-          barriers.push_back(m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::DebugTrainingPathInfo, srcAccessMask, destAccessMask));
+          barriers[numBarriers++] = m_nrcCtx->createVkBufferMemoryBarrier(nrc::BufferIdx::DebugTrainingPathInfo, srcAccessMask, destAccessMask);
         }
 
         // Create the barrier batch
-        vkCmdPipelineBarrier(ctx.getCmdBuffer(DxvkCmdBuffer::ExecBuffer), srcStageMask, dstStageMask, 0, 0, NULL, barriers.size(), barriers.data(), 0, NULL);
+        vkCmdPipelineBarrier(ctx.getCmdBuffer(DxvkCmdBuffer::ExecBuffer), srcStageMask, dstStageMask, 0, 0, NULL, numBarriers, barriers.data(), 0, NULL);
       }
 
       // Dispatch SDK's query and train
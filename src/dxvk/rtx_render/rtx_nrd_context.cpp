@@ -188,7 +188,8 @@ namespace dxvk {
 
   void NRDContext::prepareResources(
     Rc<DxvkContext> ctx,
-    const Resources::RaytracingOutput& rtOutput) {
+    const Resources::RaytracingOutput& rtOutput,
+    const VkExtent3D& denoiseExtent) {
 
     if (!m_cbData) {
       m_cbData = std::make_unique<RtxStagingDataAlloc>(
@@ -198,8 +199,9 @@ namespace dxvk {
         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
     }
 
-    const uint16_t width = static_cast<uint16_t>(rtOutput.m_compositeOutputExtent.width);
-    const uint16_t height = static_cast<uint16_t>(rtOutput.m_compositeOutputExtent.height);
+    // Note: The denoised signal may be at a lower resolution than the frame, see DxvkHalfResolutionDenoise
+    const uint16_t width = static_cast<uint16_t>(denoiseExtent.width);
+    const uint16_t height = static_cast<uint16_t>(denoiseExtent.height);
 
     bool bCreateDenoiser = m_denoiser != m_settings.m_denoiserDesc.denoiser ||
       m_settings.m_commonSettings.resourceSize[0] != width ||
@@ -255,7 +257,7 @@ namespace dxvk {
     }
 
     if (m_settings.m_commonSettings.enableValidation && !m_validationTex.isValid()) {
-      m_validationTex = Resources::createImageResource(ctx, "nrd validation texture", rtOutput.m_compositeOutputExtent, VK_FORMAT_R32G32B32A32_SFLOAT);
+      m_validationTex = Resources::createImageResource(ctx, "nrd validation texture", denoiseExtent, VK_FORMAT_R32G32B32A32_SFLOAT);
     }
   }
 
@@ -636,9 +638,12 @@ namespace dxvk {
     ScopedGpuProfileZone(ctx, "NRD");
     static_cast<RtxContext*>(ctx.ptr())->setFramePassStage(RtxFramePassStage::NRD);
 
-    prepareResources(ctx, rtOutput);
+    // Note: All denoiser inputs share the same extent
+    const VkExtent3D& denoiseExtent = inputs.normal_roughness->image->info().extent;
+
+    prepareResources(ctx, rtOutput, denoiseExtent);
 
-    updateNRDSettings(sceneManager, inputs, rtOutput);
+    updateNRDSettings(sceneManager, inputs, rtOutput, denoiseExtent);
 
     std::vector<Rc<DxvkImageView>> pInputs, pOutputs;
     if (m_settings.m_denoiserDesc.denoiser == nrd::Denoiser::REFERENCE) {
@@ -836,7 +841,8 @@ namespace dxvk {
   void NRDContext::updateNRDSettings(
     const SceneManager& sceneManager,
     const DxvkDenoise::Input& inputs,
-    const Resources::RaytracingOutput& rtOutput) {
+    const Resources::RaytracingOutput& rtOutput,
+    const VkExtent3D& denoiseExtent) {
 
     if (m_settings.m_denoiserDesc.denoiser != nrd::Denoiser::REFERENCE) {
       // Don't allow adaptive scaling for direct light in ReBlur
@@ -854,8 +860,8 @@ namespace dxvk {
     {
       const auto& camera = sceneManager.getCamera();
 
-      const uint16_t width = static_cast<uint16_t>(rtOutput.m_compositeOutputExtent.width);
-      const uint16_t height = static_cast<uint16_t>(rtOutput.m_compositeOutputExtent.height);
+      const uint16_t width = static_cast<uint16_t>(denoiseExtent.width);
+      const uint16_t height = static_cast<uint16_t>(denoiseExtent.height);
 
       m_settings.m_commonSettings.resourceSizePrev[0] = width;
       m_settings.m_commonSettings.resourceSizePrev[1] = height;
@@ -900,8 +906,9 @@ namespace dxvk {
       commonSettings.motionVectorScale[2] = commonSettings.motionVectorScale[1]; // Enable 2.5D Motion Vector in NRD, we use the scale that matches previous default NRD scale on Z (mv = mv.xyz * mvScale.xyy)
       commonSettings.cameraJitterPrev[0] = commonSettings.cameraJitter[0];
       commonSettings.cameraJitterPrev[1] = commonSettings.cameraJitter[1];
-      commonSettings.cameraJitter[0] = jitterVec[0] / static_cast<float>(width);
-      commonSettings.cameraJitter[1] = jitterVec[1] / static_cast<float>(height);
+      // Note: Jitter is given in render resolution pixels, normalize it by the render resolution so it stays the same when denoising at a lower resolution
+      commonSettings.cameraJitter[0] = jitterVec[0] / static_cast<float>(rtOutput.m_compositeOutputExtent.width);
+      commonSettings.cameraJitter[1] = jitterVec[1] / static_cast<float>(rtOutput.m_compositeOutputExtent.height);
       // Note: timeDeltaBetweenFrames is in milliseconds, as specified by NRD. If set to 0, NRD will track the time itself.
       commonSettings.timeDeltaBetweenFrames = m_settings.m_groupedSettings.timeDeltaBetweenFrames != 0 
         ? m_settings.m_groupedSettings.timeDeltaBetweenFrames : inputs.frameTimeMs;
@@ -63,7 +63,8 @@ namespace dxvk {
 
     void prepareResources(
       Rc<DxvkContext> ctx,
-      const Resources::RaytracingOutput& rtOutput);
+      const Resources::RaytracingOutput& rtOutput,
+      const VkExtent3D& denoiseExtent);
 
     void createResources(Rc<DxvkContext> ctx, const Resources::RaytracingOutput& rtOutput);
     void createPipelines();
@@ -79,7 +80,8 @@ namespace dxvk {
     void updateNRDSettings(
       const SceneManager& sceneManager,
       const DxvkDenoise::Input& inputs,
-      const Resources::RaytracingOutput& rtOutput);
+      const Resources::RaytracingOutput& rtOutput,
+      const VkExtent3D& denoiseExtent);
 
     void updateAdaptiveScaling(const VkExtent3D& renderSize);
     
@@ -30,9 +30,12 @@
 #include "rtx_texture_manager.h"
 
 #include "rtx_imgui.h"
+#include "../../util/util_filesys.h"
 
 #include "rtx/pass/common_binding_indices.h"
 
+#include <fstream>
+
 // #define VALIDATION_MODE
 
 #ifdef VALIDATION_MODE
@@ -180,6 +183,14 @@ namespace dxvk {
       m_budget = std::min(m_vidmemFreeSize - std::min(softMinFreeVidmemToNotAllocate, m_vidmemFreeSize) + static_cast<VkDeviceSize>(m_used), maxBudget);
     }
 
+    // Give up what the VRAM budget broker reclaimed and don't grow back into it while the broker holds OMMs back
+    if (m_sizeToReclaim > 0) {
+      m_budget = std::min(m_budget, m_used - std::min(m_sizeToReclaim, m_used));
+      m_sizeToReclaim = 0;
+    } else if (!m_device->getCommon()->getVramBudgetBroker().canGrow(VramBudgetBroker::Consumer::OpacityMicromaps)) {
+      m_budget = std::min(m_budget, m_prevBudget);
+    }
+
     if (m_budget < static_cast<VkDeviceSize>(OpacityMicromapOptions::Cache::minBudgetSizeMB()) * 1024 * 1024) {
       m_budget = 0;
     }
@@ -215,6 +226,13 @@ namespace dxvk {
     release(m_used);
   }
 
+  VkDeviceSize OpacityMicromapMemoryManager::reclaim(VkDeviceSize size) {
+    const VkDeviceSize reclaimableSize = m_used - std::min(m_sizeToReclaim, m_used);
+    const VkDeviceSize sizeToReclaim = std::min(size, reclaimableSize);
+    m_sizeToReclaim += sizeToReclaim;
+    return sizeToReclaim;
+  }
+
   VkDeviceSize OpacityMicromapMemoryManager::getPrevBudget() const {
     return m_prevBudget;
   }
@@ -239,6 +257,139 @@ namespace dxvk {
     return m_pendingReleaseSize.back();
   }
 
+  void OpacityMicromapDiskCache::initialize() {
+    if (m_isInitialized) {
+      return;
+    }
+
+    m_isInitialized = true;
+    m_directory = util::RtxFileSys::path(util::RtxFileSys::Cache) / "omm";
+
+    std::error_code ec;
+    util::RtxFileSys::mkDirs(m_directory);
+
+    // Only the file names are read upfront, the contents are validated when an array is loaded
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+      if (!entry.is_regular_file(ec) || entry.path().extension() != ".omm") {
+        continue;
+      }
+
+      const std::string stem = entry.path().stem().string();
+      char* end = nullptr;
+      const XXH64_hash_t ommSrcHash = std::strtoull(stem.c_str(), &end, 16);
+
+      if (end != stem.c_str() && *end == '\0') {
+        m_cachedHashes.insert(ommSrcHash);
+      }
+    }
+
+    Logger::info(str::format("[RTX Opacity Micromap] Found ", m_cachedHashes.size(), " arrays in the disk cache at ", m_directory.string()));
+  }
+
+  std::filesystem::path OpacityMicromapDiskCache::getFilePath(XXH64_hash_t ommSrcHash) const {
+    return m_directory / (hashToString(ommSrcHash) + ".omm");
+  }
+
+  bool OpacityMicromapDiskCache::contains(XXH64_hash_t ommSrcHash) {
+    initialize();
+
+    return m_cachedHashes.find(ommSrcHash) != m_cachedHashes.end();
+  }
+
+  bool OpacityMicromapDiskCache::load(XXH64_hash_t ommSrcHash, const ArrayDesc& desc, std::vector<uint8_t>& data) {
+    ScopedCpuProfileZone();
+
+    if (!contains(ommSrcHash)) {
+      return false;
+    }
+
+    std::ifstream file(getFilePath(ommSrcHash), std::ios::binary);
+    FileHeader header;
+
+    const bool isValid =
+      file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+      header.magic == kMagic &&
+      header.version == kVersion &&
+      memcmp(&header.desc, &desc, sizeof(desc)) == 0;
+
+    if (isValid) {
+      data.resize(header.dataSize);
+
+      if (file.read(reinterpret_cast<char*>(data.data()), header.dataSize)) {
+        return true;
+      }
+    }
+
+    // Stale or corrupt, the array will be baked and written out again
+    m_cachedHashes.erase(ommSrcHash);
+    return false;
+  }
+
+  void OpacityMicromapDiskCache::store(Rc<DxvkContext> ctx, XXH64_hash_t ommSrcHash, const ArrayDesc& desc, const Rc<DxvkBuffer>& ommArrayBuffer, VkDeviceSize size) {
+    initialize();
+
+    DxvkBufferCreateInfo readbackBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    readbackBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    readbackBufferInfo.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    readbackBufferInfo.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    readbackBufferInfo.size = size;
+
+    Rc<DxvkBuffer> readbackBuffer = ctx->getDevice()->createBuffer(readbackBufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, DxvkMemoryStats::Category::RTXBuffer, "OMM disk cache readback buffer");
+
+    if (readbackBuffer == nullptr) {
+      return;
+    }
+
+    // The array was last written by the baking compute shader
+    ctx->emitMemoryBarrier(0,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_WRITE_BIT,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_READ_BIT);
+
+    ctx->copyBuffer(readbackBuffer, 0, ommArrayBuffer, 0, size);
+
+    ctx->emitMemoryBarrier(0,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      VK_ACCESS_HOST_READ_BIT);
+
+    m_pendingWrites.push_back(PendingWrite { ommSrcHash, desc, readbackBuffer, size });
+  }
+
+  void OpacityMicromapDiskCache::onFrameEnd() {
+    ScopedCpuProfileZone();
+
+    int numWrites = 0;
+
+    for (auto iter = m_pendingWrites.begin(); iter != m_pendingWrites.end() && numWrites < OpacityMicromapOptions::DiskCache::maxWritesPerFrame(); ) {
+      // Readbacks complete in submission order, so later ones won't be done either
+      if (iter->readbackBuffer->isInUse()) {
+        break;
+      }
+
+      FileHeader header;
+      header.magic = kMagic;
+      header.version = kVersion;
+      header.desc = iter->desc;
+      header.dataSize = iter->size;
+
+      std::ofstream file(getFilePath(iter->ommSrcHash), std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(iter->readbackBuffer->mapPtr(0)), iter->size);
+
+      if (file) {
+        m_cachedHashes.insert(iter->ommSrcHash);
+      } else {
+        ONCE(Logger::warn(str::format("[RTX Opacity Micromap] Failed to write to the disk cache at ", m_directory.string())));
+      }
+
+      iter = m_pendingWrites.erase(iter);
+      numWrites++;
+    }
+  }
+
   Rc<DxvkBuffer> OpacityMicromapManager::getScratchMemory(const size_t requiredScratchAllocSize) {
     if (m_scratchBuffer == nullptr || m_scratchBuffer->info().size < requiredScratchAllocSize) {
       DxvkBufferCreateInfo bufferCreateInfo {};
@@ -255,9 +406,16 @@ namespace dxvk {
   OpacityMicromapManager::OpacityMicromapManager(DxvkDevice* device)
     : CommonDeviceObject(device)
     , m_memoryManager(device) {
+    // OMMs only speed up tracing and can be rebuilt, so they are the first to give up memory
+    VramBudgetBroker::ConsumerDesc vramBudgetConsumer;
+    vramBudgetConsumer.priority = 0;
+    vramBudgetConsumer.reclaim = [this](VkDeviceSize size) { return m_memoryManager.reclaim(size); };
+    device->getCommon()->getVramBudgetBroker().registerConsumer(VramBudgetBroker::Consumer::OpacityMicromaps, vramBudgetConsumer);
   }
 
   OpacityMicromapManager::~OpacityMicromapManager() { 
+    m_device->getCommon()->getVramBudgetBroker().unregisterConsumer(VramBudgetBroker::Consumer::OpacityMicromaps);
+
 #ifdef VALIDATION_MODE
     // Delink instances so that the assert on cache data destruction doesn't trigger
     for (auto& sourceData : m_cachedSourceData) {
@@ -1650,6 +1808,114 @@ namespace dxvk {
     return numTexelsPerMicroTriangleCalculationData->status;
   }
 
+  uint32_t OpacityMicromapManager::calculateOpacityMicromapArraySize(const OpacityMicromapCacheItem& ommCacheItem) {
+    const uint32_t numMicroTrianglesPerTriangle = calculateNumMicroTriangles(ommCacheItem.subdivisionLevel);
+    const uint8_t numOpacityMicromapBitsPerMicroTriangle = ommCacheItem.ommFormat == VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT ? 1 : 2;
+    const uint32_t opacityMicromapPerTriangleBufferSize = dxvk::util::ceilDivide(numMicroTrianglesPerTriangle * numOpacityMicromapBitsPerMicroTriangle, 8);
+    return ommCacheItem.numTriangles * opacityMicromapPerTriangleBufferSize;
+  }
+
+  OpacityMicromapManager::OmmResult OpacityMicromapManager::allocateOpacityMicromapArray(OpacityMicromapCacheItem& ommCacheItem) {
+    const uint32_t numTriangles = ommCacheItem.numTriangles;
+    const uint32_t opacityMicromapBufferSize = calculateOpacityMicromapArraySize(ommCacheItem);
+
+    // Preallocate all the device memory needed to build the OMM item
+    if (ommCacheItem.getDeviceSize() == 0)
+    {
+      VkDeviceSize arrayBufferDeviceSize;
+      VkDeviceSize blasOmmBuffersDeviceSize;
+
+      const VkIndexType triangleIndexType = numTriangles <= UINT16_MAX ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+      calculateRequiredVRamSize(numTriangles, ommCacheItem.subdivisionLevel, ommCacheItem.ommFormat, triangleIndexType,
+                                arrayBufferDeviceSize, blasOmmBuffersDeviceSize);
+
+      VkDeviceSize requiredDeviceSize = arrayBufferDeviceSize + blasOmmBuffersDeviceSize;
+
+      if (!m_memoryManager.allocate(requiredDeviceSize)) {
+        m_amountOfMemoryMissing += requiredDeviceSize;
+        return OmmResult::OutOfMemory;
+      }
+
+      ommCacheItem.arrayBufferDeviceSize = arrayBufferDeviceSize;
+      ommCacheItem.blasOmmBuffersDeviceSize = blasOmmBuffersDeviceSize;
+    }
+
+    // Create micromap buffer
+    if (!ommCacheItem.ommArrayBuffer.ptr())
+    {
+      DxvkBufferCreateInfo ommBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+      // Transfer usage is for arrays read back to or loaded from the disk cache
+      ommBufferInfo.usage = VK_BUFFER_USAGE_MICROMAP_BUILD_INPUT_READ_ONLY_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+      ommBufferInfo.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+      ommBufferInfo.access = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      ommBufferInfo.size = opacityMicromapBufferSize;
+      ommBufferInfo.requiredAlignmentOverride = 256;
+      ommCacheItem.ommArrayBuffer = m_device->createBuffer(ommBufferInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXOpacityMicromap, "OMM micromap buffer");
+
+      if (ommCacheItem.ommArrayBuffer == nullptr) {
+        ONCE(Logger::warn(str::format("[RTX - Opacity Micromap] Failed to allocate OMM array buffer due to m_device->createBuffer() failing to allocate a buffer for size: ", ommBufferInfo.size)));
+        return OmmResult::OutOfMemory;
+      }
+    }
+
+    return OmmResult::Success;
+  }
+
+  bool OpacityMicromapManager::usesDiskCache(const CachedSourceData& sourceData) {
+    // Instance index based hashes are not stable across runs, and billboard OMMs are too short lived to be worth persisting
+    return OpacityMicromapOptions::DiskCache::enable() &&
+           !OpacityMicromapOptions::Cache::hashInstanceIndexOnly() &&
+           sourceData.getInstance() &&
+           !usesSplitBillboardOpacityMicromap(*sourceData.getInstance());
+  }
+
+  OpacityMicromapDiskCache::ArrayDesc OpacityMicromapManager::getDiskCacheArrayDesc(const OpacityMicromapCacheItem& ommCacheItem) {
+    OpacityMicromapDiskCache::ArrayDesc desc;
+    desc.numTriangles = ommCacheItem.numTriangles;
+    desc.subdivisionLevel = ommCacheItem.subdivisionLevel;
+    desc.ommFormat = ommCacheItem.ommFormat;
+    desc.useVertexAndTextureOperations = ommCacheItem.useVertexAndTextureOperations;
+    desc.useConservativeEstimation = OpacityMicromapOptions::Building::ConservativeEstimation::enable();
+    desc.conservativeEstimationMaxTexelTapsPerMicroTriangle = OpacityMicromapOptions::Building::ConservativeEstimation::maxTexelTapsPerMicroTriangle();
+    desc.resolveTransparencyThreshold = RtxOptions::resolveTransparencyThreshold();
+    desc.resolveOpaquenessThreshold = RtxOptions::resolveOpaquenessThreshold();
+    desc.decalsMinResolveTransparencyThreshold = OpacityMicromapOptions::Building::decalsMinResolveTransparencyThreshold();
+    desc.costPerTexelTapPerMicroTriangleBudget = OpacityMicromapOptions::Building::costPerTexelTapPerMicroTriangleBudget();
+    return desc;
+  }
+
+  OpacityMicromapManager::OmmResult OpacityMicromapManager::loadOpacityMicromapArray(
+    Rc<DxvkContext> ctx,
+    XXH64_hash_t ommSrcHash,
+    OpacityMicromapCacheItem& ommCacheItem) {
+    ScopedCpuProfileZone();
+
+    // Allocate before loading so that the file isn't read only to find out there's no memory for it
+    const OmmResult allocationResult = allocateOpacityMicromapArray(ommCacheItem);
+    if (allocationResult != OmmResult::Success) {
+      return allocationResult;
+    }
+
+    std::vector<uint8_t> data;
+    if (!m_diskCache.load(ommSrcHash, getDiskCacheArrayDesc(ommCacheItem), data) ||
+        data.size() != calculateOpacityMicromapArraySize(ommCacheItem)) {
+      return OmmResult::Failure;
+    }
+
+    ctx->writeToBuffer(ommCacheItem.ommArrayBuffer, 0, data.size(), data.data());
+    ctx->getCommandList()->trackResource<DxvkAccess::Write>(ommCacheItem.ommArrayBuffer);
+
+    const uint32_t numMicroTriangles = ommCacheItem.numTriangles * calculateNumMicroTriangles(ommCacheItem.subdivisionLevel);
+    ommCacheItem.bakingState.initialized = true;
+    ommCacheItem.bakingState.numTriangles = ommCacheItem.numTriangles;
+    ommCacheItem.bakingState.numMicroTrianglesToBake = numMicroTriangles;
+    ommCacheItem.bakingState.numMicroTrianglesBaked = numMicroTriangles;
+    ommCacheItem.bakingState.numMicroTrianglesBakedInLastBake = 0;
+
+    return OmmResult::Success;
+  }
+
   OpacityMicromapManager::OmmResult OpacityMicromapManager::bakeOpacityMicromapArray(
     Rc<DxvkContext> ctx,
     XXH64_hash_t ommSrcHash,
@@ -1684,50 +1950,15 @@ namespace dxvk {
     const uint32_t numTriangles = sourceData.numTriangles;
     const uint32_t numMicroTrianglesPerTriangle = calculateNumMicroTriangles(ommCacheItem.subdivisionLevel);
     const uint32_t numMicroTriangles = numTriangles * numMicroTrianglesPerTriangle;
-    const uint8_t numOpacityMicromapBitsPerMicroTriangle = ommCacheItem.ommFormat == VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT ? 1 : 2;
-    const uint32_t opacityMicromapPerTriangleBufferSize = dxvk::util::ceilDivide(numMicroTrianglesPerTriangle * numOpacityMicromapBitsPerMicroTriangle, 8);
-    const uint32_t opacityMicromapBufferSize = numTriangles * opacityMicromapPerTriangleBufferSize;
 
     omm_validation_assert((usesSplitBillboardOpacityMicromap(instance) || numTriangles == instance.getBlas()->input.getGeometryData().calculatePrimitiveCount()) &&
                           instance.getBlas()->input.getGeometryData().calculatePrimitiveCount() ==
                           instance.getBlas()->modifiedGeometryData.calculatePrimitiveCount() &&
                           "Number of triangles must match and be consistent");
 
-    // Preallocate all the device memory needed to build the OMM item
-    if (ommCacheItem.getDeviceSize() == 0)
-    {
-      VkDeviceSize arrayBufferDeviceSize;
-      VkDeviceSize blasOmmBuffersDeviceSize;
-
-      const VkIndexType triangleIndexType = numTriangles <= UINT16_MAX ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
-      calculateRequiredVRamSize(numTriangles, ommCacheItem.subdivisionLevel, ommCacheItem.ommFormat, triangleIndexType,
-                                arrayBufferDeviceSize, blasOmmBuffersDeviceSize);
-
-      VkDeviceSize requiredDeviceSize = arrayBufferDeviceSize + blasOmmBuffersDeviceSize;
-
-      if (!m_memoryManager.allocate(requiredDeviceSize)) {
-        m_amountOfMemoryMissing += requiredDeviceSize;
-        return OmmResult::OutOfMemory;
-      }
-
-      ommCacheItem.arrayBufferDeviceSize = arrayBufferDeviceSize;
-      ommCacheItem.blasOmmBuffersDeviceSize = blasOmmBuffersDeviceSize;
-    }
-
-    // Create micromap buffer
-    if (!ommCacheItem.ommArrayBuffer.ptr())
-    {
-      DxvkBufferCreateInfo ommBufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-      ommBufferInfo.usage = VK_BUFFER_USAGE_MICROMAP_BUILD_INPUT_READ_ONLY_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-      ommBufferInfo.access = VK_ACCESS_SHADER_WRITE_BIT;
-      ommBufferInfo.size = opacityMicromapBufferSize;
-      ommBufferInfo.requiredAlignmentOverride = 256;
-      ommCacheItem.ommArrayBuffer = m_device->createBuffer(ommBufferInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXOpacityMicromap, "OMM micromap buffer");
-
-      if (ommCacheItem.ommArrayBuffer == nullptr) {
-        ONCE(Logger::warn(str::format("[RTX - Opacity Micromap] Failed to allocate OMM array buffer due to m_device->createBuffer() failing to allocate a buffer for size: ", ommBufferInfo.size)));
-        return OmmResult::OutOfMemory;
-      }
+    const OmmResult allocationResult = allocateOpacityMicromapArray(ommCacheItem);
+    if (allocationResult != OmmResult::Success) {
+      return allocationResult;
     }
 
     // Generate OMM array
@@ -1986,12 +2217,28 @@ namespace dxvk {
       OpacityMicromapCacheItem& ommCacheItem = cacheItemIter->second;
       ommCacheItem.cacheState = OpacityMicromapCacheState::eStep1_Baking;
 
-      OmmResult result = bakeOpacityMicromapArray(ctx, ommSrcHash, ommCacheItem, sourceData, textures, availableBakingBudget);
+      const bool usesDiskCache = this->usesDiskCache(sourceData);
+      bool isLoadedFromDiskCache = false;
+      OmmResult result = OmmResult::Failure;
+
+      // Arrays that have started baking are finished off by baking rather than loading
+      if (usesDiskCache && !ommCacheItem.bakingState.initialized && m_diskCache.contains(ommSrcHash)) {
+        result = loadOpacityMicromapArray(ctx, ommSrcHash, ommCacheItem);
+        isLoadedFromDiskCache = result == OmmResult::Success;
+      }
+
+      if (!isLoadedFromDiskCache && result != OmmResult::OutOfMemory) {
+        result = bakeOpacityMicromapArray(ctx, ommSrcHash, ommCacheItem, sourceData, textures, availableBakingBudget);
+      }
 
       if (result == OmmResult::Success) {
         // Use >= as the number of baked micro triangles is aligned up
         if (ommCacheItem.bakingState.numMicroTrianglesBaked >= ommCacheItem.bakingState.numMicroTrianglesToBake) {
 
+          if (usesDiskCache && !isLoadedFromDiskCache) {
+            m_diskCache.store(ctx, ommSrcHash, getDiskCacheArrayDesc(ommCacheItem), ommCacheItem.ommArrayBuffer, calculateOpacityMicromapArraySize(ommCacheItem));
+          }
+
           // Unlink the referenced RtInstance
           sourceData.setInstance(nullptr, m_instanceOmmRequests, *this);
 
@@ -2284,6 +2531,8 @@ namespace dxvk {
     // Register amount of free vidmem at the end of the frame to account for any intra-frame allocations.
     // This will be then used next frame to adjust budgeting
     m_memoryManager.registerVidmemFreeSize();
+
+    m_diskCache.onFrameEnd();
   }
   
   void OpacityMicromapManager::onFinishedBuilding() {
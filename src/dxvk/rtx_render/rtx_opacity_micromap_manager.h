@@ -30,6 +30,8 @@
 #include <vector>
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
 
 namespace dxvk {
   class DxvkContext;
@@ -49,6 +51,15 @@ namespace dxvk {
     RTX_OPTION("rtx.opacityMicromap", bool, enableBuilding, true, "Enables building of Opacity Micromap arrays.");
     RTX_OPTION("rtx.opacityMicromap", bool, enableResetEveryFrame, false, "Debug: resets Opacity Micromap runtime data every frame. ");
 
+    struct DiskCache {
+      friend class OpacityMicromapManager;
+      friend class OpacityMicromapDiskCache;
+
+      RTX_OPTION("rtx.opacityMicromap.diskCache", bool, enable, false,
+                 "Stores baked Opacity Micromap arrays in the \"omm\" subdirectory of the Remix cache directory and loads them instead of baking them again in later runs.\n"
+                 "Cached arrays are only used when the baking settings they were baked with match the current ones.");
+      RTX_OPTION("rtx.opacityMicromap.diskCache", int, maxWritesPerFrame, 16, "Max number of baked Opacity Micromap arrays to write to the disk cache per frame.");
+    };
 
     struct Cache {
       friend class OpacityMicromapManager;
@@ -316,6 +327,8 @@ namespace dxvk {
     VkDeviceSize getAvailable() const;
     void release(VkDeviceSize size);
     void releaseAll();
+    // Gives up budget on VRAM budget broker's request, the budget is lowered on the next updateMemoryBudget()
+    VkDeviceSize reclaim(VkDeviceSize size);
 
     VkDeviceSize getBudget() const { return m_budget; }
     VkDeviceSize getPrevBudget() const;
@@ -331,6 +344,7 @@ namespace dxvk {
     VkDeviceSize m_budget = 0;
     VkDeviceSize m_prevBudget = 0;
     VkDeviceSize m_vidmemFreeSize = kInvalidDeviceSize;
+    VkDeviceSize m_sizeToReclaim = 0;
 
     VkPhysicalDeviceMemoryProperties  m_memoryProperties;
 
@@ -339,6 +353,62 @@ namespace dxvk {
     std::list<VkDeviceSize> m_pendingReleaseSize;
   };
 
+  // Persists baked Opacity Micromap arrays across runs, keyed by their OMM source hash.
+  // Arrays are read back from the GPU once baking completes and written
+  // to disk on the render thread a few frames later, when the readback is done.
+  class OpacityMicromapDiskCache {
+  public:
+    // Parameters a baked array depends on besides its source hash
+    // Ensure the struct is fully padded and default initialized
+    struct ArrayDesc {
+      uint32_t numTriangles = 0;
+      uint32_t subdivisionLevel = 0;
+      VkOpacityMicromapFormatEXT ommFormat = VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT;
+      uint32_t useVertexAndTextureOperations = 0;
+      uint32_t useConservativeEstimation = 0;
+      uint32_t conservativeEstimationMaxTexelTapsPerMicroTriangle = 0;
+      float resolveTransparencyThreshold = 0.f;
+      float resolveOpaquenessThreshold = 0.f;
+      float decalsMinResolveTransparencyThreshold = 0.f;
+      float costPerTexelTapPerMicroTriangleBudget = 0.f;
+    };
+
+    static_assert(sizeof(ArrayDesc) == 40);
+
+    bool contains(XXH64_hash_t ommSrcHash);
+    // Returns the baked array, or false if it isn't cached or was baked with different parameters
+    bool load(XXH64_hash_t ommSrcHash, const ArrayDesc& desc, std::vector<uint8_t>& data);
+    // Records a readback of a fully baked array, it is written to disk in a later onFrameEnd()
+    void store(Rc<DxvkContext> ctx, XXH64_hash_t ommSrcHash, const ArrayDesc& desc, const Rc<DxvkBuffer>& ommArrayBuffer, VkDeviceSize size);
+    void onFrameEnd();
+
+  private:
+    struct FileHeader {
+      uint32_t magic = 0;
+      uint32_t version = 0;
+      ArrayDesc desc;
+      uint64_t dataSize = 0;
+    };
+
+    struct PendingWrite {
+      XXH64_hash_t ommSrcHash;
+      ArrayDesc desc;
+      Rc<DxvkBuffer> readbackBuffer;
+      VkDeviceSize size;
+    };
+
+    static constexpr uint32_t kMagic = 0x434d4d4f; // "OMMC"
+    static constexpr uint32_t kVersion = 1;
+
+    void initialize();
+    std::filesystem::path getFilePath(XXH64_hash_t ommSrcHash) const;
+
+    bool m_isInitialized = false;
+    std::filesystem::path m_directory;
+    std::unordered_set<XXH64_hash_t> m_cachedHashes;
+    std::list<PendingWrite> m_pendingWrites;
+  };
+
   // Data stored in RtInstances for quick lookups
   class OpacityMicromapInstanceData {
     friend class OpacityMicromapManager;
@@ -509,6 +579,11 @@ namespace dxvk {
 
     void calculateRequiredVRamSize(uint32_t numTriangles, uint16_t subdivisionLevel, VkOpacityMicromapFormatEXT ommFormat, VkIndexType triangleIndexType, VkDeviceSize& arrayBufferDeviceSize, VkDeviceSize& blasOmmBuffersDeviceSize);
 
+    static uint32_t calculateOpacityMicromapArraySize(const OpacityMicromapCacheItem& ommCacheItem);
+    OmmResult allocateOpacityMicromapArray(OpacityMicromapCacheItem& ommCacheItem);
+    static bool usesDiskCache(const CachedSourceData& sourceData);
+    static OpacityMicromapDiskCache::ArrayDesc getDiskCacheArrayDesc(const OpacityMicromapCacheItem& ommCacheItem);
+    OmmResult loadOpacityMicromapArray(Rc<DxvkContext> ctx, XXH64_hash_t ommSrcHash, OpacityMicromapCacheItem& ommCacheItem);
     OmmResult bakeOpacityMicromapArray(Rc<DxvkContext> ctx, XXH64_hash_t ommSrcHash,
                                   OpacityMicromapCacheItem& ommCacheItem, CachedSourceData& sourceData,
                                   const std::vector<TextureRef>& textures, uint32_t& availableBakingBudget);
@@ -552,6 +627,7 @@ namespace dxvk {
 
     VkDeviceSize m_amountOfMemoryMissing = 0;    // Records how much memory was missing in a frame
     OpacityMicromapMemoryManager m_memoryManager;
+    OpacityMicromapDiskCache m_diskCache;
     bool m_hasEnoughMemoryToPotentiallyGenerateAnOmm = true; // A quick check to avoid unnecessary computations when there's not enough free budget to handle more OMMs
     Rc<DxvkBuffer> m_scratchBuffer;
     size_t m_scratchMemoryUsedThisFrame = 0;
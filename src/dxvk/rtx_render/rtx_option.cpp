@@ -25,18 +25,74 @@ namespace dxvk {
   Config RtxOptionImpl::s_startupOptions;
   Config RtxOptionImpl::s_customOptions;
 
-  void fillHashTable(const std::vector<std::string>& rawInput, fast_unordered_set& hashTableOutput) {
-    for (auto&& hashStr : rawInput) {
-      const XXH64_hash_t h = std::stoull(hashStr, nullptr, 16);
-      hashTableOutput.insert(h);
+  int hexDigitValue(const char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
     }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
   }
 
-  void fillHashVector(const std::vector<std::string>& rawInput, std::vector<XXH64_hash_t>& hashVectorOutput) {
-    for (auto&& hashStr : rawInput) {
-      const XXH64_hash_t h = std::stoull(hashStr, nullptr, 16);
-      hashVectorOutput.emplace_back(h);
+  bool isHashListWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  // Parses a comma separated list of 64 bit hex hashes (0x prefix optional) straight from the raw option string.
+  // Hash lists can hold thousands of entries, so this avoids splitting the list into strings before converting them.
+  // Malformed entries are skipped with a warning. Returns the number of entries in the list.
+  template<typename OnHash>
+  size_t parseHashList(const std::string& optionName, const std::string& rawInput, const OnHash& onHash) {
+    const char* cursor = rawInput.data();
+    const char* const end = cursor + rawInput.size();
+    size_t count = 0;
+
+    while (cursor < end) {
+      const char* const entryEnd = std::find(cursor, end, ',');
+      const char* const entryStart = cursor;
+
+      while (cursor < entryEnd && isHashListWhitespace(*cursor)) {
+        ++cursor;
+      }
+      if (entryEnd - cursor >= 2 && cursor[0] == '0' && (cursor[1] == 'x' || cursor[1] == 'X')) {
+        cursor += 2;
+      }
+
+      XXH64_hash_t hash = 0;
+      uint32_t numDigits = 0;
+      for (int digit; cursor < entryEnd && (digit = hexDigitValue(*cursor)) >= 0; ++cursor) {
+        hash = (hash << 4) | XXH64_hash_t(digit);
+        ++numDigits;
+      }
+      while (cursor < entryEnd && isHashListWhitespace(*cursor)) {
+        ++cursor;
+      }
+
+      if (numDigits > 0 && numDigits <= 16 && cursor == entryEnd) {
+        onHash(hash);
+        ++count;
+      } else if (numDigits > 0 || cursor != entryEnd) {
+        Logger::warn(str::format("Ignoring malformed hash '", std::string(entryStart, entryEnd), "' in ", optionName, "."));
+      }
+
+      cursor = entryEnd + 1;
     }
+
+    return count;
+  }
+
+  void fillHashTable(const std::string& optionName, const std::string& rawInput, fast_unordered_set& hashTableOutput) {
+    hashTableOutput.reserve(hashTableOutput.size() + std::count(rawInput.begin(), rawInput.end(), ',') + 1);
+    parseHashList(optionName, rawInput, [&hashTableOutput](const XXH64_hash_t hash) { hashTableOutput.insert(hash); });
+  }
+
+  void fillHashVector(const std::string& optionName, const std::string& rawInput, std::vector<XXH64_hash_t>& hashVectorOutput) {
+    hashVectorOutput.reserve(hashVectorOutput.size() + std::count(rawInput.begin(), rawInput.end(), ',') + 1);
+    parseHashList(optionName, rawInput, [&hashVectorOutput](const XXH64_hash_t hash) { hashVectorOutput.emplace_back(hash); });
   }
 
   void fillIntVector(const std::vector<std::string>& rawInput, std::vector<int32_t>& intVectorOutput) {
@@ -181,12 +237,6 @@ namespace dxvk {
     }
   }
 
-  void RtxOptionImpl::invokeOnChangeCallback() const {
-    if (onChangeCallback) {
-      onChangeCallback();
-    }
-  }
-
   void RtxOptionImpl::readOption(const Config& options, RtxOptionImpl::ValueType valueType) {
     std::string fullName = getFullName();
     const char* env = environment == nullptr || strlen(environment) == 0 ? nullptr : environment;
@@ -203,10 +253,10 @@ namespace dxvk {
       value.f = options.getOption<float>(fullName.c_str(), value.f, env);
       break;
     case OptionType::HashSet:
-      fillHashTable(options.getOption<std::vector<std::string>>(fullName.c_str()), *value.hashSet);
+      fillHashTable(fullName, options.getOption<std::string>(fullName.c_str()), *value.hashSet);
       break;
     case OptionType::HashVector:
-      fillHashVector(options.getOption<std::vector<std::string>>(fullName.c_str()), *value.hashVector);
+      fillHashVector(fullName, options.getOption<std::string>(fullName.c_str()), *value.hashVector);
       break;
     case OptionType::IntVector:
       fillIntVector(options.getOption<std::vector<std::string>>(fullName.c_str()), *value.intVector);
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <unordered_set>
 #include <cassert>
 #include <limits>
@@ -96,7 +97,8 @@ namespace dxvk {
     OptionType type;
     GenericValue valueList[(int)ValueType::Count];
     uint32_t flags = 0;
-    std::function<void()> onChangeCallback;
+    typedef void (*OnChangeCallback)();
+    OnChangeCallback onChangeCallback = nullptr;
 
     RtxOptionImpl(XXH64_hash_t hash, const char* optionName, const char* optionCategory, OptionType optionType, const char* optionDescription) :
       hash(hash),
@@ -127,7 +129,7 @@ namespace dxvk {
       getDirtyRtxOptionMap()[hash] = this;
     }
 
-    void invokeOnChangeCallback() const;
+    OnChangeCallback getOnChangeCallback() const { return onChangeCallback; }
 
     static std::string getFullName(const std::string& category, const std::string& name) {
       return category + "." + name;
@@ -154,6 +156,11 @@ namespace dxvk {
 
     // Mutex to prevent race conditions when clearing dirty RtxOptions
     inline static std::mutex s_updateMutex;
+
+    // Incremented whenever applyPendingValues() promotes a hash set option, so that tables derived from them can tell when to rebuild
+    inline static std::atomic<uint32_t> s_hashSetGeneration = 0;
+
+    static uint32_t getHashSetGeneration() { return s_hashSetGeneration.load(std::memory_order_acquire); }
   };
 
   template <typename T>
@@ -299,20 +306,30 @@ namespace dxvk {
       
       auto& dirtyOptions = RtxOptionImpl::getDirtyRtxOptionMap();
       // Need a second array so that we can invoke onChange callbacks after updating values and clearing the dirty list.
-      std::vector<RtxOptionImpl*> dirtyOptionsVector;
-      dirtyOptionsVector.reserve(dirtyOptions.size());
+      // Options commonly share an onChange callback (e.g. everything a preset changes may require the same reconfiguration),
+      // so each callback is only invoked once per call no matter how many of its options changed.
+      std::vector<RtxOptionImpl::OnChangeCallback> onChangeCallbacks;
+      bool hashSetChanged = false;
       {
         for (auto& rtxOption : dirtyOptions) {
           rtxOption.second->copyValue(RtxOptionImpl::ValueType::PendingValue, RtxOptionImpl::ValueType::Value);
-          dirtyOptionsVector.push_back(rtxOption.second);
+          hashSetChanged |= rtxOption.second->type == OptionType::HashSet;
+
+          const RtxOptionImpl::OnChangeCallback callback = rtxOption.second->getOnChangeCallback();
+          if (callback != nullptr && std::find(onChangeCallbacks.begin(), onChangeCallbacks.end(), callback) == onChangeCallbacks.end()) {
+            onChangeCallbacks.push_back(callback);
+          }
         }
       }
       dirtyOptions.clear();
+      if (hashSetChanged) {
+        RtxOptionImpl::s_hashSetGeneration.fetch_add(1, std::memory_order_release);
+      }
       lock.unlock();
 
       // Invoke onChange callbacks after promoting all the values, so that newly set values will be updated at the end of the next frame
-      for (RtxOptionImpl* rtxOption : dirtyOptionsVector) {
-        rtxOption->invokeOnChangeCallback();
+      for (RtxOptionImpl::OnChangeCallback callback : onChangeCallbacks) {
+        callback();
       }
     }
 
@@ -414,6 +414,7 @@ namespace dxvk {
       rtxdiRayQuery.enableRayTracedBiasCorrection.setDeferred(true);
       restirGiRayQuery.biasCorrectionMode.setDeferred(ReSTIRGIBiasCorrection::PairwiseRaytrace);
       restirGiRayQuery.useReflectionReprojection.setDeferred(true);
+      restirGiRayQuery.useHalfResolutionReuse.setDeferred(false);
       common->metaComposite().enableStochasticAlphaBlend.setDeferred(true);
       postFx.enable.setDeferred(true);
 
@@ -433,6 +434,7 @@ namespace dxvk {
       rtxdiRayQuery.enableRayTracedBiasCorrection.setDeferred(true);
       restirGiRayQuery.biasCorrectionMode.setDeferred(ReSTIRGIBiasCorrection::PairwiseRaytrace);
       restirGiRayQuery.useReflectionReprojection.setDeferred(true);
+      restirGiRayQuery.useHalfResolutionReuse.setDeferred(false);
       common->metaComposite().enableStochasticAlphaBlend.setDeferred(true);
       postFx.enable.setDeferred(true);
 
@@ -449,6 +451,8 @@ namespace dxvk {
       russianRouletteMaxContinueProbability.setDeferred(0.7f);
       russianRoulette1stBounceMinContinueProbability.setDeferred(0.4f);
 
+      restirGiRayQuery.useHalfResolutionReuse.setDeferred(false);
+
       volumetrics.setQualityLevel(RtxGlobalVolumetrics::Medium);
       enableNrcPreset(NeuralRadianceCache::QualityPreset::Medium);
 
@@ -459,6 +463,9 @@ namespace dxvk {
       russianRouletteMaxContinueProbability.setDeferred(0.7f);
       russianRoulette1stBounceMinContinueProbability.setDeferred(0.4f);
 
+      // ReSTIR GI is only used here when NRC isn't supported
+      restirGiRayQuery.useHalfResolutionReuse.setDeferred(true);
+
       volumetrics.setQualityLevel(RtxGlobalVolumetrics::Low);
       enableNrcPreset(NeuralRadianceCache::QualityPreset::Medium);
 
@@ -349,6 +349,38 @@ namespace dxvk {
                  "This generally should be set to a value low enough to not impact the application framerate significantly (especially if non-ray traced visuals are capable of being displayed by the application while loading, e.g. an intro video), but also high enough to get the desired shader compilation performance (especially relevant if the application is fairly heavy on the CPU during async shader compilation, or on CPUs with few hardware threads).");
     } shader;
 
+    struct DynamicResolution {
+      RTX_OPTION("rtx.dynamicResolution", bool, enable, false,
+                 "Scales the render resolution of the active upscaler down when the GPU cannot hold the target frame time and back up once it has headroom again.\n"
+                 "Frames that leave the GPU idle for a large part of the frame are not GPU bound and never lower the resolution. Has no effect when no upscaler is used.");
+      RTX_OPTION("rtx.dynamicResolution", float, targetFrameTimeMs, 16.6f, "[milliseconds] The frame time the dynamic resolution scale is steered towards.");
+      RTX_OPTION("rtx.dynamicResolution", float, minScale, 0.5f, "The lowest scale dynamic resolution applies on top of the render resolution picked by the upscaler, in the range (0, 1].");
+      RTX_OPTION("rtx.dynamicResolution", float, scaleStep, 0.05f,
+                 "The amount the dynamic resolution scale moves by in a single adjustment. The scale only ever takes multiples of this value so that the render resolution,\n"
+                 "and with it all resolution dependent resources, only changes when the scale does.");
+      RTX_OPTION("rtx.dynamicResolution", uint32_t, framesPerAdjustment, 30,
+                 "The number of frames the frame time is averaged over before each dynamic resolution adjustment. Bounds how often render targets are resized.");
+    } dynamicResolution;
+
+    struct AdaptiveIndirectSampling {
+      RTX_OPTION("rtx.adaptiveIndirectSampling", bool, enable, false,
+                 "Limits the indirect bounces of pixels whose primary surface was already visible in the previous frame, and whose lighting did not change noticeably, to rtx.adaptiveIndirectSampling.stableMaxBounces.\n"
+                 "Such pixels rely on the denoiser's accumulated history, so the full bounce budget is only spent on disoccluded pixels, pixels with changing lighting and on the secondary surfaces of PSR.");
+      RTX_OPTION("rtx.adaptiveIndirectSampling", uint8_t, stableMaxBounces, 1,
+                 "The maximum number of indirect bounces of stable pixels when adaptive indirect sampling is enabled. Values at or above rtx.pathMaxBounces have no effect.");
+      RTX_OPTION("rtx.adaptiveIndirectSampling", float, lightingChangeThreshold, 0.1f,
+                 "The RTXDI lighting gradient above which a pixel is no longer considered stable. Only used when RTXDI computes gradients for the denoiser.");
+    } adaptiveIndirectSampling;
+
+    struct InterleavedIndirect {
+      RTX_OPTION("rtx.interleavedIndirect", uint32_t, rate, 1,
+                 "Traces indirect rays from the primary surface for only one in this many pixels per frame, in a pattern rotating every frame: 1 traces every pixel, 2 a checkerboard and 4 one pixel of every 2x2 quad.\n"
+                 "The skipped pixels are filled in from their traced neighbors before denoising, or through temporal and spatial reuse when ReSTIR GI is enabled. Trades indirect lighting detail for performance, mainly useful on lower end GPUs.");
+      RTX_OPTION("rtx.interleavedIndirect", float, fovealRadius, 0.0f,
+                 "Radius of a region around the center of the screen, in units of half the screen height, in which every pixel keeps tracing indirect rays when interleaved indirect tracing is enabled.\n"
+                 "Concentrates the indirect ray budget where the viewer is usually looking, which suits ultrawide displays and head mounted displays. 0 interleaves the whole screen.");
+    } interleavedIndirect;
+
     struct RaytracedRenderTarget {
       RTX_OPTION("rtx.raytracedRenderTarget", bool, enable, true, "Enables or disables raytracing for render-to-texture effects.  The render target to be raytraced must be specified in the texture selection menu.");
     } raytracedRenderTarget;
@@ -395,7 +427,43 @@ namespace dxvk {
 
     RTX_OPTION("rtx", uint32_t, minPrimsInDynamicBLAS, 1000, "The minimum number of triangles required to promote a mesh to it's own BLAS, otherwise it lands in the merged BLAS with multiple other meshes.");
     RTX_OPTION("rtx", uint32_t, maxPrimsInMergedBLAS, 50000, "The maximum number of triangles for a mesh that can be in the merged BLAS.  ");
+    RTX_OPTION("rtx", bool, enableBlasMergeCostModel, false,
+               "Decides which meshes get their own BLAS with a cost model rather than the fixed 'rtx.minPrimsInDynamicBLAS' and 'rtx.maxPrimsInMergedBLAS' thresholds.\n"
+               "The model weighs the cost of rebuilding a mesh in the merged BLAS every frame against refitting its own BLAS as often as its vertices change plus the trace overhead of an additional TLAS instance, "
+               "and keeps meshes that are far apart from each other out of the same merged BLAS.");
+    RTX_OPTION("rtx", float, dynamicBlasInstanceCost, 2000.f, "The trace and TLAS build overhead of an additional BLAS instance in the BLAS merging cost model, expressed in the build cost of as many triangles.");
+    RTX_OPTION("rtx", float, blasRefitCostRatio, 0.4f, "The cost of refitting a BLAS relative to rebuilding it in the BLAS merging cost model.");
+    RTX_OPTION("rtx", float, blasMergeHysteresis, 0.25f, "The relative cost difference required for the BLAS merging cost model to move a mesh in or out of the merged BLAS, which avoids meshes bouncing between the two.");
+    RTX_OPTION("rtx", float, maxMergedBlasSurfaceAreaRatio, 16.f,
+               "With the BLAS merging cost model, the maximum ratio between the surface area of a merged BLAS' bounds and the summed surface area of the meshes in it.\n"
+               "Merging meshes that are far apart creates a BLAS with a lot of empty space that rays have to traverse.");
+    RTX_OPTION("rtx", bool, enableDecalBatching, false,
+               "Merges decals smaller than 'rtx.minPrimsInDynamicBLAS' into merged BLAS that only hold decals of a single material, rather than alongside other small meshes.\n"
+               "The BLAS of such a decal batch is kept and reused for as long as the same decals are drawn with the same transforms, instead of being rebuilt every frame like other merged BLAS.");
+    RTX_OPTION("rtx", float, tlasInstanceCullingDistance, 0.f,
+               "The distance from the camera beyond which instances are left out of the TLAS, measured to the closest point of their bounds. 0 disables the culling.\n"
+               "Only instances that are also smaller than 'rtx.tlasInstanceCullingMinAngularSize' as seen from the camera are culled, so that large distant geometry such as terrain keeps casting shadows and reflecting.");
+    RTX_OPTION("rtx", float, tlasInstanceCullingMinAngularSize, 0.05f, "The size of an instance's bounds divided by their distance to the camera, below which instances beyond 'rtx.tlasInstanceCullingDistance' are culled.");
     RTX_OPTION_FLAG("rtx", bool, forceMergeAllMeshes, false, RtxOptionFlags::NoSave, "Force merges all meshes into as few BLAS as possible.  This is generally not desirable for performance, but can be a useful debugging tool.");
+    RTX_OPTION("rtx", bool, enableBlasCompaction, false,
+               "Compacts the dedicated BLAS of meshes that have not been rebuilt or updated for a while, which typically cuts their memory by 40-60%.\n"
+               "BLAS built while this is enabled are built with compaction allowed, which makes their builds somewhat slower.");
+    RTX_OPTION("rtx", uint32_t, numFramesBeforeBlasCompaction, 30, "The number of frames a dedicated BLAS has to stay unchanged for before it is compacted.");
+    RTX_OPTION("rtx", uint32_t, maxBlasCompactionsPerFrame, 16, "The maximum number of BLAS compaction size queries and copies to record per frame, spreading the cost of compacting a newly loaded scene over multiple frames.");
+    RTX_OPTION("rtx", bool, enableBlasDiskCache, false,
+               "Stores the dedicated BLAS of static meshes in the \"blas\" subdirectory of the Remix cache directory and loads them instead of building them again in later runs.\n"
+               "A BLAS is stored once it has stayed unchanged for 'rtx.numFramesBeforeBlasCompaction' frames. Cached BLAS are only used on the driver and GPU they were stored with, skinned meshes, meshes drawn with vertex shaders and meshes with opacity micromaps are never cached.");
+    RTX_OPTION("rtx", uint32_t, maxBlasDiskCacheWritesPerFrame, 16, "The maximum number of BLAS to serialize and write to the BLAS disk cache per frame.");
+    RTX_OPTION("rtx", uint32_t, maxBlasBuildPrimitivesPerFrame, 0,
+               "The number of triangles of BLAS builds and updates per frame after which the updates of dedicated BLAS that are outside of the camera frustum are deferred to later frames.\n"
+               "Instances are only known to be outside of the frustum with object anti-culling enabled. 0 disables the budget.");
+    RTX_OPTION("rtx", uint32_t, maxBlasUpdatesBeforeRebuild, 60,
+               "The maximum number of consecutive in place updates (refits) of a dedicated BLAS before it is fully rebuilt.\n"
+               "Refitting deforming meshes such as skinned characters is much cheaper than rebuilding them, but the trace performance of a refit BLAS degrades as the mesh moves away from the pose it was built in.\n"
+               "0 disables the periodic rebuild.");
+    RTX_OPTION("rtx", bool, uploadChangedSurfaceDataOnly, true,
+               "Uploads only the parts of the surface and surface mapping buffers that changed since the last frame, rather than the whole buffers every frame.\n"
+               "The comparison against the last uploaded data is done on the CPU.");
     RTX_OPTION_FLAG("rtx", bool, minimizeBlasMerging, false, RtxOptionFlags::NoSave, "Minimize BLAS merging to the minimum possible, this option tries to give all meshes their own BLAS.  This is generally not desirable forperformance, but can be a useful debugging tool.");
 
     RTX_OPTION_ENV("rtx", bool, enableAlwaysCalculateAABB, false, "RTX_ALWAYS_CALCULATE_AABB", "Calculate an Axis Aligned Bounding Box for every draw call.\n This may improve instance tracking across frames for skinned and vertex shaded calls.");
@@ -449,6 +517,8 @@ namespace dxvk {
     RTX_OPTION_ENV("rtx", bool, enableRayReconstruction, true, "DXVK_RAY_RECONSTRUCTION", "Enable ray reconstruction.");
 
     RTX_OPTION_FLAG("rtx", bool, lowMemoryGpu, false, RtxOptionFlags::NoSave, "Enables low memory mode, where we aggressively detune caches and streaming systems to accomodate the lower memory available.");
+    RTX_OPTION("rtx", bool, reducedPrecisionHitDistances, false, "Stores the primary and secondary surface hit distances as 16 bit floats instead of 32 bit floats, which halves the bandwidth of these G-Buffer textures.\n"
+               "The hit distance is used to reconstruct surface positions in ReSTIR-based passes, so this trades precision of those positions for bandwidth, especially for far away surfaces. Intended for bandwidth limited GPUs.");
 
     RTX_OPTION("rtx", float, resolutionScale, 0.75f, "");
     RTX_OPTION("rtx", bool, forceCameraJitter, false, "Force enables camera jitter frame to frame.");
@@ -460,6 +530,10 @@ namespace dxvk {
     RTX_OPTION("rtx", float, uniqueObjectDistance, 300.f, "The distance (in game units) that an object can move in a single frame before it is no longer considered the same object.\n"
                     "If this is too low, fast moving objects may flicker and have bad lighting.  If it's too high, repeated objects may flicker.\n"
                     "This does not account for sceneScale.");
+    RTX_OPTION("rtx", bool, preserveWorldSpaceCachesOnCameraCut, false, "Keeps the scene and the world space caches built from it across camera cuts, e.g. on map transitions, respawns or when spectating.\n"
+               "By default a camera cut clears the scene at the end of the frame, which discards instances, BLAS, opacity micromaps, lights and the NEE cache along with it so that they have to be rebuilt from scratch.\n"
+               "When set, only the screen space history (denoisers, upscalers and RTXDI/ReSTIR GI temporal reuse) is reset on the frame of the cut, and objects left behind are released by the regular garbage collection instead.\n"
+               "Whether the Neural Radiance Cache recenters its scene bounds on a camera cut is controlled separately by rtx.neuralRadianceCache.resetSceneBoundsOnCameraCut.");
     
     RTX_OPTION_ARGS("rtx", UIType, showUI, UIType::None, "0 = Don't Show, 1 = Show Simple, 2 = Show Advanced.", 
                     args.environment = "RTX_GUI_DISPLAY_UI",
@@ -494,6 +568,10 @@ namespace dxvk {
     RTX_OPTION_ENV("rtx", RenderPassIntegrateIndirectRaytraceMode, renderPassIntegrateIndirectRaytraceMode, RenderPassIntegrateIndirectRaytraceMode::TraceRay, "DXVK_RENDER_PASS_INTEGRATE_INDIRECT_RAYTRACE_MODE",
                    "The ray tracing mode to use for the Indirect Lighting pass which applies lighting to the primary/secondary surfaces.");
     RTX_OPTION("rtx", bool, captureDebugImage, false, "");
+    RTX_OPTION("rtx", uint32_t, screenshotInterval, 0,
+               "Takes a screenshot every this many frames when set to a non-zero value, e.g. to record a benchmark run or a sequence of frames. 0 disables periodic screenshots.\n"
+               "Periodic screenshots are written to the same location as regular ones with the frame number in their name. Unlike regular screenshots they keep the sRGB conversion of the output, so the frames in between look the same.\n"
+               "The readback and encoding happen asynchronously, a capture is skipped rather than stalling the frame when earlier ones are still being written.");
 
     // Denoiser Options
     RTX_OPTION_ENV("rtx", bool, useDenoiser, true, "DXVK_USE_DENOISER",
@@ -525,12 +603,18 @@ namespace dxvk {
     } accumulation;
 
     RTX_OPTION_ENV("rtx", bool, denoiseDirectAndIndirectLightingSeparately, true, "DXVK_DENOISE_DIRECT_AND_INDIRECT_LIGHTING_SEPARATELY", "Denoising quality, high uses separate denoising of direct and indirect lighting for higher quality at the cost of performance.");
+    RTX_OPTION("rtx", bool, denoiseSecondariesAtHalfResolution, false, "Denoises the secondary surface signal (reflections and refractions through PSR surfaces) at half of the render resolution and resolves it back with a depth aware upsample.\n"
+               "This roughly halves the cost of the secondary surface denoiser at the price of some detail in reflections and refractions. Not used with the reference denoiser.");
     RTX_OPTION("rtx", bool, replaceDirectSpecularHitTWithIndirectSpecularHitT, true, "");
     RTX_OPTION("rtx", bool, adaptiveResolutionDenoising, true, "");
     RTX_OPTION_ENV("rtx", bool, adaptiveAccumulation, true, "DXVK_USE_ADAPTIVE_ACCUMULATION", "");
     RTX_OPTION("rtx", uint32_t, numFramesToKeepInstances, 1, "");
     RTX_OPTION("rtx", uint32_t, numFramesToKeepBLAS, 1, "");
     RTX_OPTION("rtx", uint32_t, numFramesToKeepLights, 100, ""); // NOTE: This was the default we've had for a while, can probably be reduced...
+    RTX_OPTION("rtx", uint32_t, numGeometryCacheEntriesToCheckPerFrame, 4096,
+               "The maximum number of cached geometry entries garbage collection inspects per frame, each frame continues where the previous one stopped.\n"
+               "Spreads the cost of scanning a large cache over multiple frames, at the cost of stale geometry being released a few frames later.\n"
+               "0 inspects the whole cache every frame. Object anti-culling always inspects the whole cache as it has to classify every instance each frame.");
 
     static uint32_t numFramesToKeepGeometryData() {
       return numFramesToKeepBLAS();
@@ -646,6 +730,10 @@ namespace dxvk {
     public: static inline bool enableShaderExecutionReordering = true;
     RTX_OPTION("rtx", bool, enableShaderExecutionReorderingInPathtracerGbuffer, false, "(Note: Hard disabled in shader code) Enables Shader Execution Reordering (SER) in GBuffer Raytrace pass if SER is supported.");
     RTX_OPTION("rtx", bool, enableShaderExecutionReorderingInPathtracerIntegrateIndirect, true, "Enables Shader Execution Reordering (SER) in Integrate Indirect pass if SER is supported.");
+    RTX_OPTION("rtx", uint32_t, serSurfaceSortKeyHintBits, 4,
+               "The number of bits of the hit surface's sort key to pass as coherence hints when Shader Execution Reordering (SER) is used in the Integrate Indirect pass, from 0 to 6.\n"
+               "The sort key is made of the material type (opaque, translucent, ray portal) in the 2 leading bits, then the material features (alpha tested or blended, subsurface, emissive) in 2 bits, then the instance category (world, view or player model, particle, decal) in the last 2 bits.\n"
+               "More bits group threads about to shade similar materials more tightly, at the cost of a smaller share of the reordering going to the other hints. 0 disables the sort key hints.");
 
     // Path Options
     RTX_OPTION("rtx", bool, enableRussianRoulette, true,
@@ -909,6 +997,12 @@ namespace dxvk {
     RTX_OPTION("rtx", bool, enableReplacementMaterials, true,
                "Enables or disables enhanced material replacements.\n"
                "Requires replacement assets in general to be enabled to have any effect.");
+    RTX_OPTION("rtx", bool, enableReplacementMeshLods, true,
+               "Enables drawing the lower detail LODs of replacement meshes (authored through remix_lod:meshes) when the meshes are small on screen.\n"
+               "Requires replacement meshes to be enabled to have any effect.");
+    RTX_OPTION("rtx", float, replacementMeshLodBias, 1.f,
+               "Scales the projected screen size replacement mesh LODs are selected by.\n"
+               "Values above 1 keep the higher detail LODs for longer, values below 1 switch to the lower detail LODs sooner.");
     RTX_OPTION("rtx", bool, enableReplacementInstancerMeshRendering, true,
                "Enables or disables rendering GeomPointInstancer meshes using an optimized path.\n"
                "Requires reloading replacement assets.");
@@ -927,20 +1021,62 @@ namespace dxvk {
                  "replacements assets are simply too large for the target GPUs available vid mem, we may end up going overbudget "
                  "regularly.  Defaults to 50% of the available VRAM.");
       RTX_OPTION("rtx.texturemanager", bool, fixedBudgetEnable, false, "If true, rtx.texturemanager.fixedBudgetMiB is used instead of rtx.texturemanager.budgetPercentageOfAvailableVram.");
+      RTX_OPTION("rtx.texturemanager", int, hardBudgetMiB, 0,
+                 "A hard cap on the VRAM used by all streamed replacement textures, including the ones that are not covered by the sampler feedback budget. In mebibytes, 0 disables the cap.\n"
+                 "Textures without sampler feedback are demoted one mip per frame in least recently used order while over the cap, and regain their mips one per frame once there's room again. "
+                 "What's left of the cap bounds the sampler feedback texture budget.");
       RTX_OPTION("rtx.texturemanager", int, fixedBudgetMiB, 2048, "Fixed-size VRAM budget for replacement textures. In mebibytes. To use, set rtx.texturemanager.fixedBudgetEnable to True.");
       RTX_OPTION_ENV("rtx.texturemanager", bool, samplerFeedbackEnable, true, "DXVK_TEXTURES_SAMPLER_FEEDBACK_ENABLE",
                  "Enable texture sampler feedback. If true, a texture prioritization logic considers the amount of mip-levels that was sampled by a GPU while rendering a scene."
                  "(For example, if a texture is in the distance, it will have a lower priority compared to a texture rendered just in front of the camera).");
       RTX_OPTION_FLAG_ENV("rtx.texturemanager", bool, neverDowngradeTextures, false, RtxOptionFlags::NoSave, "DXVK_TEXTURES_NEVER_DOWNGRADE", 
                  "Debug option to forcibly prevent uploading lower resolution data, if the texture already has been promoted to a high resolution.");
+      RTX_OPTION("rtx.texturemanager", bool, prioritizeLoadQueue, true,
+                 "If true, the async texture loader picks the queued textures by priority instead of the order they were requested in.\n"
+                 "The priority is derived from the sampler feedback mip count, which follows the texture's on-screen footprint, and grows with the time spent in the queue.\n"
+                 "Queued textures are reprioritized every frame, and their load is dropped if the request goes back to what is already in VRAM.");
+      RTX_OPTION("rtx.texturemanager", uint32_t, numLoaderThreads, 2,
+                 "The number of CPU threads that read the streamed textures from disk and copy them to the staging buffer. Will be limited by the number of CPU cores.\n"
+                 "With 1, everything is done on the single async texture thread. Not used with RTX IO, which schedules its own reads and decompression.");
       RTX_OPTION("rtx.texturemanager", int, stagingBufferSizeMiB, 96,
                  "Size of a pre-allocated staging (intermediate) buffer to use when sending a texture from a RAM to GPU VRAM. "
                  "If a texture size exceeds this limit, it will not be considered for the texture streaming. In mebibytes.");
+      RTX_OPTION("rtx.texturemanager", bool, uploadOnTransferQueue, true,
+                 "If true and the GPU has a dedicated transfer queue, streamed textures are copied from the staging buffer to VRAM on the transfer queue instead of the graphics queue, so that texture streaming doesn't compete with the frame's rendering work.\n"
+                 "Not used with RTX IO, which does its own copies.");
+
+      struct MipCache {
+        RTX_OPTION("rtx.texturemanager.mipCache", bool, enable, false,
+                   "If true, loose uncompressed 8 bit per channel DDS replacement textures that have no mips are rebuilt with a full mip chain on a background thread.\n"
+                   "The rebuilt textures are stored in the \"textures\" subdirectory of the Remix cache directory, keyed by the source file path and modification time, and are used instead of the source files once they are ready.\n"
+                   "Textures with a mip chain can be streamed at a lower resolution, so this saves VRAM for mods that ship mip-less textures.");
+      };
     };
     RTX_OPTION("rtx", bool, reloadTextureWhenResolutionChanged, false, "Reload texture when resolution changed.");
     RTX_OPTION_FLAG_ENV("rtx", bool, alwaysWaitForAsyncTextures, false, RtxOptionFlags::NoSave, "DXVK_WAIT_ASYNC_TEXTURES", 
                "Force CPU to wait for the texture upload. Do not use an asynchronous thread for textures. If true, a frame stutter should be expected.");
+    RTX_OPTION("rtx", bool, lazyReplacementMeshLoading, false,
+               "If true, the mesh replacements of a USD mod are only processed and uploaded once the game draws a mesh with their hash, instead of all of them while the mod is loaded.\n"
+               "The original mesh is drawn until its replacement is ready. Useful for mods that cover a lot of content of which a single session only sees a small part.\n"
+               "Lights, materials and secret replacement variants are still loaded up front. Takes effect on the next mod load.");
+    RTX_OPTION("rtx", bool, incrementalModReload, true,
+               "If true, a change to a file of a loaded USD mod only reprocesses the replacements whose composed values the change affects, instead of reloading the whole mod.\n"
+               "The stage of the mod stays open while the mod is loaded. Changes to the layer structure of the mod, such as added sublayers, and mods with secret replacement variants still get a full reload.\n"
+               "Not used together with rtx.lazyReplacementMeshLoading. Takes effect on the next mod load.");
+    RTX_OPTION("rtx", bool, enableUsdMeshCache, true,
+               "If true, the triangulated meshes of a USD mod are cached in a \".meshcache\" file next to the mod, and later loads read them from there instead of processing the USD meshes again.\n"
+               "The cache is rebuilt whenever any layer of the mod changes.");
+    RTX_OPTION("rtx.initializer", uint32_t, numMeshImportThreads, 4,
+               "The number of worker threads that import the meshes of USD replacements while a mod is loaded.\n"
+               "The replacements themselves are still built on the loading thread in stage order, so this only changes how long loading takes.\n"
+               "0 or 1 imports every mesh on the loading thread.");
     RTX_OPTION_FLAG_ENV("rtx.initializer", bool, asyncAssetLoading, true, RtxOptionFlags::NoSave, "DXVK_ASYNC_ASSET_LOADING", "If true, a separate thread is created to load USD assets asynchronously.");
+    RTX_OPTION("rtx", bool, bindlessPartialUpdates, true,
+               "If true, the bindless texture, buffer and sampler tables only rewrite the descriptors that changed since their descriptor set was last written, instead of every descriptor in the tables each frame.");
+    RTX_OPTION("rtx", bool, memoryMapAssetPackages, true,
+               "If true, the CPU reads of uncompressed asset package blobs go through a read-only memory mapping of the package, instead of a read of each blob into an intermediate buffer.\n"
+               "The mip tail blob is also prefetched while the larger mips of a texture are copied.\n"
+               "Loads done by RTX IO are not affected.");
     RTX_OPTION("rtx", bool, usePartialDdsLoader, true,
                "A flag controlling if the partial DDS loader should be used, true to enable, false to disable and use GLI instead.\n"
                "Generally this should be always enabled as it allows for simple parsing of DDS header information without loading the entire texture into memory like GLI does to retrieve similar information.\n"
@@ -1002,6 +1138,9 @@ namespace dxvk {
     RTX_OPTION("rtx", float, skyBrightness, 1.f, "");
     RTX_OPTION("rtx", bool, skyForceHDR, false, "By default sky will be rasterized in the color format used by the game. Set the checkbox to force sky to be rasterized in HDR intermediate format. This may be important when sky textures replaced with HDR textures.");
     RTX_OPTION("rtx", uint32_t, skyProbeSide, 1024, "Resolution of the skybox for indirect illumination (rough reflections, global illumination etc).");
+    RTX_OPTION("rtx", bool, skyProbeReuse, false, "Reuses the sky probe from previous frames instead of rasterizing the sky draw calls into it again, as long as the sky draw calls stay the same.\n"
+               "Sky draw calls are compared by their geometry, textures, draw parameters and transforms relative to the sky camera, so a static skybox is reused while the sky camera only rotates.\n"
+               "A change in the sky draw calls is picked up on the following frame. The sky matte is view dependent and is always rasterized.");
     RTX_OPTION_FLAG("rtx", uint32_t, skyUiDrawcallCount, 0, RtxOptionFlags::NoSave, "");
     RTX_OPTION("rtx", uint32_t, skyDrawcallIdThreshold, 0, "It's common in games to render the skybox first, and so, this value provides a simple mechanism to identify those early draw calls that are untextured (textured draw calls can still use the Sky Textures functionality.");
     RTX_OPTION("rtx", float, skyMinZThreshold, 1.f, "If a draw call's viewport has min depth greater than or equal to this threshold, then assume that it's a sky.");
@@ -210,22 +210,27 @@ namespace dxvk {
       // Note: The getters for these SER/OMM enabled flags also check if SER/OMMs are supported, so we do not need to check for that manually.
       const bool serEnabled = RtxOptions::isShaderExecutionReorderingInPathtracerGbufferEnabled();
       const bool ommEnabled = RtxOptions::getEnableOpacityMicromap();
-      const bool nrcEnabled = RtxOptions::integrateIndirectMode() == IntegrateIndirectMode::NeuralRadianceCache;
-
-      // Need both PSR and non-PSR passes.
-      for (int32_t isPSRPass = 1; isPSRPass >= 0; isPSRPass--) {
-        for (int32_t includePortals = portalsEnabled; includePortals >= 0; includePortals--) {
-          DxvkComputePipelineShaders shaders;
-          switch (RtxOptions::renderPassGBufferRaytraceMode()) {
-          case RaytraceMode::RayQuery:
-            getComputeShader(isPSRPass, nrcEnabled);
-            break;
-          case RaytraceMode::RayQueryRayGen:
-            pipelineManager.registerRaytracingShaders(getPipelineShaders(isPSRPass, true, serEnabled, ommEnabled, includePortals, nrcEnabled));
-            break;
-          case RaytraceMode::TraceRay:
-            pipelineManager.registerRaytracingShaders(getPipelineShaders(isPSRPass, false, serEnabled, ommEnabled, includePortals, nrcEnabled));
-            break;
+      const bool currentNrcEnabled = RtxOptions::integrateIndirectMode() == IntegrateIndirectMode::NeuralRadianceCache;
+
+      // Graphics presets switch between NRC and ReSTIR GI, so the permutations of the other mode are prewarmed as well
+      for (int32_t nrcIteration = 0; nrcIteration < (isNrcSupported ? 2 : 1); nrcIteration++) {
+        const bool nrcEnabled = nrcIteration == 0 ? currentNrcEnabled : !currentNrcEnabled;
+
+        // Need both PSR and non-PSR passes.
+        for (int32_t isPSRPass = 1; isPSRPass >= 0; isPSRPass--) {
+          for (int32_t includePortals = portalsEnabled; includePortals >= 0; includePortals--) {
+            DxvkComputePipelineShaders shaders;
+            switch (RtxOptions::renderPassGBufferRaytraceMode()) {
+            case RaytraceMode::RayQuery:
+              getComputeShader(isPSRPass, nrcEnabled);
+              break;
+            case RaytraceMode::RayQueryRayGen:
+              pipelineManager.registerRaytracingShaders(getPipelineShaders(isPSRPass, true, serEnabled, ommEnabled, includePortals, nrcEnabled));
+              break;
+            case RaytraceMode::TraceRay:
+              pipelineManager.registerRaytracingShaders(getPipelineShaders(isPSRPass, false, serEnabled, ommEnabled, includePortals, nrcEnabled));
+              break;
+            }
           }
         }
       }
@@ -31,6 +31,7 @@
 #include "rtx/pass/common_binding_indices.h"
 #include "rtx/pass/integrate/integrate_indirect_binding_indices.h"
 #include "rtx/pass/integrate/integrate_nee_binding_indices.h"
+#include "rtx/pass/integrate/interleaved_indirect_reconstruction_binding_indices.h"
 #include "rtx/concept/surface_material/surface_material_hitgroup.h"
 
 #include <rtx_shaders/integrate_indirect_raygen_neeCache.h>
@@ -74,6 +75,7 @@
 #include <rtx_shaders/integrate_indirect_miss_nrc_neeCache.h>
 
 #include <rtx_shaders/integrate_nee.h>
+#include <rtx_shaders/interleaved_indirect_reconstruction.h>
 #include <rtx_shaders/visualize_nee.h>
 
 #include "dxvk_scoped_annotation.h"
@@ -213,6 +215,25 @@ namespace dxvk {
 
     PREWARM_SHADER_PIPELINE(IntegrateNEEShader);
 
+    class InterleavedIndirectReconstructionShader : public ManagedShader {
+      SHADER_SOURCE(InterleavedIndirectReconstructionShader, VK_SHADER_STAGE_COMPUTE_BIT, interleaved_indirect_reconstruction)
+
+      BINDLESS_ENABLED()
+
+      BEGIN_PARAMETER()
+        COMMON_RAYTRACING_BINDINGS
+
+        TEXTURE2D(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_SHARED_FLAGS_INPUT)
+        TEXTURE2D(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_CONE_RADIUS_INPUT)
+        TEXTURE2D(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_WORLD_POSITION_INPUT)
+
+        RW_TEXTURE2D(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_DIFFUSE_RADIANCE_INPUT_OUTPUT)
+        RW_TEXTURE2D(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_SPECULAR_RADIANCE_INPUT_OUTPUT)
+      END_PARAMETER()
+    };
+
+    PREWARM_SHADER_PIPELINE(InterleavedIndirectReconstructionShader);
+
     class VisualizeNEEShader : public ManagedShader {
       SHADER_SOURCE(VisualizeNEEShader, VK_SHADER_STAGE_COMPUTE_BIT, visualize_nee)
 
@@ -301,23 +322,33 @@ namespace dxvk {
       // Note: The getters for these SER/OMM enabled flags also check if SER/OMMs are supported, so we do not need to check for that manually.
       const bool serEnabled = RtxOptions::isShaderExecutionReorderingInPathtracerIntegrateIndirectEnabled();
       const bool ommEnabled = OpacityMicromapManager::checkIsOpacityMicromapSupported(*m_device) && RtxOptions::OpacityMicromap::enable();
-      const bool useNeeCache = NeeCachePass::enable();
-      const bool nrcEnabled = RtxOptions::integrateIndirectMode() == IntegrateIndirectMode::NeuralRadianceCache;
-
-      for (int32_t includesPortals = portalsEnabled; includesPortals >= 0; includesPortals--) {
-        // Prewarm POM on and off, as that can change based on game content (if nothing in the frame has a height texture, then POM turns off)
-        for (int32_t pomEnabled = 1; pomEnabled >= 0; pomEnabled--) {
-          DxvkComputePipelineShaders shaders;
-          switch (RtxOptions::renderPassIntegrateIndirectRaytraceMode()) {
-          case RaytraceMode::RayQuery:
-            getComputeShader(useNeeCache, nrcEnabled);
-            break;
-          case RaytraceMode::RayQueryRayGen:
-            pipelineManager.registerRaytracingShaders(getPipelineShaders(true, serEnabled, ommEnabled, useNeeCache, includesPortals, pomEnabled, nrcEnabled));
-            break;
-          case RaytraceMode::TraceRay:
-            pipelineManager.registerRaytracingShaders(getPipelineShaders(false, serEnabled, ommEnabled, useNeeCache, includesPortals, pomEnabled, nrcEnabled));
-            break;
+      const bool currentUseNeeCache = NeeCachePass::enable();
+      const bool currentNrcEnabled = RtxOptions::integrateIndirectMode() == IntegrateIndirectMode::NeuralRadianceCache;
+
+      // Graphics presets switch between NRC and ReSTIR GI and toggle the NEE cache, so the permutations of the other
+      // settings are prewarmed as well, after the ones currently in use since those are registered for compilation first
+      for (int32_t nrcIteration = 0; nrcIteration < (isNrcSupported ? 2 : 1); nrcIteration++) {
+        const bool nrcEnabled = nrcIteration == 0 ? currentNrcEnabled : !currentNrcEnabled;
+
+        for (int32_t neeCacheIteration = 0; neeCacheIteration < 2; neeCacheIteration++) {
+          const bool useNeeCache = neeCacheIteration == 0 ? currentUseNeeCache : !currentUseNeeCache;
+
+          for (int32_t includesPortals = portalsEnabled; includesPortals >= 0; includesPortals--) {
+            // Prewarm POM on and off, as that can change based on game content (if nothing in the frame has a height texture, then POM turns off)
+            for (int32_t pomEnabled = 1; pomEnabled >= 0; pomEnabled--) {
+              DxvkComputePipelineShaders shaders;
+              switch (RtxOptions::renderPassIntegrateIndirectRaytraceMode()) {
+              case RaytraceMode::RayQuery:
+                getComputeShader(useNeeCache, nrcEnabled);
+                break;
+              case RaytraceMode::RayQueryRayGen:
+                pipelineManager.registerRaytracingShaders(getPipelineShaders(true, serEnabled, ommEnabled, useNeeCache, includesPortals, pomEnabled, nrcEnabled));
+                break;
+              case RaytraceMode::TraceRay:
+                pipelineManager.registerRaytracingShaders(getPipelineShaders(false, serEnabled, ommEnabled, useNeeCache, includesPortals, pomEnabled, nrcEnabled));
+                break;
+              }
+            }
           }
         }
       }
@@ -545,6 +576,33 @@ namespace dxvk {
     }
   }
 
+  void DxvkPathtracerIntegrateIndirect::dispatchInterleavedReconstruction(RtxContext* ctx, const Resources::RaytracingOutput& rtOutput) {
+    // Note: ReSTIR GI fills in skipped pixels through its own reuse and overwrites the primary indirect radiance in its final shading.
+    if (rtOutput.m_raytraceArgs.interleavedIndirectRate <= 1 || rtOutput.m_raytraceArgs.enableReSTIRGI) {
+      return;
+    }
+
+    const auto rayDims = rtOutput.m_compositeOutputExtent;
+    VkExtent3D workgroups = util::computeBlockCount(rayDims, VkExtent3D { 16, 8, 1 });
+
+    ScopedGpuProfileZone(ctx, "Interleaved Indirect Reconstruction");
+    ctx->bindCommonRayTracingResources(rtOutput);
+
+    // Inputs
+
+    ctx->bindResourceView(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_SHARED_FLAGS_INPUT, rtOutput.m_sharedFlags.view, nullptr);
+    ctx->bindResourceView(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_CONE_RADIUS_INPUT, rtOutput.m_primaryConeRadius.view, nullptr);
+    ctx->bindResourceView(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_WORLD_POSITION_INPUT, rtOutput.getCurrentPrimaryWorldPositionWorldTriangleNormal().view(Resources::AccessType::Read), nullptr);
+
+    // Inputs / Outputs
+
+    ctx->bindResourceView(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_DIFFUSE_RADIANCE_INPUT_OUTPUT, rtOutput.m_primaryIndirectDiffuseRadiance.view(Resources::AccessType::ReadWrite), nullptr);
+    ctx->bindResourceView(INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_SPECULAR_RADIANCE_INPUT_OUTPUT, rtOutput.m_primaryIndirectSpecularRadiance.view(Resources::AccessType::ReadWrite), nullptr);
+
+    ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, InterleavedIndirectReconstructionShader::getShader());
+    ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
+  }
+
   DxvkRaytracingPipelineShaders DxvkPathtracerIntegrateIndirect::getPipelineShaders(
     const bool useRayQuery,
     const bool serEnabled,
@@ -47,6 +47,10 @@ namespace dxvk {
 
     void dispatchNEE(RtxContext* ctx, const Resources::RaytracingOutput& rtOutput);
 
+    // Fills in the primary indirect radiance of pixels that interleaved indirect tracing skipped this frame.
+    // Has to run after NRC has resolved its queries into the traced pixels.
+    void dispatchInterleavedReconstruction(RtxContext* ctx, const Resources::RaytracingOutput& rtOutput);
+
     static const char* raytraceModeToString(RaytraceMode raytraceMode);
 
   private:
@@ -27,6 +27,7 @@
 #include "rtx/pass/post_fx/post_fx.h"
 
 #include <rtx_shaders/post_fx.h>
+#include <rtx_shaders/post_fx_bloom_composite.h>
 #include <rtx_shaders/post_fx_highlight.h>
 #include <rtx_shaders/post_fx_motion_blur.h>
 #include <rtx_shaders/post_fx_motion_blur_prefilter.h>
@@ -52,6 +53,21 @@ namespace dxvk {
 
     PREWARM_SHADER_PIPELINE(PostFxShader);
 
+    class PostFxBloomCompositeShader : public ManagedShader
+    {
+      SHADER_SOURCE(PostFxBloomCompositeShader, VK_SHADER_STAGE_COMPUTE_BIT, post_fx_bloom_composite)
+
+      PUSH_CONSTANTS(PostFxArgs)
+
+      BEGIN_PARAMETER()
+        SAMPLER2D(POST_FX_INPUT)
+        RW_TEXTURE2D(POST_FX_OUTPUT)
+        SAMPLER2D(POST_FX_BLOOM_INPUT)
+      END_PARAMETER()
+    };
+
+    PREWARM_SHADER_PIPELINE(PostFxBloomCompositeShader);
+
     class PostFxMotionBlurShader : public ManagedShader
     {
       SHADER_SOURCE(PostFxMotionBlurShader, VK_SHADER_STAGE_COMPUTE_BIT, post_fx_motion_blur)
@@ -220,7 +236,8 @@ namespace dxvk {
     const PostFxArgs& postFxArgs,
     const VkExtent3D& workgroups,
     const Resources::Resource& postFxLensEffectInput,
-    const Resources::Resource& postFxLensEffectOutput)
+    const Resources::Resource& postFxLensEffectOutput,
+    const Resources::Resource* bloomBuffer)
   {
     ScopedGpuProfileZone(ctx, "PostFx Lens Effect");
 
@@ -230,7 +247,13 @@ namespace dxvk {
     ctx->bindResourceSampler(POST_FX_INPUT, linearSampler);
     ctx->bindResourceView(POST_FX_OUTPUT, postFxLensEffectOutput.view, nullptr);
 
-    ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, PostFxShader::getShader());
+    if (bloomBuffer != nullptr) {
+      ctx->bindResourceView(POST_FX_BLOOM_INPUT, bloomBuffer->view, nullptr);
+      ctx->bindResourceSampler(POST_FX_BLOOM_INPUT, linearSampler);
+      ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, PostFxBloomCompositeShader::getShader());
+    } else {
+      ctx->bindShader(VK_SHADER_STAGE_COMPUTE_BIT, PostFxShader::getShader());
+    }
 
     ctx->dispatch(workgroups.width, workgroups.height, workgroups.depth);
   }
@@ -242,12 +265,17 @@ namespace dxvk {
     const uvec2& mainCameraResolution,
     const uint32_t frameIdx,
     const Resources::RaytracingOutput& rtOutput,
-    const bool cameraCutDetected)
+    const bool cameraCutDetected,
+    const Resources::Resource* bloomBuffer,
+    const float bloomIntensity)
   {
     if (!enable()) {
       return;
     }
 
+    // A bloom buffer is only handed over when the bloom composite was skipped for this pass to do it
+    assert(bloomBuffer == nullptr || canFuseBloomComposite(cameraCutDetected));
+
     ScopedGpuProfileZone(ctx, "PostFx");
     ctx->setFramePassStage(RtxFramePassStage::PostFX);
 
@@ -296,6 +324,7 @@ namespace dxvk {
     postFxArgs.vignetteIntensity = isVignetteEnabled() ? vignetteIntensity() : 0.0f;
     postFxArgs.vignetteRadius = vignetteRadius();
     postFxArgs.vignetteSoftness = vignetteSoftness();
+    postFxArgs.bloomIntensity = bloomIntensity;
 
     ctx->setPushConstantBank(DxvkPushConstantBank::RTX);
 
@@ -317,7 +346,7 @@ namespace dxvk {
 
     if (isChromaticAberrationEnabled() || isVignetteEnabled())
     {
-      dispatchPostLensEffects(ctx, linearSampler, postFxArgs, workgroups, *lastPointer, inOutColorTexture);
+      dispatchPostLensEffects(ctx, linearSampler, postFxArgs, workgroups, *lastPointer, inOutColorTexture, bloomBuffer);
 
       lastPointer = &inOutColorTexture;
     }
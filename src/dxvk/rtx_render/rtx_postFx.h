@@ -47,7 +47,9 @@ namespace dxvk {
       const uvec2& mainCameraResolution,
       const uint32_t frameIdx,
       const Resources::RaytracingOutput& rtOutput,
-      const bool cameraCutDetected);
+      const bool cameraCutDetected,
+      const Resources::Resource* bloomBuffer = nullptr,
+      const float bloomIntensity = 0.0f);
 
     void dispatchHighlighting(
       Rc<RtxContext> ctx,
@@ -62,12 +64,17 @@ namespace dxvk {
     inline bool isMotionBlurEnabled() const { return enable() && enableMotionBlur() && motionBlurSampleCount() > 0 && exposureFraction() > 0.0f; }
     inline bool isChromaticAberrationEnabled() const { return enable() && enableChromaticAberration() && chromaticAberrationAmount() > 0.0f; }
     inline bool isVignetteEnabled() const { return enable() && enableVignette() && vignetteIntensity() > 0.0f; }
+    // The bloom composite can only be folded into the lens effect pass when that pass reads the color buffer directly
+    inline bool canFuseBloomComposite(const bool cameraCutDetected) const {
+      return fuseBloomComposite() && (isChromaticAberrationEnabled() || isVignetteEnabled()) && (cameraCutDetected || !isMotionBlurEnabled());
+    }
 
     RTX_OPTION_ENV("rtx.postfx", bool, enable, true, "RTX_POST_FX_ENABLE", "Enables post-processing effects.");
     RTX_OPTION_ENV("rtx.postfx", bool, enableMotionBlur, true, "RTX_POST_FX_MOTION_BLUR_ENABLE", "Enables motion blur post-processing effect.");
     RTX_OPTION("rtx.postfx", bool, enableChromaticAberration, true, "Enables chromatic aberration post-processing effect.");
     RTX_OPTION("rtx.postfx", bool, enableVignette, true, "Enables vignette post-processing effect.");
     RTX_OPTION("rtx.postfx", bool, desaturateOthersOnHighlight, true, "If true, desaturare all objects that are not highlighted.");
+    RTX_OPTION("rtx.postfx", bool, fuseBloomComposite, true, "If true, bloom is composited onto the image by the chromatic aberration and vignette pass instead of a separate full screen pass, saving a read and write of the final output. Only takes effect when motion blur is not running, as motion blur has to see the bloomed image.");
 
   private:
     Rc<vk::DeviceFn> m_vkd;
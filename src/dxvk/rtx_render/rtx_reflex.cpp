@@ -59,6 +59,9 @@ namespace dxvk {
     }
   }
 
+  static dxvk::mutex s_bridgeFrameTimesMutex;
+  static BridgeFrameTimes s_bridgeFrameTimes;
+
   // Reflex uses global variables for PCL init, so if a game uses multiple devices, we need to ensure we only do PCL init once.
   static std::atomic<std::uint32_t> s_initPclRefcount = 0;
 
@@ -607,4 +610,14 @@ namespace dxvk {
     // Note: This is marking that the queue in question is used for OOB presenting, not that it is a queue from a present queue family.
     NvLL_VK_NotifyOutOfBandQueue(m_device->handle(), queueHandle, VK_OUT_OF_BAND_QUEUE_TYPE_PRESENT);
   }
+
+  void RtxReflex::setBridgeFrameTimes(const BridgeFrameTimes& frameTimes) {
+    std::lock_guard<dxvk::mutex> lock(s_bridgeFrameTimesMutex);
+    s_bridgeFrameTimes = frameTimes;
+  }
+
+  BridgeFrameTimes RtxReflex::getBridgeFrameTimes() {
+    std::lock_guard<dxvk::mutex> lock(s_bridgeFrameTimesMutex);
+    return s_bridgeFrameTimes;
+  }
 }
@@ -94,6 +94,14 @@ namespace dxvk {
     float combinedDurationMax;
   };
 
+  // Frame times of a Remix Bridge client, as QPC counter values. The client measures its simulation from the return of one
+  // Present to the next, and the server stamps the arrival of the Present, so the difference is the bridge transit of the frame.
+  struct BridgeFrameTimes {
+    std::uint64_t simulationStart = 0;
+    std::uint64_t simulationEnd = 0;
+    std::uint64_t presentReceived = 0;
+  };
+
   class RtxReflex : public CommonDeviceObject {
   public:
     explicit RtxReflex(DxvkDevice* device);
@@ -166,6 +174,16 @@ namespace dxvk {
       * presents will come from this queue (typically from a frame interpolation method like DLFG).
       */
     void markOutOfBandPresentQueue(VkQueue queueHandle);
+
+    /**
+      * \brief: Stores the frame times of the most recent bridge client frame. Reflex markers can only be placed at the current time,
+      * so these are kept alongside the Reflex stats rather than forwarded as markers. Thread-safe.
+      */
+    static void setBridgeFrameTimes(const BridgeFrameTimes& frameTimes);
+    /**
+      * \brief: Gets the frame times of the most recent bridge client frame, all zeros when not running under the bridge. Thread-safe.
+      */
+    static BridgeFrameTimes getBridgeFrameTimes();
   
   private:
     VkSemaphore m_lowLatencySemaphore;
@@ -42,11 +42,13 @@
 #include "../../util/util_math.h"
 #include "../../util/util_vector.h"
 #include "../../util/util_string.h"
+#include "../../util/util_threadpool.h"
 
 #include "../../d3d9/d3d9_swapchain.h"
 
 #include <windows.h>
 
+#include <atomic>
 #include <optional>
 
 namespace dxvk {
@@ -74,6 +76,8 @@ namespace {
   uint64_t s_apiVersion{ 0 };
   IDirect3D9Ex* s_dxvkD3D9 { nullptr };
   dxvk::D3D9DeviceEx* s_dxvkDevice { nullptr };
+  // Guards the API state that lives outside of the CS thread. Commands for the CS thread don't need it,
+  // they go through the device's lock-free external command queue, see D3D9Rtx::QueueExternalCs.
   dxvk::mutex s_mutex {};
 
 
@@ -84,10 +88,9 @@ namespace {
 
   // from rtx_mod_usd.cpp
   XXH64_hash_t hack_getNextGeomHash() {
-    static uint64_t s_id = UINT64_MAX;
-    std::lock_guard lock { s_mutex };
-    --s_id;
-    return XXH64(&s_id, sizeof(s_id), 0);
+    static std::atomic<uint64_t> s_id = UINT64_MAX;
+    const uint64_t id = --s_id;
+    return XXH64(&id, sizeof(id), 0);
   }
 
 
@@ -217,20 +220,10 @@ namespace {
       return {};
     }
 
-    MaterialData toRtMaterialFinalized(dxvk::DxvkContext& ctx, const MaterialData& materialWithoutPreload, const PreloadSource& preload) {
-      auto preloadTexture = [&ctx](const std::filesystem::path& path)->TextureRef {
-        if (path.empty()) {
-          return {};
-        }
-        auto assetData = AssetDataManager::get().findAsset(path.string());
-        if (assetData == nullptr) {
-          return {};
-        }
-        auto uploadedTexture = ctx.getCommonObjects()->getTextureManager()
-          .preloadTextureAsset(assetData, dxvk::ColorSpace::AUTO, false);
-        return TextureRef { uploadedTexture };
-      };
-
+    // preloadTexture maps a texture path of the preload source to the TextureRef to put into the material
+    template<typename PreloadTexture>
+    MaterialData toRtMaterialFinalized(const MaterialData& materialWithoutPreload, const PreloadSource& preload,
+                                       const PreloadTexture& preloadTexture) {
       switch (materialWithoutPreload.getType()) {
       case MaterialDataType::Opaque:
       {
@@ -675,6 +668,67 @@ dxvk::ExternalDrawState dxvk::RemixAPIPrivateAccessor::toRtDrawState(const remix
 }
 
 namespace {
+  using MaterialTexturePool = dxvk::WorkerThreadPool<64, false, false>;
+
+  std::atomic<uint64_t> s_nextMaterialToken = 0;
+  // Materials that still wait for some of their textures to be resolved, by the token of the CreateMaterial
+  // call that registered them. A material destroyed or recreated in the meantime is left alone.
+  // Only accessed on the CS thread.
+  std::unordered_map<remixapi_MaterialHandle, uint64_t> s_unresolvedMaterials;
+
+  // Finds the assets of the texture paths off the CS thread, as that opens the files, and then registers
+  // the material again with the textures in place. The texture data itself is streamed in by the texture manager.
+  void resolveMaterialTextures(dxvk::D3D9DeviceEx* remixDevice,
+                               remixapi_MaterialHandle handle,
+                               uint64_t token,
+                               const dxvk::MaterialData& materialData,
+                               const convert::PreloadSource& preloadSrc,
+                               std::vector<std::string>&& paths) {
+    auto resolve = [remixDevice, handle, token, materialData, preloadSrc, cPaths = std::move(paths)]() {
+      std::vector<dxvk::Rc<dxvk::AssetData>> assetDatas;
+      assetDatas.reserve(cPaths.size());
+      for (const std::string& path : cPaths) {
+        assetDatas.push_back(dxvk::AssetDataManager::get().findAsset(path));
+      }
+
+      remixDevice->RTX().QueueExternalCs([handle, token, materialData, preloadSrc, cPaths,
+                                          cAssetDatas = std::move(assetDatas)](dxvk::DxvkContext* ctx) {
+        auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
+        for (size_t i = 0; i < cPaths.size(); i++) {
+          // May have been resolved for another material in the meantime
+          if (assets->findExternalMaterialTexture(cPaths[i])) {
+            continue;
+          }
+          dxvk::Rc<dxvk::ManagedTexture> texture;
+          if (cAssetDatas[i] != nullptr) {
+            texture = ctx->getCommonObjects()->getTextureManager()
+              .preloadTextureAsset(cAssetDatas[i], dxvk::ColorSpace::AUTO, false);
+          }
+          assets->addExternalMaterialTexture(cPaths[i], texture);
+        }
+
+        auto found = s_unresolvedMaterials.find(handle);
+        if (found == s_unresolvedMaterials.end() || found->second != token) {
+          return;
+        }
+        s_unresolvedMaterials.erase(found);
+
+        auto data = convert::toRtMaterialFinalized(materialData, preloadSrc, [&](const std::filesystem::path& path) {
+          const auto* texture = path.empty() ? nullptr : assets->findExternalMaterialTexture(path.string());
+          return texture ? dxvk::TextureRef { *texture } : dxvk::TextureRef {};
+        });
+        assets->destroyExternalMaterial(handle);
+        assets->makeMaterialWithTexturePreload(*ctx, handle, std::move(data));
+      });
+    };
+
+    static MaterialTexturePool s_resolvePool(1, "rtx-api-texture-resolve");
+    if (!s_resolvePool.Schedule(resolve).valid()) {
+      // Resolve queue is full, find the assets right away
+      resolve();
+    }
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMaterial(
     const remixapi_MaterialInfo* info,
     remixapi_MaterialHandle* out_handle) {
@@ -692,15 +746,33 @@ namespace {
     }
 
     // async load
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([cHandle = handle,
+    remixDevice->RTX().QueueExternalCs([remixDevice,
+                         cHandle = handle,
+                         cToken = ++s_nextMaterialToken,
                          cMaterialData = convert::toRtMaterialWithoutTexturePreload(*info),
                          cPreloadSrc = convert::makePreloadSource(*info)](dxvk::DxvkContext* ctx) {
       auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
-      assets->makeMaterialWithTexturePreload(
-        *ctx,
-        cHandle,
-        convert::toRtMaterialFinalized(*ctx, cMaterialData, cPreloadSrc));
+      const bool isRepeated = assets->accessExternalMaterial(cHandle) != nullptr;
+
+      std::vector<std::string> unresolvedPaths;
+      auto data = convert::toRtMaterialFinalized(cMaterialData, cPreloadSrc, [&](const std::filesystem::path& path) {
+        if (path.empty()) {
+          return dxvk::TextureRef {};
+        }
+        std::string pathStr = path.string();
+        if (const auto* texture = assets->findExternalMaterialTexture(pathStr)) {
+          return dxvk::TextureRef { *texture };
+        }
+        // Not resolved yet, drawn without the texture until then
+        unresolvedPaths.push_back(std::move(pathStr));
+        return dxvk::TextureRef {};
+      });
+      assets->makeMaterialWithTexturePreload(*ctx, cHandle, std::move(data));
+
+      if (!isRepeated && !unresolvedPaths.empty()) {
+        s_unresolvedMaterials[cHandle] = cToken;
+        resolveMaterialTextures(remixDevice, cHandle, cToken, cMaterialData, cPreloadSrc, std::move(unresolvedPaths));
+      }
     });
 
     *out_handle = handle;
@@ -761,9 +833,9 @@ namespace {
   remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyMaterial(
     remixapi_MaterialHandle handle) {
     if (auto remixDevice = tryAsDxvk()) {
-      std::lock_guard lock { s_mutex };
-      remixDevice->EmitCs([cHandle = handle](dxvk::DxvkContext* ctx) {
+      remixDevice->RTX().QueueExternalCs([cHandle = handle](dxvk::DxvkContext* ctx) {
         auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
+        s_unresolvedMaterials.erase(cHandle);
         assets->destroyExternalMaterial(cHandle);
       });
       return REMIXAPI_ERROR_CODE_SUCCESS;
@@ -771,26 +843,13 @@ namespace {
     return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
   }
 
-  remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMesh(
-    const remixapi_MeshInfo* info,
-    remixapi_MeshHandle* out_handle) {
-    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
-    if (!remixDevice) {
-      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
-    }
-    if (!out_handle || !info || info->sType != REMIXAPI_STRUCT_TYPE_MESH_INFO) {
-      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
-    }
-    static_assert(sizeof(remixapi_MeshHandle) == sizeof(info->hash));
-    auto handle = reinterpret_cast<remixapi_MeshHandle>(info->hash);
-    if (!handle) {
-      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
-    }
-
+  // Allocates and fills the buffers of the mesh's surfaces, the source data is not referenced afterwards
+  std::vector<dxvk::RasterGeometry> createMeshSurfaces(dxvk::D3D9DeviceEx* remixDevice,
+                                                       const remixapi_MeshInfo& info) {
     auto allocatedSurfaces = std::vector<dxvk::RasterGeometry> {};
 
-    for (size_t i = 0; i < info->surfaces_count; i++) {
-      const remixapi_MeshInfoSurfaceTriangles& src = info->surfaces_values[i];
+    for (size_t i = 0; i < info.surfaces_count; i++) {
+      const remixapi_MeshInfoSurfaceTriangles& src = info.surfaces_values[i];
 
       const size_t vertexDataSize = sizeInBytes(src.vertices_values, src.vertices_count);
       const size_t indexDataSize = sizeInBytes(src.indices_values, src.indices_count);
@@ -889,9 +948,67 @@ namespace {
       }
       allocatedSurfaces.push_back(std::move(dst));
     }
-    std::lock_guard lock { s_mutex };
+    return allocatedSurfaces;
+  }
 
-    remixDevice->EmitCs([cHandle = handle, cSurfaces = std::move(allocatedSurfaces)](dxvk::DxvkContext* ctx) mutable {
+  // Deep copy of a mesh info, for building its surfaces on the mesh upload thread after the call returned
+  struct OwnedMeshInfo {
+    explicit OwnedMeshInfo(const remixapi_MeshInfo& src)
+      : info { src } {
+      surfaces.assign(src.surfaces_values, src.surfaces_values + src.surfaces_count);
+      vertices.resize(surfaces.size());
+      indices.resize(surfaces.size());
+      blendWeights.resize(surfaces.size());
+      blendIndices.resize(surfaces.size());
+      for (size_t i = 0; i < surfaces.size(); i++) {
+        auto& surf = surfaces[i];
+        vertices[i].assign(surf.vertices_values, surf.vertices_values + surf.vertices_count);
+        surf.vertices_values = vertices[i].data();
+        indices[i].assign(surf.indices_values, surf.indices_values + surf.indices_count);
+        surf.indices_values = indices[i].data();
+        if (surf.skinning_hasvalue) {
+          auto& skin = surf.skinning_value;
+          blendWeights[i].assign(skin.blendWeights_values, skin.blendWeights_values + skin.blendWeights_count);
+          skin.blendWeights_values = blendWeights[i].data();
+          blendIndices[i].assign(skin.blendIndices_values, skin.blendIndices_values + skin.blendIndices_count);
+          skin.blendIndices_values = blendIndices[i].data();
+        }
+      }
+      info.pNext = nullptr;
+      info.surfaces_values = surfaces.data();
+    }
+
+    remixapi_MeshInfo info;
+    std::vector<remixapi_MeshInfoSurfaceTriangles> surfaces;
+    std::vector<std::vector<remixapi_HardcodedVertex>> vertices;
+    std::vector<std::vector<uint32_t>> indices;
+    std::vector<std::vector<float>> blendWeights;
+    std::vector<std::vector<uint32_t>> blendIndices;
+  };
+
+  using MeshUploadPool = dxvk::WorkerThreadPool<64, false, false>;
+
+  // Meshes created with CreateMeshAsync whose surfaces haven't been queried as ready yet. Guarded by s_mutex.
+  std::unordered_map<remixapi_MeshHandle, std::shared_ptr<dxvk::PendingExternalMesh>> s_pendingMeshes;
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMesh(
+    const remixapi_MeshInfo* info,
+    remixapi_MeshHandle* out_handle) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!out_handle || !info || info->sType != REMIXAPI_STRUCT_TYPE_MESH_INFO) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    static_assert(sizeof(remixapi_MeshHandle) == sizeof(info->hash));
+    auto handle = reinterpret_cast<remixapi_MeshHandle>(info->hash);
+    if (!handle) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+
+    auto allocatedSurfaces = createMeshSurfaces(remixDevice, *info);
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cSurfaces = std::move(allocatedSurfaces)](dxvk::DxvkContext* ctx) mutable {
       auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
       assets->registerExternalMesh(cHandle, std::move(cSurfaces));
     });
@@ -900,14 +1017,107 @@ namespace {
     return REMIXAPI_ERROR_CODE_SUCCESS;
   }
 
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateMeshAsync(
+    const remixapi_MeshInfo* info,
+    remixapi_MeshHandle* out_handle) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!out_handle || !info || info->sType != REMIXAPI_STRUCT_TYPE_MESH_INFO) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    static_assert(sizeof(remixapi_MeshHandle) == sizeof(info->hash));
+    auto handle = reinterpret_cast<remixapi_MeshHandle>(info->hash);
+    if (!handle) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+
+    // Only the copy of the source data happens on the caller thread, buffers are allocated and filled on the upload thread
+    auto source = std::make_shared<OwnedMeshInfo>(*info);
+    auto pending = std::make_shared<dxvk::PendingExternalMesh>();
+
+    {
+      std::lock_guard lock { s_mutex };
+      static MeshUploadPool s_uploadPool(1, "rtx-api-mesh-upload");
+      dxvk::Future<void> upload = s_uploadPool.Schedule([remixDevice, source, pending]() {
+        pending->surfaces = createMeshSurfaces(remixDevice, source->info);
+        pending->ready.store(true, std::memory_order_release);
+      });
+      if (!upload.valid()) {
+        // Upload queue is full, build the surfaces right away
+        pending->surfaces = createMeshSurfaces(remixDevice, source->info);
+        pending->ready.store(true, std::memory_order_release);
+      }
+      s_pendingMeshes[handle] = pending;
+    }
+
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cPending = std::move(pending)](dxvk::DxvkContext* ctx) mutable {
+      auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
+      assets->registerExternalMeshAsync(cHandle, std::move(cPending));
+    });
+
+    *out_handle = handle;
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_IsMeshReady(
+    remixapi_MeshHandle handle,
+    remixapi_Bool* out_ready) {
+    if (!handle || !out_ready) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    std::lock_guard lock { s_mutex };
+    auto found = s_pendingMeshes.find(handle);
+    if (found == s_pendingMeshes.end()) {
+      // Created synchronously, or already reported as ready
+      *out_ready = true;
+      return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+    *out_ready = found->second->ready.load(std::memory_order_acquire);
+    if (*out_ready) {
+      s_pendingMeshes.erase(found);
+    }
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateMeshVertices(
+    remixapi_MeshHandle handle,
+    uint32_t surfaceIndex,
+    uint64_t firstVertex,
+    const remixapi_HardcodedVertex* vertices_values,
+    uint64_t vertices_count) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!handle || !vertices_values || vertices_count == 0) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    auto vertices = std::vector<remixapi_HardcodedVertex>(vertices_values, vertices_values + vertices_count);
+    // look comments in remixapi_CreateMesh
+    const XXH64_hash_t positionHash = hack_getNextGeomHash();
+    const XXH64_hash_t texcoordHash = hack_getNextGeomHash();
+
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cSurfaceIndex = surfaceIndex, cFirstVertex = firstVertex,
+                         cVertices = std::move(vertices), positionHash, texcoordHash](dxvk::DxvkContext* ctx) {
+      auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
+      assets->updateExternalMeshVertices(*ctx, cHandle, cSurfaceIndex, cFirstVertex, cVertices, positionHash, texcoordHash);
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyMesh(
     remixapi_MeshHandle handle) {
     dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
     if (!remixDevice) {
       return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
     }
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([cHandle = handle](dxvk::DxvkContext* ctx) {
+    {
+      std::lock_guard lock { s_mutex };
+      s_pendingMeshes.erase(handle);
+    }
+    remixDevice->RTX().QueueExternalCs([cHandle = handle](dxvk::DxvkContext* ctx) {
       auto& assets = ctx->getCommonObjects()->getSceneManager().getAssetReplacer();
       assets->destroyExternalMesh(cHandle);
     });
@@ -923,7 +1133,6 @@ namespace {
     if (!info || info->sType != REMIXAPI_STRUCT_TYPE_CAMERA_INFO) {
       return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
     }
-    std::lock_guard lock { s_mutex };
     // ensure that near plane is not modified, to keep the projection matrix
     // exactly as the client provided, so depth buffers would have expected results,
     // for a client to be able to reproject to world space using the projection matrices
@@ -931,7 +1140,7 @@ namespace {
       assert(0);
       const_cast<bool&>(dxvk::RtxOptions::enableNearPlaneOverride()) = false;
     }
-    remixDevice->EmitCs([cRtCamera = convert::toRtCamera(*info)](dxvk::DxvkContext* ctx) {
+    remixDevice->RTX().QueueExternalCs([cRtCamera = convert::toRtCamera(*info)](dxvk::DxvkContext* ctx) {
       ctx->getCommonObjects()->getSceneManager().getCameraManager()
         .processExternalCamera(cRtCamera.type, cRtCamera.worldToView, cRtCamera.viewToProjection);
     });
@@ -944,14 +1153,107 @@ namespace {
     if (!remixDevice) {
       return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
     }
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([cRtDrawState = convert::toRtDrawState(*info)](dxvk::DxvkContext* dxvkCtx) mutable {
+    remixDevice->RTX().QueueExternalCs([cRtDrawState = convert::toRtDrawState(*info)](dxvk::DxvkContext* dxvkCtx) mutable {
       auto* ctx = static_cast<dxvk::RtxContext*>(dxvkCtx);
       ctx->commitExternalGeometryToRT(std::move(cRtDrawState));
     });
     return REMIXAPI_ERROR_CODE_SUCCESS;
   }
 
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawInstances(
+    const remixapi_InstanceInfo* infos,
+    uint32_t infos_count) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (infos_count == 0) {
+      return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+    if (!infos) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    std::vector<dxvk::ExternalDrawState> rtDrawStates;
+    rtDrawStates.reserve(infos_count);
+    for (uint32_t i = 0; i < infos_count; i++) {
+      rtDrawStates.push_back(convert::toRtDrawState(infos[i]));
+    }
+    // Single lock and CS chunk for the whole batch, instead of one per instance
+    remixDevice->RTX().QueueExternalCs([cRtDrawStates = std::move(rtDrawStates)](dxvk::DxvkContext* dxvkCtx) mutable {
+      auto* ctx = static_cast<dxvk::RtxContext*>(dxvkCtx);
+      for (dxvk::ExternalDrawState& rtDrawState : cRtDrawStates) {
+        ctx->commitExternalGeometryToRT(std::move(rtDrawState));
+      }
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateInstance(
+    const remixapi_InstanceInfo* info,
+    remixapi_InstanceHandle* out_handle) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!out_handle || !info || info->sType != REMIXAPI_STRUCT_TYPE_INSTANCE_INFO) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    static std::atomic<uint64_t> s_nextInstanceId = 0;
+    auto handle = reinterpret_cast<remixapi_InstanceHandle>(++s_nextInstanceId);
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cRtDrawState = convert::toRtDrawState(*info)](dxvk::DxvkContext* ctx) mutable {
+      ctx->getCommonObjects()->getSceneManager().createExternalInstance(cHandle, std::move(cRtDrawState));
+    });
+    *out_handle = handle;
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateInstanceTransform(
+    remixapi_InstanceHandle handle,
+    const remixapi_Transform* transform) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!handle || !transform) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cObjectToWorld = convert::tomat4(*transform)](dxvk::DxvkContext* ctx) {
+      ctx->getCommonObjects()->getSceneManager().updateExternalInstanceTransform(cHandle, cObjectToWorld);
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateInstanceMaterial(
+    remixapi_InstanceHandle handle,
+    remixapi_MaterialHandle material) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!handle) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    remixDevice->RTX().QueueExternalCs([cHandle = handle, cMaterial = material](dxvk::DxvkContext* ctx) {
+      ctx->getCommonObjects()->getSceneManager().updateExternalInstanceMaterial(cHandle, cMaterial);
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_DestroyInstance(
+    remixapi_InstanceHandle handle) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!handle) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    remixDevice->RTX().QueueExternalCs([cHandle = handle](dxvk::DxvkContext* ctx) {
+      ctx->getCommonObjects()->getSceneManager().destroyExternalInstance(cHandle);
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_CreateLight(
     const remixapi_LightInfo* info,
     remixapi_LightHandle* out_handle) {
@@ -969,10 +1271,9 @@ namespace {
     }
 
     // async load
-    std::lock_guard lock { s_mutex };
     if (auto src = pnext::find<remixapi_LightInfoDomeEXT>(info)) {
       // Special case for dome lights
-      remixDevice->EmitCs([cHandle = handle, 
+      remixDevice->RTX().QueueExternalCs([cHandle = handle, 
                           cRadiance = convert::tovec3(info->radiance), 
                           cTransform = convert::tomat4(src->transform), 
                           cTexturePath = convert::topath(src->colorTexture)]
@@ -1012,7 +1313,7 @@ namespace {
         return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
       }
 
-      remixDevice->EmitCs([cHandle = handle, cRtLight = *rtLight](dxvk::DxvkContext* ctx) {
+      remixDevice->RTX().QueueExternalCs([cHandle = handle, cRtLight = *rtLight](dxvk::DxvkContext* ctx) {
         auto& lightMgr = ctx->getCommonObjects()->getSceneManager().getLightManager();
         lightMgr.addExternalLight(cHandle, cRtLight);
       });
@@ -1028,8 +1329,7 @@ namespace {
     if (!remixDevice) {
       return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
     }
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([cHandle = handle](dxvk::DxvkContext* ctx) {
+    remixDevice->RTX().QueueExternalCs([cHandle = handle](dxvk::DxvkContext* ctx) {
       auto& lightMgr = ctx->getCommonObjects()->getSceneManager().getLightManager();
       lightMgr.removeExternalLight(cHandle);
     });
@@ -1037,6 +1337,48 @@ namespace {
   }
 
 
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_UpdateLights(
+    const remixapi_LightHandle* handles,
+    const remixapi_LightInfo* infos,
+    uint32_t count) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (count == 0) {
+      return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+    if (!handles || !infos) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+
+    // Convert everything upfront, so that an invalid light leaves the whole batch unapplied
+    std::vector<std::pair<remixapi_LightHandle, dxvk::RtLight>> lights;
+    lights.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      if (!handles[i] || infos[i].sType != REMIXAPI_STRUCT_TYPE_LIGHT_INFO) {
+        return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+      }
+      if (pnext::find<remixapi_LightInfoDomeEXT>(&infos[i])) {
+        return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+      }
+      auto rtLight = convert::toRtLight(infos[i]);
+      if (!rtLight.has_value()) {
+        return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+      }
+      lights.emplace_back(handles[i], std::move(*rtLight));
+    }
+
+    remixDevice->RTX().QueueExternalCs([cLights = std::move(lights)](dxvk::DxvkContext* ctx) {
+      auto& lightMgr = ctx->getCommonObjects()->getSceneManager().getLightManager();
+      for (const auto& [handle, rtLight] : cLights) {
+        lightMgr.addExternalLight(handle, rtLight);
+      }
+    });
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_DrawLightInstance(
     remixapi_LightHandle lightHandle) {
     dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
@@ -1048,8 +1390,7 @@ namespace {
     }
 
     // async load
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([lightHandle](dxvk::DxvkContext* ctx) {
+    remixDevice->RTX().QueueExternalCs([lightHandle](dxvk::DxvkContext* ctx) {
       auto& lightMgr = ctx->getCommonObjects()->getSceneManager().getLightManager();
       lightMgr.addExternalLightInstance(lightHandle);
     });
@@ -1143,6 +1484,30 @@ namespace {
     return REMIXAPI_ERROR_CODE_SUCCESS;
   }
 
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_pick_HighlightObjectAtPixel(
+    int32_t pixelX,
+    int32_t pixelY,
+    uint8_t colorR,
+    uint8_t colorG,
+    uint8_t colorB) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    std::lock_guard lock { s_mutex };
+
+    dxvk::g_customHighlightColor = { colorR, colorG, colorB };
+
+    // The object picking value under the pixel is resolved by the highlight pass itself
+    const auto frameId = remixDevice->GetDXVKDevice()->getCurrentFrameId();
+    remixDevice->GetDXVKDevice()->getCommon()->metaDebugView().Highlighting
+      .requestHighlighting(
+        dxvk::Vector2i { pixelX, pixelY },
+        dxvk::HighlightColor::FromVariable,
+        frameId);   // thread-safe
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_dxvk_CreateD3D9(
     const remixapi_StartupInfo& info,
     IDirect3D9Ex** out_pD3D9) {
@@ -1253,6 +1618,30 @@ namespace {
     return REMIXAPI_ERROR_CODE_GENERAL_FAILURE;
   }
 
+  dxvk::Rc<dxvk::DxvkImage> getRenderingOutputImage(
+    const dxvk::Resources::RaytracingOutput& rtOutput,
+    remixapi_dxvk_CopyRenderingOutputType type) {
+#pragma warning(push)
+#pragma warning(error : 4061) // all switch cases must be handled explicitly
+
+    switch (type) {
+    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_FINAL_COLOR:
+      return rtOutput.m_finalOutput.resource(dxvk::Resources::AccessType::Read).image;
+    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_DEPTH:
+      return rtOutput.m_primaryDepth.image;
+    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_NORMALS:
+      return rtOutput.m_primaryWorldShadingNormal.image;
+    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_OBJECT_PICKING:
+      return rtOutput.m_primaryObjectPicking.image;
+    default:
+      break;
+    }
+
+#pragma warning(pop)
+
+    return nullptr;
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_dxvk_CopyRenderingOutput(
     IDirect3DSurface9* destination,
     remixapi_dxvk_CopyRenderingOutputType type) {
@@ -1278,35 +1667,13 @@ namespace {
     }
 
     dxvk::Resources& resourceManager = remixDevice->GetDXVKDevice()->getCommon()->getResources();
-    const dxvk::Resources::RaytracingOutput& rtOutput = resourceManager.getRaytracingOutput();
-
-#pragma warning(push)
-#pragma warning(error : 4061) // all switch cases must be handled explicitly
-
-    dxvk::Rc<dxvk::DxvkImage> srcImage = nullptr;
-    switch (type) {
-    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_FINAL_COLOR:
-      srcImage = rtOutput.m_finalOutput.resource(dxvk::Resources::AccessType::Read).image;
-      break;
-    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_DEPTH:
-      srcImage = rtOutput.m_primaryDepth.image;
-      break;
-    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_NORMALS:
-      srcImage = rtOutput.m_primaryWorldShadingNormal.image;
-      break;
-    case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_OBJECT_PICKING:
-      srcImage = rtOutput.m_primaryObjectPicking.image;
-      break;
-    default:
-      break;
-    }
-
-#pragma warning(pop)
+    const dxvk::Rc<dxvk::DxvkImage> srcImage = getRenderingOutputImage(resourceManager.getRaytracingOutput(), type);
 
     if (srcImage.ptr() == nullptr) {
       return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
     }
 
+    // Emitted right away rather than queued, the copy has to stay in order with the app's own D3D9 commands
     std::lock_guard lock { s_mutex };
     remixDevice->EmitCs([cDest = destTexInfo->GetImage(), cSrc = srcImage](dxvk::DxvkContext* dxvkCtx) {
       auto* ctx = static_cast<dxvk::RtxContext*>(dxvkCtx);
@@ -1327,8 +1694,7 @@ namespace {
       return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
     }
 
-    std::lock_guard lock { s_mutex };
-    remixDevice->EmitCs([type, cColor = *color](dxvk::DxvkContext* ctx) {
+    remixDevice->RTX().QueueExternalCs([type, cColor = *color](dxvk::DxvkContext* ctx) {
       dxvk::RtxGlobals& globals = ctx->getCommonObjects()->getSceneManager().getGlobals();
       switch (type) {
       case REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_FINAL_COLOR:
@@ -1352,6 +1718,194 @@ namespace {
     return REMIXAPI_ERROR_CODE_SUCCESS;
   }
 
+  // Host copy of a rendering output requested with dxvk_RequestReadback. The copy is recorded on the CS
+  // thread, which signals s_readbackFence once the GPU is done with it, so the host only ever polls the fence.
+  struct Readback {
+    enum class State {
+      Pending,  // Not recorded on the CS thread yet
+      Recorded, // Copy is in flight or done, see signalValue
+      Failed,
+    };
+    std::atomic<State> state { State::Pending };
+    uint64_t signalValue = 0;
+    dxvk::Rc<dxvk::DxvkBuffer> buffer;
+    remixapi_ReadbackData data {};
+  };
+
+  // Readback buffers that are free to be reused. Guarded by s_mutex, as is s_readbacks.
+  constexpr size_t kMaxFreeReadbackBuffers = 4;
+  std::vector<dxvk::Rc<dxvk::DxvkBuffer>> s_freeReadbackBuffers;
+  std::unordered_map<remixapi_ReadbackHandle, std::shared_ptr<Readback>> s_readbacks;
+  dxvk::Rc<dxvk::sync::Fence> s_readbackFence = new dxvk::sync::Fence {};
+  // Only touched on the CS thread
+  uint64_t s_readbackSignalValue = 0;
+
+  dxvk::Rc<dxvk::DxvkBuffer> acquireReadbackBuffer(dxvk::DxvkContext* ctx, VkDeviceSize size) {
+    {
+      std::lock_guard lock { s_mutex };
+      auto found = std::find_if(s_freeReadbackBuffers.begin(), s_freeReadbackBuffers.end(),
+                                [size](const dxvk::Rc<dxvk::DxvkBuffer>& buffer) { return buffer->info().size >= size; });
+      if (found != s_freeReadbackBuffers.end()) {
+        dxvk::Rc<dxvk::DxvkBuffer> buffer = std::move(*found);
+        s_freeReadbackBuffers.erase(found);
+        return buffer;
+      }
+    }
+
+    dxvk::DxvkBufferCreateInfo info {};
+    info.size = size;
+    info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT;
+    info.access = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_READ_BIT;
+    const VkMemoryPropertyFlags memType =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+      VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    return ctx->getDevice()->createBuffer(info, memType, dxvk::DxvkMemoryStats::Category::RTXBuffer, "Remix API Readback Buffer");
+  }
+
+  void recordReadback(dxvk::DxvkContext* ctx, remixapi_dxvk_CopyRenderingOutputType type,
+                      const std::optional<remixapi_Rect2D>& region, Readback& readback) {
+    const dxvk::Rc<dxvk::DxvkImage> srcImage =
+      getRenderingOutputImage(ctx->getCommonObjects()->getResources().getRaytracingOutput(), type);
+    if (srcImage.ptr() == nullptr) {
+      readback.state.store(Readback::State::Failed, std::memory_order_release);
+      return;
+    }
+
+    const VkExtent3D extent = srcImage->info().extent;
+    VkOffset3D offset { 0, 0, 0 };
+    VkExtent3D copyExtent { extent.width, extent.height, 1 };
+    if (region) {
+      const int32_t left = std::clamp(region->left, 0, int32_t(extent.width));
+      const int32_t top = std::clamp(region->top, 0, int32_t(extent.height));
+      const int32_t right = std::clamp(region->right, left, int32_t(extent.width));
+      const int32_t bottom = std::clamp(region->bottom, top, int32_t(extent.height));
+      offset = VkOffset3D { left, top, 0 };
+      copyExtent = VkExtent3D { uint32_t(right - left), uint32_t(bottom - top), 1 };
+    }
+    if (copyExtent.width == 0 || copyExtent.height == 0) {
+      readback.state.store(Readback::State::Failed, std::memory_order_release);
+      return;
+    }
+
+    const uint32_t bytesPerPixel = srcImage->formatInfo()->elementSize;
+    readback.buffer = acquireReadbackBuffer(ctx, VkDeviceSize(bytesPerPixel) * copyExtent.width * copyExtent.height);
+
+    VkImageSubresourceLayers subres {};
+    subres.aspectMask = srcImage->formatInfo()->aspectMask & ~VK_IMAGE_ASPECT_STENCIL_BIT;
+    subres.mipLevel = 0;
+    subres.baseArrayLayer = 0;
+    subres.layerCount = 1;
+    ctx->copyImageToBuffer(readback.buffer, 0, bytesPerPixel, bytesPerPixel, srcImage, subres, offset, copyExtent);
+
+    ctx->emitMemoryBarrier(0,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      VK_ACCESS_HOST_READ_BIT);
+
+    readback.signalValue = ++s_readbackSignalValue;
+    ctx->signal(s_readbackFence, readback.signalValue);
+
+    readback.data.data = readback.buffer->mapPtr(0);
+    readback.data.width = copyExtent.width;
+    readback.data.height = copyExtent.height;
+    readback.data.rowPitch = bytesPerPixel * copyExtent.width;
+    readback.data.bytesPerPixel = bytesPerPixel;
+    readback.state.store(Readback::State::Recorded, std::memory_order_release);
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_dxvk_RequestReadback(
+    remixapi_dxvk_CopyRenderingOutputType type,
+    const remixapi_Rect2D* region,
+    remixapi_ReadbackHandle* out_handle) {
+    dxvk::D3D9DeviceEx* remixDevice = tryAsDxvk();
+    if (!remixDevice) {
+      return REMIXAPI_ERROR_CODE_REMIX_DEVICE_WAS_NOT_REGISTERED;
+    }
+    if (!out_handle || type > REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_OBJECT_PICKING) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+
+    if (type == REMIXAPI_DXVK_COPY_RENDERING_OUTPUT_TYPE_OBJECT_PICKING) {
+      // The picking image only exists while it's in use, readbacks fail until it's been rendered
+      dxvk::g_forceKeepObjectPickingImage = true;
+    }
+
+    static std::atomic<uint64_t> s_nextReadbackId = 0;
+    auto handle = reinterpret_cast<remixapi_ReadbackHandle>(++s_nextReadbackId);
+    auto readback = std::make_shared<Readback>();
+    {
+      std::lock_guard lock { s_mutex };
+      s_readbacks[handle] = readback;
+    }
+
+    remixDevice->RTX().QueueExternalCs([type,
+                                        cRegion = region ? std::optional { *region } : std::nullopt,
+                                        cReadback = std::move(readback)](dxvk::DxvkContext* ctx) {
+      recordReadback(ctx, type, cRegion, *cReadback);
+    });
+
+    *out_handle = handle;
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_dxvk_GetReadback(
+    remixapi_ReadbackHandle handle,
+    remixapi_Bool* out_ready,
+    remixapi_ReadbackData* out_data) {
+    if (!handle || !out_ready || !out_data) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    std::shared_ptr<Readback> readback;
+    {
+      std::lock_guard lock { s_mutex };
+      auto found = s_readbacks.find(handle);
+      if (found == s_readbacks.end()) {
+        return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+      }
+      readback = found->second;
+    }
+
+    switch (readback->state.load(std::memory_order_acquire)) {
+    case Readback::State::Failed:
+      return REMIXAPI_ERROR_CODE_GENERAL_FAILURE;
+    case Readback::State::Recorded:
+      if (s_readbackFence->value() >= readback->signalValue) {
+        *out_data = readback->data;
+        *out_ready = true;
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+      }
+      break;
+    default:
+      break;
+    }
+    *out_ready = false;
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
+  remixapi_ErrorCode REMIXAPI_CALL remixapi_dxvk_DestroyReadback(
+    remixapi_ReadbackHandle handle) {
+    if (!handle) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    std::lock_guard lock { s_mutex };
+    auto found = s_readbacks.find(handle);
+    if (found == s_readbacks.end()) {
+      return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+    }
+    const Readback& readback = *found->second;
+    // A buffer the GPU may still write to is dropped instead, the device frees it once the copy has executed
+    const bool bCompleted = readback.state.load(std::memory_order_acquire) == Readback::State::Recorded &&
+                            s_readbackFence->value() >= readback.signalValue;
+    if (bCompleted && s_freeReadbackBuffers.size() < kMaxFreeReadbackBuffers) {
+      s_freeReadbackBuffers.push_back(readback.buffer);
+    }
+    s_readbacks.erase(found);
+    return REMIXAPI_ERROR_CODE_SUCCESS;
+  }
+
   remixapi_ErrorCode REMIXAPI_CALL remixapi_Startup(const remixapi_StartupInfo* info) {
     if (!info || info->sType != REMIXAPI_STRUCT_TYPE_STARTUP_INFO) {
       return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
@@ -1567,8 +2121,21 @@ extern "C"
       interf.pick_HighlightObjects = remixapi_pick_HighlightObjects;
       interf.GetUIState = remixapi_GetUIState;
       interf.SetUIState = remixapi_SetUIState;
-    }
-    static_assert(sizeof(interf) == 184, "Add/remove function registration");
+      interf.DrawInstances = remixapi_DrawInstances;
+      interf.CreateInstance = remixapi_CreateInstance;
+      interf.UpdateInstanceTransform = remixapi_UpdateInstanceTransform;
+      interf.UpdateInstanceMaterial = remixapi_UpdateInstanceMaterial;
+      interf.DestroyInstance = remixapi_DestroyInstance;
+      interf.CreateMeshAsync = remixapi_CreateMeshAsync;
+      interf.IsMeshReady = remixapi_IsMeshReady;
+      interf.UpdateMeshVertices = remixapi_UpdateMeshVertices;
+      interf.UpdateLights = remixapi_UpdateLights;
+      interf.dxvk_RequestReadback = remixapi_dxvk_RequestReadback;
+      interf.dxvk_GetReadback = remixapi_dxvk_GetReadback;
+      interf.dxvk_DestroyReadback = remixapi_dxvk_DestroyReadback;
+      interf.pick_HighlightObjectAtPixel = remixapi_pick_HighlightObjectAtPixel;
+    }
+    static_assert(sizeof(interf) == 288, "Add/remove function registration");
 
     *out_result = interf;
     return REMIXAPI_ERROR_CODE_SUCCESS;
@@ -477,6 +477,10 @@ namespace dxvk
     void createTargetResources(Rc<DxvkContext>& ctx);
 
     void createDownscaledResources(Rc<DxvkContext>& ctx);
+
+    void createHitDistanceResources(Rc<DxvkContext>& ctx);
+
+    static VkFormat getHitDistanceFormat();
   };
 
   // State passed to RtxPass::onFrameBegin() callbacks
@@ -176,6 +176,7 @@ namespace dxvk {
   void DxvkReSTIRGIRayQuery::showImguiSettings() {
     ImGui::Checkbox("Temporal Reuse", &useTemporalReuseObject());
     ImGui::Checkbox("Spatial Reuse", &useSpatialReuseObject());
+    ImGui::Checkbox("Half Resolution Reuse", &useHalfResolutionReuseObject());
     restirGIBiasCorrectionCombo.getKey(&biasCorrectionModeObject());
     ImGui::DragFloat("Pairwise MIS Central Weight", &pairwiseMISCentralWeightObject(), 0.01f, 0.01f, 2.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
     ImGui::Checkbox("Temporal Bias Correction", &useTemporalBiasCorrectionObject());
@@ -306,24 +307,48 @@ namespace dxvk {
     return RtxOptions::useReSTIRGI();
   }
 
-  void DxvkReSTIRGIRayQuery::createDownscaledResource(
-    Rc<DxvkContext>& ctx,
-    const VkExtent3D& downscaledExtent) {
-
-    const Resources::RaytracingOutput& rtOutput = ctx->getCommonObjects()->getResources().getRaytracingOutput();
+  void DxvkReSTIRGIRayQuery::createReservoirBuffer(Rc<DxvkContext>& ctx, const VkExtent3D& downscaledExtent) {
+    auto getReservoirPagePixels = [](uint32_t width, uint32_t height) {
+      const int renderWidthBlocks = (width + RTXDI_RESERVOIR_BLOCK_SIZE - 1) / RTXDI_RESERVOIR_BLOCK_SIZE;
+      const int renderHeightBlocks = (height + RTXDI_RESERVOIR_BLOCK_SIZE - 1) / RTXDI_RESERVOIR_BLOCK_SIZE;
+      return renderWidthBlocks * renderHeightBlocks * RTXDI_RESERVOIR_BLOCK_SIZE * RTXDI_RESERVOIR_BLOCK_SIZE;
+    };
 
-    int numReservoirBuffer = 3;
+    // Initial samples, temporal and spatial reuse pages. With half resolution reuse,
+    // the two reuse pages hold one reservoir per 2x2 pixel block, see ReSTIRGI_ReservoirPositionToPointer().
+    int numReuseReservoirBuffer = 2;
     int reservoirSize = sizeof(ReSTIRGI_PackedReservoir);
-    int renderWidthBlocks = (downscaledExtent.width + RTXDI_RESERVOIR_BLOCK_SIZE - 1) / RTXDI_RESERVOIR_BLOCK_SIZE;
-    int renderHeightBlocks = (downscaledExtent.height + RTXDI_RESERVOIR_BLOCK_SIZE - 1) / RTXDI_RESERVOIR_BLOCK_SIZE;
-    int reservoirBufferPixels = renderWidthBlocks * renderHeightBlocks * RTXDI_RESERVOIR_BLOCK_SIZE * RTXDI_RESERVOIR_BLOCK_SIZE;
+    int reservoirBufferPixels = getReservoirPagePixels(downscaledExtent.width, downscaledExtent.height);
+    int reuseReservoirBufferPixels = m_isHalfResolutionReuse
+      ? getReservoirPagePixels((downscaledExtent.width + 1) / 2, (downscaledExtent.height + 1) / 2)
+      : reservoirBufferPixels;
 
     DxvkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
     bufferInfo.usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
     bufferInfo.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     bufferInfo.access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-    bufferInfo.size = reservoirBufferPixels * numReservoirBuffer * reservoirSize;
+    bufferInfo.size = (reservoirBufferPixels + reuseReservoirBufferPixels * numReuseReservoirBuffer) * reservoirSize;
     m_restirGIReservoirBuffer = ctx->getDevice()->createBuffer(bufferInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Restir GI Reservoir Buffer");
+  }
+
+  void DxvkReSTIRGIRayQuery::onFrameBegin(Rc<DxvkContext>& ctx, const FrameBeginContext& frameBeginCtx) {
+    RtxPass::onFrameBegin(ctx, frameBeginCtx);
+
+    // The reservoir layout depends on the reuse resolution, so the reservoirs are reallocated when it changes
+    if (isActive() && m_restirGIReservoirBuffer != nullptr && m_isHalfResolutionReuse != useHalfResolutionReuse()) {
+      m_isHalfResolutionReuse = useHalfResolutionReuse();
+      createReservoirBuffer(ctx, frameBeginCtx.downscaledExtent);
+    }
+  }
+
+  void DxvkReSTIRGIRayQuery::createDownscaledResource(
+    Rc<DxvkContext>& ctx,
+    const VkExtent3D& downscaledExtent) {
+
+    const Resources::RaytracingOutput& rtOutput = ctx->getCommonObjects()->getResources().getRaytracingOutput();
+
+    m_isHalfResolutionReuse = useHalfResolutionReuse();
+    createReservoirBuffer(ctx, downscaledExtent);
 
     m_restirGIRadiance = Resources::AliasedResource(rtOutput.m_compositeOutput, ctx, downscaledExtent, VK_FORMAT_R16G16B16A16_SFLOAT, "ReSTIR GI Radiance");
     m_restirGIHitGeometry = Resources::createImageResource(ctx, "ReSTIR GI Hit Geometry", downscaledExtent, VK_FORMAT_R32G32B32A32_SFLOAT);
@@ -350,7 +375,11 @@ namespace dxvk {
 
     const uint32_t frameIdx = ctx->getDevice()->getCurrentFrameId();
     const auto& numRaysExtent = rtOutput.m_compositeOutputExtent;
-    VkExtent3D workgroups = util::computeBlockCount(numRaysExtent, VkExtent3D { 16, 8, 1 });
+    // Reuse runs on one pixel per 2x2 block with half resolution reuse, final shading always runs on every pixel
+    const VkExtent3D reuseExtent = m_isHalfResolutionReuse
+      ? VkExtent3D { (numRaysExtent.width + 1) / 2, (numRaysExtent.height + 1) / 2, 1 }
+      : numRaysExtent;
+    VkExtent3D workgroups = util::computeBlockCount(reuseExtent, VkExtent3D { 16, 8, 1 });
 
     ctx->bindCommonRayTracingResources(rtOutput);
 
@@ -80,13 +80,22 @@ namespace dxvk {
 
     static void setToRayReconstructionPreset();
 
+    // Whether the reservoirs of this frame are laid out for half resolution reuse, latched at the beginning of the frame
+    bool isHalfResolutionReuseActive() const { return isActive() && m_isHalfResolutionReuse; }
+
   private:
     virtual bool isEnabled() const override;
     virtual void releaseDownscaledResource() override;
     virtual void createDownscaledResource(Rc<DxvkContext>& ctx, const VkExtent3D& downscaledExtent) override;
+    virtual void onFrameBegin(Rc<DxvkContext>& ctx, const FrameBeginContext& frameBeginCtx) override;
+
+    void createReservoirBuffer(Rc<DxvkContext>& ctx, const VkExtent3D& downscaledExtent);
 
     RTX_OPTION("rtx.restirGI", bool, useTemporalReuse, true, "Enables temporal reuse.");
     RTX_OPTION("rtx.restirGI", bool, useSpatialReuse, true, "Enables spatial reuse.");
+    RTX_OPTION("rtx.restirGI", bool, useHalfResolutionReuse, false,
+               "Runs temporal and spatial reuse on one pixel of every 2x2 pixel block and keeps their reservoirs at half resolution, which cuts the cost of reuse and the reservoir memory.\n"
+               "Final shading picks one of the nearby half resolution reservoirs for every pixel, weighted by depth and normal similarity, and still shades it with the pixel's own material and visibility.");
     RTX_OPTION("rtx.restirGI", bool, useFinalVisibility, true, "Tests visiblity in output.");
 
     // ReSTIR GI cannot work very well on specular surfaces. We need to mix the specular output with its input to improve quality.
@@ -140,6 +149,7 @@ namespace dxvk {
     Resources::AliasedResource m_restirGIRadiance;
     Resources::Resource m_restirGIHitGeometry;
     Rc<DxvkBuffer> m_restirGIReservoirBuffer;
+    bool m_isHalfResolutionReuse = false;
     Resources::Resource m_bsdfFactor2;
 
     // Last composite output is not aliased right now, but created as such AliasedResource for ::matchesWriteFrameIdx() functionality
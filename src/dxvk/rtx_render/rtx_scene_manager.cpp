@@ -19,7 +19,9 @@
 * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 * DEALINGS IN THE SOFTWARE.
 */
+#include <algorithm>
 #include <mutex>
+#include <numeric>
 #include <vector>
 
 #include "rtx_asset_replacer.h"
@@ -39,12 +41,14 @@
 #include "vulkan/vulkan_core.h"
 
 #include "rtx_game_capturer.h"
+#include "rtx_hash_collision_detection.h"
 #include "rtx_matrix_helpers.h"
 #include "rtx_intersection_test.h"
 
 #include "dxvk_scoped_annotation.h"
 #include "rtx_lights_data.h"
 #include "rtx_light_utils.h"
+#include "rtx_nee_cache.h"
 
 namespace dxvk {
   SceneManager::SceneManager(DxvkDevice* device)
@@ -187,13 +191,12 @@ namespace dxvk {
     ScopedCpuProfileZone();
 
     const size_t oldestFrame = m_device->getCurrentFrameId() - RtxOptions::numFramesToKeepGeometryData();
-    auto blasEntryGarbageCollection = [&](auto& iter, auto& entries) -> void {
-      if (iter->second.frameLastTouched < oldestFrame) {
-        onSceneObjectDestroyed(iter->second);
-        iter = entries.erase(iter);
-      } else {
-        ++iter;
+    auto blasEntryGarbageCollection = [&](BlasEntry& blas) -> bool {
+      if (blas.frameLastTouched < oldestFrame) {
+        onSceneObjectDestroyed(blas);
+        return true;
       }
+      return false;
     };
 
     // Garbage collection for BLAS/Scene objects
@@ -201,39 +204,35 @@ namespace dxvk {
     // When anti-culling is enabled, we need to check if any instances are outside frustum. Because in such
     // case the life of the instances will be extended and we need to keep the BLAS as well.
     if (!RtxOptions::AntiCulling::isObjectAntiCullingEnabled()) {
-      auto& entries = m_drawCallCache.getEntries();
       if (m_device->getCurrentFrameId() > RtxOptions::numFramesToKeepGeometryData()) {
-        for (auto iter = entries.begin(); iter != entries.end(); ) {
-          blasEntryGarbageCollection(iter, entries);
-        }
+        m_drawCallCache.eraseIfIncremental(blasEntryGarbageCollection, RtxOptions::numGeometryCacheEntriesToCheckPerFrame());
       }
     }
     else { // Implement anti-culling BLAS/Scene object GC
       fast_unordered_cache<const RtInstance*> outsideFrustumInstancesCache;
 
-      auto& entries = m_drawCallCache.getEntries();
-      for (auto iter = entries.begin(); iter != entries.end();) {
+      // Classify all instances against the frustum planes in one batch up front, the SAT test below only refines
+      // the instances that the batch test could not reject.
+      const bool useHighPrecisionTest = RtxOptions::needsMeshBoundingBox() && RtxOptions::AntiCulling::Object::enableHighPrecisionAntiCulling();
+      const bool isInfFrustum = RtxOptions::AntiCulling::Object::enableInfinityFarFrustum();
+      m_instanceManager.findInstancesInsideFrustum(getCamera(), (useHighPrecisionTest && isInfFrustum) ? PLANES_NO_FAR : PLANES_NUM, m_instancesInsideFrustum);
+
+      m_drawCallCache.eraseIf([&](BlasEntry& blas) -> bool {
         bool isAllInstancesInCurrentBlasInsideFrustum = true;
-        for (const RtInstance* instance : iter->second.getLinkedInstances()) {
-          const Matrix4 objectToView = getCamera().getWorldToView(false) * instance->getTransform();
+        for (const RtInstance* instance : blas.getLinkedInstances()) {
+          const uint32_t instanceVectorId = instance->getInstanceVectorId();
+          assert(instanceVectorId < m_instancesInsideFrustum.size() && m_instanceManager.getInstanceTable()[instanceVectorId] == instance);
 
-          bool isInsideFrustum = true;
-          if (RtxOptions::needsMeshBoundingBox()) {
+          bool isInsideFrustum = m_instancesInsideFrustum[instanceVectorId] != 0;
+          if (isInsideFrustum && useHighPrecisionTest) {
+            const Matrix4 objectToView = getCamera().getWorldToView(false) * instance->getTransform();
             const AxisAlignedBoundingBox& boundingBox = instance->getBlas()->input.getGeometryData().boundingBox;
-            if (RtxOptions::AntiCulling::Object::enableHighPrecisionAntiCulling()) {
-              isInsideFrustum = boundingBoxIntersectsFrustumSAT(
-                getCamera(),
-                boundingBox.minPos,
-                boundingBox.maxPos,
-                objectToView,
-                RtxOptions::AntiCulling::Object::enableInfinityFarFrustum());
-            } else {
-              isInsideFrustum = boundingBoxIntersectsFrustum(getCamera().getFrustum(), boundingBox.minPos, boundingBox.maxPos, objectToView);
-            }
-          }
-          else {
-            // Fallback to check object center under view space
-            isInsideFrustum = getCamera().getFrustum().CheckSphere(float3(objectToView[3][0], objectToView[3][1], objectToView[3][2]), 0);
+            isInsideFrustum = boundingBoxIntersectsFrustumSAT(
+              getCamera(),
+              boundingBox.minPos,
+              boundingBox.maxPos,
+              objectToView,
+              isInfFrustum);
           }
 
           // Only GC the objects inside the frustum to anti-frustum culling, this could cause significant performance impact
@@ -274,11 +273,11 @@ namespace dxvk {
         // If all instances in current BLAS are inside the frustum, then use original GC logic to recycle BLAS Objects
         if (isAllInstancesInCurrentBlasInsideFrustum &&
             m_device->getCurrentFrameId() > RtxOptions::numFramesToKeepGeometryData()) {
-          blasEntryGarbageCollection(iter, entries);
+          return blasEntryGarbageCollection(blas);
         } else { // If any instances are outside of the frustum in current BLAS, we need to keep the entity
-          ++iter;
+          return false;
         }
-      }
+      });
     }
 
     // Perform GC on the other managers
@@ -289,6 +288,10 @@ namespace dxvk {
   }
 
   void SceneManager::onDestroy() {
+    m_externalInstances.clear();
+    m_externalInstanceHandles.clear();
+    m_externalInstanceIndices.clear();
+    m_pReplacer->onDestroy();
     m_accelManager.onDestroy();
     if (m_opacityMicromapManager) {
       m_opacityMicromapManager->onDestroy();
@@ -372,7 +375,7 @@ namespace dxvk {
         info.size = align(output.indexCount * indexStride, CACHE_LINE_SIZE);
         output.indexCacheBuffer = m_device->createBuffer(info, memoryProperty, DxvkMemoryStats::Category::RTXAccelerationStructure, "Index Cache Buffer");
 
-        if (!RtxGeometryUtils::cacheIndexDataOnGPU(ctx, input, output)) {
+        if (!RtxGeometryUtils::cacheIndexDataOnGPU(ctx, input, output, true)) {
           ONCE(Logger::err("processGeometryInfo: failed to cache index data on GPU"));
           return ObjectCacheState::kInvalid;
         }
@@ -382,7 +385,7 @@ namespace dxvk {
         info.size = align(vertexBufferSize, CACHE_LINE_SIZE);
         output.historyBuffer[0] = m_device->createBuffer(info, memoryProperty, DxvkMemoryStats::Category::RTXAccelerationStructure, "Geometry Buffer");
 
-        RtxGeometryUtils::cacheVertexDataOnGPU(ctx, input, output);
+        RtxGeometryUtils::cacheVertexDataOnGPU(ctx, input, output, true);
 
         break;
       }
@@ -405,12 +408,14 @@ namespace dxvk {
         // Use the previous updates vertex data for previous position lookup
         std::swap(output.historyBuffer[0], output.historyBuffer[1]);
 
+        bool isNewBuffer = false;
         if (output.historyBuffer[0].ptr() == nullptr) {
           // First frame this object has been dynamic need to allocate a 2nd frame of data to preserve history.
           output.historyBuffer[0] = m_device->createBuffer(output.historyBuffer[1]->info(), memoryProperty, DxvkMemoryStats::Category::RTXAccelerationStructure, "Geometry Buffer");
+          isNewBuffer = true;
         } 
 
-        RtxGeometryUtils::cacheVertexDataOnGPU(ctx, input, output);
+        RtxGeometryUtils::cacheVertexDataOnGPU(ctx, input, output, isNewBuffer);
 
         // Sometimes, we need to invalidate history, do that here by copying the current buffer to the previous..
         if (invalidateHistory) {
@@ -478,6 +483,8 @@ namespace dxvk {
     if (m_opacityMicromapManager) {
       m_opacityMicromapManager->onFrameEnd();
     }
+
+    m_accelManager.onFrameEnd();
     
     m_activePOMCount = 0;
     m_startInMediumMaterialIndex = BINDING_INDEX_INVALID;
@@ -552,11 +559,20 @@ namespace dxvk {
     }
 
     const XXH64_hash_t activeReplacementHash = input.getHash(RtxOptions::geometryAssetHashRule());
+    if (HashCollisionDetection::shouldCheck(activeReplacementHash, HashSourceDataCategory::Geometry)) {
+      const RasterGeometry& geometryData = input.getGeometryData();
+      GeometryHashSourceData hashSourceData;
+      hashSourceData.vertexCount = geometryData.vertexCount;
+      hashSourceData.indexCount = geometryData.indexCount;
+      hashSourceData.boundingBoxHash = XXH3_64bits(&geometryData.boundingBox, sizeof(geometryData.boundingBox));
+      HashCollisionDetection::registerHashedSourceData(activeReplacementHash, &hashSourceData, HashSourceDataCategory::Geometry);
+    }
     std::vector<AssetReplacement>* pReplacements = m_pReplacer->getReplacementsForMesh(activeReplacementHash);
 
     // TODO (REMIX-656): Remove this once we can transition content to new hash
     if ((RtxOptions::geometryHashGenerationRule() & rules::LegacyAssetHash0) == rules::LegacyAssetHash0) {
-      if (!pReplacements) {
+      // Legacy hashes are not generated while mesh replacements are disabled
+      if (!pReplacements && RtxOptions::getEnableReplacementMeshes()) {
         const XXH64_hash_t legacyHash = input.getHashLegacy(rules::LegacyAssetHash0);
         pReplacements = m_pReplacer->getReplacementsForMesh(legacyHash);
         if (RtxOptions::logLegacyHashReplacementMatches() && pReplacements && uniqueHashes.find(legacyHash) == uniqueHashes.end()) {
@@ -567,7 +583,7 @@ namespace dxvk {
     }
 
     if ((RtxOptions::geometryHashGenerationRule() & rules::LegacyAssetHash1) == rules::LegacyAssetHash1) {
-      if (!pReplacements) {
+      if (!pReplacements && RtxOptions::getEnableReplacementMeshes()) {
         const XXH64_hash_t legacyHash = input.getHashLegacy(rules::LegacyAssetHash1);
         pReplacements = m_pReplacer->getReplacementsForMesh(legacyHash);
         if (RtxOptions::logLegacyHashReplacementMatches() && pReplacements && uniqueHashes.find(legacyHash) == uniqueHashes.end()) {
@@ -679,6 +695,26 @@ namespace dxvk {
     m_lightManager.addLight(rtLight, input, RtLightAntiCullingType::MeshReplacement);
   }
 
+  const MeshReplacement& SceneManager::selectReplacementLod(const MeshReplacement& geometry, const DrawCallTransforms& transforms) const {
+    // Note: All instances of a PointInstancer share one RtInstance, so they can't pick their LODs individually
+    if (geometry.lods.empty() || !geometry.bounds.isValid() || transforms.instancesToObject != nullptr || !RtxOptions::enableReplacementMeshLods()) {
+      return geometry;
+    }
+
+    // Project the bounding sphere of the mesh, relative to the camera that is actually rendered
+    const Matrix4& objectToWorld = transforms.objectToWorld;
+    const float scale = std::max({ length(objectToWorld[0].xyz()), length(objectToWorld[1].xyz()), length(objectToWorld[2].xyz()) });
+    const float radius = length(geometry.bounds.maxPos - geometry.bounds.minPos) * 0.5f * scale;
+    const float distance = length(geometry.bounds.getTransformedCentroid(objectToWorld) - getCamera().getPosition());
+    if (distance <= radius) {
+      return geometry;
+    }
+
+    // Diameter of the projected sphere as a fraction of the viewport height
+    const float screenSize = radius / (distance * std::tan(getCamera().getFov() * 0.5f));
+    return geometry.selectLod(screenSize * RtxOptions::replacementMeshLodBias());
+  }
+
   uint64_t SceneManager::drawReplacements(Rc<DxvkContext> ctx, const DrawCallState* input, const std::vector<AssetReplacement>* pReplacements, const MaterialData* overrideMaterialData) {
     ScopedCpuProfileZone();
     uint64_t rootInstanceId = UINT64_MAX;
@@ -709,7 +745,7 @@ namespace dxvk {
         transforms.texgenMode = TexGenMode::None;
 
         DrawCallState newDrawCallState(*input);
-        newDrawCallState.geometryData = replacement.geometry->data; // Note: Geometry Data replaced
+        newDrawCallState.geometryData = selectReplacementLod(*replacement.geometry, transforms).data; // Note: Geometry Data replaced
         newDrawCallState.transformData = transforms;
         newDrawCallState.categories = replacement.categories.applyCategoryFlags(newDrawCallState.categories);
 
@@ -920,7 +956,7 @@ namespace dxvk {
 
     // Note: Use either the specified override Material Data or the original draw calls state's Material Data to create a Surface Material if no override is specified
     const auto renderMaterialDataType = renderMaterialData.getType();
-    const RtSurfaceMaterial& surfaceMaterial = createSurfaceMaterial(ctx, renderMaterialData, drawCallState);
+    const RtSurfaceMaterial& surfaceMaterial = getCoalescedSurfaceMaterial(ctx, *pBlas, renderMaterialData, drawCallState, usingOverrideMaterial);
     RtInstance* instance = m_instanceManager.processSceneObject(m_cameraManager, m_rayPortalManager, *pBlas, drawCallState, renderMaterialData, surfaceMaterial);
 
     // Check if a light should be created for this Material
@@ -957,6 +993,39 @@ namespace dxvk {
     return instance ? instance->getId() : UINT64_MAX;
   }
 
+  const RtSurfaceMaterial& SceneManager::getCoalescedSurfaceMaterial(Rc<DxvkContext> ctx,
+                                                                      BlasEntry& blas,
+                                                                      const MaterialData& renderMaterialData,
+                                                                      const DrawCallState& drawCallState,
+                                                                      const bool usingOverrideMaterial) {
+    // Props are commonly drawn many times per frame with the same mesh and material, only the transform differs.
+    // Such draws share a BlasEntry, whose input is the first draw of the geometry in the frame, so when the legacy
+    // material (including textures and samplers) matches that one, so does the resulting surface material.
+    // Override materials are created per draw by the caller and are never coalesced.
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+    const LegacyMaterialData& firstMaterial = blas.input.getMaterialData();
+    const LegacyMaterialData& material = drawCallState.getMaterialData();
+    const bool matchesFirstDraw = !usingOverrideMaterial &&
+      firstMaterial.getHash() == material.getHash() &&
+      blas.input.isUsingRaytracedRenderTarget == drawCallState.isUsingRaytracedRenderTarget &&
+      blas.input.hasTextureCoordinates() == drawCallState.hasTextureCoordinates() &&
+      std::memcmp(&firstMaterial, &material, sizeof(LegacyMaterialData)) == 0;
+
+    if (matchesFirstDraw && blas.frameSurfaceMaterialCreated == currentFrame) {
+      return m_surfaceMaterialCache.at(blas.surfaceMaterialIndex);
+    }
+
+    uint32_t index = UINT32_MAX;
+    const RtSurfaceMaterial& surfaceMaterial = createSurfaceMaterial(ctx, renderMaterialData, drawCallState, &index);
+
+    if (matchesFirstDraw && index != UINT32_MAX) {
+      blas.frameSurfaceMaterialCreated = currentFrame;
+      blas.surfaceMaterialIndex = index;
+    }
+
+    return surfaceMaterial;
+  }
+
   const RtSurfaceMaterial& SceneManager::createSurfaceMaterial( Rc<DxvkContext> ctx, 
                                                                 const MaterialData& renderMaterialData,
                                                                 const DrawCallState& drawCallState,
@@ -1407,9 +1476,47 @@ namespace dxvk {
     }
   }
 
+  namespace {
+    // Grows a material buffer geometrically so that a slowly growing material count does not recreate it
+    // every frame. Returns true if the buffer was (re)created and so has to be uploaded in full.
+    bool growMaterialBuffer(DxvkDevice* device, Rc<DxvkBuffer>& buffer, DxvkBufferCreateInfo info, const size_t requiredSize, const char* name) {
+      const VkDeviceSize alignedSize = align(requiredSize, kBufferAlignment);
+      if (buffer != nullptr && alignedSize <= buffer->info().size) {
+        return false;
+      }
+      info.size = buffer == nullptr ? alignedSize : std::max(alignedSize, 2 * buffer->info().size);
+      buffer = device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, name);
+      return true;
+    }
+
+    // Uploads the given elements of a CPU side image of a buffer. Elements close to each other are merged
+    // into a single write, as one larger copy is cheaper than many small ones.
+    void writeDirtyElements(Rc<RtxContext>& ctx, const Rc<DxvkBuffer>& buffer, const std::vector<unsigned char>& data,
+                            std::vector<uint32_t>& dirtyElements, const size_t elementSize) {
+      static constexpr uint32_t kMaxElementGap = 8;
+
+      std::sort(dirtyElements.begin(), dirtyElements.end());
+      const size_t elementCount = data.size() / elementSize;
+
+      size_t i = 0;
+      while (i < dirtyElements.size() && dirtyElements[i] < elementCount) {
+        const uint32_t first = dirtyElements[i];
+        uint32_t last = first;
+        while (++i < dirtyElements.size() && dirtyElements[i] < elementCount && dirtyElements[i] <= last + kMaxElementGap) {
+          last = dirtyElements[i];
+        }
+        const size_t offset = first * elementSize;
+        ctx->writeToBuffer(buffer, offset, (last - first + 1) * elementSize, data.data() + offset);
+      }
+    }
+  } // unnamed
+
   void SceneManager::prepareSceneData(Rc<RtxContext> ctx, DxvkBarrierSet& execBarriers, const float frameTimeMilliseconds) {
     ScopedGpuProfileZone(ctx, "Build Scene");
 
+    // Arbitrate VRAM before any of the budgeted subsystems update their budgets for the frame
+    m_device->getCommon()->getVramBudgetBroker().onFrameStart();
+
     // Needs to happen before garbageCollection to avoid destroying dynamic lights
     m_lightManager.dynamicLightMatching();
 
@@ -1439,7 +1546,11 @@ namespace dxvk {
 
     if (m_cameraManager.isCameraCutThisFrame()) {
       // Ignore camera cut events on teleportation so we don't flush the caches
-      if (!didTeleport) {
+      // Note: A persistent NEE cache refers to the scene's surfaces, so the scene has to be kept as well
+      const bool keepNeeCache = NeeCachePass::enable() && NeeCachePass::persistAcrossCameraCuts();
+      // Note: RtxContext resets the screen space history itself when the world space caches are preserved
+      const bool keepScene = keepNeeCache || RtxOptions::preserveWorldSpaceCachesOnCameraCut();
+      if (!didTeleport && !keepScene) {
         Logger::info(str::format("Camera cut detected on frame ", m_device->getCurrentFrameId()));
         m_enqueueDelayedClear = true;
       }
@@ -1489,37 +1600,63 @@ namespace dxvk {
       if (m_surfaceMaterialCache.getTotalCount() > 0) {
         ScopedGpuProfileZone(ctx, "updateSurfaceMaterials");
         // Note: We duplicate the materials in the buffer so we don't have to do pointer chasing on the GPU (i.e. rather than BLAS->Surface->Material, do, BLAS->Surface, BLAS->Material)
-        size_t surfaceMaterialsGPUSize = m_accelManager.getSurfaceCount() * kSurfaceMaterialGPUSize;
+        const auto& orderedInstances = m_accelManager.getOrderedInstances();
+        uint32_t surfaceCount = orderedInstances.size();
         if (m_startInMediumMaterialIndex_inCache != UINT32_MAX) {
-          surfaceMaterialsGPUSize += kSurfaceMaterialGPUSize;
+          surfaceCount++;
         }
+        const size_t surfaceMaterialsGPUSize = surfaceCount * kSurfaceMaterialGPUSize;
 
-        info.size = align(surfaceMaterialsGPUSize, kBufferAlignment);
         info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        if (m_surfaceMaterialBuffer == nullptr || info.size > m_surfaceMaterialBuffer->info().size) {
-          m_surfaceMaterialBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Surface Material Buffer");
+        const bool recreated = growMaterialBuffer(m_device, m_surfaceMaterialBuffer, info, surfaceMaterialsGPUSize, "Surface Material Buffer");
+
+        // The buffer is laid out in instance order, so a surface is dirty when it now uses a different
+        // material than in the last upload, or when the material in its cache slot has been replaced
+        auto& surfaceMaterialsGPUData = prepareSceneDataFuncState.surfaceMaterialsGPUData;
+        auto& uploadedMaterialIndices = prepareSceneDataFuncState.uploadedSurfaceMaterialIndices;
+        auto& dirtySurfaces = prepareSceneDataFuncState.dirtyElements;
+        // The diffuse layer override is applied when the materials are written rather than stored in them
+        const bool diffuseLayerOverride = getEnableDiffuseLayerOverrideHack();
+        const bool uploadAll = recreated || m_surfaceMaterialCache.areAllSlotsDirty() ||
+                               diffuseLayerOverride != prepareSceneDataFuncState.uploadedDiffuseLayerOverride;
+        prepareSceneDataFuncState.uploadedDiffuseLayerOverride = diffuseLayerOverride;
+
+        auto& dirtySlots = prepareSceneDataFuncState.dirtySlots;
+        dirtySlots.assign(m_surfaceMaterialCache.getTotalCount(), false);
+        for (const uint32_t slot : m_surfaceMaterialCache.getDirtySlots()) {
+          dirtySlots[slot] = true;
         }
 
-        std::size_t dataOffset = 0;
+        surfaceMaterialsGPUData.resize(surfaceMaterialsGPUSize);
+        uploadedMaterialIndices.resize(surfaceCount, UINT32_MAX);
+        dirtySurfaces.clear();
+
+        auto updateSurface = [&](const uint32_t surfaceIndex, const uint32_t materialIndex) {
+          if (!uploadAll && uploadedMaterialIndices[surfaceIndex] == materialIndex && !dirtySlots[materialIndex]) {
+            return;
+          }
+          std::size_t dataOffset = surfaceIndex * kSurfaceMaterialGPUSize;
+          m_surfaceMaterialCache.getObjectTable()[materialIndex].writeGPUData(surfaceMaterialsGPUData.data(), dataOffset, surfaceIndex);
+          uploadedMaterialIndices[surfaceIndex] = materialIndex;
+          dirtySurfaces.push_back(surfaceIndex);
+        };
+
         uint16_t surfaceIndex = 0;
-        std::vector<unsigned char> surfaceMaterialsGPUData(surfaceMaterialsGPUSize);
-        for (auto&& pInstance : m_accelManager.getOrderedInstances()) {
-          auto&& surfaceMaterial = m_surfaceMaterialCache.getObjectTable()[pInstance->surface.surfaceMaterialIndex];
-          surfaceMaterial.writeGPUData(surfaceMaterialsGPUData.data(), dataOffset, surfaceIndex);
+        for (auto&& pInstance : orderedInstances) {
+          updateSurface(surfaceIndex, pInstance->surface.surfaceMaterialIndex);
           surfaceIndex++;
         }
 
         if (m_startInMediumMaterialIndex_inCache != UINT32_MAX) {
-          auto&& surfaceMaterial = m_surfaceMaterialCache.getObjectTable()[m_startInMediumMaterialIndex_inCache];
-          surfaceMaterial.writeGPUData(surfaceMaterialsGPUData.data(), dataOffset, surfaceIndex);
+          updateSurface(surfaceIndex, m_startInMediumMaterialIndex_inCache);
           m_startInMediumMaterialIndex = surfaceIndex;
           surfaceIndex++;
         }
 
-        assert(dataOffset == surfaceMaterialsGPUSize);
-        assert(surfaceMaterialsGPUData.size() == surfaceMaterialsGPUSize);
+        assert(surfaceIndex == surfaceCount);
 
-        ctx->writeToBuffer(m_surfaceMaterialBuffer, 0, surfaceMaterialsGPUData.size(), surfaceMaterialsGPUData.data());
+        writeDirtyElements(ctx, m_surfaceMaterialBuffer, surfaceMaterialsGPUData, dirtySurfaces, kSurfaceMaterialGPUSize);
+        m_surfaceMaterialCache.clearDirtySlots();
       }
 
       // Surface Material Extension Buffer
@@ -1527,25 +1664,28 @@ namespace dxvk {
         ScopedGpuProfileZone(ctx, "updateSurfaceMaterialExtensions");
         const auto surfaceMaterialExtensionsGPUSize = m_surfaceMaterialExtensionCache.getTotalCount() * kSurfaceMaterialGPUSize;
 
-        info.size = align(surfaceMaterialExtensionsGPUSize, kBufferAlignment);
         info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        if (m_surfaceMaterialExtensionBuffer == nullptr || info.size > m_surfaceMaterialExtensionBuffer->info().size) {
-          m_surfaceMaterialExtensionBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Surface Material Extension Buffer");
+        const bool recreated = growMaterialBuffer(m_device, m_surfaceMaterialExtensionBuffer, info, surfaceMaterialExtensionsGPUSize, "Surface Material Extension Buffer");
+
+        // The buffer is an image of the cache's object table, so only its dirty slots need rewriting
+        auto& surfaceMaterialExtensionsGPUData = prepareSceneDataFuncState.surfaceMaterialExtensionsGPUData;
+        auto& dirtyExtensions = prepareSceneDataFuncState.dirtyElements;
+        surfaceMaterialExtensionsGPUData.resize(surfaceMaterialExtensionsGPUSize);
+        if (recreated || m_surfaceMaterialExtensionCache.areAllSlotsDirty()) {
+          dirtyExtensions.resize(m_surfaceMaterialExtensionCache.getTotalCount());
+          std::iota(dirtyExtensions.begin(), dirtyExtensions.end(), 0);
+        } else {
+          dirtyExtensions = m_surfaceMaterialExtensionCache.getDirtySlots();
         }
 
-        std::size_t dataOffset = 0;
-        std::vector<unsigned char> surfaceMaterialExtensionsGPUData(surfaceMaterialExtensionsGPUSize);
-
-        uint16_t surfaceIndex = 0;
-        for (auto&& surfaceMaterialExtension : m_surfaceMaterialExtensionCache.getObjectTable()) {
-          surfaceMaterialExtension.writeGPUData(surfaceMaterialExtensionsGPUData.data(), dataOffset, surfaceIndex);
-          surfaceIndex++;
+        const auto& surfaceMaterialExtensions = m_surfaceMaterialExtensionCache.getObjectTable();
+        for (const uint32_t surfaceIndex : dirtyExtensions) {
+          std::size_t dataOffset = surfaceIndex * kSurfaceMaterialGPUSize;
+          surfaceMaterialExtensions[surfaceIndex].writeGPUData(surfaceMaterialExtensionsGPUData.data(), dataOffset, surfaceIndex);
         }
 
-        assert(dataOffset == surfaceMaterialExtensionsGPUSize);
-        assert(surfaceMaterialExtensionsGPUData.size() == surfaceMaterialExtensionsGPUSize);
-
-        ctx->writeToBuffer(m_surfaceMaterialExtensionBuffer, 0, surfaceMaterialExtensionsGPUData.size(), surfaceMaterialExtensionsGPUData.data());
+        writeDirtyElements(ctx, m_surfaceMaterialExtensionBuffer, surfaceMaterialExtensionsGPUData, dirtyExtensions, kSurfaceMaterialGPUSize);
+        m_surfaceMaterialExtensionCache.clearDirtySlots();
       }
 
       // Volume Material buffer
@@ -1553,23 +1693,27 @@ namespace dxvk {
         ScopedGpuProfileZone(ctx, "updateVolumeMaterials");
         const auto volumeMaterialsGPUSize = m_volumeMaterialCache.getTotalCount() * kVolumeMaterialGPUSize;
 
-        info.size = align(volumeMaterialsGPUSize, kBufferAlignment);
         info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        if (m_volumeMaterialBuffer == nullptr || info.size > m_volumeMaterialBuffer->info().size) {
-          m_volumeMaterialBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXBuffer, "Volume Material Buffer");
+        const bool recreated = growMaterialBuffer(m_device, m_volumeMaterialBuffer, info, volumeMaterialsGPUSize, "Volume Material Buffer");
+
+        auto& volumeMaterialsGPUData = prepareSceneDataFuncState.volumeMaterialsGPUData;
+        auto& dirtyVolumes = prepareSceneDataFuncState.dirtyElements;
+        volumeMaterialsGPUData.resize(volumeMaterialsGPUSize);
+        if (recreated || m_volumeMaterialCache.areAllSlotsDirty()) {
+          dirtyVolumes.resize(m_volumeMaterialCache.getTotalCount());
+          std::iota(dirtyVolumes.begin(), dirtyVolumes.end(), 0);
+        } else {
+          dirtyVolumes = m_volumeMaterialCache.getDirtySlots();
         }
 
-        std::size_t dataOffset = 0;
-        std::vector<unsigned char> volumeMaterialsGPUData(volumeMaterialsGPUSize);
-
-        for (auto&& volumeMaterial : m_volumeMaterialCache.getObjectTable()) {
-          volumeMaterial.writeGPUData(volumeMaterialsGPUData.data(), dataOffset);
+        const auto& volumeMaterials = m_volumeMaterialCache.getObjectTable();
+        for (const uint32_t volumeIndex : dirtyVolumes) {
+          std::size_t dataOffset = volumeIndex * kVolumeMaterialGPUSize;
+          volumeMaterials[volumeIndex].writeGPUData(volumeMaterialsGPUData.data(), dataOffset);
         }
 
-        assert(dataOffset == volumeMaterialsGPUSize);
-        assert(volumeMaterialsGPUData.size() == volumeMaterialsGPUSize);
-
-        ctx->writeToBuffer(m_volumeMaterialBuffer, 0, volumeMaterialsGPUData.size(), volumeMaterialsGPUData.data());
+        writeDirtyElements(ctx, m_volumeMaterialBuffer, volumeMaterialsGPUData, dirtyVolumes, kVolumeMaterialGPUSize);
+        m_volumeMaterialCache.clearDirtySlots();
       }
     }
 
@@ -1589,6 +1733,7 @@ namespace dxvk {
     m_device->statCounters().setCtr(DxvkStatCounter::RtxVolumeMaterialCount, m_volumeMaterialCache.getActiveCount());
     m_device->statCounters().setCtr(DxvkStatCounter::RtxLightCount, m_lightManager.getActiveCount());
     m_device->statCounters().setCtr(DxvkStatCounter::RtxSamplers, m_samplerCache.getActiveCount());
+    m_device->statCounters().setCtr(DxvkStatCounter::RtxHashCollisionCount, HashCollisionDetection::getCollisionCount());
 
     auto capturer = m_device->getCommon()->capturer();
     if (m_device->getCurrentFrameId() == m_beginUsdExportFrameNum) {
@@ -1641,7 +1786,8 @@ namespace dxvk {
       state.drawCall.geometryData = submesh;
       state.drawCall.geometryData.cullMode = state.doubleSided ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
 
-      const MaterialData* material = m_pReplacer->accessExternalMaterial(submesh.externalMaterial);
+      const MaterialData* material = m_pReplacer->accessExternalMaterial(
+        state.materialOverride ? state.materialOverride : submesh.externalMaterial);
       if (material != nullptr) {
         state.drawCall.materialData.setHashOverride(material->getHash());
       }
@@ -1650,6 +1796,63 @@ namespace dxvk {
     }
   }
 
+  void SceneManager::createExternalInstance(remixapi_InstanceHandle handle, ExternalDrawState&& state) {
+    auto [it, inserted] = m_externalInstanceIndices.emplace(handle, (uint32_t) m_externalInstances.size());
+    if (!inserted) {
+      m_externalInstances[it->second] = std::move(state);
+      return;
+    }
+    m_externalInstances.push_back(std::move(state));
+    m_externalInstanceHandles.push_back(handle);
+  }
+
+  ExternalDrawState* SceneManager::findExternalInstance(remixapi_InstanceHandle handle) {
+    auto it = m_externalInstanceIndices.find(handle);
+    if (it == m_externalInstanceIndices.end()) {
+      return nullptr;
+    }
+    return &m_externalInstances[it->second];
+  }
+
+  void SceneManager::updateExternalInstanceTransform(remixapi_InstanceHandle handle, const Matrix4& objectToWorld) {
+    if (ExternalDrawState* instance = findExternalInstance(handle)) {
+      instance->drawCall.transformData.objectToWorld = objectToWorld;
+    }
+  }
+
+  void SceneManager::updateExternalInstanceMaterial(remixapi_InstanceHandle handle, remixapi_MaterialHandle material) {
+    if (ExternalDrawState* instance = findExternalInstance(handle)) {
+      instance->materialOverride = material;
+    }
+  }
+
+  void SceneManager::destroyExternalInstance(remixapi_InstanceHandle handle) {
+    auto it = m_externalInstanceIndices.find(handle);
+    if (it == m_externalInstanceIndices.end()) {
+      return;
+    }
+    const uint32_t index = it->second;
+    m_externalInstanceIndices.erase(it);
+
+    const uint32_t lastIndex = (uint32_t) m_externalInstances.size() - 1;
+    if (index != lastIndex) {
+      m_externalInstances[index] = std::move(m_externalInstances[lastIndex]);
+      m_externalInstanceHandles[index] = m_externalInstanceHandles[lastIndex];
+      m_externalInstanceIndices[m_externalInstanceHandles[index]] = index;
+    }
+    m_externalInstances.pop_back();
+    m_externalInstanceHandles.pop_back();
+  }
+
+  void SceneManager::submitExternalInstances(Rc<DxvkContext> ctx) {
+    ScopedCpuProfileZone();
+    for (const ExternalDrawState& instance : m_externalInstances) {
+      // Submission patches the draw state for the frame's camera and the mesh's surfaces, keep the retained one intact
+      ExternalDrawState state = instance;
+      submitExternalDraw(ctx, std::move(state));
+    }
+  }
+
   namespace {
     bool ifTrue_andThenSetFalse(std::atomic_bool& atomicBool) {
       bool expected = true;
@@ -55,6 +55,7 @@ namespace dxvk
 class DxvkContext;
 class DxvkDevice;
 struct AssetReplacement;
+struct MeshReplacement;
 struct AssetReplacer;
 class OpacityMicromapManager;
 class TerrainBaker;
@@ -106,6 +107,8 @@ struct ExternalDrawState {
   CameraType::Enum cameraType {};
   CategoryFlags categories {};
   bool doubleSided {};
+  // If set, replaces the material of every surface of the mesh
+  remixapi_MaterialHandle materialOverride {};
 };
 
 // Scene manager is a super manager, it's the interface between rendering and world state
@@ -127,6 +130,13 @@ public:
 
   void submitDrawState(Rc<DxvkContext> ctx, const DrawCallState& input, const MaterialData* overrideMaterialData);
   void submitExternalDraw(Rc<DxvkContext> ctx, ExternalDrawState&& state);
+
+  // Retained external instances are drawn every frame by submitExternalInstances until destroyed
+  void createExternalInstance(remixapi_InstanceHandle handle, ExternalDrawState&& state);
+  void updateExternalInstanceTransform(remixapi_InstanceHandle handle, const Matrix4& objectToWorld);
+  void updateExternalInstanceMaterial(remixapi_InstanceHandle handle, remixapi_MaterialHandle material);
+  void destroyExternalInstance(remixapi_InstanceHandle handle);
+  void submitExternalInstances(Rc<DxvkContext> ctx);
   
   bool areAllReplacementsLoaded() const;
   std::vector<Mod::State> getReplacementStates() const;
@@ -239,6 +249,13 @@ private:
   // Consumes a draw call state and updates the scene state accordingly
   uint64_t processDrawCallState(Rc<DxvkContext> ctx, const DrawCallState& blasInput, const MaterialData* replacementMaterialData);
 
+  // Returns the surface material for a draw, reusing the one of an identical earlier draw of the same geometry in this frame
+  const RtSurfaceMaterial& getCoalescedSurfaceMaterial(Rc<DxvkContext> ctx,
+                                                       BlasEntry& blas,
+                                                       const MaterialData& renderMaterialData,
+                                                       const DrawCallState& drawCallState,
+                                                       const bool usingOverrideMaterial);
+
   const RtSurfaceMaterial& createSurfaceMaterial( Rc<DxvkContext> ctx, 
                                                   const MaterialData& renderMaterialData,
                                                   const DrawCallState& drawCallState,
@@ -262,6 +279,7 @@ private:
   void onInstanceDestroyed(RtInstance& instance);
 
   uint64_t drawReplacements(Rc<DxvkContext> ctx, const DrawCallState* input, const std::vector<AssetReplacement>* pReplacements, const MaterialData* overrideMaterialData);
+  const MeshReplacement& selectReplacementLod(const MeshReplacement& geometry, const DrawCallTransforms& transforms) const;
 
   void createEffectLight(Rc<DxvkContext> ctx, const DrawCallState& input, const RtInstance* instance);
 
@@ -280,6 +298,8 @@ private:
   std::unique_ptr<OpacityMicromapManager> m_opacityMicromapManager;
 
   DrawCallCache m_drawCallCache;
+  // Anti-culling frustum test results of the last GC pass, indexed like the instance table
+  std::vector<uint8_t> m_instancesInsideFrustum;
 
   CameraManager m_cameraManager;
 
@@ -297,6 +317,18 @@ private:
   Rc<DxvkBuffer> m_surfaceMaterialExtensionBuffer;
   Rc<DxvkBuffer> m_volumeMaterialBuffer;
 
+  // Persistent containers to reduce frame to frame reallocations in ::prepareSceneData()
+  struct {
+    std::vector<unsigned char> surfaceMaterialsGPUData;
+    std::vector<unsigned char> surfaceMaterialExtensionsGPUData;
+    std::vector<unsigned char> volumeMaterialsGPUData;
+    // Material cache slot each surface of the surface material buffer was last written from
+    std::vector<uint32_t> uploadedSurfaceMaterialIndices;
+    bool uploadedDiffuseLayerOverride = false;
+    std::vector<bool> dirtySlots;
+    std::vector<uint32_t> dirtyElements;
+  } prepareSceneDataFuncState;
+
   uint32_t m_currentFrameIdx = -1;
   bool m_useFixedFrameTime = false;
   std::chrono::time_point<std::chrono::steady_clock> m_startTime;
@@ -319,6 +351,13 @@ private:
   // TODO: expand to many different
   Rc<DxvkSampler> m_externalSampler = nullptr;
 
+  // Dense, so that the per frame submission is a linear walk. Destroying swaps the last instance into the hole.
+  std::vector<ExternalDrawState> m_externalInstances;
+  std::vector<remixapi_InstanceHandle> m_externalInstanceHandles;
+  std::unordered_map<remixapi_InstanceHandle, uint32_t> m_externalInstanceIndices;
+
+  ExternalDrawState* findExternalInstance(remixapi_InstanceHandle handle);
+
   std::atomic_bool m_forceFreeTextureMemory = false;
   std::atomic_bool m_forceFreeUnusedDxvkAllocatorChunks = false;
 
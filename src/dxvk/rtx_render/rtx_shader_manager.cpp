@@ -22,6 +22,7 @@
 #include <cassert>
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <filesystem>
 
 #include "dxvk_device.h"
@@ -429,12 +430,21 @@ namespace dxvk {
 
     m_shaderReloadPhase = ShaderReloadPhase::ShaderRecreation;
 
-    // Recreate all shaders within the shader map from the recompiled SPIR-V binaries
+    // Recreate the shaders within the shader map whose SPIR-V binaries were rewritten with different code
 
     bool allShaderRecreationSuccessful = true;
+    uint32_t numRecreatedShaders = 0;
 
     for (auto& [name, info] : m_shaderMap) {
-      const auto shaderSPIRVBinaryPath = (std::filesystem::path{ spirvBinaryOutputPath } / (std::string { info.m_name } + ".spv")).u8string();
+      const auto shaderSPIRVBinaryPath = std::filesystem::path{ spirvBinaryOutputPath } / (std::string { info.m_name } + ".spv");
+
+      std::error_code writeTimeError;
+      const auto binaryWriteTime = std::filesystem::last_write_time(shaderSPIRVBinaryPath, writeTimeError);
+
+      // Note: Binaries untouched since the last reload were skipped by the compile script, so they cannot have changed.
+      if (!writeTimeError && binaryWriteTime == info.m_binaryWriteTime) {
+        continue;
+      }
 
       bool recreationSuccessful = false;
       std::ifstream file(shaderSPIRVBinaryPath, std::ios::binary);
@@ -443,20 +453,30 @@ namespace dxvk {
         SpirvCodeBuffer code(file);
 
         if (code.size()) {
-          info.m_staticCode = code; // Update the code
-          info.m_shader.emplace_back(createShader(info));
+          info.m_binaryWriteTime = binaryWriteTime;
+
+          // Note: Binaries rewritten with identical code (e.g. from a whitespace change in a shared include) keep their current
+          // shader, so that none of the pipelines using it have to be recompiled.
+          if (code.size() != info.m_staticCode.size() || std::memcmp(code.data(), info.m_staticCode.data(), code.size()) != 0) {
+            info.m_staticCode = code; // Update the code
+            info.m_shader.emplace_back(createShader(info));
+
+            ++numRecreatedShaders;
+          }
 
           recreationSuccessful = true;
         }
       }
 
       if (!recreationSuccessful) {
-        Logger::err(str::format("Failed to recreate a shader from a SPIR-V binary: \"", shaderSPIRVBinaryPath, "\""));
+        Logger::err(str::format("Failed to recreate a shader from a SPIR-V binary: \"", shaderSPIRVBinaryPath.u8string(), "\""));
 
         allShaderRecreationSuccessful = false;
       }
     }
 
+    Logger::info(str::format("Recreated ", numRecreatedShaders, " of ", m_shaderMap.size(), " shaders with changed SPIR-V binaries."));
+
     // Set the reload phase to Idle now that shader recreation is complete, and set the reload status based on if shaders were reloaded successfully
 
     m_lastShaderReloadStatus = allShaderRecreationSuccessful ? ShaderReloadStatus::Success : ShaderReloadStatus::Failure;
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <vector>
+#include <filesystem>
 #include <windows.h>
 
 #include "dxvk_include.h"
@@ -307,6 +308,10 @@ namespace dxvk {
       VkShaderStageFlagBits m_shaderType;
       uint32_t m_interfaceInputs;
       uint32_t m_interfaceOutputs;
+#ifdef REMIX_DEVELOPMENT
+      // Write time of the SPIR-V binary the shader was last recreated from, if any
+      std::filesystem::file_time_type m_binaryWriteTime{};
+#endif
     };
 
     ShaderManager();
@@ -358,6 +363,8 @@ namespace dxvk {
     void terminateSpirVRecompilation();
 
     // Re-creates shaders in the Shader manager based on SPIR-V binaries written to disk by the SPIR-V recompilation process.
+    // The compile script only rebuilds shaders whose sources or includes changed, so only shaders whose binary differs from
+    // the code they currently use are recreated, leaving the pipelines of all other shaders untouched.
     void recreateShaders();
 
     // Tries to finalize the shader reloading process after a request to reload shaders has been submitted via requestReloadShaders. Can either be blocking or
@@ -52,6 +52,11 @@ namespace dxvk
 * 
 *  NOTE: This object does no ref counting - its expected that the user supply T 
    as a ref-counted object if that behavior is desired.
+* 
+*  Slots written by track() or emptied by free() are recorded as dirty until
+*  clearDirtySlots() is called, so that a mirror of the object table (e.g. a GPU
+*  buffer) only needs to update those slots.  After clear(), or once more slots
+*  changed than the table holds, every slot is dirty instead.
 */
 template<typename T, class HashFn, class KeyEqual = std::equal_to<T>>
 struct SparseUniqueCache
@@ -67,6 +72,8 @@ public:
     m_freeBuffers = {};
     m_objects.clear();
     m_bufferMap.clear();
+    m_dirtySlots.clear();
+    m_allSlotsDirty = true;
   }
 
   uint32_t track(const T& obj, std::function<T(const T&)> onFirstCache = [](const T& in) { return in; }) {
@@ -82,6 +89,7 @@ public:
         m_objects.push_back(objectToCache);
       }
       m_bufferMap.insert({ objectToCache, idx });
+      markDirty(idx);
     }
     return idx;
   }
@@ -100,6 +108,7 @@ public:
     if (iter != m_bufferMap.end()) {
       m_objects.at(iter->second) = T();
       m_freeBuffers.push(iter->second);
+      markDirty(iter->second);
       m_bufferMap.erase(iter);
     }
   }
@@ -112,10 +121,34 @@ public:
   const std::vector<T>& getObjectTable() const { return m_objects; }
   std::vector<T>& getObjectTable() { return m_objects; }
 
+  // Slots changed since the last clearDirtySlots() in the order they changed, may contain duplicates
+  const std::vector<uint32_t>& getDirtySlots() const { return m_dirtySlots; }
+  // True if the whole table has to be considered dirty, regardless of getDirtySlots()
+  bool areAllSlotsDirty() const { return m_allSlotsDirty; }
+  void clearDirtySlots() {
+    m_dirtySlots.clear();
+    m_allSlotsDirty = false;
+  }
+
 private:
+  void markDirty(const uint32_t idx) {
+    if (m_allSlotsDirty) {
+      return;
+    }
+    // Caches nobody mirrors never clear their dirty slots, so the list is bounded by the table size
+    if (m_dirtySlots.size() >= m_objects.size()) {
+      m_dirtySlots.clear();
+      m_allSlotsDirty = true;
+      return;
+    }
+    m_dirtySlots.push_back(idx);
+  }
+
   std::queue<uint32_t> m_freeBuffers;
   std::vector<T> m_objects;
   std::unordered_map<T, uint32_t, HashFn, KeyEqual> m_bufferMap;
+  std::vector<uint32_t> m_dirtySlots;
+  bool m_allSlotsDirty = true;
 };
 
 }  // namespace dxvk
@@ -353,6 +353,57 @@ namespace dxvk {
     }
     D3D9SharedPS prevSharedState = *static_cast<D3D9SharedPS*>(rtState.psSharedStateCB->mapPtr(0));
 
+    // Draw calls baked with the same content in the previous frame only need to be baked into the dirty cascades.
+    // Any other draw call is baked into all cascades and invalidates the cascades it overlaps for the next frame
+    uint32_t cascadesToBake = kAllCascadesMask;
+    BakedDrawCall* bakedDrawCall = nullptr;
+
+    if (enableIncrementalBaking()) {
+      const XXH64_hash_t drawCallHash = calculateDrawCallHash(drawCallState, drawParams, replacementMaterial, prevSharedState);
+      const uint32_t cascadeMask = calculateCascadeMask(drawCallState);
+
+      bakedDrawCall = &m_currFrameBakedDrawCalls[drawCallHash];
+      bakedDrawCall->cascadeMask = cascadeMask;
+      bakedDrawCall->count++;
+
+      auto prevBakedDrawCallIter = m_prevFrameBakedDrawCalls.find(drawCallHash);
+      const bool isCached =
+        prevBakedDrawCallIter != m_prevFrameBakedDrawCalls.end() &&
+        bakedDrawCall->count <= prevBakedDrawCallIter->second.count;
+
+      if (isCached) {
+        cascadesToBake = m_dirtyCascadeMask & cascadeMask;
+
+        // Nothing to bake, retain the textures the draw call was baked into last time
+        if (cascadesToBake == 0 && m_bakingParams.numCascades <= 32) {
+          bakedDrawCall->bakedTextureMask = prevBakedDrawCallIter->second.bakedTextureMask;
+
+          for (uint32_t i = 0; i < ReplacementMaterialTextureType::Count; i++) {
+            if ((bakedDrawCall->bakedTextureMask & (1u << i)) != 0 && m_materialTextures[i].texture.isValid()) {
+              m_materialTextures[i].markAsBaked();
+            }
+          }
+
+          // Keep the displacement range stable, it is otherwise gathered when preprocessing the replacement textures
+          if (replacementMaterial != nullptr && Material::bakeSecondaryPBRTextures() &&
+              replacementMaterial->getAlbedoOpacityTexture().isValid() && replacementMaterial->getHeightTexture().isValid()) {
+            m_currFrameMaxDisplaceIn = std::max(m_currFrameMaxDisplaceIn, replacementMaterial->getDisplaceIn());
+            m_currFrameMaxDisplaceOut = std::max(m_currFrameMaxDisplaceOut, replacementMaterial->getDisplaceOut());
+          }
+
+          const bool isBaked = m_materialTextures[ReplacementMaterialTextureType::AlbedoOpacity].isBaked();
+
+          if (isBaked) {
+            updateMaterialData(ctx);
+          }
+
+          return isBaked;
+        }
+      } else {
+        m_nextFrameDirtyCascadeMask |= cascadeMask;
+      }
+    }
+
     const float2 float2CascadeLevelResolution = float2 {
       static_cast<float>(m_bakingParams.cascadeLevelResolution.width),
       static_cast<float>(m_bakingParams.cascadeLevelResolution.height)
@@ -504,6 +555,10 @@ namespace dxvk {
         ctx->bindRenderTargets(terrainRt);
       
         m_materialTextures[textureType].markAsBaked();
+
+        if (bakedDrawCall != nullptr) {
+          bakedDrawCall->bakedTextureMask |= 1u << textureType;
+        }
       }
 
       const Matrix4& world = drawCallState.usesVertexShader ? prevCB.programmablePipeline.normalTransform : prevCB.fixedFunction.World;
@@ -513,6 +568,10 @@ namespace dxvk {
       // The levels are tiled left to right top to bottom in the combined render target texture
       for (uint32_t iCascade = 0; iCascade < m_bakingParams.numCascades; iCascade++) {
 
+        if (!isCascadeInMask(cascadesToBake, iCascade)) {
+          continue;
+        }
+
         Vector2i cascade2DIndex;
         cascade2DIndex.y = iCascade / m_bakingParams.cascadeMapSize.x;
         cascade2DIndex.x = iCascade - cascade2DIndex.y * m_bakingParams.cascadeMapSize.x;
@@ -766,6 +825,7 @@ namespace dxvk {
     {
       ImGui::Checkbox("Use Terrain Bounding Box", &cascadeMap.useTerrainBBOXObject());
       ImGui::Checkbox("Clear Terrain Textures Before Terrain Baking", &clearTerrainBeforeBakingObject());
+      ImGui::Checkbox("Incremental Baking", &enableIncrementalBakingObject());
 
       if (ImGui::CollapsingHeader("Material", collapsingHeaderClosedFlags)) {
         ImGui::Indent();
@@ -810,6 +870,7 @@ namespace dxvk {
         ImGui::DragFloat("Cascade Map's Default Half Width [meters]", &cascadeMap.defaultHalfWidthObject(), 1.f, 0.1f, 10000.f);
         ImGui::DragFloat("Cascade Map's Default Height [meters]", &cascadeMap.defaultHeightObject(), 1.f, 0.1f, 10000.f);
         ImGui::DragFloat("First Cascade Level's Half Width [meters]", &cascadeMap.levelHalfWidthObject(), 1.f, 0.1f, 10000.f);
+        ImGui::DragFloat("Cascade Map Recenter Distance [meters]", &cascadeMap.recenterDistanceObject(), 0.1f, 0.f, 10000.f);
 
         ImGui::DragInt("Max Cascade Levels", &cascadeMap.maxLevelsObject(), 1.f, 1, 16);
         RTX_OPTION_CLAMP(cascadeMap.maxLevels, 1u, 16u);
@@ -857,6 +918,10 @@ namespace dxvk {
       calculateTerrainBBOX(currentFrameIndex);
     }
 
+    if (enableIncrementalBaking() && !debugDisableBaking()) {
+      trackBakedDrawCalls();
+    }
+
     m_hasInitializedMaterialDataThisFrame = false;
 
     for (BakedTexture& texture : m_materialTextures) {
@@ -976,9 +1041,13 @@ namespace dxvk {
 
     updateTextureFormat(dxvkCtxState);
     calculateBakingParameters(ctx, dxvkCtxState);
+    updateDirtyCascades();
+
+    // Clear terrain textures.
+    // Cached cascades are not rebaked, so the clear is skipped when all cascades are cached
+    if (clearTerrainBeforeBaking() && !debugDisableBaking() && m_dirtyCascadeMask != 0) {
+      m_dirtyCascadeMask = kAllCascadesMask;
 
-    // Clear terrain textures
-    if (clearTerrainBeforeBaking() && !debugDisableBaking()) {
       for (uint32_t i = 0; i < ReplacementMaterialTextureType::Count; i++) {
         if (m_materialTextures[i].texture.isValid()) {
           clearMaterialTexture(ctx, static_cast<ReplacementMaterialTextureType::Enum>(i));
@@ -987,6 +1056,130 @@ namespace dxvk {
     }
   }
 
+  XXH64_hash_t TerrainBaker::calculateBakingParametersHash() const {
+    XXH64_hash_t h = XXH64(&m_bakingParams.numCascades, sizeof(m_bakingParams.numCascades), 0);
+    h = XXH64(&m_bakingParams.cascadeMapResolution, sizeof(m_bakingParams.cascadeMapResolution), h);
+    h = XXH64(&m_bakingParams.sceneView, sizeof(m_bakingParams.sceneView), h);
+    h = XXH64(m_bakingParams.bakingCameraOrthoProjection.data(), sizeof(Matrix4) * m_bakingParams.bakingCameraOrthoProjection.size(), h);
+
+    // Baked height values are scaled by these
+    const float displaceInFactor = Material::Properties::displaceInFactor();
+    h = XXH64(&displaceInFactor, sizeof(displaceInFactor), h);
+    h = XXH64(&m_prevFrameMaxDisplaceIn, sizeof(m_prevFrameMaxDisplaceIn), h);
+    h = XXH64(&m_prevFrameMaxDisplaceOut, sizeof(m_prevFrameMaxDisplaceOut), h);
+
+    return h;
+  }
+
+  XXH64_hash_t TerrainBaker::calculateDrawCallHash(const DrawCallState& drawCallState,
+                                                   const DrawParameters& drawParams,
+                                                   const OpaqueMaterialData* replacementMaterial,
+                                                   const D3D9SharedPS& sharedState) const {
+    const LegacyMaterialData& materialData = drawCallState.getMaterialData();
+    const DrawCallTransforms& transformData = drawCallState.getTransformData();
+
+    XXH64_hash_t h = drawCallState.getGeometryData().getHashForRule<rules::FullGeometryHash>();
+    h = XXH64(&transformData.objectToWorld, sizeof(transformData.objectToWorld), h);
+    h = XXH64(&transformData.textureTransform, sizeof(transformData.textureTransform), h);
+    h = XXH64(&drawParams, sizeof(drawParams), h);
+    h = XXH64(&sharedState.Stages[0], sizeof(sharedState.Stages), h);
+
+    // Image views are included so that textures are rebaked when they get promoted to higher resolution
+    auto hashTexture = [&h](const TextureRef& texture) {
+      const XXH64_hash_t imageHash = texture.getImageHash();
+      const DxvkImageView* imageView = texture.getImageView();
+      h = XXH64(&imageHash, sizeof(imageHash), h);
+      h = XXH64(&imageView, sizeof(imageView), h);
+    };
+
+    hashTexture(materialData.getColorTexture());
+    hashTexture(materialData.getColorTexture2());
+
+    if (replacementMaterial != nullptr) {
+      const XXH64_hash_t replacementMaterialHash = replacementMaterial->getHash();
+      h = XXH64(&replacementMaterialHash, sizeof(replacementMaterialHash), h);
+
+      hashTexture(replacementMaterial->getAlbedoOpacityTexture());
+      hashTexture(replacementMaterial->getNormalTexture());
+      hashTexture(replacementMaterial->getTangentTexture());
+      hashTexture(replacementMaterial->getHeightTexture());
+      hashTexture(replacementMaterial->getRoughnessTexture());
+      hashTexture(replacementMaterial->getMetallicTexture());
+      hashTexture(replacementMaterial->getEmissiveColorTexture());
+    }
+
+    return h;
+  }
+
+  uint32_t TerrainBaker::calculateCascadeMask(const DrawCallState& drawCallState) const {
+    const AxisAlignedBoundingBox& aabb = drawCallState.getGeometryData().boundingBox;
+
+    if (!aabb.isValid()) {
+      return kAllCascadesMask;
+    }
+
+    // Find the draw call's footprint in the baking view
+    const Matrix4 objectToBakingView = m_bakingParams.sceneView * drawCallState.getTransformData().objectToWorld;
+    Vector2 minPos = Vector2(FLT_MAX);
+    Vector2 maxPos = Vector2(-FLT_MAX);
+
+    for (uint32_t i = 0; i < 8; i++) {
+      const Vector3 corner = Vector3(
+        (i & 1) ? aabb.maxPos.x : aabb.minPos.x,
+        (i & 2) ? aabb.maxPos.y : aabb.minPos.y,
+        (i & 4) ? aabb.maxPos.z : aabb.minPos.z);
+      const Vector2 position = (objectToBakingView * Vector4(corner, 1.f)).xy();
+
+      minPos = Vector2(std::min(minPos.x, position.x), std::min(minPos.y, position.y));
+      maxPos = Vector2(std::max(maxPos.x, position.x), std::max(maxPos.y, position.y));
+    }
+
+    uint32_t cascadeMask = 0;
+
+    for (uint32_t iCascade = 0; iCascade < std::min(m_bakingParams.numCascades, 32u); iCascade++) {
+      // Cascade ortho projections map <-halfWidth, halfWidth> around the camera to clip space <-1, 1>
+      const float halfWidth = 1.f / std::abs(m_bakingParams.bakingCameraOrthoProjection[iCascade][0][0]);
+
+      if (minPos.x <= halfWidth && maxPos.x >= -halfWidth &&
+          minPos.y <= halfWidth && maxPos.y >= -halfWidth) {
+        cascadeMask |= 1u << iCascade;
+      }
+    }
+
+    return cascadeMask;
+  }
+
+  void TerrainBaker::updateDirtyCascades() {
+    const XXH64_hash_t bakingParamsHash = calculateBakingParametersHash();
+
+    if (!enableIncrementalBaking() ||
+        bakingParamsHash != m_prevBakingParamsHash ||
+        !m_materialTextures[ReplacementMaterialTextureType::AlbedoOpacity].texture.isValid()) {
+      m_dirtyCascadeMask = kAllCascadesMask;
+    } else {
+      m_dirtyCascadeMask = m_nextFrameDirtyCascadeMask;
+    }
+
+    m_prevBakingParamsHash = bakingParamsHash;
+    m_nextFrameDirtyCascadeMask = 0;
+  }
+
+  void TerrainBaker::trackBakedDrawCalls() {
+    // Cascades of draw calls that were removed, or baked fewer times, since the previous frame need to be rebaked.
+    // Added and changed draw calls have already invalidated their cascades when they were baked
+    for (const auto& prevBakedDrawCall : m_prevFrameBakedDrawCalls) {
+      auto currBakedDrawCallIter = m_currFrameBakedDrawCalls.find(prevBakedDrawCall.first);
+
+      if (currBakedDrawCallIter == m_currFrameBakedDrawCalls.end() ||
+          currBakedDrawCallIter->second.count < prevBakedDrawCall.second.count) {
+        m_nextFrameDirtyCascadeMask |= prevBakedDrawCall.second.cascadeMask;
+      }
+    }
+
+    std::swap(m_prevFrameBakedDrawCalls, m_currFrameBakedDrawCalls);
+    m_currFrameBakedDrawCalls.clear();
+  }
+
   void TerrainBaker::registerTerrainMesh(Rc<RtxContext> ctx, const DxvkContextState& dxvkCtxState, const DrawCallState& drawCallState) {
     const uint32_t currentFrameIndex = ctx->getDevice()->getCurrentFrameId();
 
@@ -1029,6 +1222,32 @@ namespace dxvk {
     }
   }
 
+  Vector3 TerrainBaker::calculateCascadeMapCenter(const Vector3& cameraPosition) const {
+    const float metersToWorldUnitScale = RtxOptions::getMeterToWorldUnitScale();
+    const float firstCascadeHalfWidth = metersToWorldUnitScale * cascadeMap.levelHalfWidth();
+
+    if (cascadeMap.recenterDistance() <= 0.f) {
+      return cameraPosition;
+    }
+
+    // Round the grid cell size to whole texels of the first cascade so that the baked texels stay put when the map is recentered.
+    // Keep it within the first cascade so that the camera stays within its footprint
+    const float firstCascadeTexelSize = 2.f * firstCascadeHalfWidth / std::max(cascadeMap.levelResolution(), 1u);
+    const float cellSize = std::max(firstCascadeTexelSize,
+      firstCascadeTexelSize * std::round(std::min(metersToWorldUnitScale * cascadeMap.recenterDistance(), firstCascadeHalfWidth) / firstCascadeTexelSize));
+
+    // Snap the camera position to the grid along the scene axes
+    const Vector3 sceneAxes[3] = { SceneManager::calculateSceneRight(), SceneManager::getSceneForward(), SceneManager::getSceneUp() };
+    Vector3 cascadeMapCenter = cameraPosition;
+
+    for (const Vector3& axis : sceneAxes) {
+      const float position = dot(axis, cameraPosition);
+      cascadeMapCenter += (cellSize * std::floor(position / cellSize + 0.5f) - position) * axis;
+    }
+
+    return cascadeMapCenter;
+  }
+
   void TerrainBaker::calculateBakingParameters(Rc<RtxContext> ctx, const DxvkContextState& dxvkCtxState) {
 
     SceneManager& sceneManager = ctx->getSceneManager();
@@ -1042,6 +1261,9 @@ namespace dxvk {
     const bool terrainBBOXIsValid = m_bakedTerrainBBOX.isValid();
     const float epsilon = 0.01f;      // Epsilon to ensure distances are greater or equal
 
+    // Center of the cascade map, the cascades are laid out around it
+    const Vector3 cascadeMapCenter = calculateCascadeMapCenter(camera.getPosition());
+
     const float terrainHeight =
       terrainBBOXIsValid
       ? SceneManager::worldToSceneOrientedVector(m_bakedTerrainBBOX.maxPos - m_bakedTerrainBBOX.minPos).z
@@ -1049,7 +1271,7 @@ namespace dxvk {
 
     const float cameraRelativeTerrainHeight =
       terrainBBOXIsValid
-      ? SceneManager::worldToSceneOrientedVector(m_bakedTerrainBBOX.maxPos - camera.getPosition()).z
+      ? SceneManager::worldToSceneOrientedVector(m_bakedTerrainBBOX.maxPos - cascadeMapCenter).z
       : metersToWorldUnitScale * cascadeMap.defaultHeight() / 2; // Assume camera is in the middle of terrain's height span
 
     // Constants set to what makes generally should make sense
@@ -1066,8 +1288,8 @@ namespace dxvk {
 
       // Compute bbox relative to the camera
       AxisAlignedBoundingBox cameraRelativeTerrainBBOX = {
-        m_bakedTerrainBBOX.minPos - camera.getPosition() - Vector3{ halfTexelOffset },
-        m_bakedTerrainBBOX.maxPos - camera.getPosition() + Vector3{ halfTexelOffset }
+        m_bakedTerrainBBOX.minPos - cascadeMapCenter - Vector3{ halfTexelOffset },
+        m_bakedTerrainBBOX.maxPos - cascadeMapCenter + Vector3{ halfTexelOffset }
       };
 
       // Convert the bbox to scene space
@@ -1091,8 +1313,8 @@ namespace dxvk {
       // Offset by zNear so that zNear doesn't clip the terrain
       // Offset by epsilon so that it doesn't clip top of the terrain
       const Vector3 bakingCameraPosition = cameraRelativeTerrainHeight >= 0.f
-        ? camera.getPosition() + (cameraRelativeTerrainHeight * (1 + epsilon) + zNear) * up
-        : camera.getPosition() + (cameraRelativeTerrainHeight * (1 - epsilon) - zNear) * up;
+        ? cascadeMapCenter + (cameraRelativeTerrainHeight * (1 + epsilon) + zNear) * up
+        : cascadeMapCenter + (cameraRelativeTerrainHeight * (1 - epsilon) - zNear) * up;
 
       const Vector3 translation = Vector3(
         dot(right, -bakingCameraPosition),
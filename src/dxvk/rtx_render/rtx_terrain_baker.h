@@ -60,6 +60,9 @@ namespace dxvk {
                                                               "Requirement: the baked terrain surfaces must not be placed vertically in the game world. Horizontal surfaces will have the best image quality. Requires \"rtx.zUp\" to be set properly.");
 
     RTX_OPTION("rtx.terrainBaker", bool, clearTerrainBeforeBaking, false, "Performs a clear on the terrain texture before it is baked to in a frame.");
+    RTX_OPTION("rtx.terrainBaker", bool, enableIncrementalBaking, false, "Skips rebaking of terrain draw calls whose geometry, textures, material and transform have not changed since the previous frame.\n"
+                                                                       "Cascades overlapped by a draw call that has been added, changed or removed are rebaked in full on the following frame, and all cascades are rebaked whenever the cascade map's placement or resolution changes.\n"
+                                                                       "Since the cascade map moves with the camera, work is only saved on frames where the camera does not move, or stays within a grid cell when \"rtx.terrainBaker.cascadeMap.recenterDistance\" is set.");
     RTX_OPTION("rtx.terrainBaker", bool, debugDisableBaking , false, "Force disables rebaking every frame. Used for debugging only.")
     RTX_OPTION("rtx.terrainBaker", bool, debugDisableBinding, false, "Force disables binding of the baked terrain texture to the terrain meshes. Used for debugging only.");
 
@@ -124,6 +127,10 @@ namespace dxvk {
       RTX_OPTION("rtx.terrainBaker.cascadeMap", float, levelHalfWidth, 10.f, "First cascade level square's half width around the camera [meters].");
       RTX_OPTION_ENV("rtx.terrainBaker.cascadeMap", uint32_t, maxLevels, 8, "RTX_TERRAIN_BAKER_MAX_CASCADE_LEVELS", "Max number of cascade levels.");
       RTX_OPTION_ENV("rtx.terrainBaker.cascadeMap", uint32_t, levelResolution, 4096, "RTX_TERRAIN_BAKER_LEVEL_RESOLUTION", "Texture resolution per cascade level.");
+      RTX_OPTION("rtx.terrainBaker.cascadeMap", float, recenterDistance, 0.f,
+                 "Size of the grid the cascade map's center is snapped to [meters], rounded to whole texels of the first cascade level and limited to its half width.\n"
+                 "The cascade map is only recentered once the camera moves to another grid cell, rather than every frame the camera moves, so that the baked texels stay put in between.\n"
+                 "Combine with \"rtx.terrainBaker.enableIncrementalBaking\" to skip rebaking while the camera stays within a grid cell. 0 keeps the cascade map centered on the camera.");
       RTX_OPTION("rtx.terrainBaker.cascadeMap", bool, expandLastCascade, true, 
                  "Expands the last cascade's footprint to cover the whole cascade map.\n"
                  "This ensures whole terrain surface has valid baked texture data to sample from\n"
@@ -156,8 +163,14 @@ namespace dxvk {
     void calculateBakingParameters(Rc<RtxContext> ctx, const DxvkContextState& dxvkCtxState);
     void updateTextureFormat(const DxvkContextState& dxvkCtxState);
     void calculateCascadeMapResolution(const Rc<DxvkDevice>& device);
+    Vector3 calculateCascadeMapCenter(const Vector3& cameraPosition) const;
     const RtxMipmap::Resource& getTerrainTexture(Rc<DxvkContext> ctx, RtxTextureManager& textureManager, ReplacementMaterialTextureType::Enum textureType, uint32_t width, uint32_t height);
     void clearMaterialTexture(Rc<DxvkContext> ctx, ReplacementMaterialTextureType::Enum textureType);
+    XXH64_hash_t calculateBakingParametersHash() const;
+    XXH64_hash_t calculateDrawCallHash(const DrawCallState& drawCallState, const DrawParameters& drawParams, const OpaqueMaterialData* replacementMaterial, const D3D9SharedPS& sharedState) const;
+    uint32_t calculateCascadeMask(const DrawCallState& drawCallState) const;
+    void updateDirtyCascades();
+    void trackBakedDrawCalls();
     static bool isPSReplacementSupportEnabled(const DrawCallState& drawCallState);
     VkClearColorValue getClearColor(ReplacementMaterialTextureType::Enum textureType);
 
@@ -247,6 +260,30 @@ namespace dxvk {
 
     BakedTexture m_materialTextures[ReplacementMaterialTextureType::Count];
 
+    // Incremental baking state.
+    // Cascades are tracked in a 32 bit mask, any cascades past that are always considered dirty
+    static constexpr uint32_t kAllCascadesMask = 0xFFFFFFFF;
+
+    static bool isCascadeInMask(uint32_t cascadeMask, uint32_t iCascade) {
+      return iCascade >= 32 || (cascadeMask & (1u << iCascade)) != 0;
+    }
+
+    struct BakedDrawCall {
+      uint32_t cascadeMask = 0;  // Cascades overlapped by the draw call
+      uint32_t count = 0;        // Number of identical draw calls baked in a frame
+      uint32_t bakedTextureMask = 0;  // Material texture types the draw call was baked into
+    };
+
+    // Draw calls baked in the previous and the current frame keyed by their content hash
+    fast_unordered_cache<BakedDrawCall> m_prevFrameBakedDrawCalls;
+    fast_unordered_cache<BakedDrawCall> m_currFrameBakedDrawCalls;
+
+    XXH64_hash_t m_prevBakingParamsHash = kEmptyHash;
+    // Cascades all draw calls have to be baked into in the current frame
+    uint32_t m_dirtyCascadeMask = kAllCascadesMask;
+    // Cascades invalidated by draw call changes, to be rebaked in full on the next baking frame
+    uint32_t m_nextFrameDirtyCascadeMask = kAllCascadesMask;
+
     Rc<DxvkSampler> m_terrainSampler;
   };
 }
\ No newline at end of file
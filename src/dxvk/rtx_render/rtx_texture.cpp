@@ -32,17 +32,17 @@
 namespace dxvk {
 
 #ifdef WITH_RTXIO
-  // Helper to schedule image layer update with RTXIO.
+  // Helper to gather the RTXIO reads of an image layer update.
   // The entire layer mip-chain will be updated with the data starting from
   // the asset assetBaseMip.
-  static uint64_t scheduleImageLayerUpdateRtxIo(
+  static void scheduleImageLayerUpdateRtxIo(
     const Rc<DxvkImage>& image,
     const int            layer,
     const uint32_t       mipLevels_begin,
     const uint32_t       mipLevels_end, // non-inclusive
     const Rc<AssetData>& assetData,
-    RtxIo::Handle        assetFile) {
-    auto& rtxio = RtxIo::get();
+    RtxIo::Handle        assetFile,
+    std::vector<RtxIo::Read>& reads) {
     const auto& assetInfo = assetData->info();
 
     // The number of mip levels in the tail data blob.
@@ -51,8 +51,6 @@ namespace dxvk {
     assert(mipLevels_begin < mipLevels_end);
     assert(mipLevels_end - mipLevels_begin == image->info().mipLevels);
 
-    uint64_t completionSyncpt = 0;
-
     if (assetInfo.compression != AssetCompression::None) {
       RtxIo::FileSource src { assetFile, 0, 0, true };
       RtxIo::ImageDest dst { image, static_cast<uint16_t>(layer), 0, 1 };
@@ -67,7 +65,7 @@ namespace dxvk {
         dst.startMip = n - mipLevels_begin;
         dst.count = isTail ? tailMipLevels : 1;
 
-        completionSyncpt = rtxio.enqueueRead(dst, src);
+        reads.push_back({ dst, src });
 
         if (isTail) {
           break;
@@ -92,10 +90,8 @@ namespace dxvk {
         0, static_cast<uint16_t>(mipLevels_end - mipLevels_begin)
       };
 
-      completionSyncpt = rtxio.enqueueRead(dst, src);
+      reads.push_back({ dst, src });
     }
-
-    return completionSyncpt;
   }
 #endif
 
@@ -108,17 +104,22 @@ namespace dxvk {
     
     RtxIo::Handle file;
     if (rtxio.openFile(texture->assetData->info().filename, &file)) {
-      uint64_t completionSyncpt = 0;
+      // Submit all layers and mips of the texture together, so that the reads
+      // from the same package end up next to each other in the RTXIO queue
+      std::vector<RtxIo::Read> reads;
 
       for (uint32_t layer = 0; layer < dstImage->info().numLayers; layer++) {
-        completionSyncpt = scheduleImageLayerUpdateRtxIo(dstImage->image(),
-                                                         layer,
-                                                         mipLevels_begin,
-                                                         mipLevels_end,
-                                                         texture->assetData,
-                                                         file);
+        scheduleImageLayerUpdateRtxIo(dstImage->image(),
+                                      layer,
+                                      mipLevels_begin,
+                                      mipLevels_end,
+                                      texture->assetData,
+                                      file,
+                                      reads);
       }
 
+      const uint64_t completionSyncpt = rtxio.enqueueReads(reads.data(), static_cast<uint32_t>(reads.size()));
+
       if (completionSyncpt) {
         assert(texture->state == ManagedTexture::State::kQueuedForUpload);
         texture->completionSyncpt = completionSyncpt;
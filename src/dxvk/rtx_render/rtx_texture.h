@@ -74,6 +74,7 @@ namespace dxvk {
     std::atomic_uint8_t m_requestedMips      = 0;
     std::atomic<State>  state                = State::kUnknown;
     uint32_t            frameQueuedForUpload = 0;
+    std::atomic<float>  loadPriority         = 0.f; // higher is picked first by the async loader, refreshed every frame while queued
     uint64_t            completionSyncpt     = 0; // completion syncpoint value
 
     // Texture streaming
@@ -81,6 +82,7 @@ namespace dxvk {
                                                                       // the data structure access simple (i.e. with a linear index, it's just an offset in array)
     mutable uint32_t    frameLastUsed                   = UINT32_MAX;
     mutable uint32_t    frameLastUsedForSamplerFeedback = UINT32_MAX;
+    uint8_t             mipCap                          = MAX_MIPS;   // max mips to request without sampler feedback, lowered by the hard VRAM budget
 
   public:
     bool hasUploadedMips(uint32_t requiredMips, bool exact) const;
@@ -240,6 +242,9 @@ namespace dxvk {
     static Rc<ManagedTexture> createTexture(const Rc<AssetData>& assetData, ColorSpace colorSpace);
   };
 
+  // Clamps a mip count to what the asset has, and to at least the mips it has to be uploaded with
+  uint16_t clampMipCountToAvailable(const Rc<AssetData>& assetData, uint32_t targetMipCount);
+
   void loadTextureRtxIo(const Rc<ManagedTexture>& texture,
                         const Rc<DxvkImageView>& dstImage,
                         const uint32_t mipLevels_begin,
@@ -32,12 +32,17 @@
 #include "rtx_texture.h"
 #include "rtx_io.h"
 #include "rtx_staging_ring.h"
+#include "../../util/util_threadpool.h"
+#include "rtx_thread_budget.h"
 
 namespace dxvk {
 
 
   size_t g_streamedTextures_budgetBytes = 0;
   size_t g_streamedTextures_usedBytes   = 0;
+  // Textures without sampler feedback, and how many of them are held below their full mip chain by the hard budget
+  size_t   g_streamedTextures_noFeedbackUsedBytes     = 0;
+  uint32_t g_streamedTextures_hardBudgetDemotedCount  = 0;
 
 
   static size_t calcTextureMemoryBudget_Megabytes(DxvkDevice* device);
@@ -173,23 +178,15 @@ namespace dxvk {
     }
 
 
-    template<
-      typename Allocator,
-      std::enable_if_t<std::is_same_v<Allocator, RtxStagingRing> || 
-                       std::is_same_v<Allocator, DxvkStagingBuffer>, int> = 0
-    >
-    ReadyToCopy makeStagingForTextureAsset(Allocator& allocator, const Rc<ManagedTexture>& tex) {
+    // Read the asset's mips into an already allocated staging slice.
+    // Doesn't touch the allocator, so can be called on any thread.
+    ReadyToCopy fillStagingForTextureAsset(const DxvkBufferSlice& stagingDst,
+                                           const Rc<ManagedTexture>& tex,
+                                           const std::pair<uint16_t, uint16_t>& mips,
+                                           RtxStagingRing* stagingbuf) {
       ScopedCpuProfileZone();
 
-      const auto [mip_begin, mip_end] = tex->calcRequiredMips_BeginEnd();
-
-      DxvkBufferSlice stagingDst = allocator.alloc(
-        CACHE_LINE_SIZE, 
-        calcSizeForAsset(*tex->assetData, mip_begin, mip_end)
-      );
-      if (!stagingDst.defined()) {
-        return {};
-      }
+      const auto [mip_begin, mip_end] = mips;
 
       auto ready = ReadyToCopy{
         /* .dstTexture = */ tex,
@@ -199,7 +196,7 @@ namespace dxvk {
                                                  mip_end),
         /* .mip_begin  = */ mip_begin,
         /* .mip_end    = */ mip_end,
-        /* .stagingbuf = */ (RtxStagingRing*)(std::is_same_v<Allocator, RtxStagingRing> ? (void*)&allocator : nullptr),
+        /* .stagingbuf = */ stagingbuf,
       };
 
       // Release asset source to keep the number of open file low
@@ -208,6 +205,32 @@ namespace dxvk {
     }
 
 
+    template<
+      typename Allocator,
+      std::enable_if_t<std::is_same_v<Allocator, RtxStagingRing> || 
+                       std::is_same_v<Allocator, DxvkStagingBuffer>, int> = 0
+    >
+    ReadyToCopy makeStagingForTextureAsset(Allocator& allocator, const Rc<ManagedTexture>& tex) {
+      ScopedCpuProfileZone();
+
+      const auto mips = tex->calcRequiredMips_BeginEnd();
+
+      DxvkBufferSlice stagingDst = allocator.alloc(
+        CACHE_LINE_SIZE, 
+        calcSizeForAsset(*tex->assetData, mips.first, mips.second)
+      );
+      if (!stagingDst.defined()) {
+        return {};
+      }
+
+      return fillStagingForTextureAsset(
+        stagingDst,
+        tex,
+        mips,
+        (RtxStagingRing*)(std::is_same_v<Allocator, RtxStagingRing> ? (void*)&allocator : nullptr));
+    }
+
+
     const char* makeDebugTextureName(const char* filename) {
       if (filename) {
         const char* lastSlash     = strrchr(filename, '/');
@@ -363,6 +386,84 @@ namespace dxvk {
     }
 
 
+    // Same as above, but records the copies on the transfer queue like DxvkContext::uploadImage.
+    // Only for freshly allocated images: the whole image is written, and the copies are executed
+    // ahead of everything else in the command list.
+    void copyStagingToDeviceOnTransferQueue(DxvkContext* ctx,
+                                            const RtxTextureManager::UploadBarriers& barriers,
+                                            const ReadyToCopy& ready) {
+      Rc<DxvkCommandList> cmd = ctx->getCommandList();
+      const Rc<DxvkDevice>& device = ctx->getDevice();
+
+      const Rc<DxvkImage>& image = ready.dstTexture->m_currentMipView->image();
+      assert(image->info().layout == VK_IMAGE_LAYOUT_UNDEFINED);
+
+      // The transfer queue does the layout transition out of UNDEFINED, the graphics queue acquires
+      // the image straight into the layout it is sampled in
+      image->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+      const VkImageSubresourceRange subresourceRange = image->getAvailableSubresources();
+      const VkImageLayout imageLayoutTransfer = image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+      barriers.sdmaAcquires.accessImage(
+        image,
+        subresourceRange,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        imageLayoutTransfer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT);
+
+      barriers.sdmaAcquires.recordCommands(cmd);
+
+      for (const ReadyToCopyMip& level : ready.mips) {
+        const auto stagingHandle = level.srcBuffer.getSliceHandle();
+
+        VkBufferImageCopy region;
+        {
+          region.bufferOffset = stagingHandle.offset;
+          region.bufferRowLength = 0;
+          region.bufferImageHeight = 0;
+          region.imageSubresource = VkImageSubresourceLayers{
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            level.mipLevel,
+            0,
+            image->info().numLayers,
+          };
+          region.imageOffset = { 0, 0, 0 };
+          region.imageExtent = level.mipExtent;
+        }
+
+        cmd->cmdCopyBufferToImage(
+          DxvkCmdBuffer::SdmaBuffer,
+          stagingHandle.handle,
+          image->handle(),
+          imageLayoutTransfer,
+          1,
+          &region);
+
+        cmd->trackResource<DxvkAccess::Read>(level.srcBuffer.buffer());
+      }
+
+      // Transfer ownership to the graphics queue
+      barriers.sdmaBarriers.releaseImage(
+        barriers.initBarriers,
+        image,
+        subresourceRange,
+        device->queues().transfer.queueFamily,
+        imageLayoutTransfer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        device->queues().graphics.queueFamily,
+        image->info().layout,
+        image->info().stages,
+        image->info().access);
+
+      cmd->trackResource<DxvkAccess::Write>(ready.dstTexture->m_currentMipView);
+    }
+
+
     void flushRtxIo(bool async) {
 #ifdef WITH_RTXIO
       if (RtxIo::enabled()) {
@@ -395,6 +496,38 @@ namespace dxvk {
     struct RcHasher { size_t operator()(const Rc<ManagedTexture>& s) const { return (size_t)s.ptr(); } };
 
 
+    // Takes the queued texture with the highest load priority out of the set,
+    // or the first one if the prioritization is disabled
+    Rc<ManagedTexture> popHighestPriority(std::unordered_set<Rc<ManagedTexture>, RcHasher>& textures) {
+      assert(!textures.empty());
+      auto best = textures.begin();
+      if (RtxOptions::TextureManager::prioritizeLoadQueue()) {
+        for (auto it = std::next(best); it != textures.end(); ++it) {
+          if ((*it)->loadPriority.load(std::memory_order_relaxed) > (*best)->loadPriority.load(std::memory_order_relaxed)) {
+            best = it;
+          }
+        }
+      }
+      Rc<ManagedTexture> tex = std::move(*best);
+      textures.erase(best);
+      return tex;
+    }
+
+
+    // A queued texture whose request changed back to what is already in VRAM, e.g. after the camera moved away
+    // and back, doesn't need its load anymore
+    bool tryCancelQueuedLoad(const Rc<ManagedTexture>& tex) {
+      if (tex->state != ManagedTexture::State::kQueuedForUpload || !tex->m_currentMipView.ptr()) {
+        return false;
+      }
+      if (!tex->hasUploadedMips(tex->m_requestedMips, true)) {
+        return false;
+      }
+      tex->state = ManagedTexture::State::kVidMem;
+      return true;
+    }
+
+
     constexpr size_t Megabytes = 1024 * 1024;
 
   } // unnamed namespace
@@ -403,12 +536,16 @@ namespace dxvk {
   // AsyncRunner begin
 
 
-  // Spawns a low-priority thread that loads files, allocates the staging memory for them with a fixed-size allocator,
-  // and returns ready-to-copy mip-chains to the Vulkan thread.
+  // Spawns a low-priority thread that allocates the staging memory for textures with a fixed-size allocator,
+  // loads the files into it, and returns ready-to-copy mip-chains to the Vulkan thread.
   // Enforces strong limits on allocator and amount of textures sent to Vulkan thread, to avoid stutter.
+  // With more than one loader thread, the file reads and the copies into the staging memory are handed
+  // to a worker pool, while the allocations stay ordered on the async thread.
   struct AsyncRunner {
 
     static constexpr uint32_t MAX_TEXTURE_UPLOADS_PER_FRAME = 32;
+    // Loads in flight are limited by MAX_TEXTURE_UPLOADS_PER_FRAME, so the pool's queues never fill up
+    using LoaderPool = WorkerThreadPool<MAX_TEXTURE_UPLOADS_PER_FRAME * 2, true, false>;
 
     explicit AsyncRunner(const Rc<DxvkDevice>& device)
       : m_ringbuf{ device, stagingBufferSize_Bytes() }
@@ -416,6 +553,12 @@ namespace dxvk {
       , m_thread{ dxvk::thread{ [this] { this->asyncLoop(); } } }
     {
       m_thread.set_priority(ThreadPriority::Lowest);
+
+      const uint32_t numLoaderThreads = RtxOptions::TextureManager::numLoaderThreads();
+      if (numLoaderThreads > 1) {
+        m_loaderPool = std::make_unique<LoaderPool>(uint8_t(std::min(RtxThreadBudget::getThreadCount(ThreadClass::Streaming, numLoaderThreads), 255u)), "rtx-texture-loader",
+                                                    RtxThreadBudget::getPriority(ThreadClass::Streaming));
+      }
     }
 
     ~AsyncRunner() {
@@ -439,6 +582,7 @@ namespace dxvk {
 
   private:
     void asyncLoop(); // boilerplate
+    void load(const Rc<ManagedTexture>& tex, const DxvkBufferSlice& stagingDst, const std::pair<uint16_t, uint16_t>& mips);
 
   private:
     // has a limited budget, returns nothing if fails
@@ -457,6 +601,10 @@ namespace dxvk {
     dxvk::mutex               m_readyTextures_mutex;
     dxvk::condition_variable  m_readyTextures_cond;
     std::vector<ReadyToCopy>  m_readyTextures;
+    uint32_t                  m_loadsInFlight = 0; // guarded by m_readyTextures_mutex
+
+    // Declared last, so that the workers are joined before anything they use is destroyed
+    std::unique_ptr<LoaderPool> m_loaderPool;
   };
 
 
@@ -510,33 +658,40 @@ namespace dxvk {
           }
 
           if (!m_texturesToProcess.empty()) {
-            itemToProcess = std::move(*m_texturesToProcess.begin());
-            m_texturesToProcess.erase(m_texturesToProcess.begin());
+            itemToProcess = popHighestPriority(m_texturesToProcess);
           }
         }
 
-        if (!itemToProcess.ptr()) {
+        if (!itemToProcess.ptr() || tryCancelQueuedLoad(itemToProcess)) {
           continue;
         }
 
         // wait a bit, to not over-commit texture uploads in a single frame
         {
           auto l = std::unique_lock{ m_readyTextures_mutex };
-          m_readyTextures_cond.wait(l, [this]() { return m_readyTextures.size() < MAX_TEXTURE_UPLOADS_PER_FRAME; });
+          m_readyTextures_cond.wait(l, [this]() { return m_readyTextures.size() + m_loadsInFlight < MAX_TEXTURE_UPLOADS_PER_FRAME; });
+          ++m_loadsInFlight;
         }
 
-        ReadyToCopy ready = makeStagingForTextureAsset(m_ringbuf, itemToProcess);
+        const auto mips = itemToProcess->calcRequiredMips_BeginEnd();
+        const size_t stagingSize = calcSizeForAsset(*itemToProcess->assetData, mips.first, mips.second);
+
+        DxvkBufferSlice stagingDst = m_ringbuf.alloc(CACHE_LINE_SIZE, stagingSize);
 
-        while (!ready.dstTexture.ptr()) {
+        while (!stagingDst.defined()) {
           // alloc failed, retry after wait
           _mm_pause();
 
-          ready = makeStagingForTextureAsset(m_ringbuf, itemToProcess);
+          stagingDst = m_ringbuf.alloc(CACHE_LINE_SIZE, stagingSize);
         }
 
-        {
-          auto l = std::unique_lock{ m_readyTextures_mutex };
-          m_readyTextures.push_back(std::move(ready));
+        // The ring can't reset while the slice is held, so it's safe to fill it on a worker
+        if (m_loaderPool) {
+          m_loaderPool->Schedule([this, tex = std::move(itemToProcess), stagingDst, mips]() {
+            load(tex, stagingDst, mips);
+          });
+        } else {
+          load(itemToProcess, stagingDst, mips);
         }
       }
     } catch (const DxvkError& e) {
@@ -546,6 +701,23 @@ namespace dxvk {
   }
 
 
+  void AsyncRunner::load(const Rc<ManagedTexture>& tex, const DxvkBufferSlice& stagingDst, const std::pair<uint16_t, uint16_t>& mips) {
+    ReadyToCopy ready{};
+    try {
+      ready = fillStagingForTextureAsset(stagingDst, tex, mips, &m_ringbuf);
+    } catch (const DxvkError& e) {
+      Logger::err(str::format("Exception while loading a texture on an async thread!"));
+      Logger::err(e.message());
+      // Still hand the slice over, so that the staging ring can be reset
+      ready = ReadyToCopy{ tex, {}, mips.first, mips.second, &m_ringbuf };
+    }
+
+    auto l = std::unique_lock{ m_readyTextures_mutex };
+    m_readyTextures.push_back(std::move(ready));
+    --m_loadsInFlight;
+  }
+
+
   // AsyncRunner end
 
 
@@ -641,12 +813,15 @@ namespace dxvk {
             }
 
             if (!m_texturesToProcess.empty()) {
-              itemToProcess = std::move(*m_texturesToProcess.begin());
-              m_texturesToProcess.erase(m_texturesToProcess.begin());
+              itemToProcess = popHighestPriority(m_texturesToProcess);
               m_texturesToProcess_count = uint32_t(m_texturesToProcess.size());
             }
           }
 
+          if (!itemToProcess.ptr() || tryCancelQueuedLoad(itemToProcess)) {
+            continue;
+          }
+
           const auto [mip_begin, mip_end] = itemToProcess->calcRequiredMips_BeginEnd();
           auto rtxioDst = allocDeviceImage(m_device.ptr(),
                                            itemToProcess->assetData,
@@ -759,6 +934,16 @@ namespace dxvk {
 
       return (2.0f * mip_weight) + (1.0f * fr_weight);
     }
+
+    // Textures that wait in the async queue gain priority over time, so that
+    // a steady stream of high-weight requests can't starve the rest:
+    // after ~60 frames, a texture outweighs any fresh request
+    constexpr float kLoadPriorityPerQueuedFrame = 0.05f;
+
+    float calcLoadPriority(float weight, uint32_t frameQueued, uint32_t curframe) {
+      const uint32_t framesQueued = (curframe >= frameQueued) ? curframe - frameQueued : 0;
+      return weight + kLoadPriorityPerQueuedFrame * float(framesQueued);
+    }
   } // unnamed namespace
 
 
@@ -782,6 +967,21 @@ namespace dxvk {
 
     static_assert(SAMPLER_FEEDBACK_INVALID == UINT16_MAX, "must be 0xFF for memset");
     memset(m_sf.m_related, 0xFF, SAMPLER_FEEDBACK_MAX_TEXTURE_COUNT * SAMPLER_FEEDBACK_RELATED_PER_TEX * sizeof(m_sf.m_related[0]));
+
+    // Demoting textures is visible, so they are the last to give up memory.
+    // Only streamed textures can give it up, and a fixed budget is left as configured
+    VramBudgetBroker::ConsumerDesc vramBudgetConsumer;
+    vramBudgetConsumer.priority = 2;
+    vramBudgetConsumer.reclaim = [this](VkDeviceSize size) -> VkDeviceSize {
+      if (RtxOptions::TextureManager::fixedBudgetEnable()) {
+        return 0;
+      }
+      const size_t reclaimableBytes = g_streamedTextures_usedBytes - std::min(m_budgetBytesToReclaim, g_streamedTextures_usedBytes);
+      const size_t bytesToReclaim = std::min(static_cast<size_t>(size), reclaimableBytes);
+      m_budgetBytesToReclaim += bytesToReclaim;
+      return bytesToReclaim;
+    };
+    pDevice->getCommon()->getVramBudgetBroker().registerConsumer(VramBudgetBroker::Consumer::Textures, vramBudgetConsumer);
   }
 
   void RtxTextureManager::startAsync() {
@@ -793,6 +993,8 @@ namespace dxvk {
   }
 
   RtxTextureManager::~RtxTextureManager() {
+    m_device->getCommon()->getVramBudgetBroker().unregisterConsumer(VramBudgetBroker::Consumer::Textures);
+
     delete m_sf.m_cachedGpubuf;
     delete m_sf.m_cachedAssetMipcount;
     delete m_sf.m_accumulatedMipcount;
@@ -811,14 +1013,18 @@ namespace dxvk {
     return tex->state;
   }
 
-  void RtxTextureManager::scheduleTextureLoad(const Rc<ManagedTexture>& texture, bool async) {
+  void RtxTextureManager::scheduleTextureLoad(const Rc<ManagedTexture>& texture, bool async, float priority) {
     if (!texture.ptr()) {
       return;
     }
 
+    const auto curframe = m_device->getCurrentFrameId();
+
     const auto managedState = processManagedTextureState(texture.ptr());
     if (managedState == ManagedTexture::State::kQueuedForUpload) {
-      // Texture is in the async thread processing queue, leave it
+      // Texture is in the async thread processing queue, leave it, but reprioritize
+      // as the camera moves, the async thread picks up the latest requested mips anyway
+      texture->loadPriority.store(calcLoadPriority(priority, texture->frameQueuedForUpload, curframe), std::memory_order_relaxed);
       return;
     }
     if (managedState == ManagedTexture::State::kVidMem) {
@@ -833,7 +1039,8 @@ namespace dxvk {
     }
 
     texture->state = ManagedTexture::State::kQueuedForUpload;
-    texture->frameQueuedForUpload = m_device->getCurrentFrameId();
+    texture->frameQueuedForUpload = curframe;
+    texture->loadPriority.store(priority, std::memory_order_relaxed);
     if (m_asyncThread) {
       m_asyncThread->queueAdd(texture, async);
     } else if (m_asyncThread_rtxio) {
@@ -844,11 +1051,13 @@ namespace dxvk {
   }
 
   void RtxTextureManager::submitTexturesToDeviceLocal(DxvkContext* ctx,
-                                                      DxvkBarrierSet& execBarriers,
-                                                      DxvkBarrierSet& execAcquires) {
+                                                      const UploadBarriers& barriers) {
     ScopedCpuProfileZoneN("Textures: upload to device");
 
     if (m_asyncThread) {
+      const bool useTransferQueue =
+        RtxOptions::TextureManager::uploadOnTransferQueue() && m_device->hasDedicatedTransferQueue();
+
       for (const ReadyToCopy& ready : m_asyncThread->retrieveReadyToUploadTextures()) {
         const Rc<ManagedTexture>& tex = ready.dstTexture;
 
@@ -860,12 +1069,17 @@ namespace dxvk {
         tex->m_currentMip_begin = ready.mip_begin;
         tex->m_currentMip_end   = ready.mip_end;
 
-        copyStagingToDevice(ctx, execBarriers, execAcquires, ready);
+        if (useTransferQueue) {
+          copyStagingToDeviceOnTransferQueue(ctx, barriers, ready);
+        } else {
+          copyStagingToDevice(ctx, barriers.execBarriers, barriers.execAcquires, ready);
+        }
         if (ready.stagingbuf) {
           ready.stagingbuf->onSliceSubmitToCmd();
         }
 
         tex->state = ManagedTexture::State::kVidMem;
+        ++m_uploadedTextureCount;
       }
     } else if (m_asyncThread_rtxio) {
       m_asyncThread_rtxio->syncPoint(RtxOptions::alwaysWaitForAsyncTextures());
@@ -1119,15 +1333,28 @@ namespace dxvk {
     }
 
 
+    const size_t hardBudgetBytes = size_t(std::max(RtxOptions::TextureManager::hardBudgetMiB(), 0)) * Megabytes;
+
     // For no-sampler-feedback textures, don't use the prioritization and budgeting (for now),
-    // as we can't predict how draw call textures (sky, terrain, etc) are used
+    // as we can't predict how draw call textures (sky, terrain, etc) are used.
+    // Only the hard budget applies to them, see limitTexturesWithoutFeedback.
+    static auto keptlist = std::vector<ManagedTexture*>{};
+    keptlist.clear();
     for (ManagedTexture* tex : checkonlyframes) {
       assert(tex && tex->canDemote);
-      tex->requestMips(
-        (tex->frameLastUsed != UINT32_MAX) && (curframe - tex->frameLastUsed <= numFramesToKeepMaterialTextures)
-        ? MAX_MIPS
-        : 0);
-      scheduleTextureLoad(tex, true);
+      const bool keep = (tex->frameLastUsed != UINT32_MAX) && (curframe - tex->frameLastUsed <= numFramesToKeepMaterialTextures);
+      if (keep) {
+        keptlist.push_back(tex);
+      } else {
+        tex->requestMips(0);
+        scheduleTextureLoad(tex, true, 0.0f);
+      }
+    }
+
+    const size_t noFeedbackUsedBytes = limitTexturesWithoutFeedback(keptlist, hardBudgetBytes, curframe);
+    for (ManagedTexture* tex : keptlist) {
+      // No feedback to score by, rank as a texture that was seen recently at an unknown resolution
+      scheduleTextureLoad(tex, true, 1.0f);
     }
 
     
@@ -1147,7 +1374,22 @@ namespace dxvk {
       std::sort(prioritylist.begin(), prioritylist.end(), l_sort);
     }
     {
-      const size_t budgetBytes = calcTextureMemoryBudget_Megabytes(m_device) * Megabytes;
+      size_t budgetBytes = calcTextureMemoryBudget_Megabytes(m_device) * Megabytes;
+
+      // Give up what the VRAM budget broker reclaimed and don't grow back into it while the broker holds textures back
+      if (m_budgetBytesToReclaim > 0) {
+        budgetBytes = std::min(budgetBytes, g_streamedTextures_usedBytes - std::min(m_budgetBytesToReclaim, g_streamedTextures_usedBytes));
+        m_budgetBytesToReclaim = 0;
+      } else if (m_prevBudgetBytes > 0 && !m_device->getCommon()->getVramBudgetBroker().canGrow(VramBudgetBroker::Consumer::Textures)) {
+        budgetBytes = std::min(budgetBytes, m_prevBudgetBytes);
+      }
+
+      // The textures without feedback take their share of the hard budget first
+      if (hardBudgetBytes > 0) {
+        budgetBytes = std::min(budgetBytes, hardBudgetBytes - std::min(noFeedbackUsedBytes, hardBudgetBytes));
+      }
+      m_prevBudgetBytes = budgetBytes;
+
       size_t       usedBytes   = 0;
       for (ManagedTexture* tex : prioritylist) {
         assert(tex && tex->canDemote && tex->samplerFeedbackStamp != SAMPLER_FEEDBACK_INVALID);
@@ -1165,12 +1407,29 @@ namespace dxvk {
           usedBytes += byteSize;
           tex->requestMips(mipc);
         } else {
-          // doesn't fit => demote
-          tex->requestMips(0);
+          // doesn't fit => demote, dropping only as many of the top mips as needed to fit into what's left of the budget
+          // rather than the whole texture, every mip dropped cuts its size by ~4x
+          uint32_t fittingMipc = mipc > 0 ? mipc - 1 : 0;
+          while (fittingMipc > 1) {
+            byteSize = calcSizeForAsset(*tex->assetData, allmipcount - fittingMipc, allmipcount);
+            if (usedBytes + byteSize <= budgetBytes) {
+              break;
+            }
+            --fittingMipc;
+          }
+
+          if (fittingMipc > 1) {
+            usedBytes += byteSize;
+            tex->requestMips(fittingMipc);
+          } else {
+            tex->requestMips(0);
+          }
           m_wasTextureBudgetPressure = true;
         }
 
-        scheduleTextureLoad(tex, true);
+        // Sampler feedback mip count is driven by the texture's on-screen footprint,
+        // so the nearby and large-on-screen textures get to the front of the async queue
+        scheduleTextureLoad(tex, true, calcResolutionAndHistoryWeightForTexture(m_sf.m_accumulatedMipcount[tex->samplerFeedbackStamp], curframe));
       }
       assert(usedBytes <= budgetBytes);
 
@@ -1180,6 +1439,119 @@ namespace dxvk {
     }
   }
 
+  size_t RtxTextureManager::limitTexturesWithoutFeedback(const std::vector<ManagedTexture*>& textures, size_t hardBudgetBytes, uint32_t curframe) {
+    auto l_calcRequestedSize = [](const ManagedTexture* tex) {
+      const auto [mip_begin, mip_end] = tex->calcRequiredMips_BeginEnd();
+      return calcSizeForAsset(*tex->assetData, mip_begin, mip_end);
+    };
+    auto l_effectiveMipCap = [](const ManagedTexture* tex) {
+      return uint32_t(clampMipCountToAvailable(tex->assetData, tex->mipCap));
+    };
+
+    size_t usedBytes = 0;
+    for (ManagedTexture* tex : textures) {
+      if (hardBudgetBytes == 0) {
+        tex->mipCap = MAX_MIPS;
+      }
+      tex->requestMips(tex->mipCap);
+      usedBytes += l_calcRequestedSize(tex);
+    }
+
+    uint32_t demotedCount = 0;
+    if (hardBudgetBytes > 0) {
+      // Least recently used first
+      static auto lru = std::vector<ManagedTexture*>{};
+      lru.assign(textures.begin(), textures.end());
+      std::sort(lru.begin(), lru.end(), [](const ManagedTexture* a, const ManagedTexture* b) {
+        return a->frameLastUsed < b->frameLastUsed;
+      });
+
+      if (usedBytes > hardBudgetBytes) {
+        // Over the budget => drop one mip of the least recently used textures per frame,
+        // until what's left fits, so that the demotion is spread over a few frames
+        for (ManagedTexture* tex : lru) {
+          if (usedBytes <= hardBudgetBytes) {
+            break;
+          }
+          const uint32_t mipc = l_effectiveMipCap(tex);
+          if (mipc <= tex->assetData->info().mininumLevelsToUpload) {
+            continue;
+          }
+          const size_t prevBytes = l_calcRequestedSize(tex);
+          tex->mipCap = uint8_t(mipc - 1);
+          tex->requestMips(tex->mipCap);
+          usedBytes -= prevBytes - l_calcRequestedSize(tex);
+        }
+      } else {
+        // Under the budget => give one mip back to the most recently used textures, as long as they stay
+        // clear of the budget by a margin, so that the textures don't flip between the two mip counts
+        const size_t promotionBudgetBytes = hardBudgetBytes - hardBudgetBytes / 8;
+        for (auto it = lru.rbegin(); it != lru.rend() && (*it)->frameLastUsed == curframe; ++it) {
+          ManagedTexture* tex = *it;
+          const uint32_t mipc = l_effectiveMipCap(tex);
+          if (mipc >= tex->assetData->info().mipLevels) {
+            continue;
+          }
+          const size_t prevBytes = l_calcRequestedSize(tex);
+          tex->requestMips(mipc + 1);
+          const size_t newBytes = l_calcRequestedSize(tex);
+          if (usedBytes + newBytes - prevBytes > promotionBudgetBytes) {
+            tex->requestMips(mipc);
+            break;
+          }
+          tex->mipCap = uint8_t(mipc + 1);
+          usedBytes += newBytes - prevBytes;
+        }
+      }
+
+      for (const ManagedTexture* tex : textures) {
+        if (l_effectiveMipCap(tex) < tex->assetData->info().mipLevels) {
+          ++demotedCount;
+        }
+      }
+    }
+
+    // for debug report
+    g_streamedTextures_noFeedbackUsedBytes    = usedBytes;
+    g_streamedTextures_hardBudgetDemotedCount = demotedCount;
+
+    return usedBytes;
+  }
+
+  RtxTextureManager::ResidencyStats RtxTextureManager::getResidencyStats() {
+    ResidencyStats stats {};
+
+    auto ls = std::unique_lock{ m_sf.m_idToTexture_mutex };
+    for (const auto& tex : m_sf.m_idToTexture) {
+      if (tex == nullptr) {
+        continue;
+      }
+      switch (tex->state.load()) {
+      case ManagedTexture::State::kVidMem:
+        if (tex->m_currentMipView != nullptr) {
+          const size_t bytes = tex->m_currentMipView->image()->memSize();
+          if (tex->m_currentMip_begin == 0) {
+            ++stats.fullCount;
+            stats.fullBytes += bytes;
+          } else {
+            ++stats.partialCount;
+            stats.partialBytes += bytes;
+          }
+        }
+        break;
+      case ManagedTexture::State::kQueuedForUpload:
+        ++stats.pendingCount;
+        break;
+      case ManagedTexture::State::kFailed:
+        ++stats.failedCount;
+        break;
+      default:
+        break;
+      }
+    }
+    return stats;
+  }
+
   XXH64_hash_t RtxTextureManager::getUniqueKey() {
     static uint64_t ID;
     XXH64_hash_t key;
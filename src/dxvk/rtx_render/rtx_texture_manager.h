@@ -93,10 +93,21 @@ namespace dxvk {
     */
     void addTexture(const TextureRef&  inputTexture, uint16_t associatedFeedbackStamp, bool async, uint32_t& textureIndexOut);
 
+    /**
+      * \brief Barrier sets of the context that texture uploads are recorded on.
+      */
+    struct UploadBarriers {
+      DxvkBarrierSet& sdmaAcquires;
+      DxvkBarrierSet& sdmaBarriers;
+      DxvkBarrierSet& initBarriers;
+      DxvkBarrierSet& execAcquires;
+      DxvkBarrierSet& execBarriers;
+    };
+
     /**
       * \brief Submit staging-to-device texture uploads, that are currently ready from async thread.
       */
-    void submitTexturesToDeviceLocal(DxvkContext* ctx, DxvkBarrierSet& execBarriers, DxvkBarrierSet& execAcquires);
+    void submitTexturesToDeviceLocal(DxvkContext* ctx, const UploadBarriers& barriers);
 
     /**
       * \brief Clears all resources managed by the resource manager.
@@ -111,6 +122,30 @@ namespace dxvk {
       */
     void garbageCollection(const uint32_t* gpuAccessedMips);
 
+    /**
+      * \brief Residency of the streamed textures, a texture with all of its mips in video memory is fully resident.
+      */
+    struct ResidencyStats {
+      uint32_t fullCount = 0;
+      uint32_t partialCount = 0;
+      uint32_t pendingCount = 0;
+      uint32_t failedCount = 0;
+      size_t fullBytes = 0;
+      size_t partialBytes = 0;
+    };
+
+    /**
+      * \brief Counts the streamed textures by residency. Walks every texture, so it is meant to be called once in a while.
+      */
+    ResidencyStats getResidencyStats();
+
+    /**
+      * \brief Number of textures uploaded to video memory since the manager was created.
+      */
+    uint64_t getUploadedTextureCount() const {
+      return m_uploadedTextureCount;
+    }
+
     /**
       * \brief Returns a unique hash key for the resource manager.
       * \return A unique hash key.
@@ -127,7 +162,10 @@ namespace dxvk {
     }
 
   private:
-    void scheduleTextureLoad(const Rc<ManagedTexture>& texture, bool async);
+    void scheduleTextureLoad(const Rc<ManagedTexture>& texture, bool async, float priority = 0.f);
+    // Requests the mips of the in-use textures that have no sampler feedback, moving their mip caps
+    // one mip per frame towards what fits into the hard budget. Returns the size of the requested mips.
+    size_t limitTexturesWithoutFeedback(const std::vector<ManagedTexture*>& textures, size_t hardBudgetBytes, uint32_t curframe);
 
   private:
     struct TextureHashFn {
@@ -150,6 +188,10 @@ namespace dxvk {
 
     SamplerFeedback m_sf = {};
     bool m_wasTextureBudgetPressure = false;
+    // Streamed texture budget of the last frame, and how much of it the VRAM budget broker asked to give up
+    size_t m_prevBudgetBytes = 0;
+    size_t m_budgetBytesToReclaim = 0;
+    uint64_t m_uploadedTextureCount = 0;
 
     RTX_OPTION("rtx.texturemanager", bool, showProgress, false, "Show texture loading progress in the HUD.");
   };
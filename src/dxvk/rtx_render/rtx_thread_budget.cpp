@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <vector>
+
+#include "rtx_thread_budget.h"
+#include "../../util/log/log.h"
+#include "../../util/util_once.h"
+#include "../../util/util_string.h"
+
+namespace dxvk {
+
+  uint32_t RtxThreadBudget::getPhysicalCoreCount() {
+    static const uint32_t s_physicalCoreCount = [] {
+      DWORD size = 0;
+      ::GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &size);
+
+      std::vector<uint8_t> buffer(size);
+      auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+      if (size == 0 || !::GetLogicalProcessorInformationEx(RelationProcessorCore, info, &size)) {
+        return dxvk::thread::hardware_concurrency();
+      }
+
+      // Every entry of the relation is one physical core
+      uint32_t count = 0;
+      for (DWORD offset = 0; offset < size; count++) {
+        offset += reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset)->Size;
+      }
+      return std::max(count, 1u);
+    }();
+
+    return s_physicalCoreCount;
+  }
+
+  uint32_t RtxThreadBudget::getTotalThreads() {
+    if (totalThreads() > 0) {
+      return totalThreads();
+    }
+
+    const uint32_t physicalCores = getPhysicalCoreCount();
+    const uint32_t total = physicalCores > reservedCores() ? physicalCores - reservedCores() : 1;
+    ONCE(Logger::info(str::format("Thread budget: ", total, " worker threads on ", physicalCores, " physical cores.")));
+    return total;
+  }
+
+  uint32_t RtxThreadBudget::getThreadCount(ThreadClass threadClass, uint32_t desired) {
+    const uint32_t total = getTotalThreads();
+    const uint32_t classLimit = threadClass == ThreadClass::FrameCritical ? total : std::max(total / 2, 1u);
+    return std::clamp(desired, 1u, classLimit);
+  }
+
+} // namespace dxvk
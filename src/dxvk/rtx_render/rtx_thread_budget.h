@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "rtx_option.h"
+#include "../../util/thread.h"
+
+namespace dxvk {
+
+  // Priority classes of the worker thread groups of the runtime
+  enum class ThreadClass : uint32_t {
+    // Work the current frame waits on, e.g. geometry processing and light matching
+    FrameCritical,
+    // Asset streaming, e.g. texture loading and the mesh import of mods
+    Streaming,
+    // Work nothing is waiting on right away, e.g. pipeline and shader compilation and asset export
+    Background,
+  };
+
+  // Sizes the worker thread groups of the runtime against a single thread budget, so that together they
+  // do not oversubscribe the CPU the game itself needs. Every group asks for the number of threads it would
+  // like, and gets no more than its class may use: frame critical groups may use the whole budget, streaming
+  // and background groups half of it each. Streaming and background threads also run at the lowest priority,
+  // so that the game's threads and the frame critical ones win when cores are short.
+  //
+  // Groups size themselves once, when they are created, the budget is not rebalanced at runtime.
+  class RtxThreadBudget {
+  public:
+    // Number of threads a group of the given class gets when it would like the desired count, at least 1
+    static uint32_t getThreadCount(ThreadClass threadClass, uint32_t desired);
+
+    static ThreadPriority getPriority(ThreadClass threadClass) {
+      return threadClass == ThreadClass::FrameCritical ? ThreadPriority::Normal : ThreadPriority::Lowest;
+    }
+
+    static uint32_t getTotalThreads();
+
+    // SMT siblings are not counted
+    static uint32_t getPhysicalCoreCount();
+
+  private:
+    RTX_OPTION("rtx.threadBudget", uint32_t, totalThreads, 0,
+               "The total number of worker threads the runtime's thread groups (geometry processing, texture loading, mesh import, light matching, shader and pipeline compilation, asset export) are sized against.\n"
+               "Frame critical groups may use all of them, streaming and background groups half of them each. 0 derives the budget from the CPU, see rtx.threadBudget.reservedCores.");
+    RTX_OPTION("rtx.threadBudget", uint32_t, reservedCores, 2,
+               "The number of physical cores left to the game's own threads when rtx.threadBudget.totalThreads is 0.");
+  };
+
+} // namespace dxvk
@@ -122,6 +122,71 @@ namespace dxvk {
     }
   }
 
+  namespace {
+    struct TextureCategoryTable {
+      uint32_t hashSetGeneration = UINT32_MAX;
+      fast_unordered_cache<TextureCategories> entries;
+
+      void rebuild() {
+        ScopedCpuProfileZone();
+        entries.clear();
+
+        auto addCategory = [this](const fast_unordered_set& textures, const InstanceCategories category) {
+          for (const XXH64_hash_t textureHash : textures) {
+            entries[textureHash].categories.set(category);
+          }
+        };
+
+        addCategory(RtxOptions::worldSpaceUiTextures(), InstanceCategories::WorldUI);
+        addCategory(RtxOptions::worldSpaceUiBackgroundTextures(), InstanceCategories::WorldMatte);
+
+        addCategory(RtxOptions::ignoreTextures(), InstanceCategories::Ignore);
+        addCategory(RtxOptions::ignoreLights(), InstanceCategories::IgnoreLights);
+        addCategory(RtxOptions::antiCullingTextures(), InstanceCategories::IgnoreAntiCulling);
+        addCategory(RtxOptions::motionBlurMaskOutTextures(), InstanceCategories::IgnoreMotionBlur);
+        addCategory(RtxOptions::opacityMicromapIgnoreTextures(), InstanceCategories::IgnoreOpacityMicromap);
+        addCategory(RtxOptions::ignoreAlphaOnTextures(), InstanceCategories::IgnoreAlphaChannel);
+        addCategory(RtxOptions::ignoreBakedLightingTextures(), InstanceCategories::IgnoreBakedLighting);
+
+        addCategory(RtxOptions::hideInstanceTextures(), InstanceCategories::Hidden);
+
+        addCategory(RtxOptions::particleTextures(), InstanceCategories::Particle);
+        addCategory(RtxOptions::beamTextures(), InstanceCategories::Beam);
+        addCategory(RtxOptions::ignoreTransparencyLayerTextures(), InstanceCategories::IgnoreTransparencyLayer);
+
+        addCategory(RtxOptions::decalTextures(), InstanceCategories::DecalStatic);
+        addCategory(RtxOptions::dynamicDecalTextures(), InstanceCategories::DecalDynamic);
+        addCategory(RtxOptions::singleOffsetDecalTextures(), InstanceCategories::DecalSingleOffset);
+        addCategory(RtxOptions::nonOffsetDecalTextures(), InstanceCategories::DecalNoOffset);
+
+        addCategory(RtxOptions::animatedWaterTextures(), InstanceCategories::AnimatedWater);
+
+        addCategory(RtxOptions::playerModelTextures(), InstanceCategories::ThirdPersonPlayerModel);
+        addCategory(RtxOptions::playerModelBodyTextures(), InstanceCategories::ThirdPersonPlayerBody);
+
+        addCategory(RtxOptions::terrainTextures(), InstanceCategories::Terrain);
+        addCategory(RtxOptions::skyBoxTextures(), InstanceCategories::Sky);
+
+        for (const XXH64_hash_t textureHash : RtxOptions::uiTextures()) {
+          entries[textureHash].isUiTexture = true;
+        }
+      }
+    };
+  }
+
+  TextureCategories lookupTextureCategories(const XXH64_hash_t textureHash) {
+    static TextureCategoryTable s_table;
+
+    const uint32_t hashSetGeneration = RtxOptionImpl::getHashSetGeneration();
+    if (s_table.hashSetGeneration != hashSetGeneration) {
+      s_table.rebuild();
+      s_table.hashSetGeneration = hashSetGeneration;
+    }
+
+    const auto it = s_table.entries.find(textureHash);
+    return it != s_table.entries.end() ? it->second : TextureCategories {};
+  }
+
   void DrawCallState::setCategory(InstanceCategories category, bool doSet) {
     if (doSet) {
       categories.set(category);
@@ -133,39 +198,10 @@ namespace dxvk {
   }
 
   void DrawCallState::setupCategoriesForTexture() {
-    // TODO (REMIX-231): It would probably be much more efficient to use a map of texture hash to category flags, rather
-    //                   than doing N lookups per texture hash for each category.
     const XXH64_hash_t& textureHash = materialData.getColorTexture().getImageHash();
 
-    setCategory(InstanceCategories::WorldUI, lookupHash(RtxOptions::worldSpaceUiTextures(), textureHash));
-    setCategory(InstanceCategories::WorldMatte, lookupHash(RtxOptions::worldSpaceUiBackgroundTextures(), textureHash));
-
-    setCategory(InstanceCategories::Ignore, lookupHash(RtxOptions::ignoreTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreLights, lookupHash(RtxOptions::ignoreLights(), textureHash));
-    setCategory(InstanceCategories::IgnoreAntiCulling, lookupHash(RtxOptions::antiCullingTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreMotionBlur, lookupHash(RtxOptions::motionBlurMaskOutTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreOpacityMicromap, lookupHash(RtxOptions::opacityMicromapIgnoreTextures(), textureHash) || isUsingRaytracedRenderTarget);
-    setCategory(InstanceCategories::IgnoreAlphaChannel, lookupHash(RtxOptions::ignoreAlphaOnTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreBakedLighting, lookupHash(RtxOptions::ignoreBakedLightingTextures(), textureHash));
-
-    setCategory(InstanceCategories::Hidden, lookupHash(RtxOptions::hideInstanceTextures(), textureHash));
-
-    setCategory(InstanceCategories::Particle, lookupHash(RtxOptions::particleTextures(), textureHash));
-    setCategory(InstanceCategories::Beam, lookupHash(RtxOptions::beamTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreTransparencyLayer, lookupHash(RtxOptions::ignoreTransparencyLayerTextures(), textureHash));
-
-    setCategory(InstanceCategories::DecalStatic, lookupHash(RtxOptions::decalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalDynamic, lookupHash(RtxOptions::dynamicDecalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalSingleOffset, lookupHash(RtxOptions::singleOffsetDecalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalNoOffset, lookupHash(RtxOptions::nonOffsetDecalTextures(), textureHash));
-
-    setCategory(InstanceCategories::AnimatedWater, lookupHash(RtxOptions::animatedWaterTextures(), textureHash));
-
-    setCategory(InstanceCategories::ThirdPersonPlayerModel, lookupHash(RtxOptions::playerModelTextures(), textureHash));
-    setCategory(InstanceCategories::ThirdPersonPlayerBody, lookupHash(RtxOptions::playerModelBodyTextures(), textureHash));
-
-    setCategory(InstanceCategories::Terrain, lookupHash(RtxOptions::terrainTextures(), textureHash));
-    setCategory(InstanceCategories::Sky, lookupHash(RtxOptions::skyBoxTextures(), textureHash));
+    categories.set(lookupTextureCategories(textureHash).categories);
+    setCategory(InstanceCategories::IgnoreOpacityMicromap, isUsingRaytracedRenderTarget);
   }
 
   void DrawCallState::setupCategoriesForGeometry() {
@@ -146,6 +146,31 @@ struct AxisAlignedBoundingBox {
     }
   }
 
+  // returns an AABB enclosing the transformed AABB, or an invalid AABB if this AABB is invalid
+  AxisAlignedBoundingBox getTransformed(const Matrix4& transform) const {
+    if (!isValid()) {
+      return AxisAlignedBoundingBox{};
+    }
+
+    const Vector3 center = getTransformedCentroid(transform);
+    const Vector3 extent = (maxPos - minPos) * 0.5f;
+    Vector3 transformedExtent{ 0.f, 0.f, 0.f };
+    for (uint32_t i = 0; i < 3; i++) {
+      for (uint32_t j = 0; j < 3; j++) {
+        transformedExtent[i] += std::abs(transform[j][i]) * extent[j];
+      }
+    }
+    return AxisAlignedBoundingBox{ center - transformedExtent, center + transformedExtent };
+  }
+
+  float getSurfaceArea() const {
+    if (!isValid()) {
+      return 0.f;
+    }
+    const Vector3 size = maxPos - minPos;
+    return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+  }
+
   const XXH64_hash_t calculateHash() const {
     return XXH3_64bits(this, sizeof(AxisAlignedBoundingBox));
   }
@@ -445,6 +470,17 @@ using CategoryFlags = Flags<InstanceCategories>;
 
 #define DECAL_CATEGORY_FLAGS InstanceCategories::DecalStatic, InstanceCategories::DecalDynamic, InstanceCategories::DecalSingleOffset, InstanceCategories::DecalNoOffset
 
+// Everything the texture category options (rtx.uiTextures, rtx.decalTextures, ...) assign to a texture hash
+struct TextureCategories {
+  CategoryFlags categories = 0;
+  bool isUiTexture = false;
+};
+
+// Looks up the categories of a texture hash with a single probe of a table that folds all the texture category options
+// together. The table is rebuilt on the next lookup after any hash set option changed.
+// Note: Must only be called from the thread submitting draw calls.
+TextureCategories lookupTextureCategories(const XXH64_hash_t textureHash);
+
 struct DrawCallState {
   DrawCallState() = default;
   DrawCallState(const DrawCallState& _input) = default;
@@ -561,6 +597,25 @@ struct PooledBlas : public RcObject {
 
   // Frame when this BLAS was last used in a TLAS
   uint32_t frameLastTouched = kInvalidFrameIndex;
+  // Frame when this BLAS was last built or updated
+  uint32_t frameLastBuilt = kInvalidFrameIndex;
+  // Number of updates (refits) since the last full build
+  uint32_t numUpdatesSinceBuild = 0;
+  // Set when an update was deferred to a later frame by the per frame build budget
+  bool hasDeferredUpdate = false;
+  // Topological hash of the geometry this BLAS was built for, an update requires the same topology
+  XXH64_hash_t topologyHash = kEmptyHash;
+
+  // Size required to build this BLAS, the allocation is smaller than this once the BLAS is compacted
+  VkDeviceSize buildSize = 0;
+  // Compacted BLAS are never updated in place, they are rebuilt into a full size BLAS instead
+  bool isCompacted = false;
+  // Compacted size query slot in AccelManager while the query is pending
+  uint32_t compactionQuery = UINT32_MAX;
+  // Serialized size query slot in BlasDiskCache while the query is pending
+  uint32_t serializationQuery = UINT32_MAX;
+  // Set once this BLAS was loaded from or stored to the BLAS disk cache
+  bool isInDiskCache = false;
 
   // Hash of a bound opacity micromap
   // Note: only used for tracking of OMMs for static BLASes
@@ -598,6 +653,17 @@ struct BlasEntry {
   // Frame when the vertex data of this geometry was last updated, used to detect static geometries
   uint32_t frameLastUpdated = kInvalidFrameIndex;
 
+  // State of the BLAS merging cost model, see 'rtx.enableBlasMergeCostModel'
+  uint32_t frameBlasCostEvaluated = kInvalidFrameIndex;
+  // Moving average of the fraction of frames the vertex data was updated in, new geometry is assumed to be animated
+  float vertexUpdateRate = 1.f;
+  bool prefersDynamicBlas = false;
+
+  // Surface material created for the first draw of this geometry in frameSurfaceMaterialCreated,
+  // later draws of the geometry with an identical material in that frame reuse it
+  uint32_t frameSurfaceMaterialCreated = kInvalidFrameIndex;
+  uint32_t surfaceMaterialIndex = UINT32_MAX;
+
   using InstanceMap = SpatialMap<RtInstance>;
 
   Rc<PooledBlas> dynamicBlas = nullptr;
@@ -0,0 +1,247 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include "rtx_usd_mesh_cache.h"
+#include "rtx_constants.h"
+
+#include <algorithm>
+#include <windows.h>
+
+#include "../../lssusd/usd_mesh_importer.h"
+
+#include "../../lssusd/usd_include_begin.h"
+#include <pxr/usd/sdf/layer.h>
+#include "../../lssusd/usd_include_end.h"
+
+namespace fs = std::filesystem;
+
+namespace dxvk {
+
+  UsdMeshCache::UsdMeshCache(const fs::path& modFilePath, const pxr::UsdStageRefPtr& stage, const uint32_t limitedNumBonesPerVertex)
+    : m_cachePath(fs::path(modFilePath).concat(".meshcache"))
+    , m_stage(stage)
+    , m_key(computeKey(stage, limitedNumBonesPerVertex)) {
+    if (mapCache()) {
+      Logger::info(str::format("[UsdMeshCache] Using ", m_numEntries, " cached meshes from ", m_cachePath.string()));
+    } else {
+      beginWrite();
+    }
+  }
+
+  UsdMeshCache::~UsdMeshCache() {
+    if (m_writeFile) {
+      // Unfinished, don't leave a partial cache behind
+      m_writeFile.reset();
+      std::error_code ec;
+      fs::remove(fs::path(m_cachePath).concat(".tmp"), ec);
+    }
+    unmapCache();
+  }
+
+  XXH64_hash_t UsdMeshCache::computeKey(const pxr::UsdStageRefPtr& stage, const uint32_t limitedNumBonesPerVertex) {
+    std::vector<std::string> layerPaths;
+    for (const pxr::SdfLayerHandle& layer : stage->GetUsedLayers()) {
+      // Anonymous layers (e.g. the session layer) have no file behind them
+      const std::string& realPath = layer->GetRealPath();
+      if (!realPath.empty()) {
+        layerPaths.push_back(realPath);
+      }
+    }
+    std::sort(layerPaths.begin(), layerPaths.end());
+
+    XXH64_hash_t key = XXH64(&kVersion, sizeof(kVersion), kEmptyHash);
+    key = XXH64(&limitedNumBonesPerVertex, sizeof(limitedNumBonesPerVertex), key);
+    for (const std::string& layerPath : layerPaths) {
+      std::error_code ec;
+      const uintmax_t size = fs::file_size(layerPath, ec);
+      const auto writeTime = fs::last_write_time(layerPath, ec).time_since_epoch().count();
+      key = StringToXXH64(layerPath, key);
+      key = XXH64(&size, sizeof(size), key);
+      key = XXH64(&writeTime, sizeof(writeTime), key);
+    }
+    return key;
+  }
+
+  bool UsdMeshCache::mapCache() {
+    HANDLE hFile = CreateFileW(m_cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < (LONGLONG) sizeof(Header)) {
+      CloseHandle(hFile);
+      return false;
+    }
+
+    HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+      CloseHandle(hFile);
+      return false;
+    }
+
+    LPVOID lpBaseAddress = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (lpBaseAddress == NULL) {
+      CloseHandle(hMapping);
+      CloseHandle(hFile);
+      return false;
+    }
+
+    m_mappedFile = hFile;
+    m_mapping = hMapping;
+    m_mappedBase = (const uint8_t*) lpBaseAddress;
+    m_mappedSize = fileSize.QuadPart;
+
+    const Header& header = *reinterpret_cast<const Header*>(m_mappedBase);
+    const bool isValid = header.magic == kMagic && header.version == kVersion && header.key == m_key &&
+                         header.directoryOffset <= m_mappedSize &&
+                         header.numEntries <= (m_mappedSize - header.directoryOffset) / sizeof(DirectoryEntry);
+    if (!isValid) {
+      unmapCache();
+      return false;
+    }
+
+    m_directory = reinterpret_cast<const DirectoryEntry*>(m_mappedBase + header.directoryOffset);
+    m_numEntries = header.numEntries;
+    return true;
+  }
+
+  void UsdMeshCache::unmapCache() {
+    if (m_mappedBase) {
+      UnmapViewOfFile(m_mappedBase);
+      CloseHandle(m_mapping);
+      CloseHandle(m_mappedFile);
+      m_mappedFile = nullptr;
+      m_mapping = nullptr;
+      m_mappedBase = nullptr;
+      m_mappedSize = 0;
+      m_directory = nullptr;
+      m_numEntries = 0;
+    }
+  }
+
+  void UsdMeshCache::beginWrite() {
+    const fs::path tmpPath = fs::path(m_cachePath).concat(".tmp");
+    m_writeFile.reset(_wfopen(tmpPath.c_str(), L"wb"));
+    if (!m_writeFile) {
+      Logger::warn(str::format("[UsdMeshCache] Failed to create ", tmpPath.string(), ", meshes of this mod will not be cached."));
+      return;
+    }
+
+    // The header is filled in by finish(), a zeroed one never matches
+    const Header header = {};
+    std::fwrite(&header, sizeof(header), 1, m_writeFile.get());
+    m_writeOffset = sizeof(header);
+  }
+
+  std::unique_ptr<lss::UsdMeshImporter> UsdMeshCache::find(const pxr::UsdPrim& prim) const {
+    if (m_directory == nullptr || prim.GetStage() != m_stage) {
+      return nullptr;
+    }
+
+    const std::string path = prim.GetPath().GetString();
+    const XXH64_hash_t pathHash = XXH3_64bits(path.data(), path.size());
+
+    const DirectoryEntry* const directoryEnd = m_directory + m_numEntries;
+    const DirectoryEntry* entry = std::lower_bound(m_directory, directoryEnd, pathHash,
+                                                   [](const DirectoryEntry& e, XXH64_hash_t hash) { return e.pathHash < hash; });
+    for (; entry != directoryEnd && entry->pathHash == pathHash; ++entry) {
+      if (entry->offset > m_mappedSize || entry->size > m_mappedSize - entry->offset || entry->size < sizeof(uint32_t)) {
+        continue;
+      }
+
+      // Every blob starts with the prim path, in case of a hash collision
+      const uint8_t* pBlob = m_mappedBase + entry->offset;
+      uint32_t pathLength;
+      memcpy(&pathLength, pBlob, sizeof(pathLength));
+      if (pathLength != path.size() || sizeof(uint32_t) + pathLength > entry->size ||
+          memcmp(pBlob + sizeof(uint32_t), path.data(), pathLength) != 0) {
+        continue;
+      }
+
+      const size_t headerSize = sizeof(uint32_t) + pathLength;
+      return lss::UsdMeshImporter::Deserialize(prim, pBlob + headerSize, entry->size - headerSize);
+    }
+
+    return nullptr;
+  }
+
+  void UsdMeshCache::add(const pxr::UsdPrim& prim, const lss::UsdMeshImporter& mesh) {
+    if (m_directory != nullptr || prim.GetStage() != m_stage) {
+      return;
+    }
+
+    const std::string path = prim.GetPath().GetString();
+    const uint32_t pathLength = path.size();
+    const std::vector<uint8_t> data = mesh.Serialize();
+
+    std::lock_guard<dxvk::mutex> lock(m_writeMutex);
+    if (!m_writeFile) {
+      return;
+    }
+
+    const bool written = std::fwrite(&pathLength, sizeof(pathLength), 1, m_writeFile.get()) == 1 &&
+                         std::fwrite(path.data(), 1, pathLength, m_writeFile.get()) == pathLength &&
+                         std::fwrite(data.data(), 1, data.size(), m_writeFile.get()) == data.size();
+    if (!written) {
+      Logger::warn(str::format("[UsdMeshCache] Failed to write ", m_cachePath.string(), ".tmp, meshes of this mod will not be cached."));
+      m_writeFile.reset();
+      return;
+    }
+
+    const uint64_t blobSize = sizeof(pathLength) + pathLength + data.size();
+    m_newEntries.push_back(DirectoryEntry { XXH3_64bits(path.data(), path.size()), m_writeOffset, blobSize });
+    m_writeOffset += blobSize;
+  }
+
+  void UsdMeshCache::finish() {
+    std::lock_guard<dxvk::mutex> lock(m_writeMutex);
+    if (!m_writeFile) {
+      return;
+    }
+
+    // Blobs are in import order, which depends on the worker threads, the directory makes lookups independent of it
+    std::sort(m_newEntries.begin(), m_newEntries.end(),
+              [](const DirectoryEntry& a, const DirectoryEntry& b) { return a.pathHash < b.pathHash; });
+
+    const Header header = { kMagic, kVersion, m_key, m_writeOffset, m_newEntries.size() };
+    const bool written = std::fwrite(m_newEntries.data(), sizeof(DirectoryEntry), m_newEntries.size(), m_writeFile.get()) == m_newEntries.size() &&
+                         std::fseek(m_writeFile.get(), 0, SEEK_SET) == 0 &&
+                         std::fwrite(&header, sizeof(header), 1, m_writeFile.get()) == 1;
+    const bool closed = std::fclose(m_writeFile.release()) == 0;
+
+    const fs::path tmpPath = fs::path(m_cachePath).concat(".tmp");
+    std::error_code ec;
+    if (written && closed) {
+      fs::rename(tmpPath, m_cachePath, ec);
+    }
+    if (!written || !closed || ec) {
+      Logger::warn(str::format("[UsdMeshCache] Failed to write ", m_cachePath.string()));
+      fs::remove(tmpPath, ec);
+      return;
+    }
+
+    Logger::info(str::format("[UsdMeshCache] Cached ", m_newEntries.size(), " meshes in ", m_cachePath.string()));
+    m_newEntries.clear();
+  }
+
+} // namespace dxvk
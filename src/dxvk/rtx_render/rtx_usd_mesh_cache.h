@@ -0,0 +1,111 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "rtx_utils.h"
+#include "../../util/thread.h"
+
+#include "../../lssusd/usd_include_begin.h"
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/prim.h>
+#include "../../lssusd/usd_include_end.h"
+
+namespace lss {
+  class UsdMeshImporter;
+}
+
+namespace dxvk {
+
+  // Cache of the meshes UsdMeshImporter produced for a USD mod, stored next to the mod as "<mod file>.meshcache".
+  // The file is valid for one exact set of layers: the key covers the path, size and write time of every layer the
+  // stage uses, so editing any of them rebuilds the whole cache on the next load.
+  //
+  // File layout: a header, one blob per mesh, then a directory sorted by prim path hash pointing at the blobs.
+  // A valid cache is memory mapped and meshes are deserialized straight from the mapping. Otherwise the blobs
+  // of the meshes imported during the load are streamed to a temporary file, which replaces the cache in finish().
+  class UsdMeshCache {
+  public:
+    UsdMeshCache(const std::filesystem::path& modFilePath, const pxr::UsdStageRefPtr& stage, const uint32_t limitedNumBonesPerVertex);
+    ~UsdMeshCache();
+
+    UsdMeshCache(const UsdMeshCache&) = delete;
+    UsdMeshCache& operator=(const UsdMeshCache&) = delete;
+
+    // Returns the cached mesh of a prim on the stage of the cache, nullptr on a miss. Thread safe.
+    std::unique_ptr<lss::UsdMeshImporter> find(const pxr::UsdPrim& prim) const;
+
+    // Records a freshly imported mesh to be written out, ignored when the cache file is already valid. Thread safe.
+    void add(const pxr::UsdPrim& prim, const lss::UsdMeshImporter& mesh);
+
+    // Writes out the directory and moves the new cache into place, if one was being built
+    void finish();
+
+  private:
+    struct Header {
+      uint32_t magic;
+      uint32_t version;
+      XXH64_hash_t key;
+      uint64_t directoryOffset;
+      uint64_t numEntries;
+    };
+
+    struct DirectoryEntry {
+      XXH64_hash_t pathHash;
+      uint64_t offset;
+      uint64_t size;
+    };
+
+    static constexpr uint32_t kMagic = 0x434d5852; // "RXMC"
+    static constexpr uint32_t kVersion = 1;
+
+    std::filesystem::path m_cachePath;
+    pxr::UsdStagePtr m_stage;
+    XXH64_hash_t m_key = 0;
+
+    // Valid cache
+    void* m_mappedFile = nullptr;
+    void* m_mapping = nullptr;
+    const uint8_t* m_mappedBase = nullptr;
+    size_t m_mappedSize = 0;
+    const DirectoryEntry* m_directory = nullptr;
+    size_t m_numEntries = 0;
+
+    // Cache being built
+    dxvk::mutex m_writeMutex;
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> m_writeFile { nullptr, &std::fclose };
+    std::vector<DirectoryEntry> m_newEntries;
+    uint64_t m_writeOffset = 0;
+
+    static XXH64_hash_t computeKey(const pxr::UsdStageRefPtr& stage, const uint32_t limitedNumBonesPerVertex);
+
+    bool mapCache();
+    void unmapCache();
+    void beginWrite();
+  };
+
+} // namespace dxvk
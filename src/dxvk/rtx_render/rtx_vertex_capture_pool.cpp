@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+
+#include "dxvk_device.h"
+#include "rtx_vertex_capture_pool.h"
+
+namespace dxvk {
+
+  namespace {
+    uint32_t ceilLog2(VkDeviceSize size) {
+      uint32_t result = 0;
+      while ((VkDeviceSize(1) << result) < size) {
+        ++result;
+      }
+      return result;
+    }
+  }
+
+  RtxVertexCapturePool::RtxVertexCapturePool(DxvkDevice* device)
+    : m_device(device)
+    , m_alignment(std::max<VkDeviceSize>(device->properties().core.properties.limits.minStorageBufferOffsetAlignment, CACHE_LINE_SIZE)) {
+  }
+
+  DxvkBufferSlice RtxVertexCapturePool::alloc(VkDeviceSize size) {
+    const VkDeviceSize alignedSize = dxvk::align(size, m_alignment);
+    if (alignedSize > kPageSize) {
+      return allocDedicated(size);
+    }
+
+    FrameData& frame = m_frames[m_frameIdx];
+    if (frame.offset + alignedSize > kPageSize) {
+      ++frame.currentPage;
+      frame.offset = 0;
+    }
+
+    if (frame.currentPage == (uint32_t) frame.pages.size()) {
+      frame.pages.push_back(createBuffer(kPageSize, "Vertex Capture Pool Page"));
+    }
+
+    const Rc<DxvkBuffer>& page = frame.pages[frame.currentPage];
+    if (frame.offset == 0) {
+      // First slice of this page in the frame, keep the page from being recycled until the CS thread is done with it
+      page->acquire(DxvkAccess::Read);
+      frame.acquiredBuffers.push_back(page);
+    }
+
+    DxvkBufferSlice slice(page, frame.offset, size);
+    frame.offset += alignedSize;
+    return slice;
+  }
+
+  DxvkBufferSlice RtxVertexCapturePool::allocDedicated(VkDeviceSize size) {
+    FrameData& frame = m_frames[m_frameIdx];
+
+    const uint32_t bucket = std::max(ceilLog2(size), kFirstDedicatedBucketLog2) - kFirstDedicatedBucketLog2;
+
+    Rc<DxvkBuffer> buffer;
+    if (bucket >= kNumDedicatedBuckets) {
+      // Too large to be worth keeping around
+      buffer = createBuffer(size, "Vertex Capture Buffer");
+    } else if (!m_freeDedicatedBuffers[bucket].empty()) {
+      buffer = std::move(m_freeDedicatedBuffers[bucket].back());
+      m_freeDedicatedBuffers[bucket].pop_back();
+    } else {
+      buffer = createBuffer(VkDeviceSize(1) << (bucket + kFirstDedicatedBucketLog2), "Vertex Capture Buffer");
+    }
+
+    buffer->acquire(DxvkAccess::Read);
+    frame.acquiredBuffers.push_back(buffer);
+    frame.dedicatedBuffers.push_back(buffer);
+
+    return DxvkBufferSlice(buffer, 0, size);
+  }
+
+  std::vector<Rc<DxvkBuffer>> RtxVertexCapturePool::onFrameEnd() {
+    std::vector<Rc<DxvkBuffer>> acquiredBuffers = std::move(m_frames[m_frameIdx].acquiredBuffers);
+    m_frames[m_frameIdx].acquiredBuffers.clear();
+
+    m_frameIdx = (m_frameIdx + 1) % kMaxFramesInFlight;
+    recycle(m_frames[m_frameIdx]);
+
+    return acquiredBuffers;
+  }
+
+  void RtxVertexCapturePool::recycle(FrameData& frame) {
+    // Pages still in use by the GPU are dropped rather than waited on, their memory is freed once the GPU is done
+    frame.pages.erase(std::remove_if(frame.pages.begin(), frame.pages.end(),
+                                     [](const Rc<DxvkBuffer>& page) { return page->isInUse(); }),
+                      frame.pages.end());
+    frame.currentPage = 0;
+    frame.offset = 0;
+
+    for (Rc<DxvkBuffer>& buffer : frame.dedicatedBuffers) {
+      const VkDeviceSize size = buffer->info().size;
+      const uint32_t sizeLog2 = ceilLog2(size);
+      if (buffer->isInUse() || (VkDeviceSize(1) << sizeLog2) != size || sizeLog2 >= kFirstDedicatedBucketLog2 + kNumDedicatedBuckets) {
+        continue;
+      }
+
+      auto& freeBuffers = m_freeDedicatedBuffers[sizeLog2 - kFirstDedicatedBucketLog2];
+      if (freeBuffers.size() < kMaxFreeBuffersPerBucket) {
+        freeBuffers.push_back(std::move(buffer));
+      }
+    }
+    frame.dedicatedBuffers.clear();
+  }
+
+  Rc<DxvkBuffer> RtxVertexCapturePool::createBuffer(VkDeviceSize size, const char* name) {
+    DxvkBufferCreateInfo info;
+    info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT;
+    info.stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.size = size;
+    return m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::AppBuffer, name);
+  }
+
+} // namespace dxvk
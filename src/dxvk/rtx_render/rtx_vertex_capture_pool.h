@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "dxvk_buffer.h"
+#include "rtx_utils.h"
+
+namespace dxvk {
+
+  // Sub-allocates the device local buffers that vertex shader capture writes post-VS vertices to.
+  // Every frame allocates linearly from its own set of fixed size pages, and a frame's pages are
+  // handed out again kMaxFramesInFlight frames later, as long as the GPU is done with them by then.
+  // Captures larger than a page get a dedicated buffer, which is recycled through power-of-two size
+  // buckets in the same way. Captured vertices are only consumed within the frame they were captured
+  // in, so nothing but the GPU can still be using a page once its frame comes around again.
+  //
+  // A slice is handed out before the CS thread records the draw that writes to it, so every buffer
+  // used in a frame holds a read reference until the caller drops it on the CS thread, see onFrameEnd.
+  class RtxVertexCapturePool {
+  public:
+    RtxVertexCapturePool(const RtxVertexCapturePool&) = delete;
+    RtxVertexCapturePool& operator=(const RtxVertexCapturePool&) = delete;
+
+    explicit RtxVertexCapturePool(DxvkDevice* device);
+
+    // Returns a slice of at least the given size. Can be called only on the thread issuing draws.
+    DxvkBufferSlice alloc(VkDeviceSize size);
+
+    // Moves on to the pages of the next frame. Returns the buffers used in the frame that just ended,
+    // the caller must release(DxvkAccess::Read) them on the CS thread after the frame's draws.
+    std::vector<Rc<DxvkBuffer>> onFrameEnd();
+
+  private:
+    static constexpr VkDeviceSize kPageSize = 4 << 20; // 4 MiB
+    // Dedicated buffers are bucketed by size from 8 MiB (2x page size) up
+    static constexpr uint32_t kFirstDedicatedBucketLog2 = 23;
+    static constexpr uint32_t kNumDedicatedBuckets = 8;
+    static constexpr uint32_t kMaxFreeBuffersPerBucket = 2;
+
+    struct FrameData {
+      std::vector<Rc<DxvkBuffer>> pages;
+      uint32_t currentPage = 0;
+      VkDeviceSize offset = 0;
+      std::vector<Rc<DxvkBuffer>> dedicatedBuffers;
+      // Subset of the above that was handed out in the frame and still holds a read reference
+      std::vector<Rc<DxvkBuffer>> acquiredBuffers;
+    };
+
+    DxvkDevice* m_device;
+    const VkDeviceSize m_alignment;
+
+    std::array<FrameData, kMaxFramesInFlight> m_frames;
+    uint32_t m_frameIdx = 0;
+
+    std::array<std::vector<Rc<DxvkBuffer>>, kNumDedicatedBuckets> m_freeDedicatedBuffers;
+
+    DxvkBufferSlice allocDedicated(VkDeviceSize size);
+    void recycle(FrameData& frame);
+    Rc<DxvkBuffer> createBuffer(VkDeviceSize size, const char* name);
+  };
+
+} // namespace dxvk
@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+
+#include "rtx_vram_budget_broker.h"
+#include "rtx_utils.h"
+#include "dxvk_device.h"
+#include "dxvk_scoped_annotation.h"
+
+namespace dxvk {
+
+  VramBudgetBroker::VramBudgetBroker(DxvkDevice* device)
+    : CommonDeviceObject(device) {
+  }
+
+  void VramBudgetBroker::registerConsumer(Consumer consumer, const ConsumerDesc& desc) {
+    ConsumerState& state = m_consumers[static_cast<uint32_t>(consumer)];
+    assert(!state.isRegistered && "VRAM budget consumer registered twice");
+
+    state.isRegistered = true;
+    state.desc = desc;
+  }
+
+  void VramBudgetBroker::unregisterConsumer(Consumer consumer) {
+    m_consumers[static_cast<uint32_t>(consumer)] = ConsumerState {};
+  }
+
+  void VramBudgetBroker::onFrameStart() {
+    ScopedCpuProfileZone();
+
+    // Gather runtime vidmem stats
+    VkDeviceSize vidmemSize = 0;
+    VkDeviceSize vidmemUsedSize = 0;
+
+    const DxvkAdapterMemoryInfo memHeapInfo = m_device->adapter()->getMemoryHeapInfo();
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = m_device->adapter()->memoryProperties();
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+      if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+        vidmemSize += memHeapInfo.heaps[i].memoryBudget;
+        vidmemUsedSize += memHeapInfo.heaps[i].memoryAllocated;
+      }
+    }
+
+    m_vidmemFreeSize = vidmemSize - std::min(vidmemUsedSize, vidmemSize);
+
+    const VkDeviceSize minFreeVidmemSize = static_cast<VkDeviceSize>(std::max(minFreeVidmemMB(), 0)) * 1024 * 1024;
+
+    if (!enable() || m_vidmemFreeSize >= minFreeVidmemSize) {
+      return;
+    }
+
+    // Memory reclaimed recently is not freed until the frames in flight using it have retired,
+    // so wait for that to show up in the stats rather than reclaiming it again from someone else
+    const uint32_t currentFrame = m_device->getCurrentFrameId();
+    if (m_frameLastReclaimed != kInvalidFrameIndex && currentFrame <= m_frameLastReclaimed + kMaxFramesInFlight) {
+      return;
+    }
+
+    std::array<ConsumerState*, static_cast<uint32_t>(Consumer::Count)> consumers;
+    uint32_t numConsumers = 0;
+    for (ConsumerState& state : m_consumers) {
+      if (state.isRegistered && state.desc.reclaim) {
+        consumers[numConsumers++] = &state;
+      }
+    }
+
+    std::stable_sort(consumers.begin(), consumers.begin() + numConsumers,
+                     [](const ConsumerState* a, const ConsumerState* b) { return a->desc.priority < b->desc.priority; });
+
+    VkDeviceSize deficit = minFreeVidmemSize - m_vidmemFreeSize;
+
+    for (uint32_t i = 0; i < numConsumers && deficit > 0; i++) {
+      const VkDeviceSize reclaimedSize = std::min(consumers[i]->desc.reclaim(deficit), deficit);
+
+      if (reclaimedSize == 0) {
+        continue;
+      }
+
+      deficit -= reclaimedSize;
+
+      m_frameLastReclaimed = currentFrame;
+      m_holdUntilFrame = currentFrame + static_cast<uint32_t>(std::max(growthCooldownFrames(), 0));
+      m_holdPriority = consumers[i]->desc.priority;
+    }
+  }
+
+  bool VramBudgetBroker::canGrow(Consumer consumer) const {
+    const ConsumerState& state = m_consumers[static_cast<uint32_t>(consumer)];
+
+    if (!enable() || !state.isRegistered || m_frameLastReclaimed == kInvalidFrameIndex) {
+      return true;
+    }
+
+    return m_device->getCurrentFrameId() >= m_holdUntilFrame || state.desc.priority > m_holdPriority;
+  }
+
+} // namespace dxvk
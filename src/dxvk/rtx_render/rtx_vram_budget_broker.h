@@ -0,0 +1,100 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include "dxvk_include.h"
+#include "rtx_common_object.h"
+#include "rtx_constants.h"
+#include "rtx_option.h"
+
+namespace dxvk {
+
+  // Arbitrates device local memory between the RTX subsystems that size their caches by the free VRAM.
+  // Without it every subsystem reacts to memory pressure on its own within the same frame, so that e.g.
+  // OMMs get evicted (and soon rebuilt) while textures get demoted at the same time.
+  //
+  // Free VRAM is sampled once at the start of a frame. When it drops below rtx.vramBudget.minFreeVidmemMB
+  // the deficit is reclaimed from the registered consumers in ascending priority order, a consumer only being
+  // asked for what the lower priority ones could not give up. Consumers that had to give up memory, and any
+  // consumer of a lower priority than them, are then held from growing for rtx.vramBudget.growthCooldownFrames.
+  //
+  // Consumers are registered and called on the CS thread.
+  class VramBudgetBroker : public CommonDeviceObject {
+  public:
+    enum class Consumer : uint32_t {
+      OpacityMicromaps,
+      Blas,
+      Textures,
+
+      Count
+    };
+
+    struct ConsumerDesc {
+      // Consumers with a lower priority are asked to give up memory first
+      uint32_t priority = 0;
+      // Asked to free up to the given number of bytes, returns how many bytes it will free.
+      // The memory may only become available once the frames in flight using it have retired.
+      std::function<VkDeviceSize(VkDeviceSize)> reclaim;
+    };
+
+    explicit VramBudgetBroker(DxvkDevice* device);
+
+    void registerConsumer(Consumer consumer, const ConsumerDesc& desc);
+    void unregisterConsumer(Consumer consumer);
+
+    void onFrameStart();
+
+    // Whether a consumer may grow its budget this frame
+    bool canGrow(Consumer consumer) const;
+
+    // Free device local memory sampled at the start of the frame
+    VkDeviceSize getVidmemFreeSize() const {
+      return m_vidmemFreeSize;
+    }
+
+  private:
+    RTX_OPTION("rtx.vramBudget", bool, enable, true,
+               "Arbitrates free video memory between Opacity Micromaps, unused BLAS and textures when it runs low.\n"
+               "Memory is reclaimed from one subsystem at a time in priority order (Opacity Micromaps first, textures last) rather than from all of them at once.");
+    RTX_OPTION("rtx.vramBudget", int, minFreeVidmemMB, 256, "Min free video memory [MB] below which memory is reclaimed from the subsystems under the VRAM budget.");
+    RTX_OPTION("rtx.vramBudget", int, growthCooldownFrames, 300,
+               "Number of frames a subsystem that gave up memory, and any subsystem of a lower priority than it, is not allowed to grow its budget again.\n"
+               "This avoids rebuilding the same data right after it has been evicted.");
+
+    struct ConsumerState {
+      bool isRegistered = false;
+      ConsumerDesc desc;
+    };
+
+    std::array<ConsumerState, static_cast<uint32_t>(Consumer::Count)> m_consumers;
+    VkDeviceSize m_vidmemFreeSize = 0;
+    uint32_t m_frameLastReclaimed = kInvalidFrameIndex;
+    uint32_t m_holdUntilFrame = 0;
+    uint32_t m_holdPriority = 0;
+  };
+
+} // namespace dxvk
@@ -0,0 +1,40 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LIGHT_TREE_H
+#define LIGHT_TREE_H
+
+// Note: Set in childOrLightIndex of leaf nodes, the remaining bits are the index of the light in the light buffer.
+// Inner nodes store the index of their first child instead, the second child always directly follows the first.
+static const uint lightTreeLeafFlag = 0x80000000u;
+
+// Node of the light tree local lights are importance sampled from, see lightTreeSample. The tree is built on
+// the CPU over all lights except distant ones, the root is the first node.
+struct LightTreeNode
+{
+  vec3 boundsMin;
+  // Sum of the estimated power of all lights below this node
+  float power;
+  vec3 boundsMax;
+  uint childOrLightIndex;
+};
+
+#endif // LIGHT_TREE_H
@@ -289,6 +289,12 @@ struct Surface
     set { data0b.z = 0; }
   }
 
+  // See SURFACE_SORT_KEY_* for the encoding
+  property uint8_t sortKey
+  {
+    get { return uint8_t(data0b.z >> 8); }
+  }
+
   property uint16_t hashPacked
   {
     get { return data0b.w; }
@@ -47,8 +47,9 @@
 #define BINDING_GPU_PRINT_BUFFER                 16
 #define BINDING_VALUE_NOISE_SAMPLER              17
 #define BINDING_SAMPLER_READBACK_BUFFER          18
+#define BINDING_LIGHT_TREE_BUFFER                19
 
-#define COMMON_MAX_BINDING                       BINDING_SAMPLER_READBACK_BUFFER
+#define COMMON_MAX_BINDING                       BINDING_LIGHT_TREE_BUFFER
 #define COMMON_NUM_BINDINGS                      (COMMON_MAX_BINDING + 1)
 
 // Note: Used to represent a non-existent buffer and material index in the Surface,
@@ -82,6 +83,7 @@
   RW_TEXTURE2D(BINDING_DEBUG_VIEW_TEXTURE)                          \
   RW_STRUCTURED_BUFFER(BINDING_GPU_PRINT_BUFFER)                    \
   SAMPLER3D(BINDING_VALUE_NOISE_SAMPLER)                            \
-  RW_STRUCTURED_BUFFER(BINDING_SAMPLER_READBACK_BUFFER)
+  RW_STRUCTURED_BUFFER(BINDING_SAMPLER_READBACK_BUFFER)            \
+  STRUCTURED_BUFFER(BINDING_LIGHT_TREE_BUFFER)
   
 #endif
@@ -65,6 +65,7 @@
 // Outputs
 
 #define DEBUG_VIEW_BINDING_STATISTICS_BUFFER_OUTPUT                                        90
+#define DEBUG_VIEW_BINDING_STATISTICS_MIN_MAX_BUFFER_OUTPUT                                91
 
 // Samplers
 
@@ -0,0 +1,56 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#ifndef HALF_RESOLUTION_DENOISE_H
+#define HALF_RESOLUTION_DENOISE_H
+
+#include "rtx/utility/shader_types.h"
+
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_INPUT           0
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_INPUT          1
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_INPUT  2
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_INPUT     3
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_INPUT     4
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_DIFFUSE_OUTPUT          5
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_SPECULAR_OUTPUT         6
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_NORMAL_ROUGHNESS_OUTPUT 7
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_LINEAR_VIEW_Z_OUTPUT    8
+#define HALF_RESOLUTION_DENOISE_DOWNSAMPLE_MOTION_VECTOR_OUTPUT    9
+
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_INPUT             0
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_INPUT            1
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_HALF_LINEAR_VIEW_Z_INPUT  2
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_LINEAR_VIEW_Z_INPUT       3
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_DIFFUSE_OUTPUT            4
+#define HALF_RESOLUTION_DENOISE_UPSAMPLE_SPECULAR_OUTPUT           5
+
+// Relative view Z difference up to which two samples are considered to be on the same surface
+#define HALF_RESOLUTION_DENOISE_DEPTH_TOLERANCE 0.05f
+
+// Push constants
+
+struct HalfResolutionDenoiseArgs {
+  uint2 fullResolution;
+  uint2 halfResolution;
+  float missLinearViewZ;
+};
+
+#endif  // HALF_RESOLUTION_DENOISE_H
@@ -30,13 +30,14 @@
 #define BINDING_BLEND_INDICES_INPUT   4
 #define BINDING_NORMAL_OUTPUT         5
 #define BINDING_NORMAL_INPUT          6
+#define BINDING_BONE_PALETTE_INPUT    7
 
 /**
 * \brief Args required to perform skinning
+*
+* The bone matrices are read from a separate palette buffer holding only the bones of the draw.
 */
 struct SkinningArgs {
-  mat4 bones[256]; // 256 is the max bone count in DX (swvp)
-
   uint dstPositionOffset;
   uint dstPositionStride;
   uint srcPositionOffset;
@@ -141,3 +141,20 @@
 #define CUSTOM_INDEX_MATERIAL_TYPE_BIT (21)
 #define CUSTOM_INDEX_SURFACE_MASK      ((1 << CUSTOM_INDEX_MATERIAL_TYPE_BIT) - 1)
 
+// Surface coherence sort key encoding, from the most to the least important bits, see AccelManager::uploadSurfaceData().
+// The leading bits are used as Shader Execution Reordering coherence hints when the integrator hits the surface.
+#define SURFACE_SORT_KEY_NUM_BITS              6
+#define SURFACE_SORT_KEY_MATERIAL_TYPE_BIT     4 // 2 bits, the surface material type
+#define SURFACE_SORT_KEY_MATERIAL_FEATURE_BIT  2 // 2 bits, SURFACE_SORT_KEY_FEATURE_*
+#define SURFACE_SORT_KEY_CATEGORY_BIT          0 // 2 bits, SURFACE_SORT_KEY_CATEGORY_*
+
+#define SURFACE_SORT_KEY_FEATURE_NONE          0
+#define SURFACE_SORT_KEY_FEATURE_ALPHA         1 // Alpha tested or blended, e.g. foliage
+#define SURFACE_SORT_KEY_FEATURE_SUBSURFACE    2 // e.g. skin
+#define SURFACE_SORT_KEY_FEATURE_EMISSIVE      3
+
+#define SURFACE_SORT_KEY_CATEGORY_WORLD        0
+#define SURFACE_SORT_KEY_CATEGORY_CHARACTER    1 // View model and player model
+#define SURFACE_SORT_KEY_CATEGORY_PARTICLE     2 // Particles and beams
+#define SURFACE_SORT_KEY_CATEGORY_DECAL        3
+
@@ -0,0 +1,41 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "rtx/pass/common_binding_indices.h"
+
+// Inputs
+
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_SHARED_FLAGS_INPUT                          40
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_CONE_RADIUS_INPUT                   41
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_WORLD_POSITION_INPUT                42
+
+// Inputs/Outputs
+
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_DIFFUSE_RADIANCE_INPUT_OUTPUT   50
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_PRIMARY_INDIRECT_SPECULAR_RADIANCE_INPUT_OUTPUT  51
+
+#define INTERLEAVED_INDIRECT_RECONSTRUCTION_MIN_BINDING     INTERLEAVED_INDIRECT_RECONSTRUCTION_BINDING_SHARED_FLAGS_INPUT
+
+#if INTERLEAVED_INDIRECT_RECONSTRUCTION_MIN_BINDING <= COMMON_MAX_BINDING
+#error "Increase the base index of interleaved indirect reconstruction bindings to avoid overlap with common bindings!"
+#endif
@@ -60,7 +60,7 @@ struct ParticleSystemConstants {
   float farH;
   float isCameraLhs;
   float anisotropy;
-  uint pad2;
+  uint numberOfParticles;
 };
 
 struct GpuParticle {
@@ -73,6 +73,8 @@ struct GpuParticle {
   half pad;
 };
 
+#define DUST_PARTICLES_SIMULATE_THREAD_GROUP_SIZE 128
+
 // Inputs
 
 #define DUST_PARTICLES_BINDING_FILTERED_RADIANCE_Y_INPUT 40
@@ -82,9 +84,11 @@ struct GpuParticle {
 // Outputs
 
 #define DUST_PARTICLES_BINDING_PARTICLES_BUFFER_INOUT   50
+#define DUST_PARTICLES_BINDING_VISIBLE_INDICES_INOUT    51
+#define DUST_PARTICLES_BINDING_DRAW_ARGS_INOUT          52
 
 #define DUST_PARTICLES_MIN_BINDING                           DUST_PARTICLES_BINDING_FILTERED_RADIANCE_Y_INPUT
-#define DUST_PARTICLES_MAX_BINDING                           DUST_PARTICLES_BINDING_PARTICLES_BUFFER_INOUT
+#define DUST_PARTICLES_MAX_BINDING                           DUST_PARTICLES_BINDING_DRAW_ARGS_INOUT
 
 #if DUST_PARTICLES_MIN_BINDING <= COMMON_MAX_BINDING
 #error "Increase the base index of dust particles bindings to avoid overlap with common bindings!"
@@ -33,8 +33,9 @@
 #define POST_FX_MOTION_BLUR_NEAREST_SAMPLER                   6
 #define POST_FX_MOTION_BLUR_LINEAR_SAMPLER                    7
 
-#define POST_FX_INPUT  0
-#define POST_FX_OUTPUT 1
+#define POST_FX_INPUT       0
+#define POST_FX_OUTPUT      1
+#define POST_FX_BLOOM_INPUT 2
 
 #define POST_FX_HIGHLIGHT_INPUT                       0
 #define POST_FX_HIGHLIGHT_OBJECT_PICKING_INPUT        1
@@ -75,6 +76,12 @@ struct PostFxArgs {
   bool   enableMotionBlurEmissive;
   float  jitterStrength;
   float  motionBlurDlfgDeduction;
+
+  // Bloom composite, only used by the fused variant of the lens effect pass
+  float  bloomIntensity;
+  uint   pad0;
+  uint   pad1;
+  uint   pad2;
 };
 
 struct PostFxMotionBlurPrefilterArgs {
@@ -343,7 +343,7 @@ struct RaytraceArgs {
   float resolveStochasticAlphaBlendThreshold;
   float translucentDecalAlbedoFactor;
 
-  float pad;
+  uint enableReSTIRGIHalfResolutionReuse;
 
   float skyBrightness;
 
@@ -380,6 +380,24 @@ struct RaytraceArgs {
   // hence why it is not named enableNrcTraining here
   uint allowNrcTraining;
 
+  // Number of nodes in the light tree, local lights are sampled through the tree instead of their light ranges when non-zero
+  uint lightTreeNodeCount;
+  // Number of RIS candidates drawn from the light tree, replaces the RIS sample counts of the local light ranges
+  uint lightTreeRisSampleCount;
+
+  // Limits the indirect bounces of pixels with a stable primary surface and lighting, see rtx.adaptiveIndirectSampling
+  uint enableAdaptiveIndirectSampling;
+  uint adaptiveIndirectSamplingStableMaxBounces;
+  float adaptiveIndirectSamplingLightingChangeThreshold;
+
+  // 1 traces indirect rays for every pixel, 2 or 4 for one in as many pixels per frame, see rtx.interleavedIndirect
+  uint interleavedIndirectRate;
+  // Pixels within this fraction of half the screen height from the screen center are never interleaved, 0 interleaves every pixel
+  float interleavedIndirectFovealRadius;
+
+  // Number of leading surface sort key bits used as SER coherence hints in the integrator, see rtx.serSurfaceSortKeyHintBits
+  uint serSurfaceSortKeyHintBits;
+
   float vertexColorStrength;
   bool vertexColorIsBakedLighting;
 
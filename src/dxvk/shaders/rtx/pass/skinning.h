@@ -28,7 +28,6 @@ typedef Vector4i uint4;
 typedef Vector3 float3;
 typedef Vector4 float4;
 
-#define toMatrix4(m) (*reinterpret_cast<const Matrix4*>(&m))
 #define mul(mat, vec) (mat * vec)
 
 #define abs(x) std::abs(x)
@@ -51,7 +50,6 @@ float asfloat(uint u) {
   return *reinterpret_cast<const float*>(&u);
 }
 #else
-#define toMatrix4(x) x
 #define Matrix4 float4x4
 
 #define WriteBuffer(T) RWStructuredBuffer<T>
@@ -129,6 +127,7 @@ void skinning(const uint32_t idx,
               ReadBuffer(float) srcBlendWeight,
               ReadByteBuffer srcBlendIndices,
               ReadBuffer(float) srcNormal,
+              ReadBuffer(Matrix4) bones,
               ConstBuffer(SkinningArgs) cb) {
   const uint32_t baseWeightsOffset = (cb.blendWeightOffset + idx * cb.blendWeightStride) / 4;
 
@@ -168,7 +167,7 @@ void skinning(const uint32_t idx,
       for (uint i = 0; i < 4 && i + j < cb.numBones; ++i) {
         float blendWeight = i + j == cb.numBones - 1 ? lastWeight : srcBlendWeight[baseWeightsOffset + i + j];
         if (blendWeight > 0) {
-          Matrix4 bone = toMatrix4(cb.bones[blendIndices[i]]);
+          Matrix4 bone = bones[blendIndices[i]];
           positionOut += mul(bone, position) * blendWeight;
           normalOut += mul(bone, normal) * blendWeight;
         }
@@ -178,14 +177,14 @@ void skinning(const uint32_t idx,
     for (uint i = 0; i < cb.numBones - 1; ++i) {
       float blendWeight = srcBlendWeight[baseWeightsOffset + i];
       if (blendWeight > 0.f) {
-        Matrix4 bone = toMatrix4(cb.bones[i]);
+        Matrix4 bone = bones[i];
         positionOut += mul(bone, position) * blendWeight;
         normalOut += mul(bone, normal) * blendWeight;
       }
     }
     // Unwrap the last bone, since blendWeights only contains numBones - 1 weights
     if (lastWeight > 0.f) {
-      Matrix4 bone = toMatrix4(cb.bones[cb.numBones - 1]);
+      Matrix4 bone = bones[cb.numBones - 1];
       positionOut += mul(bone, position) * lastWeight;
       normalOut += mul(bone, normal) * lastWeight;
     }
@@ -216,7 +215,6 @@ void skinning(const uint32_t idx,
 #ifdef __cplusplus
 #undef WriteBuffer
 #undef ReadBuffer
-#undef toMatrix4
 #undef mul
 #undef max
 #undef abs
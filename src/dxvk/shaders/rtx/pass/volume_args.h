@@ -98,7 +98,11 @@ struct VolumeArgs {
 
   float maxAttenuationDistanceForNoAtmosphere;
   uint resetHistory;
-  vec2 pad0;
+  // Note: Froxels with at least this much history are only traced once every stableFroxelUpdateInterval frames,
+  // an interval of 1 traces every froxel every frame.
+  uint16_t stableFroxelUpdateInterval;
+  uint16_t pad0;
+  float stableFroxelMinHistoryAge;
 };
 
 #ifdef __cplusplus
@@ -69,11 +69,14 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <thread>
+#include <vector>
 
 // Embedded MDLs
 #include <AperturePBR_Opacity.mdl.h>
@@ -165,6 +168,41 @@ lss::Skeleton generateSkeleton(const size_t numBones,
   return output;
 }
 
+// Runs func on every value of the map, spread over a few threads. Used for writing
+// layers that don't depend on each other, USD is fine with authoring separate layers
+// concurrently.
+template<typename MapType, typename FuncType>
+void parallelForEachValue(const MapType& map, const FuncType& func) {
+  static constexpr size_t kMaxWriterThreads = 8;
+  std::vector<const typename MapType::mapped_type*> values;
+  values.reserve(map.size());
+  for (const auto& [key, value] : map) {
+    values.push_back(&value);
+  }
+  const size_t numThreads = std::min({ values.size(), kMaxWriterThreads, size_t(std::max(std::thread::hardware_concurrency(), 1u)) });
+  if (numThreads <= 1) {
+    for (const auto* pValue : values) {
+      func(*pValue);
+    }
+    return;
+  }
+  std::atomic<size_t> nextIdx = 0;
+  auto worker = [&]() {
+    for (size_t idx = nextIdx++; idx < values.size(); idx = nextIdx++) {
+      func(*values[idx]);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 }
 
 namespace lss {
@@ -192,12 +230,16 @@ std::string getExtension(std::filesystem::path path) {
   return path.extension().generic_string();
 }
 
+std::string GameExporter::getStageExtension(const Export& exportData) {
+  return (exportData.bExportInstanceStage) ? getExtension(exportData.instanceStagePath) : lss::ext::usd;
+}
+
 void GameExporter::exportUsdInternal(const Export& exportData) {
   dxvk::Logger::info("[GameExporter][" + exportData.debugId + "] Export start");
   ExportContext ctx;
   lss::GameExporter::createApertureMdls(exportData.baseExportPath);
   ctx.instanceStage = (exportData.bExportInstanceStage) ? createInstanceStage(exportData) : pxr::UsdStageRefPtr();
-  ctx.extension = (exportData.bExportInstanceStage) ? getExtension(exportData.instanceStagePath) : lss::ext::usd;
+  ctx.extension = getStageExtension(exportData);
   exportMaterials(exportData, ctx);
   exportMeshes(exportData, ctx);
   exportSkeletons(exportData, ctx);
@@ -338,84 +380,92 @@ static std::unordered_map<Enum,AttrDesc> attrDescs{
 }
 }
 
-void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx) {
-  dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportMaterials] Begin");
+void GameExporter::writeMaterialStage(const Export& exportData,
+                                      const std::string& extension,
+                                      const Material& matData,
+                                      const std::string& fullMaterialBasePath) {
   const std::string matDirPath = exportData.baseExportPath + "/" + commonDirName::matDir;
-  const std::string fullMaterialBasePath = computeLocalPath(matDirPath);
-  
-  dxvk::env::createDirectory(matDirPath);
-  for(const auto& [matId, matData] : exportData.materials) {
-    // Build material stage
-    const std::string matName = prefix::mat + matData.matName;
-    const std::string matStageName = matName + ctx.extension;
-    const std::string matStagePath = matDirPath + matStageName;
-    pxr::UsdStageRefPtr matStage = findOpenOrCreateStage(matStagePath, true);
-    assert(matStage);
-    setCommonStageMetaData(matStage, exportData);
-
-    // Add Looks + RootPrim prims
-    const auto looksSdfPath = gStageRootPath.AppendChild(gTokLooks);
-    const auto looksScopePrim = matStage->DefinePrim(looksSdfPath, gTokScope);
-    assert(looksScopePrim);
-    matStage->SetDefaultPrim(looksScopePrim);
-
-    // Create material prim
-    const auto matSdfPath = looksSdfPath.AppendElementString(matName);
-    const auto matSchema = pxr::UsdShadeMaterial::Define(matStage, matSdfPath);
-    assert(matSchema);
-    const auto matPrim = matSchema.GetPrim();
-    assert(matPrim);
-
-    // Create shader prim under material prim
-    static const pxr::TfToken kTokShader("Shader");
-    const auto shaderPath = matPrim.GetPath().AppendChild(kTokShader);
-    const auto shader = pxr::UsdShadeShader::Define(matStage, shaderPath);
-    const auto shaderPrim = shader.GetPrim();
-    assert(shaderPrim);
-
-    std::unordered_map<ShaderAttr::Enum, pxr::UsdAttribute> shaderAttrs;
-    for(const auto& [attrEnum, desc] : ShaderAttr::attrDescs) {
-      shaderAttrs[attrEnum] =
-        shaderPrim.CreateAttribute(desc.attrName, desc.typeName, desc.custom, desc.sdfVariability);
-      // Cannot assert. Attr "outputs:out" asserts false, but authoring + Setting works just fine.
-      // assert(shaderAttrs[attrEnum]); 
-    }
+  // Build material stage
+  const std::string matName = prefix::mat + matData.matName;
+  const std::string matStagePath = matDirPath + matName + extension;
+  pxr::UsdStageRefPtr matStage = findOpenOrCreateStage(matStagePath, true);
+  assert(matStage);
+  setCommonStageMetaData(matStage, exportData);
+
+  // Add Looks + RootPrim prims
+  const auto looksSdfPath = gStageRootPath.AppendChild(gTokLooks);
+  const auto looksScopePrim = matStage->DefinePrim(looksSdfPath, gTokScope);
+  assert(looksScopePrim);
+  matStage->SetDefaultPrim(looksScopePrim);
+
+  // Create material prim
+  const auto matSdfPath = looksSdfPath.AppendElementString(matName);
+  const auto matSchema = pxr::UsdShadeMaterial::Define(matStage, matSdfPath);
+  assert(matSchema);
+  const auto matPrim = matSchema.GetPrim();
+  assert(matPrim);
+
+  // Create shader prim under material prim
+  static const pxr::TfToken kTokShader("Shader");
+  const auto shaderPath = matPrim.GetPath().AppendChild(kTokShader);
+  const auto shader = pxr::UsdShadeShader::Define(matStage, shaderPath);
+  const auto shaderPrim = shader.GetPrim();
+  assert(shaderPrim);
+
+  std::unordered_map<ShaderAttr::Enum, pxr::UsdAttribute> shaderAttrs;
+  for(const auto& [attrEnum, desc] : ShaderAttr::attrDescs) {
+    shaderAttrs[attrEnum] =
+      shaderPrim.CreateAttribute(desc.attrName, desc.typeName, desc.custom, desc.sdfVariability);
+    // Cannot assert. Attr "outputs:out" asserts false, but authoring + Setting works just fine.
+    // assert(shaderAttrs[attrEnum]); 
+  }
 
-    // Create and connect material outputs to shader outputs
-    static const pxr::TfToken kTokOutputsMdlSurface("outputs:mdl:surface");
-    const auto outputsMdlSurfaceAttr =
-      matPrim.CreateAttribute(kTokOutputsMdlSurface, pxr::SdfValueTypeNames->Token, false, pxr::SdfVariabilityVarying);
-    outputsMdlSurfaceAttr.AddConnection(shaderAttrs[ShaderAttr::OutputsOut].GetPath(), pxr::UsdListPositionFrontOfAppendList);
+  // Create and connect material outputs to shader outputs
+  static const pxr::TfToken kTokOutputsMdlSurface("outputs:mdl:surface");
+  const auto outputsMdlSurfaceAttr =
+    matPrim.CreateAttribute(kTokOutputsMdlSurface, pxr::SdfValueTypeNames->Token, false, pxr::SdfVariabilityVarying);
+  outputsMdlSurfaceAttr.AddConnection(shaderAttrs[ShaderAttr::OutputsOut].GetPath(), pxr::UsdListPositionFrontOfAppendList);
 
-    // Set shader "Kind"
-    static const pxr::TfToken kTokMaterial("Material");
-    pxr::UsdModelAPI(shader).SetKind(kTokMaterial);
+  // Set shader "Kind"
+  static const pxr::TfToken kTokMaterial("Material");
+  pxr::UsdModelAPI(shader).SetKind(kTokMaterial);
 
-    // Create and set textures asset paths on material
-    const auto relToMaterialsTexPath =
-      std::filesystem::relative(computeLocalPath(matData.albedoTexPath), fullMaterialBasePath).string();
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::DiffuseTex].Set(pxr::SdfAssetPath(relToMaterialsTexPath)));
-    shaderAttrs[ShaderAttr::DiffuseTex].SetColorSpace(pxr::TfToken("auto"));
+  // Create and set textures asset paths on material
+  const auto relToMaterialsTexPath =
+    std::filesystem::relative(computeLocalPath(matData.albedoTexPath), fullMaterialBasePath).string();
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::DiffuseTex].Set(pxr::SdfAssetPath(relToMaterialsTexPath)));
+  shaderAttrs[ShaderAttr::DiffuseTex].SetColorSpace(pxr::TfToken("auto"));
 
-    // Create and set OmniPBR MDL boilerplate attributes on shader
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::ImplSrc].Set(pxr::TfToken("sourceAsset")));
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::MdlSrcAsset].Set(pxr::SdfAssetPath("./AperturePBR_Opacity.mdl")));
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::MdlSrcAssetSubId].Set(pxr::TfToken("AperturePBR_Opacity")));
+  // Create and set OmniPBR MDL boilerplate attributes on shader
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::ImplSrc].Set(pxr::TfToken("sourceAsset")));
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::MdlSrcAsset].Set(pxr::SdfAssetPath("./AperturePBR_Opacity.mdl")));
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::MdlSrcAssetSubId].Set(pxr::TfToken("AperturePBR_Opacity")));
 
-    // Mark whether to enable varying opacity
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::Opacity].Set(matData.enableOpacity));
+  // Mark whether to enable varying opacity
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::Opacity].Set(matData.enableOpacity));
 
-    // Sampler State
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::FilterMode].Set((uint32_t)lss::Mdl::Filter::vkToMdl(matData.sampler.filter)));
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeU].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeU)));
-    ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeV].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeV)));
+  // Sampler State
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::FilterMode].Set((uint32_t)lss::Mdl::Filter::vkToMdl(matData.sampler.filter)));
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeU].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeU)));
+  ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeV].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeV)));
 
-    matStage->Save();
-    
+  matStage->Save();
+}
+
+void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx) {
+  dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportMaterials] Begin");
+  const std::string matDirPath = exportData.baseExportPath + "/" + commonDirName::matDir;
+  const std::string fullMaterialBasePath = computeLocalPath(matDirPath);
+  
+  dxvk::env::createDirectory(matDirPath);
+  // Every material has a layer of its own, only the instance stage needs to be authored serially
+  parallelForEachValue(exportData.materials, [&](const Material& matData) {
+    writeMaterialStage(exportData, ctx.extension, matData, fullMaterialBasePath);
+  });
+  for(const auto& [matId, matData] : exportData.materials) {
+    const std::string matName = prefix::mat + matData.matName;
     // Cache material reference
-    Reference matLssReference;
-    matLssReference.stagePath = matStagePath;
-    matLssReference.ogSdfPath = matSdfPath;
+    Reference matLssReference = getMaterialReference(exportData, ctx.extension, matData);
 
     // Build matSchema prim on instance stage
     if(ctx.instanceStage != nullptr) {
@@ -425,7 +475,7 @@ void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx)
       
       const std::string relMeshStagePath = commonDirName::matDir + matName + ctx.extension;
       auto matInstanceUsdReferences = matInstanceSchema.GetPrim().GetReferences();
-      matInstanceUsdReferences.AddReference(relMeshStagePath, matSdfPath);
+      matInstanceUsdReferences.AddReference(relMeshStagePath, matLssReference.ogSdfPath);
       
       matLssReference.instanceSdfPath = matInstanceSdfPath;
     }
@@ -511,187 +561,241 @@ void GameExporter::exportSkeletons(const Export& exportData, ExportContext& ctx)
   dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportSkeletons] End");
 }
 
-void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
-  dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportMeshes] Begin");
-  static const pxr::GfMatrix4d identity(1);
-  const std::string relMeshDirPath = commonDirName::meshDir + "/";
-  const std::string meshDirPath = exportData.baseExportPath + "/" + relMeshDirPath;
-  const std::string fullMeshStagePath = computeLocalPath(meshDirPath);
-  dxvk::env::createDirectory(meshDirPath);
+static void getMeshInversion(const Camera& camera, bool& bInvX, bool& bInvY) {
   // Determine whether meshes need to be inverted
-  const bool bInvX = (!exportData.camera.view.bInv) && (exportData.camera.proj.bInv || exportData.camera.isLHS());
-  const bool bInvY = (!exportData.camera.view.bInv) && exportData.camera.proj.bInv;
-  for(const auto& [meshId,mesh] : exportData.meshes) {
-    assert(mesh.numVertices > 0);
-    assert(mesh.numIndices > 0);
+  bInvX = (!camera.view.bInv) && (camera.proj.bInv || camera.isLHS());
+  bInvY = (!camera.view.bInv) && camera.proj.bInv;
+}
 
-    const bool isSkeleton = mesh.numBones > 0;
+pxr::SdfPath GameExporter::getMeshXformSdfPath(const Export& exportData, const std::string& meshName) {
+  bool bInvX, bInvY;
+  getMeshInversion(exportData.camera, bInvX, bInvY);
+  const bool visualCorrectionReqd = exportData.meta.bCorrectBakedTransforms || bInvX || bInvY;
+  if (visualCorrectionReqd) {
+    return gStageRootPath.AppendElementString("visual_correction").AppendElementString(meshName);
+  }
+  return gStageRootPath.AppendElementString(meshName);
+}
 
-    // Build mesh stage
-    const std::string meshName = prefix::mesh + mesh.meshName;
-    const std::string meshStagePath = meshDirPath + meshName + ctx.extension;
-    pxr::UsdStageRefPtr meshStage = findOpenOrCreateStage(meshStagePath, true);
-    assert(meshStage);
-    setCommonStageMetaData(meshStage, exportData);
+GameExporter::Reference GameExporter::getMaterialReference(const Export& exportData, const std::string& extension, const Material& mat) {
+  const std::string matName = prefix::mat + mat.matName;
+  Reference matLssReference;
+  matLssReference.stagePath = exportData.baseExportPath + "/" + commonDirName::matDir + matName + extension;
+  matLssReference.ogSdfPath = gStageRootPath.AppendChild(gTokLooks).AppendElementString(matName);
+  return matLssReference;
+}
 
-    pxr::VtDictionary customLayerData = meshStage->GetRootLayer()->GetCustomLayerData();
-    for (auto& component : mesh.componentHashes) {
-      customLayerData.SetValueAtPath(component.first, pxr::VtValue(component.second));
-    }
-    meshStage->GetRootLayer()->SetCustomLayerData(customLayerData);
-
-    pxr::SdfPath meshXformSdfPath;
-    const bool visualCorrectionReqd = exportData.meta.bCorrectBakedTransforms || bInvX || bInvY;
-    if (visualCorrectionReqd) {
-      const auto correctionXformSdfPath = gStageRootPath.AppendElementString("visual_correction");
-      auto correctionXformSchema = pxr::UsdGeomXform::Define(meshStage, correctionXformSdfPath);
-      auto correctionXformOp = correctionXformSchema.AddTransformOp();
-      assert(correctionXformOp);
-      pxr::GfMatrix4d xform { 1.0 };
-      const pxr::GfVec3d scale{ (bInvX) ? -1.0 : 1.0,
-                                (bInvY) ? -1.0 : 1.0, 1.0};
-      xform.SetScale(scale);
-      const pxr::GfVec3d dOrigin{
-        (bInvX) ? -mesh.origin[0] : mesh.origin[0],
-        (bInvY) ? -mesh.origin[1] : mesh.origin[1],
-        mesh.origin[2]};
-      xform.SetTranslateOnly(-dOrigin);
-      correctionXformOp.Set(xform);
-      meshXformSdfPath = correctionXformSdfPath.AppendElementString(meshName);
-    } else {
-      meshXformSdfPath = gStageRootPath.AppendElementString(meshName);
-    }
+void GameExporter::exportMeshStage(const Export& exportData, const Mesh& mesh) {
+  assert(mesh.numBones == 0);
+  const std::string extension = getStageExtension(exportData);
+  const std::string meshDirPath = exportData.baseExportPath + "/" + commonDirName::meshDir + "/";
+  dxvk::env::createDirectory(meshDirPath);
+  const auto matIt = exportData.materials.find(mesh.matId);
+  const bool bHasMat = mesh.matId != kInvalidId && matIt != exportData.materials.end();
+  const Reference matLssReference = (bHasMat) ? getMaterialReference(exportData, extension, matIt->second) : Reference();
+  writeMeshStage(exportData, extension, mesh, computeLocalPath(meshDirPath), (bHasMat) ? &matLssReference : nullptr);
+}
 
-    // Build mesh xform prim on mesh stage, make it visible
-    pxr::UsdGeomXformable meshXformSchema;
-    if (isSkeleton) {
-      meshXformSchema = pxr::UsdSkelRoot::Define(meshStage, meshXformSdfPath);
-    } else {
-      meshXformSchema = pxr::UsdGeomXform::Define(meshStage, meshXformSdfPath);
-    }
-    assert(meshXformSchema);
-    meshStage->SetDefaultPrim(meshXformSchema.GetPrim());
-    auto meshXformVisibilityAttr = meshXformSchema.CreateVisibilityAttr();
-    assert(meshXformVisibilityAttr);
-    meshXformVisibilityAttr.Set(gVisibilityInherited);
-
-    // Build mesh geometry prim under above xform
-    const auto meshSchemaSdfPath = meshXformSdfPath.AppendChild(gTokMesh);
-    pxr::UsdGeomMesh meshSchema = pxr::UsdGeomMesh::Define(meshStage, meshSchemaSdfPath);
-    pxr::UsdGeomPrimvarsAPI primvarsAPI(meshSchema.GetPrim());
-
-    assert(meshSchema);
-    auto meshVisibilityAttr = meshSchema.CreateVisibilityAttr();
-    assert(meshVisibilityAttr);
-    meshVisibilityAttr.Set(gVisibilityInherited);
-
-    auto meshXformOp = meshSchema.AddTransformOp();
-    assert(meshXformOp);
+void GameExporter::writeMeshStage(const Export& exportData,
+                                  const std::string& extension,
+                                  const Mesh& mesh,
+                                  const std::string& fullMeshStagePath,
+                                  const Reference* pMatReference) {
+  const std::string meshDirPath = exportData.baseExportPath + "/" + commonDirName::meshDir + "/";
+  const bool isSkeleton = mesh.numBones > 0;
+  bool bInvX, bInvY;
+  getMeshInversion(exportData.camera, bInvX, bInvY);
+
+  // Build mesh stage
+  const std::string meshName = prefix::mesh + mesh.meshName;
+  const std::string meshStagePath = meshDirPath + meshName + extension;
+  pxr::UsdStageRefPtr meshStage = findOpenOrCreateStage(meshStagePath, true);
+  assert(meshStage);
+  setCommonStageMetaData(meshStage, exportData);
+
+  pxr::VtDictionary customLayerData = meshStage->GetRootLayer()->GetCustomLayerData();
+  for (auto& component : mesh.componentHashes) {
+    customLayerData.SetValueAtPath(component.first, pxr::VtValue(component.second));
+  }
+  meshStage->GetRootLayer()->SetCustomLayerData(customLayerData);
+
+  const pxr::SdfPath meshXformSdfPath = getMeshXformSdfPath(exportData, meshName);
+  const bool visualCorrectionReqd = exportData.meta.bCorrectBakedTransforms || bInvX || bInvY;
+  if (visualCorrectionReqd) {
+    const auto correctionXformSdfPath = meshXformSdfPath.GetParentPath();
+    auto correctionXformSchema = pxr::UsdGeomXform::Define(meshStage, correctionXformSdfPath);
+    auto correctionXformOp = correctionXformSchema.AddTransformOp();
+    assert(correctionXformOp);
     pxr::GfMatrix4d xform { 1.0 };
-    xform = mesh.isLhs ? dxvk::swapBasis(xform) : xform;
-    meshXformOp.Set(xform);
-
-    // Set double-sidedness attribute
-    auto doubleSidedAttr = meshSchema.CreateDoubleSidedAttr();
-    assert(doubleSidedAttr);
-    doubleSidedAttr.Set(mesh.isDoubleSided);
-
-    // Set orientation attribute
-    auto orientationAttr = meshSchema.CreateOrientationAttr();
-    assert(orientationAttr);
-    orientationAttr.Set(pxr::VtValue(pxr::UsdGeomTokens->rightHanded));
-
-    // Create corresponding attribute arrays using above populated VtArrays
-    pxr::VtArray<int> faceVertexCounts;
-    faceVertexCounts.assign(mesh.numIndices / 3, 3);
-    auto faceVertexCountsAttr = meshSchema.CreateFaceVertexCountsAttr();
-    assert(faceVertexCountsAttr);
-    faceVertexCountsAttr.Set(faceVertexCounts);
-
-    for (auto& pair : mesh.categoryFlags) {
-      const auto attribute = meshSchema.GetPrim().CreateAttribute(pxr::TfToken(pair.first), pxr::SdfValueTypeNames->Bool, true, pxr::SdfVariabilityUniform);
-      attribute.Set(pxr::VtValue(pair.second));
-    }
+    const pxr::GfVec3d scale{ (bInvX) ? -1.0 : 1.0,
+                              (bInvY) ? -1.0 : 1.0, 1.0};
+    xform.SetScale(scale);
+    const pxr::GfVec3d dOrigin{
+      (bInvX) ? -mesh.origin[0] : mesh.origin[0],
+      (bInvY) ? -mesh.origin[1] : mesh.origin[1],
+      mesh.origin[2]};
+    xform.SetTranslateOnly(-dOrigin);
+    correctionXformOp.Set(xform);
+  }
 
-    // Indices
-    const bool reduce = exportData.meta.bReduceMeshBuffers;
-    ReducedIdxBufSet reducedIdxBufSet = reduce ? reduceIdxBufferSet(mesh.buffers.idxBufs) : ReducedIdxBufSet();
-    const BufSet<Index>& idxBufSet = reduce ? reducedIdxBufSet.bufSet : mesh.buffers.idxBufs;
-    auto indexAttr = meshSchema.CreateFaceVertexIndicesAttr();
-    assert(indexAttr);
-    exportBufferSet(idxBufSet, indexAttr);
-    // Vertices
-    const auto& posBufs = mesh.buffers.positionBufs;
-    auto pointsAttr = meshSchema.CreatePointsAttr();
-    assert(pointsAttr);
-    exportBufferSet(reduce ? reduceBufferSet(posBufs, reducedIdxBufSet) : posBufs, pointsAttr);
-    // Normals
-    auto normalsAttr = meshSchema.CreateNormalsAttr();
-    assert(normalsAttr);
-    exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.normalBufs, reducedIdxBufSet) : mesh.buffers.normalBufs, normalsAttr);
-    // Set subdivision scheme to None (USD defaults to catmull clark)
-    auto subdivAttr = meshSchema.CreateSubdivisionSchemeAttr();
-    assert(subdivAttr);
-    subdivAttr.Set(pxr::UsdGeomTokens->none);
-    // Texture Coordinates
-    static const pxr::TfToken kTokSt("st");
-    auto stAttr = primvarsAPI.CreatePrimvar(kTokSt, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->vertex);
-    assert(stAttr);
-    exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.texcoordBufs, reducedIdxBufSet) : mesh.buffers.texcoordBufs, stAttr);
-
-    // Vertex Colors
-    if (mesh.buffers.colorBufs.size() > 0) {
-      auto displayColorPrimvar = meshSchema.CreateDisplayColorPrimvar(pxr::UsdGeomTokens->vertex);
-      auto displayOpacityPrimvar = meshSchema.CreateDisplayOpacityPrimvar(pxr::UsdGeomTokens->vertex);
-      assert(displayColorPrimvar);
-      assert(displayOpacityPrimvar);
-      if (mesh.buffers.colorBufs.cbegin()->second.size() == 1) {
-        // Constant Color
-        displayColorPrimvar.SetInterpolation(pxr::UsdGeomTokens->constant);
-        displayOpacityPrimvar.SetInterpolation(pxr::UsdGeomTokens->constant);
-      }
-      exportColorOpacityBufferSet(reduce ? reduceBufferSet(mesh.buffers.colorBufs, reducedIdxBufSet) : mesh.buffers.colorBufs, displayColorPrimvar, displayOpacityPrimvar);
+  // Build mesh xform prim on mesh stage, make it visible
+  pxr::UsdGeomXformable meshXformSchema;
+  if (isSkeleton) {
+    meshXformSchema = pxr::UsdSkelRoot::Define(meshStage, meshXformSdfPath);
+  } else {
+    meshXformSchema = pxr::UsdGeomXform::Define(meshStage, meshXformSdfPath);
+  }
+  assert(meshXformSchema);
+  meshStage->SetDefaultPrim(meshXformSchema.GetPrim());
+  auto meshXformVisibilityAttr = meshXformSchema.CreateVisibilityAttr();
+  assert(meshXformVisibilityAttr);
+  meshXformVisibilityAttr.Set(gVisibilityInherited);
+
+  // Build mesh geometry prim under above xform
+  const auto meshSchemaSdfPath = meshXformSdfPath.AppendChild(gTokMesh);
+  pxr::UsdGeomMesh meshSchema = pxr::UsdGeomMesh::Define(meshStage, meshSchemaSdfPath);
+  pxr::UsdGeomPrimvarsAPI primvarsAPI(meshSchema.GetPrim());
+
+  assert(meshSchema);
+  auto meshVisibilityAttr = meshSchema.CreateVisibilityAttr();
+  assert(meshVisibilityAttr);
+  meshVisibilityAttr.Set(gVisibilityInherited);
+
+  auto meshXformOp = meshSchema.AddTransformOp();
+  assert(meshXformOp);
+  pxr::GfMatrix4d xform { 1.0 };
+  xform = mesh.isLhs ? dxvk::swapBasis(xform) : xform;
+  meshXformOp.Set(xform);
+
+  // Set double-sidedness attribute
+  auto doubleSidedAttr = meshSchema.CreateDoubleSidedAttr();
+  assert(doubleSidedAttr);
+  doubleSidedAttr.Set(mesh.isDoubleSided);
+
+  // Set orientation attribute
+  auto orientationAttr = meshSchema.CreateOrientationAttr();
+  assert(orientationAttr);
+  orientationAttr.Set(pxr::VtValue(pxr::UsdGeomTokens->rightHanded));
+
+  // Create corresponding attribute arrays using above populated VtArrays
+  pxr::VtArray<int> faceVertexCounts;
+  faceVertexCounts.assign(mesh.numIndices / 3, 3);
+  auto faceVertexCountsAttr = meshSchema.CreateFaceVertexCountsAttr();
+  assert(faceVertexCountsAttr);
+  faceVertexCountsAttr.Set(faceVertexCounts);
+
+  for (auto& pair : mesh.categoryFlags) {
+    const auto attribute = meshSchema.GetPrim().CreateAttribute(pxr::TfToken(pair.first), pxr::SdfValueTypeNames->Bool, true, pxr::SdfVariabilityUniform);
+    attribute.Set(pxr::VtValue(pair.second));
+  }
+
+  // Indices
+  const bool reduce = exportData.meta.bReduceMeshBuffers;
+  ReducedIdxBufSet reducedIdxBufSet = reduce ? reduceIdxBufferSet(mesh.buffers.idxBufs) : ReducedIdxBufSet();
+  const BufSet<Index>& idxBufSet = reduce ? reducedIdxBufSet.bufSet : mesh.buffers.idxBufs;
+  auto indexAttr = meshSchema.CreateFaceVertexIndicesAttr();
+  assert(indexAttr);
+  exportBufferSet(idxBufSet, indexAttr);
+  // Vertices
+  const auto& posBufs = mesh.buffers.positionBufs;
+  auto pointsAttr = meshSchema.CreatePointsAttr();
+  assert(pointsAttr);
+  exportBufferSet(reduce ? reduceBufferSet(posBufs, reducedIdxBufSet) : posBufs, pointsAttr);
+  // Normals
+  auto normalsAttr = meshSchema.CreateNormalsAttr();
+  assert(normalsAttr);
+  exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.normalBufs, reducedIdxBufSet) : mesh.buffers.normalBufs, normalsAttr);
+  // Set subdivision scheme to None (USD defaults to catmull clark)
+  auto subdivAttr = meshSchema.CreateSubdivisionSchemeAttr();
+  assert(subdivAttr);
+  subdivAttr.Set(pxr::UsdGeomTokens->none);
+  // Texture Coordinates
+  static const pxr::TfToken kTokSt("st");
+  auto stAttr = primvarsAPI.CreatePrimvar(kTokSt, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->vertex);
+  assert(stAttr);
+  exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.texcoordBufs, reducedIdxBufSet) : mesh.buffers.texcoordBufs, stAttr);
+
+  // Vertex Colors
+  if (mesh.buffers.colorBufs.size() > 0) {
+    auto displayColorPrimvar = meshSchema.CreateDisplayColorPrimvar(pxr::UsdGeomTokens->vertex);
+    auto displayOpacityPrimvar = meshSchema.CreateDisplayOpacityPrimvar(pxr::UsdGeomTokens->vertex);
+    assert(displayColorPrimvar);
+    assert(displayOpacityPrimvar);
+    if (mesh.buffers.colorBufs.cbegin()->second.size() == 1) {
+      // Constant Color
+      displayColorPrimvar.SetInterpolation(pxr::UsdGeomTokens->constant);
+      displayOpacityPrimvar.SetInterpolation(pxr::UsdGeomTokens->constant);
     }
-    
-    if (isSkeleton) {
-      pxr::UsdSkelBindingAPI skelBind = pxr::UsdSkelBindingAPI::Apply(meshSchema.GetPrim());
+    exportColorOpacityBufferSet(reduce ? reduceBufferSet(mesh.buffers.colorBufs, reducedIdxBufSet) : mesh.buffers.colorBufs, displayColorPrimvar, displayOpacityPrimvar);
+  }
+  
+  if (isSkeleton) {
+    pxr::UsdSkelBindingAPI skelBind = pxr::UsdSkelBindingAPI::Apply(meshSchema.GetPrim());
 
-      auto jointWeightsAttr = skelBind.CreateJointWeightsPrimvar(0, mesh.bonesPerVertex);
-      assert(jointWeightsAttr);
-      exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.blendWeightBufs, reducedIdxBufSet, mesh.bonesPerVertex) : mesh.buffers.blendWeightBufs, jointWeightsAttr);
+    auto jointWeightsAttr = skelBind.CreateJointWeightsPrimvar(0, mesh.bonesPerVertex);
+    assert(jointWeightsAttr);
+    exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.blendWeightBufs, reducedIdxBufSet, mesh.bonesPerVertex) : mesh.buffers.blendWeightBufs, jointWeightsAttr);
 
-      auto jointIndicesAttr = skelBind.CreateJointIndicesPrimvar(0, mesh.bonesPerVertex);
-      assert(jointIndicesAttr);
-      if (mesh.buffers.blendIndicesBufs.size() > 0) {
-        exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.blendIndicesBufs, reducedIdxBufSet, mesh.bonesPerVertex) : mesh.buffers.blendIndicesBufs, jointIndicesAttr);
-      } else {
-        // D3D9 allows for default bone indices of "0, 1, ... bonesPerVertex" if no joint indices are set.
-        pxr::VtArray<int> defaultIndices(mesh.bonesPerVertex * mesh.numVertices);
-        for (int i = 0; i < mesh.numVertices; ++i) {
-          for (int j = 0; j < mesh.bonesPerVertex; ++j) {
-            defaultIndices[i * mesh.bonesPerVertex + j] = j;
-          }
+    auto jointIndicesAttr = skelBind.CreateJointIndicesPrimvar(0, mesh.bonesPerVertex);
+    assert(jointIndicesAttr);
+    if (mesh.buffers.blendIndicesBufs.size() > 0) {
+      exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.blendIndicesBufs, reducedIdxBufSet, mesh.bonesPerVertex) : mesh.buffers.blendIndicesBufs, jointIndicesAttr);
+    } else {
+      // D3D9 allows for default bone indices of "0, 1, ... bonesPerVertex" if no joint indices are set.
+      pxr::VtArray<int> defaultIndices(mesh.bonesPerVertex * mesh.numVertices);
+      for (int i = 0; i < mesh.numVertices; ++i) {
+        for (int j = 0; j < mesh.bonesPerVertex; ++j) {
+          defaultIndices[i * mesh.bonesPerVertex + j] = j;
         }
-        jointIndicesAttr.Set(defaultIndices);
       }
+      jointIndicesAttr.Set(defaultIndices);
+    }
+
+    auto skelRel = skelBind.CreateSkeletonRel();
+    skelRel.AddTarget(meshXformSdfPath.AppendChild(gTokSkel));
+  }
+
+  if(pMatReference != nullptr) {
+    const auto shaderMatSchema = pxr::UsdShadeMaterial::Define(meshStage, pMatReference->ogSdfPath);
+    assert(shaderMatSchema);
+    auto shaderMatUsdReferences = shaderMatSchema.GetPrim().GetReferences();
+    const std::string fullMatStagePath = computeLocalPath(pMatReference->stagePath);
+    const std::string relMatRefStagePath = std::filesystem::relative(fullMatStagePath,fullMeshStagePath).string();
+    shaderMatUsdReferences.AddReference(relMatRefStagePath, pMatReference->ogSdfPath);
+    pxr::UsdShadeMaterialBindingAPI(meshXformSchema.GetPrim()).Bind(shaderMatSchema);
+  }
+
+  meshStage->Save();
+}
 
-      auto skelRel = skelBind.CreateSkeletonRel();
-      skelRel.AddTarget(meshXformSdfPath.AppendChild(gTokSkel));
+void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
+  dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportMeshes] Begin");
+  static const pxr::GfMatrix4d identity(1);
+  const std::string relMeshDirPath = commonDirName::meshDir + "/";
+  const std::string meshDirPath = exportData.baseExportPath + "/" + relMeshDirPath;
+  const std::string fullMeshStagePath = computeLocalPath(meshDirPath);
+  dxvk::env::createDirectory(meshDirPath);
+  // Every mesh has a layer of its own, only the instance stage needs to be authored serially.
+  // Streamed meshes had their stage written while capturing already.
+  parallelForEachValue(exportData.meshes, [&](const Mesh& mesh) {
+    if (mesh.bStageExported) {
+      return;
     }
+    const auto matRefIt = ctx.matReferences.find(mesh.matId);
+    const bool bHasMat = mesh.matId != kInvalidId && matRefIt != ctx.matReferences.end();
+    writeMeshStage(exportData, ctx.extension, mesh, fullMeshStagePath, (bHasMat) ? &matRefIt->second : nullptr);
+  });
+  for(const auto& [meshId,mesh] : exportData.meshes) {
+    assert(mesh.numVertices > 0);
+    assert(mesh.numIndices > 0);
+
+    const bool isSkeleton = mesh.numBones > 0;
 
     const bool bHasMat = mesh.matId != kInvalidId;
     const Reference& matLssReference = (bHasMat) ? ctx.matReferences[mesh.matId] : Reference();
-    if(bHasMat) {
-      const auto shaderMatSchema = pxr::UsdShadeMaterial::Define(meshStage, matLssReference.ogSdfPath);
-      assert(shaderMatSchema);
-      auto shaderMatUsdReferences = shaderMatSchema.GetPrim().GetReferences();
-      const std::string fullMatStagePath = computeLocalPath(matLssReference.stagePath);
-      const std::string relMatRefStagePath = std::filesystem::relative(fullMatStagePath,fullMeshStagePath).string();
-      shaderMatUsdReferences.AddReference(relMatRefStagePath, matLssReference.ogSdfPath);
-      pxr::UsdShadeMaterialBindingAPI(meshXformSchema.GetPrim()).Bind(shaderMatSchema);
-    }
-
-    meshStage->Save();
+    const std::string meshName = prefix::mesh + mesh.meshName;
+    const std::string meshStagePath = meshDirPath + meshName + ctx.extension;
+    const pxr::SdfPath meshXformSdfPath = getMeshXformSdfPath(exportData, meshName);
     
     // Cache material reference
     Reference meshLssReference;
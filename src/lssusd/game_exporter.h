@@ -42,6 +42,12 @@ public:
     s_bMultiThreadSafety = enable;
   }
   static void exportUsd(const Export& exportData);
+  // Writes the stage of a single, non-skinned mesh ahead of exportUsd, so that its buffers can be
+  // released early. The mesh must then be passed to exportUsd with bStageExported set, which
+  // references the existing stage instead of writing it again. Only the meta data, camera and
+  // materials of exportData are used. Every mesh has a layer of its own, so unlike exportUsd this
+  // can be called for distinct meshes from multiple threads at once.
+  static void exportMeshStage(const Export& exportData, const Mesh& mesh);
 private:
   struct Reference {
     std::string  stagePath;
@@ -57,6 +63,18 @@ private:
     
   };
   static void exportUsdInternal(const Export& exportData);
+  static std::string getStageExtension(const Export& exportData);
+  static Reference getMaterialReference(const Export& exportData, const std::string& extension, const Material& mat);
+  static pxr::SdfPath getMeshXformSdfPath(const Export& exportData, const std::string& meshName);
+  static void writeMaterialStage(const Export& exportData,
+                                 const std::string& extension,
+                                 const Material& matData,
+                                 const std::string& fullMaterialBasePath);
+  static void writeMeshStage(const Export& exportData,
+                             const std::string& extension,
+                             const Mesh& mesh,
+                             const std::string& fullMeshStagePath,
+                             const Reference* pMatReference);
   static pxr::UsdStageRefPtr createInstanceStage(const Export& exportData);
   static void setCommonStageMetaData(pxr::UsdStageRefPtr stage, const Export& exportData);
   static void createApertureMdls(const std::string& baseExportPath);
@@ -178,6 +178,8 @@ struct Mesh {
   uint32_t     bonesPerVertex = 0;
   pxr::VtMatrix4dArray boneXForms;
   bool         isLhs = false;
+  // Stage already written by GameExporter::exportMeshStage, buffers may be empty
+  bool         bStageExported = false;
 };
 
 struct Instance {
@@ -177,6 +177,142 @@ namespace lss {
   }
 
 
+  UsdMeshImporter::UsdMeshImporter(const UsdPrim& meshPrim)
+    : m_meshPrim(UsdGeomMesh(meshPrim)) {
+  }
+
+
+  namespace {
+    struct SerializedMeshHeader {
+      uint32_t vertexStride;
+      uint32_t numVertices;
+      uint32_t actualNumBonesPerVertex;
+      uint32_t limitedNumBonesPerVertex;
+      uint32_t doubleSided;
+      uint32_t isRightHanded;
+      uint32_t numVertexElements;
+      uint32_t numSubMeshes;
+      uint64_t numVertexFloats;
+    };
+
+    struct SerializedVertexElement {
+      uint32_t attribute;
+      uint32_t offset;
+      uint32_t size;
+    };
+
+    template<typename T>
+    void serializeValues(std::vector<uint8_t>& out, const T* pData, const size_t count = 1) {
+      const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+      out.insert(out.end(), pBytes, pBytes + sizeof(T) * count);
+    }
+
+    template<typename T>
+    bool deserializeValues(const uint8_t*& pData, const uint8_t* pEnd, T* pOut, const size_t count = 1) {
+      const size_t size = sizeof(T) * count;
+      if (size_t(pEnd - pData) < size) {
+        return false;
+      }
+      memcpy(pOut, pData, size);
+      pData += size;
+      return true;
+    }
+  }
+
+
+  std::vector<uint8_t> UsdMeshImporter::Serialize() const {
+    std::vector<uint8_t> out;
+
+    const SerializedMeshHeader header {
+      m_vertexStride,
+      m_numVertices,
+      m_actualNumBonesPerVertex,
+      m_limitedNumBonesPerVertex,
+      (uint32_t) m_doubleSided,
+      m_isRightHanded ? 1u : 0u,
+      (uint32_t) m_vertexDecl.size(),
+      (uint32_t) m_meshes.size(),
+      m_vertexData.size()
+    };
+    serializeValues(out, &header);
+
+    for (const VertexDeclaration& element : m_vertexDecl) {
+      const SerializedVertexElement serialized { (uint32_t) element.attribute, (uint32_t) element.offset, (uint32_t) element.size };
+      serializeValues(out, &serialized);
+    }
+
+    serializeValues(out, m_vertexData.data(), m_vertexData.size());
+
+    for (const SubMesh& submesh : m_meshes) {
+      const std::string path = submesh.prim.GetPath().GetString();
+      const uint32_t pathLength = path.size();
+      const uint64_t numIndices = submesh.indexBuffer.size();
+      serializeValues(out, &pathLength);
+      serializeValues(out, path.data(), pathLength);
+      serializeValues(out, &numIndices);
+      serializeValues(out, submesh.indexBuffer.data(), numIndices);
+    }
+
+    return out;
+  }
+
+
+  std::unique_ptr<UsdMeshImporter> UsdMeshImporter::Deserialize(const UsdPrim& meshPrim, const uint8_t* pData, const size_t dataSize) {
+    ZoneScoped;
+    const uint8_t* const pEnd = pData + dataSize;
+
+    SerializedMeshHeader header;
+    if (!deserializeValues(pData, pEnd, &header) || header.doubleSided > IsDoubleSided) {
+      return nullptr;
+    }
+
+    std::unique_ptr<UsdMeshImporter> mesh(new UsdMeshImporter(meshPrim));
+    mesh->m_vertexStride = header.vertexStride;
+    mesh->m_numVertices = header.numVertices;
+    mesh->m_actualNumBonesPerVertex = header.actualNumBonesPerVertex;
+    mesh->m_limitedNumBonesPerVertex = header.limitedNumBonesPerVertex;
+    mesh->m_doubleSided = (DoubleSidedState) header.doubleSided;
+    mesh->m_isRightHanded = header.isRightHanded != 0;
+
+    for (uint32_t i = 0; i < header.numVertexElements; i++) {
+      SerializedVertexElement element;
+      if (!deserializeValues(pData, pEnd, &element) || element.attribute >= Attributes::Count) {
+        return nullptr;
+      }
+      mesh->m_vertexDecl.emplace_back(VertexDeclaration { (Attributes) element.attribute, element.offset, element.size });
+    }
+
+    if (header.numVertexFloats > size_t(pEnd - pData) / sizeof(float) ||
+        header.numVertexFloats * sizeof(float) != uint64_t(header.numVertices) * header.vertexStride) {
+      return nullptr;
+    }
+    mesh->m_vertexData.resize(header.numVertexFloats);
+    deserializeValues(pData, pEnd, mesh->m_vertexData.data(), header.numVertexFloats);
+
+    const UsdStagePtr stage = meshPrim.GetStage();
+    std::string path;
+    for (uint32_t i = 0; i < header.numSubMeshes; i++) {
+      uint32_t pathLength;
+      if (!deserializeValues(pData, pEnd, &pathLength) || pathLength > size_t(pEnd - pData)) {
+        return nullptr;
+      }
+      path.resize(pathLength);
+      deserializeValues(pData, pEnd, path.data(), pathLength);
+
+      const UsdPrim prim = stage->GetPrimAtPath(SdfPath(path));
+      uint64_t numIndices;
+      if (!prim.IsValid() || !deserializeValues(pData, pEnd, &numIndices) || numIndices > size_t(pEnd - pData) / sizeof(uint32_t)) {
+        return nullptr;
+      }
+      std::vector<uint32_t> indices(numIndices);
+      deserializeValues(pData, pEnd, indices.data(), numIndices);
+      mesh->m_meshes.emplace_back(std::move(indices), prim);
+    }
+
+    return mesh;
+  }
+
+
   uint32_t UsdMeshImporter::generateVertexDeclaration(std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers) {
     size_t offset = 0;
     const size_t size = sizeof(float) * 3;
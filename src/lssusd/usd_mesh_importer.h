@@ -28,6 +28,9 @@
 #include <pxr/usd/usdGeom/subset.h>
 #include "usd_include_end.h"
 
+#include <memory>
+#include <vector>
+
 namespace lss {
   class UsdMeshUtil;
   class GeomPrimvarSampler;
@@ -36,6 +39,13 @@ namespace lss {
   public:
     UsdMeshImporter(const pxr::UsdPrim& meshPrim, const uint32_t limitedNumBonesPerVertex);
 
+    // Flattens the processed mesh so it can be stored on disk
+    std::vector<uint8_t> Serialize() const;
+
+    // Recreates a mesh from the output of Serialize, skipping triangulation.  The submesh prims are looked up on the
+    // stage of meshPrim, returns nullptr if the data is malformed or doesn't match the stage.
+    static std::unique_ptr<UsdMeshImporter> Deserialize(const pxr::UsdPrim& meshPrim, const uint8_t* pData, const size_t dataSize);
+
     enum Attributes : uint32_t {
       VertexPositions = 0,
       Normals,
@@ -125,6 +135,8 @@ namespace lss {
     void generateTriangleSamplers(UsdMeshUtil& meshUtil, const pxr::VtVec3iArray& usdIndices, const pxr::VtIntArray& trianglePrimitiveParams, std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers);
     uint32_t generateVertexDeclaration(std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers);
 
+    explicit UsdMeshImporter(const pxr::UsdPrim& meshPrim);
+
     // This class does not support copying.
     UsdMeshImporter(const UsdMeshImporter&) = delete;
     UsdMeshImporter& operator =(const UsdMeshImporter&) = delete;
@@ -88,6 +88,19 @@ namespace dxvk::this_thread {
     return RtlDllShutdownInProgress();
   }
 
+  // NV-DXVK start: priority of threads not created as dxvk::thread
+  void set_priority(ThreadPriority priority) {
+    int32_t value;
+    switch (priority) {
+      default:
+      case ThreadPriority::Normal: value = THREAD_PRIORITY_NORMAL; break;
+      case ThreadPriority::Lowest: value = THREAD_PRIORITY_LOWEST; break;
+    }
+
+    ::SetThreadPriority(::GetCurrentThread(), value);
+  }
+  // NV-DXVK end
+
 }
 
 #else
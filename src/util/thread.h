@@ -153,6 +153,10 @@ namespace dxvk {
     }
 
     bool isInModuleDetachment();
+
+    // NV-DXVK start: priority of threads not created as dxvk::thread
+    void set_priority(ThreadPriority priority);
+    // NV-DXVK end
   }
 
 
@@ -360,6 +364,19 @@ namespace dxvk {
     inline bool isInModuleDetachment() {
       return false;
     }
+
+    // NV-DXVK start: priority of threads not created as dxvk::thread
+    inline void set_priority(ThreadPriority priority) {
+      ::sched_param param = {};
+      int32_t policy;
+      switch (priority) {
+        default:
+        case ThreadPriority::Normal: policy = SCHED_OTHER; break;
+        case ThreadPriority::Lowest: policy = SCHED_IDLE;  break;
+      }
+      ::pthread_setschedparam(::pthread_self(), policy, &param);
+    }
+    // NV-DXVK end
   }
 #endif
 
@@ -264,6 +264,16 @@ namespace dxvk::env {
     }
     return res != 0;
   }
+
+  bool getProcessPrivateMemory(uint64_t& privateSize) {
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    counters.cb = sizeof(counters);
+    BOOL res = GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters));
+    if (res) {
+      privateSize = counters.PrivateUsage;
+    }
+    return res != 0;
+  }
   // NV-DXVK end
 
   void setThreadName(const std::string& name) {
@@ -137,6 +137,13 @@ namespace dxvk::env {
    * \returns true if the function succeeds
    */
   bool getAvailableSystemPhysicalMemory(uint64_t& availableSize);
+
+  /**
+   * \brief Gets the private memory committed by the current process
+   * \param privateSize Committed private memory in bytes
+   * \returns true if the function succeeds
+   */
+  bool getProcessPrivateMemory(uint64_t& privateSize);
   // NV-DXVK end
 
   /**
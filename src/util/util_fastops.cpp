@@ -21,6 +21,8 @@
 */
 #include <smmintrin.h>
 #include <math.h>
+#include <float.h>
+#include <cstring>
 #include <intrin.h>
 #include "util_math.h"
 #include "util_fastops.h"
@@ -28,6 +30,10 @@
 #include <ppl.h>
 #include "util_fastops.h"
 
+// Inlined so the short input paths of XXH3 can be specialized per element size below
+#define XXH_INLINE_ALL
+#include "xxHash/xxhash.h"
+
 #define SSE_ENABLE ((fast::g_simdSupportLevel != fast::SIMD::None) && 1)
 
 namespace fast {
@@ -931,6 +937,301 @@ namespace fast {
   template void copySubtract<uint16_t>(uint16_t* dstData, const uint16_t* srcData, const uint32_t count, const uint16_t value, const bool ignoreSentinel, const uint16_t sentinelValue);
   template void copySubtract<uint32_t>(uint32_t* dstData, const uint32_t* srcData, const uint32_t count, const uint32_t value, const bool ignoreSentinel, const uint32_t sentinelValue);
 
+  uint32_t getVertexAttributeComponentCount(const VertexAttributeFormat format) {
+    switch (format) {
+    case VertexAttributeFormat::Float16x2:
+    case VertexAttributeFormat::Short2N:
+      return 2;
+    case VertexAttributeFormat::Dec3N:
+      return 3;
+    case VertexAttributeFormat::Float16x4:
+    case VertexAttributeFormat::UByte4N:
+      return 4;
+    default:
+      throw;
+    }
+  }
+
+  __forceinline float halfToFloat(const uint16_t value) {
+    const uint32_t sign = (uint32_t) (value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1f;
+    const uint32_t mantissa = value & 0x3ff;
+
+    if (exponent == 0) {
+      // Zero or denormal, mantissa * 2^-24
+      const float result = (float) mantissa * (1.0f / 16777216.0f);
+      return sign ? -result : result;
+    }
+
+    // Infinity and NaN keep their mantissa, everything else gets its exponent rebiased
+    const uint32_t bits = exponent == 0x1f ? (sign | 0x7f800000 | (mantissa << 13))
+                                           : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+
+  __forceinline float normalizeSigned(const int32_t value, const float scale) {
+    return std::max((float) value * scale, -1.0f);
+  }
+
+  template<VertexAttributeFormat F>
+  void decodeVertexAttributes_slow(const uint32_t start, const uint32_t count, const uint8_t* srcData, const uint32_t stride, float* const* dstData) {
+    const uint8_t* pSrc = srcData + (size_t) start * stride;
+    for (uint32_t i = start; i < count; ++i, pSrc += stride) {
+      switch (F) {
+      case VertexAttributeFormat::Float16x2:
+      case VertexAttributeFormat::Float16x4:
+      {
+        uint16_t values[4];
+        std::memcpy(values, pSrc, getVertexAttributeComponentCount(F) * sizeof(uint16_t));
+        for (uint32_t c = 0; c < getVertexAttributeComponentCount(F); ++c) {
+          dstData[c][i] = halfToFloat(values[c]);
+        }
+        break;
+      }
+      case VertexAttributeFormat::UByte4N:
+        for (uint32_t c = 0; c < 4; ++c) {
+          dstData[c][i] = (float) pSrc[c] * (1.0f / 255.0f);
+        }
+        break;
+      case VertexAttributeFormat::Short2N:
+      {
+        int16_t values[2];
+        std::memcpy(values, pSrc, sizeof(values));
+        dstData[0][i] = normalizeSigned(values[0], 1.0f / 32767.0f);
+        dstData[1][i] = normalizeSigned(values[1], 1.0f / 32767.0f);
+        break;
+      }
+      case VertexAttributeFormat::Dec3N:
+      {
+        uint32_t value;
+        std::memcpy(&value, pSrc, sizeof(value));
+        // Sign extend each 10-bit component, the 2 bits of w are ignored like in D3D9
+        dstData[0][i] = normalizeSigned((int32_t) (value << 22) >> 22, 1.0f / 511.0f);
+        dstData[1][i] = normalizeSigned((int32_t) (value << 12) >> 22, 1.0f / 511.0f);
+        dstData[2][i] = normalizeSigned((int32_t) (value << 2) >> 22, 1.0f / 511.0f);
+        break;
+      }
+      default:
+        throw;
+      }
+    }
+  }
+
+  __forceinline __m256i vertexOffsets_AVX2(const uint32_t stride) {
+    return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+  }
+
+  __forceinline __m256 normalizeSigned_AVX2(const __m256i values, const float scale) {
+    return _mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(values), _mm256_set1_ps(scale)), _mm256_set1_ps(-1.0f));
+  }
+
+  // Converts the low and the high half of every 32-bit lane from half to float
+  __forceinline void halfPairsToFloat_AVX2(const __m256i values, __m256& low, __m256& high) {
+    const __m256i packed = _mm256_packus_epi32(_mm256_and_si256(values, _mm256_set1_epi32(0xffff)), _mm256_srli_epi32(values, 16));
+    // packus works per 128-bit lane, restore the vertex order
+    const __m256i ordered = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+    low = _mm256_cvtph_ps(_mm256_castsi256_si128(ordered));
+    high = _mm256_cvtph_ps(_mm256_extracti128_si256(ordered, 1));
+  }
+
+  template<VertexAttributeFormat F>
+  void decodeVertexAttributes_AVX2(const uint32_t count, const uint8_t* srcData, const uint32_t stride, float* const* dstData) {
+    const uint32_t numLanes = 8;
+    const uint32_t alignedCount = dxvk::alignDown(count, numLanes);
+
+    const __m256i offsets = vertexOffsets_AVX2(stride);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+    const uint8_t* pSrc = srcData;
+    for (uint32_t i = 0; i < alignedCount; i += numLanes, pSrc += (size_t) numLanes * stride) {
+      const __m256i values = _mm256_i32gather_epi32((const int*) pSrc, offsets, 1);
+
+      switch (F) {
+      case VertexAttributeFormat::Float16x2:
+      case VertexAttributeFormat::Float16x4:
+      {
+        __m256 x, y;
+        halfPairsToFloat_AVX2(values, x, y);
+        _mm256_storeu_ps(&dstData[0][i], x);
+        _mm256_storeu_ps(&dstData[1][i], y);
+        if (F == VertexAttributeFormat::Float16x4) {
+          __m256 z, w;
+          halfPairsToFloat_AVX2(_mm256_i32gather_epi32((const int*) (pSrc + 4), offsets, 1), z, w);
+          _mm256_storeu_ps(&dstData[2][i], z);
+          _mm256_storeu_ps(&dstData[3][i], w);
+        }
+        break;
+      }
+      case VertexAttributeFormat::UByte4N:
+      {
+        const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+        _mm256_storeu_ps(&dstData[0][i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(values, byteMask)), scale));
+        _mm256_storeu_ps(&dstData[1][i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(values, 8), byteMask)), scale));
+        _mm256_storeu_ps(&dstData[2][i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(values, 16), byteMask)), scale));
+        _mm256_storeu_ps(&dstData[3][i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(values, 24)), scale));
+        break;
+      }
+      case VertexAttributeFormat::Short2N:
+        _mm256_storeu_ps(&dstData[0][i], normalizeSigned_AVX2(_mm256_srai_epi32(_mm256_slli_epi32(values, 16), 16), 1.0f / 32767.0f));
+        _mm256_storeu_ps(&dstData[1][i], normalizeSigned_AVX2(_mm256_srai_epi32(values, 16), 1.0f / 32767.0f));
+        break;
+      case VertexAttributeFormat::Dec3N:
+        _mm256_storeu_ps(&dstData[0][i], normalizeSigned_AVX2(_mm256_srai_epi32(_mm256_slli_epi32(values, 22), 22), 1.0f / 511.0f));
+        _mm256_storeu_ps(&dstData[1][i], normalizeSigned_AVX2(_mm256_srai_epi32(_mm256_slli_epi32(values, 12), 22), 1.0f / 511.0f));
+        _mm256_storeu_ps(&dstData[2][i], normalizeSigned_AVX2(_mm256_srai_epi32(_mm256_slli_epi32(values, 2), 22), 1.0f / 511.0f));
+        break;
+      default:
+        throw;
+      }
+    }
+
+    // Process remaining elements
+    decodeVertexAttributes_slow<F>(alignedCount, count, srcData, stride, dstData);
+  }
+
+  // Gathers use 32-bit offsets relative to the first vertex of a group of 8
+  __forceinline bool canGatherVertices_AVX2(const uint32_t count, const uint32_t stride) {
+    return g_simdSupportLevel >= SIMD::AVX2 && count >= 16 && stride <= INT_MAX / 8;
+  }
+
+  template<VertexAttributeFormat F>
+  void decodeVertexAttributes(const uint32_t count, const uint8_t* srcData, const uint32_t stride, float* const* dstData) {
+    if (canGatherVertices_AVX2(count, stride)) {
+      decodeVertexAttributes_AVX2<F>(count, srcData, stride, dstData);
+    } else {
+      decodeVertexAttributes_slow<F>(0, count, srcData, stride, dstData);
+    }
+  }
+
+  void decodeVertexAttributes(const VertexAttributeFormat format, const uint32_t count, const uint8_t* srcData, const uint32_t stride, float* const* dstData) {
+    switch (format) {
+    case VertexAttributeFormat::Float16x2:
+      decodeVertexAttributes<VertexAttributeFormat::Float16x2>(count, srcData, stride, dstData);
+      break;
+    case VertexAttributeFormat::Float16x4:
+      decodeVertexAttributes<VertexAttributeFormat::Float16x4>(count, srcData, stride, dstData);
+      break;
+    case VertexAttributeFormat::UByte4N:
+      decodeVertexAttributes<VertexAttributeFormat::UByte4N>(count, srcData, stride, dstData);
+      break;
+    case VertexAttributeFormat::Short2N:
+      decodeVertexAttributes<VertexAttributeFormat::Short2N>(count, srcData, stride, dstData);
+      break;
+    case VertexAttributeFormat::Dec3N:
+      decodeVertexAttributes<VertexAttributeFormat::Dec3N>(count, srcData, stride, dstData);
+      break;
+    default:
+      throw; // not a supported format
+    }
+  }
+
+  __forceinline void findMinMaxFloat3_SSE(const uint32_t start, const uint32_t count, const uint8_t* srcData, const uint32_t stride, __m128& minPos, __m128& maxPos) {
+    const uint8_t* pSrc = srcData + (size_t) start * stride;
+    for (uint32_t i = start; i < count; ++i, pSrc += stride) {
+      const float* pPos = reinterpret_cast<const float*>(pSrc);
+      const __m128 pos = _mm_set_ps(0.0f, pPos[2], pPos[1], pPos[0]);
+      minPos = _mm_min_ps(minPos, pos);
+      maxPos = _mm_max_ps(maxPos, pos);
+    }
+  }
+
+  __forceinline float extractMin_AVX2(const __m256 values) {
+    __m128 min = _mm_min_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+    min = _mm_min_ps(min, _mm_movehl_ps(min, min));
+    return _mm_cvtss_f32(_mm_min_ss(min, _mm_shuffle_ps(min, min, 1)));
+  }
+
+  __forceinline float extractMax_AVX2(const __m256 values) {
+    __m128 max = _mm_max_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+    max = _mm_max_ps(max, _mm_movehl_ps(max, max));
+    return _mm_cvtss_f32(_mm_max_ss(max, _mm_shuffle_ps(max, max, 1)));
+  }
+
+  void findMinMaxFloat3(const uint32_t count, const uint8_t* srcData, const uint32_t stride, float minOut[3], float maxOut[3]) {
+    __m128 minPos = _mm_set_ps1(FLT_MAX);
+    __m128 maxPos = _mm_set_ps1(-FLT_MAX);
+    uint32_t alignedCount = 0;
+
+    if (canGatherVertices_AVX2(count, stride)) {
+      const uint32_t numLanes = 8;
+      alignedCount = dxvk::alignDown(count, numLanes);
+
+      const __m256i offsets = vertexOffsets_AVX2(stride);
+      __m256 min[3] = { _mm256_set1_ps(FLT_MAX), _mm256_set1_ps(FLT_MAX), _mm256_set1_ps(FLT_MAX) };
+      __m256 max[3] = { _mm256_set1_ps(-FLT_MAX), _mm256_set1_ps(-FLT_MAX), _mm256_set1_ps(-FLT_MAX) };
+
+      const uint8_t* pSrc = srcData;
+      for (uint32_t i = 0; i < alignedCount; i += numLanes, pSrc += (size_t) numLanes * stride) {
+        for (uint32_t c = 0; c < 3; ++c) {
+          const __m256 values = _mm256_i32gather_ps((const float*) pSrc + c, offsets, 1);
+          min[c] = _mm256_min_ps(min[c], values);
+          max[c] = _mm256_max_ps(max[c], values);
+        }
+      }
+
+      minPos = _mm_set_ps(0.0f, extractMin_AVX2(min[2]), extractMin_AVX2(min[1]), extractMin_AVX2(min[0]));
+      maxPos = _mm_set_ps(0.0f, extractMax_AVX2(max[2]), extractMax_AVX2(max[1]), extractMax_AVX2(max[0]));
+    }
+
+    // Process remaining elements
+    findMinMaxFloat3_SSE(alignedCount, count, srcData, stride, minPos, maxPos);
+
+    for (uint32_t c = 0; c < 3; ++c) {
+      minOut[c] = minPos.m128_f32[c];
+      maxOut[c] = maxPos.m128_f32[c];
+    }
+  }
+
+  __forceinline void findMinMaxBytes_slow(const uint32_t start, const uint32_t count, const uint8_t* srcData, const uint32_t stride, const uint32_t numBytes, uint32_t& minOut, uint32_t& maxOut) {
+    const uint8_t* pSrc = srcData + (size_t) start * stride;
+    for (uint32_t i = start; i < count; ++i, pSrc += stride) {
+      for (uint32_t j = 0; j < numBytes; ++j) {
+        minOut = std::min(minOut, (uint32_t) pSrc[j]);
+        maxOut = std::max(maxOut, (uint32_t) pSrc[j]);
+      }
+    }
+  }
+
+  void findMinMaxBytes(const uint32_t count, const uint8_t* srcData, const uint32_t stride, const uint32_t numBytes, uint32_t& minOut, uint32_t& maxOut) {
+    minOut = UINT8_MAX;
+    maxOut = 0;
+    uint32_t alignedCount = 0;
+
+    // Every gather reads 4 bytes per element, the last element is left to the scalar loop
+    // so that nothing past the end of the stream is read when the element is smaller than that
+    if (count > 0 && stride >= 4 && canGatherVertices_AVX2(count - 1, stride)) {
+      const uint32_t numLanes = 8;
+      alignedCount = dxvk::alignDown(count - 1, numLanes);
+
+      // Bytes past numBytes are forced to 0xff for the min and to 0 for the max
+      const __m256i unusedBytes = _mm256_set1_epi32((int) (numBytes >= 4 ? 0u : ~0u << (numBytes * 8)));
+      const __m256i offsets = vertexOffsets_AVX2(stride);
+      __m256i min = _mm256_set1_epi8((char) 0xff);
+      __m256i max = _mm256_setzero_si256();
+
+      const uint8_t* pSrc = srcData;
+      for (uint32_t i = 0; i < alignedCount; i += numLanes, pSrc += (size_t) numLanes * stride) {
+        const __m256i values = _mm256_i32gather_epi32((const int*) pSrc, offsets, 1);
+        min = _mm256_min_epu8(min, _mm256_or_si256(values, unusedBytes));
+        max = _mm256_max_epu8(max, _mm256_andnot_si256(unusedBytes, values));
+      }
+
+      __m128i min128 = _mm_min_epu8(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+      __m128i max128 = _mm_max_epu8(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1));
+      // Widen to 16 bits so the horizontal minimum instruction can be used for both,
+      // the maximum is found as the minimum of the inverted values
+      min128 = _mm_min_epu16(_mm_and_si128(min128, _mm_set1_epi16(0xff)), _mm_srli_epi16(min128, 8));
+      max128 = _mm_max_epu16(_mm_and_si128(max128, _mm_set1_epi16(0xff)), _mm_srli_epi16(max128, 8));
+      minOut = (uint32_t) _mm_cvtsi128_si32(_mm_minpos_epu16(min128)) & 0xffff;
+      maxOut = ~(uint32_t) _mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(max128, _mm_set1_epi16(-1)))) & 0xffff;
+    }
+
+    // Process remaining elements
+    findMinMaxBytes_slow(alignedCount, count, srcData, stride, numBytes, minOut, maxOut);
+  }
+
   void parallel_memcpy(void* dst, const void* src, const size_t count, const size_t chunkSize) {
     const uint8_t* srcBytes = static_cast<const uint8_t*>(src);
     uint8_t* dstBytes = static_cast<uint8_t*>(dst);
@@ -952,6 +1253,63 @@ namespace fast {
   }
 
 
+  static constexpr uint32_t kHashLanes = 4;
+
+  // Same result as XXH3_64bits_withSeed, with the length dispatch folded away for the common element sizes
+  template<uint32_t ElementSize>
+  __forceinline XXH64_hash_t hashElement(const uint8_t* data, const XXH64_hash_t seed) {
+    return XXH3_len_0to16_64b(data, ElementSize, XXH3_kSecret, seed);
+  }
+
+  __forceinline XXH64_hash_t hashElement(const uint8_t* data, const uint32_t elementSize, const XXH64_hash_t seed) {
+    switch (elementSize) {
+    case 4: return hashElement<4>(data, seed);
+    case 8: return hashElement<8>(data, seed);
+    case 12: return hashElement<12>(data, seed);
+    case 16: return hashElement<16>(data, seed);
+    default: return XXH3_64bits_withSeed(data, elementSize, seed);
+    }
+  }
+
+  __forceinline const uint8_t* getStreamElement(const HashElementStream& stream, const uint32_t i) {
+    if (stream.indices == nullptr) {
+      return stream.data + (size_t) i * stream.stride;
+    }
+
+    const uint32_t index = stream.indexSize == 2 ? static_cast<const uint16_t*>(stream.indices)[i]
+                                                 : static_cast<const uint32_t*>(stream.indices)[i];
+    return stream.data + (size_t) index * stream.stride;
+  }
+
+  void hashElementsChained(const HashElementStream* streams, const uint32_t numStreams, uint64_t* hashesOut) {
+    for (uint32_t first = 0; first < numStreams; first += kHashLanes) {
+      const HashElementStream* lanes = streams + first;
+      const uint32_t numLanes = std::min(kHashLanes, numStreams - first);
+
+      XXH64_hash_t hashes[kHashLanes] = {};
+      uint32_t commonCount = UINT32_MAX;
+      for (uint32_t l = 0; l < numLanes; l++) {
+        commonCount = std::min(commonCount, lanes[l].count);
+      }
+
+      // Every element depends on the hash of the previous one, so a single chain is latency bound.
+      // Interleaving independent chains keeps the multipliers busy.
+      for (uint32_t i = 0; i < commonCount; i++) {
+        for (uint32_t l = 0; l < numLanes; l++) {
+          hashes[l] = hashElement(getStreamElement(lanes[l], i), lanes[l].elementSize, hashes[l]);
+        }
+      }
+
+      // Finish the longer chains
+      for (uint32_t l = 0; l < numLanes; l++) {
+        for (uint32_t i = commonCount; i < lanes[l].count; i++) {
+          hashes[l] = hashElement(getStreamElement(lanes[l], i), lanes[l].elementSize, hashes[l]);
+        }
+        hashesOut[first + l] = hashes[l];
+      }
+    }
+  }
+
   template<typename T>
   __forceinline T findNthBit_BMI2(const T num, const T n) {
     return _tzcnt_u32(_pdep_u32(1 << n, num));
@@ -70,6 +70,89 @@ namespace fast {
   template<typename T>
   void copySubtract(T* dstData, const T* srcData, const uint32_t count, const T value, const bool ignoreSentinel = false, const T sentinelValue = 0);
 
+  /**
+    * \brief Packed vertex attribute formats supported by decodeVertexAttributes
+    */
+  enum class VertexAttributeFormat {
+    Float16x2, // D3DDECLTYPE_FLOAT16_2
+    Float16x4, // D3DDECLTYPE_FLOAT16_4
+    UByte4N,   // D3DDECLTYPE_UBYTE4N
+    Short2N,   // D3DDECLTYPE_SHORT2N
+    Dec3N,     // D3DDECLTYPE_DEC3N
+  };
+
+  /**
+    * \brief Returns the number of float components decodeVertexAttributes writes for a format
+    */
+  uint32_t getVertexAttributeComponentCount(const VertexAttributeFormat format);
+
+  /**
+    * \brief Decodes a strided stream of packed vertex attributes into one float stream per component (SoA)
+    *
+    * format: packed format of the attribute
+    * count: number of vertices
+    * srcData: first attribute to decode
+    * stride: distance in bytes between consecutive attributes
+    * dstData: one array of at least count floats for each component of the format
+    *
+    * Normalized formats are decoded the way D3D9 does, signed ones are clamped to [-1, 1].
+    */
+  void decodeVertexAttributes(const VertexAttributeFormat format, const uint32_t count, const uint8_t* srcData, const uint32_t stride, float* const* dstData);
+
+  /**
+    * \brief Finds the per-component minimum and maximum of a strided stream of 3 component float vectors
+    *
+    * count: number of vectors
+    * srcData: first vector
+    * stride: distance in bytes between consecutive vectors
+    * minOut: minimum x, y and z determined by operation
+    * maxOut: maximum x, y and z determined by operation
+    */
+  void findMinMaxFloat3(const uint32_t count, const uint8_t* srcData, const uint32_t stride, float minOut[3], float maxOut[3]);
+
+  /**
+    * \brief Finds the minimum and maximum of the first bytes of every element in a strided stream
+    *
+    * count: number of elements
+    * srcData: first element
+    * stride: distance in bytes between consecutive elements
+    * numBytes: number of bytes considered per element, at most 4
+    * minOut: minimum byte determined by operation, 255 when count is 0
+    * maxOut: maximum byte determined by operation, 0 when count is 0
+    */
+  void findMinMaxBytes(const uint32_t count, const uint8_t* srcData, const uint32_t stride, const uint32_t numBytes, uint32_t& minOut, uint32_t& maxOut);
+
+  /**
+    * \brief A strided stream of small elements hashed by hashElementsChained
+    *
+    * data: first element
+    * stride: distance in bytes between consecutive elements
+    * elementSize: number of bytes hashed per element
+    * count: number of elements, or number of indices if indices is set
+    * indices: optional, when set element i is read from data + indices[i] * stride
+    * indexSize: size in bytes of each index, 2 or 4
+    */
+  struct HashElementStream {
+    const uint8_t* data = nullptr;
+    uint32_t stride = 0;
+    uint32_t elementSize = 0;
+    uint32_t count = 0;
+    const void* indices = nullptr;
+    uint32_t indexSize = 0;
+  };
+
+  /**
+    * \brief Hashes every element of each stream with XXH3, seeding each element with the hash of the previous one
+    *
+    * streams: streams to hash, each one starts with a seed of 0
+    * numStreams: number of streams
+    * hashesOut: one hash per stream
+    *
+    * The result for a stream is identical to calling XXH3_64bits_withSeed on its elements in order. The chains
+    * of up to 4 streams are advanced in lockstep so that their latency overlaps.
+    */
+  void hashElementsChained(const HashElementStream* streams, const uint32_t numStreams, uint64_t* hashesOut);
+
   /**
     * \brief Memory copy function that uses threads internally, can be useful for very large memcpy's
     *
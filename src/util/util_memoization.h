@@ -1,4 +1,9 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <utility>
 
 namespace dxvk {
   template<typename T>
@@ -29,37 +34,43 @@ namespace dxvk {
       CacheEntry(Range r, U res) : range(r), result(std::move(res)) { }
     };
 
-    std::map<size_t, CacheEntry<T>> cache;
+    // Keyed by range start, then range end, so draws over overlapping ranges each keep their entry
+    std::map<std::pair<size_t, size_t>, CacheEntry<T>> cache;
+    // Version of the memory the cached results were computed from
+    uint64_t cacheVersion = 0;
 
   public:
+    // Returns the cached result for exactly this range, or computes it. Version is a counter of the owner
+    // that changes whenever the whole memory region is rewritten, a new version drops every cached result.
     template<typename Func>
-    T memoize(size_t start, size_t size, Func&& func) {
+    T memoize(size_t start, size_t size, uint64_t version, Func&& func) {
+      if (version != cacheVersion) {
+        cache.clear();
+        cacheVersion = version;
+      }
+
       const Range currentRange(start, start + size);
 
-      auto it = cache.find(start);
-      if (it != cache.end() && it->second.range.start == currentRange.start && it->second.range.end == currentRange.end) {
+      auto it = cache.find({ currentRange.start, currentRange.end });
+      if (it != cache.end()) {
         // Exact match found, return cached result
         return it->second.result;
       }
 
-      // No exact match, invalidate all overlapping ranges
-      invalidate(currentRange.start, currentRange.end);
-
       // If we didn't find a usable cached result, compute and store the result
       T result = std::invoke(func, start, size);
-      cache[start] = CacheEntry<T>(currentRange, result);
+      cache.emplace(std::make_pair(currentRange.start, currentRange.end), CacheEntry<T>(currentRange, result));
       return result;
     }
 
     void invalidate(size_t start, size_t size) {
       Range invalidRange(start, start + size);
 
-      // Find the first range overlapping range in cache
-      auto it = cache.lower_bound(start);
-      if (it != cache.begin()) --it;
+      // Ranges starting at or past the end of the invalidated range can not overlap it
+      auto end = cache.lower_bound({ invalidRange.end, 0 });
 
       // Erase overlapping ranges
-      while (it != cache.end() && it->second.range.start < invalidRange.end) {
+      for (auto it = cache.begin(); it != end;) {
         if (it->second.range.overlaps(invalidRange)) {
           it = cache.erase(it);
         } else {
@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace dxvk {
+  /**
+    * \brief Implements a bounded MPMC queue, after Dmitry Vyukov's
+    *        bounded MPMC queue. A ring buffer of fixed size where
+    *        every cell carries a sequence number, which tells the
+    *        producers and consumers racing for a position whether
+    *        the cell is free to write, or holds an item to read.
+    *        Any number of threads may push and pop simultaneously.
+    *  T: Type of the object
+    *  Capacity: Number of elements in the ring buffer.
+    */
+  template <typename T, uint32_t Capacity>
+  class MpmcQueue {
+    static_assert(Capacity > 0, "MpmcQueue capacity must be non-zero");
+
+  public:
+    MpmcQueue() {
+      for (uint32_t i = 0; i < Capacity; i++) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    bool push(T&& item) {
+      return tryPush([&item]() -> T&& { return std::move(item); });
+    }
+
+    // Claims a cell and only then asks makeItem for the item to put into it,
+    // so that nothing is created when the queue turns out to be full.
+    template <typename MakeItem>
+    bool tryPush(MakeItem&& makeItem) {
+      uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+      Cell* cell;
+      while (true) {
+        cell = &m_cells[pos % Capacity];
+        const uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const int64_t diff = int64_t(sequence) - int64_t(pos);
+        if (diff == 0) {
+          if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;  // queue is full
+        } else {
+          pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+      }
+      cell->data = makeItem();
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool pop(T& item) {
+      uint64_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+      Cell* cell;
+      while (true) {
+        cell = &m_cells[pos % Capacity];
+        const uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const int64_t diff = int64_t(sequence) - int64_t(pos + 1);
+        if (diff == 0) {
+          if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;  // queue is empty
+        } else {
+          pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+      }
+      item = std::move(cell->data);
+      cell->sequence.store(pos + Capacity, std::memory_order_release);
+      return true;
+    }
+
+    // Only a hint when other threads are pushing or popping at the same time
+    bool isEmpty() const {
+      return m_dequeuePos.load(std::memory_order_relaxed) >= m_enqueuePos.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Cell {
+      std::atomic<uint64_t> sequence;
+      T data;
+    };
+
+    std::array<Cell, Capacity> m_cells;
+    // Producers and consumers contend on different positions, keep them apart
+    alignas(64) std::atomic<uint64_t> m_enqueuePos = 0;
+    alignas(64) std::atomic<uint64_t> m_dequeuePos = 0;
+  };
+} //dxvk
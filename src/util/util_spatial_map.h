@@ -30,9 +30,16 @@
 
 namespace dxvk {
   // A structure to allow for quickly returning data close to a specific position.
+  // Cells are split when one of them gets crowded, so that lookups in dense clusters of
+  // data (i.e. hundreds of copies of an object piled up in one spot) only have to look
+  // at the entries actually near the search position.
   template<class T>
   class SpatialMap {
   private:
+    // A cell holding more entries than this halves the cell size, at most kMaxCellSubdivisions times.
+    static constexpr size_t kMaxEntriesPerCell = 32;
+    static constexpr uint32_t kMaxCellSubdivisions = 2;
+
     struct Entry {
       const T* data;
       Vector3 centroid;
@@ -42,15 +49,18 @@ namespace dxvk {
       Entry(const Entry& other) : data(other.data), centroid(other.centroid), transformHash(other.transformHash) { }
     };
   public:
-    SpatialMap(float cellSize) : m_cellSize(cellSize) {
+    SpatialMap(float cellSize) : m_baseCellSize(cellSize), m_cellSize(cellSize) {
       if (m_cellSize <= 0) {
         ONCE(Logger::err("Invalid cell size in SpatialMap. cellSize must be greater than 0."));
+        m_baseCellSize = 1.f;
         m_cellSize = 1.f;
       }
     }
 
     SpatialMap& operator=(SpatialMap&& other) {
+      m_baseCellSize = other.m_baseCellSize;
       m_cellSize = other.m_cellSize;
+      m_subdivisions = other.m_subdivisions;
       m_cells = std::move(other.m_cells);
       m_cache = std::move(other.m_cache);
       return *this;
@@ -69,38 +79,50 @@ namespace dxvk {
     // returns the entry cosest to `centroid` that passes the `filter` and is less than `sqrt(maxDistSqr)` units from `centroid`.
     // `filter` should return true if the entry is a valid result.
     const T* getNearestData(const Vector3& centroid, float maxDistSqr, float& nearestDistSqr, std::function<bool(const T*)> filter) const {
-      static const std::array kOffsets{
-        Vector3i{0, 0, 0},
-        Vector3i{0, 0, 1},
-        Vector3i{0, 1, 0},
-        Vector3i{0, 1, 1},
-        Vector3i{1, 0, 0},
-        Vector3i{1, 0, 1},
-        Vector3i{1, 1, 0},
-        Vector3i{1, 1, 1}
-      };
-      const Vector3 cellPosition = centroid / m_cellSize - Vector3(0.5f, 0.5f, 0.5f);
-      const Vector3i floorPos(int(std::floor(cellPosition.x)), int(std::floor(cellPosition.y)), int(std::floor(cellPosition.z)));
-
       const T* nearestData = nullptr;
       nearestDistSqr = FLT_MAX;
-      for (const Vector3i& offset : kOffsets) {
-        auto cell = m_cells.find(floorPos + offset);
-        if (cell == m_cells.end()) {
-          continue;
-        }
-        for (const Entry& entry : cell->second) {
+
+      // Returns true once nothing closer can be found
+      auto visitCell = [&](const std::vector<Entry>& cell) -> bool {
+        for (const Entry& entry : cell) {
           if (!filter(entry.data)) {
             continue;
           }
           const float distSqr = lengthSqr(entry.centroid - centroid);
           if (distSqr <= maxDistSqr && distSqr < nearestDistSqr) {
             nearestDistSqr = distSqr;
+            nearestData = entry.data;
             if (nearestDistSqr == 0.0f) {
               // Not going to find anything closer, so stop the iteration
-              return entry.data;
+              return true;
+            }
+          }
+        }
+        return false;
+      };
+
+      // Visit every cell overlapping the bounds of the search sphere
+      const float maxDist = std::sqrt(maxDistSqr);
+      const float cellsPerAxis = std::ceil(2.f * maxDist / m_cellSize) + 1.f;
+      if (cellsPerAxis * cellsPerAxis * cellsPerAxis >= float(m_cells.size())) {
+        // Cheaper to look at every cell than to look up the empty ones
+        for (const auto& cell : m_cells) {
+          if (visitCell(cell.second)) {
+            break;
+          }
+        }
+        return nearestData;
+      }
+
+      const Vector3i minPos = getCellPos(centroid - Vector3(maxDist));
+      const Vector3i maxPos = getCellPos(centroid + Vector3(maxDist));
+      for (int x = minPos.x; x <= maxPos.x; ++x) {
+        for (int y = minPos.y; y <= maxPos.y; ++y) {
+          for (int z = minPos.z; z <= maxPos.z; ++z) {
+            auto cell = m_cells.find(Vector3i(x, y, z));
+            if (cell != m_cells.end() && visitCell(cell->second)) {
+              return nearestData;
             }
-            nearestData = entry.data;
           }
         }
       }
@@ -112,7 +134,13 @@ namespace dxvk {
       m_cache.emplace(std::piecewise_construct,
                       std::forward_as_tuple(transformHash),
                       std::forward_as_tuple(data, centroid, transformHash));
-      m_cells[getCellPos(centroid)].emplace_back(data, centroid, transformHash);
+      std::vector<Entry>& cell = m_cells[getCellPos(centroid)];
+      cell.emplace_back(data, centroid, transformHash);
+      if (cell.size() > kMaxEntriesPerCell && m_subdivisions < kMaxCellSubdivisions) {
+        ++m_subdivisions;
+        m_cellSize = m_baseCellSize / float(1 << m_subdivisions);
+        rebuildCells();
+      }
       return transformHash;
     }
 
@@ -121,6 +149,13 @@ namespace dxvk {
       if (pair != m_cache.end()) {
         eraseFromCell(pair->second.centroid, transformHash);
         m_cache.erase(pair);
+
+        // Go back to the initial cell size once there are too few entries left to crowd a cell
+        if (m_subdivisions > 0 && m_cache.size() <= kMaxEntriesPerCell) {
+          m_subdivisions = 0;
+          m_cellSize = m_baseCellSize;
+          rebuildCells();
+        }
       } else {
         ONCE(Logger::err("Specified hash was missing in SpatialMap::erase()."));
         assert(false);
@@ -138,14 +173,27 @@ namespace dxvk {
     }
 
     void rebuild(float cellSize) {
-      m_cells.clear();
-      for (auto pair : m_cache) {
-        m_cells[getCellPos(pair.second.centroid)].emplace_back(pair.second);
+      if (cellSize > 0) {
+        m_baseCellSize = cellSize;
       }
+      m_subdivisions = 0;
+      m_cellSize = m_baseCellSize;
+      rebuildCells();
+    }
+
+    float getCellSize() const {
+      return m_cellSize;
     }
 
   private:
 
+    void rebuildCells() {
+      m_cells.clear();
+      for (const auto& pair : m_cache) {
+        m_cells[getCellPos(pair.second.centroid)].emplace_back(pair.second);
+      }
+    }
+
     Vector3i getCellPos(const Vector3& position) const {
       const Vector3 scaledPos = position / m_cellSize;
       return Vector3i(int(std::floor(scaledPos.x)), int(std::floor(scaledPos.y)), int(std::floor(scaledPos.z))); 
@@ -176,7 +224,9 @@ namespace dxvk {
       Logger::err("Couldn't find matching data in SpatialMap::erase().");
     }
 
+    float m_baseCellSize;
     float m_cellSize;
+    uint32_t m_subdivisions = 0;
     fast_spatial_cache<std::vector<Entry>> m_cells;
     fast_unordered_cache<Entry> m_cache;
   };
@@ -21,6 +21,7 @@
 */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
@@ -30,13 +31,15 @@
 #include <vector>
 #include <type_traits>
 #include <future>
+#include <initializer_list>
 #include <assert.h>
-#include "util_atomic_queue.h"
+#include "util_mpmc_queue.h"
 #include "util_env.h"
 #include "util_math.h"
 #include "util_fastops.h"
 #include "util_bit.h"
 #include "sync/sync_spinlock.h"
+#include "thread.h"
 
 namespace dxvk {
   const size_t kLambdaStorageCapacity = 256;
@@ -265,12 +268,17 @@ namespace dxvk {
     *        for tasks of varying execution time using a
     *        work stealing algorithm.
     *
+    *  Every worker has its own bounded MPMC queue. Any number of threads
+    *  may schedule tasks at once, and idle workers steal from the queues
+    *  of the others without taking a lock.
+    *
     *  NumThreads: How many threads to spawn (up to 255)
     *  NumTasksPerThread: Size of the task queue ring buffer
     *  WorkStealing: Enables the work stealing features of the scheduler
     *  LowLatency: Enables the low-latency mode where workers will spin instead of
     *              waiting for tasks on a conditional variable
     *  (ctor)workerName: Name given to threads with the pattern: workerName(N)
+    *  (ctor)priority: Priority the worker threads run at
     * 
     *  Example usage:
     *   // Creates 1 thread, and uses it to return PI via a future
@@ -280,7 +288,7 @@ namespace dxvk {
     */
   template<size_t NumTasksPerThread, bool WorkStealing = true, bool LowLatency = true>
   class WorkerThreadPool {
-    using Queue = AtomicQueue<TaskId, NumTasksPerThread>;
+    using Queue = MpmcQueue<TaskId, NumTasksPerThread>;
     using QueuePtr = std::unique_ptr<Queue>;
 
     struct Nop { };
@@ -288,10 +296,11 @@ namespace dxvk {
     using TaskMutex = std::conditional_t<LowLatency, Nop, dxvk::mutex>;
 
   public:
-    WorkerThreadPool(uint8_t numThreads, const char* workerName = "Nameless Worker Thread") 
+    WorkerThreadPool(uint8_t numThreads, const char* workerName = "Nameless Worker Thread", ThreadPriority priority = ThreadPriority::Normal) 
     : m_numThread(std::clamp(numThreads, (uint8_t)1u, (uint8_t)dxvk::thread::hardware_concurrency())) {
-      // Note: round up to a closest power-of-two so we can use mask as modulo
-      m_taskCount = 1 << (32 - bit::lzcnt(static_cast<uint32_t>(NumTasksPerThread * m_numThread) - 1));
+      // Note: round up to a closest power-of-two so we can use mask as modulo.
+      // Leave room for the tasks being executed on top of the queued ones.
+      m_taskCount = 1 << (32 - bit::lzcnt(static_cast<uint32_t>((NumTasksPerThread + 1) * m_numThread) - 1));
       m_tasks.reset(new Task[m_taskCount]);
       m_workerTasks.resize(m_numThread);
       m_workerThreads.resize(m_numThread);
@@ -304,8 +313,11 @@ namespace dxvk {
 
       // Start the worker threads
       for (int i = 0; i < m_numThread; i++) {
-        m_workerThreads[i] = std::thread([this, i, workerName] {
+        m_workerThreads[i] = std::thread([this, i, workerName, priority] {
           env::setThreadName(str::format(workerName, "(", i, ")"));
+          if (priority != ThreadPriority::Normal) {
+            this_thread::set_priority(priority);
+          }
           processWork(i);
         });
       }
@@ -350,32 +362,38 @@ namespace dxvk {
       const uint32_t thread = fast::findNthBit(Affinity, (uint8_t) (m_schedulerIndex++ % affinityMask));
       assert(thread < m_numThread);
 
-      // Atomic queue is SPSC, so we don't need to take a lock here
-      // since we know this will always be called from a single thread.
+      // Counted ahead of the push so that a worker woken up by it never
+      // sees the task without the count, this may only make it spin briefly.
+      ++m_numTasks;
 
+      // The queues are MPMC, so any thread may schedule without a lock.
+      // The task is only captured once the queue has room for it, a full
+      // queue leaves the lambda untouched for the caller to run instead.
       Future<R> future;
-      if (!m_workerTasks[thread]->isFull()) {
+      const bool pushed = m_workerTasks[thread]->tryPush([&]() {
         // Get next task id
-        TaskId taskId = m_taskId++ & (m_taskCount - 1);
+        const TaskId taskId = m_taskId++ & (m_taskCount - 1);
 
         // Capture task lambda
         future = m_tasks[taskId].capture<F, R>(std::forward<F>(f));
 
-        // Place task into queue
-        m_workerTasks[thread]->push(std::move(taskId));
+        return taskId;
+      });
 
-        if constexpr (!LowLatency) {
-          std::unique_lock<TaskMutex> lock(m_taskMutex);
-          if constexpr (WorkStealing) {
-            // Notify only one worker when workers can steal from the others
-            m_condOnAdd.notify_one();
-          } else {
-            // Notify all workers when they cannot steal
-            m_condOnAdd.notify_all();
-          }
-        }
+      if (!pushed) {
+        --m_numTasks;
+        return future;
+      }
 
-        ++m_numTasks;
+      if constexpr (!LowLatency) {
+        std::unique_lock<TaskMutex> lock(m_taskMutex);
+        if constexpr (WorkStealing) {
+          // Notify only one worker when workers can steal from the others
+          m_condOnAdd.notify_one();
+        } else {
+          // Notify all workers when they cannot steal
+          m_condOnAdd.notify_all();
+        }
       }
 
       return future;
@@ -423,20 +441,14 @@ namespace dxvk {
 
     // True if front pop, False if back pop
     bool executeTask(const uint32_t workerId) {
+      // The queues are MPMC, stealing needs no lock
       TaskId taskId;
-      {
-        // Since we're using an SPSC queue, we must take a lock when
-        // popping, since we may be stealing (or be stolen from) by
-        // another thread.
-        std::unique_lock<sync::Spinlock> lock(m_threadMutex);
-
-        if (!m_workerTasks[workerId]->pop(taskId)) {
-          return false;
-        }
-
-        --m_numTasks;
+      if (!m_workerTasks[workerId]->pop(taskId)) {
+        return false;
       }
 
+      --m_numTasks;
+
       // Execute the task
       m_tasks[taskId]();
 
@@ -449,7 +461,7 @@ namespace dxvk {
 
     // Add the task to the queue and notify a worker thread
     //  just distribute evenly to all threads for some mask denoted by Affinity.
-    size_t m_schedulerIndex = 0;
+    std::atomic<size_t> m_schedulerIndex = 0;
 
     uint8_t m_numThread;
 
@@ -459,17 +471,136 @@ namespace dxvk {
     TaskMutex m_taskMutex;
     OnAddCondition m_condOnAdd;
 
-    // Used to synchronize intra-thread stealing
-    sync::Spinlock m_threadMutex;
-
     std::vector<std::thread> m_workerThreads;
 
     // We expect high volume of potentially small tasks via "Schedule" per-
     //  frame, and require extremely low overhead to hit the 100's of FPS.
-    // Use a lock-free circular queue here for two reasons (profiled):
+    // Use lock-free circular queues here for two reasons (profiled):
     //  1. Non-circular queue incurs allocation overhead thats unacceptable
     //  2. Use of mutex, and CVs, incur overhead thats unacceptable
     std::vector<QueuePtr> m_workerTasks;
-    std::atomic_uint32_t m_numTasks;
+    std::atomic_uint32_t m_numTasks = 0;
+  };
+
+  /**
+    * \brief Implements a small graph of tasks with dependencies
+    *        between them, run on a WorkerThreadPool. A task is
+    *        scheduled by the worker that finishes the last of its
+    *        dependencies, so no thread blocks on a dependency and
+    *        only the end of the graph needs to be waited on.
+    *
+    *  Tasks are added first, and may only depend on tasks added
+    *  before them. The graph is then started once, and waited on
+    *  (at the latest by its destructor) before it goes away.
+    *
+    *  PoolType: The WorkerThreadPool to run the tasks on
+    *  MaxTasks: Maximum number of tasks in the graph
+    *
+    *  Example usage:
+    *   // Runs a lookup once both of the hashes it needs are done
+    *   TaskGraph<Pool, 3> graph(pool);
+    *   auto positions = graph.add([&] { hashPositions(); });
+    *   auto indices = graph.add([&] { hashIndices(); });
+    *   graph.add([&] { lookUp(); }, { positions, indices });
+    *   graph.start();
+    *   graph.wait();
+    */
+  template<typename PoolType, uint32_t MaxTasks = 16>
+  class TaskGraph {
+  public:
+    using TaskHandle = uint32_t;
+
+    explicit TaskGraph(PoolType& pool)
+    : m_pool { pool } { }
+
+    ~TaskGraph() {
+      wait();
+    }
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    template<typename F>
+    TaskHandle add(F&& f, std::initializer_list<TaskHandle> dependencies = {}) {
+      assert(!m_started && "Tasks cannot be added to a started graph!");
+      assert(m_numTasks < MaxTasks && "Task graph capacity overrun!");
+
+      const TaskHandle handle = m_numTasks++;
+      Node& node = m_nodes[handle];
+      node.work = std::forward<F>(f);
+      node.numDependencies = static_cast<uint32_t>(dependencies.size());
+
+      for (const TaskHandle dependency : dependencies) {
+        assert(dependency < handle && "Tasks may only depend on tasks added before them!");
+        Node& dependencyNode = m_nodes[dependency];
+        dependencyNode.successors[dependencyNode.numSuccessors++] = handle;
+      }
+
+      return handle;
+    }
+
+    // Schedules the tasks without dependencies, the rest follow as their dependencies finish
+    void start() {
+      assert(!m_started && "Task graph started twice!");
+      m_started = true;
+      m_numPending = m_numTasks;
+
+      for (uint32_t i = 0; i < m_numTasks; i++) {
+        m_nodes[i].numPendingDependencies = m_nodes[i].numDependencies;
+      }
+
+      for (uint32_t i = 0; i < m_numTasks; i++) {
+        if (m_nodes[i].numDependencies == 0) {
+          dispatch(i);
+        }
+      }
+    }
+
+    bool isDone() const {
+      return m_numPending == 0;
+    }
+
+    void wait() const {
+      while (!isDone()) {
+        std::this_thread::yield();
+      }
+    }
+
+  private:
+    struct Node {
+      std::function<void()> work;
+      std::atomic<uint32_t> numPendingDependencies = 0;
+      uint32_t numDependencies = 0;
+      uint32_t numSuccessors = 0;
+      std::array<TaskHandle, MaxTasks> successors;
+    };
+
+    void dispatch(const TaskHandle handle) {
+      // A full pool gets the task run on this thread instead
+      if (!m_pool.Schedule([this, handle] { run(handle); }).valid()) {
+        run(handle);
+      }
+    }
+
+    void run(const TaskHandle handle) {
+      Node& node = m_nodes[handle];
+      node.work();
+
+      for (uint32_t i = 0; i < node.numSuccessors; i++) {
+        const TaskHandle successor = node.successors[i];
+        if (m_nodes[successor].numPendingDependencies.fetch_sub(1) == 1) {
+          dispatch(successor);
+        }
+      }
+
+      // Last, the graph may be gone as soon as this reaches zero
+      --m_numPending;
+    }
+
+    PoolType& m_pool;
+    std::array<Node, MaxTasks> m_nodes;
+    uint32_t m_numTasks = 0;
+    bool m_started = false;
+    std::atomic<uint32_t> m_numPending = 0;
   };
 } //dxvk
\ No newline at end of file
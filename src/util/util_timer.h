@@ -36,4 +36,21 @@ public:
 
 private:
   const std::chrono::high_resolution_clock::time_point start_;
-};
\ No newline at end of file
+};
+
+// Using RAII, will add the amount of time it took to execute a block of code to a counter in milliseconds
+class AccumulatingTimer {
+public:
+  explicit AccumulatingTimer(float& milliseconds)
+    : milliseconds_(milliseconds)
+    , start_(std::chrono::high_resolution_clock::now()) { }
+
+  ~AccumulatingTimer() {
+    const std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start_;
+    milliseconds_ += elapsed.count();
+  }
+
+private:
+  float& milliseconds_;
+  const std::chrono::high_resolution_clock::time_point start_;
+};
@@ -29,10 +29,16 @@ enum Feature : uint64_t {
   MessageChannel,
   RemixApi,
   FileSys,
+  BridgeFrameTimes,
   nFeatures
 };
 
 static constexpr char QueryFuncName[] = "QueryFeatureVersion";
 using QueryFunc = size_t(__stdcall*)(version::Feature);
 
+// Hands the simulation start/end of a bridge client frame and the time its Present reached the server to the renderer, all on the QPC timeline
+static constexpr uint64_t bridgeFrameTimesV = 1;
+static constexpr char SetBridgeFrameTimesFuncName[] = "SetBridgeFrameTimes";
+using SetBridgeFrameTimesFunc = void(__stdcall*)(uint64_t simulationStart, uint64_t simulationEnd, uint64_t presentReceived);
+
 }
@@ -0,0 +1,336 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "../../test_utils.h"
+#include "../../../src/util/util_atomic_queue.h"
+#include "../../../src/util/util_fast_cache.h"
+#include "../../../src/util/util_fastops.h"
+#include "../../../src/util/util_spatial_map.h"
+#include "../../../src/util/util_threadpool.h"
+#include "../../../src/dxvk/rtx_render/rtx_hashing.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("benchmark_cpu_hot_paths.log");
+}
+
+using namespace dxvk;
+
+// Times the CPU stages that run per draw call or per frame, on datasets generated from a fixed seed,
+// and compares the results against benchmark_baseline.txt. Run with the baseline path as the first
+// argument, and add --update to write the current results to it instead, e.g. on the reference machine
+// after an intended change in performance.
+class BenchmarkApp {
+public:
+  BenchmarkApp(std::string baselinePath, bool update)
+    : m_baselinePath(std::move(baselinePath))
+    , m_update(update) { }
+
+  int run() {
+    benchGeometryHashes();
+    benchFindMinMax();
+    benchCopySubtract();
+    benchSpatialMapNearest();
+    benchThreadPoolSchedule();
+    benchHashCacheLookup();
+    benchAtomicQueue();
+
+    return m_update ? writeBaseline() : compareToBaseline();
+  }
+
+private:
+  static constexpr uint32_t kSeed = 0x52544958;
+  static constexpr uint32_t kNumRuns = 9;
+  // A benchmark this much slower than its baseline is a regression
+  static constexpr double kTolerance = 1.25;
+
+  struct Result {
+    std::string name;
+    double nsPerOp;
+  };
+
+  std::string m_baselinePath;
+  bool m_update;
+  std::vector<Result> m_results;
+
+  // Records the median time per operation over kNumRuns runs, after a warm up run. body performs
+  // opsPerRun operations and returns a value depending on their results, so they can't be optimized out.
+  template<typename F>
+  void measure(const char* name, uint32_t opsPerRun, F&& body) {
+    volatile uint64_t sink = body();
+    std::array<double, kNumRuns> times;
+    for (double& time : times) {
+      const auto start = std::chrono::steady_clock::now();
+      sink = sink + body();
+      const auto end = std::chrono::steady_clock::now();
+      time = std::chrono::duration<double, std::nano>(end - start).count() / opsPerRun;
+    }
+    std::nth_element(times.begin(), times.begin() + kNumRuns / 2, times.end());
+    m_results.push_back({ name, times[kNumRuns / 2] });
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << times[kNumRuns / 2] << " ns/op" << std::endl;
+  }
+
+  template<typename T>
+  static std::vector<T> makeIndices(uint32_t count, T maxValue) {
+    std::mt19937 rng(kSeed);
+    std::uniform_int_distribution<uint32_t> uni(0, maxValue);
+    std::vector<T> indices(count);
+    for (T& index : indices) {
+      index = T(uni(rng));
+    }
+    return indices;
+  }
+
+  static std::vector<Vector3> makePositions(uint32_t count, float extent) {
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> uni(-extent, extent);
+    std::vector<Vector3> positions(count);
+    for (Vector3& pos : positions) {
+      pos = Vector3(uni(rng), uni(rng), uni(rng));
+    }
+    return positions;
+  }
+
+  // Hashes the components of a mesh and combines them the way a draw call's GeometryHashes are
+  void benchGeometryHashes() {
+    constexpr uint32_t kNumMeshes = 64;
+    constexpr uint32_t kVertexCount = 1024;
+    constexpr uint32_t kIndexCount = 3 * 1024;
+    const std::vector<Vector3> positions = makePositions(kNumMeshes * kVertexCount, 100.f);
+    const std::vector<Vector3> texcoords = makePositions(kNumMeshes * kVertexCount, 1.f);
+    const std::vector<uint16_t> indices = makeIndices<uint16_t>(kNumMeshes * kIndexCount, kVertexCount - 1);
+
+    measure("geometry_hashes", kNumMeshes, [&]() {
+      uint64_t result = 0;
+      for (uint32_t i = 0; i < kNumMeshes; i++) {
+        GeometryHashes hashes;
+        hashes[HashComponents::VertexPosition] = XXH3_64bits(&positions[i * kVertexCount], kVertexCount * sizeof(Vector3));
+        hashes[HashComponents::VertexTexcoord] = XXH3_64bits(&texcoords[i * kVertexCount], kVertexCount * sizeof(Vector2));
+        hashes[HashComponents::Indices] = XXH3_64bits(&indices[i * kIndexCount], kIndexCount * sizeof(uint16_t));
+        hashes[HashComponents::GeometryDescriptor] = XXH3_64bits_withSeed(&kIndexCount, sizeof(kIndexCount), kVertexCount);
+        hashes[HashComponents::VertexLayout] = XXH3_64bits(&i, sizeof(i));
+        hashes[HashComponents::VertexShader] = XXH3_64bits(&kNumMeshes, sizeof(kNumMeshes));
+        hashes.precombine();
+        result ^= hashes.getHashForRule<rules::FullGeometryHash>();
+      }
+      return result;
+    });
+  }
+
+  void benchFindMinMax() {
+    constexpr uint32_t kCount = 64 * 1024;
+    constexpr uint32_t kCalls = 64;
+    const std::vector<uint16_t> indices = makeIndices<uint16_t>(kCount, 0xFFFE);
+
+    measure("fastop_find_min_max_16", kCalls, [&]() {
+      uint64_t result = 0;
+      for (uint32_t i = 0; i < kCalls; i++) {
+        uint32_t minIndex, maxIndex;
+        fast::findMinMax<uint16_t>(kCount, indices.data(), minIndex, maxIndex);
+        result += minIndex + maxIndex;
+      }
+      return result;
+    });
+  }
+
+  void benchCopySubtract() {
+    constexpr uint32_t kCount = 64 * 1024;
+    constexpr uint32_t kCalls = 64;
+    const std::vector<uint16_t> indices = makeIndices<uint16_t>(kCount, 0xFFFE);
+    std::vector<uint16_t> dst(kCount);
+
+    measure("fastop_copy_subtract_16", kCalls, [&]() {
+      uint64_t result = 0;
+      for (uint32_t i = 0; i < kCalls; i++) {
+        fast::copySubtract<uint16_t>(dst.data(), indices.data(), kCount, uint16_t(i));
+        result += dst[i];
+      }
+      return result;
+    });
+  }
+
+  void benchSpatialMapNearest() {
+    constexpr uint32_t kNumEntries = 4096;
+    constexpr uint32_t kNumQueries = 1024;
+    const std::vector<Vector3> entryPositions = makePositions(kNumEntries, 100.f);
+    const std::vector<Vector3> queryPositions = makePositions(kNumEntries + kNumQueries, 100.f);
+    std::vector<uint32_t> data(kNumEntries);
+
+    SpatialMap<uint32_t> map(8.f);
+    for (uint32_t i = 0; i < kNumEntries; i++) {
+      data[i] = i;
+      map.insert(entryPositions[i], translationMatrix(entryPositions[i]), &data[i]);
+    }
+
+    measure("spatial_map_get_nearest_data", kNumQueries, [&]() {
+      uint64_t result = 0;
+      for (uint32_t i = 0; i < kNumQueries; i++) {
+        float nearestDistSqr = FLT_MAX;
+        const uint32_t* nearest = map.getNearestData(queryPositions[kNumEntries + i], 16.f, nearestDistSqr,
+                                                     [](const uint32_t*) { return true; });
+        result += nearest ? *nearest : 0;
+      }
+      return result;
+    });
+  }
+
+  void benchThreadPoolSchedule() {
+    constexpr uint32_t kNumThreads = 4;
+    constexpr uint32_t kNumTasks = 1024;
+    WorkerThreadPool<kNumTasks> threadPool(kNumThreads, "benchmark-worker");
+    std::vector<Future<uint32_t>> futures(kNumTasks);
+
+    measure("threadpool_schedule_and_get", kNumTasks, [&]() {
+      for (uint32_t i = 0; i < kNumTasks; i++) {
+        futures[i] = threadPool.Schedule([i]() { return i * 3; });
+      }
+      uint64_t result = 0;
+      for (Future<uint32_t>& future : futures) {
+        result += future.valid() ? future.get() : 0;
+      }
+      return result;
+    });
+  }
+
+  // DrawCallCache needs a device, this times the hash keyed lookups the scene manager's caches are made of
+  void benchHashCacheLookup() {
+    constexpr uint32_t kNumEntries = 16 * 1024;
+    std::mt19937_64 rng(kSeed);
+    std::vector<XXH64_hash_t> keys(kNumEntries);
+    fast_unordered_cache<uint32_t> cache;
+    for (uint32_t i = 0; i < kNumEntries; i++) {
+      keys[i] = rng();
+      cache[keys[i]] = i;
+    }
+    // A quarter of the lookups miss, as new geometry does
+    std::vector<XXH64_hash_t> queries(kNumEntries);
+    for (uint32_t i = 0; i < kNumEntries; i++) {
+      queries[i] = (i % 4 == 3) ? rng() : keys[(i * 7919) % kNumEntries];
+    }
+
+    measure("hash_cache_lookup", kNumEntries, [&]() {
+      uint64_t result = 0;
+      for (const XXH64_hash_t query : queries) {
+        auto found = cache.find(query);
+        result += found != cache.end() ? found->second : 1;
+      }
+      return result;
+    });
+  }
+
+  void benchAtomicQueue() {
+    constexpr uint32_t kCapacity = 1024;
+    constexpr uint32_t kBatch = kCapacity / 2;
+    constexpr uint32_t kNumBatches = 64;
+    AtomicQueue<uint32_t, kCapacity> queue;
+
+    measure("atomic_queue_push_pop", kBatch * kNumBatches, [&]() {
+      uint64_t result = 0;
+      for (uint32_t batch = 0; batch < kNumBatches; batch++) {
+        for (uint32_t i = 0; i < kBatch; i++) {
+          queue.push(uint32_t(i));
+        }
+        uint32_t item;
+        while (queue.pop(item)) {
+          result += item;
+        }
+      }
+      return result;
+    });
+  }
+
+  // Baseline lines are "<name> <ns per op>", '-' for a benchmark that has no baseline yet
+  std::map<std::string, double> readBaseline() const {
+    std::map<std::string, double> baseline;
+    std::ifstream file(m_baselinePath);
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      std::istringstream fields(line);
+      std::string name, value;
+      if (fields >> name >> value && value != "-") {
+        baseline[name] = std::stod(value);
+      }
+    }
+    return baseline;
+  }
+
+  int writeBaseline() const {
+    std::ofstream file(m_baselinePath);
+    if (!file) {
+      std::cerr << "Failed to write " << m_baselinePath << std::endl;
+      return 1;
+    }
+    file << "# CPU hot path benchmark baseline in ns per operation, see benchmark_cpu_hot_paths.cpp" << std::endl;
+    for (const Result& result : m_results) {
+      file << result.name << " " << std::fixed << std::setprecision(2) << result.nsPerOp << std::endl;
+    }
+    std::cout << "Baseline written to " << m_baselinePath << std::endl;
+    return 0;
+  }
+
+  int compareToBaseline() const {
+    const std::map<std::string, double> baseline = readBaseline();
+    int numRegressions = 0;
+    for (const Result& result : m_results) {
+      auto found = baseline.find(result.name);
+      if (found == baseline.end()) {
+        std::cout << result.name << ": no baseline" << std::endl;
+        continue;
+      }
+      const double ratio = result.nsPerOp / found->second;
+      if (ratio > kTolerance) {
+        std::cout << result.name << ": REGRESSION, " << std::setprecision(2) << ratio << "x the baseline of "
+                  << found->second << " ns/op" << std::endl;
+        ++numRegressions;
+      }
+    }
+    return numRegressions == 0 ? 0 : 1;
+  }
+};
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: benchmark_cpu_hot_paths <baseline file> [--update]" << std::endl;
+    return 1;
+  }
+  try {
+    BenchmarkApp app(argv[1], argc > 2 && std::string(argv[2]) == "--update");
+    return app.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
@@ -98,6 +98,9 @@ public:
     std::cout << std::endl << "Begin test (32-bit)" << std::endl;
     test_smoke<uint32_t>();
     test_correctness<uint32_t>();
+
+    std::cout << std::endl << "Begin test (strided bytes)" << std::endl;
+    test_correctness_bytes();
   }
   
 private:
@@ -142,6 +145,39 @@ private:
     std::cout << "Min/Max fast ops successfully tested for correctness" << std::endl;
   }
 
+  static void test_correctness_bytes() {
+    // 3 bone indices per vertex followed by padding and a float, like a UBYTE4 blend indices element in a vertex
+    const uint32_t stride = 8;
+    const uint32_t count = 37;
+    uint8_t data[stride * count];
+    for (uint32_t i = 0; i < count; i++) {
+      uint8_t* pVertex = &data[i * stride];
+      pVertex[0] = (uint8_t) (10 + i % 7);
+      pVertex[1] = (uint8_t) (12 + i % 5);
+      pVertex[2] = (uint8_t) (30 + i % 11);
+      // Neither the padding nor the rest of the vertex may affect the result
+      pVertex[3] = i % 2 ? 0 : 255;
+      const float value = -1.0f;
+      memcpy(&pVertex[4], &value, sizeof(value));
+    }
+    // Last minimum and maximum in the last vertex, which is not gathered
+    data[(count - 1) * stride + 0] = 3;
+    data[(count - 1) * stride + 2] = 200;
+
+    uint32_t min, max;
+    fast::findMinMaxBytes(count, data, stride, 3, min, max);
+
+    if (3 != min || 200 != max)
+      throw dxvk::DxvkError("Min/Max not matching strided bytes check 1");
+
+    fast::findMinMaxBytes(count - 1, data, stride, 3, min, max);
+
+    if (10 != min || 40 != max)
+      throw dxvk::DxvkError("Min/Max not matching strided bytes check 2");
+
+    std::cout << "Strided byte Min/Max fast ops successfully tested for correctness" << std::endl;
+  }
+
   template<typename T>
   static void execute(const uint32_t count, T* pData) {
     uint32_t min, max;
@@ -82,8 +82,66 @@ namespace dxvk {
       testPoint(map, Vector3(2.5f, 2.5f, 2.51f), 3);
       // far section of next cell
       testPoint(map, Vector3(3.5f, 3.5f, 3.5f), 3);
+
+      testDenseCluster();
       std::cout << "All passed\n";
     }
+
+    // Piles enough entries into a single cell to split the cells, and checks lookups against a brute force search
+    void testDenseCluster() {
+      static constexpr int kNumEntries = 1000;
+      SpatialMap<int> map(2.0f);
+
+      std::vector<TestData> data;
+      data.reserve(kNumEntries);
+      for (int i = 0; i < kNumEntries; ++i) {
+        const float t = float(i);
+        data.emplace_back(Vector3(std::fmod(t * 0.37f, 1.9f), std::fmod(t * 0.53f, 1.9f), std::fmod(t * 0.71f, 1.9f)), i);
+        map.insert(data[i].pos, data[i].transform, &data[i].data);
+      }
+
+      if (map.getCellSize() >= 2.0f) {
+        throw DxvkError(str::format("cells were not split: cell size is ", map.getCellSize(), "."));
+      }
+
+      auto testAgainstBruteForce = [&](const Vector3& pos, const int erasedCount) {
+        float nearestDistSqr = FLT_MAX;
+        const int* result = map.getNearestData(pos, 1.f, nearestDistSqr, [](const int* unused) {return true; });
+
+        float expectedDistSqr = FLT_MAX;
+        for (int i = erasedCount; i < kNumEntries; ++i) {
+          expectedDistSqr = std::min(expectedDistSqr, lengthSqr(data[i].pos - pos));
+        }
+
+        if (expectedDistSqr > 1.f) {
+          if (result != nullptr) {
+            throw DxvkError(str::format("incorrect result: for pos ", ToString(pos), " expected nothing but got [", *result, "]."));
+          }
+        } else if (result == nullptr || nearestDistSqr != expectedDistSqr) {
+          throw DxvkError(str::format("incorrect result: for pos ", ToString(pos), " expected distance ", expectedDistSqr, " but got ", nearestDistSqr, "."));
+        }
+      };
+
+      for (int i = 0; i < 100; ++i) {
+        const float t = float(i);
+        testAgainstBruteForce(Vector3(std::fmod(t * 0.29f, 4.f) - 1.f, std::fmod(t * 0.43f, 4.f) - 1.f, std::fmod(t * 0.61f, 4.f) - 1.f), 0);
+      }
+
+      // Erasing most of the entries restores the original cell size
+      const int erasedCount = kNumEntries - 20;
+      for (int i = 0; i < erasedCount; ++i) {
+        map.erase(XXH64(&data[i].transform, sizeof(data[i].transform), 0));
+      }
+
+      if (map.getCellSize() != 2.0f) {
+        throw DxvkError(str::format("cells were not merged: cell size is ", map.getCellSize(), "."));
+      }
+
+      for (int i = 0; i < 100; ++i) {
+        const float t = float(i);
+        testAgainstBruteForce(Vector3(std::fmod(t * 0.29f, 4.f) - 1.f, std::fmod(t * 0.43f, 4.f) - 1.f, std::fmod(t * 0.61f, 4.f) - 1.f), erasedCount);
+      }
+    }
   };
 }
 
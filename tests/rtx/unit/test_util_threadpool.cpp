@@ -23,6 +23,7 @@
 #include <random>
 #include <chrono>
 #include <iostream>
+#include <thread>
 
 #include "../../test_utils.h"
 #include "../../../src/util/util_threadpool.h"
@@ -45,6 +46,10 @@ public:
     test_smoke<0>();
     cout << "Begin task cancellation test" << endl;
     test_smoke<4>();
+    cout << "Begin multiple producer test" << endl;
+    test_multi_producer();
+    cout << "Begin task graph test" << endl;
+    test_task_graph();
     cout << "Begin misc tests" << endl;
     test_misc();
     cout << "WorkerThreadPool successfully smoke tested" << endl;
@@ -128,6 +133,88 @@ private:
     FrameMark;
   }
 
+  static void test_multi_producer() {
+    ZoneScoped;
+    const uint32_t numThreads = 4;
+    const uint32_t numProducers = 4;
+    const uint32_t numTasksPerProducer = 500;
+    const uint32_t numTasks = numProducers * numTasksPerProducer;
+
+    WorkerThreadPool<numTasks, true, false> threadPool(numThreads);
+    cout << "Created thread pool with " << numThreads << " threads" << endl;
+
+    // Every task adds its index, so that a task that ran twice or not at all shows up in the sum
+    atomic<uint64_t> sum = 0;
+    atomic<uint32_t> numExecuted = 0;
+
+    vector<thread> producers;
+    for (uint32_t p = 0; p < numProducers; p++) {
+      producers.emplace_back([&threadPool, &sum, &numExecuted, p]() {
+        for (uint32_t i = 0; i < numTasksPerProducer; i++) {
+          const uint64_t index = p * numTasksPerProducer + i;
+          auto task = [&sum, &numExecuted, index]() {
+            sum += index;
+            ++numExecuted;
+          };
+
+          // A full queue is not an error, the caller runs the task instead
+          if (!threadPool.Schedule(task).valid()) {
+            task();
+          }
+        }
+      });
+    }
+
+    for (thread& producer : producers) {
+      producer.join();
+    }
+
+    const auto start = high_resolution_clock::now();
+    while (numExecuted < numTasks) {
+      if (duration_cast<seconds>(high_resolution_clock::now() - start).count() > 10) {
+        throw DxvkError("Timed out waiting for tasks of multiple producers");
+      }
+      this_thread::yield();
+    }
+
+    const uint64_t expectedSum = uint64_t(numTasks) * (numTasks - 1) / 2;
+    if (sum != expectedSum) {
+      throw DxvkError("Results of multiple producers didnt match");
+    }
+
+    cout << "Executed " << numExecuted << " tasks from " << numProducers << " producers" << endl;
+  }
+
+  static void test_task_graph() {
+    ZoneScoped;
+    const uint32_t numThreads = 4;
+    const uint32_t numIterations = 100;
+
+    using Pool = WorkerThreadPool<16, true, false>;
+    Pool threadPool(numThreads);
+
+    for (uint32_t i = 0; i < numIterations; i++) {
+      // A diamond: first, then left and right at the same time, then last
+      atomic<uint32_t> order = 0;
+      uint32_t first = 0, left = 0, right = 0, last = 0;
+      {
+        TaskGraph<Pool, 4> graph(threadPool);
+        const auto firstTask = graph.add([&]() { first = ++order; });
+        const auto leftTask = graph.add([&]() { left = ++order; }, { firstTask });
+        const auto rightTask = graph.add([&]() { right = ++order; }, { firstTask });
+        graph.add([&]() { last = ++order; }, { leftTask, rightTask });
+        graph.start();
+        graph.wait();
+      }
+
+      if (first != 1 || left < 2 || right < 2 || left == right || last != 4) {
+        throw DxvkError("Task graph ran tasks out of order");
+      }
+    }
+
+    cout << "Ran " << numIterations << " task graphs" << endl;
+  }
+
   static void test_misc() {
     const uint32_t numThreads = 4;
     const uint32_t numTasks = 32;